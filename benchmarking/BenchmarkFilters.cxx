@@ -53,6 +53,7 @@
 
 #include <vtkm/io/reader/VTKDataSetReader.h>
 
+#include <vtkm/worklet/BrickRangeIndex.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WaveletGenerator.h>
 #include <vtkm/worklet/WorkletMapField.h>
@@ -115,6 +116,7 @@ enum BenchmarkName
   TETRAHEDRALIZE = 1 << 9,
   VERTEX_CLUSTERING = 1 << 10,
   CELL_TO_POINT = 1 << 11,
+  BRICK_RANGE_INDEX = 1 << 12,
 
   ALL = GRADIENT | THRESHOLD | THRESHOLD_POINTS | CELL_AVERAGE | POINT_AVERAGE | WARP_SCALAR |
     WARP_VECTOR |
@@ -122,7 +124,8 @@ enum BenchmarkName
     EXTERNAL_FACES |
     TETRAHEDRALIZE |
     VERTEX_CLUSTERING |
-    CELL_TO_POINT
+    CELL_TO_POINT |
+    BRICK_RANGE_INDEX
 };
 
 static const std::string DIVIDER(40, '-');
@@ -302,6 +305,15 @@ class BenchmarkFilters
   VTKM_MAKE_BENCHMARK(GradientKitchenSink,
                       BenchGradient,
                       Gradient | PointGradient | Divergence | Vorticity | QCriterion);
+  // Same outputs without storing the gradient, which lets structured inputs
+  // compute the derived quantities directly from the point neighborhood:
+  VTKM_MAKE_BENCHMARK(GradientDerivedOnly,
+                      BenchGradient,
+                      PointGradient | Divergence | Vorticity | QCriterion);
+  VTKM_MAKE_BENCHMARK(GradientPointDivergence,
+                      BenchGradient,
+                      Gradient | PointGradient | Divergence);
+  VTKM_MAKE_BENCHMARK(GradientDivergenceOnly, BenchGradient, PointGradient | Divergence);
 
   template <typename>
   struct BenchThreshold
@@ -690,6 +702,142 @@ class BenchmarkFilters
   };
   VTKM_MAKE_BENCHMARK(CellToPoint, BenchCellToPoint);
 
+  // Builds a brick range index of the point scalars of the (3D structured) input.
+  struct BuildBrickRangeIndex
+  {
+    vtkm::worklet::BrickRangeIndex& Index;
+
+    template <typename ArrayHandleType>
+    VTKM_CONT void operator()(const ArrayHandleType& array) const
+    {
+      this->Index.Build(InputDataSet.GetCellSet().Cast<vtkm::cont::CellSetStructured<3>>(),
+                        PointScalarsName,
+                        array,
+                        DeviceAdapterTag());
+    }
+  };
+
+  static VTKM_CONT vtkm::worklet::BrickRangeIndex MakeBrickRangeIndex(vtkm::Id brickSize)
+  {
+    vtkm::worklet::BrickRangeIndex index(brickSize);
+    auto field = InputDataSet.GetField(PointScalarsName, vtkm::cont::Field::Association::POINTS);
+    field.GetData().ResetTypeList(vtkm::TypeListTagFieldScalar()).CastAndCall(
+      BuildBrickRangeIndex{ index });
+    return index;
+  }
+
+  template <typename>
+  struct BenchBrickRangeIndexBuild
+  {
+    vtkm::Id BrickSize;
+
+    VTKM_CONT
+    BenchBrickRangeIndexBuild(vtkm::Id brickSize)
+      : BrickSize(brickSize)
+    {
+    }
+
+    VTKM_CONT
+    vtkm::Float64 operator()()
+    {
+      Timer timer;
+      MakeBrickRangeIndex(this->BrickSize);
+      return timer.GetElapsedTime();
+    }
+
+    VTKM_CONT
+    std::string Description() const
+    {
+      std::ostringstream desc;
+      desc << "BrickRangeIndex build brickSize=" << this->BrickSize;
+      return desc.str();
+    }
+  };
+  VTKM_MAKE_BENCHMARK(BrickRangeIndexBuild8, BenchBrickRangeIndexBuild, 8);
+  VTKM_MAKE_BENCHMARK(BrickRangeIndexBuild16, BenchBrickRangeIndexBuild, 16);
+
+  // Contour and threshold close to the maximum of the point scalars, where
+  // most bricks can be skipped, with and without a brick range index.
+  template <typename>
+  struct BenchMarchingCubesBrickRangeIndex
+  {
+    vtkm::filter::MarchingCubes Filter;
+    bool UseIndex;
+
+    VTKM_CONT
+    BenchMarchingCubesBrickRangeIndex(bool useIndex)
+      : UseIndex(useIndex)
+    {
+      auto field = InputDataSet.GetField(PointScalarsName, vtkm::cont::Field::Association::POINTS);
+      auto range = field.GetRange().GetPortalConstControl().Get(0);
+      this->Filter.SetActiveField(PointScalarsName, vtkm::cont::Field::Association::POINTS);
+      this->Filter.SetIsoValue(range.Min + 0.9 * range.Length());
+      this->Filter.SetMergeDuplicatePoints(false);
+      if (useIndex)
+      {
+        this->Filter.SetBrickRangeIndex(MakeBrickRangeIndex(8));
+      }
+    }
+
+    VTKM_CONT
+    vtkm::Float64 operator()()
+    {
+      Timer timer;
+      this->Filter.Execute(InputDataSet, BenchmarkFilterPolicy());
+      return timer.GetElapsedTime();
+    }
+
+    VTKM_CONT
+    std::string Description() const
+    {
+      std::ostringstream desc;
+      desc << "MarchingCubes at 90% of the range brickRangeIndex=" << this->UseIndex;
+      return desc.str();
+    }
+  };
+  VTKM_MAKE_BENCHMARK(MarchingCubesFullScan, BenchMarchingCubesBrickRangeIndex, false);
+  VTKM_MAKE_BENCHMARK(MarchingCubesBrickRangeIndex, BenchMarchingCubesBrickRangeIndex, true);
+
+  template <typename>
+  struct BenchThresholdBrickRangeIndex
+  {
+    vtkm::filter::Threshold Filter;
+    bool UseIndex;
+
+    VTKM_CONT
+    BenchThresholdBrickRangeIndex(bool useIndex)
+      : UseIndex(useIndex)
+    {
+      auto field = InputDataSet.GetField(PointScalarsName, vtkm::cont::Field::Association::POINTS);
+      auto range = field.GetRange().GetPortalConstControl().Get(0);
+      this->Filter.SetActiveField(PointScalarsName, vtkm::cont::Field::Association::POINTS);
+      this->Filter.SetLowerThreshold(range.Min + 0.9 * range.Length());
+      this->Filter.SetUpperThreshold(range.Max);
+      if (useIndex)
+      {
+        this->Filter.SetBrickRangeIndex(MakeBrickRangeIndex(8));
+      }
+    }
+
+    VTKM_CONT
+    vtkm::Float64 operator()()
+    {
+      Timer timer;
+      this->Filter.Execute(InputDataSet, BenchmarkFilterPolicy());
+      return timer.GetElapsedTime();
+    }
+
+    VTKM_CONT
+    std::string Description() const
+    {
+      std::ostringstream desc;
+      desc << "Threshold above 90% of the range brickRangeIndex=" << this->UseIndex;
+      return desc.str();
+    }
+  };
+  VTKM_MAKE_BENCHMARK(ThresholdFullScan, BenchThresholdBrickRangeIndex, false);
+  VTKM_MAKE_BENCHMARK(ThresholdBrickRangeIndex, BenchThresholdBrickRangeIndex, true);
+
 public:
   static VTKM_CONT int Run(int benches)
   {
@@ -706,6 +854,7 @@ public:
         VTKM_RUN_BENCHMARK(GradientVector, dummyTypes);
         VTKM_RUN_BENCHMARK(GradientVectorRow, dummyTypes);
         VTKM_RUN_BENCHMARK(GradientKitchenSink, dummyTypes);
+        VTKM_RUN_BENCHMARK(GradientDerivedOnly, dummyTypes);
       }
       else
       {
@@ -717,6 +866,9 @@ public:
         VTKM_RUN_BENCHMARK(GradientVorticity, dummyTypes);
         VTKM_RUN_BENCHMARK(GradientQCriterion, dummyTypes);
         VTKM_RUN_BENCHMARK(GradientKitchenSink, dummyTypes);
+        VTKM_RUN_BENCHMARK(GradientDerivedOnly, dummyTypes);
+        VTKM_RUN_BENCHMARK(GradientPointDivergence, dummyTypes);
+        VTKM_RUN_BENCHMARK(GradientDivergenceOnly, dummyTypes);
       }
     }
     if (benches & BenchmarkName::THRESHOLD)
@@ -770,6 +922,15 @@ public:
         VTKM_RUN_BENCHMARK(MarchingCubes12FTT, dummyTypes);
       }
     }
+    if (benches & BenchmarkName::BRICK_RANGE_INDEX)
+    {
+      VTKM_RUN_BENCHMARK(BrickRangeIndexBuild8, dummyTypes);
+      VTKM_RUN_BENCHMARK(BrickRangeIndexBuild16, dummyTypes);
+      VTKM_RUN_BENCHMARK(MarchingCubesFullScan, dummyTypes);
+      VTKM_RUN_BENCHMARK(MarchingCubesBrickRangeIndex, dummyTypes);
+      VTKM_RUN_BENCHMARK(ThresholdFullScan, dummyTypes);
+      VTKM_RUN_BENCHMARK(ThresholdBrickRangeIndex, dummyTypes);
+    }
     if (benches & BenchmarkName::EXTERNAL_FACES)
     {
       VTKM_RUN_BENCHMARK(ExternalFaces, dummyTypes);
@@ -1135,6 +1296,11 @@ int BenchmarkBody(int argc, char* argv[])
     {
       benches |= BenchmarkName::CELL_TO_POINT;
     }
+    else if (arg == "brick_range_index")
+    {
+      benches |= BenchmarkName::BRICK_RANGE_INDEX;
+      needPointScalars = true;
+    }
     else if (arg == "filename")
     {
       ++i;
@@ -1248,6 +1414,13 @@ int BenchmarkBody(int argc, char* argv[])
                  "structured dataset. Removing from options.\n";
     benches = benches ^ BenchmarkName::VERTEX_CLUSTERING;
   }
+  if (benches & BenchmarkName::BRICK_RANGE_INDEX &&
+      !InputDataSet.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    std::cout << "Warning: Cannot benchmark vtkm::worklet::BrickRangeIndex on "
+                 "datasets that are not 3D structured. Removing from options.\n";
+    benches = benches ^ BenchmarkName::BRICK_RANGE_INDEX;
+  }
   if (benches & BenchmarkName::CELL_TO_POINT && isStructured)
   {
     std::cout << "Info: CellToPoint benchmark is trivial on structured datasets. "
@@ -0,0 +1,264 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include "Benchmarker.h"
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/CoordinateSystem.h>
+#include <vtkm/cont/PointLocatorUniformGrid.h>
+#include <vtkm/cont/Timer.h>
+
+#include <vtkm/worklet/KdTree3D.h>
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace vtkm::benchmarking;
+namespace vtkm
+{
+namespace benchmarking
+{
+
+using Device = VTKM_DEFAULT_DEVICE_ADAPTER_TAG;
+
+enum class NeighborQuery
+{
+  KNearest,
+  Radius
+};
+
+enum class NeighborStructure
+{
+  KdTree,
+  KdTreeMorton,
+  UniformGrid
+};
+
+inline std::string StructureName(NeighborStructure structure)
+{
+  switch (structure)
+  {
+    case NeighborStructure::KdTree:
+      return "kd-tree";
+    case NeighborStructure::KdTreeMorton:
+      return "morton kd-tree";
+    default:
+      return "uniform grid";
+  }
+}
+
+inline std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> RandomPoints(vtkm::Id numberOfPoints,
+                                                                  unsigned int seed)
+{
+  std::default_random_engine dre(seed);
+  std::uniform_real_distribution<vtkm::FloatDefault> dr(0.0f, 10.0f);
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> points;
+  for (vtkm::Id i = 0; i < numberOfPoints; i++)
+  {
+    points.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(dr(dre), dr(dre), dr(dre)));
+  }
+  return points;
+}
+
+// Random points in a 10^3 box, queried at random locations. With the default
+// sizes a radius of 0.125 finds about as many neighbors as the k-NN query.
+template <typename Value>
+struct BenchNeighborSearch
+{
+  using CoordType = vtkm::Vec<vtkm::FloatDefault, 3>;
+
+  NeighborStructure Structure;
+  NeighborQuery Query;
+  vtkm::Id K;
+  vtkm::Float64 Radius;
+  vtkm::cont::ArrayHandle<CoordType> Points;
+  vtkm::cont::ArrayHandle<CoordType> QueryPoints;
+  vtkm::worklet::KdTree3D KdTree;
+  vtkm::cont::PointLocatorUniformGrid Grid;
+
+  VTKM_CONT BenchNeighborSearch(NeighborStructure structure,
+                                NeighborQuery query,
+                                vtkm::Id numberOfPoints = 1000000,
+                                vtkm::Id numberOfQueries = 1000000)
+    : Structure(structure)
+    , Query(query)
+    , K(8)
+    , Radius(0.125)
+    , Grid({ 0.0f, 0.0f, 0.0f }, { 10.0f, 10.0f, 10.0f }, { 64, 64, 64 })
+  {
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Copy(
+      vtkm::cont::make_ArrayHandle(RandomPoints(numberOfPoints, 1)), this->Points);
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Copy(
+      vtkm::cont::make_ArrayHandle(RandomPoints(numberOfQueries, 2)), this->QueryPoints);
+
+    this->KdTree.SetBuildMode(structure == NeighborStructure::KdTreeMorton
+                                ? vtkm::worklet::KdTree3D::BUILD_MORTON
+                                : vtkm::worklet::KdTree3D::BUILD_BALANCED);
+    this->KdTree.Build(this->Points, Device());
+    this->Grid.SetCoords(vtkm::cont::CoordinateSystem("points", this->Points));
+    this->Grid.Build();
+  }
+
+  VTKM_CONT
+  vtkm::Float64 operator()()
+  {
+    vtkm::cont::ArrayHandle<vtkm::IdComponent> numNeighbors;
+    vtkm::cont::ArrayHandle<vtkm::Id> offsets;
+    vtkm::cont::ArrayHandle<vtkm::Id> neighborIds;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> distances;
+
+    vtkm::cont::Timer<Device> timer;
+    if (this->Structure != NeighborStructure::UniformGrid)
+    {
+      if (this->Query == NeighborQuery::KNearest)
+      {
+        this->KdTree.FindKNearestNeighbors(
+          this->Points, this->QueryPoints, this->K, neighborIds, distances, Device());
+      }
+      else
+      {
+        this->KdTree.FindNeighborsInRadius(this->Points,
+                                           this->QueryPoints,
+                                           this->Radius,
+                                           numNeighbors,
+                                           offsets,
+                                           neighborIds,
+                                           distances,
+                                           Device());
+      }
+    }
+    else
+    {
+      if (this->Query == NeighborQuery::KNearest)
+      {
+        this->Grid.FindKNearestNeighbors(
+          this->QueryPoints, this->K, neighborIds, distances, Device());
+      }
+      else
+      {
+        this->Grid.FindNeighborsInRadius(
+          this->QueryPoints, this->Radius, numNeighbors, offsets, neighborIds, distances, Device());
+      }
+    }
+    return timer.GetElapsedTime();
+  }
+
+  VTKM_CONT
+  std::string Description() const
+  {
+    std::stringstream description;
+    if (this->Query == NeighborQuery::KNearest)
+    {
+      description << this->K << "-nearest neighbors";
+    }
+    else
+    {
+      description << "Neighbors within " << this->Radius;
+    }
+    description << " of " << this->QueryPoints.GetNumberOfValues() << " queries among "
+                << this->Points.GetNumberOfValues() << " points (" << StructureName(this->Structure)
+                << ")";
+    return description.str();
+  }
+};
+
+// Times building a kd-tree over random points with either builder.
+template <typename Value>
+struct BenchKdTreeBuild
+{
+  vtkm::worklet::KdTree3D::BuildModeEnum BuildMode;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>> Points;
+
+  VTKM_CONT BenchKdTreeBuild(vtkm::worklet::KdTree3D::BuildModeEnum buildMode,
+                             vtkm::Id numberOfPoints = 1000000)
+    : BuildMode(buildMode)
+  {
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Copy(
+      vtkm::cont::make_ArrayHandle(RandomPoints(numberOfPoints, 1)), this->Points);
+  }
+
+  VTKM_CONT
+  vtkm::Float64 operator()()
+  {
+    vtkm::worklet::KdTree3D kdTree;
+    kdTree.SetBuildMode(this->BuildMode);
+
+    vtkm::cont::Timer<Device> timer;
+    kdTree.Build(this->Points, Device());
+    return timer.GetElapsedTime();
+  }
+
+  VTKM_CONT
+  std::string Description() const
+  {
+    std::stringstream description;
+    description << "Build "
+                << StructureName(this->BuildMode == vtkm::worklet::KdTree3D::BUILD_MORTON
+                                   ? NeighborStructure::KdTreeMorton
+                                   : NeighborStructure::KdTree)
+                << " over " << this->Points.GetNumberOfValues() << " points";
+    return description.str();
+  }
+};
+
+VTKM_MAKE_BENCHMARK(KdTreeBuild, BenchKdTreeBuild, vtkm::worklet::KdTree3D::BUILD_BALANCED);
+VTKM_MAKE_BENCHMARK(KdTreeMortonBuild, BenchKdTreeBuild, vtkm::worklet::KdTree3D::BUILD_MORTON);
+VTKM_MAKE_BENCHMARK(KdTreeKNearest,
+                    BenchNeighborSearch,
+                    NeighborStructure::KdTree,
+                    NeighborQuery::KNearest);
+VTKM_MAKE_BENCHMARK(KdTreeMortonKNearest,
+                    BenchNeighborSearch,
+                    NeighborStructure::KdTreeMorton,
+                    NeighborQuery::KNearest);
+VTKM_MAKE_BENCHMARK(GridKNearest,
+                    BenchNeighborSearch,
+                    NeighborStructure::UniformGrid,
+                    NeighborQuery::KNearest);
+VTKM_MAKE_BENCHMARK(KdTreeRadius,
+                    BenchNeighborSearch,
+                    NeighborStructure::KdTree,
+                    NeighborQuery::Radius);
+VTKM_MAKE_BENCHMARK(KdTreeMortonRadius,
+                    BenchNeighborSearch,
+                    NeighborStructure::KdTreeMorton,
+                    NeighborQuery::Radius);
+VTKM_MAKE_BENCHMARK(GridRadius,
+                    BenchNeighborSearch,
+                    NeighborStructure::UniformGrid,
+                    NeighborQuery::Radius);
+}
+} // end namespace vtkm::benchmarking
+
+int main(int, char* [])
+{
+  using Types = vtkm::ListTagBase<vtkm::FloatDefault>;
+  VTKM_RUN_BENCHMARK(KdTreeBuild, Types());
+  VTKM_RUN_BENCHMARK(KdTreeMortonBuild, Types());
+  VTKM_RUN_BENCHMARK(KdTreeKNearest, Types());
+  VTKM_RUN_BENCHMARK(KdTreeMortonKNearest, Types());
+  VTKM_RUN_BENCHMARK(GridKNearest, Types());
+  VTKM_RUN_BENCHMARK(KdTreeRadius, Types());
+  VTKM_RUN_BENCHMARK(KdTreeMortonRadius, Types());
+  VTKM_RUN_BENCHMARK(GridRadius, Types());
+  return 0;
+}
@@ -29,6 +29,7 @@
 
 #include <vtkm/rendering/Camera.h>
 #include <vtkm/rendering/internal/RunTriangulator.h>
+#include <vtkm/rendering/raytracing/BoundingVolumeHierarchy.h>
 #include <vtkm/rendering/raytracing/Ray.h>
 #include <vtkm/rendering/raytracing/RayTracer.h>
 
@@ -44,6 +45,13 @@ namespace vtkm
 namespace benchmarking
 {
 
+using LinearBVH = vtkm::rendering::raytracing::LinearBVH;
+
+inline std::string BuildModeName(LinearBVH::BuildModeEnum mode)
+{
+  return mode == LinearBVH::BUILD_SAH ? "SAH" : "morton";
+}
+
 template <typename Precision>
 struct BenchRayTracing
 {
@@ -54,8 +62,10 @@ struct BenchRayTracing
   vtkm::Id NumberOfTriangles;
   vtkm::cont::CoordinateSystem Coords;
   vtkm::cont::DataSet Data;
+  LinearBVH::BuildModeEnum BuildMode;
 
-  VTKM_CONT BenchRayTracing()
+  VTKM_CONT BenchRayTracing(LinearBVH::BuildModeEnum buildMode = LinearBVH::BUILD_MORTON)
+    : BuildMode(buildMode)
   {
     vtkm::cont::testing::MakeTestDataSet maker;
     Data = maker.Make3DUniformDataSet2();
@@ -77,6 +87,7 @@ struct BenchRayTracing
     vtkm::cont::Field field = Data.GetField("pointvar");
     vtkm::Range range = field.GetRange().GetPortalConstControl().Get(0);
 
+    Tracer.SetBuildMode(BuildMode);
     Tracer.SetData(Coords.GetData(), Indices, field, NumberOfTriangles, range, bounds);
 
     vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::UInt8, 4>> temp;
@@ -114,15 +125,87 @@ struct BenchRayTracing
   }
 
   VTKM_CONT
-  std::string Description() const { return "A ray tracing benchmark"; }
+  std::string Description() const
+  {
+    return "A ray tracing benchmark (" + BuildModeName(BuildMode) + " BVH)";
+  }
+};
+
+// Times the acceleration structure alone, so the build cost of each builder
+// can be weighed against the frame time it buys in BenchRayTracing. With
+// Refit set, the BVH is built once up front and each iteration only refits
+// it to the same triangles, as happens for time varying coordinates.
+template <typename Precision>
+struct BenchBVHBuild
+{
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> Indices;
+  vtkm::cont::CoordinateSystem Coords;
+  LinearBVH::BuildModeEnum BuildMode;
+  bool Refit;
+  LinearBVH Bvh;
+
+  VTKM_CONT BenchBVHBuild(LinearBVH::BuildModeEnum buildMode, bool refit)
+    : BuildMode(buildMode)
+    , Refit(refit)
+  {
+    vtkm::cont::testing::MakeTestDataSet maker;
+    vtkm::cont::DataSet data = maker.Make3DUniformDataSet2();
+    Coords = data.GetCoordinateSystem();
+
+    vtkm::Id numberOfTriangles;
+    vtkm::rendering::internal::RunTriangulator(data.GetCellSet(), Indices, numberOfTriangles);
+
+    Bvh.SetBuildMode(BuildMode);
+    Bvh.SetData(Coords.GetData(), Indices, Coords.GetBounds());
+    Bvh.Construct();
+  }
+
+  VTKM_CONT
+  vtkm::Float64 operator()()
+  {
+    if (!Refit)
+    {
+      // a fresh triangle array forces a full build
+      vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> indices;
+      vtkm::cont::DeviceAdapterAlgorithm<VTKM_DEFAULT_DEVICE_ADAPTER_TAG>::Copy(Indices, indices);
+      Bvh.SetData(Coords.GetData(), indices, Coords.GetBounds());
+    }
+    else
+    {
+      Bvh.SetData(Coords.GetData(), Indices, Coords.GetBounds());
+    }
+
+    vtkm::cont::Timer<VTKM_DEFAULT_DEVICE_ADAPTER_TAG> timer;
+    Bvh.Construct();
+    return timer.GetElapsedTime();
+  }
+
+  VTKM_CONT
+  std::string Description() const
+  {
+    std::stringstream description;
+    description << (Refit ? "Refit " : "Build ") << BuildModeName(BuildMode) << " BVH over "
+                << Indices.GetNumberOfValues() << " triangles";
+    return description.str();
+  }
 };
 
 VTKM_MAKE_BENCHMARK(RayTracing, BenchRayTracing);
+VTKM_MAKE_BENCHMARK(RayTracingSAH, BenchRayTracing, LinearBVH::BUILD_SAH);
+VTKM_MAKE_BENCHMARK(BVHBuild, BenchBVHBuild, LinearBVH::BUILD_MORTON, false);
+VTKM_MAKE_BENCHMARK(BVHBuildSAH, BenchBVHBuild, LinearBVH::BUILD_SAH, false);
+VTKM_MAKE_BENCHMARK(BVHRefit, BenchBVHBuild, LinearBVH::BUILD_MORTON, true);
+VTKM_MAKE_BENCHMARK(BVHRefitSAH, BenchBVHBuild, LinearBVH::BUILD_SAH, true);
 }
 } // end namespace vtkm::benchmarking
 
 int main(int, char* [])
 {
   VTKM_RUN_BENCHMARK(RayTracing, vtkm::ListTagBase<vtkm::Float32>());
+  VTKM_RUN_BENCHMARK(RayTracingSAH, vtkm::ListTagBase<vtkm::Float32>());
+  VTKM_RUN_BENCHMARK(BVHBuild, vtkm::ListTagBase<vtkm::Float32>());
+  VTKM_RUN_BENCHMARK(BVHBuildSAH, vtkm::ListTagBase<vtkm::Float32>());
+  VTKM_RUN_BENCHMARK(BVHRefit, vtkm::ListTagBase<vtkm::Float32>());
+  VTKM_RUN_BENCHMARK(BVHRefitSAH, vtkm::ListTagBase<vtkm::Float32>());
   return 0;
 }
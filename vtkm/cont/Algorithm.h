@@ -97,6 +97,18 @@ struct CopySubRangeFunctor
   }
 };
 
+struct HistogramFunctor
+{
+  template <typename Device, typename... Args>
+  VTKM_CONT bool operator()(Device, Args&&... args) const
+  {
+    VTKM_IS_DEVICE_ADAPTER_TAG(Device);
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Histogram(
+      PrepareArgForExec<Device>(std::forward<Args>(args))...);
+    return true;
+  }
+};
+
 struct LowerBoundsFunctor
 {
 
@@ -242,6 +254,26 @@ struct ScheduleFunctor
   }
 };
 
+template <typename T>
+struct SelectNthFunctor
+{
+  T result;
+
+  SelectNthFunctor()
+    : result()
+  {
+  }
+
+  template <typename Device, typename... Args>
+  VTKM_CONT bool operator()(Device, Args&&... args)
+  {
+    VTKM_IS_DEVICE_ADAPTER_TAG(Device);
+    result = vtkm::cont::DeviceAdapterAlgorithm<Device>::SelectNth(
+      PrepareArgForExec<Device>(std::forward<Args>(args))...);
+    return true;
+  }
+};
+
 struct SortFunctor
 {
   template <typename Device, typename... Args>
@@ -398,6 +430,25 @@ struct Algorithm
   }
 
 
+  template <typename T, class CIn>
+  VTKM_CONT static void Histogram(
+    vtkm::cont::DeviceAdapterId devId,
+    const vtkm::cont::ArrayHandle<T, CIn>& input,
+    vtkm::Id numberOfBins,
+    vtkm::cont::ArrayHandle<vtkm::Id, vtkm::cont::StorageTagBasic>& output)
+  {
+    vtkm::cont::TryExecuteOnDevice(devId, detail::HistogramFunctor(), input, numberOfBins, output);
+  }
+  template <typename T, class CIn>
+  VTKM_CONT static void Histogram(
+    const vtkm::cont::ArrayHandle<T, CIn>& input,
+    vtkm::Id numberOfBins,
+    vtkm::cont::ArrayHandle<vtkm::Id, vtkm::cont::StorageTagBasic>& output)
+  {
+    Histogram(vtkm::cont::DeviceAdapterIdAny(), input, numberOfBins, output);
+  }
+
+
   template <typename T, class CIn, class CVal, class COut>
   VTKM_CONT static void LowerBounds(vtkm::cont::DeviceAdapterId devId,
                                     const vtkm::cont::ArrayHandle<T, CIn>& input,
@@ -742,6 +793,41 @@ struct Algorithm
   }
 
 
+
+  template <typename T, class Storage>
+  VTKM_CONT static T SelectNth(vtkm::cont::DeviceAdapterId devId,
+                               const vtkm::cont::ArrayHandle<T, Storage>& values,
+                               vtkm::Id n)
+  {
+    detail::SelectNthFunctor<T> functor;
+    vtkm::cont::TryExecuteOnDevice(devId, functor, values, n);
+    return functor.result;
+  }
+  template <typename T, class Storage>
+  VTKM_CONT static T SelectNth(const vtkm::cont::ArrayHandle<T, Storage>& values, vtkm::Id n)
+  {
+    return SelectNth(vtkm::cont::DeviceAdapterIdAny(), values, n);
+  }
+
+
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static T SelectNth(vtkm::cont::DeviceAdapterId devId,
+                               const vtkm::cont::ArrayHandle<T, Storage>& values,
+                               vtkm::Id n,
+                               BinaryCompare binary_compare)
+  {
+    detail::SelectNthFunctor<T> functor;
+    vtkm::cont::TryExecuteOnDevice(devId, functor, values, n, binary_compare);
+    return functor.result;
+  }
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static T SelectNth(const vtkm::cont::ArrayHandle<T, Storage>& values,
+                               vtkm::Id n,
+                               BinaryCompare binary_compare)
+  {
+    return SelectNth(vtkm::cont::DeviceAdapterIdAny(), values, n, binary_compare);
+  }
+
   template <typename T, class Storage>
   VTKM_CONT static void Sort(vtkm::cont::DeviceAdapterId devId,
                              vtkm::cont::ArrayHandle<T, Storage>& values)
@@ -61,6 +61,14 @@ public:
   {
   }
 
+  VTKM_EXEC_CONT
+  ArrayPortalExtractComponent& operator=(const ArrayPortalExtractComponent<PortalType>& src)
+  {
+    this->Portal = src.Portal;
+    this->Component = src.Component;
+    return *this;
+  }
+
   VTKM_EXEC_CONT
   vtkm::Id GetNumberOfValues() const { return this->Portal.GetNumberOfValues(); }
 
@@ -512,14 +512,14 @@ public:
 };
 
 VTKM_CONT
-void BoundingIntervalHierarchy::Build()
+inline void BoundingIntervalHierarchy::Build()
 {
   BuildFunctor functor(this);
   vtkm::cont::TryExecute(functor);
 }
 
 VTKM_CONT
-const HandleType BoundingIntervalHierarchy::PrepareForExecutionImpl(
+inline const HandleType BoundingIntervalHierarchy::PrepareForExecutionImpl(
   const vtkm::cont::DeviceAdapterId deviceId) const
 {
   const bool success =
@@ -118,6 +118,25 @@ struct DeviceAdapterAlgorithm
                                      vtkm::cont::ArrayHandle<U, COut>& output,
                                      vtkm::Id outputIndex = 0);
 
+  /// \brief Counts how often each bin index occurs in the input.
+  ///
+  /// \c output is resized to \c numberOfBins, and entry \c i receives the
+  /// number of values in \c input equal to \c i. Values outside of
+  /// [0, \c numberOfBins) are not counted. The input does not have to be
+  /// sorted, and it is usually an implicit or transformed array that computes
+  /// the bin of each value on the fly.
+  ///
+  /// Unlike counting with Sort and UpperBounds, this takes linear time and
+  /// needs no temporary array the size of the input. Parts of the input are
+  /// counted into private bins that are merged at the end, or, when there
+  /// are too many bins for that, with atomic adds.
+  ///
+  template <typename T, class CIn>
+  VTKM_CONT static void Histogram(
+    const vtkm::cont::ArrayHandle<T, CIn>& input,
+    vtkm::Id numberOfBins,
+    vtkm::cont::ArrayHandle<vtkm::Id, vtkm::cont::StorageTagBasic>& output);
+
   /// \brief Output is the first index in input for each item in values that wouldn't alter the ordering of input
   ///
   /// LowerBounds is a vectorized search. From each value in \c values it finds
@@ -393,6 +412,31 @@ struct DeviceAdapterAlgorithm
   template <class Functor, class IndiceType>
   VTKM_CONT static void Schedule(Functor functor, vtkm::Id3 rangeMax);
 
+  /// \brief Select the n-th smallest value of an array.
+  ///
+  /// Returns the value that would be at index \c n of \c values if it was
+  /// sorted in ascending order, like \c std::nth_element but without
+  /// modifying \c values. \c n must be in [0, \c values.GetNumberOfValues()).
+  ///
+  /// This takes expected linear time. Pivots picked from a sorted sample
+  /// narrow down the values that can be the n-th one until few enough are
+  /// left to sort.
+  ///
+  template <typename T, class Storage>
+  VTKM_CONT static T SelectNth(const vtkm::cont::ArrayHandle<T, Storage>& values, vtkm::Id n);
+
+  /// \brief Select the n-th smallest value of an array.
+  ///
+  /// Returns the value that would be at index \c n of \c values if it was
+  /// sorted with the custom compare functor, without modifying \c values.
+  ///
+  /// BinaryCompare should be a strict weak ordering comparison operator
+  ///
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static T SelectNth(const vtkm::cont::ArrayHandle<T, Storage>& values,
+                               vtkm::Id n,
+                               BinaryCompare binary_compare);
+
   /// \brief Unstable ascending sort of input array.
   ///
   /// Sorts the contents of \c values so that they in ascending value. Doesn't
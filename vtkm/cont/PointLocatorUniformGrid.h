@@ -20,9 +20,12 @@
 #ifndef vtk_m_cont_PointLocatorUniformGrid_h
 #define vtk_m_cont_PointLocatorUniformGrid_h
 
+#include <vtkm/Math.h>
 #include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleGroupVecVariable.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/TryExecute.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
@@ -68,6 +71,9 @@ public:
     VTKM_EXEC void operator()(const CoordVecType& coord, IdType& label) const
     {
       vtkm::Vec<vtkm::Id, 3> ijk = (coord - Min) / Dxdydz;
+      // points on the upper bounds go to the last cells
+      ijk = vtkm::Max(ijk, vtkm::Id3(0));
+      ijk = vtkm::Min(ijk, Dims - vtkm::Id3(1));
       label = ijk[0] + ijk[1] * Dims[0] + ijk[2] * Dims[0] * Dims[1];
     }
 
@@ -111,10 +117,13 @@ public:
       Algorithm::SortByKey(this->Self->cellIds, this->Self->pointIds);
 
       // for each cell, find the lower and upper bound of indices to the sorted point ids.
-      vtkm::cont::ArrayHandleCounting<vtkm::Id> cell_ids_counting(
-        0, 1, this->Self->Dims[0] * this->Self->Dims[1] * this->Self->Dims[2]);
-      Algorithm::UpperBounds(this->Self->cellIds, cell_ids_counting, this->Self->cellUpper);
-      Algorithm::LowerBounds(this->Self->cellIds, cell_ids_counting, this->Self->cellLower);
+      // These are the exclusive and inclusive sums of the number of points in each cell.
+      vtkm::cont::ArrayHandle<vtkm::Id> cellCounts;
+      Algorithm::Histogram(this->Self->cellIds,
+                           this->Self->Dims[0] * this->Self->Dims[1] * this->Self->Dims[2],
+                           cellCounts);
+      Algorithm::ScanExclusive(cellCounts, this->Self->cellLower);
+      Algorithm::ScanInclusive(cellCounts, this->Self->cellUpper);
 
       return true;
     }
@@ -170,6 +179,212 @@ public:
     return ExecHandle;
   }
 
+  /// Gives worklets the non-virtual neighbor search over the bins.
+  ///
+  struct NeighborSearchObject : public vtkm::cont::ExecutionObjectBase
+  {
+    VTKM_CONT
+    NeighborSearchObject(const vtkm::cont::PointLocatorUniformGrid* self)
+      : Self(self)
+    {
+    }
+
+    const vtkm::cont::PointLocatorUniformGrid* Self;
+
+    template <typename DeviceAdapter>
+    VTKM_CONT vtkm::exec::UniformGridNeighborSearch<DeviceAdapter> PrepareForExecution(
+      DeviceAdapter) const
+    {
+      return vtkm::exec::UniformGridNeighborSearch<DeviceAdapter>(
+        this->Self->Min,
+        this->Self->Max,
+        this->Self->Dims,
+        this->Self->coords.PrepareForInput(DeviceAdapter()),
+        this->Self->pointIds.PrepareForInput(DeviceAdapter()),
+        this->Self->cellLower.PrepareForInput(DeviceAdapter()),
+        this->Self->cellUpper.PrepareForInput(DeviceAdapter()));
+    }
+  };
+
+  class KNearestNeighborsWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn<> qcIn,
+                                  ExecObject search,
+                                  WholeArrayOut<> knnIdOut,
+                                  WholeArrayOut<> knnDistOut);
+    using ExecutionSignature = void(_1, _2, _3, _4, WorkIndex);
+
+    VTKM_CONT
+    KNearestNeighborsWorklet(vtkm::Id k)
+      : K(k)
+    {
+    }
+
+    template <typename CoordVecType,
+              typename SearchType,
+              typename IdPortalType,
+              typename DistancePortalType>
+    VTKM_EXEC void operator()(const CoordVecType& qc,
+                              const SearchType& search,
+                              const IdPortalType& knnIds,
+                              const DistancePortalType& knnDistances,
+                              vtkm::Id queryIndex) const
+    {
+      using HeapType = vtkm::exec::internal::NeighborHeap<IdPortalType, DistancePortalType>;
+      vtkm::Id offset = queryIndex * this->K;
+      HeapType heap(knnIds, knnDistances, offset, this->K);
+      vtkm::exec::internal::KNearestVisitor<HeapType> visitor{ heap };
+      search.VisitNeighbors(vtkm::Vec<vtkm::FloatDefault, 3>(qc), visitor);
+      heap.Finish();
+
+      for (vtkm::Id i = offset; i < offset + this->K; ++i)
+      {
+        knnDistances.Set(i, vtkm::Sqrt(knnDistances.Get(i)));
+      }
+    }
+
+  private:
+    vtkm::Id K;
+  };
+
+  class RadiusCountWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn<> qcIn, ExecObject search, FieldOut<> countOut);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    VTKM_CONT
+    RadiusCountWorklet(vtkm::Float64 radius)
+      : Radius(radius)
+    {
+    }
+
+    template <typename CoordVecType, typename SearchType>
+    VTKM_EXEC void operator()(const CoordVecType& qc,
+                              const SearchType& search,
+                              vtkm::IdComponent& count) const
+    {
+      vtkm::FloatDefault radius = static_cast<vtkm::FloatDefault>(this->Radius);
+      vtkm::exec::internal::RadiusCountVisitor<vtkm::FloatDefault> visitor{ radius * radius, 0 };
+      search.VisitNeighbors(vtkm::Vec<vtkm::FloatDefault, 3>(qc), visitor);
+      count = visitor.Count;
+    }
+
+  private:
+    vtkm::Float64 Radius;
+  };
+
+  class RadiusFillWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn<> qcIn,
+                                  FieldIn<> offsetIn,
+                                  ExecObject search,
+                                  WholeArrayOut<> neighborIdOut,
+                                  WholeArrayOut<> neighborDistOut);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5);
+
+    VTKM_CONT
+    RadiusFillWorklet(vtkm::Float64 radius)
+      : Radius(radius)
+    {
+    }
+
+    template <typename CoordVecType,
+              typename SearchType,
+              typename IdPortalType,
+              typename DistancePortalType>
+    VTKM_EXEC void operator()(const CoordVecType& qc,
+                              vtkm::Id offset,
+                              const SearchType& search,
+                              const IdPortalType& neighborIds,
+                              const DistancePortalType& neighborDistances) const
+    {
+      vtkm::FloatDefault radius = static_cast<vtkm::FloatDefault>(this->Radius);
+      vtkm::exec::internal::RadiusFillVisitor<IdPortalType, DistancePortalType> visitor{
+        radius * radius, offset, neighborIds, neighborDistances
+      };
+      search.VisitNeighbors(vtkm::Vec<vtkm::FloatDefault, 3>(qc), visitor);
+
+      for (vtkm::Id i = offset; i < visitor.Offset; ++i)
+      {
+        neighborDistances.Set(i, vtkm::Sqrt(neighborDistances.Get(i)));
+      }
+    }
+
+  private:
+    vtkm::Float64 Radius;
+  };
+
+  /// \brief Find the \c k nearest neighbors of each query point.
+  ///
+  /// Each query keeps a bounded heap of its \c k best candidates in its own slice of the
+  /// output arrays and searches rings of bins around its own bin until the next ring is
+  /// farther than its k-th candidate. \c k is clamped to the number of points. The neighbors
+  /// of query \c i are stored in entries [i * k, (i + 1) * k) of \c neighborIds and
+  /// \c distances, sorted by increasing distance. \c Build must have been called.
+  ///
+  /// \return The number of neighbors found for each query, that is the clamped \c k.
+  template <typename QueryHandleType, typename DeviceAdapter>
+  VTKM_CONT vtkm::Id FindKNearestNeighbors(
+    const QueryHandleType& queryPoints,
+    vtkm::Id k,
+    vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault>& distances,
+    DeviceAdapter) const
+  {
+    VTKM_IS_ARRAY_HANDLE(QueryHandleType);
+    if (k < 0)
+    {
+      throw vtkm::cont::ErrorBadValue("Number of nearest neighbors must not be negative.");
+    }
+    k = vtkm::Min(k, this->pointIds.GetNumberOfValues());
+
+    neighborIds.Allocate(queryPoints.GetNumberOfValues() * k);
+    distances.Allocate(queryPoints.GetNumberOfValues() * k);
+
+    vtkm::worklet::DispatcherMapField<KNearestNeighborsWorklet, DeviceAdapter> dispatcher(
+      KNearestNeighborsWorklet{ k });
+    NeighborSearchObject search(this);
+    dispatcher.Invoke(queryPoints, search, neighborIds, distances);
+    return k;
+  }
+
+  /// \brief Find all points within \c radius of each query point.
+  ///
+  /// The result is in compressed sparse row form. A first pass counts the neighbors of each
+  /// query into \c numNeighbors, which are scanned into \c offsets. A second pass writes the
+  /// neighbors of query \c i, in no particular order, from \c offsets[i] on into
+  /// \c neighborIds and their distances into \c distances. Points at exactly
+  /// \c radius are included. \c Build must have been called.
+  template <typename QueryHandleType, typename DeviceAdapter>
+  VTKM_CONT void FindNeighborsInRadius(const QueryHandleType& queryPoints,
+                                       vtkm::Float64 radius,
+                                       vtkm::cont::ArrayHandle<vtkm::IdComponent>& numNeighbors,
+                                       vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+                                       vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+                                       vtkm::cont::ArrayHandle<vtkm::FloatDefault>& distances,
+                                       DeviceAdapter device) const
+  {
+    VTKM_IS_ARRAY_HANDLE(QueryHandleType);
+    NeighborSearchObject search(this);
+
+    vtkm::worklet::DispatcherMapField<RadiusCountWorklet, DeviceAdapter> countDispatcher(
+      RadiusCountWorklet{ radius });
+    countDispatcher.Invoke(queryPoints, search, numNeighbors);
+
+    vtkm::Id totalNeighbors;
+    vtkm::cont::ConvertNumComponentsToOffsets(numNeighbors, offsets, totalNeighbors, device);
+
+    neighborIds.Allocate(totalNeighbors);
+    distances.Allocate(totalNeighbors);
+
+    vtkm::worklet::DispatcherMapField<RadiusFillWorklet, DeviceAdapter> fillDispatcher(
+      RadiusFillWorklet{ radius });
+    fillDispatcher.Invoke(queryPoints, offsets, search, neighborIds, distances);
+  }
+
 private:
   vtkm::Vec<vtkm::FloatDefault, 3> Min;
   vtkm::Vec<vtkm::FloatDefault, 3> Max;
@@ -819,6 +819,32 @@ public:
     return true;
   }
 
+  template <typename T, class SIn>
+  VTKM_CONT static void Histogram(
+    const vtkm::cont::ArrayHandle<T, SIn>& input,
+    vtkm::Id numberOfBins,
+    vtkm::cont::ArrayHandle<vtkm::Id, vtkm::cont::StorageTagBasic>& output)
+  {
+    if (numberOfBins <= 0)
+    {
+      output.Shrink(0);
+      return;
+    }
+
+    // There are far more threads than blocks the general implementation would
+    // privatize the bins for, so count directly with atomic adds.
+    auto inputPortal = input.PrepareForInput(DeviceAdapterTagCuda());
+    auto outputPortal = output.PrepareForOutput(numberOfBins, DeviceAdapterTagCuda());
+    vtkm::cont::internal::SetConstantKernel<decltype(outputPortal)> clearKernel(outputPortal, 0);
+    Schedule(clearKernel, numberOfBins);
+
+    using AtomicType =
+      vtkm::cont::DeviceAdapterAtomicArrayImplementation<vtkm::Id, DeviceAdapterTagCuda>;
+    vtkm::cont::internal::HistogramAtomicKernel<decltype(inputPortal), AtomicType> countKernel(
+      inputPortal, AtomicType(output), numberOfBins);
+    Schedule(countKernel, input.GetNumberOfValues());
+  }
+
   template <typename T, class SIn, class SVal, class SOut>
   VTKM_CONT static void LowerBounds(const vtkm::cont::ArrayHandle<T, SIn>& input,
                                     const vtkm::cont::ArrayHandle<T, SVal>& values,
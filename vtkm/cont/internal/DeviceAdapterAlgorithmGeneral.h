@@ -240,6 +240,60 @@ public:
     return true;
   }
 
+  //--------------------------------------------------------------------------
+  // Histogram
+  template <typename T, class CIn>
+  VTKM_CONT static void Histogram(
+    const vtkm::cont::ArrayHandle<T, CIn>& input,
+    vtkm::Id numberOfBins,
+    vtkm::cont::ArrayHandle<vtkm::Id, vtkm::cont::StorageTagBasic>& output)
+  {
+    const vtkm::Id numberOfValues = input.GetNumberOfValues();
+    if (numberOfBins <= 0)
+    {
+      output.Shrink(0);
+      return;
+    }
+
+    // Blocks that count a part of the input into their own bins need no
+    // atomics, but each block has to clear its bins and every bin has to be
+    // merged over all blocks. That is only worth it when the bins are small
+    // compared to the part of the input a block counts. Otherwise all values
+    // are counted into the output with atomic adds.
+    const vtkm::Id maxNumberOfBlocks = 256;
+    const vtkm::Id minNumberOfBlocks = 16;
+    const vtkm::Id numberOfBlocks =
+      vtkm::Min(numberOfValues / (numberOfBins * 8), maxNumberOfBlocks);
+
+    auto inputPortal = input.PrepareForInput(DeviceAdapterTag());
+    if (numberOfBlocks < minNumberOfBlocks)
+    {
+      auto outputPortal = output.PrepareForOutput(numberOfBins, DeviceAdapterTag());
+      SetConstantKernel<decltype(outputPortal)> clearKernel(outputPortal, 0);
+      DerivedAlgorithm::Schedule(clearKernel, numberOfBins);
+
+      using AtomicType =
+        vtkm::cont::DeviceAdapterAtomicArrayImplementation<vtkm::Id, DeviceAdapterTag>;
+      HistogramAtomicKernel<decltype(inputPortal), AtomicType> countKernel(
+        inputPortal, AtomicType(output), numberOfBins);
+      DerivedAlgorithm::Schedule(countKernel, numberOfValues);
+      return;
+    }
+
+    const vtkm::Id blockSize = (numberOfValues + numberOfBlocks - 1) / numberOfBlocks;
+    vtkm::cont::ArrayHandle<vtkm::Id, vtkm::cont::StorageTagBasic> blockCounts;
+    auto blockCountsPortal =
+      blockCounts.PrepareForOutput(numberOfBlocks * numberOfBins, DeviceAdapterTag());
+    HistogramBlockKernel<decltype(inputPortal), decltype(blockCountsPortal)> countKernel(
+      inputPortal, blockCountsPortal, numberOfBins, blockSize);
+    DerivedAlgorithm::Schedule(countKernel, numberOfBlocks);
+
+    auto outputPortal = output.PrepareForOutput(numberOfBins, DeviceAdapterTag());
+    HistogramMergeKernel<decltype(blockCountsPortal), decltype(outputPortal)> mergeKernel(
+      blockCountsPortal, outputPortal, numberOfBlocks);
+    DerivedAlgorithm::Schedule(mergeKernel, numberOfBins);
+  }
+
   //--------------------------------------------------------------------------
   // Lower Bounds
   template <typename T, class CIn, class CVal, class COut>
@@ -698,6 +752,120 @@ public:
     }
   }
 
+  //--------------------------------------------------------------------------
+  // Select Nth
+  template <typename T, class Storage>
+  VTKM_CONT static T SelectNth(const vtkm::cont::ArrayHandle<T, Storage>& values, vtkm::Id n)
+  {
+    return DerivedAlgorithm::SelectNth(values, n, vtkm::SortLess());
+  }
+
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static T SelectNth(const vtkm::cont::ArrayHandle<T, Storage>& values,
+                               vtkm::Id n,
+                               BinaryCompare binary_compare)
+  {
+    VTKM_ASSERT(n >= 0 && n < values.GetNumberOfValues());
+
+    vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagBasic> candidates;
+    T result;
+    if (SelectNthPass(values, n, binary_compare, candidates, result))
+    {
+      return result;
+    }
+    // Every pass leaves out at least the pivots, usually almost all values
+    while (true)
+    {
+      vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagBasic> remaining = candidates;
+      candidates = vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagBasic>();
+      if (SelectNthPass(remaining, n, binary_compare, candidates, result))
+      {
+        return result;
+      }
+    }
+  }
+
+private:
+  // One pass of the selection. Two pivots around the expected position of
+  // the n-th value are taken from a sorted sample of the input, and the values
+  // are classified against them. Returns true with the result when the n-th
+  // value is a pivot (or the input was small enough to sort); otherwise the
+  // values in the class that holds the n-th one are copied to candidates and n
+  // is made relative to them.
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static bool SelectNthPass(const vtkm::cont::ArrayHandle<T, Storage>& input,
+                                      vtkm::Id& n,
+                                      BinaryCompare binary_compare,
+                                      vtkm::cont::ArrayHandle<T, StorageTagBasic>& candidates,
+                                      T& result)
+  {
+    using BasicArrayType = vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagBasic>;
+
+    const vtkm::Id maxSortSize = 1 << 14;
+    const vtkm::Id sampleSize = 1 << 10;
+    // The n-th value is between the pivots unless the sample is off by
+    // more than a few standard deviations (~sqrt(sampleSize) / 2 positions)
+    const vtkm::Id pivotMargin = 32;
+
+    const vtkm::Id numberOfValues = input.GetNumberOfValues();
+    if (numberOfValues <= maxSortSize)
+    {
+      BasicArrayType sorted;
+      DerivedAlgorithm::Copy(input, sorted);
+      DerivedAlgorithm::Sort(sorted, binary_compare);
+      result = GetExecutionValue(sorted, n);
+      return true;
+    }
+
+    BasicArrayType sample;
+    {
+      auto inputPortal = input.PrepareForInput(DeviceAdapterTag());
+      auto samplePortal = sample.PrepareForOutput(sampleSize, DeviceAdapterTag());
+      SelectSampleKernel<decltype(inputPortal), decltype(samplePortal)> sampleKernel(
+        inputPortal, samplePortal, numberOfValues / sampleSize);
+      DerivedAlgorithm::Schedule(sampleKernel, sampleSize);
+    }
+    DerivedAlgorithm::Sort(sample, binary_compare);
+
+    const vtkm::Float64 fraction =
+      static_cast<vtkm::Float64>(n) / static_cast<vtkm::Float64>(numberOfValues);
+    const vtkm::Id samplePosition =
+      static_cast<vtkm::Id>(fraction * static_cast<vtkm::Float64>(sampleSize));
+    auto samplePortal = sample.GetPortalConstControl();
+    const T low = samplePortal.Get(vtkm::Max(samplePosition - pivotMargin, vtkm::Id(0)));
+    const T high = samplePortal.Get(vtkm::Min(samplePosition + pivotMargin, sampleSize - 1));
+
+    vtkm::cont::ArrayHandle<vtkm::UInt8, vtkm::cont::StorageTagBasic> classes;
+    {
+      auto inputPortal = input.PrepareForInput(DeviceAdapterTag());
+      auto classPortal = classes.PrepareForOutput(numberOfValues, DeviceAdapterTag());
+      SelectClassifyKernel<decltype(inputPortal), decltype(classPortal), BinaryCompare>
+        classifyKernel(inputPortal, classPortal, low, high, binary_compare);
+      DerivedAlgorithm::Schedule(classifyKernel, numberOfValues);
+    }
+    vtkm::cont::ArrayHandle<vtkm::Id, vtkm::cont::StorageTagBasic> classCounts;
+    DerivedAlgorithm::Histogram(classes, 5, classCounts);
+
+    auto classCountsPortal = classCounts.GetPortalConstControl();
+    vtkm::Id classStart = 0;
+    vtkm::UInt8 nthClass = 0;
+    while (n >= classStart + classCountsPortal.Get(nthClass))
+    {
+      classStart += classCountsPortal.Get(nthClass);
+      nthClass++;
+    }
+    if (nthClass == 1 || nthClass == 3)
+    {
+      result = (nthClass == 1) ? low : high;
+      return true;
+    }
+
+    DerivedAlgorithm::CopyIf(input, classes, candidates, SelectClassEqual(nthClass));
+    n -= classStart;
+    return false;
+  }
+
+public:
   //--------------------------------------------------------------------------
   // Sort
   template <typename T, class Storage, class BinaryCompare>
@@ -366,6 +366,119 @@ struct CopyKernel
   void SetErrorMessageBuffer(const vtkm::exec::internal::ErrorMessageBuffer&) {}
 };
 
+template <class InputPortalType, class CountsPortalType>
+struct HistogramBlockKernel
+{
+  InputPortalType InputPortal;
+  CountsPortalType CountsPortal;
+  vtkm::Id NumberOfBins;
+  vtkm::Id BlockSize;
+
+  VTKM_CONT
+  HistogramBlockKernel(InputPortalType inputPortal,
+                       CountsPortalType countsPortal,
+                       vtkm::Id numberOfBins,
+                       vtkm::Id blockSize)
+    : InputPortal(inputPortal)
+    , CountsPortal(countsPortal)
+    , NumberOfBins(numberOfBins)
+    , BlockSize(blockSize)
+  {
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT
+  void operator()(vtkm::Id block) const
+  {
+    // Every block counts its part of the input into its own row of bins.
+    const vtkm::Id offset = block * this->NumberOfBins;
+    for (vtkm::Id bin = 0; bin < this->NumberOfBins; ++bin)
+    {
+      this->CountsPortal.Set(offset + bin, 0);
+    }
+
+    const vtkm::Id begin = block * this->BlockSize;
+    const vtkm::Id end = vtkm::Min(begin + this->BlockSize, this->InputPortal.GetNumberOfValues());
+    for (vtkm::Id index = begin; index < end; ++index)
+    {
+      const vtkm::Id bin = static_cast<vtkm::Id>(this->InputPortal.Get(index));
+      if (bin >= 0 && bin < this->NumberOfBins)
+      {
+        this->CountsPortal.Set(offset + bin, this->CountsPortal.Get(offset + bin) + 1);
+      }
+    }
+  }
+
+  VTKM_CONT
+  void SetErrorMessageBuffer(const vtkm::exec::internal::ErrorMessageBuffer&) {}
+};
+
+template <class CountsPortalType, class OutputPortalType>
+struct HistogramMergeKernel
+{
+  CountsPortalType CountsPortal;
+  OutputPortalType OutputPortal;
+  vtkm::Id NumberOfBlocks;
+
+  VTKM_CONT
+  HistogramMergeKernel(CountsPortalType countsPortal,
+                       OutputPortalType outputPortal,
+                       vtkm::Id numberOfBlocks)
+    : CountsPortal(countsPortal)
+    , OutputPortal(outputPortal)
+    , NumberOfBlocks(numberOfBlocks)
+  {
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT
+  void operator()(vtkm::Id bin) const
+  {
+    const vtkm::Id numberOfBins = this->OutputPortal.GetNumberOfValues();
+    vtkm::Id count = 0;
+    for (vtkm::Id block = 0; block < this->NumberOfBlocks; ++block)
+    {
+      count += this->CountsPortal.Get(block * numberOfBins + bin);
+    }
+    this->OutputPortal.Set(bin, count);
+  }
+
+  VTKM_CONT
+  void SetErrorMessageBuffer(const vtkm::exec::internal::ErrorMessageBuffer&) {}
+};
+
+template <class InputPortalType, class AtomicCountsType>
+struct HistogramAtomicKernel
+{
+  InputPortalType InputPortal;
+  AtomicCountsType Counts;
+  vtkm::Id NumberOfBins;
+
+  VTKM_CONT
+  HistogramAtomicKernel(InputPortalType inputPortal,
+                        AtomicCountsType counts,
+                        vtkm::Id numberOfBins)
+    : InputPortal(inputPortal)
+    , Counts(counts)
+    , NumberOfBins(numberOfBins)
+  {
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT
+  void operator()(vtkm::Id index) const
+  {
+    const vtkm::Id bin = static_cast<vtkm::Id>(this->InputPortal.Get(index));
+    if (bin >= 0 && bin < this->NumberOfBins)
+    {
+      this->Counts.Add(bin, 1);
+    }
+  }
+
+  VTKM_CONT
+  void SetErrorMessageBuffer(const vtkm::exec::internal::ErrorMessageBuffer&) {}
+};
+
 template <class InputPortalType, class ValuesPortalType, class OutputPortalType>
 struct LowerBoundsKernel
 {
@@ -458,6 +571,109 @@ struct LowerBoundsComparisonKernel
   void SetErrorMessageBuffer(const vtkm::exec::internal::ErrorMessageBuffer&) {}
 };
 
+template <class InputPortalType, class OutputPortalType>
+struct SelectSampleKernel
+{
+  InputPortalType InputPortal;
+  OutputPortalType OutputPortal;
+  vtkm::Id Stride;
+
+  VTKM_CONT
+  SelectSampleKernel(const InputPortalType& inputPortal,
+                     const OutputPortalType& outputPortal,
+                     vtkm::Id stride)
+    : InputPortal(inputPortal)
+    , OutputPortal(outputPortal)
+    , Stride(stride)
+  {
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC
+  void operator()(vtkm::Id index) const
+  {
+    this->OutputPortal.Set(index, this->InputPortal.Get(index * this->Stride));
+  }
+
+  VTKM_CONT
+  void SetErrorMessageBuffer(const vtkm::exec::internal::ErrorMessageBuffer&) {}
+};
+
+// Classes of a value compared with the two pivots of a selection pass:
+// 0 below low, 1 equivalent to low, 2 between low and high, 3 equivalent to
+// high, 4 above high.
+template <class InputPortalType, class ClassPortalType, class BinaryCompare>
+struct SelectClassifyKernel
+{
+  using ValueType = typename InputPortalType::ValueType;
+
+  InputPortalType InputPortal;
+  ClassPortalType ClassPortal;
+  ValueType Low;
+  ValueType High;
+  BinaryCompare Compare;
+
+  VTKM_CONT
+  SelectClassifyKernel(const InputPortalType& inputPortal,
+                       const ClassPortalType& classPortal,
+                       const ValueType& low,
+                       const ValueType& high,
+                       BinaryCompare compare)
+    : InputPortal(inputPortal)
+    , ClassPortal(classPortal)
+    , Low(low)
+    , High(high)
+    , Compare(compare)
+  {
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC
+  void operator()(vtkm::Id index) const
+  {
+    const ValueType value = this->InputPortal.Get(index);
+    vtkm::UInt8 valueClass;
+    if (this->Compare(value, this->Low))
+    {
+      valueClass = 0;
+    }
+    else if (!this->Compare(this->Low, value))
+    {
+      valueClass = 1;
+    }
+    else if (this->Compare(value, this->High))
+    {
+      valueClass = 2;
+    }
+    else if (!this->Compare(this->High, value))
+    {
+      valueClass = 3;
+    }
+    else
+    {
+      valueClass = 4;
+    }
+    this->ClassPortal.Set(index, valueClass);
+  }
+
+  VTKM_CONT
+  void SetErrorMessageBuffer(const vtkm::exec::internal::ErrorMessageBuffer&) {}
+};
+
+struct SelectClassEqual
+{
+  vtkm::UInt8 Class;
+
+  VTKM_EXEC_CONT
+  SelectClassEqual(vtkm::UInt8 valueClass = 0)
+    : Class(valueClass)
+  {
+  }
+
+  VTKM_EXEC_CONT
+  bool operator()(vtkm::UInt8 valueClass) const { return valueClass == this->Class; }
+};
+
 template <typename PortalType>
 struct SetConstantKernel
 {
@@ -26,6 +26,7 @@
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
 #include <vtkm/cont/ErrorExecution.h>
 #include <vtkm/cont/internal/DeviceAdapterAlgorithmGeneral.h>
+#include <vtkm/cont/serial/internal/ArrayManagerExecutionSerial.h>
 #include <vtkm/cont/serial/internal/DeviceAdapterTagSerial.h>
 
 #include <vtkm/BinaryOperators.h>
@@ -36,6 +37,7 @@
 #include <iterator>
 #include <numeric>
 #include <type_traits>
+#include <vector>
 
 namespace vtkm
 {
@@ -198,6 +200,29 @@ public:
     return true;
   }
 
+  template <typename T, class CIn>
+  VTKM_CONT static void Histogram(
+    const vtkm::cont::ArrayHandle<T, CIn>& input,
+    vtkm::Id numberOfBins,
+    vtkm::cont::ArrayHandle<vtkm::Id, vtkm::cont::StorageTagBasic>& output)
+  {
+    numberOfBins = vtkm::Max(numberOfBins, vtkm::Id(0));
+    auto inputPortal = input.PrepareForInput(Device());
+    auto outputPortal = output.PrepareForOutput(numberOfBins, Device());
+    auto outIter = vtkm::cont::ArrayPortalToIteratorBegin(outputPortal);
+    std::fill(outIter, outIter + numberOfBins, vtkm::Id(0));
+
+    const vtkm::Id numberOfValues = inputPortal.GetNumberOfValues();
+    for (vtkm::Id index = 0; index < numberOfValues; ++index)
+    {
+      const vtkm::Id bin = static_cast<vtkm::Id>(inputPortal.Get(index));
+      if (bin >= 0 && bin < numberOfBins)
+      {
+        ++outIter[bin];
+      }
+    }
+  }
+
   template <typename T, typename U, class CIn>
   VTKM_CONT static U Reduce(const vtkm::cont::ArrayHandle<T, CIn>& input, U initialValue)
   {
@@ -379,6 +404,27 @@ public:
     ScheduleTask(kernel, size);
   }
 
+  template <typename T, class Storage>
+  VTKM_CONT static T SelectNth(const vtkm::cont::ArrayHandle<T, Storage>& values, vtkm::Id n)
+  {
+    return SelectNth(values, n, std::less<T>());
+  }
+
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static T SelectNth(const vtkm::cont::ArrayHandle<T, Storage>& values,
+                               vtkm::Id n,
+                               BinaryCompare binary_compare)
+  {
+    VTKM_ASSERT(n >= 0 && n < values.GetNumberOfValues());
+
+    auto inputPortal = values.PrepareForInput(Device());
+    std::vector<T> copy(vtkm::cont::ArrayPortalToIteratorBegin(inputPortal),
+                        vtkm::cont::ArrayPortalToIteratorEnd(inputPortal));
+    internal::WrappedBinaryOperator<bool, BinaryCompare> wrappedCompare(binary_compare);
+    std::nth_element(copy.begin(), copy.begin() + n, copy.end(), wrappedCompare);
+    return copy[static_cast<std::size_t>(n)];
+  }
+
 private:
   template <typename Vin,
             typename I,
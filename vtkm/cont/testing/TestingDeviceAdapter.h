@@ -1249,6 +1249,95 @@ private:
     VTKM_TEST_ASSERT(value == OFFSET, "Got bad unique value");
   }
 
+  static VTKM_CONT void TestHistogram()
+  {
+    std::cout << "-------------------------------------------" << std::endl;
+    std::cout << "Testing Histogram" << std::endl;
+
+    // Few bins are counted into private bins per block, many bins with atomics.
+    const vtkm::Id binCounts[] = { 50, ARRAY_SIZE / 2 };
+    for (vtkm::Id numberOfBins : binCounts)
+    {
+      std::cout << "  " << numberOfBins << " bins" << std::endl;
+      std::vector<vtkm::Id> testData(ARRAY_SIZE);
+      std::vector<vtkm::Id> expected(static_cast<std::size_t>(numberOfBins), 0);
+      for (std::size_t i = 0; i < ARRAY_SIZE; ++i)
+      {
+        // Includes values below and above the valid bins, which are skipped.
+        const std::size_t range = static_cast<std::size_t>(numberOfBins + 3);
+        vtkm::Id bin = static_cast<vtkm::Id>((i * 7) % range) - 1;
+        testData[i] = bin;
+        if (bin >= 0 && bin < numberOfBins)
+        {
+          ++expected[static_cast<std::size_t>(bin)];
+        }
+      }
+
+      IdArrayHandle input = vtkm::cont::make_ArrayHandle(testData);
+      IdArrayHandle counts;
+      Algorithm::Histogram(input, numberOfBins, counts);
+      VTKM_TEST_ASSERT(counts.GetNumberOfValues() == numberOfBins, "Wrong number of bins");
+      auto portal = counts.GetPortalConstControl();
+      for (vtkm::Id bin = 0; bin < numberOfBins; ++bin)
+      {
+        VTKM_TEST_ASSERT(portal.Get(bin) == expected[static_cast<std::size_t>(bin)],
+                         "Got bad count from Histogram");
+      }
+    }
+
+    IdArrayHandle empty;
+    IdArrayHandle counts;
+    Algorithm::Histogram(empty, 10, counts);
+    VTKM_TEST_ASSERT(counts.GetNumberOfValues() == 10, "Wrong number of bins for empty input");
+    VTKM_TEST_ASSERT(Algorithm::Reduce(counts, vtkm::Id(0)) == 0, "Empty input has counts");
+  }
+
+  static VTKM_CONT void TestSelectNth()
+  {
+    std::cout << "-------------------------------------------" << std::endl;
+    std::cout << "Testing SelectNth" << std::endl;
+
+    // Large enough to narrow down the values over several passes, with
+    // repeated values.
+    const vtkm::Id numberOfValues = 100000;
+    std::vector<vtkm::Id> testData(static_cast<std::size_t>(numberOfValues));
+    for (std::size_t i = 0; i < testData.size(); ++i)
+    {
+      testData[i] = static_cast<vtkm::Id>((i * 7919) % 5003);
+    }
+    IdArrayHandle input = vtkm::cont::make_ArrayHandle(testData);
+
+    std::vector<vtkm::Id> sorted(testData);
+    std::sort(sorted.begin(), sorted.end());
+    const vtkm::Id positions[] = { 0, 1, 777, numberOfValues / 2, numberOfValues - 1 };
+    for (vtkm::Id n : positions)
+    {
+      const vtkm::Id nth = Algorithm::SelectNth(input, n);
+      VTKM_TEST_ASSERT(nth == sorted[static_cast<std::size_t>(n)], "Got bad value from SelectNth");
+
+      const vtkm::Id nthGreater = Algorithm::SelectNth(input, n, vtkm::SortGreater());
+      VTKM_TEST_ASSERT(nthGreater == sorted[static_cast<std::size_t>(numberOfValues - 1 - n)],
+                       "Got bad value from SelectNth with comparison object");
+    }
+    VTKM_TEST_ASSERT(input.GetPortalConstControl().Get(0) == testData[0] &&
+                       input.GetPortalConstControl().Get(numberOfValues - 1) == testData.back(),
+                     "SelectNth modified its input");
+
+    // All values equal to a pivot
+    IdArrayHandle constant;
+    Algorithm::Copy(vtkm::cont::ArrayHandleConstant<vtkm::Id>(OFFSET, numberOfValues), constant);
+    VTKM_TEST_ASSERT(Algorithm::SelectNth(constant, numberOfValues / 3) == OFFSET,
+                     "Got bad value from SelectNth of constant array");
+
+    // Small arrays are sorted directly
+    IdArrayHandle small;
+    small.Allocate(3);
+    small.GetPortalControl().Set(0, 5);
+    small.GetPortalControl().Set(1, -2);
+    small.GetPortalControl().Set(2, 9);
+    VTKM_TEST_ASSERT(Algorithm::SelectNth(small, 1) == 5, "Got bad value from small SelectNth");
+  }
+
   static VTKM_CONT void TestReduce()
   {
     std::cout << "-------------------------------------------" << std::endl;
@@ -2458,6 +2547,9 @@ private:
       TestOrderedUniqueValues(); //tests Copy, LowerBounds, Sort, Unique
       TestCopyIf();
 
+      TestHistogram();
+      TestSelectNth();
+
       TestCopyArraysMany();
       TestCopyArraysInDiffTypes();
 
@@ -23,7 +23,9 @@
 
 //#define VTKM_DEVICE_ADAPTER VTKM_DEVICE_ADAPTER_SERIAL
 
+#include <algorithm>
 #include <random>
+#include <vector>
 
 #include <vtkm/cont/testing/Testing.h>
 
@@ -176,10 +178,110 @@ public:
     VTKM_TEST_ASSERT(passTest, "Uniform Grid NN search result incorrect.");
   }
 
+  void TestKNearestAndRadius() const
+  {
+    vtkm::Int32 nTrainingPoints = 1000;
+    vtkm::Int32 nTestingPoint = 100;
+    const vtkm::Id k = 6;
+    const vtkm::Float64 radius = 1.2;
+
+    std::default_random_engine dre;
+    std::uniform_real_distribution<vtkm::Float32> dr(0.0f, 10.0f);
+
+    std::vector<vtkm::Vec<vtkm::Float32, 3>> coordi;
+    for (vtkm::Int32 i = 0; i < nTrainingPoints; i++)
+    {
+      coordi.push_back(vtkm::make_Vec(dr(dre), dr(dre), dr(dre)));
+    }
+    // query points also outside of the grid bounds
+    std::uniform_real_distribution<vtkm::Float32> dq(-2.0f, 12.0f);
+    std::vector<vtkm::Vec<vtkm::Float32, 3>> qcVec;
+    for (vtkm::Int32 i = 0; i < nTestingPoint; i++)
+    {
+      qcVec.push_back(vtkm::make_Vec(dq(dre), dq(dre), dq(dre)));
+    }
+    auto qc_Handle = vtkm::cont::make_ArrayHandle(qcVec);
+
+    vtkm::cont::CoordinateSystem coord("points", vtkm::cont::make_ArrayHandle(coordi));
+    vtkm::cont::PointLocatorUniformGrid locator(
+      { 0.0f, 0.0f, 0.0f }, { 10.0f, 10.0f, 10.0f }, { 8, 8, 8 });
+    locator.SetCoords(coord);
+    locator.Build();
+
+    vtkm::cont::ArrayHandle<vtkm::Id> knnId_Handle;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> knnDis_Handle;
+    vtkm::Id kFound =
+      locator.FindKNearestNeighbors(qc_Handle, k, knnId_Handle, knnDis_Handle, DeviceAdapter());
+    VTKM_TEST_ASSERT(kFound == k, "Wrong number of nearest neighbors.");
+
+    vtkm::cont::ArrayHandle<vtkm::IdComponent> numNeighbors_Handle;
+    vtkm::cont::ArrayHandle<vtkm::Id> offsets_Handle;
+    vtkm::cont::ArrayHandle<vtkm::Id> neighborId_Handle;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> neighborDis_Handle;
+    locator.FindNeighborsInRadius(qc_Handle,
+                                  radius,
+                                  numNeighbors_Handle,
+                                  offsets_Handle,
+                                  neighborId_Handle,
+                                  neighborDis_Handle,
+                                  DeviceAdapter());
+
+    auto knnIds = knnId_Handle.GetPortalConstControl();
+    auto knnDis = knnDis_Handle.GetPortalConstControl();
+    auto numNeighbors = numNeighbors_Handle.GetPortalConstControl();
+    auto offsets = offsets_Handle.GetPortalConstControl();
+    auto neighborIds = neighborId_Handle.GetPortalConstControl();
+    auto neighborDis = neighborDis_Handle.GetPortalConstControl();
+    // the locator compares squared distances at its own precision
+    const vtkm::FloatDefault radius2 =
+      static_cast<vtkm::FloatDefault>(radius) * static_cast<vtkm::FloatDefault>(radius);
+    for (vtkm::Int32 i = 0; i < nTestingPoint; i++)
+    {
+      std::vector<std::pair<vtkm::FloatDefault, vtkm::Id>> sorted;
+      for (vtkm::Int32 j = 0; j < nTrainingPoints; j++)
+      {
+        vtkm::Vec<vtkm::FloatDefault, 3> diff(coordi[j] - qcVec[i]);
+        sorted.push_back(std::make_pair(vtkm::MagnitudeSquared(diff), vtkm::Id(j)));
+      }
+      std::sort(sorted.begin(), sorted.end());
+
+      for (vtkm::Id n = 0; n < k; n++)
+      {
+        VTKM_TEST_ASSERT(test_equal(knnDis.Get(i * k + n), vtkm::Sqrt(sorted[n].first)),
+                         "Uniform Grid k-NN search distance incorrect.");
+      }
+      VTKM_TEST_ASSERT(knnIds.Get(i * k) == sorted[0].second,
+                       "Uniform Grid k-NN search result incorrect.");
+
+      std::vector<vtkm::Id> expected;
+      for (const auto& candidate : sorted)
+      {
+        if (candidate.first <= radius2)
+        {
+          expected.push_back(candidate.second);
+        }
+      }
+      std::vector<vtkm::Id> found;
+      for (vtkm::IdComponent n = 0; n < numNeighbors.Get(i); n++)
+      {
+        vtkm::Id pointId = neighborIds.Get(offsets.Get(i) + n);
+        VTKM_TEST_ASSERT(test_equal(neighborDis.Get(offsets.Get(i) + n),
+                                    vtkm::Magnitude(vtkm::Vec<vtkm::FloatDefault, 3>(
+                                      coordi[static_cast<std::size_t>(pointId)] - qcVec[i]))),
+                         "Uniform Grid radius search distance incorrect.");
+        found.push_back(pointId);
+      }
+      std::sort(found.begin(), found.end());
+      std::sort(expected.begin(), expected.end());
+      VTKM_TEST_ASSERT(found == expected, "Uniform Grid radius search result incorrect.");
+    }
+  }
+
   void operator()() const
   {
     vtkm::cont::GetGlobalRuntimeDeviceTracker().ForceDevice(DeviceAdapter());
     this->TestTest();
+    this->TestKNearestAndRadius();
   }
 };
 
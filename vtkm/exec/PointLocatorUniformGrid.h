@@ -27,6 +27,7 @@
 #include <vtkm/worklet/WorkletMapField.h>
 
 #include <vtkm/exec/PointLocator.h>
+#include <vtkm/exec/internal/NeighborSearch.h>
 
 #include <vtkm/VectorAnalysis.h>
 
@@ -241,6 +242,159 @@ private:
       queryPoint, planeCenter, div, mod, origin, numInPlane, nearestNeighborId, nearestDistance2);
   }
 };
+
+/// \brief k-nearest-neighbor and radius searches on the bins of a uniform grid.
+///
+/// Uses the same bins as \c PointLocatorUniformGrid but is not a virtual
+/// object, so its templated search can be called from worklets directly.
+/// Cells are visited in rings of growing distance around the cell holding the
+/// query point. The search stops when the next ring is farther away than the
+/// bound of the visitor, and cells of a ring that are farther than the bound
+/// are skipped.
+///
+template <typename DeviceAdapter>
+class UniformGridNeighborSearch
+{
+public:
+  using CoordPortalType = typename vtkm::cont::ArrayHandle<
+    vtkm::Vec<vtkm::FloatDefault, 3>>::template ExecutionTypes<DeviceAdapter>::PortalConst;
+  using IdPortalType =
+    typename vtkm::cont::ArrayHandle<vtkm::Id>::template ExecutionTypes<DeviceAdapter>::PortalConst;
+
+  UniformGridNeighborSearch() = default;
+
+  VTKM_CONT
+  UniformGridNeighborSearch(const vtkm::Vec<vtkm::FloatDefault, 3>& _min,
+                            const vtkm::Vec<vtkm::FloatDefault, 3>& _max,
+                            const vtkm::Vec<vtkm::Id, 3>& _dims,
+                            const CoordPortalType& _coords,
+                            const IdPortalType& _pointIds,
+                            const IdPortalType& _cellLower,
+                            const IdPortalType& _cellUpper)
+    : Min(_min)
+    , Dims(_dims)
+    , Dxdydz((_max - Min) / Dims)
+    , coords(_coords)
+    , pointIds(_pointIds)
+    , cellLower(_cellLower)
+    , cellUpper(_cellUpper)
+  {
+  }
+
+  /// Hands every point that may lie within the bound of \c visitor to it,
+  /// along with its squared distance to \c queryPoint.
+  ///
+  template <typename VisitorType>
+  VTKM_EXEC void VisitNeighbors(const vtkm::Vec<vtkm::FloatDefault, 3>& queryPoint,
+                                VisitorType& visitor) const
+  {
+    vtkm::Id3 ijk = (queryPoint - this->Min) / this->Dxdydz;
+    ijk = vtkm::Max(ijk, vtkm::Id3(0));
+    ijk = vtkm::Min(ijk, this->Dims - vtkm::Id3(1));
+
+    vtkm::Id maxLevel = vtkm::Max(vtkm::Max(this->Dims[0], this->Dims[1]), this->Dims[2]);
+    for (vtkm::Id level = 0; level < maxLevel; ++level)
+    {
+      vtkm::FloatDefault gap = vtkm::Infinity<vtkm::FloatDefault>();
+      for (vtkm::IdComponent d = 0; d < 3; ++d)
+      {
+        if (ijk[d] - level >= 0)
+        {
+          vtkm::FloatDefault face =
+            this->Min[d] + static_cast<vtkm::FloatDefault>(ijk[d] - level + 1) * this->Dxdydz[d];
+          gap = vtkm::Min(gap, queryPoint[d] - face);
+        }
+        if (ijk[d] + level < this->Dims[d])
+        {
+          vtkm::FloatDefault face =
+            this->Min[d] + static_cast<vtkm::FloatDefault>(ijk[d] + level) * this->Dxdydz[d];
+          gap = vtkm::Min(gap, face - queryPoint[d]);
+        }
+      }
+      if (gap == vtkm::Infinity<vtkm::FloatDefault>())
+      { // the previous rings covered the whole grid
+        break;
+      }
+      gap = vtkm::Max(gap, vtkm::FloatDefault(0));
+      if (level > 0 && gap * gap > visitor.GetBound())
+      {
+        break;
+      }
+      this->VisitRing(queryPoint, ijk, level, visitor);
+    }
+  }
+
+private:
+  vtkm::Vec<vtkm::FloatDefault, 3> Min;
+  vtkm::Vec<vtkm::Id, 3> Dims;
+  vtkm::Vec<vtkm::FloatDefault, 3> Dxdydz;
+
+  CoordPortalType coords;
+  IdPortalType pointIds;
+  IdPortalType cellLower;
+  IdPortalType cellUpper;
+
+  template <typename VisitorType>
+  VTKM_EXEC void VisitRing(const vtkm::Vec<vtkm::FloatDefault, 3>& queryPoint,
+                           const vtkm::Id3& center,
+                           vtkm::Id level,
+                           VisitorType& visitor) const
+  {
+    vtkm::Id3 lower = vtkm::Max(center - vtkm::Id3(level), vtkm::Id3(0));
+    vtkm::Id3 upper = vtkm::Min(center + vtkm::Id3(level), this->Dims - vtkm::Id3(1));
+    for (vtkm::Id k = lower[2]; k <= upper[2]; ++k)
+    {
+      bool kOnRing = vtkm::Abs(k - center[2]) == level;
+      for (vtkm::Id j = lower[1]; j <= upper[1]; ++j)
+      {
+        if (kOnRing || vtkm::Abs(j - center[1]) == level)
+        {
+          for (vtkm::Id i = lower[0]; i <= upper[0]; ++i)
+          {
+            this->VisitCell(queryPoint, vtkm::Id3(i, j, k), visitor);
+          }
+        }
+        else
+        { // only the two x faces of the ring
+          if (center[0] - level >= 0)
+          {
+            this->VisitCell(queryPoint, vtkm::Id3(center[0] - level, j, k), visitor);
+          }
+          if (level > 0 && center[0] + level < this->Dims[0])
+          {
+            this->VisitCell(queryPoint, vtkm::Id3(center[0] + level, j, k), visitor);
+          }
+        }
+      }
+    }
+  }
+
+  template <typename VisitorType>
+  VTKM_EXEC void VisitCell(const vtkm::Vec<vtkm::FloatDefault, 3>& queryPoint,
+                           const vtkm::Id3& ijk,
+                           VisitorType& visitor) const
+  {
+    // skip the cell when its box is beyond the bound
+    vtkm::Vec<vtkm::FloatDefault, 3> cellMin =
+      this->Min + vtkm::Vec<vtkm::FloatDefault, 3>(ijk) * this->Dxdydz;
+    vtkm::Vec<vtkm::FloatDefault, 3> outside =
+      vtkm::Max(vtkm::Max(cellMin - queryPoint, queryPoint - (cellMin + this->Dxdydz)),
+                vtkm::Vec<vtkm::FloatDefault, 3>(0));
+    if (vtkm::MagnitudeSquared(outside) > visitor.GetBound())
+    {
+      return;
+    }
+
+    vtkm::Id cellId = ijk[0] + (ijk[1] * this->Dims[0]) + (ijk[2] * this->Dims[0] * this->Dims[1]);
+    vtkm::Id lower = this->cellLower.Get(cellId);
+    vtkm::Id upper = this->cellUpper.Get(cellId);
+    for (vtkm::Id index = lower; index < upper; index++)
+    {
+      vtkm::Id pointid = this->pointIds.Get(index);
+      visitor.Visit(pointid, vtkm::MagnitudeSquared(this->coords.Get(pointid) - queryPoint));
+    }
+  }
+};
 }
 }
 
@@ -0,0 +1,259 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_exec_internal_NeighborSearch_h
+#define vtk_m_exec_internal_NeighborSearch_h
+
+#include <vtkm/Math.h>
+#include <vtkm/Types.h>
+
+namespace vtkm
+{
+namespace exec
+{
+namespace internal
+{
+
+/// \brief Bounded max-heap of the nearest points found so far for one query.
+///
+/// The heap lives in the slice [offset, offset + capacity) of a pair of
+/// output portals, one for point ids and one for squared distances, so a
+/// k-nearest-neighbor worklet needs no scratch memory of its own. While the
+/// heap is not full every point is accepted. Once it is full, a point only
+/// replaces the farthest one if it is strictly closer. \c Finish sorts the
+/// slice by increasing distance and pads unused entries with an id of -1 and
+/// an infinite distance.
+///
+template <typename IdPortalType, typename DistancePortalType>
+class NeighborHeap
+{
+public:
+  using DistanceType = typename DistancePortalType::ValueType;
+
+  VTKM_EXEC
+  NeighborHeap(const IdPortalType& ids,
+               const DistancePortalType& distances2,
+               vtkm::Id offset,
+               vtkm::Id capacity)
+    : Ids(ids)
+    , Distances2(distances2)
+    , Offset(offset)
+    , Capacity(capacity)
+    , Size(0)
+  {
+  }
+
+  VTKM_EXEC
+  vtkm::Id GetNumberOfNeighbors() const { return this->Size; }
+
+  VTKM_EXEC
+  bool IsFull() const { return this->Size >= this->Capacity; }
+
+  /// The squared distance a point has to be closer than to enter the heap.
+  ///
+  VTKM_EXEC
+  DistanceType GetBound() const
+  {
+    if (!this->IsFull())
+    {
+      return vtkm::Infinity<DistanceType>();
+    }
+    if (this->Capacity < 1)
+    {
+      return vtkm::NegativeInfinity<DistanceType>();
+    }
+    return this->Distances2.Get(this->Offset);
+  }
+
+  VTKM_EXEC
+  void Insert(vtkm::Id pointId, DistanceType distance2)
+  {
+    if (!this->IsFull())
+    {
+      this->Set(this->Size, pointId, distance2);
+      this->SiftUp(this->Size);
+      ++this->Size;
+    }
+    else if (distance2 < this->GetBound())
+    {
+      this->Set(0, pointId, distance2);
+      this->SiftDown(0, this->Size);
+    }
+  }
+
+  VTKM_EXEC
+  void Finish()
+  {
+    for (vtkm::Id end = this->Size - 1; end > 0; --end)
+    {
+      this->Swap(0, end);
+      this->SiftDown(0, end);
+    }
+    for (vtkm::Id index = this->Size; index < this->Capacity; ++index)
+    {
+      this->Set(index, -1, vtkm::Infinity<DistanceType>());
+    }
+  }
+
+private:
+  IdPortalType Ids;
+  DistancePortalType Distances2;
+  vtkm::Id Offset;
+  vtkm::Id Capacity;
+  vtkm::Id Size;
+
+  VTKM_EXEC
+  DistanceType GetDistance2(vtkm::Id index) const
+  {
+    return this->Distances2.Get(this->Offset + index);
+  }
+
+  VTKM_EXEC
+  void Set(vtkm::Id index, vtkm::Id pointId, DistanceType distance2) const
+  {
+    this->Ids.Set(this->Offset + index, pointId);
+    this->Distances2.Set(this->Offset + index, distance2);
+  }
+
+  VTKM_EXEC
+  void Swap(vtkm::Id index1, vtkm::Id index2) const
+  {
+    vtkm::Id pointId = this->Ids.Get(this->Offset + index1);
+    DistanceType distance2 = this->GetDistance2(index1);
+    this->Set(index1, this->Ids.Get(this->Offset + index2), this->GetDistance2(index2));
+    this->Set(index2, pointId, distance2);
+  }
+
+  VTKM_EXEC
+  void SiftUp(vtkm::Id index) const
+  {
+    while (index > 0)
+    {
+      vtkm::Id parent = (index - 1) / 2;
+      if (!(this->GetDistance2(parent) < this->GetDistance2(index)))
+      {
+        break;
+      }
+      this->Swap(parent, index);
+      index = parent;
+    }
+  }
+
+  VTKM_EXEC
+  void SiftDown(vtkm::Id index, vtkm::Id size) const
+  {
+    for (;;)
+    {
+      vtkm::Id largest = index;
+      vtkm::Id left = 2 * index + 1;
+      vtkm::Id right = left + 1;
+      if (left < size && this->GetDistance2(largest) < this->GetDistance2(left))
+      {
+        largest = left;
+      }
+      if (right < size && this->GetDistance2(largest) < this->GetDistance2(right))
+      {
+        largest = right;
+      }
+      if (largest == index)
+      {
+        break;
+      }
+      this->Swap(index, largest);
+      index = largest;
+    }
+  }
+};
+
+/// The neighbor searches of the point locators walk their structure and hand
+/// every candidate point to a visitor. The visitor gives the squared distance
+/// beyond which nothing can be accepted with \c GetBound(), so that whole
+/// parts of the structure can be skipped, and receives candidates with
+/// \c Visit(pointId, distance2).
+///
+template <typename HeapType>
+struct KNearestVisitor
+{
+  HeapType& Heap;
+
+  VTKM_EXEC
+  typename HeapType::DistanceType GetBound() const { return this->Heap.GetBound(); }
+
+  VTKM_EXEC
+  void Visit(vtkm::Id pointId, typename HeapType::DistanceType distance2)
+  {
+    this->Heap.Insert(pointId, distance2);
+  }
+};
+
+/// Counts the points within a radius. Used by the first pass of a radius
+/// search to size the output.
+///
+template <typename DistanceType>
+struct RadiusCountVisitor
+{
+  DistanceType Radius2;
+  vtkm::IdComponent Count;
+
+  VTKM_EXEC
+  DistanceType GetBound() const { return this->Radius2; }
+
+  VTKM_EXEC
+  void Visit(vtkm::Id, DistanceType distance2)
+  {
+    if (distance2 <= this->Radius2)
+    {
+      ++this->Count;
+    }
+  }
+};
+
+/// Writes the points within a radius, and their squared distances, from
+/// \c Offset on. Used by the second pass of a radius search, which must visit
+/// the same points as the first one.
+///
+template <typename IdPortalType, typename DistancePortalType>
+struct RadiusFillVisitor
+{
+  using DistanceType = typename DistancePortalType::ValueType;
+
+  DistanceType Radius2;
+  vtkm::Id Offset;
+  const IdPortalType& Ids;
+  const DistancePortalType& Distances2;
+
+  VTKM_EXEC
+  DistanceType GetBound() const { return this->Radius2; }
+
+  VTKM_EXEC
+  void Visit(vtkm::Id pointId, DistanceType distance2)
+  {
+    if (distance2 <= this->Radius2)
+    {
+      this->Ids.Set(this->Offset, pointId);
+      this->Distances2.Set(this->Offset, distance2);
+      ++this->Offset;
+    }
+  }
+};
+}
+}
+} // namespace vtkm::exec::internal
+
+#endif //vtk_m_exec_internal_NeighborSearch_h
@@ -22,6 +22,7 @@
 #define vtk_m_filter_ClipWithField_h
 
 #include <vtkm/filter/FilterDataSetWithField.h>
+#include <vtkm/worklet/BrickRangeIndex.h>
 #include <vtkm/worklet/Clip.h>
 
 namespace vtkm
@@ -49,6 +50,16 @@ public:
   VTKM_CONT
   vtkm::Float64 GetClipValue() const { return this->ClipValue; }
 
+  /// Set/Get a brick range index built over the active point field, with its
+  /// name. On structured datasets matching the index, the cells of the bricks
+  /// that are entirely discarded by the clip are skipped. The index is
+  /// ignored for other fields or arrays, and must be rebuilt when the values
+  /// of the field are modified in place.
+  VTKM_CONT
+  void SetBrickRangeIndex(const vtkm::worklet::BrickRangeIndex& index) { this->BrickIndex = index; }
+  VTKM_CONT
+  const vtkm::worklet::BrickRangeIndex& GetBrickRangeIndex() const { return this->BrickIndex; }
+
   template <typename T, typename StorageType, typename DerivedPolicy, typename DeviceAdapter>
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input,
                                           const vtkm::cont::ArrayHandle<T, StorageType>& field,
@@ -69,6 +80,7 @@ private:
   vtkm::Float64 ClipValue;
   vtkm::worklet::Clip Worklet;
   bool Invert;
+  vtkm::worklet::BrickRangeIndex BrickIndex;
 };
 
 template <>
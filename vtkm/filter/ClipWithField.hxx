@@ -18,6 +18,7 @@
 //  this software.
 //============================================================================
 
+#include <vtkm/Math.h>
 #include <vtkm/cont/ArrayHandlePermutation.h>
 #include <vtkm/cont/CellSetPermutation.h>
 #include <vtkm/cont/CoordinateSystem.h>
@@ -86,8 +87,29 @@ inline VTKM_CONT vtkm::cont::DataSet ClipWithField::DoExecute(
   const vtkm::cont::CoordinateSystem& inputCoords =
     input.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex());
 
-  vtkm::cont::CellSetExplicit<> outputCellSet = this->Worklet.Run(
-    vtkm::filter::ApplyPolicy(cells, policy), field, this->ClipValue, this->Invert, device);
+  vtkm::cont::CellSetExplicit<> outputCellSet;
+  if (cells.IsType<vtkm::cont::CellSetStructured<3>>() &&
+      this->BrickIndex.IsValidFor(
+        cells.Cast<vtkm::cont::CellSetStructured<3>>(), fieldMeta.GetName(), field))
+  {
+    // A cell produces output only if one of its points is on the kept side.
+    const vtkm::Range range = this->Invert
+      ? vtkm::Range(vtkm::NegativeInfinity64(), this->ClipValue)
+      : vtkm::Range(this->ClipValue, vtkm::Infinity64());
+    vtkm::cont::ArrayHandle<vtkm::Id> candidates =
+      this->BrickIndex.GetCellsIntersecting(range, device);
+    outputCellSet = this->Worklet.RunOnCandidates(cells.Cast<vtkm::cont::CellSetStructured<3>>(),
+                                                  field,
+                                                  candidates,
+                                                  this->ClipValue,
+                                                  this->Invert,
+                                                  device);
+  }
+  else
+  {
+    outputCellSet = this->Worklet.Run(
+      vtkm::filter::ApplyPolicy(cells, policy), field, this->ClipValue, this->Invert, device);
+  }
 
   //create the output data
   vtkm::cont::DataSet output;
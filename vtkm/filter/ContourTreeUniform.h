@@ -67,7 +67,12 @@
 #ifndef vtk_m_filter_ContourTreeUniform_h
 #define vtk_m_filter_ContourTreeUniform_h
 
+#include <vtkm/Bounds.h>
+#include <vtkm/cont/MultiBlock.h>
 #include <vtkm/filter/FilterField.h>
+#include <vtkm/worklet/contourtree/BoundaryTree.h>
+
+#include <vector>
 
 namespace vtkm
 {
@@ -80,6 +85,14 @@ namespace filter
 /// peak of contour
 /// Based on the algorithm presented in the paper:
 //  “Parallel Peak Pruning for Scalable SMP Contour Tree Computation.”
+///
+/// A MultiBlock of uniform blocks, possibly spread over several ranks, is treated as
+/// one volume decomposed into blocks that share the points on their common edges. The
+/// join and split trees of each block are computed and kept on the critical points and
+/// the shared points, then merged pairwise over DIY into the trees of the whole volume.
+/// The result is a single block with "saddlePeak" as a whole mesh field, holding point
+/// indices into the whole volume.
+///
 class ContourTreeMesh2D : public vtkm::filter::FilterField<ContourTreeMesh2D>
 {
 public:
@@ -93,6 +106,29 @@ public:
                                           const vtkm::filter::FieldMetadata& fieldMeta,
                                           const vtkm::filter::PolicyBase<DerivedPolicy>& policy,
                                           const DeviceAdapter& tag);
+
+  /// When on, the branch decomposition of the contour tree is output as well, in the
+  /// whole mesh fields "branchExtremum", "branchSaddle", "branchPersistence" and
+  /// "branchParent" (see vtkm::worklet::contourtree::BranchDecomposition). Off by default.
+  VTKM_CONT
+  void SetComputeBranchDecomposition(bool value) { this->ComputeBranchDecomposition = value; }
+  VTKM_CONT
+  bool GetComputeBranchDecomposition() const { return this->ComputeBranchDecomposition; }
+
+  template <typename DerivedPolicy>
+  VTKM_CONT void PreExecute(const vtkm::cont::MultiBlock& input,
+                            const vtkm::filter::PolicyBase<DerivedPolicy>& policy);
+
+  template <typename DerivedPolicy>
+  VTKM_CONT void PostExecute(const vtkm::cont::MultiBlock& input,
+                             vtkm::cont::MultiBlock& output,
+                             const vtkm::filter::PolicyBase<DerivedPolicy>& policy);
+
+private:
+  bool ComputeBranchDecomposition;
+  bool Distributed;
+  vtkm::Bounds GlobalBounds;
+  std::vector<vtkm::worklet::contourtree::BoundaryTree> BoundaryTrees;
 };
 
 template <>
@@ -108,6 +144,11 @@ public:
 /// peak of contour
 /// Based on the algorithm presented in the paper:
 //  “Parallel Peak Pruning for Scalable SMP Contour Tree Computation.”
+///
+/// A MultiBlock of uniform blocks, possibly spread over several ranks, is treated as
+/// one volume decomposed into blocks that share the points on their common faces, as
+/// described for ContourTreeMesh2D.
+///
 class ContourTreeMesh3D : public vtkm::filter::FilterField<ContourTreeMesh3D>
 {
 public:
@@ -121,6 +162,29 @@ public:
                                           const vtkm::filter::FieldMetadata& fieldMeta,
                                           const vtkm::filter::PolicyBase<DerivedPolicy>& policy,
                                           const DeviceAdapter& tag);
+
+  /// When on, the branch decomposition of the contour tree is output as well, in the
+  /// whole mesh fields "branchExtremum", "branchSaddle", "branchPersistence" and
+  /// "branchParent" (see vtkm::worklet::contourtree::BranchDecomposition). Off by default.
+  VTKM_CONT
+  void SetComputeBranchDecomposition(bool value) { this->ComputeBranchDecomposition = value; }
+  VTKM_CONT
+  bool GetComputeBranchDecomposition() const { return this->ComputeBranchDecomposition; }
+
+  template <typename DerivedPolicy>
+  VTKM_CONT void PreExecute(const vtkm::cont::MultiBlock& input,
+                            const vtkm::filter::PolicyBase<DerivedPolicy>& policy);
+
+  template <typename DerivedPolicy>
+  VTKM_CONT void PostExecute(const vtkm::cont::MultiBlock& input,
+                             vtkm::cont::MultiBlock& output,
+                             const vtkm::filter::PolicyBase<DerivedPolicy>& policy);
+
+private:
+  bool ComputeBranchDecomposition;
+  bool Distributed;
+  vtkm::Bounds GlobalBounds;
+  std::vector<vtkm::worklet::contourtree::BoundaryTree> BoundaryTrees;
 };
 
 template <>
@@ -129,6 +193,37 @@ class FilterTraits<ContourTreeMesh3D>
 public:
   using InputFieldTypeList = TypeListTagScalarAll;
 };
+
+/// \brief Construct the ContourTree for a point field on an explicit mesh
+///
+/// Output field "saddlePeak" which is pairs of vertex ids indicating saddle and
+/// peak of contour, as for ContourTreeMesh3D. The input must have a
+/// vtkm::cont::CellSetExplicit or vtkm::cont::CellSetSingleType cell set of
+/// tetrahedra or triangles. The neighbourhood of each point is given by the cells
+/// incident to it. The mesh must be connected. Other shapes and meshes that are not
+/// connected throw vtkm::cont::ErrorFilterExecution.
+///
+class ContourTreeMeshExplicit : public vtkm::filter::FilterField<ContourTreeMeshExplicit>
+{
+public:
+  VTKM_CONT
+  ContourTreeMeshExplicit();
+
+  /// Output field "saddlePeak" which is pairs of vertex ids indicating saddle and peak of contour
+  template <typename T, typename StorageType, typename DerivedPolicy, typename DeviceAdapter>
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input,
+                                          const vtkm::cont::ArrayHandle<T, StorageType>& field,
+                                          const vtkm::filter::FieldMetadata& fieldMeta,
+                                          const vtkm::filter::PolicyBase<DerivedPolicy>& policy,
+                                          const DeviceAdapter& tag);
+};
+
+template <>
+class FilterTraits<ContourTreeMeshExplicit>
+{
+public:
+  using InputFieldTypeList = TypeListTagScalarAll;
+};
 }
 } // namespace vtkm::filter
 
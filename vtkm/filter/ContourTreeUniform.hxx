@@ -64,18 +64,386 @@
 //  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
 //  (LDAV), October 2016, Baltimore, Maryland.
 
+#include <vtkm/CellShape.h>
+#include <vtkm/Math.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
+#include <vtkm/cont/AssignerMultiBlock.h>
+#include <vtkm/cont/BoundsGlobalCompute.h>
+#include <vtkm/cont/CellSetExplicit.h>
+#include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/ErrorFilterExecution.h>
 #include <vtkm/filter/internal/CreateResult.h>
 
 #include <vtkm/worklet/ContourTreeUniform.h>
+#include <vtkm/worklet/contourtree/BranchDecomposition.h>
+
+#include <algorithm>
+
+// clang-format off
+VTKM_THIRDPARTY_PRE_INCLUDE
+#include <vtkm/thirdparty/diy/Configure.h>
+#include VTKM_DIY(diy/decomposition.hpp)
+#include VTKM_DIY(diy/master.hpp)
+#include VTKM_DIY(diy/partners/broadcast.hpp)
+#include VTKM_DIY(diy/partners/merge.hpp)
+#include VTKM_DIY(diy/reduce.hpp)
+#include VTKM_DIY(diy/serialization.hpp)
+VTKM_THIRDPARTY_POST_INCLUDE
+// clang-format on
+
+namespace diy
+{
+
+template <>
+struct Serialization<vtkm::worklet::contourtree::BoundaryTree>
+{
+  static void save(BinaryBuffer& bb, const vtkm::worklet::contourtree::BoundaryTree& tree)
+  {
+    diy::save(bb, tree.vertexIds);
+    diy::save(bb, tree.values);
+    diy::save(bb, tree.joinArcs);
+    diy::save(bb, tree.splitArcs);
+    diy::save(bb, tree.nSharing);
+    diy::save(bb, tree.nMerged);
+  }
+
+  static void load(BinaryBuffer& bb, vtkm::worklet::contourtree::BoundaryTree& tree)
+  {
+    diy::load(bb, tree.vertexIds);
+    diy::load(bb, tree.values);
+    diy::load(bb, tree.joinArcs);
+    diy::load(bb, tree.splitArcs);
+    diy::load(bb, tree.nSharing);
+    diy::load(bb, tree.nMerged);
+  }
+};
+
+} // namespace diy
 
 namespace vtkm
 {
 namespace filter
 {
+namespace detail
+{
+class DistributedContourTree
+{
+  using BoundaryTree = vtkm::worklet::contourtree::BoundaryTree;
+
+  class Reducer
+  {
+  public:
+    void operator()(BoundaryTree* tree,
+                    const diy::ReduceProxy& srp,
+                    const diy::RegularMergePartners&) const
+    {
+      const auto selfid = srp.gid();
+      // 1. dequeue and merge.
+      std::vector<int> incoming;
+      srp.incoming(incoming);
+      for (const int gid : incoming)
+      {
+        if (gid != selfid)
+        {
+          BoundaryTree in;
+          srp.dequeue(gid, in);
+          if (tree->GetNumberOfVertices() == 0)
+          {
+            *tree = in;
+          }
+          else
+          {
+            tree->Merge(in);
+            tree->Simplify();
+          }
+        }
+      }
+
+      // 2. enqueue
+      for (int cc = 0; cc < srp.out_link().size(); ++cc)
+      {
+        auto target = srp.out_link().target(cc);
+        if (target.gid != selfid)
+        {
+          srp.enqueue(target, *tree);
+        }
+      }
+    }
+  };
+
+public:
+  // merges the boundary trees of all blocks on all ranks and returns the result on every
+  // rank
+  BoundaryTree ReduceAll(const std::vector<BoundaryTree>& localTrees) const
+  {
+    const vtkm::Id numLocalBlocks = static_cast<vtkm::Id>(localTrees.size());
+    auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+
+    diy::Master master(comm,
+                       /*threads*/ 1,
+                       /*limit*/ -1,
+                       []() -> void* { return new BoundaryTree(); },
+                       [](void* ptr) { delete static_cast<BoundaryTree*>(ptr); });
+
+    vtkm::cont::AssignerMultiBlock assigner(numLocalBlocks);
+    diy::RegularDecomposer<diy::DiscreteBounds> decomposer(
+      /*dims*/ 1, diy::interval(0, assigner.nblocks() - 1), assigner.nblocks());
+    decomposer.decompose(comm.rank(), assigner, master);
+
+    assert(static_cast<vtkm::Id>(master.size()) == numLocalBlocks);
+    for (vtkm::Id cc = 0; cc < numLocalBlocks; ++cc)
+    {
+      *master.block<BoundaryTree>(static_cast<int>(cc)) = localTrees[static_cast<size_t>(cc)];
+    }
+
+    diy::RegularMergePartners partners(decomposer, /*k=*/2);
+    // reduce to block-0.
+    diy::reduce(master, assigner, partners, Reducer());
+
+    BoundaryTree result;
+    if (master.local(0))
+    {
+      result = *master.block<BoundaryTree>(master.lid(0));
+    }
+
+    this->Broadcast(result);
+    return result;
+  }
+
+private:
+  void Broadcast(BoundaryTree& tree) const
+  {
+    // broadcast to all ranks (and not blocks).
+    auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+    if (comm.size() > 1)
+    {
+      diy::Master master(comm,
+                         /*threads*/ 1,
+                         /*limit*/ -1,
+                         []() -> void* { return new BoundaryTree(); },
+                         [](void* ptr) { delete static_cast<BoundaryTree*>(ptr); });
+
+      diy::ContiguousAssigner assigner(comm.size(), comm.size());
+      diy::RegularDecomposer<diy::DiscreteBounds> decomposer(
+        1, diy::interval(0, comm.size() - 1), comm.size());
+      decomposer.decompose(comm.rank(), assigner, master);
+      assert(master.size() == 1); // number of local blocks should be 1 per rank.
+      *master.block<BoundaryTree>(0) = tree;
+      diy::RegularBroadcastPartners partners(decomposer, /*k=*/2);
+      diy::reduce(master, assigner, partners, Reducer());
+      tree = *master.block<BoundaryTree>(0);
+    }
+  }
+};
+
+// Locates a block in the volume from its uniform point coordinates and the bounds of all
+// blocks.
+inline void ComputeBlockExtent(const vtkm::cont::DataSet& input,
+                               const vtkm::Bounds& globalBounds,
+                               const vtkm::Id3& blockDims,
+                               vtkm::Id3& blockOrigin,
+                               vtkm::Id3& globalDims)
+{
+  auto coords = input.GetCoordinateSystem().GetData();
+  if (!coords.IsType<vtkm::cont::ArrayHandleUniformPointCoordinates>())
+  {
+    throw vtkm::cont::ErrorFilterExecution(
+      "Blocks of a distributed contour tree need uniform point coordinates.");
+  }
+  auto portal =
+    coords.Cast<vtkm::cont::ArrayHandleUniformPointCoordinates>().GetPortalConstControl();
+  const auto origin = portal.GetOrigin();
+  const auto spacing = portal.GetSpacing();
+  const vtkm::Range ranges[3] = { globalBounds.X, globalBounds.Y, globalBounds.Z };
+  for (vtkm::IdComponent dim = 0; dim < 3; ++dim)
+  {
+    if (blockDims[dim] > 1 && spacing[dim] > 0)
+    {
+      blockOrigin[dim] = static_cast<vtkm::Id>(
+        vtkm::Round((static_cast<vtkm::Float64>(origin[dim]) - ranges[dim].Min) / spacing[dim]));
+      globalDims[dim] =
+        static_cast<vtkm::Id>(vtkm::Round(ranges[dim].Length() / spacing[dim])) + 1;
+    }
+    else
+    {
+      blockOrigin[dim] = 0;
+      globalDims[dim] = blockDims[dim];
+    }
+  }
+}
+
+inline vtkm::Id3 BlockPointDimensions(const vtkm::cont::CellSetStructured<2>& cellSet)
+{
+  vtkm::Id2 pointDimensions = cellSet.GetPointDimensions();
+  return vtkm::Id3(pointDimensions[0], pointDimensions[1], 1);
+}
+
+inline vtkm::Id3 BlockPointDimensions(const vtkm::cont::CellSetStructured<3>& cellSet)
+{
+  return cellSet.GetPointDimensions();
+}
+
+// The shared vertex counts assume that the blocks tile the volume as a regular lattice,
+// neighbouring blocks sharing exactly the points on their common faces, so that a point
+// is shared by 2, 4 or 8 blocks. Any other layout would splice out vertices before all
+// the blocks sharing them were merged, so the extents of the blocks of all ranks are
+// gathered and checked here.
+template <typename CellSetType>
+inline void ValidateBlockLattice(const vtkm::cont::MultiBlock& input,
+                                 const vtkm::Bounds& globalBounds)
+{
+  // first point, last point and volume dimensions of every block
+  std::vector<vtkm::Id> localExtents;
+  for (const vtkm::cont::DataSet& block : input)
+  {
+    CellSetType cellSet;
+    block.GetCellSet(0).CopyTo(cellSet);
+    vtkm::Id3 blockDims = BlockPointDimensions(cellSet);
+    vtkm::Id3 blockOrigin, globalDims;
+    ComputeBlockExtent(block, globalBounds, blockDims, blockOrigin, globalDims);
+    for (vtkm::IdComponent dim = 0; dim < 3; ++dim)
+    {
+      localExtents.push_back(blockOrigin[dim]);
+      localExtents.push_back(blockOrigin[dim] + blockDims[dim] - 1);
+      localExtents.push_back(globalDims[dim]);
+    }
+  }
+
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  std::vector<std::vector<vtkm::Id>> gatheredExtents;
+  diy::mpi::all_gather(comm, localExtents, gatheredExtents);
+  std::vector<vtkm::Id> extents;
+  for (const auto& rankExtents : gatheredExtents)
+  {
+    extents.insert(extents.end(), rankExtents.begin(), rankExtents.end());
+  }
+  const std::size_t nBlocks = extents.size() / 9;
+  if (nBlocks == 0)
+  {
+    return;
+  }
+
+  // along every axis the blocks start at a sorted set of cuts, and each block has to end
+  // on the cut after its own start, or on the last point of the volume
+  std::vector<vtkm::Id> cuts[3];
+  bool valid = true;
+  for (std::size_t dim = 0; dim < 3; ++dim)
+  {
+    const vtkm::Id globalDim = extents[3 * dim + 2];
+    for (std::size_t block = 0; block < nBlocks; ++block)
+    {
+      valid = valid && extents[9 * block + 3 * dim + 2] == globalDim;
+      cuts[dim].push_back(extents[9 * block + 3 * dim]);
+    }
+    std::sort(cuts[dim].begin(), cuts[dim].end());
+    cuts[dim].erase(std::unique(cuts[dim].begin(), cuts[dim].end()), cuts[dim].end());
+    valid = valid && cuts[dim].front() == 0;
+    cuts[dim].push_back(globalDim > 1 ? globalDim - 1 : 0);
+  }
+
+  // every cell of the lattice is covered by exactly one block
+  const std::size_t nCells = (cuts[0].size() - 1) * (cuts[1].size() - 1) * (cuts[2].size() - 1);
+  std::vector<bool> covered(nCells, false);
+  for (std::size_t block = 0; valid && block < nBlocks; ++block)
+  {
+    std::size_t cell = 0;
+    for (std::size_t dim = 3; valid && dim-- > 0;)
+    {
+      const vtkm::Id first = extents[9 * block + 3 * dim];
+      const vtkm::Id last = extents[9 * block + 3 * dim + 1];
+      const std::size_t slot = static_cast<std::size_t>(
+        std::lower_bound(cuts[dim].begin(), cuts[dim].end(), first) - cuts[dim].begin());
+      valid = slot + 1 < cuts[dim].size() && last == cuts[dim][slot + 1];
+      cell = cell * (cuts[dim].size() - 1) + slot;
+    }
+    valid = valid && !covered[cell];
+    if (valid)
+    {
+      covered[cell] = true;
+    }
+  }
+
+  if (!valid || nBlocks != nCells)
+  {
+    throw vtkm::cont::ErrorFilterExecution(
+      "Blocks of a distributed contour tree must tile the volume as a regular lattice, "
+      "neighbouring blocks sharing the points on their common faces.");
+  }
+}
+
+template <typename T>
+inline void AddWholeMeshField(vtkm::cont::DataSet& output,
+                              const std::string& name,
+                              const std::vector<T>& values)
+{
+  vtkm::cont::ArrayHandle<T> array;
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(values), array);
+  output.AddField(vtkm::cont::Field(name, vtkm::cont::Field::Association::WHOLE_MESH, array));
+}
+
+inline void AddBranchDecomposition(vtkm::cont::DataSet& output,
+                                   const vtkm::worklet::contourtree::BoundaryTree& tree)
+{
+  vtkm::worklet::contourtree::BranchDecomposition branches;
+  branches.Compute(tree);
+  AddWholeMeshField(output, "branchExtremum", branches.extrema);
+  AddWholeMeshField(output, "branchSaddle", branches.saddles);
+  AddWholeMeshField(output, "branchPersistence", branches.persistence);
+  AddWholeMeshField(output, "branchParent", branches.parents);
+}
+
+inline vtkm::cont::ArrayHandle<vtkm::Pair<vtkm::Id, vtkm::Id>> CollectSaddlePeak(
+  const vtkm::worklet::contourtree::BoundaryTree& tree)
+{
+  std::vector<vtkm::Pair<vtkm::Id, vtkm::Id>> superarcs;
+  tree.CollectSaddlePeak(superarcs);
+  vtkm::cont::ArrayHandle<vtkm::Pair<vtkm::Id, vtkm::Id>> saddlePeak;
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(superarcs), saddlePeak);
+  return saddlePeak;
+}
+
+inline vtkm::cont::MultiBlock MergeBoundaryTrees(
+  const std::vector<vtkm::worklet::contourtree::BoundaryTree>& boundaryTrees,
+  const std::string& outputFieldName,
+  bool computeBranchDecomposition)
+{
+  auto tree = DistributedContourTree().ReduceAll(boundaryTrees);
+
+  vtkm::cont::DataSet output;
+  output.AddField(vtkm::cont::Field(
+    outputFieldName, vtkm::cont::Field::Association::WHOLE_MESH, CollectSaddlePeak(tree)));
+  if (computeBranchDecomposition)
+  {
+    AddBranchDecomposition(output, tree);
+  }
+  return vtkm::cont::MultiBlock(output);
+}
+
+// The link of a vertex is only read off its incident cells when they are simplices
+template <typename CellSetType>
+inline void CheckSimplices(const CellSetType& cellSet)
+{
+  auto shapes =
+    cellSet.GetShapesArray(vtkm::TopologyElementTagPoint(), vtkm::TopologyElementTagCell())
+      .GetPortalConstControl();
+  for (vtkm::Id cell = 0; cell < shapes.GetNumberOfValues(); cell++)
+  {
+    if (shapes.Get(cell) != vtkm::CELL_SHAPE_TRIANGLE && shapes.Get(cell) != vtkm::CELL_SHAPE_TETRA)
+    {
+      throw vtkm::cont::ErrorFilterExecution("Only triangles and tetrahedra are supported.");
+    }
+  }
+}
+
+} // namespace detail
 
 //-----------------------------------------------------------------------------
-ContourTreeMesh2D::ContourTreeMesh2D()
+inline ContourTreeMesh2D::ContourTreeMesh2D()
+  : ComputeBranchDecomposition(false)
+  , Distributed(false)
 {
   this->SetOutputFieldName("saddlePeak");
 }
@@ -101,23 +469,81 @@ vtkm::cont::DataSet ContourTreeMesh2D::DoExecute(
   // How should policy be used?
   vtkm::filter::ApplyPolicy(cellSet, policy);
 
+  // The mesh is stored as rows of columns, with x running along the rows
   vtkm::Id2 pointDimensions = cellSet.GetPointDimensions();
-  vtkm::Id nRows = pointDimensions[0];
-  vtkm::Id nCols = pointDimensions[1];
+  vtkm::Id nRows = pointDimensions[1];
+  vtkm::Id nCols = pointDimensions[0];
+  vtkm::Id3 blockDims(pointDimensions[0], pointDimensions[1], 1);
+
+  vtkm::worklet::ContourTreeMesh2D worklet;
+  if (this->Distributed)
+  {
+    // The trees are merged and output once all blocks are done, in PostExecute
+    vtkm::Id3 blockOrigin, globalDims;
+    detail::ComputeBlockExtent(input, this->GlobalBounds, blockDims, blockOrigin, globalDims);
+    this->BoundaryTrees.emplace_back();
+    worklet.RunBoundaryTree(
+      field, blockDims, blockOrigin, globalDims, this->BoundaryTrees.back(), device);
+    return vtkm::cont::DataSet();
+  }
 
   vtkm::cont::ArrayHandle<vtkm::Pair<vtkm::Id, vtkm::Id>> saddlePeak;
+  vtkm::worklet::contourtree::BoundaryTree tree;
+  if (this->ComputeBranchDecomposition)
+  {
+    worklet.RunBoundaryTree(field, blockDims, vtkm::Id3(0), blockDims, tree, device);
+    saddlePeak = detail::CollectSaddlePeak(tree);
+  }
+  else
+  {
+    worklet.Run(field, nRows, nCols, saddlePeak, device);
+  }
 
-  vtkm::worklet::ContourTreeMesh2D worklet;
-  worklet.Run(field, nRows, nCols, saddlePeak, device);
+  vtkm::cont::DataSet result = internal::CreateResult(input,
+                                                      saddlePeak,
+                                                      this->GetOutputFieldName(),
+                                                      fieldMeta.GetAssociation(),
+                                                      fieldMeta.GetCellSetName());
+  if (this->ComputeBranchDecomposition)
+  {
+    detail::AddBranchDecomposition(result, tree);
+  }
+  return result;
+}
 
-  return internal::CreateResult(input,
-                                saddlePeak,
-                                this->GetOutputFieldName(),
-                                fieldMeta.GetAssociation(),
-                                fieldMeta.GetCellSetName());
+//-----------------------------------------------------------------------------
+template <typename DerivedPolicy>
+inline VTKM_CONT void ContourTreeMesh2D::PreExecute(const vtkm::cont::MultiBlock& input,
+                                                    const vtkm::filter::PolicyBase<DerivedPolicy>&)
+{
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  this->Distributed = comm.size() > 1 || input.GetNumberOfBlocks() > 1;
+  this->BoundaryTrees.clear();
+  if (this->Distributed)
+  {
+    this->GlobalBounds = vtkm::cont::BoundsGlobalCompute(input);
+    detail::ValidateBlockLattice<vtkm::cont::CellSetStructured<2>>(input, this->GlobalBounds);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <typename DerivedPolicy>
+inline VTKM_CONT void ContourTreeMesh2D::PostExecute(const vtkm::cont::MultiBlock&,
+                                                     vtkm::cont::MultiBlock& result,
+                                                     const vtkm::filter::PolicyBase<DerivedPolicy>&)
+{
+  if (this->Distributed)
+  {
+    result = detail::MergeBoundaryTrees(
+      this->BoundaryTrees, this->GetOutputFieldName(), this->ComputeBranchDecomposition);
+    this->BoundaryTrees.clear();
+  }
 }
+
 //-----------------------------------------------------------------------------
-ContourTreeMesh3D::ContourTreeMesh3D()
+inline ContourTreeMesh3D::ContourTreeMesh3D()
+  : ComputeBranchDecomposition(false)
+  , Distributed(false)
 {
   this->SetOutputFieldName("saddlePeak");
 }
@@ -143,15 +569,124 @@ vtkm::cont::DataSet ContourTreeMesh3D::DoExecute(
   // How should policy be used?
   vtkm::filter::ApplyPolicy(cellSet, policy);
 
+  // The mesh is stored as slices of rows of columns, with x running along the rows
   vtkm::Id3 pointDimensions = cellSet.GetPointDimensions();
-  vtkm::Id nRows = pointDimensions[0];
-  vtkm::Id nCols = pointDimensions[1];
+  vtkm::Id nRows = pointDimensions[1];
+  vtkm::Id nCols = pointDimensions[0];
   vtkm::Id nSlices = pointDimensions[2];
 
+  vtkm::worklet::ContourTreeMesh3D worklet;
+  if (this->Distributed)
+  {
+    // The trees are merged and output once all blocks are done, in PostExecute
+    vtkm::Id3 blockOrigin, globalDims;
+    detail::ComputeBlockExtent(
+      input, this->GlobalBounds, pointDimensions, blockOrigin, globalDims);
+    this->BoundaryTrees.emplace_back();
+    worklet.RunBoundaryTree(
+      field, pointDimensions, blockOrigin, globalDims, this->BoundaryTrees.back(), device);
+    return vtkm::cont::DataSet();
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Pair<vtkm::Id, vtkm::Id>> saddlePeak;
+  vtkm::worklet::contourtree::BoundaryTree tree;
+  if (this->ComputeBranchDecomposition)
+  {
+    worklet.RunBoundaryTree(field, pointDimensions, vtkm::Id3(0), pointDimensions, tree, device);
+    saddlePeak = detail::CollectSaddlePeak(tree);
+  }
+  else
+  {
+    worklet.Run(field, nRows, nCols, nSlices, saddlePeak, device);
+  }
+
+  vtkm::cont::DataSet result = internal::CreateResult(input,
+                                                      saddlePeak,
+                                                      this->GetOutputFieldName(),
+                                                      fieldMeta.GetAssociation(),
+                                                      fieldMeta.GetCellSetName());
+  if (this->ComputeBranchDecomposition)
+  {
+    detail::AddBranchDecomposition(result, tree);
+  }
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+template <typename DerivedPolicy>
+inline VTKM_CONT void ContourTreeMesh3D::PreExecute(const vtkm::cont::MultiBlock& input,
+                                                    const vtkm::filter::PolicyBase<DerivedPolicy>&)
+{
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  this->Distributed = comm.size() > 1 || input.GetNumberOfBlocks() > 1;
+  this->BoundaryTrees.clear();
+  if (this->Distributed)
+  {
+    this->GlobalBounds = vtkm::cont::BoundsGlobalCompute(input);
+    detail::ValidateBlockLattice<vtkm::cont::CellSetStructured<3>>(input, this->GlobalBounds);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <typename DerivedPolicy>
+inline VTKM_CONT void ContourTreeMesh3D::PostExecute(const vtkm::cont::MultiBlock&,
+                                                     vtkm::cont::MultiBlock& result,
+                                                     const vtkm::filter::PolicyBase<DerivedPolicy>&)
+{
+  if (this->Distributed)
+  {
+    result = detail::MergeBoundaryTrees(
+      this->BoundaryTrees, this->GetOutputFieldName(), this->ComputeBranchDecomposition);
+    this->BoundaryTrees.clear();
+  }
+}
+
+//-----------------------------------------------------------------------------
+inline ContourTreeMeshExplicit::ContourTreeMeshExplicit()
+{
+  this->SetOutputFieldName("saddlePeak");
+}
+
+//-----------------------------------------------------------------------------
+template <typename T, typename StorageType, typename DerivedPolicy, typename DeviceAdapter>
+vtkm::cont::DataSet ContourTreeMeshExplicit::DoExecute(
+  const vtkm::cont::DataSet& input,
+  const vtkm::cont::ArrayHandle<T, StorageType>& field,
+  const vtkm::filter::FieldMetadata& fieldMeta,
+  const vtkm::filter::PolicyBase<DerivedPolicy>&,
+  const DeviceAdapter& device)
+{
+  if (fieldMeta.IsPointField() == false)
+  {
+    throw vtkm::cont::ErrorFilterExecution("Point field expected.");
+  }
+
   vtkm::cont::ArrayHandle<vtkm::Pair<vtkm::Id, vtkm::Id>> saddlePeak;
+  vtkm::worklet::ContourTreeMeshExplicit worklet;
 
-  vtkm::worklet::ContourTreeMesh3D worklet;
-  worklet.Run(field, nRows, nCols, nSlices, saddlePeak, device);
+  const vtkm::cont::DynamicCellSet& cells = input.GetCellSet(0);
+  try
+  {
+    if (cells.IsType<vtkm::cont::CellSetSingleType<>>())
+    {
+      detail::CheckSimplices(cells.Cast<vtkm::cont::CellSetSingleType<>>());
+      worklet.Run(field, cells.Cast<vtkm::cont::CellSetSingleType<>>(), saddlePeak, device);
+    }
+    else if (cells.IsType<vtkm::cont::CellSetExplicit<>>())
+    {
+      detail::CheckSimplices(cells.Cast<vtkm::cont::CellSetExplicit<>>());
+      worklet.Run(field, cells.Cast<vtkm::cont::CellSetExplicit<>>(), saddlePeak, device);
+    }
+    else
+    {
+      throw vtkm::cont::ErrorFilterExecution("Explicit cell set expected.");
+    }
+  }
+  catch (const vtkm::cont::ErrorBadValue& error)
+  {
+    // a mesh that is not connected, which would otherwise be retried on other devices
+    throw vtkm::cont::ErrorFilterExecution(error.GetMessage());
+  }
 
   return internal::CreateResult(input,
                                 saddlePeak,
@@ -71,6 +71,7 @@ namespace filter
 //-----------------------------------------------------------------------------
 Gradient::Gradient()
   : ComputePointGradient(false)
+  , ComputeDivergence(false)
   , ComputeVorticity(false)
   , ComputeQCriterion(false)
   , StoreGradient(true)
@@ -69,6 +69,18 @@ public:
   VTKM_CONT
   bool GetMergeDuplicatePoints() const { return this->Worklet.GetMergeDuplicatePoints(); }
 
+  /// Set/Get a brick range index built over the active field, with its name.
+  /// On structured datasets matching the index, only the cells of the bricks
+  /// that contain an isovalue are visited. The index is ignored for other
+  /// fields or arrays, and must be rebuilt when the values of the field are
+  /// modified in place.
+  ///
+  VTKM_CONT
+  void SetBrickRangeIndex(const vtkm::worklet::BrickRangeIndex& index) { this->BrickIndex = index; }
+
+  VTKM_CONT
+  const vtkm::worklet::BrickRangeIndex& GetBrickRangeIndex() const { return this->BrickIndex; }
+
   /// Set/Get whether normals should be generated. Off by default. If enabled,
   /// the default behaviour is to generate high quality normals for structured
   /// datasets, using gradients, and generate fast normals for unstructured
@@ -127,6 +139,7 @@ private:
   bool ComputeFastNormalsForStructured;
   bool ComputeFastNormalsForUnstructured;
   std::string NormalArrayName;
+  vtkm::worklet::BrickRangeIndex BrickIndex;
   vtkm::worklet::MarchingCubes Worklet;
 };
 
@@ -158,6 +158,11 @@ inline VTKM_CONT vtkm::cont::DataSet MarchingCubes::DoExecute(
   //But I think we should get this to compile before we tinker with
   //a more efficient api
 
+  // The worklet checks that the index matches the cells and the array.
+  this->Worklet.SetBrickRangeIndex(this->BrickIndex.GetFieldName() == fieldMeta.GetName()
+                                     ? this->BrickIndex
+                                     : vtkm::worklet::BrickRangeIndex());
+
   bool generateHighQualityNormals = IsCellSetStructured(cells)
     ? !this->ComputeFastNormalsForStructured
     : !this->ComputeFastNormalsForUnstructured;
@@ -0,0 +1,151 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2017 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2017 UT-Battelle, LLC.
+//  Copyright 2017 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#ifndef vtk_m_filter_ParticleAdvection_h
+#define vtk_m_filter_ParticleAdvection_h
+
+#include <vtkm/cont/MultiBlock.h>
+#include <vtkm/filter/FilterDataSetWithField.h>
+#include <vtkm/worklet/ParticleAdvection.h>
+
+#include <vector>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace detail
+{
+/// State of a single particle as it travels between the blocks of a
+/// `MultiBlock`. This is what gets serialized when a particle is handed
+/// over to the block (possibly on another rank) it has moved into.
+struct AdvectedParticle
+{
+  vtkm::Vec<vtkm::FloatDefault, 3> Position;
+  vtkm::Id SeedId;
+  vtkm::Id NumberOfSteps;
+  vtkm::Id Status;
+  vtkm::FloatDefault Time;
+};
+} // namespace detail
+
+/// \brief Advect particles through a vector field distributed over many blocks.
+///
+/// Takes as input a vector field and seed locations and advects every seed
+/// for a fixed number of steps. Unlike `Streamline`, the input may be a
+/// `MultiBlock` distributed over several MPI ranks. Each seed starts in the
+/// block that contains it. Whenever a particle exits its current block, it
+/// is sent to the block (local or remote) that contains its new position
+/// and advection continues there, until it either takes the requested
+/// number of steps or leaves the global domain. A particle that cannot move
+/// in the block it was sent to terminates there.
+///
+/// Blocks may be uniform or rectilinear structured grids, or explicit cell
+/// sets, and the types may differ between blocks.
+///
+/// The seeds must be the same on all ranks. The output has one block per
+/// local input block, holding the final positions of the particles that
+/// terminated in that block along with the point fields "seed_ids",
+/// "steps_taken", "status" and "time".
+///
+/// Blocks exchange particles in bulk-synchronous rounds. Every round advects
+/// all particles held by the local blocks, then routes the ones that left
+/// their block with one collective exchange.
+class ParticleAdvection : public vtkm::filter::FilterDataSetWithField<ParticleAdvection>
+{
+public:
+  VTKM_CONT
+  ParticleAdvection();
+
+  VTKM_CONT
+  void SetStepSize(vtkm::Float64 s) { this->StepSize = s; }
+
+  VTKM_CONT
+  void SetNumberOfSteps(vtkm::Id n) { this->NumberOfSteps = n; }
+
+  VTKM_CONT
+  void SetSeeds(const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>>& seeds);
+
+  /// Number of communication rounds the last execution needed before all
+  /// particles terminated.
+  VTKM_CONT
+  vtkm::Id GetNumberOfRounds() const { return this->NumberOfRounds; }
+
+  template <typename DerivedPolicy>
+  VTKM_CONT vtkm::cont::MultiBlock PrepareForExecution(
+    const vtkm::cont::MultiBlock& input,
+    const vtkm::filter::PolicyBase<DerivedPolicy>& policy);
+
+  template <typename T, typename StorageType, typename DerivedPolicy, typename DeviceAdapter>
+  VTKM_CONT vtkm::cont::DataSet DoExecute(
+    const vtkm::cont::DataSet& input,
+    const vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>, StorageType>& field,
+    const vtkm::filter::FieldMetadata& fieldMeta,
+    const vtkm::filter::PolicyBase<DerivedPolicy>& policy,
+    const DeviceAdapter& tag);
+
+  template <typename T, typename StorageType, typename DerivedPolicy, typename DeviceAdapter>
+  VTKM_CONT bool DoMapField(vtkm::cont::DataSet& result,
+                            const vtkm::cont::ArrayHandle<T, StorageType>& input,
+                            const vtkm::filter::FieldMetadata& fieldMeta,
+                            const vtkm::filter::PolicyBase<DerivedPolicy>& policy,
+                            const DeviceAdapter& tag);
+
+private:
+  // Advects `Particles` with an evaluator for the explicit cells of a block.
+  template <typename CellSetType, typename T, typename StorageType, typename DeviceAdapter>
+  VTKM_CONT vtkm::cont::DataSet AdvectUnstructured(
+    const vtkm::cont::DynamicCellSet& cells,
+    const vtkm::cont::CoordinateSystem& coords,
+    const vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>, StorageType>& field,
+    const DeviceAdapter& tag);
+
+  // Advects `Particles` with the given integrator and returns them as a data
+  // set of vertices.
+  template <typename T, typename IntegratorType, typename DeviceAdapter>
+  VTKM_CONT vtkm::cont::DataSet Advect(const IntegratorType& integrator, const DeviceAdapter& tag);
+
+  vtkm::worklet::ParticleAdvection Worklet;
+  vtkm::Float64 StepSize;
+  vtkm::Id NumberOfSteps;
+  vtkm::Id NumberOfRounds;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>> Seeds;
+
+  // Particles to advect through the block passed to DoExecute, which returns
+  // them advected as a data set of vertices.
+  std::vector<detail::AdvectedParticle> Particles;
+};
+
+template <>
+class FilterTraits<ParticleAdvection>
+{
+public:
+  struct TypeListTagParticleAdvection
+    : vtkm::ListTagBase<vtkm::Vec<vtkm::Float32, 3>, vtkm::Vec<vtkm::Float64, 3>>
+  {
+  };
+  using InputFieldTypeList = TypeListTagParticleAdvection;
+};
+}
+} // namespace vtkm::filter
+
+#include <vtkm/filter/ParticleAdvection.hxx>
+
+#endif // vtk_m_filter_ParticleAdvection_h
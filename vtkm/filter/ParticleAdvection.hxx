@@ -0,0 +1,483 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2017 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2017 UT-Battelle, LLC.
+//  Copyright 2017 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleCartesianProduct.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
+#include <vtkm/cont/AssignerMultiBlock.h>
+#include <vtkm/cont/BoundingIntervalHierarchy.hxx>
+#include <vtkm/cont/CellSetExplicit.h>
+#include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/ErrorFilterExecution.h>
+#include <vtkm/worklet/particleadvection/GridEvaluators.h>
+#include <vtkm/worklet/particleadvection/Integrators.h>
+#include <vtkm/worklet/particleadvection/Particles.h>
+
+// clang-format off
+VTKM_THIRDPARTY_PRE_INCLUDE
+#include <vtkm/thirdparty/diy/Configure.h>
+#include VTKM_DIY(diy/master.hpp)
+#include VTKM_DIY(diy/mpi.hpp)
+VTKM_THIRDPARTY_POST_INCLUDE
+// clang-format on
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace detail
+{
+/// The particles owned by one block of the input. `Active` particles are
+/// waiting to be advected through the block, `Terminated` ones are done and
+/// will be reported in the output block.
+struct ParticleAdvectionBlock
+{
+  std::vector<AdvectedParticle> Active;
+  std::vector<AdvectedParticle> Terminated;
+};
+
+/// Returns the global id of the first block containing `point` or -1 if the
+/// point is outside of all blocks.
+inline int FindParticleBlock(const std::vector<vtkm::Bounds>& blockBounds,
+                             const vtkm::Vec<vtkm::FloatDefault, 3>& point)
+{
+  for (std::size_t gid = 0; gid < blockBounds.size(); ++gid)
+  {
+    if (blockBounds[gid].Contains(point))
+    {
+      return static_cast<int>(gid);
+    }
+  }
+  return -1;
+}
+
+/// Stores particles as a data set with one vertex per particle, at the
+/// particle position, and the point fields "seed_ids", "steps_taken", "status"
+/// and "time".
+inline vtkm::cont::DataSet MakeParticleDataSet(const std::vector<AdvectedParticle>& particles)
+{
+  const vtkm::Id numParticles = static_cast<vtkm::Id>(particles.size());
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>> positions;
+  vtkm::cont::ArrayHandle<vtkm::Id> seedIds;
+  vtkm::cont::ArrayHandle<vtkm::Id> stepsTaken;
+  vtkm::cont::ArrayHandle<vtkm::Id> status;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> times;
+  positions.Allocate(numParticles);
+  seedIds.Allocate(numParticles);
+  stepsTaken.Allocate(numParticles);
+  status.Allocate(numParticles);
+  times.Allocate(numParticles);
+  for (vtkm::Id cc = 0; cc < numParticles; ++cc)
+  {
+    const AdvectedParticle& particle = particles[static_cast<std::size_t>(cc)];
+    positions.GetPortalControl().Set(cc, particle.Position);
+    seedIds.GetPortalControl().Set(cc, particle.SeedId);
+    stepsTaken.GetPortalControl().Set(cc, particle.NumberOfSteps);
+    status.GetPortalControl().Set(cc, particle.Status);
+    times.GetPortalControl().Set(cc, particle.Time);
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(numParticles), connectivity);
+  vtkm::cont::CellSetSingleType<> vertices("vertices");
+  vertices.Fill(numParticles, vtkm::CELL_SHAPE_VERTEX, 1, connectivity);
+
+  vtkm::cont::DataSet dataSet;
+  dataSet.AddCoordinateSystem(vtkm::cont::CoordinateSystem("coordinates", positions));
+  dataSet.AddCellSet(vertices);
+  dataSet.AddField(vtkm::cont::Field("seed_ids", vtkm::cont::Field::Association::POINTS, seedIds));
+  dataSet.AddField(
+    vtkm::cont::Field("steps_taken", vtkm::cont::Field::Association::POINTS, stepsTaken));
+  dataSet.AddField(vtkm::cont::Field("status", vtkm::cont::Field::Association::POINTS, status));
+  dataSet.AddField(vtkm::cont::Field("time", vtkm::cont::Field::Association::POINTS, times));
+  return dataSet;
+}
+
+/// Reads back the particles stored by `MakeParticleDataSet`.
+inline std::vector<AdvectedParticle> GetParticles(const vtkm::cont::DataSet& dataSet)
+{
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>> positions;
+  vtkm::cont::ArrayHandle<vtkm::Id> seedIds;
+  vtkm::cont::ArrayHandle<vtkm::Id> stepsTaken;
+  vtkm::cont::ArrayHandle<vtkm::Id> status;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> times;
+  vtkm::cont::ArrayCopy(dataSet.GetCoordinateSystem().GetData(), positions);
+  dataSet.GetField("seed_ids").GetData().CopyTo(seedIds);
+  dataSet.GetField("steps_taken").GetData().CopyTo(stepsTaken);
+  dataSet.GetField("status").GetData().CopyTo(status);
+  dataSet.GetField("time").GetData().CopyTo(times);
+
+  const vtkm::Id numParticles = positions.GetNumberOfValues();
+  std::vector<AdvectedParticle> particles(static_cast<std::size_t>(numParticles));
+  for (vtkm::Id cc = 0; cc < numParticles; ++cc)
+  {
+    AdvectedParticle& particle = particles[static_cast<std::size_t>(cc)];
+    particle.Position = positions.GetPortalConstControl().Get(cc);
+    particle.SeedId = seedIds.GetPortalConstControl().Get(cc);
+    particle.NumberOfSteps = stepsTaken.GetPortalConstControl().Get(cc);
+    particle.Status = status.GetPortalConstControl().Get(cc);
+    particle.Time = times.GetPortalConstControl().Get(cc);
+  }
+  return particles;
+}
+} // namespace detail
+
+//-----------------------------------------------------------------------------
+inline VTKM_CONT ParticleAdvection::ParticleAdvection()
+  : vtkm::filter::FilterDataSetWithField<ParticleAdvection>()
+  , Worklet()
+  , StepSize(0)
+  , NumberOfSteps(0)
+  , NumberOfRounds(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+inline VTKM_CONT void ParticleAdvection::SetSeeds(
+  const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>>& seeds)
+{
+  this->Seeds = seeds;
+}
+
+//-----------------------------------------------------------------------------
+template <typename DerivedPolicy>
+inline VTKM_CONT vtkm::cont::MultiBlock ParticleAdvection::PrepareForExecution(
+  const vtkm::cont::MultiBlock& input,
+  const vtkm::filter::PolicyBase<DerivedPolicy>& policy)
+{
+  using BlockType = detail::ParticleAdvectionBlock;
+  using ParticleType = detail::AdvectedParticle;
+  using ProxyType = diy::Master::ProxyWithLink;
+
+  if (this->Seeds.GetNumberOfValues() == 0)
+  {
+    throw vtkm::cont::ErrorFilterExecution("No seeds provided.");
+  }
+
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  vtkm::cont::AssignerMultiBlock assigner(input);
+  std::vector<int> gids;
+  assigner.local_gids(comm.rank(), gids);
+
+  // Every rank needs the bounds of all blocks to know where to send the
+  // particles leaving its own blocks. Global ids are assigned contiguously
+  // per rank, so concatenating the gathered bounds orders them by gid.
+  std::vector<vtkm::Float64> localBounds;
+  for (const vtkm::cont::DataSet& block : input)
+  {
+    const vtkm::Bounds bounds =
+      block.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex()).GetBounds();
+    localBounds.insert(localBounds.end(),
+                       { bounds.X.Min, bounds.X.Max, bounds.Y.Min, bounds.Y.Max, bounds.Z.Min,
+                         bounds.Z.Max });
+  }
+  std::vector<std::vector<vtkm::Float64>> gatheredBounds;
+  diy::mpi::all_gather(comm, localBounds, gatheredBounds);
+  std::vector<vtkm::Bounds> blockBounds;
+  for (const auto& rankBounds : gatheredBounds)
+  {
+    for (std::size_t cc = 0; cc + 5 < rankBounds.size(); cc += 6)
+    {
+      blockBounds.emplace_back(rankBounds[cc + 0],
+                               rankBounds[cc + 1],
+                               rankBounds[cc + 2],
+                               rankBounds[cc + 3],
+                               rankBounds[cc + 4],
+                               rankBounds[cc + 5]);
+    }
+  }
+
+  diy::Master master(comm,
+                     /*threads*/ 1,
+                     /*limit*/ -1,
+                     []() -> void* { return new BlockType(); },
+                     [](void* ptr) { delete static_cast<BlockType*>(ptr); });
+  for (const int gid : gids)
+  {
+    master.add(gid, new BlockType(), new diy::Link());
+  }
+
+  // Seeds start in the first block that contains them. Seeds outside of all
+  // blocks are ignored.
+  auto seedPortal = this->Seeds.GetPortalConstControl();
+  for (vtkm::Id cc = 0; cc < seedPortal.GetNumberOfValues(); ++cc)
+  {
+    const vtkm::Vec<vtkm::FloatDefault, 3> seed = seedPortal.Get(cc);
+    const int gid = detail::FindParticleBlock(blockBounds, seed);
+    if (gid >= 0 && master.local(gid))
+    {
+      ParticleType particle;
+      particle.Position = seed;
+      particle.SeedId = cc;
+      particle.NumberOfSteps = 0;
+      particle.Status = vtkm::worklet::particleadvection::STATUS_OK;
+      particle.Time = 0;
+      master.block<BlockType>(master.lid(gid))->Active.push_back(particle);
+    }
+  }
+
+  auto countActive = [&]() -> vtkm::Id {
+    vtkm::Id localActive = 0;
+    for (int lid = 0; lid < static_cast<int>(master.size()); ++lid)
+    {
+      localActive += static_cast<vtkm::Id>(master.block<BlockType>(lid)->Active.size());
+    }
+    vtkm::Id globalActive = 0;
+    diy::mpi::all_reduce(comm, localActive, globalActive, std::plus<vtkm::Id>());
+    return globalActive;
+  };
+
+  // Advect in rounds: every block advects the particles it holds until they
+  // leave it, then the particles that left are routed to the blocks they
+  // entered. The exchange is a remote (non-neighbor) exchange since a
+  // particle may enter any block, and is repeated until no rank has any
+  // active particle left.
+  this->NumberOfRounds = 0;
+  while (countActive() > 0)
+  {
+    master.foreach ([&](BlockType* block, const ProxyType& cp) {
+      if (block->Active.empty())
+      {
+        return;
+      }
+
+      std::vector<ParticleType> received;
+      received.swap(block->Active);
+      this->Particles = received;
+      vtkm::cont::DataSet advected =
+        this->FilterDataSetWithField<ParticleAdvection>::PrepareForExecution(
+          input.GetBlock(master.lid(cp.gid())), policy);
+      this->Particles.clear();
+
+      const std::vector<ParticleType> particles = detail::GetParticles(advected);
+      std::map<int, std::vector<ParticleType>> outgoing;
+      for (std::size_t cc = 0; cc < particles.size(); ++cc)
+      {
+        const ParticleType& particle = particles[cc];
+        // A particle that did not move, e.g. because it is inside the bounds
+        // of the block but not in any of its cells, would be routed back to
+        // the same block in every round, so it terminates here.
+        const bool moved = particle.Position != received[cc].Position;
+        int destination = -1;
+        if (moved && particle.NumberOfSteps < this->NumberOfSteps &&
+            (particle.Status & vtkm::worklet::particleadvection::EXITED_SPATIAL_BOUNDARY) != 0)
+        {
+          destination = detail::FindParticleBlock(blockBounds, particle.Position);
+        }
+
+        if (destination < 0)
+        {
+          block->Terminated.push_back(particle);
+        }
+        else
+        {
+          outgoing[destination].push_back(particle);
+        }
+      }
+
+      for (const auto& message : outgoing)
+      {
+        cp.enqueue(diy::BlockID{ message.first, assigner.rank(message.first) }, message.second);
+      }
+    });
+
+    master.exchange(/*remote*/ true);
+
+    master.foreach ([](BlockType* block, const ProxyType& cp) {
+      std::vector<int> incoming;
+      cp.incoming(incoming);
+      for (const int gid : incoming)
+      {
+        while (cp.incoming(gid))
+        {
+          std::vector<ParticleType> received;
+          cp.dequeue(gid, received);
+          block->Active.insert(block->Active.end(), received.begin(), received.end());
+        }
+      }
+    });
+
+    ++this->NumberOfRounds;
+  }
+
+  vtkm::cont::MultiBlock output;
+  for (int lid = 0; lid < static_cast<int>(master.size()); ++lid)
+  {
+    std::vector<ParticleType>& terminated = master.block<BlockType>(lid)->Terminated;
+    std::sort(terminated.begin(),
+              terminated.end(),
+              [](const ParticleType& a, const ParticleType& b) { return a.SeedId < b.SeedId; });
+
+    output.AddBlock(detail::MakeParticleDataSet(terminated));
+  }
+  return output;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T, typename StorageType, typename DerivedPolicy, typename DeviceAdapter>
+inline VTKM_CONT vtkm::cont::DataSet ParticleAdvection::DoExecute(
+  const vtkm::cont::DataSet& input,
+  const vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>, StorageType>& field,
+  const vtkm::filter::FieldMetadata& fieldMeta,
+  const vtkm::filter::PolicyBase<DerivedPolicy>&,
+  const DeviceAdapter& device)
+{
+  const vtkm::cont::DynamicCellSet& cells = input.GetCellSet(this->GetActiveCellSetIndex());
+  const vtkm::cont::CoordinateSystem& coords =
+    input.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex());
+
+  if (!fieldMeta.IsPointField())
+  {
+    throw vtkm::cont::ErrorFilterExecution("Point field expected.");
+  }
+
+  using FieldHandle = vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>, StorageType>;
+  using FieldPortalConstType =
+    typename FieldHandle::template ExecutionTypes<DeviceAdapter>::PortalConst;
+  const T stepSize = static_cast<T>(this->StepSize);
+
+  // Blocks may be of different types, so the evaluator is picked per block.
+  if (cells.IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    using AxisHandle = vtkm::cont::ArrayHandle<vtkm::FloatDefault>;
+    using RectilinearType =
+      vtkm::cont::ArrayHandleCartesianProduct<AxisHandle, AxisHandle, AxisHandle>;
+    if (coords.GetData().IsType<vtkm::cont::ArrayHandleUniformPointCoordinates>())
+    {
+      using EvalType = vtkm::worklet::particleadvection::
+        UniformGridEvaluate<FieldPortalConstType, T, DeviceAdapter, StorageType>;
+      using RK4Type = vtkm::worklet::particleadvection::RK4Integrator<EvalType, T>;
+      return this->Advect<T>(RK4Type(EvalType(coords, cells, field), stepSize), device);
+    }
+    if (coords.GetData().IsType<RectilinearType>())
+    {
+      using EvalType = vtkm::worklet::particleadvection::
+        RectilinearGridEvaluate<FieldPortalConstType, T, DeviceAdapter, StorageType>;
+      using RK4Type = vtkm::worklet::particleadvection::RK4Integrator<EvalType, T>;
+      return this->Advect<T>(RK4Type(EvalType(coords, cells, field), stepSize), device);
+    }
+    throw vtkm::cont::ErrorFilterExecution("Coordinate type not supported.");
+  }
+  if (cells.IsType<vtkm::cont::CellSetExplicit<>>())
+  {
+    return this->AdvectUnstructured<vtkm::cont::CellSetExplicit<>>(cells, coords, field, device);
+  }
+  if (cells.IsType<vtkm::cont::CellSetSingleType<>>())
+  {
+    return this->AdvectUnstructured<vtkm::cont::CellSetSingleType<>>(
+      cells, coords, field, device);
+  }
+  throw vtkm::cont::ErrorFilterExecution("Cell type not supported.");
+}
+
+//-----------------------------------------------------------------------------
+template <typename CellSetType, typename T, typename StorageType, typename DeviceAdapter>
+inline VTKM_CONT vtkm::cont::DataSet ParticleAdvection::AdvectUnstructured(
+  const vtkm::cont::DynamicCellSet& cells,
+  const vtkm::cont::CoordinateSystem& coords,
+  const vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>, StorageType>& field,
+  const DeviceAdapter& device)
+{
+  // The evaluator reads the points through their concrete array type, so
+  // other coordinate arrays are copied first.
+  using CoordsHandle = vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>>;
+  vtkm::cont::CoordinateSystem points = coords;
+  if (!coords.GetData().IsType<CoordsHandle>())
+  {
+    CoordsHandle pointsCopy;
+    vtkm::cont::ArrayCopy(coords.GetData(), pointsCopy, device);
+    points = vtkm::cont::CoordinateSystem(coords.GetName(), pointsCopy);
+  }
+
+  vtkm::cont::BoundingIntervalHierarchy locator;
+  locator.SetCellSet(cells);
+  locator.SetCoordinates(points);
+
+  using FieldHandle = vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>, StorageType>;
+  using FieldPortalConstType =
+    typename FieldHandle::template ExecutionTypes<DeviceAdapter>::PortalConst;
+  using EvalType = vtkm::worklet::particleadvection::
+    UnstructuredGridEvaluate<FieldPortalConstType, T, DeviceAdapter, StorageType, CellSetType>;
+  using RK4Type = vtkm::worklet::particleadvection::RK4Integrator<EvalType, T>;
+  // The locator has to outlive the advection, which uses its execution object.
+  return this->Advect<T>(
+    RK4Type(EvalType(points, cells, field, locator), static_cast<T>(this->StepSize)), device);
+}
+
+//-----------------------------------------------------------------------------
+template <typename T, typename IntegratorType, typename DeviceAdapter>
+inline VTKM_CONT vtkm::cont::DataSet ParticleAdvection::Advect(const IntegratorType& integrator,
+                                                               const DeviceAdapter& device)
+{
+  // Continue the particles where the previous block left them off.
+  const vtkm::Id numParticles = static_cast<vtkm::Id>(this->Particles.size());
+  vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>> positions;
+  vtkm::cont::ArrayHandle<vtkm::Id> stepsTaken;
+  vtkm::cont::ArrayHandle<T> times;
+  positions.Allocate(numParticles);
+  stepsTaken.Allocate(numParticles);
+  times.Allocate(numParticles);
+  for (vtkm::Id cc = 0; cc < numParticles; ++cc)
+  {
+    const detail::AdvectedParticle& particle = this->Particles[static_cast<std::size_t>(cc)];
+    positions.GetPortalControl().Set(cc, vtkm::Vec<T, 3>(particle.Position));
+    stepsTaken.GetPortalControl().Set(cc, particle.NumberOfSteps);
+    times.GetPortalControl().Set(cc, static_cast<T>(particle.Time));
+  }
+
+  vtkm::worklet::ParticleAdvectionResult<T> res =
+    this->Worklet.Run(integrator, positions, stepsTaken, times, this->NumberOfSteps, device);
+
+  auto positionPortal = res.positions.GetPortalConstControl();
+  auto statusPortal = res.status.GetPortalConstControl();
+  auto stepsPortal = res.stepsTaken.GetPortalConstControl();
+  auto timePortal = res.times.GetPortalConstControl();
+  std::vector<detail::AdvectedParticle> advected(this->Particles);
+  for (vtkm::Id cc = 0; cc < numParticles; ++cc)
+  {
+    detail::AdvectedParticle& particle = advected[static_cast<std::size_t>(cc)];
+    particle.Position = vtkm::Vec<vtkm::FloatDefault, 3>(positionPortal.Get(cc));
+    particle.Status = statusPortal.Get(cc);
+    particle.NumberOfSteps = stepsPortal.Get(cc);
+    particle.Time = static_cast<vtkm::FloatDefault>(timePortal.Get(cc));
+  }
+
+  return detail::MakeParticleDataSet(advected);
+}
+
+//-----------------------------------------------------------------------------
+template <typename T, typename StorageType, typename DerivedPolicy, typename DeviceAdapter>
+inline VTKM_CONT bool ParticleAdvection::DoMapField(vtkm::cont::DataSet&,
+                                                    const vtkm::cont::ArrayHandle<T, StorageType>&,
+                                                    const vtkm::filter::FieldMetadata&,
+                                                    const vtkm::filter::PolicyBase<DerivedPolicy>&,
+                                                    const DeviceAdapter&)
+{
+  return false;
+}
+}
+} // namespace vtkm::filter
@@ -22,6 +22,7 @@
 #define vtk_m_filter_Threshold_h
 
 #include <vtkm/filter/FilterDataSetWithField.h>
+#include <vtkm/worklet/BrickRangeIndex.h>
 #include <vtkm/worklet/Threshold.h>
 
 namespace vtkm
@@ -35,7 +36,10 @@ namespace filter
 /// satisfy a threshold criterion. A cell satisfies the criterion if the
 /// scalar value of every point or cell satisfies the criterion. The
 /// criterion takes the form of between two values. The output of this
-/// filter is an permutation of the input dataset.
+/// filter is an permutation of the input dataset. The thresholds are
+/// converted to the type of the field: integer fields keep the integers
+/// within the thresholds, and floating point thresholds are rounded to the
+/// nearest value of the field type.
 ///
 /// You can threshold either on point or cell fields
 class Threshold : public vtkm::filter::FilterDataSetWithField<Threshold>
@@ -54,6 +58,16 @@ public:
   VTKM_CONT
   vtkm::Float64 GetUpperThreshold() const { return this->UpperValue; }
 
+  /// Set/Get a brick range index built over the active point field, with its
+  /// name. On structured datasets matching the index, only the cells of the
+  /// bricks with values in the threshold range are tested. The index is
+  /// ignored for other fields or arrays, and must be rebuilt when the values
+  /// of the field are modified in place.
+  VTKM_CONT
+  void SetBrickRangeIndex(const vtkm::worklet::BrickRangeIndex& index) { this->BrickIndex = index; }
+  VTKM_CONT
+  const vtkm::worklet::BrickRangeIndex& GetBrickRangeIndex() const { return this->BrickIndex; }
+
   template <typename T, typename StorageType, typename DerivedPolicy, typename DeviceAdapter>
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input,
                                           const vtkm::cont::ArrayHandle<T, StorageType>& field,
@@ -74,6 +88,7 @@ private:
   double LowerValue;
   double UpperValue;
   vtkm::worklet::Threshold Worklet;
+  vtkm::worklet::BrickRangeIndex BrickIndex;
 };
 
 template <>
@@ -18,6 +18,8 @@
 //  this software.
 //============================================================================
 
+#include <vtkm/Math.h>
+
 #include <vtkm/cont/ArrayHandleCounting.h>
 #include <vtkm/cont/ArrayHandlePermutation.h>
 #include <vtkm/cont/CellSetPermutation.h>
@@ -25,30 +27,96 @@
 
 #include <vtkm/worklet/DispatcherMapTopology.h>
 
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
 namespace
 {
 
+template <typename T>
 class ThresholdRange
 {
 public:
   VTKM_CONT
-  ThresholdRange(const vtkm::Float64& lower, const vtkm::Float64& upper)
+  ThresholdRange(const T& lower, const T& upper)
     : Lower(lower)
     , Upper(upper)
   {
   }
 
-  template <typename T>
-  VTKM_EXEC bool operator()(const T& value) const
+  VTKM_EXEC
+  bool operator()(const T& value) const { return value >= this->Lower && value <= this->Upper; }
+
+  // The same bounds as a range of the brick range index, which holds the
+  // field values converted to Float64.
+  VTKM_CONT
+  vtkm::Range GetRange() const
   {
-    return value >= static_cast<T>(this->Lower) && value <= static_cast<T>(this->Upper);
+    return vtkm::Range(static_cast<vtkm::Float64>(this->Lower),
+                       static_cast<vtkm::Float64>(this->Upper));
   }
 
 private:
-  vtkm::Float64 Lower;
-  vtkm::Float64 Upper;
+  T Lower;
+  T Upper;
 };
 
+// A range that no value of T satisfies.
+template <typename T>
+inline ThresholdRange<T> MakeEmptyThresholdRange()
+{
+  return ThresholdRange<T>(std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest());
+}
+
+// Integer bounds are rounded inward to the integers within the range. The
+// limit 2^digits is one past the largest value of T and exact in Float64.
+template <typename T>
+inline ThresholdRange<T> MakeThresholdRange(vtkm::Float64 lower,
+                                            vtkm::Float64 upper,
+                                            std::true_type)
+{
+  using Limits = std::numeric_limits<T>;
+  const vtkm::Float64 lowest = static_cast<vtkm::Float64>(Limits::lowest());
+  const vtkm::Float64 limit = std::ldexp(1.0, Limits::digits);
+
+  lower = vtkm::Ceil(lower);
+  upper = vtkm::Floor(upper);
+  if (lower >= limit || upper < lowest)
+  {
+    return MakeEmptyThresholdRange<T>();
+  }
+  return ThresholdRange<T>(lower < lowest ? Limits::lowest() : static_cast<T>(lower),
+                           upper >= limit ? Limits::max() : static_cast<T>(upper));
+}
+
+// Floating point bounds are rounded to the nearest value of T, so a threshold
+// written as a literal still selects the field value it names.
+template <typename T>
+inline ThresholdRange<T> MakeThresholdRange(vtkm::Float64 lower,
+                                            vtkm::Float64 upper,
+                                            std::false_type)
+{
+  using Limits = std::numeric_limits<T>;
+  const vtkm::Float64 lowest = static_cast<vtkm::Float64>(Limits::lowest());
+  const vtkm::Float64 max = static_cast<vtkm::Float64>(Limits::max());
+
+  if (lower > max || upper < lowest)
+  {
+    return MakeEmptyThresholdRange<T>();
+  }
+  return ThresholdRange<T>(lower < lowest ? Limits::lowest() : static_cast<T>(lower),
+                           upper > max ? Limits::max() : static_cast<T>(upper));
+}
+
+// Converts the thresholds to the type of the field once, so that the cells
+// tested and the bricks queried use exactly the same bounds.
+template <typename T>
+inline ThresholdRange<T> MakeThresholdRange(vtkm::Float64 lower, vtkm::Float64 upper)
+{
+  return MakeThresholdRange<T>(lower, upper, typename std::is_integral<T>::type());
+}
+
 } // end anon namespace
 
 namespace vtkm
@@ -76,12 +144,29 @@ inline VTKM_CONT vtkm::cont::DataSet Threshold::DoExecute(
   //get the cells and coordinates of the dataset
   const vtkm::cont::DynamicCellSet& cells = input.GetCellSet(this->GetActiveCellSetIndex());
 
-  ThresholdRange predicate(this->GetLowerThreshold(), this->GetUpperThreshold());
-  vtkm::cont::DynamicCellSet cellOut = this->Worklet.Run(vtkm::filter::ApplyPolicy(cells, policy),
-                                                         field,
-                                                         fieldMeta.GetAssociation(),
-                                                         predicate,
-                                                         DeviceAdapter());
+  const ThresholdRange<T> predicate =
+    MakeThresholdRange<T>(this->GetLowerThreshold(), this->GetUpperThreshold());
+  vtkm::cont::DynamicCellSet cellOut;
+  if (fieldMeta.IsPointField() && cells.IsType<vtkm::cont::CellSetStructured<3>>() &&
+      this->BrickIndex.IsValidFor(
+        cells.Cast<vtkm::cont::CellSetStructured<3>>(), fieldMeta.GetName(), field))
+  {
+    vtkm::cont::ArrayHandle<vtkm::Id> candidates =
+      this->BrickIndex.GetCellsIntersecting(predicate.GetRange(), DeviceAdapter());
+    cellOut = this->Worklet.RunOnCandidates(cells.Cast<vtkm::cont::CellSetStructured<3>>(),
+                                            field,
+                                            candidates,
+                                            predicate,
+                                            DeviceAdapter());
+  }
+  else
+  {
+    cellOut = this->Worklet.Run(vtkm::filter::ApplyPolicy(cells, policy),
+                                field,
+                                fieldMeta.GetAssociation(),
+                                predicate,
+                                DeviceAdapter());
+  }
 
   vtkm::cont::DataSet output;
   output.AddCellSet(cellOut);
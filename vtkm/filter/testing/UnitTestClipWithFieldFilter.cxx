@@ -92,10 +92,56 @@ void TestClipExplicit()
   }
 }
 
+void TestClipStructuredBrickRangeIndex()
+{
+  std::cout << "Testing Clip Filter on Structured data with a brick range index" << std::endl;
+
+  vtkm::cont::DataSet ds = vtkm::cont::testing::MakeTestDataSet().Make3DUniformDataSet1();
+
+  vtkm::cont::CellSetStructured<3> cells;
+  ds.GetCellSet().CopyTo(cells);
+  vtkm::cont::ArrayHandle<vtkm::Float32> pointvar;
+  ds.GetField("pointvar").GetData().CopyTo(pointvar);
+  vtkm::worklet::BrickRangeIndex index(1);
+  index.Build(cells, "pointvar", pointvar, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  for (int invert = 0; invert < 2; ++invert)
+  {
+    vtkm::filter::ClipWithField clip;
+    clip.SetClipValue(25.0);
+    clip.SetInvertClip(invert == 1);
+    clip.SetActiveField("pointvar");
+    clip.SetFieldsToPass("cellvar", vtkm::cont::Field::Association::CELL_SET);
+    const vtkm::cont::DataSet expected = clip.Execute(ds);
+
+    clip.SetBrickRangeIndex(index);
+    const vtkm::cont::DataSet result = clip.Execute(ds);
+
+    VTKM_TEST_ASSERT(result.GetCellSet().GetNumberOfCells() ==
+                       expected.GetCellSet().GetNumberOfCells(),
+                     "Wrong number of cells with a brick range index");
+    VTKM_TEST_ASSERT(result.GetCoordinateSystem().GetData().GetNumberOfValues() ==
+                       expected.GetCoordinateSystem().GetData().GetNumberOfValues(),
+                     "Wrong number of points with a brick range index");
+
+    vtkm::cont::ArrayHandle<vtkm::Float32> expectedCellvar, resultCellvar;
+    expected.GetField("cellvar").GetData().CopyTo(expectedCellvar);
+    result.GetField("cellvar").GetData().CopyTo(resultCellvar);
+    VTKM_TEST_ASSERT(resultCellvar.GetNumberOfValues() > 0, "Clip should not be empty");
+    for (vtkm::Id i = 0; i < resultCellvar.GetNumberOfValues(); ++i)
+    {
+      VTKM_TEST_ASSERT(resultCellvar.GetPortalConstControl().Get(i) ==
+                         expectedCellvar.GetPortalConstControl().Get(i),
+                       "Wrong cell field with a brick range index");
+    }
+  }
+}
+
 void TestClip()
 {
   //todo: add more clip tests
   TestClipExplicit();
+  TestClipStructuredBrickRangeIndex();
 }
 }
 
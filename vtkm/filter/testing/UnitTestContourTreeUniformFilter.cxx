@@ -66,14 +66,84 @@
 
 #include <vtkm/filter/ContourTreeUniform.h>
 
+#include <vtkm/CellShape.h>
+#include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/DataSetBuilderExplicit.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
+#include <vtkm/filter/testing/WavyBlocks.h>
+#include <vtkm/worklet/testing/GridSimplices.h>
+
+#include <vector>
 
 namespace
 {
 
 using vtkm::cont::testing::MakeTestDataSet;
 
+template <typename T>
+void CompareFields(const vtkm::cont::DataSet& expected,
+                   const vtkm::cont::DataSet& result,
+                   const std::string& name)
+{
+  vtkm::cont::ArrayHandle<T> expectedArray, resultArray;
+  expected.GetField(name).GetData().CopyTo(expectedArray);
+  result.GetField(name).GetData().CopyTo(resultArray);
+  VTKM_TEST_ASSERT(expectedArray.GetNumberOfValues() == resultArray.GetNumberOfValues(),
+                   "Contour tree has the wrong size");
+  for (vtkm::Id index = 0; index < expectedArray.GetNumberOfValues(); index++)
+  {
+    VTKM_TEST_ASSERT(test_equal(expectedArray.GetPortalConstControl().Get(index),
+                                resultArray.GetPortalConstControl().Get(index)),
+                     "Contour tree differs from the expected one");
+  }
+}
+
+template <typename FilterType>
+void TestDistributed(const vtkm::Id3& dims, const std::vector<vtkm::Id> cuts[3], bool is3D)
+{
+  vtkm::Id3 last = dims - vtkm::Id3(1);
+  vtkm::cont::DataSet whole = vtkm::filter::testing::MakeWavyBlock(vtkm::Id3(0), last, is3D);
+  vtkm::cont::MultiBlock blocks = vtkm::filter::testing::MakeWavyBlocks(dims, cuts, is3D);
+
+  FilterType filter;
+  filter.SetActiveField("pointvar");
+  vtkm::cont::DataSet expected = filter.Execute(whole);
+
+  filter.SetComputeBranchDecomposition(true);
+  vtkm::cont::DataSet expectedBranches = filter.Execute(whole);
+  CompareFields<vtkm::Pair<vtkm::Id, vtkm::Id>>(expected, expectedBranches, "saddlePeak");
+
+  vtkm::cont::MultiBlock result = filter.Execute(blocks);
+  VTKM_TEST_ASSERT(result.GetNumberOfBlocks() == 1, "Expecting the merged contour tree");
+  vtkm::cont::DataSet merged = result.GetBlock(0);
+  CompareFields<vtkm::Pair<vtkm::Id, vtkm::Id>>(expected, merged, "saddlePeak");
+  CompareFields<vtkm::Id>(expectedBranches, merged, "branchExtremum");
+  CompareFields<vtkm::Id>(expectedBranches, merged, "branchSaddle");
+  CompareFields<vtkm::Float64>(expectedBranches, merged, "branchPersistence");
+  CompareFields<vtkm::Id>(expectedBranches, merged, "branchParent");
+
+  // a tree with n superarcs has n + 1 nodes; every leaf but one ends a branch, and each
+  // branch comes before its parent
+  vtkm::cont::ArrayHandle<vtkm::Id> parents;
+  vtkm::cont::ArrayHandle<vtkm::Float64> persistence;
+  merged.GetField("branchParent").GetData().CopyTo(parents);
+  merged.GetField("branchPersistence").GetData().CopyTo(persistence);
+  vtkm::Id nBranches = parents.GetNumberOfValues();
+  VTKM_TEST_ASSERT(nBranches > 1, "Expecting several branches");
+  VTKM_TEST_ASSERT(parents.GetPortalConstControl().Get(nBranches - 1) == -1,
+                   "Main branch should come last");
+  for (vtkm::Id branch = 0; branch + 1 < nBranches; branch++)
+  {
+    vtkm::Id parent = parents.GetPortalConstControl().Get(branch);
+    VTKM_TEST_ASSERT(parent > branch, "Branch should come before its parent");
+    VTKM_TEST_ASSERT(persistence.GetPortalConstControl().Get(branch) <=
+                       persistence.GetPortalConstControl().Get(parent),
+                     "Branch should not be more persistent than its parent");
+  }
+}
+
 class TestContourTreeUniform
 {
 public:
@@ -160,10 +230,106 @@ public:
                      "Wrong result for ContourTree filter");
   }
 
+  void TestContourTree_MeshExplicit() const
+  {
+    std::cout << "Testing ContourTree_MeshExplicit Filter" << std::endl;
+
+    // Split the cubes of the uniform data set into six tetrahedra each, along the
+    // diagonal that the 3D regular mesh uses, so the contour trees must agree
+    vtkm::cont::DataSet uniform = MakeTestDataSet().Make3DUniformDataSet1();
+    vtkm::cont::CellSetSingleType<> cellSet = vtkm::worklet::testing::MakeGridSimplices(true);
+
+    vtkm::cont::DataSet inDataSet;
+    inDataSet.AddCoordinateSystem(uniform.GetCoordinateSystem());
+    inDataSet.AddCellSet(cellSet);
+    inDataSet.AddField(uniform.GetField("pointvar"));
+
+    vtkm::filter::ContourTreeMeshExplicit contourTreeMeshExplicit;
+    contourTreeMeshExplicit.SetActiveField("pointvar");
+    vtkm::cont::DataSet result = contourTreeMeshExplicit.Execute(inDataSet);
+
+    vtkm::filter::ContourTreeMesh3D contourTreeMesh3D;
+    contourTreeMesh3D.SetActiveField("pointvar");
+    vtkm::cont::DataSet expected = contourTreeMesh3D.Execute(uniform);
+
+    CompareFields<vtkm::Pair<vtkm::Id, vtkm::Id>>(expected, result, "saddlePeak");
+
+    // quads are not simplices
+    vtkm::cont::DataSet quads = MakeTestDataSet().Make2DExplicitDataSet0();
+    bool thrown = false;
+    try
+    {
+      contourTreeMeshExplicit.Execute(quads);
+    }
+    catch (vtkm::cont::ErrorFilterExecution&)
+    {
+      thrown = true;
+    }
+    VTKM_TEST_ASSERT(thrown, "Cells that are not simplices should be rejected");
+
+    // two triangles that share no point
+    using CoordType = vtkm::Vec<vtkm::Float32, 3>;
+    std::vector<CoordType> coords = { CoordType(0, 0, 0), CoordType(1, 0, 0), CoordType(0, 1, 0),
+                                      CoordType(2, 0, 0), CoordType(3, 0, 0), CoordType(2, 1, 0) };
+    std::vector<vtkm::UInt8> shapes(2, vtkm::CELL_SHAPE_TRIANGLE);
+    std::vector<vtkm::IdComponent> numIndices(2, 3);
+    std::vector<vtkm::Id> connectivity = { 0, 1, 2, 3, 4, 5 };
+    vtkm::cont::DataSet apart =
+      vtkm::cont::DataSetBuilderExplicit().Create(coords, shapes, numIndices, connectivity);
+    std::vector<vtkm::Float32> values = { 1.f, 2.f, 3.f, 4.f, 5.f, 6.f };
+    vtkm::cont::DataSetFieldAdd().AddPointField(apart, "pointvar", values);
+    thrown = false;
+    try
+    {
+      contourTreeMeshExplicit.Execute(apart);
+    }
+    catch (vtkm::cont::ErrorFilterExecution&)
+    {
+      thrown = true;
+    }
+    VTKM_TEST_ASSERT(thrown, "A mesh that is not connected should be rejected");
+  }
+
+  void TestContourTree_Distributed() const
+  {
+    std::cout << "Testing distributed ContourTree_Mesh2D Filter" << std::endl;
+    std::vector<vtkm::Id> cuts2D[3] = { { 4, 9 }, { 5 }, {} };
+    TestDistributed<vtkm::filter::ContourTreeMesh2D>(vtkm::Id3(15, 11, 1), cuts2D, false);
+
+    std::cout << "Testing distributed ContourTree_Mesh3D Filter" << std::endl;
+    std::vector<vtkm::Id> cuts3D[3] = { { 4, 9 }, { 7 }, { 3, 10 } };
+    TestDistributed<vtkm::filter::ContourTreeMesh3D>(vtkm::Id3(17, 15, 16), cuts3D, true);
+
+    // the right block spans both rows of the left column, so the points along x = 7 are
+    // shared by three blocks instead of two
+    std::cout << "Testing distributed ContourTree_Mesh2D Filter on a T-junction" << std::endl;
+    vtkm::cont::MultiBlock tJunction;
+    tJunction.AddBlock(
+      vtkm::filter::testing::MakeWavyBlock(vtkm::Id3(0, 0, 0), vtkm::Id3(7, 5, 0), false));
+    tJunction.AddBlock(
+      vtkm::filter::testing::MakeWavyBlock(vtkm::Id3(0, 5, 0), vtkm::Id3(7, 10, 0), false));
+    tJunction.AddBlock(
+      vtkm::filter::testing::MakeWavyBlock(vtkm::Id3(7, 0, 0), vtkm::Id3(14, 10, 0), false));
+    vtkm::filter::ContourTreeMesh2D filter;
+    filter.SetActiveField("pointvar");
+    bool thrown = false;
+    try
+    {
+      filter.Execute(tJunction);
+    }
+    catch (vtkm::cont::ErrorFilterExecution&)
+    {
+      thrown = true;
+    }
+    VTKM_TEST_ASSERT(thrown, "Blocks that are not a regular lattice should be rejected");
+  }
+
   void operator()() const
   {
     this->TestContourTree_Mesh2D_DEM_Triangulation();
     this->TestContourTree_Mesh3D_DEM_Triangulation();
+    this->TestContourTree_MeshExplicit();
+    this->TestContourTree_Distributed();
   }
 };
 }
@@ -0,0 +1,114 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2017 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2017 UT-Battelle, LLC.
+//  Copyright 2017 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/MultiBlock.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/filter/ContourTreeUniform.h>
+#include <vtkm/filter/testing/WavyBlocks.h>
+
+// clang-format off
+VTKM_THIRDPARTY_PRE_INCLUDE
+#include <vtkm/thirdparty/diy/Configure.h>
+#include VTKM_DIY(diy/mpi.hpp)
+VTKM_THIRDPARTY_POST_INCLUDE
+// clang-format on
+
+#include <vector>
+
+namespace
+{
+
+template <typename T>
+void CompareFields(const vtkm::cont::DataSet& expected,
+                   const vtkm::cont::DataSet& result,
+                   const std::string& name)
+{
+  vtkm::cont::ArrayHandle<T> expectedArray, resultArray;
+  expected.GetField(name).GetData().CopyTo(expectedArray);
+  result.GetField(name).GetData().CopyTo(resultArray);
+  VTKM_TEST_ASSERT(expectedArray.GetNumberOfValues() == resultArray.GetNumberOfValues(),
+                   "Contour tree has the wrong size");
+  for (vtkm::Id index = 0; index < expectedArray.GetNumberOfValues(); index++)
+  {
+    VTKM_TEST_ASSERT(test_equal(expectedArray.GetPortalConstControl().Get(index),
+                                resultArray.GetPortalConstControl().Get(index)),
+                     "Contour tree differs from the expected one");
+  }
+}
+
+//The wavy volume is cut into blocks, and every rank takes a contiguous range of them.
+//Every rank has to end up with the contour tree of the whole volume.
+template <typename FilterType>
+void TestDistributed(const vtkm::Id3& dims, const std::vector<vtkm::Id> cuts[3], bool is3D)
+{
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  vtkm::cont::MultiBlock allBlocks = vtkm::filter::testing::MakeWavyBlocks(dims, cuts, is3D);
+  const vtkm::Id numBlocks = allBlocks.GetNumberOfBlocks();
+  if (numBlocks < comm.size())
+  {
+    std::cout << "Skipped, there are fewer blocks than ranks" << std::endl;
+    return;
+  }
+
+  vtkm::cont::MultiBlock localBlocks;
+  const vtkm::Id begin = numBlocks * comm.rank() / comm.size();
+  const vtkm::Id end = numBlocks * (comm.rank() + 1) / comm.size();
+  for (vtkm::Id index = begin; index < end; ++index)
+  {
+    localBlocks.AddBlock(allBlocks.GetBlock(index));
+  }
+
+  FilterType filter;
+  filter.SetActiveField("pointvar");
+  filter.SetComputeBranchDecomposition(true);
+
+  //The reference tree is computed by every rank on its own.
+  vtkm::cont::EnvironmentTracker::SetCommunicator(comm.split(comm.rank()));
+  vtkm::cont::DataSet whole =
+    vtkm::filter::testing::MakeWavyBlock(vtkm::Id3(0), dims - vtkm::Id3(1), is3D);
+  vtkm::cont::DataSet expected = filter.Execute(whole);
+  vtkm::cont::EnvironmentTracker::SetCommunicator(comm);
+
+  vtkm::cont::MultiBlock result = filter.Execute(localBlocks);
+  VTKM_TEST_ASSERT(result.GetNumberOfBlocks() == 1, "Expecting the merged contour tree");
+  vtkm::cont::DataSet merged = result.GetBlock(0);
+  CompareFields<vtkm::Pair<vtkm::Id, vtkm::Id>>(expected, merged, "saddlePeak");
+  CompareFields<vtkm::Id>(expected, merged, "branchExtremum");
+  CompareFields<vtkm::Id>(expected, merged, "branchSaddle");
+  CompareFields<vtkm::Float64>(expected, merged, "branchPersistence");
+  CompareFields<vtkm::Id>(expected, merged, "branchParent");
+}
+
+void TestDistributedContourTreeFilter()
+{
+  std::cout << "Testing ContourTree_Mesh2D Filter across ranks" << std::endl;
+  std::vector<vtkm::Id> cuts2D[3] = { { 4, 9 }, { 3, 5, 8 }, {} };
+  TestDistributed<vtkm::filter::ContourTreeMesh2D>(vtkm::Id3(15, 11, 1), cuts2D, false);
+
+  std::cout << "Testing ContourTree_Mesh3D Filter across ranks" << std::endl;
+  std::vector<vtkm::Id> cuts3D[3] = { { 4, 9 }, { 7 }, { 3, 10 } };
+  TestDistributed<vtkm::filter::ContourTreeMesh3D>(vtkm::Id3(17, 15, 16), cuts3D, true);
+}
+}
+
+int UnitTestDistributedContourTreeFilter(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestDistributedContourTreeFilter);
+}
@@ -0,0 +1,139 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2017 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2017 UT-Battelle, LLC.
+//  Copyright 2017 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/MultiBlock.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/filter/ParticleAdvection.h>
+
+// clang-format off
+VTKM_THIRDPARTY_PRE_INCLUDE
+#include <vtkm/thirdparty/diy/Configure.h>
+#include VTKM_DIY(diy/mpi.hpp)
+VTKM_THIRDPARTY_POST_INCLUDE
+// clang-format on
+
+#include <functional>
+
+namespace
+{
+
+const vtkm::Id BlocksPerRank = 2;
+
+//Blocks of 4x4x4 cells stacked along X by global block id, each rank holding
+//BlocksPerRank consecutive blocks.
+vtkm::cont::MultiBlock MakeLocalBlocks(int rank)
+{
+  const vtkm::Id3 dims(5, 5, 5);
+  const vtkm::Id numPoints = dims[0] * dims[1] * dims[2];
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> vectorField(
+    static_cast<std::size_t>(numPoints), vtkm::Vec<vtkm::FloatDefault, 3>(1, 0, 0));
+
+  vtkm::cont::DataSetBuilderUniform dataSetBuilder;
+  vtkm::cont::DataSetFieldAdd dataSetField;
+  vtkm::cont::MultiBlock blocks;
+  for (vtkm::Id cc = 0; cc < BlocksPerRank; ++cc)
+  {
+    const vtkm::Id gid = rank * BlocksPerRank + cc;
+    const vtkm::Vec<vtkm::FloatDefault, 3> origin(static_cast<vtkm::FloatDefault>(4 * gid), 0, 0);
+    vtkm::cont::DataSet ds =
+      dataSetBuilder.Create(dims, origin, vtkm::Vec<vtkm::FloatDefault, 3>(1, 1, 1));
+    dataSetField.AddPointField(ds, "vector", vectorField);
+    blocks.AddBlock(ds);
+  }
+  return blocks;
+}
+
+void TestDistributedParticleAdvectionFilter()
+{
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  const vtkm::Id numBlocks = BlocksPerRank * comm.size();
+  const vtkm::FloatDefault length = static_cast<vtkm::FloatDefault>(4 * numBlocks);
+  vtkm::cont::MultiBlock input = MakeLocalBlocks(comm.rank());
+
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> seeds;
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(.5f, 1.0f, 1.0f));
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(.5f, 2.0f, 2.0f));
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(4.5f, 3.0f, 3.0f));
+  //Outside of all blocks, ignored.
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(length + 8.0f, 2.0f, 2.0f));
+
+  vtkm::filter::ParticleAdvection advection;
+  advection.SetStepSize(0.1);
+  advection.SetSeeds(vtkm::cont::make_ArrayHandle(seeds));
+  advection.SetActiveField("vector");
+
+  //The first two seeds travel through all blocks, and so across all ranks, to
+  //stop in the last block. The third one starts in the second
+  //block and leaves the domain through the last block.
+  const vtkm::Id numSteps = 40 * numBlocks - 25;
+  advection.SetNumberOfSteps(numSteps);
+  vtkm::cont::MultiBlock output = advection.Execute(input);
+  VTKM_TEST_ASSERT(output.GetNumberOfBlocks() == BlocksPerRank, "Wrong number of output blocks");
+  VTKM_TEST_ASSERT(advection.GetNumberOfRounds() == numBlocks, "Wrong number of rounds");
+
+  vtkm::Id numParticles = 0;
+  for (vtkm::Id blockId = 0; blockId < BlocksPerRank; ++blockId)
+  {
+    const vtkm::Id gid = comm.rank() * BlocksPerRank + blockId;
+    vtkm::cont::DataSet block = output.GetBlock(blockId);
+    vtkm::cont::ArrayHandle<vtkm::Id> seedIds;
+    vtkm::cont::ArrayHandle<vtkm::Id> stepsTaken;
+    block.GetField("seed_ids").GetData().CopyTo(seedIds);
+    block.GetField("steps_taken").GetData().CopyTo(stepsTaken);
+    auto positions = block.GetCoordinateSystem().GetData().GetPortalConstControl();
+
+    const vtkm::Id numBlockParticles = seedIds.GetNumberOfValues();
+    VTKM_TEST_ASSERT(gid == numBlocks - 1 || numBlockParticles == 0,
+                     "Particles should terminate in the last block");
+    for (vtkm::Id cc = 0; cc < numBlockParticles; ++cc)
+    {
+      const vtkm::Id seedId = seedIds.GetPortalConstControl().Get(cc);
+      const vtkm::Vec<vtkm::FloatDefault, 3> seed = seeds[static_cast<std::size_t>(seedId)];
+      const vtkm::Vec<vtkm::FloatDefault, 3> pos = positions.Get(cc);
+      if (seedId < 2)
+      {
+        VTKM_TEST_ASSERT(stepsTaken.GetPortalConstControl().Get(cc) == numSteps,
+                         "Wrong number of steps");
+        VTKM_TEST_ASSERT(pos[0] > length - 4.0f && pos[0] < length, "Particle did not advect");
+      }
+      else
+      {
+        VTKM_TEST_ASSERT(stepsTaken.GetPortalConstControl().Get(cc) < numSteps,
+                         "Particle should exit the domain early");
+        VTKM_TEST_ASSERT(pos[0] >= length, "Particle should exit the domain");
+      }
+      VTKM_TEST_ASSERT(test_equal(pos[1], seed[1]) && test_equal(pos[2], seed[2]),
+                       "Particle left its streamline");
+    }
+    numParticles += numBlockParticles;
+  }
+
+  vtkm::Id globalParticles = 0;
+  diy::mpi::all_reduce(comm, numParticles, globalParticles, std::plus<vtkm::Id>());
+  VTKM_TEST_ASSERT(globalParticles == 3, "Wrong number of particles");
+}
+}
+
+int UnitTestDistributedParticleAdvectionFilter(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestDistributedParticleAdvectionFilter);
+}
@@ -0,0 +1,285 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2017 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2017 UT-Battelle, LLC.
+//  Copyright 2017 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/DataSetBuilderExplicit.h>
+#include <vtkm/cont/DataSetBuilderRectilinear.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
+#include <vtkm/cont/MultiBlock.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/filter/ParticleAdvection.h>
+
+namespace
+{
+
+vtkm::cont::MultiBlock MakeBlocks(vtkm::Id numBlocks)
+{
+  //Blocks of 4x4x4 cells stacked along X, sharing their boundary faces.
+  const vtkm::Id3 dims(5, 5, 5);
+  const vtkm::Id numPoints = dims[0] * dims[1] * dims[2];
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> vectorField(
+    static_cast<std::size_t>(numPoints), vtkm::Vec<vtkm::FloatDefault, 3>(1, 0, 0));
+
+  vtkm::cont::DataSetBuilderUniform dataSetBuilder;
+  vtkm::cont::DataSetFieldAdd dataSetField;
+  vtkm::cont::MultiBlock blocks;
+  for (vtkm::Id cc = 0; cc < numBlocks; ++cc)
+  {
+    const vtkm::Vec<vtkm::FloatDefault, 3> origin(static_cast<vtkm::FloatDefault>(4 * cc), 0, 0);
+    vtkm::cont::DataSet ds =
+      dataSetBuilder.Create(dims, origin, vtkm::Vec<vtkm::FloatDefault, 3>(1, 1, 1));
+    dataSetField.AddPointField(ds, "vector", vectorField);
+    blocks.AddBlock(ds);
+  }
+  return blocks;
+}
+
+//A block of 4x4x4 unit hexahedra starting at x = originX with only the cells
+//at y >= minCellY, so the block has a hole in its bounds below that.
+vtkm::cont::DataSet MakeExplicitBlock(vtkm::FloatDefault originX, vtkm::Id minCellY)
+{
+  const vtkm::Id size = 5;
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> points;
+  for (vtkm::Id k = 0; k < size; ++k)
+  {
+    for (vtkm::Id j = 0; j < size; ++j)
+    {
+      for (vtkm::Id i = 0; i < size; ++i)
+      {
+        points.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(
+          originX + static_cast<vtkm::FloatDefault>(i),
+          static_cast<vtkm::FloatDefault>(j),
+          static_cast<vtkm::FloatDefault>(k)));
+      }
+    }
+  }
+
+  std::vector<vtkm::UInt8> shapes;
+  std::vector<vtkm::IdComponent> numIndices;
+  std::vector<vtkm::Id> connectivity;
+  auto pointId = [&](vtkm::Id i, vtkm::Id j, vtkm::Id k) { return (k * size + j) * size + i; };
+  for (vtkm::Id k = 0; k < size - 1; ++k)
+  {
+    for (vtkm::Id j = minCellY; j < size - 1; ++j)
+    {
+      for (vtkm::Id i = 0; i < size - 1; ++i)
+      {
+        shapes.push_back(vtkm::CELL_SHAPE_HEXAHEDRON);
+        numIndices.push_back(8);
+        connectivity.insert(connectivity.end(),
+                            { pointId(i, j, k),
+                              pointId(i + 1, j, k),
+                              pointId(i + 1, j + 1, k),
+                              pointId(i, j + 1, k),
+                              pointId(i, j, k + 1),
+                              pointId(i + 1, j, k + 1),
+                              pointId(i + 1, j + 1, k + 1),
+                              pointId(i, j + 1, k + 1) });
+      }
+    }
+  }
+
+  vtkm::cont::DataSet ds =
+    vtkm::cont::DataSetBuilderExplicit().Create(points, shapes, numIndices, connectivity);
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> vectorField(
+    points.size(), vtkm::Vec<vtkm::FloatDefault, 3>(1, 0, 0));
+  vtkm::cont::DataSetFieldAdd().AddPointField(ds, "vector", vectorField);
+  return ds;
+}
+
+void TestMixedBlockTypes()
+{
+  //A uniform, a rectilinear and an explicit block stacked along X as in
+  //MakeBlocks, so the particles have to travel exactly as through those.
+  vtkm::cont::MultiBlock input;
+  input.AddBlock(MakeBlocks(1).GetBlock(0));
+
+  std::vector<vtkm::FloatDefault> xCoords{ 4, 5, 6, 7, 8 };
+  std::vector<vtkm::FloatDefault> yzCoords{ 0, 1, 2, 3, 4 };
+  vtkm::cont::DataSet rectilinear =
+    vtkm::cont::DataSetBuilderRectilinear().Create(xCoords, yzCoords, yzCoords);
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> vectorField(
+    125, vtkm::Vec<vtkm::FloatDefault, 3>(1, 0, 0));
+  vtkm::cont::DataSetFieldAdd().AddPointField(rectilinear, "vector", vectorField);
+  input.AddBlock(rectilinear);
+  input.AddBlock(MakeExplicitBlock(8, 0));
+
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> seeds;
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(.5f, 1.0f, 1.0f));
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(1.5f, 2.0f, 2.0f));
+
+  vtkm::filter::ParticleAdvection advection;
+  advection.SetStepSize(0.1);
+  advection.SetSeeds(vtkm::cont::make_ArrayHandle(seeds));
+  advection.SetActiveField("vector");
+  advection.SetNumberOfSteps(80);
+  vtkm::cont::MultiBlock output = advection.Execute(input);
+
+  vtkm::cont::DataSet lastBlock = output.GetBlock(2);
+  vtkm::cont::ArrayHandle<vtkm::Id> seedIds;
+  vtkm::cont::ArrayHandle<vtkm::Id> stepsTaken;
+  lastBlock.GetField("seed_ids").GetData().CopyTo(seedIds);
+  lastBlock.GetField("steps_taken").GetData().CopyTo(stepsTaken);
+  VTKM_TEST_ASSERT(seedIds.GetNumberOfValues() == 2, "Particles should stop in the last block");
+  auto positions = lastBlock.GetCoordinateSystem().GetData().GetPortalConstControl();
+  for (vtkm::Id cc = 0; cc < 2; ++cc)
+  {
+    const vtkm::Vec<vtkm::FloatDefault, 3> seed =
+      seeds[static_cast<std::size_t>(seedIds.GetPortalConstControl().Get(cc))];
+    const vtkm::Vec<vtkm::FloatDefault, 3> pos = positions.Get(cc);
+    VTKM_TEST_ASSERT(stepsTaken.GetPortalConstControl().Get(cc) == 80, "Wrong number of steps");
+    VTKM_TEST_ASSERT(pos[0] > 8.0f && pos[0] < 12.0f, "Particle did not advect");
+    VTKM_TEST_ASSERT(test_equal(pos[1], seed[1]) && test_equal(pos[2], seed[2]),
+                     "Particle left its streamline");
+  }
+}
+
+void TestStuckParticles()
+{
+  //The second block has no cells at y < 2, so the first seed enters its
+  //bounds but cannot move any further. It has to terminate there instead of
+  //being sent back to the same block forever.
+  vtkm::cont::MultiBlock input;
+  input.AddBlock(MakeBlocks(1).GetBlock(0));
+  input.AddBlock(MakeExplicitBlock(4, 2));
+
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> seeds;
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(.5f, 1.0f, 1.0f));
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(.5f, 3.0f, 3.0f));
+
+  vtkm::filter::ParticleAdvection advection;
+  advection.SetStepSize(0.1);
+  advection.SetSeeds(vtkm::cont::make_ArrayHandle(seeds));
+  advection.SetActiveField("vector");
+  advection.SetNumberOfSteps(1000);
+  vtkm::cont::MultiBlock output = advection.Execute(input);
+  VTKM_TEST_ASSERT(advection.GetNumberOfRounds() == 2, "Wrong number of rounds");
+
+  vtkm::cont::DataSet lastBlock = output.GetBlock(1);
+  vtkm::cont::ArrayHandle<vtkm::Id> seedIds;
+  vtkm::cont::ArrayHandle<vtkm::Id> stepsTaken;
+  lastBlock.GetField("seed_ids").GetData().CopyTo(seedIds);
+  lastBlock.GetField("steps_taken").GetData().CopyTo(stepsTaken);
+  VTKM_TEST_ASSERT(seedIds.GetNumberOfValues() == 2, "Particles should stop in the last block");
+  auto positions = lastBlock.GetCoordinateSystem().GetData().GetPortalConstControl();
+  for (vtkm::Id cc = 0; cc < 2; ++cc)
+  {
+    const vtkm::Vec<vtkm::FloatDefault, 3> pos = positions.Get(cc);
+    VTKM_TEST_ASSERT(stepsTaken.GetPortalConstControl().Get(cc) < 1000,
+                     "Particle should stop early");
+    if (seedIds.GetPortalConstControl().Get(cc) == 0)
+    {
+      VTKM_TEST_ASSERT(pos[0] > 4.0f && pos[0] < 4.1f, "Particle should stop at the hole");
+    }
+    else
+    {
+      VTKM_TEST_ASSERT(pos[0] >= 8.0f, "Particle should exit the domain");
+    }
+  }
+}
+
+void TestParticleAdvectionFilter()
+{
+  const vtkm::Id numBlocks = 3;
+  vtkm::cont::MultiBlock input = MakeBlocks(numBlocks);
+
+  std::vector<vtkm::Vec<vtkm::FloatDefault, 3>> seeds;
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(.5f, 1.0f, 1.0f));
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(.5f, 2.0f, 2.0f));
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(4.5f, 3.0f, 3.0f));
+  //Outside of all blocks, ignored.
+  seeds.push_back(vtkm::Vec<vtkm::FloatDefault, 3>(20.0f, 2.0f, 2.0f));
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>> seedArray =
+    vtkm::cont::make_ArrayHandle(seeds);
+
+  vtkm::filter::ParticleAdvection advection;
+  advection.SetStepSize(0.1);
+  advection.SetSeeds(seedArray);
+  advection.SetActiveField("vector");
+
+  //The first two seeds travel through blocks 0 and 1 and stop in block 2, the
+  //third one starts in block 1 and leaves the domain through block 2.
+  advection.SetNumberOfSteps(80);
+  vtkm::cont::MultiBlock output = advection.Execute(input);
+  VTKM_TEST_ASSERT(output.GetNumberOfBlocks() == numBlocks, "Wrong number of output blocks");
+  VTKM_TEST_ASSERT(advection.GetNumberOfRounds() == 3, "Wrong number of rounds");
+
+  vtkm::Id numParticles = 0;
+  for (vtkm::Id blockId = 0; blockId < numBlocks; ++blockId)
+  {
+    vtkm::cont::DataSet block = output.GetBlock(blockId);
+    vtkm::cont::ArrayHandle<vtkm::Id> seedIds;
+    vtkm::cont::ArrayHandle<vtkm::Id> stepsTaken;
+    block.GetField("seed_ids").GetData().CopyTo(seedIds);
+    block.GetField("steps_taken").GetData().CopyTo(stepsTaken);
+    auto positions = block.GetCoordinateSystem().GetData().GetPortalConstControl();
+
+    const vtkm::Id numBlockParticles = seedIds.GetNumberOfValues();
+    VTKM_TEST_ASSERT(block.GetCellSet().GetNumberOfCells() == numBlockParticles,
+                     "Wrong number of cells");
+    VTKM_TEST_ASSERT(block.HasField("status") && block.HasField("time"),
+                     "Missing particle fields");
+    VTKM_TEST_ASSERT(blockId == 2 || numBlockParticles == 0,
+                     "Particles should terminate in the last block");
+    for (vtkm::Id cc = 0; cc < numBlockParticles; ++cc)
+    {
+      const vtkm::Id seedId = seedIds.GetPortalConstControl().Get(cc);
+      const vtkm::Vec<vtkm::FloatDefault, 3> seed = seeds[static_cast<std::size_t>(seedId)];
+      const vtkm::Vec<vtkm::FloatDefault, 3> pos = positions.Get(cc);
+      if (seedId < 2)
+      {
+        VTKM_TEST_ASSERT(stepsTaken.GetPortalConstControl().Get(cc) == 80,
+                         "Wrong number of steps");
+        VTKM_TEST_ASSERT(pos[0] > 8.0f && pos[0] < 12.0f, "Particle did not advect");
+      }
+      else
+      {
+        VTKM_TEST_ASSERT(stepsTaken.GetPortalConstControl().Get(cc) < 80,
+                         "Particle should exit the domain early");
+        VTKM_TEST_ASSERT(pos[0] >= 12.0f, "Particle should exit the domain");
+      }
+      VTKM_TEST_ASSERT(test_equal(pos[1], seed[1]) && test_equal(pos[2], seed[2]),
+                       "Particle left its streamline");
+    }
+    numParticles += numBlockParticles;
+  }
+  VTKM_TEST_ASSERT(numParticles == 3, "Wrong number of particles");
+
+  //With enough steps, all seeds leave the global domain through the last block.
+  advection.SetNumberOfSteps(1000);
+  output = advection.Execute(input);
+  vtkm::cont::DataSet lastBlock = output.GetBlock(numBlocks - 1);
+  VTKM_TEST_ASSERT(lastBlock.GetCoordinateSystem().GetData().GetNumberOfValues() == 3,
+                   "Wrong number of particles in last block");
+  auto positions = lastBlock.GetCoordinateSystem().GetData().GetPortalConstControl();
+  for (vtkm::Id cc = 0; cc < 3; ++cc)
+  {
+    VTKM_TEST_ASSERT(positions.Get(cc)[0] >= 12.0f, "Particle should exit the domain");
+  }
+
+  TestMixedBlockTypes();
+  TestStuckParticles();
+}
+}
+
+int UnitTestParticleAdvectionFilter(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestParticleAdvectionFilter);
+}
@@ -18,6 +18,8 @@
 //  this software.
 //============================================================================
 
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 
@@ -80,6 +82,110 @@ public:
                      "Wrong cell field data");
   }
 
+  void TestRegular3DBrickRangeIndex() const
+  {
+    std::cout << "Testing threshold on 3D regular dataset with a brick range index" << std::endl;
+    vtkm::cont::DataSet dataset = MakeTestDataSet().Make3DUniformDataSet0();
+
+    vtkm::cont::CellSetStructured<3> cells;
+    dataset.GetCellSet().CopyTo(cells);
+    vtkm::cont::ArrayHandle<vtkm::Float32> pointvar;
+    dataset.GetField("pointvar").GetData().CopyTo(pointvar);
+    vtkm::worklet::BrickRangeIndex index(1);
+    index.Build(cells, "pointvar", pointvar, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+    vtkm::filter::Threshold threshold;
+    threshold.SetBrickRangeIndex(index);
+    threshold.SetLowerThreshold(20.1);
+    threshold.SetUpperThreshold(20.1);
+    threshold.SetActiveField("pointvar");
+    threshold.SetFieldsToPass("cellvar");
+    auto output = threshold.Execute(dataset);
+
+    vtkm::cont::ArrayHandle<vtkm::Float32> cellFieldArray;
+    output.GetField("cellvar").GetData().CopyTo(cellFieldArray);
+
+    VTKM_TEST_ASSERT(cellFieldArray.GetNumberOfValues() == 2 &&
+                       cellFieldArray.GetPortalConstControl().Get(0) == 100.1f &&
+                       cellFieldArray.GetPortalConstControl().Get(1) == 100.2f,
+                     "Wrong cell field data");
+
+    threshold.SetLowerThreshold(500.1);
+    threshold.SetUpperThreshold(500.1);
+    output = threshold.Execute(dataset);
+    output.GetField("cellvar").GetData().CopyTo(cellFieldArray);
+    VTKM_TEST_ASSERT(cellFieldArray.GetNumberOfValues() == 0, "field should be empty");
+  }
+
+  // Number of cells kept, checking that the brick range index keeps the same ones
+  template <typename T>
+  vtkm::Id ThresholdBounds(const vtkm::cont::DataSet& dataset,
+                           const std::string& fieldName,
+                           vtkm::Float64 lower,
+                           vtkm::Float64 upper) const
+  {
+    vtkm::cont::CellSetStructured<3> cells;
+    dataset.GetCellSet().CopyTo(cells);
+    vtkm::cont::ArrayHandle<T> field;
+    dataset.GetField(fieldName).GetData().CopyTo(field);
+    vtkm::worklet::BrickRangeIndex index(1);
+    index.Build(cells, fieldName, field, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+    vtkm::filter::Threshold threshold;
+    threshold.SetLowerThreshold(lower);
+    threshold.SetUpperThreshold(upper);
+    threshold.SetActiveField(fieldName);
+    vtkm::Id numCells = threshold.Execute(dataset).GetCellSet().GetNumberOfCells();
+
+    threshold.SetBrickRangeIndex(index);
+    VTKM_TEST_ASSERT(threshold.Execute(dataset).GetCellSet().GetNumberOfCells() == numCells,
+                     "Brick range index changed the thresholded cells");
+    return numCells;
+  }
+
+  void TestBrickRangeIndexBounds() const
+  {
+    std::cout << "Testing threshold bounds with a brick range index" << std::endl;
+
+    // A row of 7 cells, cell i having the points of values i and i + 1. A cell
+    // is kept when one of its points is within the thresholds.
+    const vtkm::Id3 dims(8, 2, 2);
+    vtkm::cont::DataSet dataset = vtkm::cont::DataSetBuilderUniform().Create(dims);
+    std::vector<vtkm::Int32> ints;
+    std::vector<vtkm::Float32> floats;
+    for (vtkm::Id k = 0; k < dims[2]; ++k)
+    {
+      for (vtkm::Id j = 0; j < dims[1]; ++j)
+      {
+        for (vtkm::Id i = 0; i < dims[0]; ++i)
+        {
+          ints.push_back(static_cast<vtkm::Int32>(i));
+          floats.push_back(static_cast<vtkm::Float32>(static_cast<vtkm::Float64>(i) * 0.1));
+        }
+      }
+    }
+    vtkm::cont::DataSetFieldAdd::AddPointField(dataset, "ints", ints);
+    vtkm::cont::DataSetFieldAdd::AddPointField(dataset, "floats", floats);
+
+    // Integer fields keep the integers within the bounds
+    VTKM_TEST_ASSERT(ThresholdBounds<vtkm::Int32>(dataset, "ints", 2.5, 3.5) == 2,
+                     "Wrong cells for fractional integer bounds");
+    VTKM_TEST_ASSERT(ThresholdBounds<vtkm::Int32>(dataset, "ints", 3.0, 3.9) == 2,
+                     "Wrong cells for fractional integer bounds");
+    VTKM_TEST_ASSERT(ThresholdBounds<vtkm::Int32>(dataset, "ints", -1e300, 1e300) == 7,
+                     "Wrong cells for bounds beyond the integer range");
+    VTKM_TEST_ASSERT(ThresholdBounds<vtkm::Int32>(dataset, "ints", 1e300, 1e301) == 0,
+                     "Wrong cells for bounds above the integer range");
+
+    // Float fields keep the values the bounds round to
+    VTKM_TEST_ASSERT(ThresholdBounds<vtkm::Float32>(dataset, "floats", 0.2, 0.4) == 4,
+                     "Wrong cells for float bounds equal to field values");
+    VTKM_TEST_ASSERT(ThresholdBounds<vtkm::Float32>(dataset, "floats", 0.2 + 1e-6, 0.4) == 3,
+                     "Wrong cells for float bounds just above a field value");
+    VTKM_TEST_ASSERT(ThresholdBounds<vtkm::Float32>(dataset, "floats", 1e300, 1e301) == 0,
+                     "Wrong cells for bounds above the float range");
+  }
+
   void TestExplicit3D() const
   {
     std::cout << "Testing threshold on 3D explicit dataset" << std::endl;
@@ -131,6 +237,8 @@ public:
   {
     this->TestRegular2D();
     this->TestRegular3D();
+    this->TestRegular3DBrickRangeIndex();
+    this->TestBrickRangeIndexBounds();
     this->TestExplicit3D();
     this->TestExplicit3DZeroResults();
   }
@@ -0,0 +1,107 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_filter_testing_WavyBlocks_h
+#define vtk_m_filter_testing_WavyBlocks_h
+
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
+#include <vtkm/cont/MultiBlock.h>
+
+#include <cmath>
+#include <vector>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace testing
+{
+
+// A smooth field with many extrema, so that its contour tree has many branches
+inline vtkm::Float32 WavyValue(vtkm::Id x, vtkm::Id y, vtkm::Id z)
+{
+  vtkm::Float64 fx = static_cast<vtkm::Float64>(x);
+  vtkm::Float64 fy = static_cast<vtkm::Float64>(y);
+  vtkm::Float64 fz = static_cast<vtkm::Float64>(z);
+  return static_cast<vtkm::Float32>(std::sin(0.7 * fx) * std::cos(0.5 * fy) +
+                                    0.3 * std::sin(0.9 * fz + 0.2 * fx));
+}
+
+// The points from first to last (inclusive) of a volume with a wavy field
+inline vtkm::cont::DataSet MakeWavyBlock(const vtkm::Id3& first, const vtkm::Id3& last, bool is3D)
+{
+  vtkm::Id3 dims = last - first + vtkm::Id3(1);
+  std::vector<vtkm::Float32> values;
+  for (vtkm::Id z = first[2]; z <= last[2]; z++)
+    for (vtkm::Id y = first[1]; y <= last[1]; y++)
+      for (vtkm::Id x = first[0]; x <= last[0]; x++)
+        values.push_back(WavyValue(x, y, z));
+
+  using CoordType = vtkm::FloatDefault;
+  vtkm::cont::DataSetBuilderUniform builder;
+  vtkm::cont::DataSet dataSet;
+  if (is3D)
+  {
+    vtkm::Vec<CoordType, 3> origin(static_cast<CoordType>(first[0]),
+                                   static_cast<CoordType>(first[1]),
+                                   static_cast<CoordType>(first[2]));
+    dataSet = builder.Create(dims, origin, vtkm::Vec<CoordType, 3>(1, 1, 1));
+  }
+  else
+  {
+    vtkm::Vec<CoordType, 2> origin(static_cast<CoordType>(first[0]),
+                                   static_cast<CoordType>(first[1]));
+    dataSet =
+      builder.Create(vtkm::Id2(dims[0], dims[1]), origin, vtkm::Vec<CoordType, 2>(1, 1));
+  }
+  vtkm::cont::DataSetFieldAdd().AddPointField(dataSet, "pointvar", values);
+  return dataSet;
+}
+
+// Cuts a volume into blocks that share the points on their common faces
+inline vtkm::cont::MultiBlock MakeWavyBlocks(const vtkm::Id3& dims,
+                                             const std::vector<vtkm::Id> cuts[3],
+                                             bool is3D)
+{
+  std::vector<vtkm::Id> bounds[3];
+  for (int dim = 0; dim < 3; dim++)
+  {
+    bounds[dim].push_back(0);
+    bounds[dim].insert(bounds[dim].end(), cuts[dim].begin(), cuts[dim].end());
+    bounds[dim].push_back(dims[dim] - 1);
+  }
+
+  vtkm::cont::MultiBlock blocks;
+  for (std::size_t k = 0; k + 1 < bounds[2].size(); k++)
+    for (std::size_t j = 0; j + 1 < bounds[1].size(); j++)
+      for (std::size_t i = 0; i + 1 < bounds[0].size(); i++)
+      {
+        vtkm::Id3 first(bounds[0][i], bounds[1][j], bounds[2][k]);
+        vtkm::Id3 last(bounds[0][i + 1], bounds[1][j + 1], bounds[2][k + 1]);
+        blocks.AddBlock(MakeWavyBlock(first, last, is3D));
+      }
+  return blocks;
+}
+}
+}
+} // namespace vtkm::filter::testing
+
+#endif // vtk_m_filter_testing_WavyBlocks_h
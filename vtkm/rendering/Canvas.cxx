@@ -21,17 +21,24 @@
 #include <vtkm/rendering/Canvas.h>
 
 #include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayPortalToIterators.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/TryExecute.h>
 #include <vtkm/rendering/BitmapFontFactory.h>
 #include <vtkm/rendering/DecodePNG.h>
+#include <vtkm/rendering/EncodePNG.h>
 #include <vtkm/rendering/LineRenderer.h>
 #include <vtkm/rendering/TextRenderer.h>
 #include <vtkm/rendering/WorldAnnotator.h>
+#include <vtkm/rendering/internal/AnnotationBatch.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 namespace vtkm
 {
@@ -140,6 +147,264 @@ struct BlendBackgroundExecutor
   }
 }; // struct BlendBackgroundExecutor
 
+// Converts the color buffer to 8 bit channels. The rows are flipped so the
+// top row of the image comes first, which is what image files expect.
+struct ColorsToBytes : public vtkm::worklet::WorkletMapField
+{
+  vtkm::Id Width;
+  vtkm::Id Height;
+  vtkm::IdComponent Channels;
+
+  VTKM_CONT
+  ColorsToBytes(vtkm::Id width, vtkm::Id height, vtkm::IdComponent channels)
+    : Width(width)
+    , Height(height)
+    , Channels(channels)
+  {
+  }
+
+  using ControlSignature = void(FieldIn<>, WholeArrayOut<>);
+  using ExecutionSignature = void(_1, _2, WorkIndex);
+
+  template <typename BytesPortalType>
+  VTKM_EXEC void operator()(const vtkm::Vec<vtkm::Float32, 4>& color,
+                            BytesPortalType& bytes,
+                            const vtkm::Id& index) const
+  {
+    const vtkm::Id x = index % this->Width;
+    const vtkm::Id y = index / this->Width;
+    const vtkm::Id out = ((this->Height - 1 - y) * this->Width + x) * this->Channels;
+    for (vtkm::IdComponent i = 0; i < this->Channels; ++i)
+    {
+      const vtkm::Float32 value = vtkm::Min(1.f, vtkm::Max(0.f, color[i]));
+      bytes.Set(out + i, static_cast<vtkm::UInt8>(value * 255.f));
+    }
+  }
+}; // struct ColorsToBytes
+
+// Converts the depth buffer to 16 bit big endian values with the top row
+// first.
+struct DepthToBytes : public vtkm::worklet::WorkletMapField
+{
+  vtkm::Id Width;
+  vtkm::Id Height;
+
+  VTKM_CONT
+  DepthToBytes(vtkm::Id width, vtkm::Id height)
+    : Width(width)
+    , Height(height)
+  {
+  }
+
+  using ControlSignature = void(FieldIn<>, WholeArrayOut<>);
+  using ExecutionSignature = void(_1, _2, WorkIndex);
+
+  template <typename BytesPortalType>
+  VTKM_EXEC void operator()(const vtkm::Float32& depth,
+                            BytesPortalType& bytes,
+                            const vtkm::Id& index) const
+  {
+    const vtkm::Id x = index % this->Width;
+    const vtkm::Id y = index / this->Width;
+    const vtkm::Id out = ((this->Height - 1 - y) * this->Width + x) * 2;
+    const vtkm::Float32 value = vtkm::Min(1.f, vtkm::Max(0.f, depth));
+    const vtkm::UInt16 quantized = static_cast<vtkm::UInt16>(value * 65535.f + 0.5f);
+    bytes.Set(out, static_cast<vtkm::UInt8>(quantized >> 8));
+    bytes.Set(out + 1, static_cast<vtkm::UInt8>(quantized & 0xFF));
+  }
+}; // struct DepthToBytes
+
+// Copies the depth buffer with the top row first.
+struct FlipDepth : public vtkm::worklet::WorkletMapField
+{
+  vtkm::Id Width;
+  vtkm::Id Height;
+
+  VTKM_CONT
+  FlipDepth(vtkm::Id width, vtkm::Id height)
+    : Width(width)
+    , Height(height)
+  {
+  }
+
+  using ControlSignature = void(FieldIn<>, WholeArrayOut<>);
+  using ExecutionSignature = void(_1, _2, WorkIndex);
+
+  template <typename DepthPortalType>
+  VTKM_EXEC void operator()(const vtkm::Float32& depth,
+                            DepthPortalType& flipped,
+                            const vtkm::Id& index) const
+  {
+    const vtkm::Id x = index % this->Width;
+    const vtkm::Id y = index / this->Width;
+    flipped.Set((this->Height - 1 - y) * this->Width + x, depth);
+  }
+}; // struct FlipDepth
+
+template <typename WorkletType, typename InputType, typename OutputType>
+struct ConvertBufferExecutor
+{
+  WorkletType Worklet;
+  InputType Input;
+  OutputType Output;
+  vtkm::Id OutputSize;
+
+  VTKM_CONT
+  ConvertBufferExecutor(const WorkletType& worklet,
+                        const InputType& input,
+                        const OutputType& output,
+                        vtkm::Id outputSize)
+    : Worklet(worklet)
+    , Input(input)
+    , Output(output)
+    , OutputSize(outputSize)
+  {
+  }
+
+  template <typename Device>
+  VTKM_CONT bool operator()(Device)
+  {
+    VTKM_IS_DEVICE_ADAPTER_TAG(Device);
+
+    this->Output.PrepareForOutput(this->OutputSize, Device());
+    vtkm::worklet::DispatcherMapField<WorkletType, Device> dispatcher(this->Worklet);
+    dispatcher.Invoke(this->Input, this->Output);
+    return true;
+  }
+}; // struct ConvertBufferExecutor
+
+template <typename WorkletType, typename InputType, typename OutputType>
+void ConvertBuffer(const WorkletType& worklet,
+                   const InputType& input,
+                   OutputType& output,
+                   vtkm::Id outputSize)
+{
+  ConvertBufferExecutor<WorkletType, InputType, OutputType> executor(
+    worklet, input, output, outputSize);
+  vtkm::cont::TryExecute(executor);
+}
+
+enum class ImageFileType
+{
+  PPM,
+  PNG,
+  RAW
+};
+
+// An image converted on the device and copied to the host, ready to be
+// encoded and written without touching the canvas again.
+struct ImageFile
+{
+  std::string FileName;
+  ImageFileType Type;
+  vtkm::Id Width;
+  vtkm::Id Height;
+  unsigned int Channels;
+  unsigned int BitDepth;
+  std::vector<unsigned char> Data;
+};
+
+bool HasPNGExtension(const std::string& fileName)
+{
+  if (fileName.size() < 4)
+  {
+    return false;
+  }
+  std::string extension = fileName.substr(fileName.size() - 4);
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+  return extension == ".png";
+}
+
+template <typename T>
+void CopyToHost(const vtkm::cont::ArrayHandle<T>& array, std::vector<unsigned char>& data)
+{
+  auto portal = array.GetPortalConstControl();
+  data.resize(static_cast<std::size_t>(portal.GetNumberOfValues()) * sizeof(T));
+  std::copy(vtkm::cont::ArrayPortalToIteratorBegin(portal),
+            vtkm::cont::ArrayPortalToIteratorEnd(portal),
+            reinterpret_cast<T*>(data.data()));
+}
+
+ImageFile PrepareColorImage(const vtkm::rendering::Canvas& canvas, const std::string& fileName)
+{
+  canvas.RefreshColorBuffer();
+  ImageFile image;
+  image.FileName = fileName;
+  image.Type = HasPNGExtension(fileName) ? ImageFileType::PNG : ImageFileType::PPM;
+  image.Width = canvas.GetWidth();
+  image.Height = canvas.GetHeight();
+  // PPM files only hold RGB, PNG files keep the alpha channel
+  image.Channels = image.Type == ImageFileType::PNG ? 4 : 3;
+  image.BitDepth = 8;
+  vtkm::cont::ArrayHandle<vtkm::UInt8> bytes;
+  canvas.ConvertColorBufferToBytes(bytes, static_cast<vtkm::IdComponent>(image.Channels));
+  CopyToHost(bytes, image.Data);
+  return image;
+}
+
+ImageFile PrepareDepthImage(const vtkm::rendering::Canvas& canvas, const std::string& fileName)
+{
+  canvas.RefreshDepthBuffer();
+  ImageFile image;
+  image.FileName = fileName;
+  image.Type = HasPNGExtension(fileName) ? ImageFileType::PNG : ImageFileType::RAW;
+  image.Width = canvas.GetWidth();
+  image.Height = canvas.GetHeight();
+  image.Channels = 1;
+  const vtkm::Id size = image.Width * image.Height;
+  if (image.Type == ImageFileType::PNG)
+  {
+    image.BitDepth = 16;
+    vtkm::cont::ArrayHandle<vtkm::UInt8> bytes;
+    ConvertBuffer(
+      DepthToBytes(image.Width, image.Height), canvas.GetDepthBuffer(), bytes, size * 2);
+    CopyToHost(bytes, image.Data);
+  }
+  else
+  {
+    image.BitDepth = 32;
+    vtkm::cont::ArrayHandle<vtkm::Float32> flipped;
+    ConvertBuffer(FlipDepth(image.Width, image.Height), canvas.GetDepthBuffer(), flipped, size);
+    CopyToHost(flipped, image.Data);
+  }
+  return image;
+}
+
+void WriteImageFile(const ImageFile& image)
+{
+  std::ofstream of(image.FileName.c_str(), std::ios_base::binary | std::ios_base::out);
+  if (!of)
+  {
+    throw vtkm::cont::ErrorBadValue("Canvas: could not open " + image.FileName + " for writing.");
+  }
+  if (image.Type == ImageFileType::PNG)
+  {
+    std::vector<unsigned char> png;
+    int error = vtkm::rendering::EncodePNG(png,
+                                           image.Data.data(),
+                                           static_cast<unsigned long>(image.Width),
+                                           static_cast<unsigned long>(image.Height),
+                                           image.Channels,
+                                           image.BitDepth);
+    if (error != 0)
+    {
+      throw vtkm::cont::ErrorBadValue("Canvas: could not encode " + image.FileName + " as PNG.");
+    }
+    of.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+  }
+  else
+  {
+    if (image.Type == ImageFileType::PPM)
+    {
+      of << "P6" << std::endl << image.Width << " " << image.Height << std::endl;
+      of << 255 << std::endl;
+    }
+    of.write(reinterpret_cast<const char*>(image.Data.data()),
+             static_cast<std::streamsize>(image.Data.size()));
+  }
+  of.close();
+}
+
 struct DrawColorSwatch : public vtkm::worklet::WorkletMapField
 {
   using ControlSignature = void(FieldIn<>, WholeArrayInOut<>);
@@ -332,6 +597,47 @@ struct ColorBarExecutor
   const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& ColorBuffer;
 }; // struct ColorSwatchExecutor
 
+struct FontAtlas
+{
+  vtkm::rendering::BitmapFont Font;
+  std::vector<unsigned char> Alpha;
+  vtkm::Id Width = 0;
+  vtkm::Id Height = 0;
+  bool Valid = false;
+};
+
+FontAtlas LoadFontAtlas()
+{
+  FontAtlas atlas;
+  atlas.Font = BitmapFontFactory::CreateLiberation2Sans();
+  const std::vector<unsigned char>& rawPNG = atlas.Font.GetRawImageData();
+  std::vector<unsigned char> rgba;
+  unsigned long textureWidth, textureHeight;
+  int error = DecodePNG(rgba, textureWidth, textureHeight, &rawPNG[0], rawPNG.size());
+  if (error != 0)
+  {
+    return atlas;
+  }
+  std::size_t numValues = textureWidth * textureHeight;
+  atlas.Alpha.resize(numValues);
+  for (std::size_t i = 0; i < numValues; ++i)
+  {
+    atlas.Alpha[i] = rgba[i * 4 + 3];
+  }
+  atlas.Width = static_cast<vtkm::Id>(textureWidth);
+  atlas.Height = static_cast<vtkm::Id>(textureHeight);
+  atlas.Valid = true;
+  return atlas;
+}
+
+// Decoding the font image costs far more than drawing a few labels, so it is
+// done once and the glyph atlas is shared by all canvases.
+const FontAtlas& GetFontAtlas()
+{
+  static const FontAtlas atlas = LoadFontAtlas();
+  return atlas;
+}
+
 } // namespace internal
 
 struct Canvas::CanvasInternals
@@ -340,6 +646,7 @@ struct Canvas::CanvasInternals
   CanvasInternals(vtkm::Id width, vtkm::Id height)
     : Width(width)
     , Height(height)
+    , BatchAnnotations(false)
   {
     BackgroundColor.Components[0] = 0.f;
     BackgroundColor.Components[1] = 0.f;
@@ -362,6 +669,8 @@ struct Canvas::CanvasInternals
   FontTextureType FontTexture;
   vtkm::Matrix<vtkm::Float32, 4, 4> ModelView;
   vtkm::Matrix<vtkm::Float32, 4, 4> Projection;
+  vtkm::rendering::internal::AnnotationBatch Annotations;
+  bool BatchAnnotations;
 };
 
 Canvas::Canvas(vtkm::Id width, vtkm::Id height)
@@ -448,6 +757,7 @@ void Canvas::Clear()
 
 void Canvas::Finish()
 {
+  this->EndAnnotations();
 }
 
 void Canvas::BlendBackground()
@@ -490,6 +800,8 @@ void Canvas::AddColorSwatch(const vtkm::Vec<vtkm::Float64, 2>& point0,
   y[0] = static_cast<vtkm::Id>(((point0[1] + 1.) / 2.) * height + .5);
   y[1] = static_cast<vtkm::Id>(((point2[1] + 1.) / 2.) * height + .5);
 
+  // The swatch covers whatever was added before it.
+  this->FlushAnnotations();
   vtkm::Id2 dims(this->GetWidth(), this->GetHeight());
   vtkm::cont::TryExecute(
     internal::ColorSwatchExecutor(dims, x, y, color.Components, this->GetColorBuffer()));
@@ -551,6 +863,8 @@ void Canvas::AddColorBar(const vtkm::Bounds& bounds,
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::UInt8, 4>> colorMap;
   colorTable.Sample(static_cast<vtkm::Int32>(numSamples), colorMap);
 
+  // The bar covers whatever was added before it.
+  this->FlushAnnotations();
   vtkm::Id2 dims(this->GetWidth(), this->GetHeight());
   vtkm::cont::TryExecute(
     internal::ColorBarExecutor(dims, x, y, horizontal, colorMap, this->GetColorBuffer()));
@@ -645,24 +959,14 @@ void Canvas::AddText(vtkm::Float32 x,
 
 bool Canvas::LoadFont() const
 {
-  Internals->Font = BitmapFontFactory::CreateLiberation2Sans();
-  const std::vector<unsigned char>& rawPNG = Internals->Font.GetRawImageData();
-  std::vector<unsigned char> rgba;
-  unsigned long textureWidth, textureHeight;
-  int error = DecodePNG(rgba, textureWidth, textureHeight, &rawPNG[0], rawPNG.size());
-  if (error != 0)
+  const internal::FontAtlas& atlas = internal::GetFontAtlas();
+  if (!atlas.Valid)
   {
     return false;
   }
-  std::size_t numValues = textureWidth * textureHeight;
-  std::vector<unsigned char> alpha(numValues);
-  for (std::size_t i = 0; i < numValues; ++i)
-  {
-    alpha[i] = rgba[i * 4 + 3];
-  }
-  vtkm::cont::ArrayHandle<vtkm::UInt8> textureHandle = vtkm::cont::make_ArrayHandle(alpha);
-  Internals->FontTexture =
-    FontTextureType(vtkm::Id(textureWidth), vtkm::Id(textureHeight), textureHandle);
+  Internals->Font = atlas.Font;
+  vtkm::cont::ArrayHandle<vtkm::UInt8> textureHandle = vtkm::cont::make_ArrayHandle(atlas.Alpha);
+  Internals->FontTexture = FontTextureType(atlas.Width, atlas.Height, textureHandle);
   Internals->FontTexture.SetFilterMode(TextureFilterMode::Linear);
   Internals->FontTexture.SetWrapMode(TextureWrapMode::Clamp);
   return true;
@@ -692,30 +996,69 @@ void Canvas::SetViewToScreenSpace(const vtkm::rendering::Camera& vtkmNotUsed(cam
   Internals->Projection[2][2] = -1.0f;
 }
 
-void Canvas::SaveAs(const std::string& fileName) const
+void Canvas::ConvertColorBufferToBytes(vtkm::cont::ArrayHandle<vtkm::UInt8>& bytes,
+                                       vtkm::IdComponent channels) const
 {
-  this->RefreshColorBuffer();
-  std::ofstream of(fileName.c_str(), std::ios_base::binary | std::ios_base::out);
-  vtkm::Id width = GetWidth();
-  vtkm::Id height = GetHeight();
-  of << "P6" << std::endl << width << " " << height << std::endl << 255 << std::endl;
-  ColorBufferType::PortalConstControl colorPortal = GetColorBuffer().GetPortalConstControl();
-  for (vtkm::Id yIndex = height - 1; yIndex >= 0; yIndex--)
+  if (channels < 1 || channels > 4)
   {
-    for (vtkm::Id xIndex = 0; xIndex < width; xIndex++)
-    {
-      vtkm::Vec<vtkm::Float32, 4> tuple = colorPortal.Get(yIndex * width + xIndex);
-      of << (unsigned char)(tuple[0] * 255);
-      of << (unsigned char)(tuple[1] * 255);
-      of << (unsigned char)(tuple[2] * 255);
-    }
+    throw vtkm::cont::ErrorBadValue("Canvas: colors can only be converted to 1 to 4 channels.");
   }
-  of.close();
+  const vtkm::Id size = this->GetWidth() * this->GetHeight() * channels;
+  internal::ConvertBuffer(internal::ColorsToBytes(this->GetWidth(), this->GetHeight(), channels),
+                          this->GetColorBuffer(),
+                          bytes,
+                          size);
+}
+
+void Canvas::SaveAs(const std::string& fileName) const
+{
+  internal::WriteImageFile(internal::PrepareColorImage(*this, fileName));
+}
+
+std::future<void> Canvas::SaveAsAsync(const std::string& fileName) const
+{
+  return std::async(
+    std::launch::async, internal::WriteImageFile, internal::PrepareColorImage(*this, fileName));
+}
+
+void Canvas::SaveDepthAs(const std::string& fileName) const
+{
+  internal::WriteImageFile(internal::PrepareDepthImage(*this, fileName));
+}
+
+std::future<void> Canvas::SaveDepthAsAsync(const std::string& fileName) const
+{
+  return std::async(
+    std::launch::async, internal::WriteImageFile, internal::PrepareDepthImage(*this, fileName));
 }
 
 vtkm::rendering::WorldAnnotator* Canvas::CreateWorldAnnotator() const
 {
   return new vtkm::rendering::WorldAnnotator(this);
 }
+
+void Canvas::BeginAnnotations()
+{
+  Internals->BatchAnnotations = true;
+}
+
+void Canvas::EndAnnotations()
+{
+  Internals->BatchAnnotations = false;
+  this->FlushAnnotations();
+}
+
+void Canvas::FlushAnnotations() const
+{
+  if (!Internals->Annotations.IsEmpty())
+  {
+    Internals->Annotations.Render(*this, Internals->FontTexture);
+  }
+}
+
+vtkm::rendering::internal::AnnotationBatch* Canvas::GetAnnotationBatch() const
+{
+  return Internals->BatchAnnotations ? &Internals->Annotations : nullptr;
+}
 }
 } // vtkm::rendering
@@ -31,6 +31,8 @@
 #include <vtkm/rendering/Color.h>
 #include <vtkm/rendering/Texture2D.h>
 
+#include <future>
+
 #define VTKM_DEFAULT_CANVAS_DEPTH 1.001f
 
 namespace vtkm
@@ -40,6 +42,11 @@ namespace rendering
 
 class WorldAnnotator;
 
+namespace internal
+{
+class AnnotationBatch;
+}
+
 class VTKM_RENDERING_EXPORT Canvas
 {
 public:
@@ -110,8 +117,31 @@ public:
   virtual void SetViewToScreenSpace(const vtkm::rendering::Camera& camera, bool clip);
   virtual void SetViewportClipping(const vtkm::rendering::Camera&, bool) {}
 
+  /// Saves the color buffer. Files ending in .png are written as RGBA PNG
+  /// files, all other files as binary PPM.
   virtual void SaveAs(const std::string& fileName) const;
 
+  /// Same as SaveAs, except that only the conversion of the color buffer
+  /// happens on the calling thread. Encoding and writing the file happen on
+  /// another thread, so rendering can continue while the file is written.
+  /// Errors are rethrown by the get method of the returned future.
+  std::future<void> SaveAsAsync(const std::string& fileName) const;
+
+  /// Saves the depth buffer. Files ending in .png are written as 16 bit
+  /// gray PNG files. All other files receive the raw 32 bit float values in
+  /// native byte order, top row first.
+  void SaveDepthAs(const std::string& fileName) const;
+
+  /// Asynchronous version of SaveDepthAs. See SaveAsAsync.
+  std::future<void> SaveDepthAsAsync(const std::string& fileName) const;
+
+  /// Converts the color buffer to 8 bits per channel in parallel. The output
+  /// holds the first \c channels components of each pixel, with the top row
+  /// of the image first.
+  VTKM_CONT
+  void ConvertColorBufferToBytes(vtkm::cont::ArrayHandle<vtkm::UInt8>& bytes,
+                                 vtkm::IdComponent channels = 4) const;
+
   /// Creates a WorldAnnotator of a type that is paired with this Canvas. Other
   /// types of world annotators might work, but this provides a default.
   ///
@@ -121,6 +151,24 @@ public:
   ///
   virtual vtkm::rendering::WorldAnnotator* CreateWorldAnnotator() const;
 
+  /// Starts collecting annotations. Until EndAnnotations is called, the lines
+  /// and text added with AddLine, AddText or a WorldAnnotator are only
+  /// recorded, and EndAnnotations then rasterizes all of them in a few
+  /// parallel passes. The result is the same as drawing them one after the
+  /// other in the order they were added. Color swatches and color bars draw
+  /// the pending annotations before themselves. Outside of such a block every
+  /// line and string is drawn as soon as it is added. The transformations are
+  /// applied when an annotation is added, so the view may change in between.
+  ///
+  VTKM_CONT
+  void BeginAnnotations();
+
+  /// Draws the annotations collected since BeginAnnotations. Finish calls
+  /// this as well.
+  ///
+  VTKM_CONT
+  void EndAnnotations();
+
   VTKM_CONT
   virtual void AddColorSwatch(const vtkm::Vec<vtkm::Float64, 2>& point0,
                               const vtkm::Vec<vtkm::Float64, 2>& point1,
@@ -197,6 +245,7 @@ public:
   friend class AxisAnnotation2D;
   friend class ColorBarAnnotation;
   friend class ColorLegendAnnotation;
+  friend class LineRenderer;
   friend class TextAnnotationScreen;
   friend class TextRenderer;
   friend class WorldAnnotator;
@@ -208,6 +257,13 @@ private:
 
   const vtkm::Matrix<vtkm::Float32, 4, 4>& GetProjection() const;
 
+  // Returns the batch collecting annotations, or nullptr if annotations are
+  // currently drawn right away.
+  vtkm::rendering::internal::AnnotationBatch* GetAnnotationBatch() const;
+
+  // Draws the collected annotations without ending the batch.
+  void FlushAnnotations() const;
+
   struct CanvasInternals;
   std::shared_ptr<CanvasInternals> Internals;
 };
@@ -0,0 +1,472 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/rendering/Compositor.h>
+
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Timer.h>
+#include <vtkm/cont/serial/DeviceAdapterSerial.h>
+#include <vtkm/rendering/raytracing/Logger.h>
+
+// clang-format off
+VTKM_THIRDPARTY_PRE_INCLUDE
+#include <vtkm/thirdparty/diy/Configure.h>
+#include VTKM_DIY(diy/decomposition.hpp)
+#include VTKM_DIY(diy/master.hpp)
+#include VTKM_DIY(diy/partners/swap.hpp)
+#include VTKM_DIY(diy/reduce.hpp)
+#include VTKM_DIY(diy/serialization.hpp)
+VTKM_THIRDPARTY_POST_INCLUDE
+// clang-format on
+
+#include <algorithm>
+#include <vector>
+
+namespace vtkm
+{
+namespace rendering
+{
+namespace
+{
+
+// A contiguous range [Begin, End) of the pixels of an image.
+struct ImagePiece
+{
+  vtkm::Id Begin = 0;
+  vtkm::Id End = 0;
+  std::vector<vtkm::Vec<vtkm::Float32, 4>> Colors;
+  std::vector<vtkm::Float32> Depths;
+
+  // Splits the piece in `count` contiguous parts of (almost) equal size.
+  void Split(int count, std::vector<ImagePiece>& parts) const
+  {
+    parts.resize(static_cast<std::size_t>(count));
+    const vtkm::Id size = this->End - this->Begin;
+    for (int i = 0; i < count; ++i)
+    {
+      ImagePiece& part = parts[static_cast<std::size_t>(i)];
+      part.Begin = this->Begin + (size * i) / count;
+      part.End = this->Begin + (size * (i + 1)) / count;
+      const auto first = static_cast<std::size_t>(part.Begin - this->Begin);
+      const auto last = static_cast<std::size_t>(part.End - this->Begin);
+      part.Colors.assign(this->Colors.begin() + first, this->Colors.begin() + last);
+      part.Depths.assign(this->Depths.begin() + first, this->Depths.begin() + last);
+    }
+  }
+
+  // Composites `back`, which covers the same pixels and lies behind this
+  // piece, into this piece.
+  void CompositeBehind(const ImagePiece& back, Compositor::CompositeMode mode)
+  {
+    for (std::size_t i = 0; i < this->Depths.size(); ++i)
+    {
+      if (mode == Compositor::DEPTH_TEST)
+      {
+        // Ties go to the front image so the result does not depend on the
+        // order of the rounds.
+        if (back.Depths[i] < this->Depths[i])
+        {
+          this->Colors[i] = back.Colors[i];
+          this->Depths[i] = back.Depths[i];
+        }
+      }
+      else
+      {
+        vtkm::Vec<vtkm::Float32, 4>& front = this->Colors[i];
+        const vtkm::Float32 transmission = 1.f - front[3];
+        front[0] += back.Colors[i][0] * transmission;
+        front[1] += back.Colors[i][1] * transmission;
+        front[2] += back.Colors[i][2] * transmission;
+        front[3] += back.Colors[i][3] * transmission;
+        this->Depths[i] = vtkm::Min(this->Depths[i], back.Depths[i]);
+      }
+    }
+  }
+};
+
+struct ImageBlock
+{
+  ImagePiece Image;
+};
+
+// Assigns the image blocks (one gid per visibility order) to their ranks.
+class ImageAssigner : public diy::StaticAssigner
+{
+public:
+  ImageAssigner(int size, const std::vector<int>& ranks)
+    : diy::StaticAssigner(size, static_cast<int>(ranks.size()))
+    , Ranks(ranks)
+  {
+  }
+
+  void local_gids(int rank, std::vector<int>& gids) const override
+  {
+    gids.clear();
+    for (std::size_t gid = 0; gid < this->Ranks.size(); ++gid)
+    {
+      if (this->Ranks[gid] == rank)
+      {
+        gids.push_back(static_cast<int>(gid));
+      }
+    }
+  }
+
+  int rank(int gid) const override { return this->Ranks[static_cast<std::size_t>(gid)]; }
+
+private:
+  std::vector<int> Ranks;
+};
+
+} // anonymous namespace
+}
+} // namespace vtkm::rendering
+
+namespace diy
+{
+template <>
+struct Serialization<vtkm::rendering::ImagePiece>
+{
+  static void save(BinaryBuffer& bb, const vtkm::rendering::ImagePiece& piece)
+  {
+    diy::save(bb, piece.Begin);
+    diy::save(bb, piece.End);
+    diy::save(bb, piece.Colors);
+    diy::save(bb, piece.Depths);
+  }
+
+  static void load(BinaryBuffer& bb, vtkm::rendering::ImagePiece& piece)
+  {
+    diy::load(bb, piece.Begin);
+    diy::load(bb, piece.End);
+    diy::load(bb, piece.Colors);
+    diy::load(bb, piece.Depths);
+  }
+};
+} // namespace diy
+
+namespace vtkm
+{
+namespace rendering
+{
+
+struct Compositor::InternalsType
+{
+  struct LocalImage
+  {
+    vtkm::Id Width;
+    vtkm::Id Height;
+    vtkm::Id VisibilityOrder;
+    ImagePiece Pixels;
+  };
+
+  CompositeMode Mode = DEPTH_TEST;
+  CompositeAlgorithm Algorithm = RADIX_K;
+  vtkm::IdComponent RadixK = 8;
+  std::vector<LocalImage> Images;
+};
+
+Compositor::Compositor()
+  : Internals(new InternalsType)
+{
+}
+
+Compositor::~Compositor()
+{
+}
+
+void Compositor::SetCompositeMode(CompositeMode mode)
+{
+  this->Internals->Mode = mode;
+}
+
+Compositor::CompositeMode Compositor::GetCompositeMode() const
+{
+  return this->Internals->Mode;
+}
+
+void Compositor::SetAlgorithm(CompositeAlgorithm algorithm)
+{
+  this->Internals->Algorithm = algorithm;
+}
+
+Compositor::CompositeAlgorithm Compositor::GetAlgorithm() const
+{
+  return this->Internals->Algorithm;
+}
+
+void Compositor::SetRadixK(vtkm::IdComponent k)
+{
+  if (k < 2)
+  {
+    throw vtkm::cont::ErrorBadValue("Radix-k compositing needs k >= 2.");
+  }
+  this->Internals->RadixK = k;
+}
+
+vtkm::IdComponent Compositor::GetRadixK() const
+{
+  return this->Internals->RadixK;
+}
+
+void Compositor::AddCanvas(const vtkm::rendering::Canvas& canvas, vtkm::Id visibilityOrder)
+{
+  InternalsType::LocalImage image;
+  image.Width = canvas.GetWidth();
+  image.Height = canvas.GetHeight();
+  image.VisibilityOrder = visibilityOrder;
+
+  const vtkm::Id numPixels = image.Width * image.Height;
+  auto colors = canvas.GetColorBuffer().GetPortalConstControl();
+  auto depths = canvas.GetDepthBuffer().GetPortalConstControl();
+  image.Pixels.Begin = 0;
+  image.Pixels.End = numPixels;
+  image.Pixels.Colors.resize(static_cast<std::size_t>(numPixels));
+  image.Pixels.Depths.resize(static_cast<std::size_t>(numPixels));
+  for (vtkm::Id i = 0; i < numPixels; ++i)
+  {
+    image.Pixels.Colors[static_cast<std::size_t>(i)] = colors.Get(i);
+    image.Pixels.Depths[static_cast<std::size_t>(i)] = depths.Get(i);
+  }
+  this->Internals->Images.push_back(image);
+}
+
+vtkm::Id Compositor::GetNumberOfCanvases() const
+{
+  return static_cast<vtkm::Id>(this->Internals->Images.size());
+}
+
+void Compositor::ClearCanvases()
+{
+  this->Internals->Images.clear();
+}
+
+bool Compositor::Composite(vtkm::rendering::Canvas& result)
+{
+  using Timer = vtkm::cont::Timer<vtkm::cont::DeviceAdapterTagSerial>;
+  raytracing::Logger* logger = raytracing::Logger::GetInstance();
+  logger->OpenLogEntry("compositor");
+  Timer totalTimer;
+  Timer timer;
+
+  diy::mpi::communicator comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  const std::vector<InternalsType::LocalImage>& images = this->Internals->Images;
+  const CompositeMode mode = this->Internals->Mode;
+
+  // Gather the size and the visibility order of the images of every rank.
+  // The first entry of each message is the image size, which also keeps the
+  // messages non-empty.
+  std::vector<vtkm::Id> localInfo;
+  localInfo.push_back(images.empty() ? -1 : images[0].Width);
+  localInfo.push_back(images.empty() ? -1 : images[0].Height);
+  for (const auto& image : images)
+  {
+    if (image.Width != images[0].Width || image.Height != images[0].Height)
+    {
+      throw vtkm::cont::ErrorBadValue("All composited canvases must have the same size.");
+    }
+    localInfo.push_back(image.VisibilityOrder);
+  }
+  std::vector<std::vector<vtkm::Id>> allInfo;
+  diy::mpi::all_gather(comm, localInfo, allInfo);
+
+  vtkm::Id width = -1;
+  vtkm::Id height = -1;
+  std::vector<int> gidRanks;
+  std::vector<int> localGids;
+  for (int rank = 0; rank < comm.size(); ++rank)
+  {
+    const std::vector<vtkm::Id>& info = allInfo[static_cast<std::size_t>(rank)];
+    if (info.size() == 2)
+    {
+      continue;
+    }
+    if (width >= 0 && (info[0] != width || info[1] != height))
+    {
+      throw vtkm::cont::ErrorBadValue("All composited canvases must have the same size.");
+    }
+    width = info[0];
+    height = info[1];
+    for (std::size_t i = 2; i < info.size(); ++i)
+    {
+      // In depth test mode the images are numbered in rank order.
+      const vtkm::Id gid =
+        (mode == DEPTH_TEST) ? static_cast<vtkm::Id>(gidRanks.size()) : info[i];
+      if (gid < 0)
+      {
+        throw vtkm::cont::ErrorBadValue("Alpha blending needs the visibility order of all images.");
+      }
+      if (rank == comm.rank())
+      {
+        localGids.push_back(static_cast<int>(gid));
+      }
+      gidRanks.push_back(static_cast<int>(gid));
+    }
+  }
+
+  const int numBlocks = static_cast<int>(gidRanks.size());
+  if (numBlocks == 0)
+  {
+    logger->CloseLogEntry(totalTimer.GetElapsedTime());
+    return false;
+  }
+
+  // gidRanks currently lists the gids in rank order, invert it.
+  std::vector<int> ranks(static_cast<std::size_t>(numBlocks), -1);
+  {
+    std::size_t index = 0;
+    for (int rank = 0; rank < comm.size(); ++rank)
+    {
+      const std::size_t count = allInfo[static_cast<std::size_t>(rank)].size() - 2;
+      for (std::size_t i = 0; i < count; ++i, ++index)
+      {
+        const int gid = gidRanks[index];
+        if (gid >= numBlocks || ranks[static_cast<std::size_t>(gid)] != -1)
+        {
+          throw vtkm::cont::ErrorBadValue("Visibility orders must be unique and less than the "
+                                          "number of images.");
+        }
+        ranks[static_cast<std::size_t>(gid)] = rank;
+      }
+    }
+  }
+  ImageAssigner assigner(comm.size(), ranks);
+
+  diy::Master master(comm,
+                     1,
+                     -1,
+                     []() -> void* { return new ImageBlock(); },
+                     [](void* ptr) { delete static_cast<ImageBlock*>(ptr); });
+  for (std::size_t i = 0; i < images.size(); ++i)
+  {
+    ImageBlock* block = new ImageBlock();
+    block->Image = images[i].Pixels;
+    master.add(localGids[i], block, new diy::Link);
+  }
+
+  diy::RegularDecomposer<diy::DiscreteBounds> decomposer(
+    /*dim*/ 1, diy::interval(0, numBlocks - 1), numBlocks);
+  // Contiguous groups keep every intermediate image a contiguous range of
+  // the visibility order, which the "over" operator requires.
+  const int k = (this->Internals->Algorithm == BINARY_SWAP) ? 2 : this->Internals->RadixK;
+  diy::RegularSwapPartners partners(decomposer, k, /*contiguous*/ true);
+
+  logger->AddLogData("images", numBlocks);
+  logger->AddLogData("rounds", partners.rounds());
+  logger->AddLogData("setup", timer.GetElapsedTime());
+  timer.Reset();
+
+  auto callback =
+    [mode](ImageBlock* block, const diy::ReduceProxy& proxy, const diy::RegularSwapPartners&) {
+      // 1. composite the parts received for the pixels this block now owns.
+      // The partners are listed by gid, i.e. front to back.
+      if (proxy.in_link().size() > 0)
+      {
+        ImagePiece composite;
+        bool first = true;
+        for (int i = 0; i < proxy.in_link().size(); ++i)
+        {
+          const int gid = proxy.in_link().target(i).gid;
+          ImagePiece incoming;
+          if (gid == proxy.gid())
+          {
+            incoming = std::move(block->Image);
+          }
+          else
+          {
+            proxy.dequeue(gid, incoming);
+          }
+          if (first)
+          {
+            composite = std::move(incoming);
+            first = false;
+          }
+          else
+          {
+            composite.CompositeBehind(incoming, mode);
+          }
+        }
+        block->Image = std::move(composite);
+      }
+
+      // 2. split the pixels among the partners of the next round.
+      if (proxy.out_link().size() > 0)
+      {
+        std::vector<ImagePiece> parts;
+        block->Image.Split(proxy.out_link().size(), parts);
+        for (int i = 0; i < proxy.out_link().size(); ++i)
+        {
+          const diy::BlockID target = proxy.out_link().target(i);
+          if (target.gid == proxy.gid())
+          {
+            block->Image = std::move(parts[static_cast<std::size_t>(i)]);
+          }
+          else
+          {
+            proxy.enqueue(target, parts[static_cast<std::size_t>(i)]);
+          }
+        }
+      }
+    };
+  diy::reduce(master, assigner, partners, callback);
+
+  logger->AddLogData("swap", timer.GetElapsedTime());
+  timer.Reset();
+
+  // Collect the pieces on the block of the front-most image.
+  const diy::BlockID root{ 0, assigner.rank(0) };
+  master.foreach ([&](ImageBlock* block, const diy::Master::ProxyWithLink& cp) {
+    cp.enqueue(root, block->Image);
+  });
+  master.exchange(/*remote*/ true);
+
+  bool hasResult = false;
+  master.foreach ([&](ImageBlock*, const diy::Master::ProxyWithLink& cp) {
+    if (cp.gid() != 0)
+    {
+      return;
+    }
+    hasResult = true;
+    result.ResizeBuffers(width, height);
+    auto colors = result.GetColorBuffer().GetPortalControl();
+    auto depths = result.GetDepthBuffer().GetPortalControl();
+    std::vector<int> incoming;
+    cp.incoming(incoming);
+    for (const int gid : incoming)
+    {
+      while (cp.incoming(gid))
+      {
+        ImagePiece piece;
+        cp.dequeue(gid, piece);
+        for (vtkm::Id i = piece.Begin; i < piece.End; ++i)
+        {
+          colors.Set(i, piece.Colors[static_cast<std::size_t>(i - piece.Begin)]);
+          depths.Set(i, piece.Depths[static_cast<std::size_t>(i - piece.Begin)]);
+        }
+      }
+    }
+  });
+
+  logger->AddLogData("collect", timer.GetElapsedTime());
+  logger->CloseLogEntry(totalTimer.GetElapsedTime());
+  return hasResult;
+}
+}
+} // namespace vtkm::rendering
@@ -0,0 +1,102 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_rendering_Compositor_h
+#define vtk_m_rendering_Compositor_h
+
+#include <vtkm/rendering/vtkm_rendering_export.h>
+
+#include <vtkm/rendering/Canvas.h>
+
+#include <memory>
+
+namespace vtkm
+{
+namespace rendering
+{
+
+/// \brief Sort-last image compositing across ranks.
+///
+/// Every rank adds the canvases it rendered locally (any number, including
+/// none) and then all ranks call \c Composite. The images are combined with
+/// a radix-k swap over the communicator of \c vtkm::cont::EnvironmentTracker.
+/// Each image is a block, so several images per rank are composited exactly
+/// as if they were on different ranks. Binary-swap is radix-k with k = 2.
+///
+/// In \c DEPTH_TEST mode the closest fragment of every pixel is kept. In
+/// \c ALPHA_BLEND mode the images are blended front to back in visibility
+/// order with the "over" operator, which expects premultiplied colors (as
+/// produced by the ray tracers before \c Canvas::BlendBackground). Each image
+/// then needs a unique visibility order in [0, number of images), where 0
+/// is the front-most image.
+///
+/// The time spent in each stage is recorded in the ray tracing \c Logger
+/// under the "compositor" entry.
+///
+class VTKM_RENDERING_EXPORT Compositor
+{
+public:
+  enum CompositeMode
+  {
+    DEPTH_TEST,
+    ALPHA_BLEND
+  };
+
+  enum CompositeAlgorithm
+  {
+    BINARY_SWAP,
+    RADIX_K
+  };
+
+  Compositor();
+  ~Compositor();
+
+  void SetCompositeMode(CompositeMode mode);
+  CompositeMode GetCompositeMode() const;
+
+  void SetAlgorithm(CompositeAlgorithm algorithm);
+  CompositeAlgorithm GetAlgorithm() const;
+
+  /// Target group size of the radix-k rounds. Only used by \c RADIX_K.
+  /// The default is 8.
+  void SetRadixK(vtkm::IdComponent k);
+  vtkm::IdComponent GetRadixK() const;
+
+  /// Add a locally rendered image. \c visibilityOrder is only used, and
+  /// required, in \c ALPHA_BLEND mode.
+  void AddCanvas(const vtkm::rendering::Canvas& canvas, vtkm::Id visibilityOrder = -1);
+
+  vtkm::Id GetNumberOfCanvases() const;
+
+  void ClearCanvases();
+
+  /// Composite the images added on all ranks. This is a collective call.
+  /// The final image is written into \c result on the rank that added the
+  /// front-most image (the first image of the lowest rank in \c DEPTH_TEST
+  /// mode), which is the only rank where this returns true.
+  bool Composite(vtkm::rendering::Canvas& result);
+
+private:
+  struct InternalsType;
+  std::shared_ptr<InternalsType> Internals;
+};
+}
+} //namespace vtkm::rendering
+
+#endif //vtk_m_rendering_Compositor_h
@@ -71,6 +71,17 @@ protected:
     }
   };
 
+  vtkm::Float32 SampleDistance;
+
+  VTKM_CONT
+  bool IsSameMesh(const vtkm::cont::DynamicCellSet& cellset,
+                  const vtkm::cont::CoordinateSystem& coords) const
+  {
+    using Helper = vtkm::cont::detail::DynamicCellSetCopyHelper;
+    return Helper::GetCellSetContainer(cellset) == Helper::GetCellSetContainer(Cells) &&
+      coords.GetData() == Coords.GetData();
+  }
+
 public:
   InternalsType(vtkm::cont::DataSet& dataSet)
   {
@@ -79,6 +90,7 @@ public:
     Coords = dataSet.GetCoordinateSystem();
     Mode = VOLUME_MODE;
     CompositeBackground = true;
+    SampleDistance = -1.f;
     //
     // Just grab a default scalar field
     //
@@ -93,6 +105,37 @@ public:
 
   ~InternalsType() { delete Tracer; }
 
+  VTKM_CONT
+  void SetData(const vtkm::cont::DynamicCellSet& cellset,
+               const vtkm::cont::CoordinateSystem& coords,
+               const vtkm::cont::Field& scalarField)
+  {
+    // The tracer owns the mesh connectivity and the boundary BVH, so it is only
+    // replaced when the mesh itself changes.
+    if (!this->IsSameMesh(cellset, coords))
+    {
+      BaseType* tracer = raytracing::ConnectivityTracerFactory::CreateTracer(cellset, coords);
+      delete Tracer;
+      Tracer = tracer;
+      if (SampleDistance > 0.f)
+      {
+        Tracer->SetSampleDistance(SampleDistance);
+      }
+      if (ColorMap.GetNumberOfValues() > 0)
+      {
+        Tracer->SetColorMap(ColorMap);
+      }
+      Cells = cellset;
+      Coords = coords;
+    }
+
+    Dataset = vtkm::cont::DataSet();
+    Dataset.AddCellSet(cellset);
+    Dataset.AddCoordinateSystem(coords);
+    Dataset.AddField(scalarField);
+    this->SetScalarField(scalarField.GetName());
+  }
+
   void SetSampleDistance(const vtkm::Float32& distance)
   {
     if (Mode != VOLUME_MODE)
@@ -101,6 +144,7 @@ public:
       return;
     }
     Tracer->SetSampleDistance(distance);
+    SampleDistance = distance;
   }
 
   VTKM_CONT
@@ -121,6 +165,7 @@ public:
   void SetColorMap(vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& colormap)
   {
     Tracer->SetColorMap(colormap);
+    ColorMap = colormap;
   }
 
   VTKM_CONT
@@ -247,6 +292,14 @@ ConnectivityProxy::ConnectivityProxy()
 {
 }
 
+VTKM_CONT
+void ConnectivityProxy::SetData(const vtkm::cont::DynamicCellSet& cellset,
+                                const vtkm::cont::CoordinateSystem& coords,
+                                const vtkm::cont::Field& scalarField)
+{
+  Internals->SetData(cellset, coords, scalarField);
+}
+
 VTKM_CONT
 void ConnectivityProxy::SetSampleDistance(const vtkm::Float32& distance)
 {
@@ -47,6 +47,13 @@ public:
     ENERGY_MODE
   };
 
+  /// Replaces the data to render. The mesh connectivity, face-to-cell maps and
+  /// boundary BVH are kept when the cell set and coordinates are the same as
+  /// before, so changing only the scalar field re-runs just the tracing.
+  void SetData(const vtkm::cont::DynamicCellSet& cellset,
+               const vtkm::cont::CoordinateSystem& coords,
+               const vtkm::cont::Field& scalarField);
+
   void SetRenderMode(RenderMode mode);
   void SetSampleDistance(const vtkm::Float32&);
   void SetCanvas(vtkm::rendering::Canvas* canvas);
@@ -0,0 +1,442 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2016 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2016 UT-Battelle, LLC.
+//  Copyright 2016 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//
+//=============================================================================
+
+#include <vtkm/rendering/EncodePNG.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace vtkm
+{
+namespace rendering
+{
+namespace
+{
+
+// ----------------------------------------------------------------------------
+// Check sums
+
+struct CrcTable
+{
+  unsigned long Values[256];
+
+  CrcTable()
+  {
+    for (unsigned long n = 0; n < 256; ++n)
+    {
+      unsigned long c = n;
+      for (int k = 0; k < 8; ++k)
+      {
+        c = (c & 1) ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+      }
+      this->Values[n] = c;
+    }
+  }
+};
+
+unsigned long Crc32(const unsigned char* data, std::size_t size)
+{
+  // images may be encoded from several threads at once
+  static const CrcTable table;
+  unsigned long crc = 0xFFFFFFFFUL;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    crc = table.Values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFUL;
+}
+
+unsigned long Adler32(const unsigned char* data, std::size_t size)
+{
+  unsigned long s1 = 1;
+  unsigned long s2 = 0;
+  while (size > 0)
+  {
+    // 5550 is the largest run that cannot overflow 32 bit sums
+    std::size_t run = std::min<std::size_t>(size, 5550);
+    size -= run;
+    for (std::size_t i = 0; i < run; ++i)
+    {
+      s1 += data[i];
+      s2 += s1;
+    }
+    data += run;
+    s1 %= 65521;
+    s2 %= 65521;
+  }
+  return (s2 << 16) | s1;
+}
+
+void AppendUInt32(std::vector<unsigned char>& out, unsigned long value)
+{
+  out.push_back(static_cast<unsigned char>((value >> 24) & 0xFF));
+  out.push_back(static_cast<unsigned char>((value >> 16) & 0xFF));
+  out.push_back(static_cast<unsigned char>((value >> 8) & 0xFF));
+  out.push_back(static_cast<unsigned char>(value & 0xFF));
+}
+
+// ----------------------------------------------------------------------------
+// Deflate with LZ77 matching and the fixed Huffman codes of RFC 1951.
+// Rendered images have large flat regions, so the fixed codes already
+// compress them well and avoid building dynamic code tables.
+
+class BitWriter
+{
+public:
+  explicit BitWriter(std::vector<unsigned char>& out)
+    : Out(out)
+    , Buffer(0)
+    , Count(0)
+  {
+  }
+
+  // writes the low numBits of value, least significant bit first
+  void Write(unsigned int value, int numBits)
+  {
+    this->Buffer |= static_cast<unsigned long>(value) << this->Count;
+    this->Count += numBits;
+    while (this->Count >= 8)
+    {
+      this->Out.push_back(static_cast<unsigned char>(this->Buffer & 0xFF));
+      this->Buffer >>= 8;
+      this->Count -= 8;
+    }
+  }
+
+  // Huffman codes are defined most significant bit first
+  void WriteCode(unsigned int code, int numBits)
+  {
+    unsigned int reversed = 0;
+    for (int i = 0; i < numBits; ++i)
+    {
+      reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    this->Write(reversed, numBits);
+  }
+
+  void Flush()
+  {
+    if (this->Count > 0)
+    {
+      this->Out.push_back(static_cast<unsigned char>(this->Buffer & 0xFF));
+    }
+    this->Buffer = 0;
+    this->Count = 0;
+  }
+
+private:
+  std::vector<unsigned char>& Out;
+  unsigned long Buffer;
+  int Count;
+};
+
+const unsigned int LENGTH_BASE[29] = { 3,  4,  5,  6,  7,  8,  9,  10,  11,  13,
+                                       15, 17, 19, 23, 27, 31, 35, 43,  51,  59,
+                                       67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const unsigned int LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                        2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const unsigned int DISTANCE_BASE[30] = { 1,    2,    3,    4,     5,     7,     9,    13,
+                                         17,   25,   33,   49,    65,    97,    129,  193,
+                                         257,  385,  513,  769,   1025,  1537,  2049, 3073,
+                                         4097, 6145, 8193, 12289, 16385, 24577 };
+const unsigned int DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2,  2,  3,  3,  4,  4,  5,  5,  6,
+                                          6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+void WriteLiteral(BitWriter& writer, unsigned int symbol)
+{
+  if (symbol < 144)
+  {
+    writer.WriteCode(0x30 + symbol, 8);
+  }
+  else if (symbol < 256)
+  {
+    writer.WriteCode(0x190 + symbol - 144, 9);
+  }
+  else if (symbol < 280)
+  {
+    writer.WriteCode(symbol - 256, 7);
+  }
+  else
+  {
+    writer.WriteCode(0xC0 + symbol - 280, 8);
+  }
+}
+
+void WriteMatch(BitWriter& writer, unsigned int length, unsigned int distance)
+{
+  int code = 28;
+  while (LENGTH_BASE[code] > length)
+  {
+    --code;
+  }
+  WriteLiteral(writer, 257 + static_cast<unsigned int>(code));
+  writer.Write(length - LENGTH_BASE[code], static_cast<int>(LENGTH_EXTRA[code]));
+
+  code = 29;
+  while (DISTANCE_BASE[code] > distance)
+  {
+    --code;
+  }
+  writer.WriteCode(static_cast<unsigned int>(code), 5);
+  writer.Write(distance - DISTANCE_BASE[code], static_cast<int>(DISTANCE_EXTRA[code]));
+}
+
+void Deflate(std::vector<unsigned char>& out, const std::vector<unsigned char>& in)
+{
+  const std::size_t windowSize = 32768;
+  const std::size_t hashSize = 1 << 15;
+  const unsigned int minMatch = 3;
+  const unsigned int maxMatch = 258;
+  const int maxChain = 64;
+
+  // zlib header: deflate with a 32k window, default compression
+  out.push_back(0x78);
+  out.push_back(0x9C);
+
+  BitWriter writer(out);
+  writer.Write(1, 1); // final block
+  writer.Write(1, 2); // fixed Huffman codes
+
+  std::vector<long> head(hashSize, -1);
+  std::vector<long> prev(windowSize, -1);
+  const std::size_t size = in.size();
+  std::size_t pos = 0;
+  while (pos < size)
+  {
+    unsigned int bestLength = 0;
+    std::size_t bestDistance = 0;
+    std::size_t hash = 0;
+    if (pos + minMatch <= size)
+    {
+      hash = ((static_cast<std::size_t>(in[pos]) << 10) ^
+              (static_cast<std::size_t>(in[pos + 1]) << 5) ^ in[pos + 2]) &
+        (hashSize - 1);
+      const std::size_t maxLength = std::min<std::size_t>(maxMatch, size - pos);
+      long candidate = head[hash];
+      for (int chain = 0; chain < maxChain && candidate >= 0; ++chain)
+      {
+        const std::size_t start = static_cast<std::size_t>(candidate);
+        if (pos - start > windowSize - 1)
+        {
+          break;
+        }
+        std::size_t length = 0;
+        while (length < maxLength && in[start + length] == in[pos + length])
+        {
+          ++length;
+        }
+        if (length > bestLength)
+        {
+          bestLength = static_cast<unsigned int>(length);
+          bestDistance = pos - start;
+          if (length == maxLength)
+          {
+            break;
+          }
+        }
+        candidate = prev[start % windowSize];
+      }
+    }
+
+    std::size_t advance = 1;
+    if (bestLength >= minMatch)
+    {
+      WriteMatch(writer, bestLength, static_cast<unsigned int>(bestDistance));
+      advance = bestLength;
+    }
+    else
+    {
+      WriteLiteral(writer, in[pos]);
+    }
+
+    // insert every position we step over into the hash chains
+    for (std::size_t i = 0; i < advance; ++i, ++pos)
+    {
+      if (pos + minMatch <= size)
+      {
+        hash = ((static_cast<std::size_t>(in[pos]) << 10) ^
+                (static_cast<std::size_t>(in[pos + 1]) << 5) ^ in[pos + 2]) &
+          (hashSize - 1);
+        prev[pos % windowSize] = head[hash];
+        head[hash] = static_cast<long>(pos);
+      }
+    }
+  }
+  WriteLiteral(writer, 256); // end of block
+  writer.Flush();
+
+  AppendUInt32(out, Adler32(in.data(), in.size()));
+}
+
+// ----------------------------------------------------------------------------
+// PNG scanline filters
+
+unsigned char Paeth(int a, int b, int c)
+{
+  int p = a + b - c;
+  int pa = std::abs(p - a);
+  int pb = std::abs(p - b);
+  int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc)
+    return static_cast<unsigned char>(a);
+  if (pb <= pc)
+    return static_cast<unsigned char>(b);
+  return static_cast<unsigned char>(c);
+}
+
+// Filters one scanline with each of the five PNG filters and keeps the one
+// with the smallest sum of absolute values, the heuristic suggested by the
+// PNG specification.
+void FilterScanline(std::vector<unsigned char>& out,
+                    const unsigned char* row,
+                    const unsigned char* previous,
+                    std::size_t rowSize,
+                    std::size_t bytesPerPixel,
+                    std::vector<unsigned char>& scratch,
+                    std::vector<unsigned char>& best)
+{
+  scratch.resize(rowSize);
+  best.resize(rowSize);
+  std::size_t bestSum = static_cast<std::size_t>(-1);
+  unsigned char bestType = 0;
+  for (unsigned char type = 0; type < 5; ++type)
+  {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < rowSize; ++i)
+    {
+      int a = i >= bytesPerPixel ? row[i - bytesPerPixel] : 0;
+      int b = previous ? previous[i] : 0;
+      int c = (previous && i >= bytesPerPixel) ? previous[i - bytesPerPixel] : 0;
+      unsigned char predictor = 0;
+      switch (type)
+      {
+        case 1:
+          predictor = static_cast<unsigned char>(a);
+          break;
+        case 2:
+          predictor = static_cast<unsigned char>(b);
+          break;
+        case 3:
+          predictor = static_cast<unsigned char>((a + b) / 2);
+          break;
+        case 4:
+          predictor = Paeth(a, b, c);
+          break;
+        default:
+          break;
+      }
+      unsigned char value = static_cast<unsigned char>(row[i] - predictor);
+      scratch[i] = value;
+      sum += value < 128 ? value : 256 - value;
+    }
+    if (sum < bestSum)
+    {
+      bestSum = sum;
+      bestType = type;
+      best.swap(scratch);
+    }
+  }
+  out.push_back(bestType);
+  out.insert(out.end(), best.begin(), best.end());
+}
+
+void AppendChunk(std::vector<unsigned char>& out,
+                 const char* type,
+                 const std::vector<unsigned char>& data)
+{
+  AppendUInt32(out, static_cast<unsigned long>(data.size()));
+  const std::size_t typeStart = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  AppendUInt32(out, Crc32(&out[typeStart], data.size() + 4));
+}
+
+} // anonymous namespace
+
+int EncodePNG(std::vector<unsigned char>& out_png,
+              const unsigned char* in_image,
+              unsigned long image_width,
+              unsigned long image_height,
+              unsigned int channels,
+              unsigned int bit_depth)
+{
+  unsigned char colorType;
+  switch (channels)
+  {
+    case 1:
+      colorType = 0;
+      break;
+    case 3:
+      colorType = 2;
+      break;
+    case 4:
+      colorType = 6;
+      break;
+    default:
+      return 1; // unsupported number of channels
+  }
+  if (bit_depth != 8 && bit_depth != 16)
+  {
+    return 2; // unsupported bit depth
+  }
+  if (image_width == 0 || image_height == 0 || image_width > 0x7FFFFFFFUL ||
+      image_height > 0x7FFFFFFFUL)
+  {
+    return 3; // invalid image size
+  }
+
+  const std::size_t bytesPerPixel = channels * bit_depth / 8;
+  const std::size_t rowSize = bytesPerPixel * image_width;
+
+  std::vector<unsigned char> filtered;
+  filtered.reserve((rowSize + 1) * image_height);
+  std::vector<unsigned char> scratch;
+  std::vector<unsigned char> best;
+  for (unsigned long y = 0; y < image_height; ++y)
+  {
+    const unsigned char* row = in_image + y * rowSize;
+    const unsigned char* previous = y > 0 ? row - rowSize : nullptr;
+    FilterScanline(filtered, row, previous, rowSize, bytesPerPixel, scratch, best);
+  }
+
+  out_png.clear();
+  const unsigned char signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+  out_png.insert(out_png.end(), signature, signature + 8);
+
+  std::vector<unsigned char> header;
+  AppendUInt32(header, image_width);
+  AppendUInt32(header, image_height);
+  header.push_back(static_cast<unsigned char>(bit_depth));
+  header.push_back(colorType);
+  header.push_back(0); // deflate compression
+  header.push_back(0); // adaptive filtering
+  header.push_back(0); // no interlacing
+  AppendChunk(out_png, "IHDR", header);
+
+  std::vector<unsigned char> compressed;
+  Deflate(compressed, filtered);
+  AppendChunk(out_png, "IDAT", compressed);
+  AppendChunk(out_png, "IEND", std::vector<unsigned char>());
+  return 0;
+}
+}
+} // vtkm::rendering
@@ -0,0 +1,49 @@
+//=============================================================================
+//
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2016 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2016 UT-Battelle, LLC.
+//  Copyright 2016 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//
+//=============================================================================
+#ifndef vtk_m_rendering_EncodePNG_h
+#define vtk_m_rendering_EncodePNG_h
+
+#include <vtkm/rendering/vtkm_rendering_export.h>
+
+#include <vector>
+
+namespace vtkm
+{
+namespace rendering
+{
+
+/// Encodes an image as a PNG file in memory. The image is stored row by
+/// row, starting with the top row. \c channels selects the color type:
+/// 1 for gray, 3 for RGB and 4 for RGBA. \c bit_depth is 8 or 16; 16 bit
+/// samples are stored big endian, as in the PNG file itself. Returns 0 on
+/// success and a non-zero error code for unsupported arguments.
+VTKM_RENDERING_EXPORT
+int EncodePNG(std::vector<unsigned char>& out_png,
+              const unsigned char* in_image,
+              unsigned long image_width,
+              unsigned long image_height,
+              unsigned int channels,
+              unsigned int bit_depth = 8);
+}
+} // vtkm::rendering
+
+#endif //vtk_m_rendering_EncodePNG_h
@@ -0,0 +1,344 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/rendering/ImageDatabase.h>
+
+#include <vtkm/cont/ErrorBadValue.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+namespace vtkm
+{
+namespace rendering
+{
+
+namespace internal
+{
+
+static void MakeDirectory(const std::string& path)
+{
+#ifdef _WIN32
+  int result = _mkdir(path.c_str());
+#else
+  int result = mkdir(path.c_str(), 0755);
+#endif
+  if (result != 0 && errno != EEXIST)
+  {
+    throw vtkm::cont::ErrorBadValue("Could not create image database directory " + path);
+  }
+}
+
+// Each image is written on another thread while the next one renders. Bounding
+// the number of pending writes bounds the memory held by the image copies.
+constexpr std::size_t MaxPendingWrites = 4;
+
+} // namespace internal
+
+struct ImageDatabase::InternalsType
+{
+  struct Entry
+  {
+    vtkm::Float64 Time;
+    vtkm::Float64 Phi;
+    vtkm::Float64 Theta;
+    bool HasParameter;
+    vtkm::Float64 Parameter;
+    std::string ColorTableName;
+    std::string FileName;
+  };
+
+  std::string Path;
+  std::vector<vtkm::Float64> Phi;
+  std::vector<vtkm::Float64> Theta;
+  bool HasCamera;
+  vtkm::rendering::Camera Camera;
+  std::vector<std::string> ColorTableNames;
+  std::vector<vtkm::cont::ColorTable> ColorTables;
+  std::string ParameterName;
+  std::vector<vtkm::Float64> ParameterValues;
+  SceneGenerator Generator;
+  std::vector<Entry> Entries;
+
+  InternalsType()
+    : Phi(1, 0.0)
+    , Theta(1, 0.0)
+    , HasCamera(false)
+  {
+  }
+};
+
+ImageDatabase::ImageDatabase(const std::string& path)
+  : Internals(new InternalsType)
+{
+  this->Internals->Path = path;
+  internal::MakeDirectory(path);
+}
+
+ImageDatabase::~ImageDatabase()
+{
+}
+
+const std::string& ImageDatabase::GetPath() const
+{
+  return this->Internals->Path;
+}
+
+void ImageDatabase::SetCameraSweep(const std::vector<vtkm::Float64>& phi,
+                                   const std::vector<vtkm::Float64>& theta)
+{
+  if (phi.empty() || theta.empty())
+  {
+    throw vtkm::cont::ErrorBadValue("Camera sweep needs at least one phi and one theta.");
+  }
+  this->Internals->Phi = phi;
+  this->Internals->Theta = theta;
+}
+
+void ImageDatabase::SetCameraSweep(vtkm::IdComponent numberOfPhi, vtkm::IdComponent numberOfTheta)
+{
+  if (numberOfPhi < 1 || numberOfTheta < 1)
+  {
+    throw vtkm::cont::ErrorBadValue("Camera sweep needs at least one phi and one theta.");
+  }
+  std::vector<vtkm::Float64> phi(static_cast<std::size_t>(numberOfPhi));
+  for (vtkm::IdComponent i = 0; i < numberOfPhi; ++i)
+  {
+    phi[static_cast<std::size_t>(i)] = -180.0 + 360.0 * i / numberOfPhi;
+  }
+  // Elevations are sampled at the centers of equal intervals so that no view
+  // looks straight along the view up direction.
+  std::vector<vtkm::Float64> theta(static_cast<std::size_t>(numberOfTheta));
+  for (vtkm::IdComponent i = 0; i < numberOfTheta; ++i)
+  {
+    theta[static_cast<std::size_t>(i)] = -90.0 + 180.0 * (i + 0.5) / numberOfTheta;
+  }
+  this->SetCameraSweep(phi, theta);
+}
+
+const std::vector<vtkm::Float64>& ImageDatabase::GetPhi() const
+{
+  return this->Internals->Phi;
+}
+
+const std::vector<vtkm::Float64>& ImageDatabase::GetTheta() const
+{
+  return this->Internals->Theta;
+}
+
+void ImageDatabase::SetCamera(const vtkm::rendering::Camera& camera)
+{
+  this->Internals->Camera = camera;
+  this->Internals->HasCamera = true;
+}
+
+void ImageDatabase::AddColorTable(const std::string& name, const vtkm::cont::ColorTable& colorTable)
+{
+  this->Internals->ColorTableNames.push_back(name);
+  this->Internals->ColorTables.push_back(colorTable);
+}
+
+void ImageDatabase::SetParameterSweep(const std::string& name,
+                                      const std::vector<vtkm::Float64>& values,
+                                      const SceneGenerator& generator)
+{
+  if (!generator)
+  {
+    throw vtkm::cont::ErrorBadValue("Parameter sweep needs a scene generator.");
+  }
+  this->Internals->ParameterName = name;
+  this->Internals->ParameterValues = values;
+  this->Internals->Generator = generator;
+}
+
+void ImageDatabase::Render(vtkm::rendering::Mapper& mapper,
+                           vtkm::rendering::Canvas& canvas,
+                           vtkm::Float64 time)
+{
+  if (!this->Internals->Generator)
+  {
+    throw vtkm::cont::ErrorBadValue("No parameter sweep set for the image database.");
+  }
+  for (vtkm::Float64 value : this->Internals->ParameterValues)
+  {
+    vtkm::rendering::Scene scene = this->Internals->Generator(value);
+    this->RenderScene(scene, mapper, canvas, time, true, value);
+  }
+  this->WriteIndex();
+}
+
+void ImageDatabase::Render(const vtkm::rendering::Scene& scene,
+                           vtkm::rendering::Mapper& mapper,
+                           vtkm::rendering::Canvas& canvas,
+                           vtkm::Float64 time)
+{
+  this->RenderScene(scene, mapper, canvas, time, false, 0.0);
+  this->WriteIndex();
+}
+
+void ImageDatabase::RenderScene(const vtkm::rendering::Scene& scene,
+                                vtkm::rendering::Mapper& mapper,
+                                vtkm::rendering::Canvas& canvas,
+                                vtkm::Float64 time,
+                                bool hasParameter,
+                                vtkm::Float64 parameter)
+{
+  // One scene per color table. The actors share their cell sets and
+  // coordinates with the original, so mappers that cache per cell set data
+  // keep using it across color tables.
+  std::vector<vtkm::rendering::Scene> scenes;
+  std::vector<std::string> colorTableNames;
+  if (this->Internals->ColorTables.empty())
+  {
+    scenes.push_back(scene);
+    colorTableNames.push_back(std::string());
+  }
+  for (std::size_t i = 0; i < this->Internals->ColorTables.size(); ++i)
+  {
+    vtkm::rendering::Scene colored;
+    for (vtkm::IdComponent a = 0; a < scene.GetNumberOfActors(); ++a)
+    {
+      const vtkm::rendering::Actor& actor = scene.GetActor(a);
+      vtkm::rendering::Actor recolored(actor.GetCells(),
+                                       actor.GetCoordinates(),
+                                       actor.GetScalarField(),
+                                       this->Internals->ColorTables[i]);
+      recolored.SetScalarRange(actor.GetScalarRange());
+      colored.AddActor(recolored);
+    }
+    scenes.push_back(colored);
+    colorTableNames.push_back(this->Internals->ColorTableNames[i]);
+  }
+
+  vtkm::rendering::Camera baseCamera = this->Internals->Camera;
+  if (!this->Internals->HasCamera)
+  {
+    baseCamera.ResetToBounds(scene.GetSpatialBounds());
+  }
+
+  std::deque<std::future<void>> pendingWrites;
+  for (vtkm::Float64 phi : this->Internals->Phi)
+  {
+    for (vtkm::Float64 theta : this->Internals->Theta)
+    {
+      vtkm::rendering::Camera camera = baseCamera;
+      camera.Azimuth(phi);
+      camera.Elevation(theta);
+      for (std::size_t s = 0; s < scenes.size(); ++s)
+      {
+        canvas.Activate();
+        canvas.Clear();
+        scenes[s].Render(mapper, canvas, camera);
+        canvas.Finish();
+
+        InternalsType::Entry entry;
+        entry.Time = time;
+        entry.Phi = phi;
+        entry.Theta = theta;
+        entry.HasParameter = hasParameter;
+        entry.Parameter = parameter;
+        entry.ColorTableName = colorTableNames[s];
+        std::ostringstream fileName;
+        fileName << "image_" << std::setfill('0') << std::setw(6)
+                 << this->Internals->Entries.size() << ".png";
+        entry.FileName = fileName.str();
+
+        if (pendingWrites.size() >= internal::MaxPendingWrites)
+        {
+          pendingWrites.front().get();
+          pendingWrites.pop_front();
+        }
+        pendingWrites.push_back(
+          canvas.SaveAsAsync(this->Internals->Path + "/" + entry.FileName));
+        this->Internals->Entries.push_back(entry);
+      }
+    }
+  }
+
+  while (!pendingWrites.empty())
+  {
+    pendingWrites.front().get();
+    pendingWrites.pop_front();
+  }
+}
+
+vtkm::Id ImageDatabase::GetNumberOfImages() const
+{
+  return static_cast<vtkm::Id>(this->Internals->Entries.size());
+}
+
+void ImageDatabase::WriteIndex() const
+{
+  bool hasParameter = false;
+  bool hasColorTable = false;
+  for (const InternalsType::Entry& entry : this->Internals->Entries)
+  {
+    hasParameter = hasParameter || entry.HasParameter;
+    hasColorTable = hasColorTable || !entry.ColorTableName.empty();
+  }
+
+  std::string fileName = this->Internals->Path + "/data.csv";
+  std::ofstream of(fileName.c_str());
+  if (!of)
+  {
+    throw vtkm::cont::ErrorBadValue("Could not open " + fileName + " for writing.");
+  }
+  of << "time,phi,theta";
+  if (hasParameter)
+  {
+    of << "," << this->Internals->ParameterName;
+  }
+  if (hasColorTable)
+  {
+    of << ",colormap";
+  }
+  of << ",FILE\n";
+  for (const InternalsType::Entry& entry : this->Internals->Entries)
+  {
+    of << entry.Time << "," << entry.Phi << "," << entry.Theta;
+    if (hasParameter)
+    {
+      of << ",";
+      if (entry.HasParameter)
+      {
+        of << entry.Parameter;
+      }
+    }
+    if (hasColorTable)
+    {
+      of << "," << entry.ColorTableName;
+    }
+    of << "," << entry.FileName << "\n";
+  }
+}
+}
+} // namespace vtkm::rendering
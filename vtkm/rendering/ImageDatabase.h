@@ -0,0 +1,127 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_rendering_ImageDatabase_h
+#define vtk_m_rendering_ImageDatabase_h
+
+#include <vtkm/rendering/vtkm_rendering_export.h>
+
+#include <vtkm/cont/ColorTable.h>
+#include <vtkm/rendering/Camera.h>
+#include <vtkm/rendering/Canvas.h>
+#include <vtkm/rendering/Mapper.h>
+#include <vtkm/rendering/Scene.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vtkm
+{
+namespace rendering
+{
+
+/// \brief Renders a scene over a sweep of views and parameters into an image
+/// database.
+///
+/// An image database is a directory of images together with an index file,
+/// \c data.csv, that lists the parameters each image was rendered with (a
+/// Cinema "spec D" database). Every image is one combination of time,
+/// camera position (\c phi, \c theta), an optional user parameter (such as an
+/// isovalue) and an optional color table.
+///
+/// All views of one scene are rendered back to back with the same mapper and
+/// canvas, so acceleration structures and ray buffers the mapper keeps
+/// between renders are reused instead of rebuilt for every image. Images are
+/// written asynchronously while the next view renders.
+///
+class VTKM_RENDERING_EXPORT ImageDatabase
+{
+public:
+  /// Produces the scene for one value of a parameter sweep, for example by
+  /// contouring a data set at the given isovalue.
+  using SceneGenerator = std::function<vtkm::rendering::Scene(vtkm::Float64)>;
+
+  /// Creates a database in the given directory. The directory is created if
+  /// it does not exist.
+  ImageDatabase(const std::string& path);
+
+  ~ImageDatabase();
+
+  const std::string& GetPath() const;
+
+  /// Sets the camera positions as azimuth (\c phi) and elevation (\c theta)
+  /// angles in degrees relative to the base camera.
+  void SetCameraSweep(const std::vector<vtkm::Float64>& phi,
+                      const std::vector<vtkm::Float64>& theta);
+
+  /// Spreads \c numberOfPhi azimuths evenly over [-180, 180) and
+  /// \c numberOfTheta elevations evenly over (-90, 90), avoiding the poles.
+  void SetCameraSweep(vtkm::IdComponent numberOfPhi, vtkm::IdComponent numberOfTheta);
+
+  const std::vector<vtkm::Float64>& GetPhi() const;
+  const std::vector<vtkm::Float64>& GetTheta() const;
+
+  /// The camera the sweep is relative to. When not set, the camera is reset
+  /// to the spatial bounds of each scene.
+  void SetCamera(const vtkm::rendering::Camera& camera);
+
+  /// Adds a color table to sweep over. Every actor of the scene is rendered
+  /// with the table, keeping its scalar range. When no table is added, the
+  /// actors' own color tables are used.
+  void AddColorTable(const std::string& name, const vtkm::cont::ColorTable& colorTable);
+
+  /// Sets a parameter to sweep over. The generator is called once for each
+  /// value and the resulting scene is rendered for every view.
+  void SetParameterSweep(const std::string& name,
+                         const std::vector<vtkm::Float64>& values,
+                         const SceneGenerator& generator);
+
+  /// Renders every view of the parameter sweep.
+  void Render(vtkm::rendering::Mapper& mapper,
+              vtkm::rendering::Canvas& canvas,
+              vtkm::Float64 time = 0.0);
+
+  /// Renders every view of the given scene, ignoring any parameter sweep.
+  void Render(const vtkm::rendering::Scene& scene,
+              vtkm::rendering::Mapper& mapper,
+              vtkm::rendering::Canvas& canvas,
+              vtkm::Float64 time = 0.0);
+
+  vtkm::Id GetNumberOfImages() const;
+
+  /// Writes the index file. This is called at the end of each Render.
+  void WriteIndex() const;
+
+private:
+  void RenderScene(const vtkm::rendering::Scene& scene,
+                   vtkm::rendering::Mapper& mapper,
+                   vtkm::rendering::Canvas& canvas,
+                   vtkm::Float64 time,
+                   bool hasParameter,
+                   vtkm::Float64 parameter);
+
+  struct InternalsType;
+  std::shared_ptr<InternalsType> Internals;
+};
+}
+} //namespace vtkm::rendering
+
+#endif //vtk_m_rendering_ImageDatabase_h
@@ -21,9 +21,7 @@
 #include <vtkm/rendering/LineRenderer.h>
 
 #include <vtkm/Transform3D.h>
-#include <vtkm/cont/TryExecute.h>
-#include <vtkm/worklet/DispatcherMapField.h>
-#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/rendering/internal/AnnotationBatch.h>
 
 namespace vtkm
 {
@@ -56,6 +54,13 @@ void LineRenderer::RenderLine(const vtkm::Vec<vtkm::Float64, 3>& point0,
   vtkm::Vec<vtkm::Float32, 3> p0 = TransformPoint(point0);
   vtkm::Vec<vtkm::Float32, 3> p1 = TransformPoint(point1);
 
+  vtkm::rendering::internal::AnnotationBatch* batch = Canvas->GetAnnotationBatch();
+  if (batch != nullptr)
+  {
+    batch->AddLine(p0, p1, color.Components);
+    return;
+  }
+
   vtkm::Id x0 = static_cast<vtkm::Id>(vtkm::Round(p0[0]));
   vtkm::Id y0 = static_cast<vtkm::Id>(vtkm::Round(p0[1]));
   vtkm::Float32 z0 = static_cast<vtkm::Float32>(p0[2]);
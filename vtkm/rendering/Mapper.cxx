@@ -36,9 +36,13 @@ void Mapper::SetActiveColorTable(const vtkm::cont::ColorTable& colorTable)
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::UInt8, 4>> temp;
   colorTable.Sample(1024, temp);
 
-  this->ColorMap.Allocate(1024);
-  auto portal = this->ColorMap.GetPortalControl();
+  // The colors go to a new array that only replaces the current one when they
+  // differ, so mappers can tell from the handle whether the color map changed.
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> colorMap;
+  colorMap.Allocate(1024);
+  auto portal = colorMap.GetPortalControl();
   auto colorPortal = temp.GetPortalConstControl();
+  bool changed = this->ColorMap.GetNumberOfValues() != 1024;
   for (vtkm::Id i = 0; i < 1024; ++i)
   {
     auto color = colorPortal.Get(i);
@@ -48,6 +52,18 @@ void Mapper::SetActiveColorTable(const vtkm::cont::ColorTable& colorTable)
                                   color[3] * conversionToFloatSpace);
     portal.Set(i, t);
   }
+  if (!changed)
+  {
+    auto currentPortal = this->ColorMap.GetPortalConstControl();
+    for (vtkm::Id i = 0; i < 1024 && !changed; ++i)
+    {
+      changed = currentPortal.Get(i) != portal.Get(i);
+    }
+  }
+  if (changed)
+  {
+    this->ColorMap = colorMap;
+  }
 }
 
 void Mapper::SetLogarithmX(bool l)
@@ -59,6 +59,7 @@ public:
   virtual void SetLogarithmY(bool l);
 
 protected:
+  // Replaced by a new array, never modified in place, when the colors change.
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> ColorMap;
   bool LogarithmX = false;
   bool LogarithmY = false;
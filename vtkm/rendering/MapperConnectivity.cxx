@@ -80,7 +80,14 @@ void MapperConnectivity::RenderCells(const vtkm::cont::DynamicCellSet& cellset,
                                      const vtkm::rendering::Camera& camera,
                                      const vtkm::Range& vtkmNotUsed(scalarRange))
 {
-  vtkm::rendering::ConnectivityProxy tracerProxy(cellset, coords, scalarField);
+  if (!TracerProxy)
+  {
+    TracerProxy.reset(new vtkm::rendering::ConnectivityProxy(cellset, coords, scalarField));
+  }
+  else
+  {
+    TracerProxy->SetData(cellset, coords, scalarField);
+  }
   if (SampleDistance == -1.f)
   {
     // set a default distance
@@ -92,9 +99,9 @@ void MapperConnectivity::RenderCells(const vtkm::cont::DynamicCellSet& cellset,
     constexpr vtkm::Float64 defaultSamples = 200.;
     SampleDistance = static_cast<vtkm::Float32>(length / defaultSamples);
   }
-  tracerProxy.SetSampleDistance(SampleDistance);
-  tracerProxy.SetColorMap(ColorMap);
-  tracerProxy.Trace(camera, CanvasRT);
+  TracerProxy->SetSampleDistance(SampleDistance);
+  TracerProxy->SetColorMap(ColorMap);
+  TracerProxy->Trace(camera, CanvasRT);
 }
 
 void MapperConnectivity::StartScene()
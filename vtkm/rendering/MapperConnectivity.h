@@ -25,11 +25,15 @@
 #include <vtkm/rendering/Mapper.h>
 #include <vtkm/rendering/View.h>
 
+#include <memory>
+
 namespace vtkm
 {
 namespace rendering
 {
 
+class ConnectivityProxy;
+
 class VTKM_RENDERING_EXPORT MapperConnectivity : public Mapper
 {
 public:
@@ -56,6 +60,8 @@ public:
 protected:
   vtkm::Float32 SampleDistance;
   CanvasRayTracer* CanvasRT;
+  // Kept between renders so the mesh connectivity of an unchanged cell set is reused
+  std::shared_ptr<ConnectivityProxy> TracerProxy;
 };
 }
 } //namespace vtkm::rendering
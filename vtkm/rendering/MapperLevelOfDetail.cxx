@@ -0,0 +1,545 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/rendering/MapperLevelOfDetail.h>
+
+#include <vtkm/Matrix.h>
+#include <vtkm/TypeListTag.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
+#include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/ErrorExecution.h>
+#include <vtkm/cont/Timer.h>
+#include <vtkm/cont/TryExecute.h>
+#include <vtkm/rendering/internal/RunTriangulator.h>
+#include <vtkm/rendering/raytracing/Logger.h>
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/VertexClustering.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace vtkm
+{
+namespace rendering
+{
+
+namespace
+{
+
+// Splits the triangulator output into the connectivity of a triangle cell set
+// and the id of the cell each triangle came from.
+class SplitTriangles : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<>, FieldOut<>, WholeArrayOut<>);
+  using ExecutionSignature = void(WorkIndex, _1, _2, _3);
+
+  template <typename PortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& index,
+                            const vtkm::Vec<vtkm::Id, 4>& triangle,
+                            vtkm::Id& cellId,
+                            PortalType& connectivity) const
+  {
+    cellId = triangle[0];
+    connectivity.Set(3 * index + 0, triangle[1]);
+    connectivity.Set(3 * index + 1, triangle[2]);
+    connectivity.Set(3 * index + 2, triangle[3]);
+  }
+}; // class SplitTriangles
+
+struct Level
+{
+  bool Built = false;
+  vtkm::Id3 Divisions;
+  vtkm::cont::DynamicCellSet Cells;
+  vtkm::cont::CoordinateSystem Coords;
+  // Original point and cell of each point and triangle in the level
+  vtkm::cont::ArrayHandle<vtkm::Id> PointMap;
+  vtkm::cont::ArrayHandle<vtkm::Id> CellMap;
+  vtkm::Id NumberOfTriangles = 0;
+};
+
+struct Mesh
+{
+  vtkm::cont::DynamicCellSet Cells;
+  vtkm::cont::CoordinateSystem Coords;
+  vtkm::cont::CellSetSingleType<> Triangles;
+  vtkm::cont::ArrayHandle<vtkm::Id> TriangleCellIds;
+  vtkm::Id NumberOfTriangles = 0;
+  vtkm::Bounds ClusterBounds;
+  std::vector<Level> Levels;
+};
+
+struct SplitTrianglesFunctor
+{
+  template <typename Device>
+  VTKM_CONT bool operator()(Device,
+                            const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>>& triangles,
+                            vtkm::cont::ArrayHandle<vtkm::Id>& cellIds,
+                            vtkm::cont::ArrayHandle<vtkm::Id>& connectivity) const
+  {
+    connectivity.Allocate(3 * triangles.GetNumberOfValues());
+    vtkm::worklet::DispatcherMapField<SplitTriangles, Device>().Invoke(
+      triangles, cellIds, connectivity);
+    return true;
+  }
+};
+
+struct ClusterFunctor
+{
+  template <typename Device>
+  VTKM_CONT bool operator()(Device, const Mesh& mesh, Level& level) const
+  {
+    vtkm::worklet::VertexClustering clustering;
+    vtkm::cont::DataSet output = clustering.Run(
+      mesh.Triangles, mesh.Coords.GetData(), mesh.ClusterBounds, level.Divisions, Device());
+    level.Cells = output.GetCellSet();
+    level.Coords = output.GetCoordinateSystem();
+    level.PointMap = clustering.ProcessPointField(
+      vtkm::cont::ArrayHandleIndex(mesh.Coords.GetData().GetNumberOfValues()), Device());
+    level.CellMap = clustering.ProcessCellField(mesh.TriangleCellIds, Device());
+    level.NumberOfTriangles = level.Cells.GetNumberOfCells();
+    level.Built = true;
+    return true;
+  }
+};
+
+struct PermuteField
+{
+  template <typename T, typename S>
+  VTKM_CONT void operator()(const vtkm::cont::ArrayHandle<T, S>& values,
+                            const vtkm::cont::ArrayHandle<vtkm::Id>& map,
+                            vtkm::cont::DynamicArrayHandle& result) const
+  {
+    vtkm::cont::ArrayHandle<T> permuted;
+    vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandlePermutation(map, values), permuted);
+    result = permuted;
+  }
+};
+
+vtkm::cont::Field MapField(const vtkm::cont::Field& field, const Level& level)
+{
+  vtkm::cont::DynamicArrayHandle data;
+  auto values = field.GetData().ResetTypeList(vtkm::TypeListTagFieldScalar());
+  if (field.GetAssociation() == vtkm::cont::Field::Association::POINTS)
+  {
+    values.CastAndCall(PermuteField(), level.PointMap, data);
+    return vtkm::cont::Field(field.GetName(), field.GetAssociation(), data);
+  }
+  else if (field.GetAssociation() == vtkm::cont::Field::Association::CELL_SET)
+  {
+    values.CastAndCall(PermuteField(), level.CellMap, data);
+    return vtkm::cont::Field(
+      field.GetName(), field.GetAssociation(), level.Cells.GetName(), data);
+  }
+  return field;
+}
+
+// Clustering divides the longest axis into the given number of bins and the
+// other axes into bins of about the same size.
+vtkm::Id3 ClusterDivisions(const vtkm::Bounds& bounds, vtkm::Id divisions)
+{
+  vtkm::Vec<vtkm::Float64, 3> lengths(bounds.X.Length(), bounds.Y.Length(), bounds.Z.Length());
+  vtkm::Float64 maxLength = vtkm::Max(lengths[0], vtkm::Max(lengths[1], lengths[2]));
+  vtkm::Id3 result;
+  for (vtkm::IdComponent i = 0; i < 3; ++i)
+  {
+    result[i] = vtkm::Max(
+      vtkm::Id(1),
+      static_cast<vtkm::Id>(vtkm::Ceil(static_cast<vtkm::Float64>(divisions) * lengths[i] /
+                                       maxLength)));
+  }
+  return result;
+}
+
+// Bins of zero size would turn point coordinates into NaN cluster ids, so flat
+// axes are padded.
+vtkm::Bounds PadFlatAxes(vtkm::Bounds bounds)
+{
+  vtkm::Float64 maxLength =
+    vtkm::Max(bounds.X.Length(), vtkm::Max(bounds.Y.Length(), bounds.Z.Length()));
+  vtkm::Float64 pad = maxLength > 0. ? 0.5e-3 * maxLength : 0.5;
+  vtkm::Range* axes[3] = { &bounds.X, &bounds.Y, &bounds.Z };
+  for (vtkm::Range* axis : axes)
+  {
+    if (axis->Length() <= 0.)
+    {
+      axis->Min -= pad;
+      axis->Max += pad;
+    }
+  }
+  return bounds;
+}
+
+// Size in pixels of the longest side of the screen space box around the
+// projected bounds. Returns infinity when the camera is inside the bounds.
+vtkm::Float64 ProjectedSize(const vtkm::rendering::Camera& camera,
+                            const vtkm::Bounds& bounds,
+                            vtkm::Id width,
+                            vtkm::Id height)
+{
+  vtkm::Matrix<vtkm::Float32, 4, 4> transform = vtkm::MatrixMultiply(
+    camera.CreateProjectionMatrix(width, height), camera.CreateViewMatrix());
+  vtkm::Vec<vtkm::Float32, 2> minCorner(1.f, 1.f);
+  vtkm::Vec<vtkm::Float32, 2> maxCorner(-1.f, -1.f);
+  for (vtkm::IdComponent i = 0; i < 8; ++i)
+  {
+    vtkm::Vec<vtkm::Float32, 4> corner(
+      static_cast<vtkm::Float32>((i & 1) ? bounds.X.Max : bounds.X.Min),
+      static_cast<vtkm::Float32>((i & 2) ? bounds.Y.Max : bounds.Y.Min),
+      static_cast<vtkm::Float32>((i & 4) ? bounds.Z.Max : bounds.Z.Min),
+      1.f);
+    vtkm::Vec<vtkm::Float32, 4> projected = vtkm::MatrixMultiply(transform, corner);
+    if (projected[3] <= vtkm::Epsilon32())
+    {
+      return std::numeric_limits<vtkm::Float64>::infinity();
+    }
+    for (vtkm::IdComponent c = 0; c < 2; ++c)
+    {
+      vtkm::Float32 ndc = vtkm::Min(1.f, vtkm::Max(-1.f, projected[c] / projected[3]));
+      minCorner[c] = vtkm::Min(minCorner[c], ndc);
+      maxCorner[c] = vtkm::Max(maxCorner[c], ndc);
+    }
+  }
+  vtkm::Float64 x = 0.5 * (maxCorner[0] - minCorner[0]) * static_cast<vtkm::Float64>(width);
+  vtkm::Float64 y = 0.5 * (maxCorner[1] - minCorner[1]) * static_cast<vtkm::Float64>(height);
+  return vtkm::Max(x, y);
+}
+
+// Meshes whose levels are kept. Rendering more meshes than this evicts the
+// least recently rendered one.
+constexpr std::size_t MaxCachedMeshes = 8;
+
+} // anonymous namespace
+
+struct MapperLevelOfDetail::InternalsType
+{
+  std::shared_ptr<vtkm::rendering::Mapper> MapperPointer;
+  bool Interactive = true;
+  vtkm::Id CoarsestDivisions = 16;
+  vtkm::IdComponent NumberOfLevels = 4;
+  vtkm::Float32 PixelsPerCluster = 2.f;
+  vtkm::Float64 TimeBudget = 0.;
+  // Running estimate of the render time per triangle, used with the budget
+  vtkm::Float64 SecondsPerTriangle = 0.;
+  vtkm::IdComponent LastLevel = -1;
+  vtkm::Id LastNumberOfTriangles = 0;
+  std::vector<Mesh> Meshes;
+
+  VTKM_CONT
+  Mesh& GetMesh(const vtkm::cont::DynamicCellSet& cellset,
+                const vtkm::cont::CoordinateSystem& coords)
+  {
+    using Helper = vtkm::cont::detail::DynamicCellSetCopyHelper;
+    for (std::size_t i = 0; i < this->Meshes.size(); ++i)
+    {
+      if (Helper::GetCellSetContainer(this->Meshes[i].Cells) ==
+            Helper::GetCellSetContainer(cellset) &&
+          this->Meshes[i].Coords.GetData() == coords.GetData())
+      {
+        // keep the most recently rendered mesh at the back
+        std::rotate(this->Meshes.begin() + static_cast<std::ptrdiff_t>(i),
+                    this->Meshes.begin() + static_cast<std::ptrdiff_t>(i) + 1,
+                    this->Meshes.end());
+        return this->Meshes.back();
+      }
+    }
+
+    if (this->Meshes.size() >= MaxCachedMeshes)
+    {
+      this->Meshes.erase(this->Meshes.begin());
+    }
+
+    Mesh mesh;
+    mesh.Cells = cellset;
+    mesh.Coords = coords;
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> triangles;
+    vtkm::rendering::internal::RunTriangulator(cellset, triangles, mesh.NumberOfTriangles);
+    triangles.Shrink(mesh.NumberOfTriangles);
+    vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
+    if (!vtkm::cont::TryExecute(
+          SplitTrianglesFunctor(), triangles, mesh.TriangleCellIds, connectivity))
+    {
+      throw vtkm::cont::ErrorExecution("Failed to prepare level of detail triangles.");
+    }
+    mesh.Triangles = vtkm::cont::CellSetSingleType<>("triangles");
+    mesh.Triangles.Fill(
+      coords.GetData().GetNumberOfValues(), vtkm::CellShapeTagTriangle::Id, 3, connectivity);
+    mesh.ClusterBounds = PadFlatAxes(coords.GetBounds());
+    this->Meshes.push_back(mesh);
+    this->ResetLevels(this->Meshes.back());
+    return this->Meshes.back();
+  }
+
+  VTKM_CONT
+  void ResetLevels(Mesh& mesh) const
+  {
+    mesh.Levels.clear();
+    mesh.Levels.resize(static_cast<std::size_t>(this->NumberOfLevels));
+    for (vtkm::IdComponent i = 0; i < this->NumberOfLevels; ++i)
+    {
+      mesh.Levels[static_cast<std::size_t>(i)].Divisions =
+        ClusterDivisions(mesh.ClusterBounds, this->CoarsestDivisions << i);
+    }
+  }
+
+  VTKM_CONT
+  Level& GetLevel(Mesh& mesh, vtkm::IdComponent index) const
+  {
+    Level& level = mesh.Levels[static_cast<std::size_t>(index)];
+    if (!level.Built)
+    {
+      if (!vtkm::cont::TryExecute(ClusterFunctor(), mesh, level))
+      {
+        throw vtkm::cont::ErrorExecution("Failed to build level of detail.");
+      }
+    }
+    return level;
+  }
+
+  VTKM_CONT
+  vtkm::Id GetNumberOfTriangles(Mesh& mesh, vtkm::IdComponent index) const
+  {
+    return index < 0 ? mesh.NumberOfTriangles : this->GetLevel(mesh, index).NumberOfTriangles;
+  }
+
+  VTKM_CONT
+  vtkm::IdComponent SelectLevel(Mesh& mesh, const vtkm::rendering::Camera& camera) const
+  {
+    vtkm::rendering::Canvas* canvas = this->MapperPointer->GetCanvas();
+    if (!this->Interactive || canvas == nullptr)
+    {
+      return -1;
+    }
+
+    // The coarsest level that still puts about PixelsPerCluster pixels in a
+    // cluster, -1 when even the finest level is too coarse.
+    vtkm::Float64 neededDivisions =
+      ProjectedSize(camera, mesh.ClusterBounds, canvas->GetWidth(), canvas->GetHeight()) /
+      this->PixelsPerCluster;
+    vtkm::IdComponent index = -1;
+    for (vtkm::IdComponent i = 0; i < this->NumberOfLevels; ++i)
+    {
+      if (static_cast<vtkm::Float64>(this->CoarsestDivisions << i) >= neededDivisions)
+      {
+        index = i;
+        break;
+      }
+    }
+
+    if (this->TimeBudget > 0. && this->SecondsPerTriangle > 0.)
+    {
+      while (index != 0 &&
+             static_cast<vtkm::Float64>(this->GetNumberOfTriangles(mesh, index)) *
+                 this->SecondsPerTriangle >
+               this->TimeBudget)
+      {
+        index = index < 0 ? this->NumberOfLevels - 1 : index - 1;
+      }
+    }
+
+    // Clustering does not always remove much, e.g. on small meshes
+    if (index >= 0 && this->GetNumberOfTriangles(mesh, index) >= mesh.NumberOfTriangles)
+    {
+      index = -1;
+    }
+    return index;
+  }
+};
+
+MapperLevelOfDetail::MapperLevelOfDetail(const vtkm::rendering::Mapper& mapper)
+  : Internals(new InternalsType)
+{
+  this->Internals->MapperPointer.reset(mapper.NewCopy());
+}
+
+MapperLevelOfDetail::~MapperLevelOfDetail()
+{
+}
+
+vtkm::rendering::Mapper& MapperLevelOfDetail::GetMapper()
+{
+  return *this->Internals->MapperPointer;
+}
+
+void MapperLevelOfDetail::SetInteractive(bool on)
+{
+  this->Internals->Interactive = on;
+}
+
+bool MapperLevelOfDetail::GetInteractive() const
+{
+  return this->Internals->Interactive;
+}
+
+void MapperLevelOfDetail::SetLevels(vtkm::Id coarsestDivisions, vtkm::IdComponent numberOfLevels)
+{
+  if (coarsestDivisions < 1 || numberOfLevels < 1)
+  {
+    throw vtkm::cont::ErrorBadValue("Level of detail needs at least one level and division.");
+  }
+  this->Internals->CoarsestDivisions = coarsestDivisions;
+  this->Internals->NumberOfLevels = numberOfLevels;
+  for (Mesh& mesh : this->Internals->Meshes)
+  {
+    this->Internals->ResetLevels(mesh);
+  }
+}
+
+void MapperLevelOfDetail::SetPixelsPerCluster(vtkm::Float32 pixels)
+{
+  if (pixels <= 0.f)
+  {
+    throw vtkm::cont::ErrorBadValue("Pixels per cluster must be positive.");
+  }
+  this->Internals->PixelsPerCluster = pixels;
+}
+
+vtkm::Float32 MapperLevelOfDetail::GetPixelsPerCluster() const
+{
+  return this->Internals->PixelsPerCluster;
+}
+
+void MapperLevelOfDetail::SetTimeBudget(vtkm::Float64 seconds)
+{
+  this->Internals->TimeBudget = seconds;
+}
+
+vtkm::Float64 MapperLevelOfDetail::GetTimeBudget() const
+{
+  return this->Internals->TimeBudget;
+}
+
+vtkm::IdComponent MapperLevelOfDetail::GetLastLevel() const
+{
+  return this->Internals->LastLevel;
+}
+
+vtkm::Id MapperLevelOfDetail::GetLastNumberOfTriangles() const
+{
+  return this->Internals->LastNumberOfTriangles;
+}
+
+void MapperLevelOfDetail::ClearCache()
+{
+  this->Internals->Meshes.clear();
+}
+
+void MapperLevelOfDetail::SetCanvas(vtkm::rendering::Canvas* canvas)
+{
+  this->Internals->MapperPointer->SetCanvas(canvas);
+}
+
+vtkm::rendering::Canvas* MapperLevelOfDetail::GetCanvas() const
+{
+  return this->Internals->MapperPointer->GetCanvas();
+}
+
+void MapperLevelOfDetail::RenderCells(const vtkm::cont::DynamicCellSet& cellset,
+                                      const vtkm::cont::CoordinateSystem& coords,
+                                      const vtkm::cont::Field& scalarField,
+                                      const vtkm::cont::ColorTable& colorTable,
+                                      const vtkm::rendering::Camera& camera,
+                                      const vtkm::Range& scalarRange)
+{
+  raytracing::Logger* logger = raytracing::Logger::GetInstance();
+  logger->OpenLogEntry("mapper_level_of_detail");
+  vtkm::cont::Timer<> totalTimer;
+
+  InternalsType& internals = *this->Internals;
+  Mesh& mesh = internals.GetMesh(cellset, coords);
+  vtkm::IdComponent index = internals.SelectLevel(mesh, camera);
+  logger->AddLogData("select_level", totalTimer.GetElapsedTime());
+  logger->AddLogData("level", index);
+
+  vtkm::cont::Timer<> renderTimer;
+  vtkm::Id numberOfTriangles;
+  if (index < 0)
+  {
+    internals.MapperPointer->RenderCells(
+      cellset, coords, scalarField, colorTable, camera, scalarRange);
+    numberOfTriangles = mesh.NumberOfTriangles;
+  }
+  else
+  {
+    Level& level = internals.GetLevel(mesh, index);
+    internals.MapperPointer->RenderCells(level.Cells,
+                                         level.Coords,
+                                         MapField(scalarField, level),
+                                         colorTable,
+                                         camera,
+                                         scalarRange);
+    numberOfTriangles = level.NumberOfTriangles;
+  }
+  vtkm::Float64 renderTime = renderTimer.GetElapsedTime();
+  logger->AddLogData("triangles", numberOfTriangles);
+  logger->AddLogData("render", renderTime);
+
+  if (numberOfTriangles > 0)
+  {
+    vtkm::Float64 secondsPerTriangle = renderTime / static_cast<vtkm::Float64>(numberOfTriangles);
+    internals.SecondsPerTriangle = internals.SecondsPerTriangle > 0.
+      ? 0.5 * (internals.SecondsPerTriangle + secondsPerTriangle)
+      : secondsPerTriangle;
+  }
+  internals.LastLevel = index;
+  internals.LastNumberOfTriangles = numberOfTriangles;
+  logger->CloseLogEntry(totalTimer.GetElapsedTime());
+}
+
+void MapperLevelOfDetail::SetActiveColorTable(const vtkm::cont::ColorTable& ct)
+{
+  this->Mapper::SetActiveColorTable(ct);
+  this->Internals->MapperPointer->SetActiveColorTable(ct);
+}
+
+void MapperLevelOfDetail::SetLogarithmX(bool l)
+{
+  this->Mapper::SetLogarithmX(l);
+  this->Internals->MapperPointer->SetLogarithmX(l);
+}
+
+void MapperLevelOfDetail::SetLogarithmY(bool l)
+{
+  this->Mapper::SetLogarithmY(l);
+  this->Internals->MapperPointer->SetLogarithmY(l);
+}
+
+void MapperLevelOfDetail::StartScene()
+{
+  this->Internals->MapperPointer->StartScene();
+}
+
+void MapperLevelOfDetail::EndScene()
+{
+  this->Internals->MapperPointer->EndScene();
+}
+
+vtkm::rendering::Mapper* MapperLevelOfDetail::NewCopy() const
+{
+  return new vtkm::rendering::MapperLevelOfDetail(*this);
+}
+}
+} // namespace vtkm::rendering
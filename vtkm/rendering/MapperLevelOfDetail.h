@@ -0,0 +1,107 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_rendering_MapperLevelOfDetail_h
+#define vtk_m_rendering_MapperLevelOfDetail_h
+
+#include <vtkm/cont/ColorTable.h>
+#include <vtkm/rendering/Camera.h>
+#include <vtkm/rendering/Mapper.h>
+
+#include <memory>
+
+namespace vtkm
+{
+namespace rendering
+{
+
+/// \brief Renders decimated versions of large meshes with another mapper.
+///
+/// \c MapperLevelOfDetail wraps a surface mapper such as \c MapperRayTracer or
+/// \c MapperWireframer. For each cell set it renders, it keeps a small
+/// hierarchy of meshes simplified with vertex clustering, each level having
+/// twice the clustering resolution of the previous one. Levels are built the
+/// first time they are needed and cached, so rendering the same actor again
+/// only pays for rendering the selected level.
+///
+/// The level is chosen so that a cluster covers about \c PixelsPerCluster
+/// pixels of the projected bounds of the data. With a time budget, coarser
+/// levels are chosen while the predicted render time exceeds the budget.
+/// When interactive mode is off, every mesh is rendered at full resolution,
+/// which is meant for final frames.
+///
+class VTKM_RENDERING_EXPORT MapperLevelOfDetail : public Mapper
+{
+public:
+  MapperLevelOfDetail(const vtkm::rendering::Mapper& mapper);
+
+  ~MapperLevelOfDetail();
+
+  /// The mapper that renders the selected level.
+  vtkm::rendering::Mapper& GetMapper();
+
+  /// Render decimated levels while on, full resolution while off.
+  void SetInteractive(bool on);
+  bool GetInteractive() const;
+
+  /// The number of clustering divisions along the longest axis of the
+  /// coarsest level, and the number of levels.
+  void SetLevels(vtkm::Id coarsestDivisions, vtkm::IdComponent numberOfLevels);
+
+  void SetPixelsPerCluster(vtkm::Float32 pixels);
+  vtkm::Float32 GetPixelsPerCluster() const;
+
+  /// Time budget in seconds for rendering one mesh. Zero disables the budget.
+  void SetTimeBudget(vtkm::Float64 seconds);
+  vtkm::Float64 GetTimeBudget() const;
+
+  /// The level used by the last render, -1 for full resolution.
+  vtkm::IdComponent GetLastLevel() const;
+  /// The number of triangles rendered by the last render.
+  vtkm::Id GetLastNumberOfTriangles() const;
+
+  /// Drops all cached levels.
+  void ClearCache();
+
+  void SetCanvas(vtkm::rendering::Canvas* canvas) override;
+  vtkm::rendering::Canvas* GetCanvas() const override;
+
+  void RenderCells(const vtkm::cont::DynamicCellSet& cellset,
+                   const vtkm::cont::CoordinateSystem& coords,
+                   const vtkm::cont::Field& scalarField,
+                   const vtkm::cont::ColorTable& colorTable,
+                   const vtkm::rendering::Camera& camera,
+                   const vtkm::Range& scalarRange) override;
+
+  void SetActiveColorTable(const vtkm::cont::ColorTable& ct) override;
+  void SetLogarithmX(bool l) override;
+  void SetLogarithmY(bool l) override;
+
+  void StartScene() override;
+  void EndScene() override;
+  vtkm::rendering::Mapper* NewCopy() const override;
+
+private:
+  struct InternalsType;
+  std::shared_ptr<InternalsType> Internals;
+};
+}
+} //namespace vtkm::rendering
+
+#endif //vtk_m_rendering_MapperLevelOfDetail_h
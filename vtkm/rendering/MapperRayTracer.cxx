@@ -42,12 +42,50 @@ struct MapperRayTracer::InternalsType
   vtkm::rendering::raytracing::Camera RayCamera;
   vtkm::rendering::raytracing::Ray<vtkm::Float32> Rays;
   bool CompositeBackground;
+  // The triangulation of the last cell set is kept so that rendering the same
+  // cells again (e.g. from a different view) reuses it. Handing the tracer the
+  // same index array also lets the BVH be refit instead of rebuilt.
+  vtkm::cont::DynamicCellSet CachedCells;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> CachedIndices;
+  vtkm::Id CachedNumberOfTriangles;
+  bool HasCachedTriangles;
+  // The coordinates, field and range last handed to the tracer. Setting the
+  // same data again would refit the BVH for nothing, so it is skipped.
+  vtkm::cont::ArrayHandleVirtualCoordinates CachedCoords;
+  vtkm::cont::Field CachedField;
+  vtkm::Range CachedScalarRange;
+  bool HasCachedData;
   VTKM_CONT
   InternalsType()
     : Canvas(nullptr)
     , CompositeBackground(true)
+    , CachedNumberOfTriangles(0)
+    , HasCachedTriangles(false)
+    , HasCachedData(false)
   {
   }
+
+  VTKM_CONT
+  bool IsCached(const vtkm::cont::DynamicCellSet& cellset) const
+  {
+    using Helper = vtkm::cont::detail::DynamicCellSetCopyHelper;
+    return this->HasCachedTriangles &&
+      Helper::GetCellSetContainer(cellset) == Helper::GetCellSetContainer(this->CachedCells);
+  }
+
+  VTKM_CONT
+  bool IsCached(const vtkm::cont::CoordinateSystem& coords,
+                const vtkm::cont::Field& scalarField,
+                const vtkm::Range& scalarRange) const
+  {
+    using Helper = vtkm::cont::detail::DynamicArrayHandleCopyHelper;
+    return this->HasCachedData && coords.GetData() == this->CachedCoords &&
+      scalarField.GetName() == this->CachedField.GetName() &&
+      scalarField.GetAssociation() == this->CachedField.GetAssociation() &&
+      Helper::GetArrayHandleContainer(scalarField.GetData()) ==
+      Helper::GetArrayHandleContainer(this->CachedField.GetData()) &&
+      scalarRange == this->CachedScalarRange;
+  }
 };
 
 MapperRayTracer::MapperRayTracer()
@@ -91,10 +129,16 @@ void MapperRayTracer::RenderCells(const vtkm::cont::DynamicCellSet& cellset,
   logger->OpenLogEntry("mapper_ray_tracer");
   vtkm::cont::Timer<> tot_timer;
   vtkm::cont::Timer<> timer;
-  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> indices;
-  vtkm::Id numberOfTriangles;
-
-  vtkm::rendering::internal::RunTriangulator(cellset, indices, numberOfTriangles);
+  if (!this->Internals->IsCached(cellset))
+  {
+    vtkm::rendering::internal::RunTriangulator(
+      cellset, this->Internals->CachedIndices, this->Internals->CachedNumberOfTriangles);
+    this->Internals->CachedCells = cellset;
+    this->Internals->HasCachedTriangles = true;
+    this->Internals->HasCachedData = false;
+  }
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> indices = this->Internals->CachedIndices;
+  vtkm::Id numberOfTriangles = this->Internals->CachedNumberOfTriangles;
   vtkm::Float64 time = timer.GetElapsedTime();
   logger->AddLogData("triangulator", time);
   vtkm::rendering::raytracing::Camera& cam = this->Internals->Tracer.GetCamera();
@@ -106,13 +150,21 @@ void MapperRayTracer::RenderCells(const vtkm::cont::DynamicCellSet& cellset,
   raytracing::RayOperations::MapCanvasToRays(
     this->Internals->Rays, camera, *this->Internals->Canvas);
 
-  vtkm::Bounds dataBounds = coords.GetBounds();
-  vtkm::cont::Field& field = const_cast<vtkm::cont::Field&>(scalarField);
-  this->Internals->Tracer.SetData(
-    coords.GetData(), indices, field, numberOfTriangles, scalarRange, dataBounds);
+  if (!this->Internals->IsCached(coords, scalarField, scalarRange))
+  {
+    vtkm::Bounds dataBounds = coords.GetBounds();
+    vtkm::cont::Field& field = const_cast<vtkm::cont::Field&>(scalarField);
+    this->Internals->Tracer.SetData(
+      coords.GetData(), indices, field, numberOfTriangles, scalarRange, dataBounds);
+    this->Internals->CachedCoords = coords.GetData();
+    this->Internals->CachedField = scalarField;
+    this->Internals->CachedScalarRange = scalarRange;
+    this->Internals->HasCachedData = true;
+  }
 
   this->Internals->Tracer.SetColorMap(this->ColorMap);
   this->Internals->Tracer.Render(this->Internals->Rays);
+  this->Internals->RayCamera.ExpandSubsampledRays(this->Internals->Rays);
 
   timer.Reset();
   this->Internals->Canvas->WriteToCanvas(
@@ -134,6 +186,16 @@ void MapperRayTracer::SetCompositeBackground(bool on)
   this->Internals->CompositeBackground = on;
 }
 
+void MapperRayTracer::SetSubsampling(vtkm::Int32 factor)
+{
+  this->Internals->RayCamera.SetSubsampling(factor);
+}
+
+void MapperRayTracer::SetSortRays(bool on)
+{
+  this->Internals->Tracer.SetSortRays(on);
+}
+
 void MapperRayTracer::StartScene()
 {
   // Nothing needs to be done.
@@ -51,6 +51,11 @@ public:
   virtual void StartScene() override;
   virtual void EndScene() override;
   void SetCompositeBackground(bool on);
+  /// Trace one ray per factor x factor block of pixels. Lower the factor on
+  /// successive renders to refine the image progressively.
+  void SetSubsampling(vtkm::Int32 factor);
+  /// Sort rays by direction and origin before they are traced.
+  void SetSortRays(bool on);
   vtkm::rendering::Mapper* NewCopy() const override;
 
 private:
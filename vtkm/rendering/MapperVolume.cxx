@@ -44,14 +44,46 @@ struct MapperVolume::InternalsType
   vtkm::rendering::CanvasRayTracer* Canvas;
   vtkm::Float32 SampleDistance;
   bool CompositeBackground;
+  vtkm::Int32 Subsampling;
+  // kept between renders so the tiled ray order is computed once
+  vtkm::rendering::raytracing::Camera RayCamera;
+  // kept between renders so the macro cell ranges are only rebuilt when the data changes
+  vtkm::rendering::raytracing::VolumeRendererStructured Tracer;
+  // The tracer holds a pointer to the field, so it is given this copy.
+  vtkm::cont::Field CachedField;
+  vtkm::cont::ArrayHandleVirtualCoordinates CachedCoords;
+  vtkm::cont::DynamicCellSet CachedCells;
+  vtkm::Range CachedScalarRange;
+  bool HasCachedData;
 
   VTKM_CONT
   InternalsType()
     : Canvas(nullptr)
     , SampleDistance(DEFAULT_SAMPLE_DISTANCE)
     , CompositeBackground(true)
+    , Subsampling(1)
+    , HasCachedData(false)
   {
   }
+
+  VTKM_CONT
+  bool IsCached(const vtkm::cont::DynamicCellSet& cellset,
+                const vtkm::cont::CoordinateSystem& coords,
+                const vtkm::cont::Field& scalarField,
+                const vtkm::Range& scalarRange) const
+  {
+    using CellSetHelper = vtkm::cont::detail::DynamicCellSetCopyHelper;
+    using ArrayHelper = vtkm::cont::detail::DynamicArrayHandleCopyHelper;
+    return this->HasCachedData &&
+      CellSetHelper::GetCellSetContainer(cellset) ==
+      CellSetHelper::GetCellSetContainer(this->CachedCells) &&
+      coords.GetData() == this->CachedCoords &&
+      scalarField.GetName() == this->CachedField.GetName() &&
+      scalarField.GetAssociation() == this->CachedField.GetAssociation() &&
+      ArrayHelper::GetArrayHandleContainer(scalarField.GetData()) ==
+      ArrayHelper::GetArrayHandleContainer(this->CachedField.GetData()) &&
+      scalarRange == this->CachedScalarRange;
+  }
 };
 
 MapperVolume::MapperVolume()
@@ -107,12 +139,13 @@ void MapperVolume::RenderCells(const vtkm::cont::DynamicCellSet& cellset,
     vtkm::cont::Timer<> tot_timer;
     vtkm::cont::Timer<> timer;
 
-    vtkm::rendering::raytracing::VolumeRendererStructured tracer;
+    vtkm::rendering::raytracing::VolumeRendererStructured& tracer = this->Internals->Tracer;
 
-    vtkm::rendering::raytracing::Camera rayCamera;
+    vtkm::rendering::raytracing::Camera& rayCamera = this->Internals->RayCamera;
     vtkm::rendering::raytracing::Ray<vtkm::Float32> rays;
 
     rayCamera.SetParameters(camera, *this->Internals->Canvas);
+    rayCamera.SetSubsampling(this->Internals->Subsampling);
 
     rayCamera.CreateRays(rays, coords);
     rays.Buffers.at(0).InitConst(0.f);
@@ -124,11 +157,22 @@ void MapperVolume::RenderCells(const vtkm::cont::DynamicCellSet& cellset,
       tracer.SetSampleDistance(this->Internals->SampleDistance);
     }
 
-    tracer.SetData(
-      coords, scalarField, cellset.Cast<vtkm::cont::CellSetStructured<3>>(), scalarRange);
+    if (!this->Internals->IsCached(cellset, coords, scalarField, scalarRange))
+    {
+      this->Internals->CachedField = scalarField;
+      this->Internals->CachedCoords = coords.GetData();
+      this->Internals->CachedCells = cellset;
+      this->Internals->CachedScalarRange = scalarRange;
+      this->Internals->HasCachedData = true;
+      tracer.SetData(coords,
+                     this->Internals->CachedField,
+                     cellset.Cast<vtkm::cont::CellSetStructured<3>>(),
+                     scalarRange);
+    }
     tracer.SetColorMap(this->ColorMap);
 
     tracer.Render(rays);
+    rayCamera.ExpandSubsampledRays(rays);
 
     timer.Reset();
     this->Internals->Canvas->WriteToCanvas(rays, rays.Buffers.at(0).Buffer, camera);
@@ -164,6 +208,15 @@ void MapperVolume::SetSampleDistance(const vtkm::Float32 sampleDistance)
   this->Internals->SampleDistance = sampleDistance;
 }
 
+void MapperVolume::SetSubsampling(const vtkm::Int32 factor)
+{
+  if (factor < 1)
+  {
+    throw vtkm::cont::ErrorBadValue("Mapper volume: subsampling must be at least one.");
+  }
+  this->Internals->Subsampling = factor;
+}
+
 void MapperVolume::SetCompositeBackground(const bool compositeBackground)
 {
   this->Internals->CompositeBackground = compositeBackground;
@@ -52,6 +52,8 @@ public:
   vtkm::rendering::Mapper* NewCopy() const override;
   void SetSampleDistance(const vtkm::Float32 distance);
   void SetCompositeBackground(const bool compositeBackground);
+  /// Cast one ray per factor x factor block of pixels for a faster preview.
+  void SetSubsampling(const vtkm::Int32 factor);
 
 private:
   struct InternalsType;
@@ -57,11 +57,15 @@ void View1D::Paint()
   this->UpdateCameraProperties();
   this->SetupForWorldSpace();
   this->GetScene().Render(this->GetMapper(), this->GetCanvas(), this->GetCamera());
+  this->GetCanvas().BeginAnnotations();
   this->RenderWorldAnnotations();
+  this->GetCanvas().EndAnnotations();
   this->SetupForScreenSpace();
+  this->GetCanvas().BeginAnnotations();
   this->RenderScreenAnnotations();
   this->RenderColorLegendAnnotations();
   this->RenderAnnotations();
+  this->GetCanvas().EndAnnotations();
   this->GetCanvas().Finish();
 }
 
@@ -55,10 +55,14 @@ void View2D::Paint()
   this->UpdateCameraProperties();
   this->SetupForWorldSpace();
   this->GetScene().Render(this->GetMapper(), this->GetCanvas(), this->GetCamera());
+  this->GetCanvas().BeginAnnotations();
   this->RenderWorldAnnotations();
+  this->GetCanvas().EndAnnotations();
   this->SetupForScreenSpace();
+  this->GetCanvas().BeginAnnotations();
   this->RenderScreenAnnotations();
   this->RenderAnnotations();
+  this->GetCanvas().EndAnnotations();
   this->GetCanvas().Finish();
 }
 
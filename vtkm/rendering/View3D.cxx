@@ -54,12 +54,16 @@ void View3D::Paint()
   this->GetCanvas().Clear();
 
   this->SetupForWorldSpace();
+  this->GetCanvas().BeginAnnotations();
   this->RenderWorldAnnotations();
+  this->GetCanvas().EndAnnotations();
   this->GetScene().Render(this->GetMapper(), this->GetCanvas(), this->GetCamera());
 
   this->SetupForScreenSpace();
+  this->GetCanvas().BeginAnnotations();
   this->RenderAnnotations();
   this->RenderScreenAnnotations();
+  this->GetCanvas().EndAnnotations();
 
   this->GetCanvas().Finish();
 }
@@ -0,0 +1,592 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/rendering/internal/AnnotationBatch.h>
+
+#include <vtkm/Pair.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/TryExecute.h>
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace vtkm
+{
+namespace rendering
+{
+namespace internal
+{
+namespace
+{
+
+constexpr vtkm::IdComponent PRIMITIVE_LINE = 0;
+constexpr vtkm::IdComponent PRIMITIVE_GLYPH = 1;
+
+// (pixel index, primitive index). A primitive covers a pixel with at most
+// one fragment, so sorting these keys orders the fragments of every pixel
+// by the order the primitives were added in.
+using FragmentKey = vtkm::Pair<vtkm::Id, vtkm::Id>;
+
+// Walks the pixels of a line with Bresenham's algorithm, stopping at the
+// border of the canvas, and calls visit(x, y) for each of them.
+template <typename Visitor>
+VTKM_EXEC void WalkLine(const vtkm::Vec<vtkm::Float32, 4>& coords,
+                        vtkm::Id width,
+                        vtkm::Id height,
+                        Visitor& visit)
+{
+  vtkm::Id x0 = static_cast<vtkm::Id>(vtkm::Round(coords[0]));
+  vtkm::Id y0 = static_cast<vtkm::Id>(vtkm::Round(coords[1]));
+  vtkm::Id x1 = static_cast<vtkm::Id>(vtkm::Round(coords[2]));
+  vtkm::Id y1 = static_cast<vtkm::Id>(vtkm::Round(coords[3]));
+  vtkm::Id dx = vtkm::Abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  vtkm::Id dy = -vtkm::Abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  vtkm::Id err = dx + dy, err2 = 0;
+
+  while (x0 >= 0 && x0 < width && y0 >= 0 && y0 < height)
+  {
+    visit(x0, y0);
+
+    if (x0 == x1 && y0 == y1)
+    {
+      break;
+    }
+    err2 = err * 2;
+    if (err2 >= dy)
+    {
+      err += dy;
+      x0 += sx;
+    }
+    if (err2 <= dx)
+    {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+VTKM_EXEC
+inline vtkm::Float32 LineDepth(const vtkm::Vec<vtkm::Float32, 4>& coords,
+                               const vtkm::Vec<vtkm::Float32, 4>& params,
+                               vtkm::Id x)
+{
+  vtkm::Id dx = vtkm::Abs(static_cast<vtkm::Id>(vtkm::Round(coords[2])) -
+                          static_cast<vtkm::Id>(vtkm::Round(coords[0])));
+  vtkm::Float32 t =
+    (dx == 0) ? 1.0f : (static_cast<vtkm::Float32>(x) - coords[0]) / (coords[2] - coords[0]);
+  t = vtkm::Min(1.f, vtkm::Max(0.f, t));
+  return vtkm::Lerp(params[0], params[1], t);
+}
+
+VTKM_EXEC
+inline vtkm::Float32 Clamp(vtkm::Float32 v, vtkm::Float32 min, vtkm::Float32 max)
+{
+  return vtkm::Min(vtkm::Max(v, min), max);
+}
+
+// The text is sampled at increments of 0.25f of a pixel. This is the last
+// sample taken between first and last, computed the same way the sampling
+// loop steps.
+VTKM_EXEC
+inline vtkm::Float32 LastSample(vtkm::Float32 first, vtkm::Float32 last)
+{
+  vtkm::Float32 sample = first;
+  while (sample + 0.25f <= last)
+  {
+    sample += 0.25f;
+  }
+  return sample;
+}
+
+// Pixel rectangle of a glyph clamped to the canvas.
+VTKM_EXEC
+inline vtkm::Vec<vtkm::Float32, 4> GlyphRect(const vtkm::Vec<vtkm::Float32, 4>& screenCoords,
+                                             vtkm::Id width,
+                                             vtkm::Id height)
+{
+  return vtkm::Vec<vtkm::Float32, 4>(
+    Clamp(screenCoords[0], 0.0f, static_cast<vtkm::Float32>(width - 1)),
+    Clamp(screenCoords[1], 0.0f, static_cast<vtkm::Float32>(height - 1)),
+    Clamp(screenCoords[2], 0.0f, static_cast<vtkm::Float32>(width - 1)),
+    Clamp(screenCoords[3], 0.0f, static_cast<vtkm::Float32>(height - 1)));
+}
+
+struct LinePixelCounter
+{
+  vtkm::Id Count = 0;
+
+  VTKM_EXEC
+  void operator()(vtkm::Id, vtkm::Id) { ++this->Count; }
+};
+
+template <typename KeyPortal>
+struct LinePixelWriter
+{
+  const KeyPortal& Keys;
+  vtkm::Id Offset;
+  vtkm::Id Primitive;
+  vtkm::Id Width;
+
+  VTKM_EXEC
+  void operator()(vtkm::Id x, vtkm::Id y)
+  {
+    this->Keys.Set(this->Offset++, FragmentKey(y * this->Width + x, this->Primitive));
+  }
+};
+
+// Number of pixels touched by every primitive.
+struct CountFragments : public vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn<>, FieldIn<>, FieldOut<>);
+  using ExecutionSignature = _3(_1, _2);
+  using InputDomain = _1;
+
+  VTKM_CONT
+  CountFragments(vtkm::Id width, vtkm::Id height, bool drawGlyphs)
+    : Width(width)
+    , Height(height)
+    , DrawGlyphs(drawGlyphs)
+  {
+  }
+
+  VTKM_EXEC
+  vtkm::Id operator()(vtkm::IdComponent kind, const vtkm::Vec<vtkm::Float32, 4>& coords) const
+  {
+    if (kind == PRIMITIVE_LINE)
+    {
+      LinePixelCounter counter;
+      WalkLine(coords, this->Width, this->Height, counter);
+      return counter.Count;
+    }
+
+    const vtkm::Vec<vtkm::Float32, 4> rect = GlyphRect(coords, this->Width, this->Height);
+    if (!this->DrawGlyphs || rect[2] < rect[0] || rect[3] < rect[1])
+    {
+      return 0;
+    }
+    // Steps of a quarter pixel visit every pixel between the first and last
+    // rounded samples.
+    vtkm::Id columns = static_cast<vtkm::Id>(vtkm::Round(LastSample(rect[0], rect[2]))) -
+      static_cast<vtkm::Id>(vtkm::Round(rect[0])) + 1;
+    vtkm::Id rows = static_cast<vtkm::Id>(vtkm::Round(LastSample(rect[1], rect[3]))) -
+      static_cast<vtkm::Id>(vtkm::Round(rect[1])) + 1;
+    return columns * rows;
+  }
+
+  vtkm::Id Width;
+  vtkm::Id Height;
+  bool DrawGlyphs;
+}; // struct CountFragments
+
+// Writes the fragment keys of every primitive into its range of the
+// fragment array.
+struct EmitFragments : public vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn<>, FieldIn<>, FieldIn<>, FieldIn<>, WholeArrayOut<>);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, InputIndex);
+  using InputDomain = _1;
+
+  VTKM_CONT
+  EmitFragments(vtkm::Id width, vtkm::Id height)
+    : Width(width)
+    , Height(height)
+  {
+  }
+
+  template <typename KeyPortal>
+  VTKM_EXEC void operator()(vtkm::IdComponent kind,
+                            const vtkm::Vec<vtkm::Float32, 4>& coords,
+                            vtkm::Id offset,
+                            vtkm::Id count,
+                            const KeyPortal& keys,
+                            vtkm::Id primitive) const
+  {
+    if (count == 0)
+    {
+      return;
+    }
+    if (kind == PRIMITIVE_LINE)
+    {
+      LinePixelWriter<KeyPortal> writer{ keys, offset, primitive, this->Width };
+      WalkLine(coords, this->Width, this->Height, writer);
+      return;
+    }
+
+    const vtkm::Vec<vtkm::Float32, 4> rect = GlyphRect(coords, this->Width, this->Height);
+    vtkm::Id firstColumn = static_cast<vtkm::Id>(vtkm::Round(rect[0]));
+    vtkm::Id lastColumn = static_cast<vtkm::Id>(vtkm::Round(LastSample(rect[0], rect[2])));
+    vtkm::Id firstRow = static_cast<vtkm::Id>(vtkm::Round(rect[1]));
+    vtkm::Id lastRow = static_cast<vtkm::Id>(vtkm::Round(LastSample(rect[1], rect[3])));
+    for (vtkm::Id y = firstRow; y <= lastRow; ++y)
+    {
+      for (vtkm::Id x = firstColumn; x <= lastColumn; ++x)
+      {
+        keys.Set(offset++, FragmentKey(y * this->Width + x, primitive));
+      }
+    }
+  }
+
+  vtkm::Id Width;
+  vtkm::Id Height;
+}; // struct EmitFragments
+
+// Flags the first fragment of every pixel in the sorted fragments.
+struct MarkPixelStarts : public vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn<>, WholeArrayIn<>, FieldOut<>);
+  using ExecutionSignature = _3(_1, _2);
+  using InputDomain = _1;
+
+  template <typename KeyPortal>
+  VTKM_EXEC vtkm::Id operator()(vtkm::Id index, const KeyPortal& keys) const
+  {
+    return (index == 0 || keys.Get(index - 1).first != keys.Get(index).first) ? 1 : 0;
+  }
+}; // struct MarkPixelStarts
+
+// Each instance owns one pixel and applies its fragments in order, so the
+// color and depth of a pixel only ever have a single writer.
+struct ResolvePixels : public vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn<>,
+                                WholeArrayIn<>,
+                                WholeArrayIn<>,
+                                WholeArrayIn<>,
+                                WholeArrayIn<>,
+                                WholeArrayIn<>,
+                                WholeArrayIn<>,
+                                WholeArrayIn<>,
+                                ExecObject,
+                                WholeArrayInOut<>,
+                                WholeArrayInOut<>);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, WorkIndex);
+  using InputDomain = _1;
+
+  VTKM_CONT
+  ResolvePixels(vtkm::Id width, vtkm::Id height, vtkm::Id numberOfFragments)
+    : Width(width)
+    , Height(height)
+    , NumberOfFragments(numberOfFragments)
+  {
+  }
+
+  template <typename StartPortal,
+            typename KeyPortal,
+            typename KindPortal,
+            typename Vec4Portal,
+            typename DepthPortal,
+            typename FontTexture,
+            typename ColorBufferPortal,
+            typename DepthBufferPortal>
+  VTKM_EXEC void operator()(vtkm::Id begin,
+                            const StartPortal& starts,
+                            const KeyPortal& keys,
+                            const KindPortal& kinds,
+                            const Vec4Portal& coords,
+                            const Vec4Portal& params,
+                            const Vec4Portal& colors,
+                            const DepthPortal& depths,
+                            const FontTexture& fontTexture,
+                            ColorBufferPortal& colorBuffer,
+                            DepthBufferPortal& depthBuffer,
+                            vtkm::Id workIndex) const
+  {
+    vtkm::Id end = (workIndex + 1 < starts.GetNumberOfValues()) ? starts.Get(workIndex + 1)
+                                                                : this->NumberOfFragments;
+    vtkm::Id index = keys.Get(begin).first;
+    vtkm::Id x = index % this->Width;
+    vtkm::Id y = index / this->Width;
+    for (vtkm::Id f = begin; f < end; ++f)
+    {
+      vtkm::Id primitive = keys.Get(f).second;
+      if (kinds.Get(primitive) == PRIMITIVE_LINE)
+      {
+        this->DrawLinePixel(index,
+                            LineDepth(coords.Get(primitive), params.Get(primitive), x),
+                            colors.Get(primitive),
+                            colorBuffer,
+                            depthBuffer);
+      }
+      else
+      {
+        this->DrawGlyphPixel(x,
+                             y,
+                             coords.Get(primitive),
+                             params.Get(primitive),
+                             colors.Get(primitive),
+                             depths.Get(primitive),
+                             fontTexture,
+                             colorBuffer,
+                             depthBuffer);
+      }
+    }
+  }
+
+  template <typename ColorBufferPortal, typename DepthBufferPortal>
+  VTKM_EXEC void DrawLinePixel(vtkm::Id index,
+                               vtkm::Float32 z,
+                               const vtkm::Vec<vtkm::Float32, 4>& color,
+                               ColorBufferPortal& colorBuffer,
+                               DepthBufferPortal& depthBuffer) const
+  {
+    vtkm::Vec<vtkm::Float32, 4> currentColor = colorBuffer.Get(index);
+    vtkm::Float32 currentZ = depthBuffer.Get(index);
+    bool blend = currentColor[3] < 1.f && z > currentZ;
+    if (currentZ > z || blend)
+    {
+      vtkm::Vec<vtkm::Float32, 4> writeColor = color;
+      vtkm::Float32 depth = z;
+
+      if (blend)
+      {
+        // If there is any transparency, all alphas
+        // have been pre-mulitplied
+        vtkm::Float32 alpha = (1.f - currentColor[3]);
+        writeColor[0] = currentColor[0] + color[0] * alpha;
+        writeColor[1] = currentColor[1] + color[1] * alpha;
+        writeColor[2] = currentColor[2] + color[2] * alpha;
+        writeColor[3] = 1.f * alpha + currentColor[3]; // we are always drawing opaque lines
+        // keep the current z. Line z interpolation is not accurate
+        depth = currentZ;
+      }
+
+      depthBuffer.Set(index, depth);
+      colorBuffer.Set(index, writeColor);
+    }
+  }
+
+  // Applies the samples of a glyph that round to pixel (px, py), in the
+  // same order as sampling the whole glyph would.
+  template <typename FontTexture, typename ColorBufferPortal, typename DepthBufferPortal>
+  VTKM_EXEC void DrawGlyphPixel(vtkm::Id px,
+                                vtkm::Id py,
+                                const vtkm::Vec<vtkm::Float32, 4>& screenCoords,
+                                const vtkm::Vec<vtkm::Float32, 4>& textureCoords,
+                                const vtkm::Vec<vtkm::Float32, 4>& color,
+                                vtkm::Float32 depth,
+                                const FontTexture& fontTexture,
+                                ColorBufferPortal& colorBuffer,
+                                DepthBufferPortal& depthBuffer) const
+  {
+    const vtkm::Vec<vtkm::Float32, 4> rect = GlyphRect(screenCoords, this->Width, this->Height);
+    vtkm::Float32 x0 = rect[0], y0 = rect[1], x1 = rect[2], y1 = rect[3];
+    // For crisp text rendering, we sample the font texture at points smaller than the pixel
+    // sizes. Here we sample at increments of 0.25f, and scale the reported intensities accordingly
+    vtkm::Float32 dx = x1 - x0, dy = y1 - y0;
+    for (vtkm::Float32 x = x0; x <= x1; x += 0.25f)
+    {
+      vtkm::Id column = static_cast<vtkm::Id>(vtkm::Round(x));
+      if (column < px)
+      {
+        continue;
+      }
+      if (column > px)
+      {
+        break;
+      }
+      for (vtkm::Float32 y = y0; y <= y1; y += 0.25f)
+      {
+        vtkm::Id row = static_cast<vtkm::Id>(vtkm::Round(y));
+        if (row < py)
+        {
+          continue;
+        }
+        if (row > py)
+        {
+          break;
+        }
+        vtkm::Float32 tu = x1 == x0 ? 1.0f : (x - x0) / dx;
+        vtkm::Float32 tv = y1 == y0 ? 1.0f : (y - y0) / dy;
+        vtkm::Float32 u = vtkm::Lerp(textureCoords[0], textureCoords[2], tu);
+        vtkm::Float32 v = vtkm::Lerp(textureCoords[1], textureCoords[3], tv);
+        vtkm::Float32 intensity = fontTexture.GetColor(u, v)[0] * 0.25f;
+        this->Plot(py * this->Width + px, intensity, color, depth, colorBuffer, depthBuffer);
+      }
+    }
+  }
+
+  template <typename ColorBufferPortal, typename DepthBufferPortal>
+  VTKM_EXEC void Plot(vtkm::Id index,
+                      vtkm::Float32 intensity,
+                      const vtkm::Vec<vtkm::Float32, 4>& textColor,
+                      vtkm::Float32 depth,
+                      ColorBufferPortal& colorBuffer,
+                      DepthBufferPortal& depthBuffer) const
+  {
+    vtkm::Vec<vtkm::Float32, 4> srcColor = colorBuffer.Get(index);
+    vtkm::Float32 currentDepth = depthBuffer.Get(index);
+    bool swap = depth > currentDepth;
+
+    intensity = intensity * textColor[3];
+    vtkm::Vec<vtkm::Float32, 4> color = intensity * textColor;
+    color[3] = intensity;
+    vtkm::Vec<vtkm::Float32, 4> front = color;
+    vtkm::Vec<vtkm::Float32, 4> back = srcColor;
+
+    if (swap)
+    {
+      front = srcColor;
+      back = color;
+    }
+
+    vtkm::Vec<vtkm::Float32, 4> blendedColor;
+    vtkm::Float32 alpha = (1.f - front[3]);
+    blendedColor[0] = front[0] + back[0] * alpha;
+    blendedColor[1] = front[1] + back[1] * alpha;
+    blendedColor[2] = front[2] + back[2] * alpha;
+    blendedColor[3] = back[3] * alpha + front[3];
+
+    colorBuffer.Set(index, blendedColor);
+  }
+
+  vtkm::Id Width;
+  vtkm::Id Height;
+  vtkm::Id NumberOfFragments;
+}; // struct ResolvePixels
+
+struct RenderAnnotationsExecutor
+{
+  using ColorBufferType = vtkm::rendering::Canvas::ColorBufferType;
+  using DepthBufferType = vtkm::rendering::Canvas::DepthBufferType;
+  using FontTextureType = vtkm::rendering::Canvas::FontTextureType;
+
+  template <typename Device>
+  VTKM_CONT bool operator()(Device,
+                            const vtkm::cont::ArrayHandle<vtkm::IdComponent>& kinds,
+                            const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& coords,
+                            const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& params,
+                            const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& colors,
+                            const vtkm::cont::ArrayHandle<vtkm::Float32>& depths,
+                            const FontTextureType& fontTexture,
+                            ColorBufferType& colorBuffer,
+                            DepthBufferType& depthBuffer,
+                            vtkm::Id width,
+                            vtkm::Id height) const
+  {
+    VTKM_IS_DEVICE_ADAPTER_TAG(Device);
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<Device>;
+
+    vtkm::cont::ArrayHandle<vtkm::Id> counts;
+    vtkm::worklet::DispatcherMapField<CountFragments, Device> countDispatcher(
+      CountFragments(width, height, fontTexture.IsValid()));
+    countDispatcher.Invoke(kinds, coords, counts);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> offsets;
+    vtkm::Id numberOfFragments = Algorithm::ScanExclusive(counts, offsets);
+    if (numberOfFragments == 0)
+    {
+      return true;
+    }
+
+    vtkm::cont::ArrayHandle<FragmentKey> keys;
+    keys.Allocate(numberOfFragments);
+    vtkm::worklet::DispatcherMapField<EmitFragments, Device> emitDispatcher(
+      EmitFragments(width, height));
+    emitDispatcher.Invoke(kinds, coords, offsets, counts, keys);
+    Algorithm::Sort(keys);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> pixelStartFlags;
+    vtkm::worklet::DispatcherMapField<MarkPixelStarts, Device> markDispatcher;
+    markDispatcher.Invoke(vtkm::cont::ArrayHandleIndex(numberOfFragments), keys, pixelStartFlags);
+    vtkm::cont::ArrayHandle<vtkm::Id> pixelStarts;
+    Algorithm::CopyIf(vtkm::cont::ArrayHandleIndex(numberOfFragments), pixelStartFlags, pixelStarts);
+
+    vtkm::worklet::DispatcherMapField<ResolvePixels, Device> resolveDispatcher(
+      ResolvePixels(width, height, numberOfFragments));
+    resolveDispatcher.Invoke(pixelStarts,
+                             pixelStarts,
+                             keys,
+                             kinds,
+                             coords,
+                             params,
+                             colors,
+                             depths,
+                             fontTexture.GetExecObjectFactory(),
+                             colorBuffer,
+                             depthBuffer);
+    return true;
+  }
+}; // struct RenderAnnotationsExecutor
+
+} // anonymous namespace
+
+void AnnotationBatch::AddLine(const vtkm::Vec<vtkm::Float32, 3>& point0,
+                              const vtkm::Vec<vtkm::Float32, 3>& point1,
+                              const vtkm::Vec<vtkm::Float32, 4>& color)
+{
+  this->Kinds.push_back(PRIMITIVE_LINE);
+  this->Coords.push_back(vtkm::Vec<vtkm::Float32, 4>(point0[0], point0[1], point1[0], point1[1]));
+  this->Params.push_back(vtkm::Vec<vtkm::Float32, 4>(point0[2], point1[2], 0.f, 0.f));
+  this->Colors.push_back(color);
+  this->Depths.push_back(0.f);
+}
+
+void AnnotationBatch::AddGlyph(const vtkm::Vec<vtkm::Id, 4>& screenCoords,
+                               const vtkm::Vec<vtkm::Float32, 4>& textureCoords,
+                               const vtkm::Vec<vtkm::Float32, 4>& color,
+                               vtkm::Float32 depth)
+{
+  this->Kinds.push_back(PRIMITIVE_GLYPH);
+  this->Coords.push_back(vtkm::Vec<vtkm::Float32, 4>(static_cast<vtkm::Float32>(screenCoords[0]),
+                                                     static_cast<vtkm::Float32>(screenCoords[1]),
+                                                     static_cast<vtkm::Float32>(screenCoords[2]),
+                                                     static_cast<vtkm::Float32>(screenCoords[3])));
+  this->Params.push_back(textureCoords);
+  this->Colors.push_back(color);
+  this->Depths.push_back(depth);
+}
+
+void AnnotationBatch::Clear()
+{
+  this->Kinds.clear();
+  this->Coords.clear();
+  this->Params.clear();
+  this->Colors.clear();
+  this->Depths.clear();
+}
+
+void AnnotationBatch::Render(const vtkm::rendering::Canvas& canvas,
+                             const vtkm::rendering::Canvas::FontTextureType& fontTexture)
+{
+  vtkm::rendering::Canvas::ColorBufferType colorBuffer = canvas.GetColorBuffer();
+  vtkm::rendering::Canvas::DepthBufferType depthBuffer = canvas.GetDepthBuffer();
+
+  // The array handles only wrap the vectors, so they have to go out of scope
+  // before the vectors are cleared.
+  if (!this->Kinds.empty())
+  {
+    vtkm::cont::TryExecute(RenderAnnotationsExecutor(),
+                           vtkm::cont::make_ArrayHandle(this->Kinds),
+                           vtkm::cont::make_ArrayHandle(this->Coords),
+                           vtkm::cont::make_ArrayHandle(this->Params),
+                           vtkm::cont::make_ArrayHandle(this->Colors),
+                           vtkm::cont::make_ArrayHandle(this->Depths),
+                           fontTexture,
+                           colorBuffer,
+                           depthBuffer,
+                           canvas.GetWidth(),
+                           canvas.GetHeight());
+  }
+
+  this->Clear();
+}
+}
+}
+} // namespace vtkm::rendering::internal
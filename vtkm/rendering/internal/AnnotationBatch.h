@@ -0,0 +1,96 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2018 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2018 UT-Battelle, LLC.
+//  Copyright 2018 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_rendering_internal_AnnotationBatch_h
+#define vtk_m_rendering_internal_AnnotationBatch_h
+
+#include <vtkm/rendering/vtkm_rendering_export.h>
+
+#include <vtkm/Types.h>
+#include <vtkm/rendering/Canvas.h>
+
+#include <vector>
+
+namespace vtkm
+{
+namespace rendering
+{
+namespace internal
+{
+
+/// Collects the lines and text glyphs of the annotations drawn into a canvas
+/// so that they can be rasterized in a few parallel passes, rather than with
+/// a pass for every line and string.
+///
+/// Lines are given in pixel coordinates with a depth value. Glyphs are given
+/// as the pixel rectangle (xmin, ymin, xmax, ymax) they cover along with the
+/// matching rectangle in the font texture.
+///
+/// The primitives are broken into one fragment per pixel they touch. The
+/// fragments are sorted by pixel and then by the order the primitives were
+/// added in, and each pixel is resolved by a single thread that applies its
+/// fragments in that order. The result is therefore the same as drawing the
+/// primitives one after the other, including where they overlap.
+///
+class VTKM_RENDERING_EXPORT AnnotationBatch
+{
+public:
+  VTKM_CONT
+  void AddLine(const vtkm::Vec<vtkm::Float32, 3>& point0,
+               const vtkm::Vec<vtkm::Float32, 3>& point1,
+               const vtkm::Vec<vtkm::Float32, 4>& color);
+
+  VTKM_CONT
+  void AddGlyph(const vtkm::Vec<vtkm::Id, 4>& screenCoords,
+                const vtkm::Vec<vtkm::Float32, 4>& textureCoords,
+                const vtkm::Vec<vtkm::Float32, 4>& color,
+                vtkm::Float32 depth);
+
+  VTKM_CONT
+  vtkm::Id GetNumberOfPrimitives() const { return static_cast<vtkm::Id>(this->Kinds.size()); }
+
+  VTKM_CONT
+  bool IsEmpty() const { return this->Kinds.empty(); }
+
+  VTKM_CONT
+  void Clear();
+
+  /// Draws the primitives into the buffers of the canvas, in the order they
+  /// were added, and empties the batch. Glyphs are skipped when the font
+  /// texture is not valid.
+  ///
+  VTKM_CONT
+  void Render(const vtkm::rendering::Canvas& canvas,
+              const vtkm::rendering::Canvas::FontTextureType& fontTexture);
+
+private:
+  // Lines store (x0, y0, x1, y1) in Coords and (z0, z1, 0, 0) in Params.
+  // Glyphs store their pixel rectangle in Coords and their texture rectangle
+  // in Params.
+  std::vector<vtkm::IdComponent> Kinds;
+  std::vector<vtkm::Vec<vtkm::Float32, 4>> Coords;
+  std::vector<vtkm::Vec<vtkm::Float32, 4>> Params;
+  std::vector<vtkm::Vec<vtkm::Float32, 4>> Colors;
+  std::vector<vtkm::Float32> Depths;
+};
+}
+}
+} // namespace vtkm::rendering::internal
+
+#endif //vtk_m_rendering_internal_AnnotationBatch_h
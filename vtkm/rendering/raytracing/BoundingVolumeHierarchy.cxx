@@ -18,7 +18,11 @@
 //  this software.
 //============================================================================
 
+#include <algorithm>
+#include <cstring>
 #include <math.h>
+#include <utility>
+#include <vector>
 
 #include <vtkm/Math.h>
 #include <vtkm/VectorAnalysis.h>
@@ -29,6 +33,7 @@
 #include <vtkm/cont/Timer.h>
 #include <vtkm/cont/TryExecute.h>
 
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/AtomicArray.h>
 
 #include <vtkm/rendering/raytracing/BoundingVolumeHierarchy.h>
@@ -69,18 +74,40 @@ public:
   template <typename Device>
   class TreeBuilder;
 
+  template <typename Device>
+  class RefitWideNodes;
+
+  class SAHBuilder;
+
   VTKM_CONT
   LinearBVHBuilder() {}
 
   template <typename Device>
   VTKM_CONT void SortAABBS(
     BVHData& bvh,
+    vtkm::cont::ArrayHandle<vtkm::Id>& iterator,
     vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>>& triangleIndices,
     vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Int32, 4>>& outputTriangleIndices,
     Device vtkmNotUsed(device));
 
+  template <typename Device>
+  VTKM_CONT void GatherAABBs(BVHData& bvh,
+                             const vtkm::cont::ArrayHandle<vtkm::Id>& iterator,
+                             Device vtkmNotUsed(device));
+
+  template <typename Device>
+  VTKM_CONT void Propagate(BVHData& bvh, LinearBVH& linearBVH, Device vtkmNotUsed(device));
+
   template <typename Device>
   VTKM_CONT void RunOnDevice(LinearBVH& linearBVH, Device device);
+
+  template <typename Device>
+  VTKM_CONT void RefitOnDevice(LinearBVH& linearBVH, Device device);
+
+  template <typename Device>
+  VTKM_CONT void RefitWideOnDevice(LinearBVH& linearBVH, Device device);
+
+  VTKM_CONT void CollapseWide(LinearBVH& linearBVH);
 }; // class LinearBVHBuilder
 
 class LinearBVHBuilder::CountingIterator : public vtkm::worklet::WorkletMapField
@@ -234,7 +261,7 @@ public:
   vtkm::cont::ArrayHandle<vtkm::Id> rightChild;
 
   template <typename Device>
-  VTKM_CONT BVHData(vtkm::Id numPrimitives, Device vtkmNotUsed(device))
+  VTKM_CONT BVHData(vtkm::Id numPrimitives, Device vtkmNotUsed(device), bool allocateTree = true)
     : NumPrimitives(numPrimitives)
   {
     InnerNodeCount = NumPrimitives - 1;
@@ -246,6 +273,8 @@ public:
     ymaxs = new vtkm::cont::ArrayHandle<vtkm::Float32>();
     zmaxs = new vtkm::cont::ArrayHandle<vtkm::Float32>();
 
+    if (!allocateTree)
+      return;
     parent.PrepareForOutput(size, Device());
     leftChild.PrepareForOutput(InnerNodeCount, Device());
     rightChild.PrepareForOutput(InnerNodeCount, Device());
@@ -438,6 +467,81 @@ public:
   }
 }; //class PropagateAABBs
 
+// Copies the refit child bounds of the binary tree into the lanes of the
+// wide nodes collapsed from it. The child pointers are left untouched.
+template <typename Device>
+class LinearBVHBuilder::RefitWideNodes : public vtkm::worklet::WorkletMapField
+{
+private:
+  using Float4ArrayHandle = typename vtkm::cont::ArrayHandle<Vec<vtkm::Float32, 4>>;
+  using Float4ArrayPortal = typename Float4ArrayHandle::ExecutionTypes<Device>::Portal;
+  using Float4ConstPortal = typename Float4ArrayHandle::ExecutionTypes<Device>::PortalConst;
+
+  Float4ConstPortal FlatBVH;
+  Float4ArrayPortal WideBVH;
+
+public:
+  VTKM_CONT
+  RefitWideNodes(const Float4ArrayHandle& flatBVH, Float4ArrayHandle& wideBVH)
+    : FlatBVH(flatBVH.PrepareForInput(Device()))
+    , WideBVH(wideBVH.PrepareForInPlace(Device()))
+  {
+  }
+  using ControlSignature = void(FieldIn<>);
+  using ExecutionSignature = void(WorkIndex, _1);
+
+  VTKM_EXEC
+  void operator()(const vtkm::Id& wideNode, const vtkm::Vec<vtkm::Int32, 4>& sources) const
+  {
+    const vtkm::Id wideOffset = wideNode * 7;
+    vtkm::Vec<vtkm::Float32, 4> lanes[6];
+    for (vtkm::IdComponent i = 0; i < 6; ++i)
+    {
+      lanes[i] = WideBVH.Get(wideOffset + i);
+    }
+    for (vtkm::IdComponent lane = 0; lane < 4; ++lane)
+    {
+      if (sources[lane] < 0)
+      {
+        continue;
+      }
+      // binary node offsets are multiples of 4, the remainder is the side
+      const vtkm::Id offset = sources[lane] & ~3;
+      vtkm::Float32 box[6];
+      if ((sources[lane] & 3) == 0)
+      {
+        const vtkm::Vec<vtkm::Float32, 4> first4 = FlatBVH.Get(offset);
+        const vtkm::Vec<vtkm::Float32, 4> second4 = FlatBVH.Get(offset + 1);
+        box[0] = first4[0];
+        box[1] = first4[1];
+        box[2] = first4[2];
+        box[3] = first4[3];
+        box[4] = second4[0];
+        box[5] = second4[1];
+      }
+      else
+      {
+        const vtkm::Vec<vtkm::Float32, 4> second4 = FlatBVH.Get(offset + 1);
+        const vtkm::Vec<vtkm::Float32, 4> third4 = FlatBVH.Get(offset + 2);
+        box[0] = second4[2];
+        box[1] = second4[3];
+        box[2] = third4[0];
+        box[3] = third4[1];
+        box[4] = third4[2];
+        box[5] = third4[3];
+      }
+      for (vtkm::IdComponent i = 0; i < 6; ++i)
+      {
+        lanes[i][lane] = box[i];
+      }
+    }
+    for (vtkm::IdComponent i = 0; i < 6; ++i)
+    {
+      WideBVH.Set(wideOffset + i, lanes[i]);
+    }
+  }
+}; //class RefitWideNodes
+
 
 template <typename Device>
 class LinearBVHBuilder::TreeBuilder : public vtkm::worklet::WorkletMapField
@@ -598,24 +702,250 @@ public:
   }
 }; // class TreeBuilder
 
+// Top down binned SAH build on the host. The produced topology uses the
+// same layout as the morton builder: the root is inner node 0, the inner
+// nodes are numbered 0..n-2 and the leaf holding the i-th primitive of the
+// leaf order is node n-1+i. This lets the device side gather and
+// propagation passes be shared by both builders.
+class LinearBVHBuilder::SAHBuilder
+{
+public:
+  using Vec3f = vtkm::Vec<vtkm::Float32, 3>;
+
+  struct AABB
+  {
+    Vec3f Min;
+    Vec3f Max;
+
+    AABB()
+      : Min(vtkm::Infinity32())
+      , Max(vtkm::NegativeInfinity32())
+    {
+    }
+
+    void Include(const AABB& other)
+    {
+      for (vtkm::IdComponent i = 0; i < 3; ++i)
+      {
+        Min[i] = vtkm::Min(Min[i], other.Min[i]);
+        Max[i] = vtkm::Max(Max[i], other.Max[i]);
+      }
+    }
+
+    void Include(const Vec3f& point)
+    {
+      for (vtkm::IdComponent i = 0; i < 3; ++i)
+      {
+        Min[i] = vtkm::Min(Min[i], point[i]);
+        Max[i] = vtkm::Max(Max[i], point[i]);
+      }
+    }
+
+    vtkm::Float32 SurfaceArea() const
+    {
+      if (Min[0] > Max[0])
+        return 0.f;
+      Vec3f d = Max - Min;
+      return 2.f * (d[0] * d[1] + d[1] * d[2] + d[2] * d[0]);
+    }
+  };
+
+  static constexpr vtkm::Id NumBins = 16;
+
+  template <typename PortalType>
+  SAHBuilder(const PortalType& xmins,
+             const PortalType& ymins,
+             const PortalType& zmins,
+             const PortalType& xmaxs,
+             const PortalType& ymaxs,
+             const PortalType& zmaxs)
+  {
+    const vtkm::Id size = xmins.GetNumberOfValues();
+    Boxes.resize(static_cast<std::size_t>(size));
+    Centroids.resize(static_cast<std::size_t>(size));
+    for (vtkm::Id i = 0; i < size; ++i)
+    {
+      AABB& box = Boxes[static_cast<std::size_t>(i)];
+      box.Min = Vec3f(xmins.Get(i), ymins.Get(i), zmins.Get(i));
+      box.Max = Vec3f(xmaxs.Get(i), ymaxs.Get(i), zmaxs.Get(i));
+      Centroids[static_cast<std::size_t>(i)] = (box.Min + box.Max) * 0.5f;
+    }
+  }
+
+  void Build(std::vector<vtkm::Id>& order,
+             std::vector<vtkm::Id>& parents,
+             std::vector<vtkm::Id>& leftChildren,
+             std::vector<vtkm::Id>& rightChildren)
+  {
+    const vtkm::Id size = static_cast<vtkm::Id>(Boxes.size());
+    const vtkm::Id innerCount = size - 1;
+    order.resize(static_cast<std::size_t>(size));
+    for (vtkm::Id i = 0; i < size; ++i)
+      order[static_cast<std::size_t>(i)] = i;
+    parents.assign(static_cast<std::size_t>(size + innerCount), 0);
+    leftChildren.resize(static_cast<std::size_t>(innerCount));
+    rightChildren.resize(static_cast<std::size_t>(innerCount));
+
+    struct Task
+    {
+      vtkm::Id Node;
+      vtkm::Id Begin;
+      vtkm::Id End;
+    };
+    std::vector<Task> stack;
+    stack.push_back(Task{ 0, 0, size });
+    vtkm::Id nextInner = 1;
+    while (!stack.empty())
+    {
+      Task task = stack.back();
+      stack.pop_back();
+      const vtkm::Id mid = this->Split(order, task.Begin, task.End);
+
+      vtkm::Id children[2];
+      const vtkm::Id begins[2] = { task.Begin, mid };
+      const vtkm::Id ends[2] = { mid, task.End };
+      for (int c = 0; c < 2; ++c)
+      {
+        if (ends[c] - begins[c] == 1)
+        {
+          children[c] = innerCount + begins[c];
+        }
+        else
+        {
+          children[c] = nextInner++;
+          stack.push_back(Task{ children[c], begins[c], ends[c] });
+        }
+        parents[static_cast<std::size_t>(children[c])] = task.Node;
+      }
+      leftChildren[static_cast<std::size_t>(task.Node)] = children[0];
+      rightChildren[static_cast<std::size_t>(task.Node)] = children[1];
+    }
+  }
+
+private:
+  std::vector<AABB> Boxes;
+  std::vector<Vec3f> Centroids;
+
+  static vtkm::Id BinIndex(vtkm::Float32 value, vtkm::Float32 min, vtkm::Float32 scale)
+  {
+    vtkm::Id bin = static_cast<vtkm::Id>((value - min) * scale);
+    return vtkm::Max(vtkm::Id(0), vtkm::Min(bin, NumBins - 1));
+  }
+
+  // Partitions order[begin, end) and returns the first index of the right
+  // half. Both halves are always non-empty.
+  vtkm::Id Split(std::vector<vtkm::Id>& order, vtkm::Id begin, vtkm::Id end)
+  {
+    const vtkm::Id count = end - begin;
+    if (count == 2)
+      return begin + 1;
+
+    AABB centroidBounds;
+    for (vtkm::Id i = begin; i < end; ++i)
+    {
+      const std::size_t prim = static_cast<std::size_t>(order[static_cast<std::size_t>(i)]);
+      centroidBounds.Include(Centroids[prim]);
+    }
+
+    vtkm::Float32 bestCost = vtkm::Infinity32();
+    vtkm::IdComponent bestAxis = -1;
+    vtkm::Id bestBin = 0;
+    for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+    {
+      const vtkm::Float32 extent = centroidBounds.Max[axis] - centroidBounds.Min[axis];
+      if (!(extent > 0.f))
+        continue;
+      const vtkm::Float32 scale = static_cast<vtkm::Float32>(NumBins) / extent;
+
+      AABB bins[NumBins];
+      vtkm::Id counts[NumBins] = {};
+      for (vtkm::Id i = begin; i < end; ++i)
+      {
+        const std::size_t prim = static_cast<std::size_t>(order[static_cast<std::size_t>(i)]);
+        const vtkm::Id bin = BinIndex(Centroids[prim][axis], centroidBounds.Min[axis], scale);
+        counts[bin]++;
+        bins[bin].Include(Boxes[prim]);
+      }
+
+      // sweep from the right to collect the cost of the right side of each split
+      vtkm::Float32 rightArea[NumBins];
+      vtkm::Id rightCount[NumBins];
+      AABB accum;
+      vtkm::Id accumCount = 0;
+      for (vtkm::Id b = NumBins - 1; b > 0; --b)
+      {
+        accum.Include(bins[b]);
+        accumCount += counts[b];
+        rightArea[b] = accum.SurfaceArea();
+        rightCount[b] = accumCount;
+      }
+
+      accum = AABB();
+      accumCount = 0;
+      for (vtkm::Id b = 1; b < NumBins; ++b)
+      {
+        accum.Include(bins[b - 1]);
+        accumCount += counts[b - 1];
+        if (accumCount == 0 || rightCount[b] == 0)
+          continue;
+        const vtkm::Float32 cost = static_cast<vtkm::Float32>(accumCount) * accum.SurfaceArea() +
+          static_cast<vtkm::Float32>(rightCount[b]) * rightArea[b];
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bestAxis = axis;
+          bestBin = b;
+        }
+      }
+    }
+
+    auto first = order.begin() + static_cast<std::ptrdiff_t>(begin);
+    auto last = order.begin() + static_cast<std::ptrdiff_t>(end);
+    if (bestAxis != -1)
+    {
+      const vtkm::Float32 min = centroidBounds.Min[bestAxis];
+      const vtkm::Float32 scale = static_cast<vtkm::Float32>(NumBins) /
+        (centroidBounds.Max[bestAxis] - min);
+      auto midIter = std::partition(first, last, [&](vtkm::Id prim) {
+        return BinIndex(Centroids[static_cast<std::size_t>(prim)][bestAxis], min, scale) <
+          bestBin;
+      });
+      return begin + static_cast<vtkm::Id>(midIter - first);
+    }
+
+    // All centroids coincide, so no split is better than any other.
+    return begin + count / 2;
+  }
+}; // class SAHBuilder
+
 template <typename Device>
 VTKM_CONT void LinearBVHBuilder::SortAABBS(
   BVHData& bvh,
+  vtkm::cont::ArrayHandle<vtkm::Id>& iterator,
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>>& triangleIndices,
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Int32, 4>>& outputTriangleIndices,
   Device vtkmNotUsed(device))
 {
   //create array of indexes to be sorted with morton codes
-  vtkm::cont::ArrayHandle<vtkm::Id> iterator;
   iterator.PrepareForOutput(bvh.GetNumberOfPrimitives(), Device());
   vtkm::worklet::DispatcherMapField<CountingIterator, Device> iteratorDispatcher;
   iteratorDispatcher.Invoke(iterator);
 
-  //std::cout<<"\n\n\n";
   //sort the morton codes
-
   vtkm::cont::DeviceAdapterAlgorithm<Device>::SortByKey(bvh.mortonCodes, iterator);
 
+  GatherAABBs(bvh, iterator, Device());
+
+  vtkm::worklet::DispatcherMapField<GatherVecCast<Device>, Device>(
+    GatherVecCast<Device>(triangleIndices, outputTriangleIndices, bvh.GetNumberOfPrimitives()))
+    .Invoke(iterator);
+} // method SortAABBs
+
+template <typename Device>
+VTKM_CONT void LinearBVHBuilder::GatherAABBs(BVHData& bvh,
+                                             const vtkm::cont::ArrayHandle<vtkm::Id>& iterator,
+                                             Device vtkmNotUsed(device))
+{
   vtkm::Id arraySize = bvh.GetNumberOfPrimitives();
   vtkm::cont::ArrayHandle<vtkm::Float32>* tempStorage;
   vtkm::cont::ArrayHandle<vtkm::Float32>* tempPtr;
@@ -669,13 +999,32 @@ VTKM_CONT void LinearBVHBuilder::SortAABBS(
   tempPtr = bvh.zmaxs;
   bvh.zmaxs = tempStorage;
   tempStorage = tempPtr;
-
-  vtkm::worklet::DispatcherMapField<GatherVecCast<Device>, Device>(
-    GatherVecCast<Device>(triangleIndices, outputTriangleIndices, arraySize))
-    .Invoke(iterator);
   delete tempStorage;
+} // method GatherAABBs
 
-} // method SortAABBs
+template <typename Device>
+VTKM_CONT void LinearBVHBuilder::Propagate(BVHData& bvh,
+                                           LinearBVH& linearBVH,
+                                           Device vtkmNotUsed(device))
+{
+  const vtkm::Int32 primitiveCount = vtkm::Int32(bvh.GetNumberOfPrimitives());
+
+  vtkm::cont::ArrayHandle<vtkm::Int32> counters;
+  counters.PrepareForOutput(bvh.GetNumberOfPrimitives() - 1, Device());
+  vtkm::Int32 zero = 0;
+  vtkm::worklet::DispatcherMapField<MemSet<vtkm::Int32>, Device>(MemSet<vtkm::Int32>(zero))
+    .Invoke(counters);
+  vtkm::cont::AtomicArray<vtkm::Int32> atomicCounters(counters);
+
+  vtkm::worklet::DispatcherMapField<PropagateAABBs<Device>, Device>(
+    PropagateAABBs<Device>(linearBVH.Parents,
+                           linearBVH.LeftChildren,
+                           linearBVH.RightChildren,
+                           primitiveCount,
+                           linearBVH.FlatBVH,
+                           atomicCounters))
+    .Invoke(*bvh.xmins, *bvh.ymins, *bvh.zmins, *bvh.xmaxs, *bvh.ymaxs, *bvh.zmaxs);
+} // method Propagate
 
 // Adding this as a template parameter to allow restricted types and
 // storage for dynamic coordinate system to limit crazy code bloat and
@@ -696,7 +1045,8 @@ VTKM_CONT void LinearBVHBuilder::RunOnDevice(LinearBVH& linearBVH, Device device
   logger->AddLogData("bvh_num_triangles ", numberOfTriangles);
 
   const vtkm::Id numBBoxes = numberOfTriangles;
-  BVHData bvh(numBBoxes, device);
+  // the SAH topology is built on the host, so device tree storage is not needed
+  BVHData bvh(numBBoxes, device, linearBVH.BuildMode != LinearBVH::BUILD_SAH);
 
   vtkm::cont::Timer<Device> timer;
   vtkm::worklet::DispatcherMapField<FindAABBs, Device>(FindAABBs())
@@ -713,81 +1063,282 @@ VTKM_CONT void LinearBVHBuilder::RunOnDevice(LinearBVH& linearBVH, Device device
   logger->AddLogData("find_aabb", time);
   timer.Reset();
 
-  // Find the extent of all bounding boxes to generate normalization for morton codes
-  vtkm::Vec<vtkm::Float32, 3> minExtent(vtkm::Infinity32(), vtkm::Infinity32(), vtkm::Infinity32());
-  vtkm::Vec<vtkm::Float32, 3> maxExtent(
-    vtkm::NegativeInfinity32(), vtkm::NegativeInfinity32(), vtkm::NegativeInfinity32());
-  maxExtent[0] =
-    vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.xmaxs, maxExtent[0], MaxValue());
-  maxExtent[1] =
-    vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.ymaxs, maxExtent[1], MaxValue());
-  maxExtent[2] =
-    vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.zmaxs, maxExtent[2], MaxValue());
-  minExtent[0] =
-    vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.xmins, minExtent[0], MinValue());
-  minExtent[1] =
-    vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.ymins, minExtent[1], MinValue());
-  minExtent[2] =
-    vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.zmins, minExtent[2], MinValue());
+  if (linearBVH.BuildMode == LinearBVH::BUILD_SAH)
+  {
+    std::vector<vtkm::Id> order, parents, leftChildren, rightChildren;
+    {
+      SAHBuilder sah(bvh.xmins->GetPortalConstControl(),
+                     bvh.ymins->GetPortalConstControl(),
+                     bvh.zmins->GetPortalConstControl(),
+                     bvh.xmaxs->GetPortalConstControl(),
+                     bvh.ymaxs->GetPortalConstControl(),
+                     bvh.zmaxs->GetPortalConstControl());
+      sah.Build(order, parents, leftChildren, rightChildren);
+    }
+    // copy the host built topology so it is retained for refitting
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Copy(vtkm::cont::make_ArrayHandle(order),
+                                                     linearBVH.LeafOrder);
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Copy(vtkm::cont::make_ArrayHandle(parents),
+                                                     linearBVH.Parents);
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Copy(vtkm::cont::make_ArrayHandle(leftChildren),
+                                                     linearBVH.LeftChildren);
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Copy(vtkm::cont::make_ArrayHandle(rightChildren),
+                                                     linearBVH.RightChildren);
+
+    time = timer.GetElapsedTime();
+    logger->AddLogData("sah_build", time);
+    timer.Reset();
+
+    linearBVH.Allocate(bvh.GetNumberOfPrimitives(), Device());
+
+    GatherAABBs(bvh, linearBVH.LeafOrder, Device());
+    vtkm::worklet::DispatcherMapField<GatherVecCast<Device>, Device>(
+      GatherVecCast<Device>(triangleIndices, linearBVH.LeafNodes, bvh.GetNumberOfPrimitives()))
+      .Invoke(linearBVH.LeafOrder);
+
+    time = timer.GetElapsedTime();
+    logger->AddLogData("gather_aabbs", time);
+    timer.Reset();
+  }
+  else
+  {
+    // Find the extent of all bounding boxes to generate normalization for morton codes
+    vtkm::Vec<vtkm::Float32, 3> minExtent(
+      vtkm::Infinity32(), vtkm::Infinity32(), vtkm::Infinity32());
+    vtkm::Vec<vtkm::Float32, 3> maxExtent(
+      vtkm::NegativeInfinity32(), vtkm::NegativeInfinity32(), vtkm::NegativeInfinity32());
+    maxExtent[0] =
+      vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.xmaxs, maxExtent[0], MaxValue());
+    maxExtent[1] =
+      vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.ymaxs, maxExtent[1], MaxValue());
+    maxExtent[2] =
+      vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.zmaxs, maxExtent[2], MaxValue());
+    minExtent[0] =
+      vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.xmins, minExtent[0], MinValue());
+    minExtent[1] =
+      vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.ymins, minExtent[1], MinValue());
+    minExtent[2] =
+      vtkm::cont::DeviceAdapterAlgorithm<Device>::Reduce(*bvh.zmins, minExtent[2], MinValue());
+
+    time = timer.GetElapsedTime();
+    logger->AddLogData("calc_extents", time);
+    timer.Reset();
+
+    vtkm::Vec<vtkm::Float32, 3> deltaExtent = maxExtent - minExtent;
+    vtkm::Vec<vtkm::Float32, 3> inverseExtent;
+    for (int i = 0; i < 3; ++i)
+    {
+      inverseExtent[i] = (deltaExtent[i] == 0.f) ? 0 : 1.f / deltaExtent[i];
+    }
+
+    //Generate the morton codes
+    vtkm::worklet::DispatcherMapField<MortonCodeAABB, Device>(
+      MortonCodeAABB(inverseExtent, minExtent))
+      .Invoke(
+        *bvh.xmins, *bvh.ymins, *bvh.zmins, *bvh.xmaxs, *bvh.ymaxs, *bvh.zmaxs, bvh.mortonCodes);
 
-  time = timer.GetElapsedTime();
-  logger->AddLogData("calc_extents", time);
-  timer.Reset();
+    time = timer.GetElapsedTime();
+    logger->AddLogData("morton_codes", time);
+    timer.Reset();
 
-  vtkm::Vec<vtkm::Float32, 3> deltaExtent = maxExtent - minExtent;
-  vtkm::Vec<vtkm::Float32, 3> inverseExtent;
-  for (int i = 0; i < 3; ++i)
-  {
-    inverseExtent[i] = (deltaExtent[i] == 0.f) ? 0 : 1.f / deltaExtent[i];
+    linearBVH.Allocate(bvh.GetNumberOfPrimitives(), Device());
+
+    SortAABBS(bvh, linearBVH.LeafOrder, triangleIndices, linearBVH.LeafNodes, Device());
+
+    time = timer.GetElapsedTime();
+    logger->AddLogData("sort_aabbs", time);
+    timer.Reset();
+
+    vtkm::worklet::DispatcherMapField<TreeBuilder<Device>, Device>(
+      TreeBuilder<Device>(bvh.mortonCodes, bvh.parent, bvh.GetNumberOfPrimitives()))
+      .Invoke(bvh.leftChild, bvh.rightChild);
+
+    linearBVH.Parents = bvh.parent;
+    linearBVH.LeftChildren = bvh.leftChild;
+    linearBVH.RightChildren = bvh.rightChild;
+
+    time = timer.GetElapsedTime();
+    logger->AddLogData("build_tree", time);
+    timer.Reset();
   }
 
-  //Generate the morton codes
-  vtkm::worklet::DispatcherMapField<MortonCodeAABB, Device>(
-    MortonCodeAABB(inverseExtent, minExtent))
-    .Invoke(
-      *bvh.xmins, *bvh.ymins, *bvh.zmins, *bvh.xmaxs, *bvh.ymaxs, *bvh.zmaxs, bvh.mortonCodes);
+  Propagate(bvh, linearBVH, Device());
 
   time = timer.GetElapsedTime();
-  logger->AddLogData("morton_codes", time);
-  timer.Reset();
+  logger->AddLogData("propagate_aabbs", time);
 
-  linearBVH.Allocate(bvh.GetNumberOfPrimitives(), Device());
+  time = constructTimer.GetElapsedTime();
+  logger->CloseLogEntry(time);
+}
 
-  SortAABBS(bvh, triangleIndices, linearBVH.LeafNodes, Device());
+template <typename Device>
+VTKM_CONT void LinearBVHBuilder::RefitOnDevice(LinearBVH& linearBVH, Device device)
+{
+  Logger* logger = Logger::GetInstance();
+  logger->OpenLogEntry("bvh_refit");
+  logger->AddLogData("device", GetDeviceString(Device()));
+  vtkm::cont::Timer<Device> refitTimer;
 
-  time = timer.GetElapsedTime();
-  logger->AddLogData("sort_aabbs", time);
-  timer.Reset();
+  auto coordsHandle = linearBVH.GetCoordsHandle();
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> triangleIndices = linearBVH.GetTriangles();
+  vtkm::Id numberOfTriangles = linearBVH.GetNumberOfTriangles();
+  logger->AddLogData("bvh_num_triangles ", numberOfTriangles);
 
-  vtkm::worklet::DispatcherMapField<TreeBuilder<Device>, Device>(
-    TreeBuilder<Device>(bvh.mortonCodes, bvh.parent, bvh.GetNumberOfPrimitives()))
-    .Invoke(bvh.leftChild, bvh.rightChild);
+  // the topology is reused, so only the primitive bounds are needed
+  BVHData bvh(numberOfTriangles, device, false);
 
-  time = timer.GetElapsedTime();
-  logger->AddLogData("build_tree", time);
-  timer.Reset();
+  vtkm::cont::Timer<Device> timer;
+  vtkm::worklet::DispatcherMapField<FindAABBs, Device>(FindAABBs())
+    .Invoke(triangleIndices,
+            *bvh.xmins,
+            *bvh.ymins,
+            *bvh.zmins,
+            *bvh.xmaxs,
+            *bvh.ymaxs,
+            *bvh.zmaxs,
+            coordsHandle);
 
-  const vtkm::Int32 primitiveCount = vtkm::Int32(bvh.GetNumberOfPrimitives());
+  vtkm::Float64 time = timer.GetElapsedTime();
+  logger->AddLogData("find_aabb", time);
+  timer.Reset();
 
-  vtkm::cont::ArrayHandle<vtkm::Int32> counters;
-  counters.PrepareForOutput(bvh.GetNumberOfPrimitives() - 1, Device());
-  vtkm::Int32 zero = 0;
-  vtkm::worklet::DispatcherMapField<MemSet<vtkm::Int32>, Device>(MemSet<vtkm::Int32>(zero))
-    .Invoke(counters);
-  vtkm::cont::AtomicArray<vtkm::Int32> atomicCounters(counters);
+  GatherAABBs(bvh, linearBVH.LeafOrder, Device());
 
+  time = timer.GetElapsedTime();
+  logger->AddLogData("gather_aabbs", time);
+  timer.Reset();
 
-  vtkm::worklet::DispatcherMapField<PropagateAABBs<Device>, Device>(
-    PropagateAABBs<Device>(
-      bvh.parent, bvh.leftChild, bvh.rightChild, primitiveCount, linearBVH.FlatBVH, atomicCounters))
-    .Invoke(*bvh.xmins, *bvh.ymins, *bvh.zmins, *bvh.xmaxs, *bvh.ymaxs, *bvh.zmaxs);
+  Propagate(bvh, linearBVH, Device());
 
   time = timer.GetElapsedTime();
   logger->AddLogData("propagate_aabbs", time);
 
-  time = constructTimer.GetElapsedTime();
+  time = refitTimer.GetElapsedTime();
   logger->CloseLogEntry(time);
 }
+
+template <typename Device>
+VTKM_CONT void LinearBVHBuilder::RefitWideOnDevice(LinearBVH& linearBVH, Device)
+{
+  Logger* logger = Logger::GetInstance();
+  logger->OpenLogEntry("bvh_wide_refit");
+  logger->AddLogData("device", GetDeviceString(Device()));
+  vtkm::cont::Timer<Device> timer;
+
+  RefitWideNodes<Device> refitWide(linearBVH.FlatBVH, linearBVH.WideBVH);
+  vtkm::worklet::DispatcherMapField<RefitWideNodes<Device>, Device>(refitWide)
+    .Invoke(linearBVH.WideSources);
+
+  logger->CloseLogEntry(timer.GetElapsedTime());
+}
+
+VTKM_CONT void LinearBVHBuilder::CollapseWide(LinearBVH& linearBVH)
+{
+  using Vec4f = vtkm::Vec<vtkm::Float32, 4>;
+  using Vec4i = vtkm::Vec<vtkm::Int32, 4>;
+  constexpr vtkm::Int32 wideNodeSize = 7;
+
+  struct Child
+  {
+    vtkm::Float32 Box[6];
+    vtkm::Int32 Node;
+    // offset of the binary node holding this box plus 0 (left) or 1 (right)
+    vtkm::Int32 Source;
+
+    vtkm::Float32 SurfaceArea() const
+    {
+      const vtkm::Float32 dx = Box[3] - Box[0];
+      const vtkm::Float32 dy = Box[4] - Box[1];
+      const vtkm::Float32 dz = Box[5] - Box[2];
+      return dx * dy + dy * dz + dz * dx;
+    }
+  };
+
+  auto flatBVH = linearBVH.FlatBVH.GetPortalConstControl();
+  auto readChildren = [&flatBVH](vtkm::Int32 offset, Child* children) {
+    const Vec4f first4 = flatBVH.Get(offset);
+    const Vec4f second4 = flatBVH.Get(offset + 1);
+    const Vec4f third4 = flatBVH.Get(offset + 2);
+    const Vec4f fourth4 = flatBVH.Get(offset + 3);
+    const vtkm::Float32 left[6] = { first4[0], first4[1], first4[2],
+                                    first4[3], second4[0], second4[1] };
+    const vtkm::Float32 right[6] = { second4[2], second4[3], third4[0],
+                                     third4[1], third4[2], third4[3] };
+    for (int i = 0; i < 6; ++i)
+    {
+      children[0].Box[i] = left[i];
+      children[1].Box[i] = right[i];
+    }
+    memcpy(&children[0].Node, &fourth4[0], 4);
+    memcpy(&children[1].Node, &fourth4[1], 4);
+    children[0].Source = offset;
+    children[1].Source = offset + 1;
+  };
+
+  // pairs of binary node offset and wide node index
+  std::vector<std::pair<vtkm::Int32, vtkm::Int32>> stack;
+  std::vector<Vec4f> wide(wideNodeSize);
+  // where each lane's box came from, so that a refit can update it in place
+  std::vector<Vec4i> sources(1);
+  stack.push_back(std::make_pair(0, 0));
+  while (!stack.empty())
+  {
+    const vtkm::Int32 binaryNode = stack.back().first;
+    const vtkm::Int32 wideNode = stack.back().second;
+    stack.pop_back();
+
+    // pull grandchildren up, always opening the largest inner child
+    Child children[4];
+    readChildren(binaryNode, children);
+    int count = 2;
+    while (count < 4)
+    {
+      int largest = -1;
+      vtkm::Float32 largestArea = -1.f;
+      for (int i = 0; i < count; ++i)
+      {
+        if (children[i].Node >= 0 && children[i].SurfaceArea() > largestArea)
+        {
+          largest = i;
+          largestArea = children[i].SurfaceArea();
+        }
+      }
+      if (largest == -1)
+        break;
+      Child opened[2];
+      readChildren(children[largest].Node, opened);
+      children[largest] = opened[0];
+      children[count++] = opened[1];
+    }
+
+    Vec4f lanes[wideNodeSize];
+    Vec4i laneSources(-1);
+    for (int i = 0; i < wideNodeSize; ++i)
+      lanes[i] = Vec4f(0.f);
+    for (int lane = 0; lane < count; ++lane)
+    {
+      for (int i = 0; i < 6; ++i)
+        lanes[i][lane] = children[lane].Box[i];
+      laneSources[lane] = children[lane].Source;
+      vtkm::Int32 pointer = children[lane].Node;
+      if (pointer >= 0)
+      {
+        const vtkm::Int32 childNode = static_cast<vtkm::Int32>(wide.size()) / wideNodeSize;
+        wide.resize(wide.size() + wideNodeSize);
+        sources.resize(sources.size() + 1);
+        stack.push_back(std::make_pair(pointer, childNode));
+        pointer = childNode * wideNodeSize;
+      }
+      memcpy(&lanes[6][lane], &pointer, 4);
+    }
+    for (int i = 0; i < wideNodeSize; ++i)
+      wide[static_cast<std::size_t>(wideNode * wideNodeSize + i)] = lanes[i];
+    sources[static_cast<std::size_t>(wideNode)] = laneSources;
+  }
+
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(wide), linearBVH.WideBVH);
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(sources), linearBVH.WideSources);
+}
 } //namespace detail
 
 struct LinearBVH::ConstructFunctor
@@ -808,7 +1359,11 @@ struct LinearBVH::ConstructFunctor
 
 LinearBVH::LinearBVH()
   : IsConstructed(false)
-  , CanConstruct(false){};
+  , CanConstruct(false)
+  , WideIsConstructed(false)
+  , BuildMode(BUILD_MORTON)
+  , AllowRefit(true)
+  , CanRefit(false){};
 
 VTKM_CONT
 LinearBVH::LinearBVH(vtkm::cont::ArrayHandleVirtualCoordinates coordsHandle,
@@ -819,12 +1374,18 @@ LinearBVH::LinearBVH(vtkm::cont::ArrayHandleVirtualCoordinates coordsHandle,
   , Triangles(triangles)
   , IsConstructed(false)
   , CanConstruct(true)
+  , WideIsConstructed(false)
+  , BuildMode(BUILD_MORTON)
+  , AllowRefit(true)
+  , CanRefit(false)
 {
 }
 
 VTKM_CONT
 LinearBVH::LinearBVH(const LinearBVH& other)
   : FlatBVH(other.FlatBVH)
+  , WideBVH(other.WideBVH)
+  , WideSources(other.WideSources)
   , LeafNodes(other.LeafNodes)
   , LeafCount(other.LeafCount)
   , CoordBounds(other.CoordBounds)
@@ -832,6 +1393,14 @@ LinearBVH::LinearBVH(const LinearBVH& other)
   , Triangles(other.Triangles)
   , IsConstructed(other.IsConstructed)
   , CanConstruct(other.CanConstruct)
+  , WideIsConstructed(other.WideIsConstructed)
+  , BuildMode(other.BuildMode)
+  , AllowRefit(other.AllowRefit)
+  , CanRefit(other.CanRefit)
+  , Parents(other.Parents)
+  , LeftChildren(other.LeftChildren)
+  , RightChildren(other.RightChildren)
+  , LeafOrder(other.LeafOrder)
 {
 }
 template <typename Device>
@@ -860,6 +1429,8 @@ void LinearBVH::SetData(vtkm::cont::ArrayHandleVirtualCoordinates coordsHandle,
                         vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> triangles,
                         vtkm::Bounds coordBounds)
 {
+  // The same connectivity with new coordinates keeps the tree topology valid
+  CanRefit = AllowRefit && LeafOrder.GetNumberOfValues() > 0 && Triangles == triangles;
   CoordBounds = coordBounds;
   CoordsHandle = coordsHandle;
   Triangles = triangles;
@@ -867,6 +1438,36 @@ void LinearBVH::SetData(vtkm::cont::ArrayHandleVirtualCoordinates coordsHandle,
   CanConstruct = true;
 }
 
+VTKM_CONT
+void LinearBVH::SetBuildMode(BuildModeEnum mode)
+{
+  if (mode == BuildMode)
+    return;
+  BuildMode = mode;
+  IsConstructed = false;
+  CanRefit = false;
+}
+
+VTKM_CONT
+LinearBVH::BuildModeEnum LinearBVH::GetBuildMode() const
+{
+  return BuildMode;
+}
+
+VTKM_CONT
+void LinearBVH::SetAllowRefit(bool allowRefit)
+{
+  AllowRefit = allowRefit;
+  if (!AllowRefit)
+    CanRefit = false;
+}
+
+VTKM_CONT
+bool LinearBVH::GetAllowRefit() const
+{
+  return AllowRefit;
+}
+
 template <typename Device>
 void LinearBVH::ConstructOnDevice(Device device)
 {
@@ -890,8 +1491,23 @@ void LinearBVH::ConstructOnDevice(Device device)
       Triangles.GetPortalControl().Set(1, triangle);
     }
     detail::LinearBVHBuilder builder;
-    builder.RunOnDevice(*this, device);
+    if (CanRefit && this->GetNumberOfTriangles() == LeafOrder.GetNumberOfValues())
+    {
+      builder.RefitOnDevice(*this, device);
+      // the wide tree was collapsed from the same topology, so it only
+      // needs its bounds updated
+      if (WideIsConstructed)
+      {
+        builder.RefitWideOnDevice(*this, device);
+      }
+    }
+    else
+    {
+      builder.RunOnDevice(*this, device);
+      WideIsConstructed = false;
+    }
     IsConstructed = true;
+    CanRefit = false;
   }
 
   vtkm::Float64 time = timer.GetElapsedTime();
@@ -914,6 +1530,22 @@ template VTKM_RENDERING_EXPORT void LinearBVH::ConstructOnDevice<vtkm::cont::Dev
   vtkm::cont::DeviceAdapterTagCuda);
 #endif
 
+VTKM_CONT
+void LinearBVH::ConstructWide()
+{
+  this->Construct();
+  if (WideIsConstructed)
+    return;
+
+  Logger* logger = Logger::GetInstance();
+  vtkm::cont::Timer<vtkm::cont::DeviceAdapterTagSerial> timer;
+  logger->OpenLogEntry("bvh_wide");
+  detail::LinearBVHBuilder builder;
+  builder.CollapseWide(*this);
+  WideIsConstructed = true;
+  logger->CloseLogEntry(timer.GetElapsedTime());
+}
+
 VTKM_CONT
 bool LinearBVH::GetIsConstructed() const
 {
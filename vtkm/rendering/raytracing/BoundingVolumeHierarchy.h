@@ -30,6 +30,10 @@ namespace rendering
 {
 namespace raytracing
 {
+namespace detail
+{
+class LinearBVHBuilder;
+}
 
 //
 // This is the data structure that is passed to the ray tracer.
@@ -37,9 +41,31 @@ namespace raytracing
 class VTKM_RENDERING_EXPORT LinearBVH
 {
 public:
+  // BUILD_MORTON sorts primitives along a morton curve and builds the tree
+  // in parallel. BUILD_SAH recursively splits primitives with a binned surface
+  // area heuristic. The SAH build is slower, but produces a tree that is
+  // faster to traverse, so it is a good trade when the same geometry is
+  // rendered many times.
+  enum BuildModeEnum
+  {
+    BUILD_MORTON,
+    BUILD_SAH
+  };
+
   using InnerNodesHandle = vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>;
   using LeafNodesHandle = vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Int32, 4>>;
   InnerNodesHandle FlatBVH;
+  // Four wide collapse of FlatBVH used for traversal on CPU devices. Each
+  // node is seven Vec4s: the xmins, ymins, zmins, xmaxs, ymaxs and zmaxs of
+  // its four children followed by the child pointers bit cast to Int32.
+  // Inner children hold the offset of their node, leaves hold
+  // -(leaf index + 1) and unused lanes hold 0.
+  InnerNodesHandle WideBVH;
+  // For each wide node lane, the FlatBVH offset of the binary node its box
+  // was read from plus 0 for the left or 1 for the right child, or -1 for an
+  // unused lane. A refit updates WideBVH through it instead of collapsing
+  // the tree again.
+  LeafNodesHandle WideSources;
   LeafNodesHandle LeafNodes;
   struct ConstructFunctor;
   vtkm::Id LeafCount;
@@ -50,6 +76,16 @@ protected:
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> Triangles;
   bool IsConstructed;
   bool CanConstruct;
+  bool WideIsConstructed;
+  BuildModeEnum BuildMode;
+  bool AllowRefit;
+  bool CanRefit;
+  // Tree topology retained from the last full build. Refitting reuses it
+  // and only recomputes the bounding boxes.
+  vtkm::cont::ArrayHandle<vtkm::Id> Parents;
+  vtkm::cont::ArrayHandle<vtkm::Id> LeftChildren;
+  vtkm::cont::ArrayHandle<vtkm::Id> RightChildren;
+  vtkm::cont::ArrayHandle<vtkm::Id> LeafOrder;
 
 public:
   LinearBVH();
@@ -68,14 +104,36 @@ public:
   VTKM_CONT
   void Construct();
 
+  /// Sets the geometry for the next construction. If the BVH has already
+  /// been built for the same triangle array and refitting is allowed, the
+  /// next construction keeps the existing tree topology and only refits the
+  /// bounding boxes to the (possibly moved) coordinates.
   VTKM_CONT
   void SetData(vtkm::cont::ArrayHandleVirtualCoordinates coordsHandle,
                vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> triangles,
                vtkm::Bounds coordBounds);
 
+  VTKM_CONT
+  void SetBuildMode(BuildModeEnum mode);
+
+  VTKM_CONT
+  BuildModeEnum GetBuildMode() const;
+
+  VTKM_CONT
+  void SetAllowRefit(bool allowRefit);
+
+  VTKM_CONT
+  bool GetAllowRefit() const;
+
   template <typename Device>
   VTKM_CONT void ConstructOnDevice(Device device);
 
+  /// Builds WideBVH from the binary tree, constructing the binary tree first
+  /// if needed. The collapse runs in the control environment after a full
+  /// build. After a refit, the existing wide nodes are refit on the device.
+  VTKM_CONT
+  void ConstructWide();
+
   VTKM_CONT
   bool GetIsConstructed() const;
 
@@ -86,6 +144,8 @@ public:
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> GetTriangles() const;
 
   vtkm::Id GetNumberOfTriangles() const;
+
+  friend class detail::LinearBVHBuilder;
 }; // class LinearBVH
 }
 }
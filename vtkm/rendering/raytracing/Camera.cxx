@@ -20,6 +20,8 @@
 
 #include <vtkm/VectorAnalysis.h>
 
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/Timer.h>
 #include <vtkm/cont/TryExecute.h>
@@ -161,6 +163,134 @@ public:
 
 }; // class pixelData
 
+namespace detail
+{
+
+// spreads the lower 16 bits of x so there is a zero bit between each of them
+VTKM_EXEC_CONT inline vtkm::UInt64 ExpandBits2D(vtkm::UInt32 x)
+{
+  vtkm::UInt64 x64 = x & 0xFFFF;
+  x64 = (x64 | x64 << 8) & 0x00FF00FF;
+  x64 = (x64 | x64 << 4) & 0x0F0F0F0F;
+  x64 = (x64 | x64 << 2) & 0x33333333;
+  x64 = (x64 | x64 << 1) & 0x55555555;
+  return x64;
+}
+
+VTKM_EXEC_CONT inline vtkm::UInt64 Morton2D(vtkm::Int32 x, vtkm::Int32 y)
+{
+  return ExpandBits2D(static_cast<vtkm::UInt32>(y)) << 1 |
+    ExpandBits2D(static_cast<vtkm::UInt32>(x));
+}
+
+// Sort key that orders pixels by 8x8 tile, then by position inside the
+// tile. Both levels use morton order.
+class TiledPixelKey : public vtkm::worklet::WorkletMapField
+{
+protected:
+  vtkm::Int32 LatticeWidth;
+
+public:
+  VTKM_CONT
+  TiledPixelKey(vtkm::Int32 latticeWidth)
+    : LatticeWidth(latticeWidth)
+  {
+  }
+
+  using ControlSignature = void(FieldOut<>);
+  using ExecutionSignature = void(WorkIndex, _1);
+  VTKM_EXEC
+  void operator()(const vtkm::Id idx, vtkm::UInt64& key) const
+  {
+    const vtkm::Int32 i = vtkm::Int32(idx) % LatticeWidth;
+    const vtkm::Int32 j = vtkm::Int32(idx) / LatticeWidth;
+    key = (Morton2D(i / 8, j / 8) << 6) | Morton2D(i % 8, j % 8);
+  }
+}; // class TiledPixelKey
+
+// Records which ray was generated for each point of the subsampled lattice.
+class ScatterLatticeRays : public vtkm::worklet::WorkletMapField
+{
+protected:
+  vtkm::Int32 Width;
+  vtkm::Int32 Minx;
+  vtkm::Int32 Miny;
+  vtkm::Int32 LatticeWidth;
+  vtkm::Int32 Stride;
+
+public:
+  VTKM_CONT
+  ScatterLatticeRays(vtkm::Int32 width,
+                     vtkm::Int32 minx,
+                     vtkm::Int32 miny,
+                     vtkm::Int32 latticeWidth,
+                     vtkm::Int32 stride)
+    : Width(width)
+    , Minx(minx)
+    , Miny(miny)
+    , LatticeWidth(latticeWidth)
+    , Stride(stride)
+  {
+  }
+
+  using ControlSignature = void(FieldIn<>, WholeArrayOut<>);
+  using ExecutionSignature = void(WorkIndex, _1, _2);
+  template <typename PortalType>
+  VTKM_EXEC void operator()(const vtkm::Id rayIndex,
+                            const vtkm::Id& pixelIndex,
+                            PortalType& rayOfLattice) const
+  {
+    const vtkm::Int32 i = (vtkm::Int32(pixelIndex) % Width - Minx) / Stride;
+    const vtkm::Int32 j = (vtkm::Int32(pixelIndex) / Width - Miny) / Stride;
+    rayOfLattice.Set(j * LatticeWidth + i, rayIndex);
+  }
+}; // class ScatterLatticeRays
+
+// For each pixel of the image subset, finds the ray that covers it.
+class ExpandLattice : public vtkm::worklet::WorkletMapField
+{
+protected:
+  vtkm::Int32 Width;
+  vtkm::Int32 Minx;
+  vtkm::Int32 Miny;
+  vtkm::Int32 SubsetWidth;
+  vtkm::Int32 LatticeWidth;
+  vtkm::Int32 Stride;
+
+public:
+  VTKM_CONT
+  ExpandLattice(vtkm::Int32 width,
+                vtkm::Int32 minx,
+                vtkm::Int32 miny,
+                vtkm::Int32 subsetWidth,
+                vtkm::Int32 latticeWidth,
+                vtkm::Int32 stride)
+    : Width(width)
+    , Minx(minx)
+    , Miny(miny)
+    , SubsetWidth(subsetWidth)
+    , LatticeWidth(latticeWidth)
+    , Stride(stride)
+  {
+  }
+
+  using ControlSignature = void(FieldOut<>, FieldOut<>, WholeArrayIn<>);
+  using ExecutionSignature = void(WorkIndex, _1, _2, _3);
+  template <typename PortalType>
+  VTKM_EXEC void operator()(const vtkm::Id idx,
+                            vtkm::Id& source,
+                            vtkm::Id& pixelIndex,
+                            const PortalType& rayOfLattice) const
+  {
+    const vtkm::Int32 i = vtkm::Int32(idx) % SubsetWidth;
+    const vtkm::Int32 j = vtkm::Int32(idx) / SubsetWidth;
+    source = rayOfLattice.Get((j / Stride) * LatticeWidth + i / Stride);
+    pixelIndex = static_cast<vtkm::Id>((j + Miny) * Width + i + Minx);
+  }
+}; // class ExpandLattice
+
+} // namespace detail
+
 class Camera::Ortho2DRayGen : public vtkm::worklet::WorkletMapField
 {
 public:
@@ -168,7 +298,8 @@ public:
   vtkm::Int32 h;
   vtkm::Int32 Minx;
   vtkm::Int32 Miny;
-  vtkm::Int32 SubsetWidth;
+  vtkm::Int32 LatticeWidth;
+  vtkm::Int32 Stride;
   vtkm::Vec<vtkm::Float32, 3> nlook; // normalized look
   vtkm::Vec<vtkm::Float32, 3> PixelDelta;
   vtkm::Vec<vtkm::Float32, 3> delta_y;
@@ -178,7 +309,8 @@ public:
   Ortho2DRayGen(vtkm::Int32 width,
                 vtkm::Int32 height,
                 vtkm::Float32 vtkmNotUsed(_zoom),
-                vtkm::Int32 subsetWidth,
+                vtkm::Int32 latticeWidth,
+                vtkm::Int32 stride,
                 vtkm::Int32 minx,
                 vtkm::Int32 miny,
                 const vtkm::rendering::Camera& camera)
@@ -186,7 +318,8 @@ public:
     , h(height)
     , Minx(minx)
     , Miny(miny)
-    , SubsetWidth(subsetWidth)
+    , LatticeWidth(latticeWidth)
+    , Stride(stride)
   {
     vtkm::Float32 left, right, bottom, top;
     camera.GetViewRange2D(left, right, bottom, top);
@@ -216,10 +349,10 @@ public:
     vtkm::Normalize(nlook);
   }
 
-  using ControlSignature =
-    void(FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>);
+  using ControlSignature = void(
+    FieldIn<>, FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>);
 
-  using ExecutionSignature = void(WorkIndex, _1, _2, _3, _4, _5, _6, _7);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8);
   template <typename Precision>
   VTKM_EXEC void operator()(vtkm::Id idx,
                             Precision& rayDirX,
@@ -239,8 +372,8 @@ public:
     // not where the rays might intersect data like
     // the perspective ray gen
     //
-    int i = vtkm::Int32(idx) % SubsetWidth;
-    int j = vtkm::Int32(idx) / SubsetWidth;
+    int i = (vtkm::Int32(idx) % LatticeWidth) * Stride;
+    int j = (vtkm::Int32(idx) / LatticeWidth) * Stride;
 
     vtkm::Vec<vtkm::Float32, 3> pos;
     pos[0] = vtkm::Float32(i);
@@ -264,7 +397,8 @@ public:
   vtkm::Int32 h;
   vtkm::Int32 Minx;
   vtkm::Int32 Miny;
-  vtkm::Int32 SubsetWidth;
+  vtkm::Int32 LatticeWidth;
+  vtkm::Int32 Stride;
   vtkm::Vec<vtkm::Float32, 3> nlook; // normalized look
   vtkm::Vec<vtkm::Float32, 3> delta_x;
   vtkm::Vec<vtkm::Float32, 3> delta_y;
@@ -276,14 +410,16 @@ public:
                     vtkm::Vec<vtkm::Float32, 3> look,
                     vtkm::Vec<vtkm::Float32, 3> up,
                     vtkm::Float32 _zoom,
-                    vtkm::Int32 subsetWidth,
+                    vtkm::Int32 latticeWidth,
+                    vtkm::Int32 stride,
                     vtkm::Int32 minx,
                     vtkm::Int32 miny)
     : w(width)
     , h(height)
     , Minx(minx)
     , Miny(miny)
-    , SubsetWidth(subsetWidth)
+    , LatticeWidth(latticeWidth)
+    , Stride(stride)
   {
     vtkm::Float32 thx = tanf((fovX * vtkm::Pi_180f()) * .5f);
     vtkm::Float32 thy = tanf((fovY * vtkm::Pi_180f()) * .5f);
@@ -308,9 +444,9 @@ public:
     vtkm::Normalize(nlook);
   }
 
-  using ControlSignature = void(FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>);
+  using ControlSignature = void(FieldIn<>, FieldOut<>, FieldOut<>, FieldOut<>, FieldOut<>);
 
-  using ExecutionSignature = void(WorkIndex, _1, _2, _3, _4);
+  using ExecutionSignature = void(_1, _2, _3, _4, _5);
   template <typename Precision>
   VTKM_EXEC void operator()(vtkm::Id idx,
                             Precision& rayDirX,
@@ -319,8 +455,8 @@ public:
                             vtkm::Id& pixelIndex) const
   {
     vtkm::Vec<Precision, 3> ray_dir(rayDirX, rayDirY, rayDirZ);
-    int i = vtkm::Int32(idx) % SubsetWidth;
-    int j = vtkm::Int32(idx) / SubsetWidth;
+    int i = (vtkm::Int32(idx) % LatticeWidth) * Stride;
+    int j = (vtkm::Int32(idx) / LatticeWidth) * Stride;
     i += Minx;
     j += Miny;
     // Write out the global pixelId
@@ -364,6 +500,10 @@ bool Camera::operator==(const Camera& other) const
     return false;
   if (this->Zoom != other.Zoom)
     return false;
+  if (this->RayOrder != other.RayOrder)
+    return false;
+  if (this->Subsampling != other.Subsampling)
+    return false;
   if (this->Look[0] != other.Look[0])
     return false;
   if (this->Look[1] != other.Look[1])
@@ -417,6 +557,10 @@ Camera::Camera()
   this->Position[1] = 0.f;
   this->Position[2] = 0.f;
   this->IsViewDirty = true;
+  this->RayOrder = RAY_ORDER_TILED;
+  this->Subsampling = 1;
+  this->PixelOrderWidth = 0;
+  this->PixelOrderHeight = 0;
 }
 
 VTKM_CONT
@@ -618,6 +762,46 @@ vtkm::Vec<vtkm::Float32, 3> Camera::GetPosition() const
   return this->Position;
 }
 
+VTKM_CONT
+void Camera::SetRayOrder(RayOrderEnum order)
+{
+  this->RayOrder = order;
+}
+
+VTKM_CONT
+Camera::RayOrderEnum Camera::GetRayOrder() const
+{
+  return this->RayOrder;
+}
+
+VTKM_CONT
+void Camera::SetSubsampling(const vtkm::Int32& factor)
+{
+  if (factor < 1)
+  {
+    throw vtkm::cont::ErrorBadValue("Camera subsampling must be at least one.");
+  }
+  this->Subsampling = factor;
+}
+
+VTKM_CONT
+vtkm::Int32 Camera::GetSubsampling() const
+{
+  return this->Subsampling;
+}
+
+VTKM_CONT
+vtkm::Int32 Camera::GetLatticeWidth() const
+{
+  return (this->SubsetWidth + this->Subsampling - 1) / this->Subsampling;
+}
+
+VTKM_CONT
+vtkm::Int32 Camera::GetLatticeHeight() const
+{
+  return (this->SubsetHeight + this->Subsampling - 1) / this->Subsampling;
+}
+
 VTKM_CONT
 void Camera::ResetIsViewDirty()
 {
@@ -659,6 +843,28 @@ struct Camera::CreateRaysFunctor
   }
 };
 
+template <typename Precision>
+struct Camera::ExpandRaysFunctor
+{
+  vtkm::rendering::raytracing::Camera* Self;
+  vtkm::rendering::raytracing::Ray<Precision>& Rays;
+  VTKM_CONT
+  ExpandRaysFunctor(vtkm::rendering::raytracing::Camera* self,
+                    vtkm::rendering::raytracing::Ray<Precision>& rays)
+    : Self(self)
+    , Rays(rays)
+  {
+  }
+
+  template <typename Device>
+  VTKM_CONT bool operator()(Device)
+  {
+    VTKM_IS_DEVICE_ADAPTER_TAG(Device);
+    Self->ExpandSubsampledRaysOnDevice(this->Rays, Device());
+    return true;
+  }
+};
+
 struct Camera::PixelDataFunctor
 {
   vtkm::rendering::raytracing::Camera* Self;
@@ -738,6 +944,91 @@ void Camera::CreateRays(Ray<vtkm::Float64>& rays, const vtkm::cont::CoordinateSy
   vtkm::cont::TryExecute(functor);
 }
 
+VTKM_CONT
+void Camera::ExpandSubsampledRays(Ray<vtkm::Float32>& rays)
+{
+  ExpandRaysFunctor<Float32> functor(this, rays);
+  vtkm::cont::TryExecute(functor);
+}
+
+VTKM_CONT
+void Camera::ExpandSubsampledRays(Ray<vtkm::Float64>& rays)
+{
+  ExpandRaysFunctor<Float64> functor(this, rays);
+  vtkm::cont::TryExecute(functor);
+}
+
+template <typename Precision, typename Device>
+VTKM_CONT void Camera::ExpandSubsampledRaysOnDevice(Ray<Precision>& rays, Device)
+{
+  if (this->Subsampling == 1)
+  {
+    return;
+  }
+
+  const vtkm::Int32 latticeWidth = this->GetLatticeWidth();
+  const vtkm::Id latticeSize = vtkm::Id(latticeWidth) * vtkm::Id(this->GetLatticeHeight());
+  if (rays.NumRays != latticeSize)
+  {
+    throw vtkm::cont::ErrorBadValue(
+      "Camera: rays do not match the subsampled image, they cannot be expanded.");
+  }
+
+  vtkm::cont::Timer<Device> timer;
+  vtkm::cont::ArrayHandle<vtkm::Id> rayOfLattice;
+  rayOfLattice.PrepareForOutput(latticeSize, Device());
+  vtkm::worklet::DispatcherMapField<detail::ScatterLatticeRays, Device>(
+    detail::ScatterLatticeRays(
+      this->Width, this->SubsetMinX, this->SubsetMinY, latticeWidth, this->Subsampling))
+    .Invoke(rays.PixelIdx, rayOfLattice);
+
+  const vtkm::Id size = vtkm::Id(this->SubsetWidth) * vtkm::Id(this->SubsetHeight);
+  vtkm::cont::ArrayHandle<vtkm::Id> sources;
+  vtkm::cont::ArrayHandle<vtkm::Id> pixels;
+  sources.PrepareForOutput(size, Device());
+  pixels.PrepareForOutput(size, Device());
+  vtkm::worklet::DispatcherMapField<detail::ExpandLattice, Device>(
+    detail::ExpandLattice(this->Width,
+                          this->SubsetMinX,
+                          this->SubsetMinY,
+                          this->SubsetWidth,
+                          latticeWidth,
+                          this->Subsampling))
+    .Invoke(sources, pixels, rayOfLattice);
+
+  RayOperations::GatherRays(rays, sources, Device());
+  rays.PixelIdx = pixels;
+
+  Logger::GetInstance()->AddLogData("expand_subsampled", timer.GetElapsedTime());
+}
+
+template <typename Device>
+VTKM_CONT void Camera::UpdatePixelOrder(Device)
+{
+  const vtkm::Int32 latticeWidth = this->GetLatticeWidth();
+  const vtkm::Int32 latticeHeight = this->GetLatticeHeight();
+  if (latticeWidth == this->PixelOrderWidth && latticeHeight == this->PixelOrderHeight)
+  {
+    return;
+  }
+
+  const vtkm::Id size = vtkm::Id(latticeWidth) * vtkm::Id(latticeHeight);
+  vtkm::cont::ArrayHandle<vtkm::UInt64> keys;
+  keys.PrepareForOutput(size, Device());
+  vtkm::worklet::DispatcherMapField<detail::TiledPixelKey, Device>(
+    detail::TiledPixelKey(latticeWidth))
+    .Invoke(keys);
+
+  // assign a new handle since copies of this camera may share the old one
+  vtkm::cont::ArrayHandle<vtkm::Id> pixelOrder;
+  vtkm::cont::DeviceAdapterAlgorithm<Device>::Copy(
+    vtkm::cont::ArrayHandleCounting<vtkm::Id>(0, 1, size), pixelOrder);
+  vtkm::cont::DeviceAdapterAlgorithm<Device>::SortByKey(keys, pixelOrder);
+  this->PixelOrder = pixelOrder;
+  this->PixelOrderWidth = latticeWidth;
+  this->PixelOrderHeight = latticeHeight;
+}
+
 template <typename Precision, typename Device>
 VTKM_CONT void Camera::CreateRaysOnDevice(Ray<Precision>& rays,
                                           Device,
@@ -778,17 +1069,41 @@ VTKM_CONT void Camera::CreateRaysOnDevice(Ray<Precision>& rays,
   //Reset the camera look vector
   this->Look = this->LookAt - this->Position;
   vtkm::Normalize(this->Look);
-  if (ortho)
+  if (this->RayOrder == RAY_ORDER_TILED)
   {
+    this->UpdatePixelOrder(Device());
+    this->GenerateRays(rays, this->PixelOrder, ortho, Device());
+  }
+  else
+  {
+    this->GenerateRays(rays, vtkm::cont::ArrayHandleIndex(rays.NumRays), ortho, Device());
+  }
+
+  time = timer.GetElapsedTime();
+  logger->AddLogData("ray_gen", time);
+  time = createTimer.GetElapsedTime();
+  logger->CloseLogEntry(time);
+} //create rays
 
-    vtkm::worklet::DispatcherMapField<Ortho2DRayGen, Device>(Ortho2DRayGen(this->Width,
-                                                                           this->Height,
-                                                                           this->Zoom,
-                                                                           this->SubsetWidth,
-                                                                           this->SubsetMinX,
-                                                                           this->SubsetMinY,
-                                                                           this->CameraView))
-      .Invoke(rays.DirX,
+template <typename Precision, typename PixelOrderType, typename Device>
+VTKM_CONT void Camera::GenerateRays(Ray<Precision>& rays,
+                                    const PixelOrderType& pixelOrder,
+                                    bool ortho,
+                                    Device)
+{
+  if (ortho)
+  {
+    vtkm::worklet::DispatcherMapField<Ortho2DRayGen, Device>(
+      Ortho2DRayGen(this->Width,
+                    this->Height,
+                    this->Zoom,
+                    this->GetLatticeWidth(),
+                    this->Subsampling,
+                    this->SubsetMinX,
+                    this->SubsetMinY,
+                    this->CameraView))
+      .Invoke(pixelOrder,
+              rays.DirX,
               rays.DirY,
               rays.DirZ,
               rays.OriginX,
@@ -807,10 +1122,12 @@ VTKM_CONT void Camera::CreateRaysOnDevice(Ray<Precision>& rays,
                         this->Look,
                         this->Up,
                         this->Zoom,
-                        this->SubsetWidth,
+                        this->GetLatticeWidth(),
+                        this->Subsampling,
                         this->SubsetMinX,
                         this->SubsetMinY))
-      .Invoke(rays.DirX,
+      .Invoke(pixelOrder,
+              rays.DirX,
               rays.DirY,
               rays.DirZ,
               rays.PixelIdx); //X Y Z
@@ -827,12 +1144,7 @@ VTKM_CONT void Camera::CreateRaysOnDevice(Ray<Precision>& rays,
       MemSet<Precision>(this->Position[2]))
       .Invoke(rays.OriginZ);
   }
-
-  time = timer.GetElapsedTime();
-  logger->AddLogData("ray_gen", time);
-  time = createTimer.GetElapsedTime();
-  logger->CloseLogEntry(time);
-} //create rays
+}
 
 VTKM_CONT
 void Camera::FindSubset(const vtkm::Bounds& bounds)
@@ -995,9 +1307,10 @@ VTKM_CONT void Camera::UpdateDimensions(Ray<Precision>& rays,
   }
 
   // resize rays and buffers
-  if (rays.NumRays != SubsetWidth * SubsetHeight)
+  const vtkm::Int32 numRays = this->GetLatticeWidth() * this->GetLatticeHeight();
+  if (rays.NumRays != numRays)
   {
-    RayOperations::Resize(rays, this->SubsetHeight * this->SubsetWidth, Device());
+    RayOperations::Resize(rays, numRays, Device());
   }
 }
 
@@ -34,11 +34,23 @@ namespace raytracing
 
 class VTKM_RENDERING_EXPORT Camera
 {
+public:
+  // Order in which rays are generated. Scanline order walks the image row
+  // by row. Tiled order walks 8x8 pixel tiles in morton order, and the
+  // pixels inside each tile in morton order, so neighboring rays are close
+  // on screen and tend to visit the same nodes of the acceleration structure.
+  enum RayOrderEnum
+  {
+    RAY_ORDER_SCANLINE,
+    RAY_ORDER_TILED
+  };
 
 private:
   struct PixelDataFunctor;
   template <typename Precision>
   struct CreateRaysFunctor;
+  template <typename Precision>
+  struct ExpandRaysFunctor;
   vtkm::rendering::CanvasRayTracer Canvas;
   vtkm::Int32 Height;
   vtkm::Int32 Width;
@@ -50,6 +62,12 @@ private:
   vtkm::Float32 FovY;
   vtkm::Float32 Zoom;
   bool IsViewDirty;
+  RayOrderEnum RayOrder;
+  vtkm::Int32 Subsampling;
+  // cached pixel order for tiled ray generation
+  vtkm::cont::ArrayHandle<vtkm::Id> PixelOrder;
+  vtkm::Int32 PixelOrderWidth;
+  vtkm::Int32 PixelOrderHeight;
 
   vtkm::Vec<vtkm::Float32, 3> Look;
   vtkm::Vec<vtkm::Float32, 3> Up;
@@ -127,6 +145,23 @@ public:
   VTKM_CONT
   vtkm::Vec<vtkm::Float32, 3> GetLookAt() const;
 
+  VTKM_CONT
+  void SetRayOrder(RayOrderEnum order);
+
+  VTKM_CONT
+  RayOrderEnum GetRayOrder() const;
+
+  /// Only create a ray for every n-th pixel in x and y. This renders a
+  /// coarse preview that costs about 1/n^2 of a full frame. Call
+  /// ExpandSubsampledRays after rendering to copy the result of each ray to
+  /// the n x n block of pixels it stands for. Rendering with a decreasing
+  /// factor (e.g., 4, 2, 1) gives a progressively refined image.
+  VTKM_CONT
+  void SetSubsampling(const vtkm::Int32& factor);
+
+  VTKM_CONT
+  vtkm::Int32 GetSubsampling() const;
+
   VTKM_CONT
   void ResetIsViewDirty();
 
@@ -138,6 +173,14 @@ public:
   VTKM_CONT
   void CreateRays(Ray<vtkm::Float64>& rays, const vtkm::cont::CoordinateSystem& coords);
 
+  /// Replaces rays created with subsampling by one ray per pixel of the
+  /// image subset. Each new ray is a copy of the rendered ray that covers
+  /// its pixel. Does nothing when subsampling is off.
+  VTKM_CONT
+  void ExpandSubsampledRays(Ray<vtkm::Float32>& rays);
+  VTKM_CONT
+  void ExpandSubsampledRays(Ray<vtkm::Float64>& rays);
+
   VTKM_CONT
   void GetPixelData(const vtkm::cont::CoordinateSystem& coords,
                     vtkm::Int32& activePixels,
@@ -160,6 +203,24 @@ private:
   VTKM_CONT
   void FindSubset(const vtkm::Bounds& bounds);
 
+  template <typename Precision, typename DeviceAdapter>
+  VTKM_CONT void ExpandSubsampledRaysOnDevice(Ray<Precision>& rays, DeviceAdapter);
+
+  template <typename DeviceAdapter>
+  VTKM_CONT void UpdatePixelOrder(DeviceAdapter);
+
+  template <typename Precision, typename PixelOrderType, typename DeviceAdapter>
+  VTKM_CONT void GenerateRays(Ray<Precision>& rays,
+                              const PixelOrderType& pixelOrder,
+                              bool ortho,
+                              DeviceAdapter);
+
+  VTKM_CONT
+  vtkm::Int32 GetLatticeWidth() const;
+
+  VTKM_CONT
+  vtkm::Int32 GetLatticeHeight() const;
+
   template <typename DeviceAdapter, typename Precision>
   VTKM_CONT void UpdateDimensions(Ray<Precision>& rays,
                                   DeviceAdapter,
@@ -96,6 +96,36 @@ public:
   }
 }; //class InitBuffer
 
+class GatherBuffer : public vtkm::worklet::WorkletMapField
+{
+protected:
+  const vtkm::Id NumChannels; // the number of channels in the buffer
+
+public:
+  VTKM_CONT
+  GatherBuffer(const vtkm::Int32 numChannels)
+    : NumChannels(numChannels)
+  {
+  }
+  using ControlSignature = void(FieldIn<>, WholeArrayIn<>, WholeArrayOut<>);
+  using ExecutionSignature = void(_1, _2, _3, WorkIndex);
+  template <typename InBufferPortalType, typename OutBufferPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& source,
+                            const InBufferPortalType& inBuffer,
+                            OutBufferPortalType& outBuffer,
+                            const vtkm::Id& index) const
+  {
+    vtkm::Id inIndex = source * NumChannels;
+    vtkm::Id outIndex = index * NumChannels;
+    for (vtkm::Int32 i = 0; i < NumChannels; ++i)
+    {
+      BOUNDS_CHECK(inBuffer, inIndex + i);
+      BOUNDS_CHECK(outBuffer, outIndex + i);
+      outBuffer.Set(outIndex + i, inBuffer.Get(inIndex + i));
+    }
+  }
+}; //class GatherBuffer
+
 
 } // namespace detail
 
@@ -123,6 +153,24 @@ public:
     buffer.Size = newSize;
   }
 
+  // Builds a new buffer whose i-th element is element sources[i] of the
+  // old buffer. The sources do not need to be unique.
+  template <typename Device, typename Precision>
+  static void Gather(ChannelBuffer<Precision>& buffer,
+                     const vtkm::cont::ArrayHandle<vtkm::Id>& sources,
+                     Device)
+  {
+    const vtkm::Id newSize = sources.GetNumberOfValues();
+    vtkm::cont::ArrayHandle<Precision> gatheredBuffer;
+    gatheredBuffer.PrepareForOutput(newSize * buffer.NumChannels, Device());
+
+    vtkm::worklet::DispatcherMapField<detail::GatherBuffer, Device>(
+      detail::GatherBuffer(buffer.NumChannels))
+      .Invoke(sources, buffer.Buffer, gatheredBuffer);
+    buffer.Buffer = gatheredBuffer;
+    buffer.Size = newSize;
+  }
+
   template <typename Device, typename Precision>
   static void InitChannels(ChannelBuffer<Precision>& buffer,
                            vtkm::cont::ArrayHandle<Precision> sourceSignature,
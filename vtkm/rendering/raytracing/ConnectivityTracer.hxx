@@ -1168,8 +1168,11 @@ void ConnectivityTracer<CellType, ConnectivityType>::RenderOnDevice(Ray<FloatTyp
   vtkm::Float64 time = timer.GetElapsedTime();
   logger->AddLogData("init", time);
 
+  timer.Reset();
+  MeshConnReused = MeshConn.GetIsConstructed();
   MeshConn.Construct(Device());
-
+  MeshConnTime = timer.GetElapsedTime();
+  timer.Reset();
 
   bool cullMissedRays = true;
   bool workRemaining = true;
@@ -1257,6 +1260,7 @@ void ConnectivityTracer<CellType, ConnectivityType>::RenderOnDevice(Ray<FloatTyp
       IdentifyMissedRay(rays.DebugWidth, rays.DebugHeight, this->BackgroundColor))
       .Invoke(pCounter, rays.Buffers.at(0).Buffer);
   }
+  TraceTime = timer.GetElapsedTime();
   vtkm::Float64 renderTime = renderTimer.GetElapsedTime();
   this->LogTimers();
   logger->AddLogData("active_pixels", rays.NumRays);
@@ -154,6 +154,9 @@ void ConnectivityTracerBase::ResetTimers()
   SampleTime = 0.;
   LostRayTime = 0.;
   MeshEntryTime = 0.;
+  MeshConnTime = 0.;
+  TraceTime = 0.;
+  MeshConnReused = false;
 }
 
 void ConnectivityTracerBase::LogTimers()
@@ -163,7 +166,10 @@ void ConnectivityTracerBase::LogTimers()
   logger->AddLogData("integrate ", IntegrateTime);
   logger->AddLogData("sample_cells ", SampleTime);
   logger->AddLogData("lost_rays ", LostRayTime);
-  logger->AddLogData("mesh_entry", LostRayTime);
+  logger->AddLogData("mesh_entry", MeshEntryTime);
+  logger->AddLogData("mesh_conn", MeshConnTime);
+  logger->AddLogData("mesh_conn_reused", MeshConnReused ? "true" : "false");
+  logger->AddLogData("trace", TraceTime);
 }
 }
 }
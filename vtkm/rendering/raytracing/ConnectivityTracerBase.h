@@ -92,6 +92,11 @@ protected:
   vtkm::Float64 SampleTime;
   vtkm::Float64 LostRayTime;
   vtkm::Float64 MeshEntryTime;
+  // Building the mesh connectivity and boundary BVH only happens on the first
+  // trace of a tracer; later traces reuse them and only pay for the tracing.
+  vtkm::Float64 MeshConnTime;
+  vtkm::Float64 TraceTime;
+  bool MeshConnReused;
 
   template <typename FloatType, typename Device>
   void PrintRayStatus(Ray<FloatType>& rays, Device)
@@ -20,14 +20,20 @@
 #ifndef vtk_m_rendering_raytracing_Ray_Operations_h
 #define vtk_m_rendering_raytracing_Ray_Operations_h
 
+#include <vtkm/BinaryOperators.h>
 #include <vtkm/Matrix.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
 #include <vtkm/cont/TryExecute.h>
 #include <vtkm/rendering/Camera.h>
 #include <vtkm/rendering/CanvasRayTracer.h>
 #include <vtkm/rendering/raytracing/ChannelBufferOperations.h>
+#include <vtkm/rendering/raytracing/MortonCodes.h>
 #include <vtkm/rendering/raytracing/Ray.h>
 #include <vtkm/rendering/raytracing/Worklets.h>
 
+#include <limits>
+
 namespace vtkm
 {
 namespace rendering
@@ -110,6 +116,49 @@ public:
   }
 }; //class RayMapMinDistances
 
+// Builds a sort key for each ray. The high bits are the morton code of the
+// direction and the low bits are the morton code of the origin inside the
+// bounds of all ray origins, so rays that start near each other and travel
+// in similar directions end up next to each other.
+class RaySortKey : public vtkm::worklet::WorkletMapField
+{
+protected:
+  vtkm::Vec<vtkm::Float32, 3> MinOrigin;
+  vtkm::Vec<vtkm::Float32, 3> InvOriginExtent;
+
+public:
+  VTKM_CONT
+  RaySortKey(const vtkm::Vec<vtkm::Float32, 3>& minOrigin,
+             const vtkm::Vec<vtkm::Float32, 3>& maxOrigin)
+    : MinOrigin(minOrigin)
+  {
+    for (vtkm::Int32 i = 0; i < 3; ++i)
+    {
+      const vtkm::Float32 extent = maxOrigin[i] - minOrigin[i];
+      InvOriginExtent[i] = extent > 0.f ? 1.f / extent : 0.f;
+    }
+  }
+
+  using ControlSignature = void(FieldIn<>, FieldIn<>, FieldOut<>);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  template <typename Precision>
+  VTKM_EXEC void operator()(const vtkm::Vec<Precision, 3>& origin,
+                            const vtkm::Vec<Precision, 3>& dir,
+                            vtkm::UInt64& key) const
+  {
+    vtkm::Float32 dx = static_cast<vtkm::Float32>(dir[0]) * 0.5f + 0.5f;
+    vtkm::Float32 dy = static_cast<vtkm::Float32>(dir[1]) * 0.5f + 0.5f;
+    vtkm::Float32 dz = static_cast<vtkm::Float32>(dir[2]) * 0.5f + 0.5f;
+    vtkm::Float32 ox = (static_cast<vtkm::Float32>(origin[0]) - MinOrigin[0]) * InvOriginExtent[0];
+    vtkm::Float32 oy = (static_cast<vtkm::Float32>(origin[1]) - MinOrigin[1]) * InvOriginExtent[1];
+    vtkm::Float32 oz = (static_cast<vtkm::Float32>(origin[2]) - MinOrigin[2]) * InvOriginExtent[2];
+    const vtkm::UInt64 dirCode = Morton3D(dx, dy, dz);
+    const vtkm::UInt64 originCode = Morton3D(ox, oy, oz);
+    key = (dirCode << 32) | originCode;
+  }
+}; //class RaySortKey
+
 } // namespace detail
 class RayOperations
 {
@@ -281,6 +330,129 @@ public:
     return masks;
   }
 
+  //
+  // Replaces the rays with a new set where ray i is a copy of the
+  // old ray sources[i]. Used to reorder rays and to duplicate them.
+  //
+  template <typename Device, typename T>
+  static void GatherRays(Ray<T>& rays, const vtkm::cont::ArrayHandle<vtkm::Id>& sources, Device)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<Device>;
+    vtkm::cont::ArrayHandle<T> emptyHandle;
+
+    rays.Normal =
+      vtkm::cont::make_ArrayHandleCompositeVector(emptyHandle, emptyHandle, emptyHandle);
+    rays.Origin =
+      vtkm::cont::make_ArrayHandleCompositeVector(emptyHandle, emptyHandle, emptyHandle);
+    rays.Dir = vtkm::cont::make_ArrayHandleCompositeVector(emptyHandle, emptyHandle, emptyHandle);
+    rays.Intersection =
+      vtkm::cont::make_ArrayHandleCompositeVector(emptyHandle, emptyHandle, emptyHandle);
+
+    const vtkm::Int32 numFloatArrays = 18;
+    vtkm::cont::ArrayHandle<T>* floatArrayPointers[numFloatArrays];
+    floatArrayPointers[0] = &rays.OriginX;
+    floatArrayPointers[1] = &rays.OriginY;
+    floatArrayPointers[2] = &rays.OriginZ;
+    floatArrayPointers[3] = &rays.DirX;
+    floatArrayPointers[4] = &rays.DirY;
+    floatArrayPointers[5] = &rays.DirZ;
+    floatArrayPointers[6] = &rays.Distance;
+    floatArrayPointers[7] = &rays.MinDistance;
+    floatArrayPointers[8] = &rays.MaxDistance;
+
+    floatArrayPointers[9] = &rays.Scalar;
+    floatArrayPointers[10] = &rays.IntersectionX;
+    floatArrayPointers[11] = &rays.IntersectionY;
+    floatArrayPointers[12] = &rays.IntersectionZ;
+    floatArrayPointers[13] = &rays.U;
+    floatArrayPointers[14] = &rays.V;
+    floatArrayPointers[15] = &rays.NormalX;
+    floatArrayPointers[16] = &rays.NormalY;
+    floatArrayPointers[17] = &rays.NormalZ;
+
+    const int breakPoint = rays.IntersectionDataEnabled ? -1 : 9;
+    for (int i = 0; i < numFloatArrays; ++i)
+    {
+      if (i == breakPoint)
+      {
+        break;
+      }
+      vtkm::cont::ArrayHandle<T> gathered;
+      Algorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(sources, *floatArrayPointers[i]),
+                      gathered);
+      *floatArrayPointers[i] = gathered;
+    }
+
+    //
+    // restore the composite vectors
+    //
+    rays.Normal =
+      vtkm::cont::make_ArrayHandleCompositeVector(rays.NormalX, rays.NormalY, rays.NormalZ);
+    rays.Origin =
+      vtkm::cont::make_ArrayHandleCompositeVector(rays.OriginX, rays.OriginY, rays.OriginZ);
+    rays.Dir = vtkm::cont::make_ArrayHandleCompositeVector(rays.DirX, rays.DirY, rays.DirZ);
+    rays.Intersection = vtkm::cont::make_ArrayHandleCompositeVector(
+      rays.IntersectionX, rays.IntersectionY, rays.IntersectionZ);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> gatheredHits;
+    Algorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(sources, rays.HitIdx), gatheredHits);
+    rays.HitIdx = gatheredHits;
+
+    vtkm::cont::ArrayHandle<vtkm::Id> gatheredPixels;
+    Algorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(sources, rays.PixelIdx),
+                    gatheredPixels);
+    rays.PixelIdx = gatheredPixels;
+
+    vtkm::cont::ArrayHandle<vtkm::UInt8> gatheredStatus;
+    Algorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(sources, rays.Status), gatheredStatus);
+    rays.Status = gatheredStatus;
+
+    rays.NumRays = sources.GetNumberOfValues();
+
+    const size_t bufferCount = static_cast<size_t>(rays.Buffers.size());
+    for (size_t i = 0; i < bufferCount; ++i)
+    {
+      ChannelBufferOperations::Gather(rays.Buffers[i], sources, Device());
+    }
+  }
+
+  //
+  // Sorts the rays by direction and origin so that rays which are likely
+  // to visit the same parts of the acceleration structure are traced
+  // together. The pixel ids move with the rays.
+  //
+  template <typename Device, typename T>
+  static void SortRays(Ray<T>& rays, Device)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<Device>;
+    if (rays.NumRays < 2)
+    {
+      return;
+    }
+
+    vtkm::Vec<vtkm::Float32, 3> minOrigin;
+    vtkm::Vec<vtkm::Float32, 3> maxOrigin;
+    vtkm::cont::ArrayHandle<T>* origins[3] = { &rays.OriginX, &rays.OriginY, &rays.OriginZ };
+    for (vtkm::Int32 i = 0; i < 3; ++i)
+    {
+      minOrigin[i] = static_cast<vtkm::Float32>(
+        Algorithm::Reduce(*origins[i], std::numeric_limits<T>::max(), vtkm::Minimum()));
+      maxOrigin[i] = static_cast<vtkm::Float32>(
+        Algorithm::Reduce(*origins[i], std::numeric_limits<T>::lowest(), vtkm::Maximum()));
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::UInt64> keys;
+    vtkm::worklet::DispatcherMapField<detail::RaySortKey, Device>(
+      detail::RaySortKey(minOrigin, maxOrigin))
+      .Invoke(rays.Origin, rays.Dir, keys);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> order;
+    Algorithm::Copy(vtkm::cont::ArrayHandleCounting<vtkm::Id>(0, 1, rays.NumRays), order);
+    Algorithm::SortByKey(keys, order);
+
+    GatherRays(rays, order, Device());
+  }
+
   template <typename Device, typename T>
   static void Resize(Ray<T>& rays, const vtkm::Int32 newSize, Device)
   {
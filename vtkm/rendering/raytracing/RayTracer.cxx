@@ -22,6 +22,7 @@
 #include <iostream>
 #include <math.h>
 #include <stdio.h>
+#include <type_traits>
 #include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
 #include <vtkm/cont/ColorTable.h>
 #include <vtkm/cont/Timer.h>
@@ -29,6 +30,7 @@
 
 #include <vtkm/rendering/raytracing/Camera.h>
 #include <vtkm/rendering/raytracing/Logger.h>
+#include <vtkm/rendering/raytracing/RayOperations.h>
 #include <vtkm/rendering/raytracing/RayTracingTypeDefs.h>
 #include <vtkm/rendering/raytracing/TriangleIntersector.h>
 #include <vtkm/worklet/DispatcherMapField.h>
@@ -44,6 +46,18 @@ namespace raytracing
 namespace detail
 {
 
+// The wide BVH traversal is tuned for CPU vector units. GPUs keep the
+// binary traversal.
+template <typename Device>
+struct UseWideBVH : std::true_type
+{
+};
+
+template <>
+struct UseWideBVH<vtkm::cont::DeviceAdapterTagCuda> : std::false_type
+{
+};
+
 class IntersectionPoint : public vtkm::worklet::WorkletMapField
 {
 public:
@@ -383,6 +397,7 @@ public:
 } // namespace detail
 
 RayTracer::RayTracer()
+  : SortRays(false)
 {
 }
 
@@ -413,6 +428,26 @@ void RayTracer::SetColorMap(const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float3
   ColorMap = colorMap;
 }
 
+void RayTracer::SetBuildMode(LinearBVH::BuildModeEnum mode)
+{
+  Bvh.SetBuildMode(mode);
+}
+
+LinearBVH::BuildModeEnum RayTracer::GetBuildMode() const
+{
+  return Bvh.GetBuildMode();
+}
+
+void RayTracer::SetSortRays(bool on)
+{
+  SortRays = on;
+}
+
+bool RayTracer::GetSortRays() const
+{
+  return SortRays;
+}
+
 template <typename Precision>
 struct RayTracer::RenderFunctor
 {
@@ -471,9 +506,24 @@ void RayTracer::RenderOnDevice(Ray<Precision>& rays, Device)
   if (NumberOfTriangles > 0)
   {
     vtkm::cont::Timer<Device> timer;
+    if (SortRays)
+    {
+      RayOperations::SortRays(rays, Device());
+      time = timer.GetElapsedTime();
+      logger->AddLogData("sort_rays", time);
+      timer.Reset();
+    }
+
     // Find distance to intersection
     TriangleIntersector<Device, TriLeafIntersector<Moller>> intersector;
-    intersector.run(rays, Bvh, CoordsHandle);
+    if (detail::UseWideBVH<Device>::value)
+    {
+      intersector.runWide(rays, Bvh, CoordsHandle);
+    }
+    else
+    {
+      intersector.run(rays, Bvh, CoordsHandle);
+    }
     time = timer.GetElapsedTime();
     logger->AddLogData("intersect", time);
     timer.Reset();
@@ -45,6 +45,7 @@ protected:
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> ColorMap;
   vtkm::Range ScalarRange;
   vtkm::Bounds DataBounds;
+  bool SortRays;
   template <typename Precision>
   struct RenderFunctor;
 
@@ -69,6 +70,21 @@ public:
   VTKM_CONT
   void SetColorMap(const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& colorMap);
 
+  /// Selects how the acceleration structure is built. See LinearBVH.
+  VTKM_CONT
+  void SetBuildMode(LinearBVH::BuildModeEnum mode);
+
+  VTKM_CONT
+  LinearBVH::BuildModeEnum GetBuildMode() const;
+
+  /// When on, rays are sorted by direction and origin before traversal so
+  /// that coherent rays are traced together. Off by default.
+  VTKM_CONT
+  void SetSortRays(bool on);
+
+  VTKM_CONT
+  bool GetSortRays() const;
+
   void Render(vtkm::rendering::raytracing::Ray<vtkm::Float32>& rays);
   void Render(vtkm::rendering::raytracing::Ray<vtkm::Float64>& rays);
 
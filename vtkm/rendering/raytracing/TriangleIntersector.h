@@ -74,7 +74,10 @@ public:
 
     intersector.IntersectTri(a, b, c, dirx, diry, dirz, distance, u, v, originX, originY, originZ);
 
-    if (distance != -1. && distance < closestDistance && distance > minDistance)
+    // Equal distances go to the lower leaf index, so the hit does not depend
+    // on the order in which the tree is traversed.
+    if (distance != -1. && distance > minDistance &&
+        (distance < closestDistance || (distance == closestDistance && currentNode < hitIndex)))
     {
       closestDistance = distance;
       minU = u;
@@ -669,6 +672,72 @@ VTKM_EXEC inline bool IntersectAABB(const BVHPortalType& bvh,
   return (min0 > min1);
 }
 
+// Intersects the four children of a WideBVH node. The hit children are
+// written to children ordered from nearest to farthest and their count is
+// returned.
+template <typename BVHPortalType, typename RayPrecision>
+VTKM_EXEC inline vtkm::Int32 IntersectWideAABB(const BVHPortalType& bvh,
+                                               const vtkm::Int32& currentNode,
+                                               const RayPrecision& originDirX,
+                                               const RayPrecision& originDirY,
+                                               const RayPrecision& originDirZ,
+                                               const RayPrecision& invDirx,
+                                               const RayPrecision& invDiry,
+                                               const RayPrecision& invDirz,
+                                               const RayPrecision& closestDistance,
+                                               const RayPrecision& minDistance,
+                                               vtkm::Int32 children[4])
+{
+  const vtkm::Vec<vtkm::Float32, 4> xmins = bvh.Get(currentNode);
+  const vtkm::Vec<vtkm::Float32, 4> ymins = bvh.Get(currentNode + 1);
+  const vtkm::Vec<vtkm::Float32, 4> zmins = bvh.Get(currentNode + 2);
+  const vtkm::Vec<vtkm::Float32, 4> xmaxs = bvh.Get(currentNode + 3);
+  const vtkm::Vec<vtkm::Float32, 4> ymaxs = bvh.Get(currentNode + 4);
+  const vtkm::Vec<vtkm::Float32, 4> zmaxs = bvh.Get(currentNode + 5);
+  const vtkm::Vec<vtkm::Float32, 4> pointers = bvh.Get(currentNode + 6);
+
+  RayPrecision near[4];
+  bool hit[4];
+  VTKM_VECTORIZATION_PRE_LOOP
+  for (vtkm::Int32 i = 0; i < 4; ++i)
+  {
+    VTKM_VECTORIZATION_IN_LOOP
+    const RayPrecision xmin = xmins[i] * invDirx - originDirX;
+    const RayPrecision ymin = ymins[i] * invDiry - originDirY;
+    const RayPrecision zmin = zmins[i] * invDirz - originDirZ;
+    const RayPrecision xmax = xmaxs[i] * invDirx - originDirX;
+    const RayPrecision ymax = ymaxs[i] * invDiry - originDirY;
+    const RayPrecision zmax = zmaxs[i] * invDirz - originDirZ;
+    near[i] = vtkm::Max(
+      vtkm::Max(vtkm::Max(vtkm::Min(ymin, ymax), vtkm::Min(xmin, xmax)), vtkm::Min(zmin, zmax)),
+      minDistance);
+    const RayPrecision far = vtkm::Min(
+      vtkm::Min(vtkm::Min(vtkm::Max(ymin, ymax), vtkm::Max(xmin, xmax)), vtkm::Max(zmin, zmax)),
+      closestDistance);
+    hit[i] = (far >= near[i]);
+  }
+
+  vtkm::Int32 count = 0;
+  RayPrecision distances[4];
+  for (vtkm::Int32 i = 0; i < 4; ++i)
+  {
+    vtkm::Int32 child;
+    memcpy(&child, &pointers[i], 4);
+    if (!hit[i] || child == 0)
+      continue;
+    vtkm::Int32 j = count++;
+    while (j > 0 && distances[j - 1] > near[i])
+    {
+      distances[j] = distances[j - 1];
+      children[j] = children[j - 1];
+      --j;
+    }
+    distances[j] = near[i];
+    children[j] = child;
+  }
+  return count;
+}
+
 template <typename T>
 VTKM_EXEC inline void swap(T& a, T& b)
 {
@@ -867,6 +936,144 @@ public:
         distance = closestDistance;
     } // ()
   };
+  // Same as Intersector, but traverses the four wide LinearBVH::WideBVH. The
+  // four child boxes of a node are tested together, which maps well onto
+  // the vector units of CPUs.
+  class WideIntersector : public vtkm::worklet::WorkletMapField
+  {
+  private:
+    LeafIntesectorType LeafIntersector;
+    Float4ArrayPortal WideBVH;
+    Int4ArrayPortal Leafs;
+    VTKM_EXEC
+    inline vtkm::Float32 rcp(vtkm::Float32 f) const { return 1.0f / f; }
+    VTKM_EXEC
+    inline vtkm::Float32 rcp_safe(vtkm::Float32 f) const
+    {
+      return rcp((fabs(f) < 1e-8f) ? 1e-8f : f);
+    }
+    VTKM_EXEC
+    inline vtkm::Float64 rcp(vtkm::Float64 f) const { return 1.0 / f; }
+    VTKM_EXEC
+    inline vtkm::Float64 rcp_safe(vtkm::Float64 f) const
+    {
+      return rcp((fabs(f) < 1e-8f) ? 1e-8f : f);
+    }
+
+  public:
+    VTKM_CONT
+    WideIntersector(LinearBVH& bvh)
+      : WideBVH(bvh.WideBVH.PrepareForInput(Device()))
+      , Leafs(bvh.LeafNodes.PrepareForInput(Device()))
+    {
+    }
+    using ControlSignature = void(FieldIn<>,
+                                  FieldIn<>,
+                                  FieldOut<>,
+                                  FieldIn<>,
+                                  FieldIn<>,
+                                  FieldOut<>,
+                                  FieldOut<>,
+                                  FieldOut<>,
+                                  WholeArrayIn<Vec3RenderingTypes>);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, _9);
+
+    template <typename PointPortalType, typename Precision>
+    VTKM_EXEC void operator()(const vtkm::Vec<Precision, 3>& rayDir,
+                              const vtkm::Vec<Precision, 3>& rayOrigin,
+                              Precision& distance,
+                              const Precision& minDistance,
+                              const Precision& maxDistance,
+                              Precision& minU,
+                              Precision& minV,
+                              vtkm::Id& hitIndex,
+                              const PointPortalType& points) const
+    {
+      Precision closestDistance = maxDistance;
+      distance = maxDistance;
+      hitIndex = -1;
+      Precision dirx = rayDir[0];
+      Precision diry = rayDir[1];
+      Precision dirz = rayDir[2];
+
+      Precision invDirx = rcp_safe(dirx);
+      Precision invDiry = rcp_safe(diry);
+      Precision invDirz = rcp_safe(dirz);
+
+      // up to three children are pushed per node
+      vtkm::Int32 todo[128];
+      vtkm::Int32 stackptr = 0;
+      vtkm::Int32 barrier = END_FLAG2;
+      vtkm::Int32 currentNode = 0;
+
+      todo[stackptr] = barrier;
+
+      Precision originX = rayOrigin[0];
+      Precision originY = rayOrigin[1];
+      Precision originZ = rayOrigin[2];
+      Precision originDirX = originX * invDirx;
+      Precision originDirY = originY * invDiry;
+      Precision originDirZ = originZ * invDirz;
+      while (currentNode != END_FLAG2)
+      {
+        if (currentNode > -1)
+        {
+          vtkm::Int32 children[4];
+          vtkm::Int32 hitCount = IntersectWideAABB(WideBVH,
+                                                   currentNode,
+                                                   originDirX,
+                                                   originDirY,
+                                                   originDirZ,
+                                                   invDirx,
+                                                   invDiry,
+                                                   invDirz,
+                                                   closestDistance,
+                                                   minDistance,
+                                                   children);
+          if (hitCount == 0)
+          {
+            currentNode = todo[stackptr];
+            stackptr--;
+          }
+          else
+          {
+            // visit the nearest child next and the others from near to far
+            for (vtkm::Int32 i = hitCount - 1; i > 0; --i)
+            {
+              stackptr++;
+              todo[stackptr] = children[i];
+            }
+            currentNode = children[0];
+          }
+        } // if inner node
+
+        if (currentNode < 0 && currentNode != barrier)
+        {
+          currentNode = -currentNode - 1; //swap the neg address
+          LeafIntersector.IntersectLeaf(currentNode,
+                                        originX,
+                                        originY,
+                                        originZ,
+                                        dirx,
+                                        diry,
+                                        dirz,
+                                        points,
+                                        hitIndex,
+                                        closestDistance,
+                                        minU,
+                                        minV,
+                                        Leafs,
+                                        minDistance);
+          currentNode = todo[stackptr];
+          stackptr--;
+        } // if leaf node
+
+      } //while
+      if (hitIndex != -1)
+        distance = closestDistance;
+    } // ()
+  }; //class WideIntersector
+
   template <typename Precision>
   class IntersectorHitIndex : public vtkm::worklet::WorkletMapField
   {
@@ -1061,6 +1268,24 @@ public:
               coordsHandle);
   }
 
+  // Intersects using LinearBVH::WideBVH, collapsing the tree if needed. Hits
+  // are identical to run.
+  template <typename DynamicCoordType, typename Precision>
+  VTKM_CONT void runWide(Ray<Precision>& rays, LinearBVH& bvh, DynamicCoordType coordsHandle)
+  {
+    bvh.ConstructWide();
+    vtkm::worklet::DispatcherMapField<WideIntersector, Device>(WideIntersector(bvh))
+      .Invoke(rays.Dir,
+              rays.Origin,
+              rays.Distance,
+              rays.MinDistance,
+              rays.MaxDistance,
+              rays.U,
+              rays.V,
+              rays.HitIdx,
+              coordsHandle);
+  }
+
   template <typename DynamicCoordType, typename Precision>
   VTKM_CONT void runHitOnly(Ray<Precision>& rays,
                             LinearBVH& bvh,
@@ -304,9 +304,205 @@ public:
 
 }; // class UniformLocator
 
+// Number of cells along each axis of a macro cell
+constexpr vtkm::Id MACRO_CELL_SIZE = 8;
+
+template <typename Device>
+class EmptySpaceSkipper
+{
+protected:
+  using EmptyHandle = vtkm::cont::ArrayHandle<vtkm::UInt8>;
+  using EmptyConstPortal = typename EmptyHandle::ExecutionTypes<Device>::PortalConst;
+
+  EmptyConstPortal Empty;
+  vtkm::Id3 MacroCellDims;
+  vtkm::Id3 CellDims;
+  bool Enabled;
+
+public:
+  EmptySpaceSkipper(const EmptyHandle& empty,
+                    const vtkm::Id3& macroCellDims,
+                    const vtkm::Id3& cellDims,
+                    bool enabled)
+    : Empty(empty.PrepareForInput(Device()))
+    , MacroCellDims(macroCellDims)
+    , CellDims(cellDims)
+    , Enabled(enabled)
+  {
+  }
+
+  VTKM_EXEC
+  inline bool IsEmpty(const vtkm::Vec<vtkm::Id, 3>& cell) const
+  {
+    if (!Enabled)
+      return false;
+    const vtkm::Id index =
+      ((cell[2] / MACRO_CELL_SIZE) * MacroCellDims[1] + cell[1] / MACRO_CELL_SIZE) *
+        MacroCellDims[0] +
+      cell[0] / MACRO_CELL_SIZE;
+    return Empty.Get(index) != 0;
+  }
+
+  // Distance along the ray at which it leaves the macro cell containing cell
+  template <typename LocatorType>
+  VTKM_EXEC inline vtkm::Float32 ExitDistance(const vtkm::Vec<vtkm::Id, 3>& cell,
+                                              const vtkm::Vec<vtkm::Float32, 3>& rayOrigin,
+                                              const vtkm::Vec<vtkm::Float32, 3>& rayDir,
+                                              const LocatorType& locator) const
+  {
+    vtkm::Vec<vtkm::Id, 3> minCorner;
+    vtkm::Vec<vtkm::Id, 3> maxCorner;
+    for (vtkm::Int32 dim = 0; dim < 3; ++dim)
+    {
+      minCorner[dim] = (cell[dim] / MACRO_CELL_SIZE) * MACRO_CELL_SIZE;
+      maxCorner[dim] = vtkm::Min(minCorner[dim] + MACRO_CELL_SIZE, CellDims[dim]);
+    }
+    vtkm::Vec<vtkm::Float32, 3> minPoint;
+    vtkm::Vec<vtkm::Float32, 3> maxPoint;
+    locator.GetMinPoint(minCorner, minPoint);
+    locator.GetMinPoint(maxCorner, maxPoint);
+
+    vtkm::Float32 exit = vtkm::Infinity32();
+    for (vtkm::Int32 dim = 0; dim < 3; ++dim)
+    {
+      if (rayDir[dim] == 0.f)
+        continue;
+      const vtkm::Float32 invDir = 1.f / rayDir[dim];
+      const vtkm::Float32 t0 = (minPoint[dim] - rayOrigin[dim]) * invDir;
+      const vtkm::Float32 t1 = (maxPoint[dim] - rayOrigin[dim]) * invDir;
+      exit = vtkm::Min(exit, vtkm::Max(t0, t1));
+    }
+    return exit;
+  }
+}; // class EmptySpaceSkipper
 
 } //namespace
 
+// Computes the scalar range of each macro cell. Point fields include the
+// points on the far faces of the macro cell, so the range bounds every value
+// interpolated inside it.
+class MacroCellRange : public vtkm::worklet::WorkletMapField
+{
+  vtkm::Id3 MacroCellDims;
+  vtkm::Id3 CellDims;
+  bool IsAssocPoints;
+
+public:
+  VTKM_CONT
+  MacroCellRange(const vtkm::Id3& macroCellDims, const vtkm::Id3& cellDims, bool isAssocPoints)
+    : MacroCellDims(macroCellDims)
+    , CellDims(cellDims)
+    , IsAssocPoints(isAssocPoints)
+  {
+  }
+
+  using ControlSignature = void(FieldOut<>, WholeArrayIn<ScalarRenderingTypes>);
+  using ExecutionSignature = void(WorkIndex, _1, _2);
+
+  template <typename ScalarPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& macroCell,
+                            vtkm::Vec<vtkm::Float32, 2>& range,
+                            const ScalarPortalType& scalars) const
+  {
+    vtkm::Id3 macroIndex;
+    macroIndex[0] = macroCell % MacroCellDims[0];
+    macroIndex[1] = (macroCell / MacroCellDims[0]) % MacroCellDims[1];
+    macroIndex[2] = macroCell / (MacroCellDims[0] * MacroCellDims[1]);
+
+    vtkm::Id3 dims = CellDims;
+    vtkm::Id3 first;
+    vtkm::Id3 last;
+    for (vtkm::Int32 dim = 0; dim < 3; ++dim)
+    {
+      first[dim] = macroIndex[dim] * MACRO_CELL_SIZE;
+      last[dim] = vtkm::Min(first[dim] + MACRO_CELL_SIZE, CellDims[dim]);
+      if (IsAssocPoints)
+      {
+        dims[dim] += 1;
+      }
+      else
+      {
+        last[dim] -= 1;
+      }
+    }
+
+    range[0] = vtkm::Infinity32();
+    range[1] = vtkm::NegativeInfinity32();
+    for (vtkm::Id k = first[2]; k <= last[2]; ++k)
+    {
+      for (vtkm::Id j = first[1]; j <= last[1]; ++j)
+      {
+        for (vtkm::Id i = first[0]; i <= last[0]; ++i)
+        {
+          const vtkm::Float32 scalar =
+            static_cast<vtkm::Float32>(scalars.Get((k * dims[1] + j) * dims[0] + i));
+          range[0] = vtkm::Min(range[0], scalar);
+          range[1] = vtkm::Max(range[1], scalar);
+        }
+      }
+    }
+  }
+}; //class MacroCellRange
+
+// Flags macro cells whose whole scalar range maps to fully transparent
+// color map entries. OpaqueCount holds the running count of color map
+// entries with non zero opacity.
+template <typename Device>
+class FlagEmptyMacroCells : public vtkm::worklet::WorkletMapField
+{
+  using CountHandle = vtkm::cont::ArrayHandle<vtkm::Id>;
+  using CountPortal = typename CountHandle::ExecutionTypes<Device>::PortalConst;
+
+  CountPortal OpaqueCount;
+  vtkm::Id ColorMapSize;
+  vtkm::Float32 MinScalar;
+  vtkm::Float32 InverseDeltaScalar;
+
+  VTKM_EXEC
+  inline vtkm::Id ColorIndex(const vtkm::Float32& scalar) const
+  {
+    const vtkm::Float32 normalized = (scalar - MinScalar) * InverseDeltaScalar;
+    return static_cast<vtkm::Id>(normalized * static_cast<vtkm::Float32>(ColorMapSize));
+  }
+
+public:
+  VTKM_CONT
+  FlagEmptyMacroCells(const CountHandle& opaqueCount,
+                      const vtkm::Id& colorMapSize,
+                      const vtkm::Float32& minScalar,
+                      const vtkm::Float32& maxScalar)
+    : OpaqueCount(opaqueCount.PrepareForInput(Device()))
+    , ColorMapSize(colorMapSize - 1)
+    , MinScalar(minScalar)
+  {
+    // matches the samplers
+    if ((maxScalar - minScalar) != 0.f)
+      InverseDeltaScalar = 1.f / (maxScalar - minScalar);
+    else
+      InverseDeltaScalar = minScalar;
+  }
+
+  using ControlSignature = void(FieldIn<>, FieldOut<>);
+  using ExecutionSignature = void(_1, _2);
+
+  VTKM_EXEC
+  void operator()(const vtkm::Vec<vtkm::Float32, 2>& range, vtkm::UInt8& empty) const
+  {
+    vtkm::Id first = ColorIndex(range[0]);
+    vtkm::Id last = ColorIndex(range[1]);
+    if (first > last)
+    {
+      vtkm::Id temp = first;
+      first = last;
+      last = temp;
+    }
+    // pad by one entry to absorb interpolation round off
+    first = vtkm::Max(vtkm::Id(0), vtkm::Min(first - 1, ColorMapSize));
+    last = vtkm::Max(vtkm::Id(0), vtkm::Min(last + 1, ColorMapSize));
+    empty = (OpaqueCount.Get(last + 1) - OpaqueCount.Get(first)) == 0 ? 1 : 0;
+  }
+}; //class FlagEmptyMacroCells
+
 
 template <typename Device, typename LocatorType>
 class Sampler : public vtkm::worklet::WorkletMapField
@@ -319,7 +515,9 @@ private:
   vtkm::Float32 MinScalar;
   vtkm::Float32 SampleDistance;
   vtkm::Float32 InverseDeltaScalar;
+  vtkm::Float32 TerminationAlpha;
   LocatorType Locator;
+  EmptySpaceSkipper<Device> Skipper;
 
 public:
   VTKM_CONT
@@ -327,11 +525,15 @@ public:
           const vtkm::Float32& minScalar,
           const vtkm::Float32& maxScalar,
           const vtkm::Float32& sampleDistance,
-          const LocatorType& locator)
+          const vtkm::Float32& terminationAlpha,
+          const LocatorType& locator,
+          const EmptySpaceSkipper<Device>& skipper)
     : ColorMap(colorMap.PrepareForInput(Device()))
     , MinScalar(minScalar)
     , SampleDistance(sampleDistance)
+    , TerminationAlpha(terminationAlpha)
     , Locator(locator)
+    , Skipper(skipper)
   {
     ColorMapSize = colorMap.GetNumberOfValues() - 1;
     if ((maxScalar - minScalar) != 0.f)
@@ -423,6 +625,16 @@ public:
 
         vtkm::Vec<vtkm::Id, 8> cellIndices;
         Locator.LocateCell(cell, sampleLocation, invSpacing);
+        if (Skipper.IsEmpty(cell))
+        {
+          // jump to the first sample past the macro cell, staying on the
+          // same sample positions as without skipping
+          vtkm::Float32 exit = Skipper.ExitDistance(cell, rayOrigin, rayDir, Locator);
+          vtkm::Float32 steps = vtkm::Ceil((exit - distance) / SampleDistance);
+          distance += vtkm::Max(1.f, steps) * SampleDistance;
+          sampleLocation = rayOrigin + distance * rayDir;
+          continue;
+        }
         Locator.GetCellIndices(cell, cellIndices);
         Locator.GetPoint(cellIndices[0], bottomLeft);
 
@@ -484,7 +696,7 @@ public:
       ty = (sampleLocation[1] - bottomLeft[1]) * invSpacing[1];
       tz = (sampleLocation[2] - bottomLeft[2]) * invSpacing[2];
 
-      if (color[3] >= 1.f)
+      if (color[3] >= TerminationAlpha)
         break;
     }
 
@@ -515,7 +727,9 @@ private:
   vtkm::Float32 MinScalar;
   vtkm::Float32 SampleDistance;
   vtkm::Float32 InverseDeltaScalar;
+  vtkm::Float32 TerminationAlpha;
   LocatorType Locator;
+  EmptySpaceSkipper<Device> Skipper;
 
 public:
   VTKM_CONT
@@ -523,11 +737,15 @@ public:
                    const vtkm::Float32& minScalar,
                    const vtkm::Float32& maxScalar,
                    const vtkm::Float32& sampleDistance,
-                   const LocatorType& locator)
+                   const vtkm::Float32& terminationAlpha,
+                   const LocatorType& locator,
+                   const EmptySpaceSkipper<Device>& skipper)
     : ColorMap(colorMap.PrepareForInput(Device()))
     , MinScalar(minScalar)
     , SampleDistance(sampleDistance)
+    , TerminationAlpha(terminationAlpha)
     , Locator(locator)
+    , Skipper(skipper)
   {
     ColorMapSize = colorMap.GetNumberOfValues() - 1;
     if ((maxScalar - minScalar) != 0.f)
@@ -605,6 +823,14 @@ public:
       if (newCell)
       {
         Locator.LocateCell(cell, sampleLocation, invSpacing);
+        if (Skipper.IsEmpty(cell))
+        {
+          vtkm::Float32 exit = Skipper.ExitDistance(cell, rayOrigin, rayDir, Locator);
+          vtkm::Float32 steps = vtkm::Ceil((exit - distance) / SampleDistance);
+          distance += vtkm::Max(1.f, steps) * SampleDistance;
+          sampleLocation = rayOrigin + distance * rayDir;
+          continue;
+        }
         vtkm::Id cellId = Locator.GetCellIndex(cell);
 
         scalar0 = vtkm::Float32(scalars.Get(cellId));
@@ -633,7 +859,7 @@ public:
       distance += SampleDistance;
       sampleLocation = sampleLocation + SampleDistance * rayDir;
 
-      if (color[3] >= 1.f)
+      if (color[3] >= TerminationAlpha)
         break;
       tx = (sampleLocation[0] - bottomLeft[0]) * invSpacing[0];
       ty = (sampleLocation[1] - bottomLeft[1]) * invSpacing[1];
@@ -736,12 +962,23 @@ VolumeRendererStructured::VolumeRendererStructured()
   IsSceneDirty = false;
   IsUniformDataSet = true;
   SampleDistance = -1.f;
+  EmptySpaceSkipping = true;
+  EarlyTerminationAlpha = 1.f;
+  IsMacroCellRangeDirty = true;
+  IsMacroCellEmptyDirty = true;
+  MacroCellDims = vtkm::Id3(0, 0, 0);
 }
 
 void VolumeRendererStructured::SetColorMap(
   const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& colorMap)
 {
-  ColorMap = colorMap;
+  // mappers set their color map every frame, so only a different array
+  // invalidates the empty flags
+  if (colorMap != ColorMap)
+  {
+    ColorMap = colorMap;
+    IsMacroCellEmptyDirty = true;
+  }
 }
 
 void VolumeRendererStructured::SetData(const vtkm::cont::CoordinateSystem& coords,
@@ -749,14 +986,83 @@ void VolumeRendererStructured::SetData(const vtkm::cont::CoordinateSystem& coord
                                        const vtkm::cont::CellSetStructured<3>& cellset,
                                        const vtkm::Range& scalarRange)
 {
-  if (coords.GetData().IsSameType(CartesianArrayHandle()))
-    IsUniformDataSet = false;
+  IsUniformDataSet = !coords.GetData().IsSameType(CartesianArrayHandle());
   IsSceneDirty = true;
   SpatialExtent = coords.GetBounds();
   Coordinates = coords.GetData();
   ScalarField = &scalarField;
   Cellset = cellset;
   ScalarRange = scalarRange;
+  IsMacroCellRangeDirty = true;
+  IsMacroCellEmptyDirty = true;
+}
+
+void VolumeRendererStructured::EnableEmptySpaceSkipping()
+{
+  EmptySpaceSkipping = true;
+}
+
+void VolumeRendererStructured::DisableEmptySpaceSkipping()
+{
+  EmptySpaceSkipping = false;
+}
+
+void VolumeRendererStructured::SetEarlyTerminationAlpha(const vtkm::Float32& alpha)
+{
+  if (alpha <= 0.f || alpha > 1.f)
+    throw vtkm::cont::ErrorBadValue("Early termination alpha must be in (0, 1].");
+  EarlyTerminationAlpha = alpha;
+}
+
+template <typename Device>
+void VolumeRendererStructured::BuildMacroCells(Device)
+{
+  Logger* logger = Logger::GetInstance();
+  const vtkm::Id3 cellDims = Cellset.GetCellDimensions();
+  if (IsMacroCellRangeDirty)
+  {
+    vtkm::cont::Timer<Device> timer;
+    for (vtkm::Int32 dim = 0; dim < 3; ++dim)
+    {
+      MacroCellDims[dim] = (cellDims[dim] + MACRO_CELL_SIZE - 1) / MACRO_CELL_SIZE;
+    }
+    const bool isAssocPoints =
+      ScalarField->GetAssociation() == vtkm::cont::Field::Association::POINTS;
+    MacroCellRanges.PrepareForOutput(MacroCellDims[0] * MacroCellDims[1] * MacroCellDims[2],
+                                     Device());
+    vtkm::worklet::DispatcherMapField<MacroCellRange, Device>(
+      MacroCellRange(MacroCellDims, cellDims, isAssocPoints))
+      .Invoke(MacroCellRanges, *ScalarField);
+    IsMacroCellRangeDirty = false;
+    IsMacroCellEmptyDirty = true;
+    logger->AddLogData("macro_cell_ranges", timer.GetElapsedTime());
+  }
+
+  if (IsMacroCellEmptyDirty)
+  {
+    vtkm::cont::Timer<Device> timer;
+    // the color map is small, so count its opaque entries on the host
+    const vtkm::Id colorMapSize = ColorMap.GetNumberOfValues();
+    vtkm::cont::ArrayHandle<vtkm::Id> opaqueCount;
+    opaqueCount.Allocate(colorMapSize + 1);
+    auto colorPortal = ColorMap.GetPortalConstControl();
+    auto countPortal = opaqueCount.GetPortalControl();
+    countPortal.Set(0, 0);
+    for (vtkm::Id i = 0; i < colorMapSize; ++i)
+    {
+      const vtkm::Id opaque = colorPortal.Get(i)[3] > 0.f ? 1 : 0;
+      countPortal.Set(i + 1, countPortal.Get(i) + opaque);
+    }
+
+    vtkm::worklet::DispatcherMapField<FlagEmptyMacroCells<Device>, Device>(
+      FlagEmptyMacroCells<Device>(opaqueCount,
+                                  colorMapSize,
+                                  vtkm::Float32(ScalarRange.Min),
+                                  vtkm::Float32(ScalarRange.Max)))
+      .Invoke(MacroCellRanges, MacroCellEmpty);
+    IsMacroCellEmptyDirty = false;
+    logger->AddLogData("macro_cell_flags", timer.GetElapsedTime());
+  }
 }
 
 template <typename Precision>
@@ -832,6 +1138,19 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
     throw vtkm::cont::ErrorBadValue("Field not accociated with cell set or points");
   bool isAssocPoints = ScalarField->GetAssociation() == vtkm::cont::Field::Association::POINTS;
 
+  if (EmptySpaceSkipping)
+  {
+    this->BuildMacroCells(Device());
+  }
+  else if (MacroCellEmpty.GetNumberOfValues() == 0)
+  {
+    // the skipper still needs a valid array to prepare
+    MacroCellEmpty.Allocate(0);
+  }
+  EmptySpaceSkipper<Device> skipper(
+    MacroCellEmpty, MacroCellDims, Cellset.GetCellDimensions(), EmptySpaceSkipping);
+  timer.Reset();
+
   if (IsUniformDataSet)
   {
     vtkm::cont::ArrayHandleUniformPointCoordinates vertices;
@@ -845,7 +1164,9 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
                                                 vtkm::Float32(ScalarRange.Min),
                                                 vtkm::Float32(ScalarRange.Max),
                                                 SampleDistance,
-                                                locator))
+                                                EarlyTerminationAlpha,
+                                                locator,
+                                                skipper))
         .Invoke(rays.Dir,
                 rays.Origin,
                 rays.MinDistance,
@@ -860,7 +1181,9 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
                                                          vtkm::Float32(ScalarRange.Min),
                                                          vtkm::Float32(ScalarRange.Max),
                                                          SampleDistance,
-                                                         locator))
+                                                         EarlyTerminationAlpha,
+                                                         locator,
+                                                         skipper))
         .Invoke(rays.Dir,
                 rays.Origin,
                 rays.MinDistance,
@@ -881,7 +1204,9 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
                                                     vtkm::Float32(ScalarRange.Min),
                                                     vtkm::Float32(ScalarRange.Max),
                                                     SampleDistance,
-                                                    locator))
+                                                    EarlyTerminationAlpha,
+                                                    locator,
+                                                    skipper))
         .Invoke(rays.Dir,
                 rays.Origin,
                 rays.MinDistance,
@@ -897,7 +1222,9 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
                                                              vtkm::Float32(ScalarRange.Min),
                                                              vtkm::Float32(ScalarRange.Max),
                                                              SampleDistance,
-                                                             locator))
+                                                             EarlyTerminationAlpha,
+                                                             locator,
+                                                             skipper))
         .Invoke(rays.Dir,
                 rays.Origin,
                 rays.MinDistance,
@@ -24,6 +24,8 @@
 
 #include <vtkm/cont/DataSet.h>
 
+#include <vtkm/rendering/vtkm_rendering_export.h>
+
 #include <vtkm/rendering/raytracing/Ray.h>
 
 namespace vtkm
@@ -33,7 +35,7 @@ namespace rendering
 namespace raytracing
 {
 
-class VolumeRendererStructured
+class VTKM_RENDERING_EXPORT VolumeRendererStructured
 {
 public:
   using DefaultHandle = vtkm::cont::ArrayHandle<vtkm::FloatDefault>;
@@ -49,6 +51,8 @@ public:
   VTKM_CONT
   void DisableCompositeBackground();
 
+  /// The empty macro cell flags are only rebuilt when a different array is
+  /// given, so a color map must not be modified in place once it is set.
   VTKM_CONT
   void SetColorMap(const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& colorMap);
 
@@ -68,9 +72,27 @@ public:
   VTKM_CONT
   void SetSampleDistance(const vtkm::Float32& distance);
 
+  /// Empty space skipping divides the volume into macro cells and records
+  /// which of them are fully transparent under the current color map. Rays
+  /// jump over those macro cells without sampling them. It is enabled by
+  /// default.
+  VTKM_CONT
+  void EnableEmptySpaceSkipping();
+
+  VTKM_CONT
+  void DisableEmptySpaceSkipping();
+
+  /// Rays stop sampling once their accumulated opacity reaches this value.
+  /// The default is 1.0.
+  VTKM_CONT
+  void SetEarlyTerminationAlpha(const vtkm::Float32& alpha);
+
 protected:
   template <typename Precision, typename Device>
   VTKM_CONT void RenderOnDevice(vtkm::rendering::raytracing::Ray<Precision>& rays, Device);
+
+  template <typename Device>
+  VTKM_CONT void BuildMacroCells(Device);
   template <typename Precision>
   struct RenderFunctor;
 
@@ -83,6 +105,16 @@ protected:
   vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> ColorMap;
   vtkm::Float32 SampleDistance;
   vtkm::Range ScalarRange;
+
+  bool EmptySpaceSkipping;
+  vtkm::Float32 EarlyTerminationAlpha;
+  // The scalar range of each macro cell only depends on the field, while the
+  // empty flags also depend on the color map, so they are rebuilt separately.
+  bool IsMacroCellRangeDirty;
+  bool IsMacroCellEmptyDirty;
+  vtkm::Id3 MacroCellDims;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 2>> MacroCellRanges;
+  vtkm::cont::ArrayHandle<vtkm::UInt8> MacroCellEmpty;
 };
 }
 }
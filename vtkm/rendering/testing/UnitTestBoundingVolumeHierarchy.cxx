@@ -0,0 +1,366 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/Math.h>
+#include <vtkm/VectorAnalysis.h>
+#include <vtkm/cont/CoordinateSystem.h>
+#include <vtkm/cont/DeviceAdapter.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/rendering/raytracing/BoundingVolumeHierarchy.h>
+#include <vtkm/rendering/raytracing/Logger.h>
+#include <vtkm/rendering/raytracing/Ray.h>
+#include <vtkm/rendering/raytracing/TriangleIntersector.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using Device = VTKM_DEFAULT_DEVICE_ADAPTER_TAG;
+using LinearBVH = vtkm::rendering::raytracing::LinearBVH;
+using Vec3f = vtkm::Vec<vtkm::Float32, 3>;
+
+const vtkm::Id GRID_DIM = 24;
+const vtkm::Float32 RAY_HEIGHT = 10.f;
+
+// A bumpy height field so that the tree has some structure to split on.
+void MakeHeightField(vtkm::Float32 zOffset,
+                     vtkm::cont::ArrayHandle<Vec3f>& points,
+                     vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>>& triangles)
+{
+  std::vector<Vec3f> pts;
+  for (vtkm::Id j = 0; j < GRID_DIM; ++j)
+  {
+    for (vtkm::Id i = 0; i < GRID_DIM; ++i)
+    {
+      vtkm::Float32 x = static_cast<vtkm::Float32>(i);
+      vtkm::Float32 y = static_cast<vtkm::Float32>(j);
+      pts.push_back(Vec3f(x, y, zOffset + vtkm::Sin(0.5f * x) * vtkm::Cos(0.3f * y)));
+    }
+  }
+  points.Allocate(static_cast<vtkm::Id>(pts.size()));
+  for (std::size_t i = 0; i < pts.size(); ++i)
+  {
+    points.GetPortalControl().Set(static_cast<vtkm::Id>(i), pts[i]);
+  }
+
+  if (triangles.GetNumberOfValues() > 0)
+  {
+    return;
+  }
+  std::vector<vtkm::Vec<vtkm::Id, 4>> tris;
+  for (vtkm::Id j = 0; j < GRID_DIM - 1; ++j)
+  {
+    for (vtkm::Id i = 0; i < GRID_DIM - 1; ++i)
+    {
+      vtkm::Id cell = j * (GRID_DIM - 1) + i;
+      vtkm::Id p0 = j * GRID_DIM + i;
+      tris.push_back(vtkm::Vec<vtkm::Id, 4>(cell, p0, p0 + 1, p0 + GRID_DIM + 1));
+      tris.push_back(vtkm::Vec<vtkm::Id, 4>(cell, p0, p0 + GRID_DIM + 1, p0 + GRID_DIM));
+    }
+  }
+  triangles.Allocate(static_cast<vtkm::Id>(tris.size()));
+  for (std::size_t i = 0; i < tris.size(); ++i)
+  {
+    triangles.GetPortalControl().Set(static_cast<vtkm::Id>(i), tris[i]);
+  }
+}
+
+// Shoots one ray straight down through the middle of each quad and returns
+// the hit distances.
+std::vector<vtkm::Float32> Trace(LinearBVH& bvh,
+                                 const vtkm::cont::CoordinateSystem& coords,
+                                 bool wide = false)
+{
+  bvh.ConstructOnDevice(Device());
+
+  const vtkm::Int32 numRays = static_cast<vtkm::Int32>((GRID_DIM - 1) * (GRID_DIM - 1));
+  vtkm::rendering::raytracing::Ray<vtkm::Float32> rays(numRays, Device());
+  for (vtkm::Id j = 0; j < GRID_DIM - 1; ++j)
+  {
+    for (vtkm::Id i = 0; i < GRID_DIM - 1; ++i)
+    {
+      vtkm::Id ray = j * (GRID_DIM - 1) + i;
+      rays.OriginX.GetPortalControl().Set(ray, static_cast<vtkm::Float32>(i) + 0.3f);
+      rays.OriginY.GetPortalControl().Set(ray, static_cast<vtkm::Float32>(j) + 0.6f);
+      rays.OriginZ.GetPortalControl().Set(ray, RAY_HEIGHT);
+      rays.DirX.GetPortalControl().Set(ray, 0.f);
+      rays.DirY.GetPortalControl().Set(ray, 0.f);
+      rays.DirZ.GetPortalControl().Set(ray, -1.f);
+      rays.MinDistance.GetPortalControl().Set(ray, 0.f);
+      rays.MaxDistance.GetPortalControl().Set(ray, vtkm::Infinity32());
+    }
+  }
+
+  vtkm::rendering::raytracing::TriangleIntersector<
+    Device,
+    vtkm::rendering::raytracing::TriLeafIntersector<vtkm::rendering::raytracing::Moller>>
+    intersector;
+  if (wide)
+  {
+    intersector.runWide(rays, bvh, coords.GetData());
+  }
+  else
+  {
+    intersector.run(rays, bvh, coords.GetData());
+  }
+
+  std::vector<vtkm::Float32> distances;
+  for (vtkm::Id i = 0; i < numRays; ++i)
+  {
+    VTKM_TEST_ASSERT(rays.HitIdx.GetPortalConstControl().Get(i) != -1, "Ray missed geometry");
+    distances.push_back(rays.Distance.GetPortalConstControl().Get(i));
+  }
+  return distances;
+}
+
+void CompareDistances(const std::vector<vtkm::Float32>& a,
+                      const std::vector<vtkm::Float32>& b,
+                      vtkm::Float32 offset)
+{
+  VTKM_TEST_ASSERT(a.size() == b.size(), "Wrong number of rays");
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    VTKM_TEST_ASSERT(test_equal(a[i], b[i] + offset, 0.0001), "Hit distances differ");
+  }
+}
+
+// Checks that every lane of the wide tree bounds the triangles or the lanes
+// of the wide node below it.
+void CheckWideBounds(const LinearBVH& bvh, const vtkm::cont::ArrayHandle<Vec3f>& points)
+{
+  auto wide = bvh.WideBVH.GetPortalConstControl();
+  auto leafs = bvh.LeafNodes.GetPortalConstControl();
+  auto pointPortal = points.GetPortalConstControl();
+  auto contains = [&wide](vtkm::Id node, vtkm::IdComponent lane, const Vec3f& point) {
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      if (point[i] < wide.Get(node + i)[lane] || point[i] > wide.Get(node + i + 3)[lane])
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (vtkm::Id node = 0; node < wide.GetNumberOfValues(); node += 7)
+  {
+    for (vtkm::IdComponent lane = 0; lane < 4; ++lane)
+    {
+      vtkm::Int32 pointer;
+      vtkm::Float32 bits = wide.Get(node + 6)[lane];
+      memcpy(&pointer, &bits, 4);
+      if (pointer < 0)
+      {
+        vtkm::Vec<vtkm::Int32, 4> leaf = leafs.Get(-pointer - 1);
+        for (vtkm::IdComponent i = 1; i < 4; ++i)
+        {
+          VTKM_TEST_ASSERT(contains(node, lane, pointPortal.Get(leaf[i])),
+                           "Wide leaf box misses its triangle");
+        }
+      }
+      else if (pointer > 0)
+      {
+        for (vtkm::IdComponent childLane = 0; childLane < 4; ++childLane)
+        {
+          vtkm::Float32 childBits = wide.Get(pointer + 6)[childLane];
+          vtkm::Int32 childPointer;
+          memcpy(&childPointer, &childBits, 4);
+          if (childPointer == 0)
+          {
+            continue;
+          }
+          Vec3f childMin(wide.Get(pointer)[childLane],
+                         wide.Get(pointer + 1)[childLane],
+                         wide.Get(pointer + 2)[childLane]);
+          Vec3f childMax(wide.Get(pointer + 3)[childLane],
+                         wide.Get(pointer + 4)[childLane],
+                         wide.Get(pointer + 5)[childLane]);
+          VTKM_TEST_ASSERT(contains(node, lane, childMin) && contains(node, lane, childMax),
+                           "Wide inner box misses its children");
+        }
+      }
+    }
+  }
+}
+
+void TestBuildModes()
+{
+  std::cout << "Testing SAH build against morton build" << std::endl;
+  vtkm::cont::ArrayHandle<Vec3f> points;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> triangles;
+  MakeHeightField(0.f, points, triangles);
+  vtkm::cont::CoordinateSystem coords("coords", points);
+
+  LinearBVH morton(coords.GetData(), triangles, coords.GetBounds());
+  VTKM_TEST_ASSERT(morton.GetBuildMode() == LinearBVH::BUILD_MORTON, "Wrong default build mode");
+  std::vector<vtkm::Float32> expected = Trace(morton, coords);
+
+  LinearBVH sah(coords.GetData(), triangles, coords.GetBounds());
+  sah.SetBuildMode(LinearBVH::BUILD_SAH);
+  std::vector<vtkm::Float32> result = Trace(sah, coords);
+  VTKM_TEST_ASSERT(sah.LeafCount == triangles.GetNumberOfValues(), "Wrong leaf count");
+  CompareDistances(expected, result, 0.f);
+}
+
+void TestRefit(LinearBVH::BuildModeEnum mode)
+{
+  std::cout << "Testing refit with build mode " << mode << std::endl;
+  vtkm::cont::ArrayHandle<Vec3f> points;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> triangles;
+  MakeHeightField(0.f, points, triangles);
+  vtkm::cont::CoordinateSystem coords("coords", points);
+
+  LinearBVH bvh(coords.GetData(), triangles, coords.GetBounds());
+  bvh.SetBuildMode(mode);
+  std::vector<vtkm::Float32> before = Trace(bvh, coords);
+  CompareDistances(before, Trace(bvh, coords, true), 0.f);
+  CheckWideBounds(bvh, points);
+
+  // move the geometry up, but keep the connectivity
+  vtkm::cont::ArrayHandle<Vec3f> movedPoints;
+  MakeHeightField(2.f, movedPoints, triangles);
+  vtkm::cont::CoordinateSystem movedCoords("coords", movedPoints);
+  bvh.SetData(movedCoords.GetData(), triangles, movedCoords.GetBounds());
+  VTKM_TEST_ASSERT(!bvh.GetIsConstructed(), "BVH should need refitting");
+  vtkm::rendering::raytracing::Logger* logger =
+    vtkm::rendering::raytracing::Logger::GetInstance();
+  logger->Clear();
+  std::vector<vtkm::Float32> after = Trace(bvh, movedCoords, true);
+  CompareDistances(before, after, 2.f);
+  CompareDistances(before, Trace(bvh, movedCoords), 2.f);
+  CheckWideBounds(bvh, movedPoints);
+  // the wide nodes are refit in place rather than collapsed again
+  const std::string log = logger->GetStream().str();
+  VTKM_TEST_ASSERT(log.find("bvh_wide_refit <") != std::string::npos, "Wide BVH was not refit");
+  VTKM_TEST_ASSERT(log.find("bvh_wide <") == std::string::npos, "Wide BVH was collapsed again");
+
+  // the refit bounds must match a full rebuild of the moved geometry
+  LinearBVH rebuilt(movedCoords.GetData(), triangles, movedCoords.GetBounds());
+  rebuilt.SetBuildMode(mode);
+  rebuilt.ConstructOnDevice(Device());
+  VTKM_TEST_ASSERT(rebuilt.FlatBVH.GetNumberOfValues() == bvh.FlatBVH.GetNumberOfValues(),
+                   "Refit changed the tree size");
+  auto refitPortal = bvh.FlatBVH.GetPortalConstControl();
+  auto rebuiltPortal = rebuilt.FlatBVH.GetPortalConstControl();
+  for (vtkm::Id i = 0; i < refitPortal.GetNumberOfValues(); ++i)
+  {
+    // every fourth entry holds the child pointers bit cast to floats
+    if (i % 4 != 3)
+    {
+      VTKM_TEST_ASSERT(test_equal(refitPortal.Get(i), rebuiltPortal.Get(i)),
+                       "Refit bounds differ");
+    }
+  }
+
+  // new connectivity forces a full build
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> newTriangles;
+  MakeHeightField(2.f, movedPoints, newTriangles);
+  bvh.SetData(movedCoords.GetData(), newTriangles, movedCoords.GetBounds());
+  CompareDistances(before, Trace(bvh, movedCoords), 2.f);
+  CompareDistances(before, Trace(bvh, movedCoords, true), 2.f);
+}
+
+void TestWideTraversal(LinearBVH::BuildModeEnum mode)
+{
+  std::cout << "Testing wide traversal with build mode " << mode << std::endl;
+  vtkm::cont::ArrayHandle<Vec3f> points;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 4>> triangles;
+  MakeHeightField(0.f, points, triangles);
+  vtkm::cont::CoordinateSystem coords("coords", points);
+
+  LinearBVH bvh(coords.GetData(), triangles, coords.GetBounds());
+  bvh.SetBuildMode(mode);
+  bvh.ConstructOnDevice(Device());
+
+  // Rays from a point above the surface in many directions, so that some
+  // miss and some hit edges shared by two triangles.
+  const vtkm::Int32 numRays = 64 * 64;
+  vtkm::rendering::raytracing::Ray<vtkm::Float32> rays(numRays, Device());
+  for (vtkm::Id i = 0; i < numRays; ++i)
+  {
+    Vec3f target(static_cast<vtkm::Float32>(i % 64) * 0.5f - 4.f,
+                 static_cast<vtkm::Float32>(i / 64) * 0.5f - 4.f,
+                 0.f);
+    Vec3f origin(11.5f, 11.5f, RAY_HEIGHT);
+    Vec3f dir = vtkm::Normal(target - origin);
+    rays.OriginX.GetPortalControl().Set(i, origin[0]);
+    rays.OriginY.GetPortalControl().Set(i, origin[1]);
+    rays.OriginZ.GetPortalControl().Set(i, origin[2]);
+    rays.DirX.GetPortalControl().Set(i, dir[0]);
+    rays.DirY.GetPortalControl().Set(i, dir[1]);
+    rays.DirZ.GetPortalControl().Set(i, dir[2]);
+    rays.MinDistance.GetPortalControl().Set(i, 0.f);
+    rays.MaxDistance.GetPortalControl().Set(i, vtkm::Infinity32());
+  }
+
+  vtkm::rendering::raytracing::TriangleIntersector<
+    Device,
+    vtkm::rendering::raytracing::TriLeafIntersector<vtkm::rendering::raytracing::Moller>>
+    intersector;
+  intersector.run(rays, bvh, coords.GetData());
+  std::vector<vtkm::Id> hits;
+  std::vector<vtkm::Float32> distances, us, vs;
+  for (vtkm::Id i = 0; i < numRays; ++i)
+  {
+    hits.push_back(rays.HitIdx.GetPortalConstControl().Get(i));
+    distances.push_back(rays.Distance.GetPortalConstControl().Get(i));
+    us.push_back(rays.U.GetPortalConstControl().Get(i));
+    vs.push_back(rays.V.GetPortalConstControl().Get(i));
+  }
+
+  intersector.runWide(rays, bvh, coords.GetData());
+  VTKM_TEST_ASSERT(bvh.WideBVH.GetNumberOfValues() % 7 == 0, "Bad wide node layout");
+  vtkm::Id numHits = 0;
+  for (vtkm::Id i = 0; i < numRays; ++i)
+  {
+    std::size_t index = static_cast<std::size_t>(i);
+    VTKM_TEST_ASSERT(rays.HitIdx.GetPortalConstControl().Get(i) == hits[index],
+                     "Wide traversal hit a different triangle");
+    if (hits[index] == -1)
+    {
+      continue;
+    }
+    numHits++;
+    VTKM_TEST_ASSERT(rays.Distance.GetPortalConstControl().Get(i) == distances[index] &&
+                       rays.U.GetPortalConstControl().Get(i) == us[index] &&
+                       rays.V.GetPortalConstControl().Get(i) == vs[index],
+                     "Wide traversal produced a different hit");
+  }
+  VTKM_TEST_ASSERT(numHits > 0 && numHits < numRays, "Expected both hits and misses");
+}
+
+void TestBoundingVolumeHierarchy()
+{
+  TestBuildModes();
+  TestWideTraversal(LinearBVH::BUILD_MORTON);
+  TestWideTraversal(LinearBVH::BUILD_SAH);
+  TestRefit(LinearBVH::BUILD_MORTON);
+  TestRefit(LinearBVH::BUILD_SAH);
+}
+
+} //namespace
+
+int UnitTestBoundingVolumeHierarchy(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestBoundingVolumeHierarchy);
+}
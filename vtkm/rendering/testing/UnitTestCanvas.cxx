@@ -20,11 +20,81 @@
 
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/rendering/Canvas.h>
+#include <vtkm/rendering/DecodePNG.h>
+#include <vtkm/rendering/WorldAnnotator.h>
 #include <vtkm/rendering/testing/RenderTest.h>
 
+#include <fstream>
+#include <iterator>
+#include <memory>
+
 namespace
 {
 
+std::vector<unsigned char> ReadFile(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios_base::binary);
+  return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+                                    std::istreambuf_iterator<char>());
+}
+
+void SaveTests(const vtkm::rendering::Canvas& canvas)
+{
+  const vtkm::Id width = canvas.GetWidth();
+  const vtkm::Id height = canvas.GetHeight();
+  auto colors = canvas.GetColorBuffer().GetPortalConstControl();
+
+  std::cout << "Testing PNG output" << std::endl;
+  std::future<void> pending = canvas.SaveAsAsync("canvas.png");
+  canvas.SaveAs("canvas_sync.png");
+  pending.get();
+  std::vector<unsigned char> png = ReadFile("canvas.png");
+  VTKM_TEST_ASSERT(png == ReadFile("canvas_sync.png"), "Async and sync PNG files differ");
+  VTKM_TEST_ASSERT(png.size() < static_cast<std::size_t>(width * height),
+                   "PNG file is not compressed");
+
+  std::vector<unsigned char> decoded;
+  unsigned long decodedWidth, decodedHeight;
+  int error =
+    vtkm::rendering::DecodePNG(decoded, decodedWidth, decodedHeight, png.data(), png.size());
+  VTKM_TEST_ASSERT(error == 0, "Could not decode PNG file");
+  VTKM_TEST_ASSERT(decodedWidth == static_cast<unsigned long>(width) &&
+                     decodedHeight == static_cast<unsigned long>(height),
+                   "Wrong PNG image size");
+  for (vtkm::Id y = 0; y < height; ++y)
+  {
+    for (vtkm::Id x = 0; x < width; ++x)
+    {
+      // image files store the top row first
+      vtkm::Vec<vtkm::Float32, 4> color = colors.Get((height - 1 - y) * width + x);
+      std::size_t offset = static_cast<std::size_t>((y * width + x) * 4);
+      for (vtkm::IdComponent c = 0; c < 4; ++c)
+      {
+        VTKM_TEST_ASSERT(decoded[offset + static_cast<std::size_t>(c)] ==
+                           static_cast<unsigned char>(color[c] * 255.f),
+                         "Wrong PNG pixel");
+      }
+    }
+  }
+
+  std::cout << "Testing depth output" << std::endl;
+  canvas.SaveDepthAs("canvas_depth.png");
+  png = ReadFile("canvas_depth.png");
+  error = vtkm::rendering::DecodePNG(
+    decoded, decodedWidth, decodedHeight, png.data(), png.size(), false);
+  VTKM_TEST_ASSERT(error == 0, "Could not decode depth PNG file");
+  VTKM_TEST_ASSERT(decoded.size() == static_cast<std::size_t>(width * height * 2),
+                   "Depth PNG is not 16 bit gray");
+
+  canvas.SaveDepthAsAsync("canvas_depth.raw").get();
+  std::vector<unsigned char> raw = ReadFile("canvas_depth.raw");
+  VTKM_TEST_ASSERT(raw.size() == static_cast<std::size_t>(width * height) * sizeof(vtkm::Float32),
+                   "Wrong raw depth size");
+  auto depths = canvas.GetDepthBuffer().GetPortalConstControl();
+  const vtkm::Float32* rawDepths = reinterpret_cast<const vtkm::Float32*>(raw.data());
+  VTKM_TEST_ASSERT(rawDepths[0] == depths.Get((height - 1) * width), "Wrong raw depth");
+}
+
 void RenderTests()
 {
   vtkm::rendering::Canvas canvas;
@@ -42,11 +112,90 @@ void RenderTests()
   canvas.AddColorBar(colorBarBounds, vtkm::cont::ColorTable("inferno"), false);
   canvas.BlendBackground();
   canvas.SaveAs("canvas.pnm");
+  SaveTests(canvas);
+}
+
+void DrawAnnotations(const vtkm::rendering::Canvas& canvas)
+{
+  canvas.AddLine(-0.8, 0.8, 0.8, 0.8, 1.0f, vtkm::rendering::Color::black);
+  canvas.AddLine(0.8, 0.6, 0.8, -0.8, 1.0f, vtkm::rendering::Color::red);
+  canvas.AddLine(-0.6, -0.6, 0.6, 0.2, 1.0f, vtkm::rendering::Color::blue);
+  canvas.AddText(
+    -0.7f, 0.5f, 0.1f, 0.f, 1.f, -1.f, 0.f, vtkm::rendering::Color::black, "Line 1");
+  canvas.AddText(
+    -0.7f, 0.3f, 0.1f, 0.f, 1.f, -1.f, 0.f, vtkm::rendering::Color::green, "Line 2");
+  canvas.AddText(-0.7f, 0.1f, 0.1f, 30.f, 1.f, -1.f, 0.f, vtkm::rendering::Color::red, "Rotated");
+
+  std::unique_ptr<vtkm::rendering::WorldAnnotator> annotator(canvas.CreateWorldAnnotator());
+  annotator->AddLine(vtkm::make_Vec(-0.8, -0.8, 0.0),
+                     vtkm::make_Vec(-0.2, -0.7, 0.0),
+                     1.0f,
+                     vtkm::rendering::Color::magenta);
+
+  // Overlapping primitives have to be drawn in the order they were added.
+  canvas.AddLine(0.0, 0.9, 0.0, 0.4, 1.0f, vtkm::rendering::Color::red);
+  canvas.AddLine(-0.8, 0.5, 0.0, 0.5, 1.0f, vtkm::rendering::Color::blue);
+  canvas.AddText(
+    -0.7f, 0.3f, 0.1f, 0.f, 1.f, -1.f, 0.f, vtkm::rendering::Color::blue, "Overlap");
+  vtkm::Bounds colorBarBounds(0.2, 0.6, -0.4, -0.2, 0, 0);
+  canvas.AddColorBar(colorBarBounds, vtkm::cont::ColorTable("inferno"), true);
+  canvas.AddLine(0.1, -0.3, 0.7, -0.3, 1.0f, vtkm::rendering::Color::green);
+  canvas.AddText(0.2f, -0.3f, 0.1f, 0.f, 1.f, -1.f, 0.f, vtkm::rendering::Color::white, "Bar");
+}
+
+void BatchedAnnotationTests()
+{
+  std::cout << "Testing batched annotations" << std::endl;
+  vtkm::rendering::Canvas immediate(200, 200);
+  immediate.Clear();
+  immediate.AddLine(-0.9, 0.9, 0.9, -0.9, 1.0f, vtkm::rendering::Color::black);
+  DrawAnnotations(immediate);
+
+  vtkm::rendering::Canvas batched(200, 200);
+  batched.Clear();
+  batched.BeginAnnotations();
+  batched.AddLine(-0.9, 0.9, 0.9, -0.9, 1.0f, vtkm::rendering::Color::black);
+  auto colors = batched.GetColorBuffer().GetPortalConstControl();
+  for (vtkm::Id i = 0; i < colors.GetNumberOfValues(); ++i)
+  {
+    VTKM_TEST_ASSERT(colors.Get(i)[3] == 0.f, "Annotation drawn before EndAnnotations");
+  }
+  DrawAnnotations(batched);
+  batched.EndAnnotations();
+
+  auto expectedColors = immediate.GetColorBuffer().GetPortalConstControl();
+  auto expectedDepths = immediate.GetDepthBuffer().GetPortalConstControl();
+  colors = batched.GetColorBuffer().GetPortalConstControl();
+  auto depths = batched.GetDepthBuffer().GetPortalConstControl();
+  vtkm::Id numberOfDrawnPixels = 0;
+  for (vtkm::Id i = 0; i < colors.GetNumberOfValues(); ++i)
+  {
+    VTKM_TEST_ASSERT(test_equal(colors.Get(i), expectedColors.Get(i)),
+                     "Batched annotations differ in color");
+    VTKM_TEST_ASSERT(depths.Get(i) == expectedDepths.Get(i),
+                     "Batched annotations differ in depth");
+    if (colors.Get(i)[3] > 0.f)
+    {
+      ++numberOfDrawnPixels;
+    }
+  }
+  VTKM_TEST_ASSERT(numberOfDrawnPixels > 500, "Annotations were not drawn");
+
+  // Once the batch has been drawn, annotations are drawn right away again.
+  batched.AddLine(-0.9, -0.9, 0.9, -0.9, 1.0f, vtkm::rendering::Color::black);
+  colors = batched.GetColorBuffer().GetPortalConstControl();
+  VTKM_TEST_ASSERT(colors.Get(10 * 200 + 100)[3] == 1.f, "Line was not drawn right away");
+}
+
+void CanvasTests()
+{
+  RenderTests();
+  BatchedAnnotationTests();
 }
 
 } //namespace
 
 int UnitTestCanvas(int, char* [])
 {
-  return vtkm::cont::testing::Testing::Run(RenderTests);
+  return vtkm::cont::testing::Testing::Run(CanvasTests);
 }
@@ -0,0 +1,176 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/rendering/Canvas.h>
+#include <vtkm/rendering/Compositor.h>
+
+// clang-format off
+VTKM_THIRDPARTY_PRE_INCLUDE
+#include <vtkm/thirdparty/diy/Configure.h>
+#include VTKM_DIY(diy/mpi.hpp)
+VTKM_THIRDPARTY_POST_INCLUDE
+// clang-format on
+
+#include <vector>
+
+namespace
+{
+
+const vtkm::Id Width = 7;
+const vtkm::Id Height = 5;
+const int ImagesPerRank = 3;
+
+vtkm::Float32 PixelDepth(int image, vtkm::Id pixel)
+{
+  return static_cast<vtkm::Float32>((image * 7 + pixel * 3) % 11) / 11.f;
+}
+
+vtkm::Vec<vtkm::Float32, 4> PixelColor(int image, vtkm::Id pixel, int numImages)
+{
+  // premultiplied by an alpha of 0.25
+  const vtkm::Float32 alpha = 0.25f;
+  return vtkm::Vec<vtkm::Float32, 4>(alpha * static_cast<vtkm::Float32>(image) / numImages,
+                                     alpha * static_cast<vtkm::Float32>(pixel) / (Width * Height),
+                                     alpha * 0.5f,
+                                     alpha);
+}
+
+// The visibility order of an image in the alpha blending tests.
+int VisibilityOrder(int image, int numImages)
+{
+  return numImages - 1 - image;
+}
+
+void MakeCanvas(vtkm::rendering::Canvas& canvas, int image, int numImages)
+{
+  canvas.ResizeBuffers(Width, Height);
+  auto colors = canvas.GetColorBuffer().GetPortalControl();
+  auto depths = canvas.GetDepthBuffer().GetPortalControl();
+  for (vtkm::Id i = 0; i < Width * Height; ++i)
+  {
+    colors.Set(i, PixelColor(image, i, numImages));
+    depths.Set(i, PixelDepth(image, i));
+  }
+}
+
+void CheckResult(const vtkm::rendering::Canvas& result,
+                 vtkm::rendering::Compositor::CompositeMode mode,
+                 int numImages)
+{
+  auto colors = result.GetColorBuffer().GetPortalConstControl();
+  auto depths = result.GetDepthBuffer().GetPortalConstControl();
+  VTKM_TEST_ASSERT(colors.GetNumberOfValues() == Width * Height, "Wrong result size");
+
+  for (vtkm::Id i = 0; i < Width * Height; ++i)
+  {
+    vtkm::Vec<vtkm::Float32, 4> color;
+    vtkm::Float32 depth;
+    if (mode == vtkm::rendering::Compositor::DEPTH_TEST)
+    {
+      int front = 0;
+      for (int image = 1; image < numImages; ++image)
+      {
+        if (PixelDepth(image, i) < PixelDepth(front, i))
+        {
+          front = image;
+        }
+      }
+      color = PixelColor(front, i, numImages);
+      depth = PixelDepth(front, i);
+    }
+    else
+    {
+      color = vtkm::Vec<vtkm::Float32, 4>(0.f);
+      depth = 1.f;
+      for (int order = 0; order < numImages; ++order)
+      {
+        const int image = numImages - 1 - order;
+        color = color + PixelColor(image, i, numImages) * (1.f - color[3]);
+        depth = vtkm::Min(depth, PixelDepth(image, i));
+      }
+    }
+    VTKM_TEST_ASSERT(test_equal(colors.Get(i), color), "Wrong composited color");
+    VTKM_TEST_ASSERT(test_equal(depths.Get(i), depth), "Wrong composited depth");
+  }
+}
+
+void TestComposite(vtkm::rendering::Compositor::CompositeMode mode,
+                   vtkm::rendering::Compositor::CompositeAlgorithm algorithm,
+                   vtkm::IdComponent k)
+{
+  diy::mpi::communicator comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  const int numImages = ImagesPerRank * comm.size();
+  if (comm.rank() == 0)
+  {
+    std::cout << "Compositing " << numImages << " images, mode " << mode << ", algorithm "
+              << algorithm << ", k " << k << std::endl;
+  }
+
+  vtkm::rendering::Compositor compositor;
+  compositor.SetCompositeMode(mode);
+  compositor.SetAlgorithm(algorithm);
+  compositor.SetRadixK(k);
+  for (int i = 0; i < ImagesPerRank; ++i)
+  {
+    const int image = comm.rank() * ImagesPerRank + i;
+    vtkm::rendering::Canvas canvas(Width, Height);
+    MakeCanvas(canvas, image, numImages);
+    compositor.AddCanvas(canvas, VisibilityOrder(image, numImages));
+  }
+  VTKM_TEST_ASSERT(compositor.GetNumberOfCanvases() == ImagesPerRank, "Wrong number of canvases");
+
+  vtkm::rendering::Canvas result(1, 1);
+  const bool hasResult = compositor.Composite(result);
+
+  // The result is on the rank of the front-most image.
+  const int resultRank = (mode == vtkm::rendering::Compositor::DEPTH_TEST) ? 0 : comm.size() - 1;
+  VTKM_TEST_ASSERT(hasResult == (comm.rank() == resultRank), "Result on the wrong rank");
+  if (hasResult)
+  {
+    CheckResult(result, mode, numImages);
+  }
+}
+
+void TestCompositor()
+{
+  using Compositor = vtkm::rendering::Compositor;
+  const Compositor::CompositeMode modes[2] = { Compositor::DEPTH_TEST, Compositor::ALPHA_BLEND };
+  for (Compositor::CompositeMode mode : modes)
+  {
+    TestComposite(mode, Compositor::BINARY_SWAP, 2);
+    TestComposite(mode, Compositor::RADIX_K, 2);
+    TestComposite(mode, Compositor::RADIX_K, 3);
+    TestComposite(mode, Compositor::RADIX_K, 8);
+  }
+
+  // a rank without images does not take part in the result
+  Compositor compositor;
+  vtkm::rendering::Canvas result(1, 1);
+  VTKM_TEST_ASSERT(!compositor.Composite(result), "Nothing to composite");
+}
+
+} // anonymous namespace
+
+int UnitTestCompositor(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestCompositor);
+}
@@ -0,0 +1,149 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2016 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2016 UT-Battelle, LLC.
+//  Copyright 2016 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/testing/MakeTestDataSet.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/rendering/Actor.h>
+#include <vtkm/rendering/CanvasRayTracer.h>
+#include <vtkm/rendering/DecodePNG.h>
+#include <vtkm/rendering/ImageDatabase.h>
+#include <vtkm/rendering/MapperRayTracer.h>
+#include <vtkm/rendering/Scene.h>
+
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+
+std::vector<unsigned char> ReadFile(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios_base::binary);
+  return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+                                    std::istreambuf_iterator<char>());
+}
+
+std::vector<std::string> ReadLines(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str());
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+vtkm::rendering::Scene MakeScene(const vtkm::cont::DataSet& dataSet, vtkm::Float64 maxValue)
+{
+  vtkm::rendering::Actor actor(dataSet.GetCellSet(),
+                               dataSet.GetCoordinateSystem(),
+                               dataSet.GetField("pointvar"),
+                               vtkm::cont::ColorTable("inferno"));
+  actor.SetScalarRange(vtkm::Range(0.0, maxValue));
+  vtkm::rendering::Scene scene;
+  scene.AddActor(actor);
+  return scene;
+}
+
+void TestCameraSweep()
+{
+  std::cout << "Testing camera sweep" << std::endl;
+  vtkm::cont::DataSet dataSet = vtkm::cont::testing::MakeTestDataSet().Make3DRegularDataSet0();
+  vtkm::rendering::CanvasRayTracer canvas(64, 48);
+  vtkm::rendering::MapperRayTracer mapper;
+
+  vtkm::rendering::ImageDatabase database("image_database_views.cdb");
+  database.SetCameraSweep(4, 3);
+  VTKM_TEST_ASSERT(database.GetPhi().size() == 4 && database.GetTheta().size() == 3,
+                   "Wrong number of camera positions");
+  VTKM_TEST_ASSERT(test_equal(database.GetPhi()[0], -180.0), "Wrong first phi");
+  VTKM_TEST_ASSERT(test_equal(database.GetTheta()[1], 0.0), "Wrong middle theta");
+  database.AddColorTable("inferno", vtkm::cont::ColorTable("inferno"));
+  database.AddColorTable("cool", vtkm::cont::ColorTable("cool to warm"));
+  database.Render(MakeScene(dataSet, 100.0), mapper, canvas);
+  VTKM_TEST_ASSERT(database.GetNumberOfImages() == 24, "Wrong number of images");
+
+  std::vector<std::string> index = ReadLines(database.GetPath() + "/data.csv");
+  VTKM_TEST_ASSERT(index.size() == 25, "Wrong number of index entries");
+  VTKM_TEST_ASSERT(index[0] == "time,phi,theta,colormap,FILE", "Wrong index header");
+  VTKM_TEST_ASSERT(index[1] == "0,-180,-60,inferno,image_000000.png", "Wrong index entry");
+  VTKM_TEST_ASSERT(index[2] == "0,-180,-60,cool,image_000001.png", "Wrong index entry");
+
+  std::vector<unsigned char> first = ReadFile(database.GetPath() + "/image_000000.png");
+  std::vector<unsigned char> decoded;
+  unsigned long width, height;
+  int error = vtkm::rendering::DecodePNG(decoded, width, height, first.data(), first.size());
+  VTKM_TEST_ASSERT(error == 0, "Could not decode database image");
+  VTKM_TEST_ASSERT(width == 64 && height == 48, "Wrong database image size");
+  VTKM_TEST_ASSERT(first != ReadFile(database.GetPath() + "/image_000001.png"),
+                   "Color tables produced the same image");
+  VTKM_TEST_ASSERT(first != ReadFile(database.GetPath() + "/image_000002.png"),
+                   "Camera positions produced the same image");
+
+  // A view of the database matches rendering the scene directly.
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(-180.0);
+  camera.Elevation(-60.0);
+  canvas.Clear();
+  MakeScene(dataSet, 100.0).Render(mapper, canvas, camera);
+  canvas.SaveAs("image_database_direct.png");
+  VTKM_TEST_ASSERT(first == ReadFile("image_database_direct.png"),
+                   "Database image differs from direct rendering");
+}
+
+void TestParameterSweep()
+{
+  std::cout << "Testing parameter sweep" << std::endl;
+  vtkm::cont::DataSet dataSet = vtkm::cont::testing::MakeTestDataSet().Make3DRegularDataSet0();
+  vtkm::rendering::CanvasRayTracer canvas(32, 32);
+  vtkm::rendering::MapperRayTracer mapper;
+
+  vtkm::rendering::ImageDatabase database("image_database_params.cdb");
+  database.SetCameraSweep({ 0.0, 90.0 }, { 30.0 });
+  database.SetParameterSweep("range", { 50.0, 100.0, 200.0 }, [&](vtkm::Float64 value) {
+    return MakeScene(dataSet, value);
+  });
+  database.Render(mapper, canvas, 1.5);
+  VTKM_TEST_ASSERT(database.GetNumberOfImages() == 6, "Wrong number of images");
+
+  std::vector<std::string> index = ReadLines(database.GetPath() + "/data.csv");
+  VTKM_TEST_ASSERT(index.size() == 7, "Wrong number of index entries");
+  VTKM_TEST_ASSERT(index[0] == "time,phi,theta,range,FILE", "Wrong index header");
+  VTKM_TEST_ASSERT(index[6] == "1.5,90,30,200,image_000005.png", "Wrong index entry");
+  VTKM_TEST_ASSERT(ReadFile(database.GetPath() + "/image_000000.png") !=
+                     ReadFile(database.GetPath() + "/image_000002.png"),
+                   "Parameter values produced the same image");
+}
+
+void RenderTests()
+{
+  TestCameraSweep();
+  TestParameterSweep();
+}
+
+} //namespace
+
+int UnitTestImageDatabase(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(RenderTests);
+}
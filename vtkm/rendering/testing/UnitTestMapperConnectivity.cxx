@@ -18,6 +18,7 @@
 //  this software.
 //============================================================================
 
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
@@ -32,6 +33,58 @@
 namespace
 {
 
+vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> RenderField(
+  vtkm::rendering::MapperConnectivity& mapper,
+  const vtkm::cont::DataSet& dataSet,
+  const std::string& fieldName)
+{
+  vtkm::rendering::CanvasRayTracer canvas(64, 64);
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.f);
+  camera.Elevation(20.f);
+  mapper.SetCanvas(&canvas);
+  mapper.SetActiveColorTable(vtkm::cont::ColorTable("inferno"));
+  canvas.Clear();
+  mapper.RenderCells(dataSet.GetCellSet(),
+                     dataSet.GetCoordinateSystem(),
+                     dataSet.GetField(fieldName),
+                     vtkm::cont::ColorTable("inferno"),
+                     camera,
+                     vtkm::Range());
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> colors;
+  vtkm::cont::ArrayCopy(canvas.GetColorBuffer(), colors);
+  return colors;
+}
+
+void CheckSameImage(const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& a,
+                    const vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>>& b)
+{
+  VTKM_TEST_ASSERT(a.GetNumberOfValues() == b.GetNumberOfValues(), "Image sizes differ");
+  for (vtkm::Id i = 0; i < a.GetNumberOfValues(); ++i)
+  {
+    VTKM_TEST_ASSERT(test_equal(a.GetPortalConstControl().Get(i), b.GetPortalConstControl().Get(i)),
+                     "Reused connectivity changed the image");
+  }
+}
+
+void ReuseConnectivityTest()
+{
+  std::cout << "Testing connectivity reuse" << std::endl;
+  vtkm::cont::DataSet dataSet = vtkm::cont::testing::MakeTestDataSet().Make3DExplicitDataSet5();
+
+  // One mapper traces both fields on the same connectivity; fresh mappers
+  // build it again for each field.
+  vtkm::rendering::MapperConnectivity mapper;
+  auto pointImage = RenderField(mapper, dataSet, "pointvar");
+  auto cellImage = RenderField(mapper, dataSet, "cellvar");
+  auto pointImageAgain = RenderField(mapper, dataSet, "pointvar");
+
+  vtkm::rendering::MapperConnectivity freshMapper;
+  CheckSameImage(cellImage, RenderField(freshMapper, dataSet, "cellvar"));
+  CheckSameImage(pointImage, pointImageAgain);
+}
+
 void RenderTests()
 {
   using M = vtkm::rendering::MapperConnectivity;
@@ -47,6 +100,8 @@ void RenderTests()
     maker.Make3DRectilinearDataSet0(), "pointvar", colorTable, "rect3D.pnm");
   vtkm::rendering::testing::Render<M, C, V3>(
     maker.Make3DExplicitDataSet5(), "pointvar", colorTable, "explicit3D.pnm");
+
+  ReuseConnectivityTest();
 }
 
 } //namespace
@@ -0,0 +1,144 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/rendering/Actor.h>
+#include <vtkm/rendering/CanvasRayTracer.h>
+#include <vtkm/rendering/MapperLevelOfDetail.h>
+#include <vtkm/rendering/MapperRayTracer.h>
+#include <vtkm/rendering/MapperWireframer.h>
+#include <vtkm/rendering/Scene.h>
+#include <vtkm/rendering/View3D.h>
+#include <vtkm/rendering/testing/RenderTest.h>
+
+namespace
+{
+
+vtkm::cont::DataSet MakeDataSet()
+{
+  const vtkm::Id3 dims(48, 48, 48);
+  vtkm::cont::DataSet dataSet = vtkm::cont::DataSetBuilderUniform().Create(dims);
+  std::vector<vtkm::Float32> pointvar(static_cast<std::size_t>(dims[0] * dims[1] * dims[2]));
+  for (std::size_t i = 0; i < pointvar.size(); ++i)
+  {
+    pointvar[i] = static_cast<vtkm::Float32>(i % 97);
+  }
+  std::vector<vtkm::Float32> cellvar(static_cast<std::size_t>(47 * 47 * 47));
+  for (std::size_t i = 0; i < cellvar.size(); ++i)
+  {
+    cellvar[i] = static_cast<vtkm::Float32>(i % 13);
+  }
+  vtkm::cont::DataSetFieldAdd::AddPointField(dataSet, "pointvar", pointvar);
+  vtkm::cont::DataSetFieldAdd::AddCellField(dataSet, "cellvar", cellvar);
+  return dataSet;
+}
+
+void RenderField(vtkm::rendering::MapperLevelOfDetail& mapper,
+                 vtkm::rendering::Canvas& canvas,
+                 const vtkm::cont::DataSet& dataSet,
+                 const std::string& fieldName)
+{
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.f);
+  camera.Elevation(20.f);
+  mapper.SetCanvas(&canvas);
+  mapper.SetActiveColorTable(vtkm::cont::ColorTable("inferno"));
+  canvas.Clear();
+  mapper.RenderCells(dataSet.GetCellSet(),
+                     dataSet.GetCoordinateSystem(),
+                     dataSet.GetField(fieldName),
+                     vtkm::cont::ColorTable("inferno"),
+                     camera,
+                     vtkm::Range(0., 100.));
+}
+
+void LevelSelectionTest()
+{
+  std::cout << "Testing level selection" << std::endl;
+  vtkm::cont::DataSet dataSet = MakeDataSet();
+  vtkm::rendering::MapperLevelOfDetail mapper((vtkm::rendering::MapperRayTracer()));
+  mapper.SetLevels(4, 3);
+
+  // the external faces of 47^3 hexahedra
+  const vtkm::Id fullTriangles = 6 * 2 * 47 * 47;
+
+  vtkm::rendering::CanvasRayTracer small(32, 32);
+  RenderField(mapper, small, dataSet, "pointvar");
+  VTKM_TEST_ASSERT(mapper.GetLastLevel() >= 0, "Small image should use a decimated level");
+  vtkm::Id smallTriangles = mapper.GetLastNumberOfTriangles();
+  VTKM_TEST_ASSERT(smallTriangles > 0 && smallTriangles < fullTriangles,
+                   "Decimated level is not smaller");
+
+  vtkm::rendering::CanvasRayTracer large(512, 512);
+  RenderField(mapper, large, dataSet, "cellvar");
+  VTKM_TEST_ASSERT(mapper.GetLastLevel() == -1, "Large image should use full resolution");
+  VTKM_TEST_ASSERT(mapper.GetLastNumberOfTriangles() == fullTriangles,
+                   "Wrong full resolution triangle count");
+
+  // A budget no level can meet picks the coarsest level
+  mapper.SetTimeBudget(1e-12);
+  RenderField(mapper, large, dataSet, "pointvar");
+  VTKM_TEST_ASSERT(mapper.GetLastLevel() == 0, "Time budget should pick the coarsest level");
+  VTKM_TEST_ASSERT(mapper.GetLastNumberOfTriangles() <= smallTriangles,
+                   "Coarsest level is not the smallest");
+
+  mapper.SetInteractive(false);
+  RenderField(mapper, small, dataSet, "cellvar");
+  VTKM_TEST_ASSERT(mapper.GetLastLevel() == -1, "Final frames should use full resolution");
+}
+
+void RenderTests()
+{
+  using C = vtkm::rendering::CanvasRayTracer;
+  using V3 = vtkm::rendering::View3D;
+
+  LevelSelectionTest();
+
+  vtkm::cont::DataSet dataSet = MakeDataSet();
+  vtkm::cont::ColorTable colorTable("inferno");
+  vtkm::rendering::MapperLevelOfDetail rayTracer((vtkm::rendering::MapperRayTracer()));
+  vtkm::rendering::MapperLevelOfDetail wireframer((vtkm::rendering::MapperWireframer()));
+
+  vtkm::rendering::Scene scene;
+  scene.AddActor(vtkm::rendering::Actor(dataSet.GetCellSet(),
+                                        dataSet.GetCoordinateSystem(),
+                                        dataSet.GetField("pointvar"),
+                                        colorTable));
+  C canvas(64, 64);
+  vtkm::rendering::Camera camera;
+  vtkm::rendering::testing::SetCamera<V3>(
+    camera, dataSet.GetCoordinateSystem().GetBounds(), dataSet.GetField("pointvar"));
+  V3 rayTracerView(scene, rayTracer, canvas, camera, vtkm::rendering::Color(0, 0, 0, 1));
+  vtkm::rendering::testing::Render<vtkm::rendering::MapperLevelOfDetail, C, V3>(
+    rayTracerView, "lod_rt.pnm");
+  V3 wireframerView(scene, wireframer, canvas, camera, vtkm::rendering::Color(0, 0, 0, 1));
+  vtkm::rendering::testing::Render<vtkm::rendering::MapperLevelOfDetail, C, V3>(
+    wireframerView, "lod_wire.pnm");
+}
+
+} //namespace
+
+int UnitTestMapperLevelOfDetail(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(RenderTests);
+}
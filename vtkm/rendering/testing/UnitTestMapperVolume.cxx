@@ -27,6 +27,7 @@
 #include <vtkm/rendering/MapperVolume.h>
 #include <vtkm/rendering/Scene.h>
 #include <vtkm/rendering/View3D.h>
+#include <vtkm/rendering/raytracing/Logger.h>
 #include <vtkm/rendering/testing/RenderTest.h>
 
 namespace
@@ -49,9 +50,56 @@ void RenderTests()
     maker.Make3DRectilinearDataSet0(), "pointvar", colorTable, "rect3D.pnm");
 }
 
+// Renders the actor and returns whether the empty macro cell flags were rebuilt
+bool RenderRebuildsFlags(const vtkm::rendering::Actor& actor,
+                         vtkm::rendering::MapperVolume& mapper,
+                         vtkm::rendering::CanvasRayTracer& canvas,
+                         const vtkm::rendering::Camera& camera)
+{
+  vtkm::rendering::raytracing::Logger* logger =
+    vtkm::rendering::raytracing::Logger::GetInstance();
+  logger->Clear();
+  actor.Render(mapper, canvas, camera);
+  return logger->GetStream().str().find("macro_cell_flags") != std::string::npos;
+}
+
+void TestColorMapCaching()
+{
+  std::cout << "Testing that unchanged color maps reuse the empty macro cells" << std::endl;
+  vtkm::cont::testing::MakeTestDataSet maker;
+  vtkm::cont::DataSet dataSet = maker.Make3DRegularDataSet0();
+  vtkm::cont::ColorTable colorTable("inferno");
+  colorTable.AddPointAlpha(0.0, .01f);
+  colorTable.AddPointAlpha(1.0, .01f);
+  vtkm::rendering::Actor actor(dataSet.GetCellSet(),
+                               dataSet.GetCoordinateSystem(),
+                               dataSet.GetField("pointvar"),
+                               colorTable);
+
+  vtkm::rendering::CanvasRayTracer canvas(64, 64);
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  vtkm::rendering::MapperVolume mapper;
+
+  VTKM_TEST_ASSERT(RenderRebuildsFlags(actor, mapper, canvas, camera),
+                   "First render did not build the empty macro cells");
+  VTKM_TEST_ASSERT(!RenderRebuildsFlags(actor, mapper, canvas, camera),
+                   "Second render rebuilt the empty macro cells");
+
+  colorTable.AddPointAlpha(0.5, 0.f);
+  VTKM_TEST_ASSERT(RenderRebuildsFlags(actor, mapper, canvas, camera),
+                   "Changing the color table did not rebuild the empty macro cells");
+}
+
+void MapperVolumeTests()
+{
+  RenderTests();
+  TestColorMapCaching();
+}
+
 } //namespace
 
 int UnitTestMapperVolume(int, char* [])
 {
-  return vtkm::cont::testing::Testing::Run(RenderTests);
+  return vtkm::cont::testing::Testing::Run(MapperVolumeTests);
 }
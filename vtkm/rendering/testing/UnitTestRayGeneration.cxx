@@ -0,0 +1,159 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/cont/DeviceAdapter.h>
+#include <vtkm/cont/testing/MakeTestDataSet.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/rendering/Camera.h>
+#include <vtkm/rendering/CanvasRayTracer.h>
+#include <vtkm/rendering/raytracing/Camera.h>
+#include <vtkm/rendering/raytracing/Ray.h>
+#include <vtkm/rendering/raytracing/RayOperations.h>
+
+#include <map>
+
+namespace
+{
+
+using Device = VTKM_DEFAULT_DEVICE_ADAPTER_TAG;
+using RayType = vtkm::rendering::raytracing::Ray<vtkm::Float32>;
+using DirMap = std::map<vtkm::Id, vtkm::Vec<vtkm::Float32, 3>>;
+
+const vtkm::Id WIDTH = 61;
+const vtkm::Id HEIGHT = 43;
+
+void SetupCamera(vtkm::rendering::raytracing::Camera& rayCamera,
+                 const vtkm::cont::CoordinateSystem& coords,
+                 vtkm::rendering::CanvasRayTracer& canvas)
+{
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(coords.GetBounds());
+  camera.Azimuth(30.f);
+  camera.Elevation(20.f);
+  rayCamera.SetParameters(camera, canvas);
+}
+
+// maps each pixel to the direction of its ray, checking that no pixel is
+// covered twice
+DirMap GetDirections(RayType& rays)
+{
+  DirMap directions;
+  for (vtkm::Id i = 0; i < rays.NumRays; ++i)
+  {
+    vtkm::Id pixel = rays.PixelIdx.GetPortalConstControl().Get(i);
+    VTKM_TEST_ASSERT(directions.count(pixel) == 0, "Pixel has more than one ray");
+    directions[pixel] = rays.Dir.GetPortalConstControl().Get(i);
+  }
+  return directions;
+}
+
+void CompareDirections(const DirMap& expected, const DirMap& result)
+{
+  VTKM_TEST_ASSERT(expected.size() == result.size(), "Wrong number of pixels");
+  for (auto& pixelDir : expected)
+  {
+    auto found = result.find(pixelDir.first);
+    VTKM_TEST_ASSERT(found != result.end(), "Missing pixel");
+    VTKM_TEST_ASSERT(test_equal(pixelDir.second, found->second), "Wrong ray direction");
+  }
+}
+
+void TestRayGeneration()
+{
+  vtkm::cont::DataSet dataSet = vtkm::cont::testing::MakeTestDataSet().Make3DUniformDataSet1();
+  const vtkm::cont::CoordinateSystem& coords = dataSet.GetCoordinateSystem();
+  vtkm::rendering::CanvasRayTracer canvas(WIDTH, HEIGHT);
+
+  std::cout << "Testing scanline and tiled ray order" << std::endl;
+  vtkm::rendering::raytracing::Camera scanCamera;
+  SetupCamera(scanCamera, coords, canvas);
+  scanCamera.SetRayOrder(vtkm::rendering::raytracing::Camera::RAY_ORDER_SCANLINE);
+  RayType scanRays;
+  scanCamera.CreateRays(scanRays, coords);
+  DirMap expected = GetDirections(scanRays);
+
+  vtkm::rendering::raytracing::Camera tiledCamera;
+  SetupCamera(tiledCamera, coords, canvas);
+  VTKM_TEST_ASSERT(tiledCamera.GetRayOrder() ==
+                     vtkm::rendering::raytracing::Camera::RAY_ORDER_TILED,
+                   "Tiled order should be the default");
+  RayType tiledRays;
+  tiledCamera.CreateRays(tiledRays, coords);
+  CompareDirections(expected, GetDirections(tiledRays));
+
+  const vtkm::Id subsetWidth = tiledCamera.GetSubsetWidth();
+  const vtkm::Id subsetHeight = tiledCamera.GetSubsetHeight();
+  VTKM_TEST_ASSERT(subsetWidth >= 8 && subsetHeight >= 8, "Subset too small for the test");
+  // the first 64 rays cover the first 8x8 tile
+  vtkm::Id minX = WIDTH, minY = HEIGHT, maxX = 0, maxY = 0;
+  for (vtkm::Id i = 0; i < 64; ++i)
+  {
+    vtkm::Id pixel = tiledRays.PixelIdx.GetPortalConstControl().Get(i);
+    minX = vtkm::Min(minX, pixel % WIDTH);
+    maxX = vtkm::Max(maxX, pixel % WIDTH);
+    minY = vtkm::Min(minY, pixel / WIDTH);
+    maxY = vtkm::Max(maxY, pixel / WIDTH);
+  }
+  VTKM_TEST_ASSERT(maxX - minX == 7 && maxY - minY == 7, "First rays are not an 8x8 tile");
+
+  std::cout << "Testing ray sorting" << std::endl;
+  vtkm::rendering::raytracing::RayOperations::SortRays(tiledRays, Device());
+  CompareDirections(expected, GetDirections(tiledRays));
+
+  std::cout << "Testing subsampling" << std::endl;
+  const vtkm::Int32 factor = 4;
+  vtkm::rendering::raytracing::Camera coarseCamera;
+  SetupCamera(coarseCamera, coords, canvas);
+  coarseCamera.SetSubsampling(factor);
+  RayType coarseRays;
+  coarseCamera.CreateRays(coarseRays, coords);
+  const vtkm::Id latticeSize =
+    ((subsetWidth + factor - 1) / factor) * ((subsetHeight + factor - 1) / factor);
+  VTKM_TEST_ASSERT(coarseRays.NumRays == latticeSize, "Wrong number of subsampled rays");
+  DirMap coarse = GetDirections(coarseRays);
+  vtkm::Id firstPixel = scanRays.PixelIdx.GetPortalConstControl().Get(0);
+  for (auto& pixelDir : coarse)
+  {
+    vtkm::Id x = pixelDir.first % WIDTH - firstPixel % WIDTH;
+    vtkm::Id y = pixelDir.first / WIDTH - firstPixel / WIDTH;
+    VTKM_TEST_ASSERT(x % factor == 0 && y % factor == 0, "Ray is not on the lattice");
+    VTKM_TEST_ASSERT(test_equal(pixelDir.second, expected[pixelDir.first]),
+                     "Wrong subsampled ray direction");
+  }
+
+  coarseCamera.ExpandSubsampledRays(coarseRays);
+  DirMap expanded = GetDirections(coarseRays);
+  VTKM_TEST_ASSERT(expanded.size() == expected.size(), "Expanded rays do not cover the subset");
+  for (auto& pixelDir : expanded)
+  {
+    vtkm::Id x = pixelDir.first % WIDTH - firstPixel % WIDTH;
+    vtkm::Id y = pixelDir.first / WIDTH - firstPixel / WIDTH;
+    vtkm::Id source = pixelDir.first - (y % factor) * WIDTH - (x % factor);
+    VTKM_TEST_ASSERT(expected.count(pixelDir.first) == 1, "Expanded ray outside the subset");
+    VTKM_TEST_ASSERT(test_equal(pixelDir.second, coarse[source]), "Wrong expanded ray");
+  }
+}
+
+} //namespace
+
+int UnitTestRayGeneration(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestRayGeneration);
+}
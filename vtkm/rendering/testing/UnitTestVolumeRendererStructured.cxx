@@ -0,0 +1,198 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#include <vtkm/VectorAnalysis.h>
+#include <vtkm/cont/DataSetBuilderRectilinear.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/DataSetFieldAdd.h>
+#include <vtkm/cont/DeviceAdapter.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/rendering/raytracing/Ray.h>
+#include <vtkm/rendering/raytracing/VolumeRendererStructured.h>
+
+#include <vector>
+
+namespace
+{
+
+using Device = VTKM_DEFAULT_DEVICE_ADAPTER_TAG;
+using VolumeRenderer = vtkm::rendering::raytracing::VolumeRendererStructured;
+
+const vtkm::Id DIM = 33;
+const vtkm::Id IMAGE_DIM = 48;
+
+// A field that is high in a small blob and low everywhere else, so that most
+// of the volume maps to transparent colors.
+vtkm::Float32 BlobValue(vtkm::Float32 x, vtkm::Float32 y, vtkm::Float32 z)
+{
+  vtkm::Vec<vtkm::Float32, 3> center(22.f, 12.f, 18.f);
+  vtkm::Float32 dist = vtkm::Magnitude(vtkm::Vec<vtkm::Float32, 3>(x, y, z) - center);
+  return vtkm::Max(0.f, 1.f - dist / 8.f);
+}
+
+void AddFields(vtkm::cont::DataSet& dataSet)
+{
+  std::vector<vtkm::Float32> pointField;
+  for (vtkm::Id k = 0; k < DIM; ++k)
+    for (vtkm::Id j = 0; j < DIM; ++j)
+      for (vtkm::Id i = 0; i < DIM; ++i)
+        pointField.push_back(BlobValue(vtkm::Float32(i), vtkm::Float32(j), vtkm::Float32(k)));
+  std::vector<vtkm::Float32> cellField;
+  for (vtkm::Id k = 0; k < DIM - 1; ++k)
+    for (vtkm::Id j = 0; j < DIM - 1; ++j)
+      for (vtkm::Id i = 0; i < DIM - 1; ++i)
+        cellField.push_back(
+          BlobValue(vtkm::Float32(i) + 0.5f, vtkm::Float32(j) + 0.5f, vtkm::Float32(k) + 0.5f));
+
+  vtkm::cont::DataSetFieldAdd::AddPointField(dataSet, "pointvar", pointField);
+  vtkm::cont::DataSetFieldAdd::AddCellField(dataSet, "cellvar", cellField, "cells");
+}
+
+vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> MakeColorMap()
+{
+  // the lower half of the scalar range is fully transparent
+  const vtkm::Id size = 256;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> colorMap;
+  colorMap.Allocate(size);
+  for (vtkm::Id i = 0; i < size; ++i)
+  {
+    vtkm::Float32 t = vtkm::Float32(i) / vtkm::Float32(size - 1);
+    vtkm::Float32 alpha = i < size / 2 ? 0.f : 0.2f * t;
+    colorMap.GetPortalControl().Set(i, vtkm::Vec<vtkm::Float32, 4>(t, 0.5f, 1.f - t, alpha));
+  }
+  return colorMap;
+}
+
+std::vector<vtkm::Float32> Render(VolumeRenderer& renderer)
+{
+  // orthographic rays looking down the diagonal of the volume
+  const vtkm::Int32 numRays = static_cast<vtkm::Int32>(IMAGE_DIM * IMAGE_DIM);
+  vtkm::rendering::raytracing::Ray<vtkm::Float32> rays(numRays, Device());
+  rays.Buffers.at(0).InitConst(0.f);
+  vtkm::Vec<vtkm::Float32, 3> dir = vtkm::Normal(vtkm::Vec<vtkm::Float32, 3>(-1.f, -0.7f, -0.4f));
+  vtkm::Vec<vtkm::Float32, 3> up(0.f, 0.f, 1.f);
+  vtkm::Vec<vtkm::Float32, 3> u = vtkm::Normal(vtkm::Cross(dir, up));
+  vtkm::Vec<vtkm::Float32, 3> v = vtkm::Cross(u, dir);
+  vtkm::Vec<vtkm::Float32, 3> center(16.f, 16.f, 16.f);
+  for (vtkm::Int32 i = 0; i < numRays; ++i)
+  {
+    vtkm::Float32 a = (vtkm::Float32(i % IMAGE_DIM) / vtkm::Float32(IMAGE_DIM) - 0.5f) * 56.f;
+    vtkm::Float32 b = (vtkm::Float32(i / IMAGE_DIM) / vtkm::Float32(IMAGE_DIM) - 0.5f) * 56.f;
+    vtkm::Vec<vtkm::Float32, 3> origin = center - 60.f * dir + a * u + b * v;
+    rays.OriginX.GetPortalControl().Set(i, origin[0]);
+    rays.OriginY.GetPortalControl().Set(i, origin[1]);
+    rays.OriginZ.GetPortalControl().Set(i, origin[2]);
+    rays.DirX.GetPortalControl().Set(i, dir[0]);
+    rays.DirY.GetPortalControl().Set(i, dir[1]);
+    rays.DirZ.GetPortalControl().Set(i, dir[2]);
+    rays.MinDistance.GetPortalControl().Set(i, 0.f);
+    rays.MaxDistance.GetPortalControl().Set(i, vtkm::Infinity32());
+  }
+
+  renderer.Render(rays);
+
+  std::vector<vtkm::Float32> image;
+  auto portal = rays.Buffers.at(0).Buffer.GetPortalConstControl();
+  for (vtkm::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+  {
+    image.push_back(portal.Get(i));
+  }
+  return image;
+}
+
+void TestSkipping(const vtkm::cont::DataSet& dataSet, const std::string& fieldName)
+{
+  std::cout << "Testing empty space skipping for " << fieldName << std::endl;
+  const vtkm::cont::Field& field = dataSet.GetField(fieldName);
+  vtkm::cont::CellSetStructured<3> cellSet;
+  dataSet.GetCellSet().CopyTo(cellSet);
+  vtkm::Range range(0.0, 1.0);
+
+  VolumeRenderer reference;
+  reference.DisableEmptySpaceSkipping();
+  reference.SetEarlyTerminationAlpha(1.f);
+  reference.SetSampleDistance(0.25f);
+  reference.SetData(dataSet.GetCoordinateSystem(), field, cellSet, range);
+  reference.SetColorMap(MakeColorMap());
+  std::vector<vtkm::Float32> expected = Render(reference);
+
+  VolumeRenderer renderer;
+  renderer.SetEarlyTerminationAlpha(1.f);
+  renderer.SetSampleDistance(0.25f);
+  renderer.SetData(dataSet.GetCoordinateSystem(), field, cellSet, range);
+  renderer.SetColorMap(MakeColorMap());
+  // render twice to exercise the cached macro cells
+  Render(renderer);
+  std::vector<vtkm::Float32> result = Render(renderer);
+
+  VTKM_TEST_ASSERT(expected.size() == result.size(), "Wrong image size");
+  vtkm::Id numVisible = 0;
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    VTKM_TEST_ASSERT(test_equal(expected[i], result[i], 0.001),
+                     "Skipping changed the rendered image");
+    if (i % 4 == 3 && expected[i] > 0.f)
+      numVisible++;
+  }
+  VTKM_TEST_ASSERT(numVisible > 0, "Expected the blob to be visible");
+
+  // a fully opaque color map leaves nothing to skip
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 4>> opaque = MakeColorMap();
+  for (vtkm::Id i = 0; i < opaque.GetNumberOfValues(); ++i)
+  {
+    auto color = opaque.GetPortalConstControl().Get(i);
+    color[3] = 0.05f;
+    opaque.GetPortalControl().Set(i, color);
+  }
+  reference.SetColorMap(opaque);
+  renderer.SetColorMap(opaque);
+  expected = Render(reference);
+  result = Render(renderer);
+  for (std::size_t i = 0; i < expected.size(); ++i)
+  {
+    VTKM_TEST_ASSERT(test_equal(expected[i], result[i], 0.001),
+                     "Changing the color map was not picked up");
+  }
+}
+
+void TestVolumeRendererStructured()
+{
+  vtkm::cont::DataSet uniform =
+    vtkm::cont::DataSetBuilderUniform::Create(vtkm::Id3(DIM, DIM, DIM));
+  AddFields(uniform);
+  TestSkipping(uniform, "pointvar");
+  TestSkipping(uniform, "cellvar");
+
+  std::vector<vtkm::Float32> coords;
+  for (vtkm::Id i = 0; i < DIM; ++i)
+    coords.push_back(vtkm::Float32(i));
+  vtkm::cont::DataSet rectilinear =
+    vtkm::cont::DataSetBuilderRectilinear::Create(coords, coords, coords);
+  AddFields(rectilinear);
+  TestSkipping(rectilinear, "pointvar");
+  TestSkipping(rectilinear, "cellvar");
+}
+
+} //namespace
+
+int UnitTestVolumeRendererStructured(int, char* [])
+{
+  return vtkm::cont::testing::Testing::Run(TestVolumeRendererStructured);
+}
@@ -0,0 +1,411 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2015 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2015 UT-Battelle, LLC.
+//  Copyright 2015 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#ifndef vtk_m_worklet_BrickRangeIndex_h
+#define vtk_m_worklet_BrickRangeIndex_h
+
+#include <vtkm/Range.h>
+#include <vtkm/Types.h>
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/DynamicArrayHandle.h>
+
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/ScatterCounting.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <string>
+
+namespace vtkm
+{
+namespace worklet
+{
+
+namespace brickrange
+{
+
+struct RangeType : vtkm::ListTagBase<vtkm::Range>
+{
+};
+
+/// Cell index range [Min, Max) covered by a brick along each axis.
+struct BrickExtent
+{
+  vtkm::Id3 Min;
+  vtkm::Id3 Max;
+};
+
+VTKM_EXEC_CONT
+inline BrickExtent ComputeBrickExtent(vtkm::Id brickIndex,
+                                      const vtkm::Id3& cellDims,
+                                      const vtkm::Id3& brickDims,
+                                      vtkm::Id brickSize)
+{
+  const vtkm::Id3 brick(brickIndex % brickDims[0],
+                        (brickIndex / brickDims[0]) % brickDims[1],
+                        brickIndex / (brickDims[0] * brickDims[1]));
+  BrickExtent extent;
+  for (vtkm::IdComponent d = 0; d < 3; ++d)
+  {
+    extent.Min[d] = brick[d] * brickSize;
+    extent.Max[d] = vtkm::Min(extent.Min[d] + brickSize, cellDims[d]);
+  }
+  return extent;
+}
+
+// Computes the range of a point field over the points of every brick.
+class ComputeBrickRanges : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<IdType> brickIndex,
+                                WholeArrayIn<ScalarAll> field,
+                                FieldOut<RangeType> range);
+  using ExecutionSignature = void(_1, _2, _3);
+  using InputDomain = _1;
+
+  VTKM_CONT
+  ComputeBrickRanges(const vtkm::Id3& cellDims, const vtkm::Id3& brickDims, vtkm::Id brickSize)
+    : CellDims(cellDims)
+    , BrickDims(brickDims)
+    , BrickSize(brickSize)
+  {
+  }
+
+  template <typename FieldPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& brickIndex,
+                            const FieldPortalType& field,
+                            vtkm::Range& range) const
+  {
+    const BrickExtent extent =
+      ComputeBrickExtent(brickIndex, this->CellDims, this->BrickDims, this->BrickSize);
+    const vtkm::Id3 pointDims = this->CellDims + vtkm::Id3(1);
+
+    // The points of a brick are the points of its cells, i.e. one more
+    // layer of points than cells along each axis.
+    range = vtkm::Range();
+    for (vtkm::Id k = extent.Min[2]; k <= extent.Max[2]; ++k)
+    {
+      for (vtkm::Id j = extent.Min[1]; j <= extent.Max[1]; ++j)
+      {
+        const vtkm::Id rowStart = (k * pointDims[1] + j) * pointDims[0];
+        for (vtkm::Id i = extent.Min[0]; i <= extent.Max[0]; ++i)
+        {
+          range.Include(static_cast<vtkm::Float64>(field.Get(rowStart + i)));
+        }
+      }
+    }
+  }
+
+private:
+  vtkm::Id3 CellDims;
+  vtkm::Id3 BrickDims;
+  vtkm::Id BrickSize;
+};
+
+// Counts the cells of the bricks that may contain one of the isovalues, i.e.
+// that have point values on both sides of it.
+class CountCellsStraddling : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<RangeType> range,
+                                FieldIn<IdType> numCells,
+                                WholeArrayIn<ScalarAll> isovalues,
+                                FieldOut<IdType> numCandidates);
+  using ExecutionSignature = _4(_1, _2, _3);
+  using InputDomain = _1;
+
+  template <typename IsoValuesPortalType>
+  VTKM_EXEC vtkm::Id operator()(const vtkm::Range& range,
+                                const vtkm::Id& numCells,
+                                const IsoValuesPortalType& isovalues) const
+  {
+    for (vtkm::Id i = 0; i < isovalues.GetNumberOfValues(); ++i)
+    {
+      // Marching cubes classifies points with `value > isovalue`, so a cell
+      // produces triangles only when min <= isovalue < max.
+      const vtkm::Float64 isovalue = static_cast<vtkm::Float64>(isovalues.Get(i));
+      if (range.Min <= isovalue && isovalue < range.Max)
+      {
+        return numCells;
+      }
+    }
+    return 0;
+  }
+};
+
+// Counts the cells of the bricks whose range intersects the given range.
+class CountCellsIntersecting : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<RangeType> range,
+                                FieldIn<IdType> numCells,
+                                FieldOut<IdType> numCandidates);
+  using ExecutionSignature = _3(_1, _2);
+  using InputDomain = _1;
+
+  VTKM_CONT
+  CountCellsIntersecting(const vtkm::Range& query)
+    : Query(query)
+  {
+  }
+
+  VTKM_EXEC
+  vtkm::Id operator()(const vtkm::Range& range, const vtkm::Id& numCells) const
+  {
+    return (range.Max >= this->Query.Min && range.Min <= this->Query.Max) ? numCells : 0;
+  }
+
+private:
+  vtkm::Range Query;
+};
+
+// Writes the ids of the cells of every candidate brick.
+class GenerateCandidateCells : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<IdType> brickIndex, FieldOut<IdType> cellId);
+  using ExecutionSignature = void(_1, VisitIndex, _2);
+  using InputDomain = _1;
+
+  using ScatterType = vtkm::worklet::ScatterCounting;
+
+  VTKM_CONT
+  GenerateCandidateCells(const vtkm::Id3& cellDims, const vtkm::Id3& brickDims, vtkm::Id brickSize)
+    : CellDims(cellDims)
+    , BrickDims(brickDims)
+    , BrickSize(brickSize)
+  {
+  }
+
+  VTKM_EXEC
+  void operator()(const vtkm::Id& brickIndex, vtkm::IdComponent visitIndex, vtkm::Id& cellId) const
+  {
+    const BrickExtent extent =
+      ComputeBrickExtent(brickIndex, this->CellDims, this->BrickDims, this->BrickSize);
+    const vtkm::Id3 size = extent.Max - extent.Min;
+    const vtkm::Id3 cell(extent.Min[0] + visitIndex % size[0],
+                         extent.Min[1] + (visitIndex / size[0]) % size[1],
+                         extent.Min[2] + visitIndex / (size[0] * size[1]));
+    cellId = (cell[2] * this->CellDims[1] + cell[1]) * this->CellDims[0] + cell[0];
+  }
+
+private:
+  vtkm::Id3 CellDims;
+  vtkm::Id3 BrickDims;
+  vtkm::Id BrickSize;
+};
+
+// Number of cells in every brick.
+class CountBrickCells : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<IdType> brickIndex, FieldOut<IdType> numCells);
+  using ExecutionSignature = _2(_1);
+  using InputDomain = _1;
+
+  VTKM_CONT
+  CountBrickCells(const vtkm::Id3& cellDims, const vtkm::Id3& brickDims, vtkm::Id brickSize)
+    : CellDims(cellDims)
+    , BrickDims(brickDims)
+    , BrickSize(brickSize)
+  {
+  }
+
+  VTKM_EXEC
+  vtkm::Id operator()(const vtkm::Id& brickIndex) const
+  {
+    const BrickExtent extent =
+      ComputeBrickExtent(brickIndex, this->CellDims, this->BrickDims, this->BrickSize);
+    const vtkm::Id3 size = extent.Max - extent.Min;
+    return size[0] * size[1] * size[2];
+  }
+
+private:
+  vtkm::Id3 CellDims;
+  vtkm::Id3 BrickDims;
+  vtkm::Id BrickSize;
+};
+
+} // namespace brickrange
+
+/// \brief Per-brick value range index of a point field on a 3D structured grid.
+///
+/// The cells of the grid are grouped in bricks of `BrickSize`^3 cells and the
+/// range of the field over the points of every brick is stored. Queries
+/// return the ids, in increasing order, of the cells of the bricks whose
+/// range may satisfy the query. Algorithms such as marching cubes or
+/// threshold can then visit only those cells instead of the whole grid and
+/// still produce the same result.
+///
+/// The index is built once and can be reused for any number of queries as
+/// long as the field values do not change. It keeps the array it was built
+/// from and is only valid for that same array, so the index of a field that
+/// is replaced is not used by mistake. It must still be rebuilt when the
+/// values of that array are modified in place.
+class BrickRangeIndex
+{
+public:
+  VTKM_CONT
+  BrickRangeIndex(vtkm::Id brickSize = 8)
+    : BrickSize(brickSize)
+    , CellDimensions(0)
+    , BrickDimensions(0)
+  {
+  }
+
+  VTKM_CONT
+  vtkm::Id GetBrickSize() const { return this->BrickSize; }
+
+  VTKM_CONT
+  vtkm::Id3 GetCellDimensions() const { return this->CellDimensions; }
+
+  VTKM_CONT
+  const vtkm::cont::ArrayHandle<vtkm::Range>& GetBrickRanges() const { return this->BrickRanges; }
+
+  /// Name of the field the index was built from, empty if it was not given.
+  VTKM_CONT
+  const std::string& GetFieldName() const { return this->FieldName; }
+
+  /// Returns true if the index was built from this array for a cell set with
+  /// these dimensions.
+  template <typename ValueType, typename StorageType>
+  VTKM_CONT bool IsValidFor(const vtkm::cont::CellSetStructured<3>& cells,
+                            const vtkm::cont::ArrayHandle<ValueType, StorageType>& pointField) const
+  {
+    using ArrayHandleType = vtkm::cont::ArrayHandle<ValueType, StorageType>;
+    return this->BrickRanges.GetNumberOfValues() > 0 &&
+      cells.GetCellDimensions() == this->CellDimensions &&
+      this->PointField.template IsTypeAndStorage<ValueType, StorageType>() &&
+      this->PointField.template Cast<ArrayHandleType>() == pointField;
+  }
+
+  /// Returns true if the index was also built for the field named fieldName.
+  template <typename ValueType, typename StorageType>
+  VTKM_CONT bool IsValidFor(const vtkm::cont::CellSetStructured<3>& cells,
+                            const std::string& fieldName,
+                            const vtkm::cont::ArrayHandle<ValueType, StorageType>& pointField) const
+  {
+    return fieldName == this->FieldName && this->IsValidFor(cells, pointField);
+  }
+
+  template <typename ValueType, typename StorageType, typename DeviceAdapter>
+  VTKM_CONT void Build(const vtkm::cont::CellSetStructured<3>& cells,
+                       const vtkm::cont::ArrayHandle<ValueType, StorageType>& pointField,
+                       DeviceAdapter device)
+  {
+    this->Build(cells, std::string(), pointField, device);
+  }
+
+  /// Build the index of the point field named fieldName. Filters only use
+  /// the index for their active field if it has this name.
+  template <typename ValueType, typename StorageType, typename DeviceAdapter>
+  VTKM_CONT void Build(const vtkm::cont::CellSetStructured<3>& cells,
+                       const std::string& fieldName,
+                       const vtkm::cont::ArrayHandle<ValueType, StorageType>& pointField,
+                       DeviceAdapter)
+  {
+    this->FieldName = fieldName;
+    this->PointField = vtkm::cont::DynamicArrayHandle(pointField);
+    this->CellDimensions = cells.GetCellDimensions();
+    for (vtkm::IdComponent d = 0; d < 3; ++d)
+    {
+      this->BrickDimensions[d] = (this->CellDimensions[d] + this->BrickSize - 1) / this->BrickSize;
+    }
+    const vtkm::Id numBricks =
+      this->BrickDimensions[0] * this->BrickDimensions[1] * this->BrickDimensions[2];
+
+    vtkm::cont::ArrayHandleIndex brickIndices(numBricks);
+    brickrange::ComputeBrickRanges computeRanges(
+      this->CellDimensions, this->BrickDimensions, this->BrickSize);
+    vtkm::worklet::DispatcherMapField<brickrange::ComputeBrickRanges, DeviceAdapter>
+      computeRangesDispatcher(computeRanges);
+    computeRangesDispatcher.Invoke(brickIndices, pointField, this->BrickRanges);
+
+    brickrange::CountBrickCells countCells(
+      this->CellDimensions, this->BrickDimensions, this->BrickSize);
+    vtkm::worklet::DispatcherMapField<brickrange::CountBrickCells, DeviceAdapter>
+      countCellsDispatcher(countCells);
+    countCellsDispatcher.Invoke(brickIndices, this->BrickNumberOfCells);
+  }
+
+  /// Cells that may produce a contour for one of the isovalues.
+  template <typename ValueType, typename StorageType, typename DeviceAdapter>
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Id> GetCellsStraddling(
+    const vtkm::cont::ArrayHandle<ValueType, StorageType>& isovalues,
+    DeviceAdapter device) const
+  {
+    vtkm::cont::ArrayHandle<vtkm::Id> numCandidates;
+    vtkm::worklet::DispatcherMapField<brickrange::CountCellsStraddling, DeviceAdapter>
+      countDispatcher;
+    countDispatcher.Invoke(this->BrickRanges, this->BrickNumberOfCells, isovalues, numCandidates);
+    return this->GenerateCandidates(numCandidates, device);
+  }
+
+  /// Cells of the bricks having values in `range` (inclusive).
+  template <typename DeviceAdapter>
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Id> GetCellsIntersecting(const vtkm::Range& range,
+                                                                   DeviceAdapter device) const
+  {
+    vtkm::cont::ArrayHandle<vtkm::Id> numCandidates;
+    vtkm::worklet::DispatcherMapField<brickrange::CountCellsIntersecting, DeviceAdapter>
+      countDispatcher((brickrange::CountCellsIntersecting(range)));
+    countDispatcher.Invoke(this->BrickRanges, this->BrickNumberOfCells, numCandidates);
+    return this->GenerateCandidates(numCandidates, device);
+  }
+
+private:
+  template <typename DeviceAdapter>
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Id> GenerateCandidates(
+    const vtkm::cont::ArrayHandle<vtkm::Id>& numCandidates,
+    DeviceAdapter) const
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    vtkm::worklet::ScatterCounting scatter(numCandidates, DeviceAdapter());
+    brickrange::GenerateCandidateCells generate(
+      this->CellDimensions, this->BrickDimensions, this->BrickSize);
+    vtkm::worklet::DispatcherMapField<brickrange::GenerateCandidateCells, DeviceAdapter>
+      generateDispatcher(generate, scatter);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> cellIds;
+    generateDispatcher.Invoke(vtkm::cont::ArrayHandleIndex(numCandidates.GetNumberOfValues()),
+                              cellIds);
+
+    // Bricks are not contiguous in cell id space. Sorting keeps the cells in
+    // the same order as a full traversal of the grid.
+    Algorithm::Sort(cellIds);
+    return cellIds;
+  }
+
+  vtkm::Id BrickSize;
+  vtkm::Id3 CellDimensions;
+  vtkm::Id3 BrickDimensions;
+  std::string FieldName;
+  vtkm::cont::DynamicArrayHandle PointField;
+  vtkm::cont::ArrayHandle<vtkm::Range> BrickRanges;
+  vtkm::cont::ArrayHandle<vtkm::Id> BrickNumberOfCells;
+};
+}
+} // namespace vtkm::worklet
+
+#endif // vtk_m_worklet_BrickRangeIndex_h
@@ -25,6 +25,7 @@
 #include <vtkm/worklet/internal/ClipTables.h>
 
 #include <vtkm/cont/ArrayHandlePermutation.h>
+#include <vtkm/cont/CellSetPermutation.h>
 #include <vtkm/cont/CellSetExplicit.h>
 #include <vtkm/cont/CoordinateSystem.h>
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
@@ -486,78 +487,32 @@ public:
                                     bool invert,
                                     DeviceAdapter device)
   {
-    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
-
-    using ClipTablesPortal = internal::ClipTables::DevicePortal<DeviceAdapter>;
-    ClipTablesPortal clipTablesDevicePortal = this->ClipTablesInstance.GetDevicePortal(device);
-
-    // Step 1. compute counts for the elements of the cell set data structure
-    vtkm::cont::ArrayHandle<vtkm::Id> clipTableIdxs;
-    vtkm::cont::ArrayHandle<ClipStats> stats;
-
-    ComputeStats<DeviceAdapter> computeStats(value, clipTablesDevicePortal, invert);
-    DispatcherMapTopology<ComputeStats<DeviceAdapter>, DeviceAdapter>(computeStats)
-      .Invoke(cellSet, scalars, clipTableIdxs, stats);
-
-    // compute offsets for each invocation
-    ClipStats zero;
-    vtkm::cont::ArrayHandle<ClipStats> cellSetIndices;
-    ClipStats total = Algorithm::ScanExclusive(stats, cellSetIndices, ClipStats::SumOp(), zero);
-    stats.ReleaseResources();
-
-    // Step 2. generate the output cell set
-    vtkm::cont::ArrayHandle<vtkm::UInt8> shapes;
-    vtkm::cont::ArrayHandle<vtkm::IdComponent> numIndices;
-    vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
-    vtkm::cont::ArrayHandle<vtkm::Id> cellToConnectivityMap;
-    internal::ExecutionConnectivityExplicit outConnectivity(
-      shapes, numIndices, connectivity, cellToConnectivityMap, total);
-
-    vtkm::cont::ArrayHandle<EdgeInterpolation> newPoints;
-    newPoints.Allocate(total.NumberOfNewPoints);
-    // reverse map from the new points to connectivity array
-    vtkm::cont::ArrayHandle<vtkm::Id> newPointsConnectivityReverseMap;
-    newPointsConnectivityReverseMap.Allocate(total.NumberOfNewPoints);
-
-    this->CellIdMap.Allocate(total.NumberOfCells);
-
-    GenerateCellSet<DeviceAdapter> generateCellSet(value, clipTablesDevicePortal);
-    DispatcherMapTopology<GenerateCellSet<DeviceAdapter>, DeviceAdapter>(generateCellSet)
-      .Invoke(cellSet,
-              scalars,
-              clipTableIdxs,
-              cellSetIndices,
-              outConnectivity,
-              newPoints,
-              newPointsConnectivityReverseMap,
-              this->CellIdMap);
-    cellSetIndices.ReleaseResources();
-
-    // Step 3. remove duplicates from the list of new points
-    vtkm::cont::ArrayHandle<vtkm::worklet::EdgeInterpolation> uniqueNewPoints;
-
-    Algorithm::SortByKey(
-      newPoints, newPointsConnectivityReverseMap, EdgeInterpolation::LessThanOp());
-    Algorithm::Copy(newPoints, uniqueNewPoints);
-    Algorithm::Unique(uniqueNewPoints, EdgeInterpolation::EqualToOp());
-
-    this->NewPointsInterpolation = uniqueNewPoints;
-    this->NewPointsOffset = scalars.GetNumberOfValues();
+    return this->DoRun(cellSet, scalars, value, invert, device);
+  }
 
-    // Step 4. update the connectivity array with indexes to the new, unique points
-    AmendConnectivity<DeviceAdapter> computeNewPointsConnectivity(
-      newPoints.PrepareForInput(device),
-      uniqueNewPoints.PrepareForInput(device),
-      newPointsConnectivityReverseMap.PrepareForInput(device),
-      this->NewPointsOffset,
-      connectivity.PrepareForInPlace(device));
-    Algorithm::Schedule(computeNewPointsConnectivity, total.NumberOfNewPoints);
+  /// Same as \c Run, but only the cells listed in \c candidateCellIds are
+  /// visited. The ids must be sorted and must include every cell that is not
+  /// entirely discarded by the clip (see \c BrickRangeIndex), in which case
+  /// the output is identical to clipping the whole cell set.
+  template <typename CellSetType, typename ScalarsArrayHandle, typename DeviceAdapter>
+  vtkm::cont::CellSetExplicit<> RunOnCandidates(
+    const CellSetType& cellSet,
+    const ScalarsArrayHandle& scalars,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& candidateCellIds,
+    vtkm::Float64 value,
+    bool invert,
+    DeviceAdapter device)
+  {
+    auto candidateCells = vtkm::cont::make_CellSetPermutation(candidateCellIds, cellSet);
+    vtkm::cont::CellSetExplicit<> output =
+      this->DoRun(candidateCells, scalars, value, invert, device);
 
-    vtkm::cont::CellSetExplicit<> output;
-    output.Fill(this->NewPointsOffset + uniqueNewPoints.GetNumberOfValues(),
-                shapes,
-                numIndices,
-                connectivity);
+    // CellIdMap refers to positions in the candidate list; map it back to the
+    // ids of the input cells.
+    vtkm::cont::ArrayHandle<vtkm::Id> cellIdMap;
+    vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>::Copy(
+      vtkm::cont::make_ArrayHandlePermutation(this->CellIdMap, candidateCellIds), cellIdMap);
+    this->CellIdMap = cellIdMap;
 
     return output;
   }
@@ -727,6 +682,89 @@ public:
   }
 
 private:
+  template <typename CellSetType, typename ScalarsArrayHandle, typename DeviceAdapter>
+  vtkm::cont::CellSetExplicit<> DoRun(const CellSetType& cellSet,
+                                      const ScalarsArrayHandle& scalars,
+                                      vtkm::Float64 value,
+                                      bool invert,
+                                      DeviceAdapter device)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    using ClipTablesPortal = internal::ClipTables::DevicePortal<DeviceAdapter>;
+    ClipTablesPortal clipTablesDevicePortal = this->ClipTablesInstance.GetDevicePortal(device);
+
+    // Step 1. compute counts for the elements of the cell set data structure
+    vtkm::cont::ArrayHandle<vtkm::Id> clipTableIdxs;
+    vtkm::cont::ArrayHandle<ClipStats> stats;
+
+    ComputeStats<DeviceAdapter> computeStats(value, clipTablesDevicePortal, invert);
+    DispatcherMapTopology<ComputeStats<DeviceAdapter>, DeviceAdapter>(computeStats)
+      .Invoke(cellSet, scalars, clipTableIdxs, stats);
+
+    // compute offsets for each invocation
+    ClipStats zero;
+    vtkm::cont::ArrayHandle<ClipStats> cellSetIndices;
+    ClipStats total = Algorithm::ScanExclusive(stats, cellSetIndices, ClipStats::SumOp(), zero);
+    stats.ReleaseResources();
+
+    // Step 2. generate the output cell set
+    vtkm::cont::ArrayHandle<vtkm::UInt8> shapes;
+    vtkm::cont::ArrayHandle<vtkm::IdComponent> numIndices;
+    vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
+    vtkm::cont::ArrayHandle<vtkm::Id> cellToConnectivityMap;
+    internal::ExecutionConnectivityExplicit outConnectivity(
+      shapes, numIndices, connectivity, cellToConnectivityMap, total);
+
+    vtkm::cont::ArrayHandle<EdgeInterpolation> newPoints;
+    newPoints.Allocate(total.NumberOfNewPoints);
+    // reverse map from the new points to connectivity array
+    vtkm::cont::ArrayHandle<vtkm::Id> newPointsConnectivityReverseMap;
+    newPointsConnectivityReverseMap.Allocate(total.NumberOfNewPoints);
+
+    this->CellIdMap.Allocate(total.NumberOfCells);
+
+    GenerateCellSet<DeviceAdapter> generateCellSet(value, clipTablesDevicePortal);
+    DispatcherMapTopology<GenerateCellSet<DeviceAdapter>, DeviceAdapter>(generateCellSet)
+      .Invoke(cellSet,
+              scalars,
+              clipTableIdxs,
+              cellSetIndices,
+              outConnectivity,
+              newPoints,
+              newPointsConnectivityReverseMap,
+              this->CellIdMap);
+    cellSetIndices.ReleaseResources();
+
+    // Step 3. remove duplicates from the list of new points
+    vtkm::cont::ArrayHandle<vtkm::worklet::EdgeInterpolation> uniqueNewPoints;
+
+    Algorithm::SortByKey(
+      newPoints, newPointsConnectivityReverseMap, EdgeInterpolation::LessThanOp());
+    Algorithm::Copy(newPoints, uniqueNewPoints);
+    Algorithm::Unique(uniqueNewPoints, EdgeInterpolation::EqualToOp());
+
+    this->NewPointsInterpolation = uniqueNewPoints;
+    this->NewPointsOffset = scalars.GetNumberOfValues();
+
+    // Step 4. update the connectivity array with indexes to the new, unique points
+    AmendConnectivity<DeviceAdapter> computeNewPointsConnectivity(
+      newPoints.PrepareForInput(device),
+      uniqueNewPoints.PrepareForInput(device),
+      newPointsConnectivityReverseMap.PrepareForInput(device),
+      this->NewPointsOffset,
+      connectivity.PrepareForInPlace(device));
+    Algorithm::Schedule(computeNewPointsConnectivity, total.NumberOfNewPoints);
+
+    vtkm::cont::CellSetExplicit<> output;
+    output.Fill(this->NewPointsOffset + uniqueNewPoints.GetNumberOfValues(),
+                shapes,
+                numIndices,
+                connectivity);
+
+    return output;
+  }
+
   internal::ClipTables ClipTablesInstance;
   vtkm::cont::ArrayHandle<EdgeInterpolation> NewPointsInterpolation;
   vtkm::cont::ArrayHandle<vtkm::Id> CellIdMap;
@@ -69,8 +69,11 @@
 
 #include <vtkm/Math.h>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleConcatenate.h>
 #include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/Field.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
@@ -84,11 +87,14 @@
 #pragma GCC diagnostic ignored "-Wstrict-overflow"
 #endif
 
+#include <vtkm/worklet/contourtree/BoundaryTree.h>
 #include <vtkm/worklet/contourtree/ChainGraph.h>
 #include <vtkm/worklet/contourtree/ContourTree.h>
 #include <vtkm/worklet/contourtree/MergeTree.h>
 #include <vtkm/worklet/contourtree/Mesh2D_DEM_Triangulation.h>
 #include <vtkm/worklet/contourtree/Mesh3D_DEM_Triangulation.h>
+#include <vtkm/worklet/contourtree/MeshExplicit_Triangulation.h>
+#include <vtkm/worklet/contourtree/SharedVertexCounter.h>
 
 const bool JOIN = true;
 const bool SPLIT = false;
@@ -99,6 +105,110 @@ namespace vtkm
 {
 namespace worklet
 {
+namespace detail
+{
+
+struct IsSharedVertex
+{
+  VTKM_EXEC_CONT bool operator()(vtkm::Id nSharing) const { return nSharing > 1; }
+};
+
+// Computes the join and split trees of one block of a decomposed volume and keeps them on
+// the critical points and on the vertices the block shares with its neighbours. Vertex
+// indices are converted to indices into the whole volume so that the trees of different
+// blocks can be merged.
+template <typename MeshType, typename FieldType, typename StorageType, typename DeviceAdapter>
+void ComputeBoundaryTree(const vtkm::cont::ArrayHandle<FieldType, StorageType>& fieldArray,
+                         MeshType& mesh,
+                         const vtkm::Id3& blockDims,
+                         const vtkm::Id3& blockOrigin,
+                         const vtkm::Id3& globalDims,
+                         contourtree::BoundaryTree& boundaryTree,
+                         DeviceAdapter)
+{
+  using DeviceAlgorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+  using IdArrayType = vtkm::cont::ArrayHandle<vtkm::Id>;
+
+  // the mesh stores the block as rows of columns, the x axis running along each row
+  vtkm::Id nRows = blockDims[1];
+  vtkm::Id nCols = blockDims[0];
+  vtkm::Id nSlices = blockDims[2];
+
+  contourtree::MergeTree<FieldType, StorageType, DeviceAdapter> joinTree(
+    fieldArray, nRows, nCols, nSlices, JOIN);
+  mesh.SetStarts(joinTree.extrema, JOIN);
+  joinTree.BuildRegularChains();
+  contourtree::ChainGraph<FieldType, StorageType, DeviceAdapter> joinGraph(
+    fieldArray, joinTree.extrema, JOIN);
+  mesh.SetSaddleStarts(joinGraph, JOIN);
+  joinGraph.Compute(joinTree.saddles);
+
+  contourtree::MergeTree<FieldType, StorageType, DeviceAdapter> splitTree(
+    fieldArray, nRows, nCols, nSlices, SPLIT);
+  mesh.SetStarts(splitTree.extrema, SPLIT);
+  splitTree.BuildRegularChains();
+  contourtree::ChainGraph<FieldType, StorageType, DeviceAdapter> splitGraph(
+    fieldArray, splitTree.extrema, SPLIT);
+  mesh.SetSaddleStarts(splitGraph, SPLIT);
+  splitGraph.Compute(splitTree.saddles);
+
+  // find the vertices on faces shared with other blocks
+  vtkm::Id nVertices = fieldArray.GetNumberOfValues();
+  vtkm::cont::ArrayHandleIndex vertexIndexArray(nVertices);
+  IdArrayType nSharing;
+  contourtree::SharedVertexCounter sharedVertexCounter(blockDims, blockOrigin, globalDims);
+  vtkm::worklet::DispatcherMapField<contourtree::SharedVertexCounter, DeviceAdapter>
+    sharedVertexCounterDispatcher(sharedVertexCounter);
+  sharedVertexCounterDispatcher.Invoke(vertexIndexArray, // input
+                                       nSharing);        // output
+  IdArrayType sharedVertices;
+  DeviceAlgorithm::CopyIf(vertexIndexArray, nSharing, sharedVertices, IsSharedVertex());
+
+  // the trees are kept on the union of the critical points of both and the shared vertices
+  IdArrayType candidates;
+  vtkm::cont::ArrayHandleConcatenate<IdArrayType, IdArrayType> criticalArray(
+    joinGraph.valueIndex, splitGraph.valueIndex);
+  DeviceAlgorithm::Copy(
+    vtkm::cont::make_ArrayHandleConcatenate(criticalArray, sharedVertices), candidates);
+  DeviceAlgorithm::Sort(candidates);
+  DeviceAlgorithm::Unique(candidates);
+
+  joinTree.ComputeAugmentedSuperarcs();
+  joinTree.ComputeAugmentedArcs(candidates);
+  splitTree.ComputeAugmentedSuperarcs();
+  splitTree.ComputeAugmentedArcs(candidates);
+
+  // copy the arcs out with global vertex indices; local indices are row-major like the
+  // global ones, so the order of the vertices is preserved
+  auto toGlobal = [&](vtkm::Id vertex) {
+    if (vertex == NO_VERTEX_ASSIGNED)
+      return vertex;
+    vtkm::Id col = vertex % nCols;
+    vtkm::Id row = (vertex / nCols) % nRows;
+    vtkm::Id slice = vertex / (nCols * nRows);
+    return (blockOrigin[0] + col) +
+      globalDims[0] * ((blockOrigin[1] + row) + globalDims[1] * (blockOrigin[2] + slice));
+  };
+
+  auto candidatePortal = candidates.GetPortalConstControl();
+  auto valuePortal = fieldArray.GetPortalConstControl();
+  auto joinArcPortal = joinTree.mergeArcs.GetPortalConstControl();
+  auto splitArcPortal = splitTree.mergeArcs.GetPortalConstControl();
+  auto sharingPortal = nSharing.GetPortalConstControl();
+  boundaryTree = contourtree::BoundaryTree();
+  for (vtkm::Id candidate = 0; candidate < candidates.GetNumberOfValues(); candidate++)
+  {
+    vtkm::Id vertex = candidatePortal.Get(candidate);
+    boundaryTree.AddVertex(toGlobal(vertex),
+                           static_cast<vtkm::Float64>(valuePortal.Get(vertex)),
+                           toGlobal(joinArcPortal.Get(vertex)),
+                           toGlobal(splitArcPortal.Get(vertex)),
+                           sharingPortal.Get(vertex),
+                           1);
+  }
+  boundaryTree.Simplify();
+}
+} // namespace detail
 
 class ContourTreeMesh2D
 {
@@ -153,6 +263,26 @@ public:
 
     contourTree.CollectSaddlePeak(saddlePeak);
   }
+
+  /// Computes the boundary tree of one block of a 2D volume decomposed into blocks that
+  /// share the points on their common edges. \c blockDims are the point dimensions of
+  /// the block, \c blockOrigin the index of its first point in the whole volume and
+  /// \c globalDims the point dimensions of the whole volume, with third components of
+  /// 1, 0 and 1. The boundary trees of all blocks can be merged with
+  /// contourtree::BoundaryTree::Merge and turned into the contour tree of the volume.
+  template <typename FieldType, typename StorageType, typename DeviceAdapter>
+  void RunBoundaryTree(const vtkm::cont::ArrayHandle<FieldType, StorageType> fieldArray,
+                       const vtkm::Id3& blockDims,
+                       const vtkm::Id3& blockOrigin,
+                       const vtkm::Id3& globalDims,
+                       contourtree::BoundaryTree& boundaryTree,
+                       const DeviceAdapter& device)
+  {
+    contourtree::Mesh2D_DEM_Triangulation<FieldType, StorageType, DeviceAdapter> mesh(
+      fieldArray, blockDims[1], blockDims[0]);
+    detail::ComputeBoundaryTree(
+      fieldArray, mesh, blockDims, blockOrigin, globalDims, boundaryTree, device);
+  }
 };
 
 class ContourTreeMesh3D
@@ -207,6 +337,94 @@ public:
 
     contourTree.CollectSaddlePeak(saddlePeak);
   }
+
+  /// Computes the boundary tree of one block of a 3D volume decomposed into blocks that
+  /// share the points on their common faces. \c blockDims are the point dimensions of
+  /// the block, \c blockOrigin the index of its first point in the whole volume and
+  /// \c globalDims the point dimensions of the whole volume. The boundary trees of all
+  /// blocks can be merged with contourtree::BoundaryTree::Merge and turned into the
+  /// contour tree of the volume.
+  template <typename FieldType, typename StorageType, typename DeviceAdapter>
+  void RunBoundaryTree(const vtkm::cont::ArrayHandle<FieldType, StorageType> fieldArray,
+                       const vtkm::Id3& blockDims,
+                       const vtkm::Id3& blockOrigin,
+                       const vtkm::Id3& globalDims,
+                       contourtree::BoundaryTree& boundaryTree,
+                       const DeviceAdapter& device)
+  {
+    contourtree::Mesh3D_DEM_Triangulation<FieldType, StorageType, DeviceAdapter> mesh(
+      fieldArray, blockDims[1], blockDims[0], blockDims[2]);
+    detail::ComputeBoundaryTree(
+      fieldArray, mesh, blockDims, blockOrigin, globalDims, boundaryTree, device);
+  }
+};
+
+/// Computes the contour tree of a point field on an explicit cell set, such as a
+/// tetrahedral or triangle mesh. The neighbourhood of each point is given by the cells
+/// incident to it, and the cells are treated as simplices. The mesh must be connected,
+/// otherwise vtkm::cont::ErrorBadValue is thrown.
+class ContourTreeMeshExplicit
+{
+public:
+  template <typename FieldType,
+            typename StorageType,
+            typename CellSetType,
+            typename DeviceAdapter>
+  void Run(const vtkm::cont::ArrayHandle<FieldType, StorageType> fieldArray,
+           const CellSetType& cellSet,
+           vtkm::cont::ArrayHandle<vtkm::Pair<vtkm::Id, vtkm::Id>>& saddlePeak,
+           const DeviceAdapter& device)
+  {
+    // DeviceAdapter is passed only to be available in template but is not used
+    (void)device;
+
+    // The merge trees only need the number of vertices, so the mesh is a single row
+    vtkm::Id nRows = 1;
+    vtkm::Id nCols = fieldArray.GetNumberOfValues();
+    vtkm::Id nSlices = 1;
+
+    // Build the mesh and fill in the values
+    contourtree::MeshExplicit_Triangulation<FieldType, StorageType, DeviceAdapter> mesh(
+      fieldArray, cellSet);
+    if (mesh.CountComponents() > 1)
+    {
+      throw vtkm::cont::ErrorBadValue("The mesh of a contour tree must be connected.");
+    }
+
+    // Initialize the join tree so that all arcs point to maxima
+    contourtree::MergeTree<FieldType, StorageType, DeviceAdapter> joinTree(
+      fieldArray, nRows, nCols, nSlices, JOIN);
+    mesh.SetStarts(joinTree.extrema, JOIN);
+    joinTree.BuildRegularChains();
+
+    // Create the active topology graph from the regular graph
+    contourtree::ChainGraph<FieldType, StorageType, DeviceAdapter> joinGraph(
+      fieldArray, joinTree.extrema, JOIN);
+    mesh.SetSaddleStarts(joinGraph, JOIN);
+
+    // Call join graph to finish computation
+    joinGraph.Compute(joinTree.saddles);
+
+    // Initialize the split tree so that all arcs point to minima
+    contourtree::MergeTree<FieldType, StorageType, DeviceAdapter> splitTree(
+      fieldArray, nRows, nCols, nSlices, SPLIT);
+    mesh.SetStarts(splitTree.extrema, SPLIT);
+    splitTree.BuildRegularChains();
+
+    // Create the active topology graph from the regular graph
+    contourtree::ChainGraph<FieldType, StorageType, DeviceAdapter> splitGraph(
+      fieldArray, splitTree.extrema, SPLIT);
+    mesh.SetSaddleStarts(splitGraph, SPLIT);
+
+    // Call split graph to finish computation
+    splitGraph.Compute(splitTree.saddles);
+
+    // Now compute the contour tree
+    contourtree::ContourTree<FieldType, StorageType, DeviceAdapter> contourTree(
+      fieldArray, joinTree, splitTree, joinGraph, splitGraph);
+
+    contourTree.CollectSaddlePeak(saddlePeak);
+  }
 };
 }
 } // namespace vtkm::worklet
@@ -142,6 +142,30 @@ public:
     mxnResult.first = mxnMBP;
     mxnResult.second = mxnPotential;
   }
+
+  // Run MBP on a single halo of particles using a tree code over a hierarchy of bins
+  // theta is the opening angle, with theta = 0 matching the N^2 algorithm
+  template <typename FieldType, typename StorageType, typename DeviceAdapter>
+  void RunMBPCenterFinderTree(vtkm::cont::ArrayHandle<FieldType, StorageType> xLocation,
+                              vtkm::cont::ArrayHandle<FieldType, StorageType> yLocation,
+                              vtkm::cont::ArrayHandle<FieldType, StorageType> zLocation,
+                              const vtkm::Id nParticles,
+                              const FieldType particleMass,
+                              const FieldType theta,
+                              vtkm::Pair<vtkm::Id, FieldType>& treeResult,
+                              const DeviceAdapter&)
+  {
+    // Constructor gets particle locations and particle mass
+    cosmotools::CosmoTools<FieldType, StorageType, DeviceAdapter> cosmo(
+      nParticles, particleMass, xLocation, yLocation, zLocation);
+
+    // Most Bound Particle with potentials approximated by far away bins
+    FieldType treePotential;
+    vtkm::Id treeMBP = cosmo.MBPCenterFinderTree(&treePotential, theta);
+
+    treeResult.first = treeMBP;
+    treeResult.second = treePotential;
+  }
 };
 }
 } // namespace vtkm::worklet
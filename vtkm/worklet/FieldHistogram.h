@@ -23,10 +23,8 @@
 
 #include <vtkm/Math.h>
 #include <vtkm/cont/ArrayHandle.h>
-#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleTransform.h>
 #include <vtkm/cont/DeviceAdapter.h>
-#include <vtkm/worklet/DispatcherMapField.h>
-#include <vtkm/worklet/WorkletMapField.h>
 
 #include <vtkm/cont/Field.h>
 
@@ -62,57 +60,35 @@ namespace worklet
 class FieldHistogram
 {
 public:
-  // For each value set the bin it should be in
+  // Computes the bin of a value. It is applied through an ArrayHandleTransform
+  // while the bins are counted, so the bin indices are never stored.
   template <typename FieldType>
-  class SetHistogramBin : public vtkm::worklet::WorkletMapField
+  class ComputeBin
   {
   public:
-    using ControlSignature = void(FieldIn<> value, FieldOut<> binIndex);
-    using ExecutionSignature = void(_1, _2);
-    using InputDomain = _1;
-
     vtkm::Id numberOfBins;
     FieldType minValue;
     FieldType delta;
 
+    ComputeBin() = default;
+
     VTKM_CONT
-    SetHistogramBin(vtkm::Id numberOfBins0, FieldType minValue0, FieldType delta0)
+    ComputeBin(vtkm::Id numberOfBins0, FieldType minValue0, FieldType delta0)
       : numberOfBins(numberOfBins0)
       , minValue(minValue0)
       , delta(delta0)
     {
     }
 
-    VTKM_EXEC
-    void operator()(const FieldType& value, vtkm::Id& binIndex) const
+    VTKM_EXEC_CONT
+    vtkm::Id operator()(const FieldType& value) const
     {
-      binIndex = static_cast<vtkm::Id>((value - minValue) / delta);
+      vtkm::Id binIndex = static_cast<vtkm::Id>((value - minValue) / delta);
       if (binIndex < 0)
         binIndex = 0;
       else if (binIndex >= numberOfBins)
         binIndex = numberOfBins - 1;
-    }
-  };
-
-  // Calculate the adjacent difference between values in ArrayHandle
-  class AdjacentDifference : public vtkm::worklet::WorkletMapField
-  {
-  public:
-    using ControlSignature = void(FieldIn<IdType> inputIndex,
-                                  WholeArrayIn<IdType> counts,
-                                  FieldOut<IdType> outputCount);
-    using ExecutionSignature = void(_1, _2, _3);
-    using InputDomain = _1;
-
-    template <typename WholeArrayType>
-    VTKM_EXEC void operator()(const vtkm::Id& index,
-                              const WholeArrayType& counts,
-                              vtkm::Id& difference) const
-    {
-      if (index == 0)
-        difference = counts.Get(index);
-      else
-        difference = counts.Get(index) - counts.Get(index - 1);
+      return binIndex;
     }
   };
 
@@ -156,31 +132,13 @@ public:
            DeviceAdapter vtkmNotUsed(device))
   {
     using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
-    const vtkm::Id numberOfValues = fieldArray.GetNumberOfValues();
-
     const FieldType fieldDelta = compute_delta(fieldMinValue, fieldMaxValue, numberOfBins);
 
-    // Worklet fills in the bin belonging to each value
-    vtkm::cont::ArrayHandle<vtkm::Id> binIndex;
-    binIndex.Allocate(numberOfValues);
-
-    // Worklet to set the bin number for each data value
-    SetHistogramBin<FieldType> binWorklet(numberOfBins, fieldMinValue, fieldDelta);
-    vtkm::worklet::DispatcherMapField<SetHistogramBin<FieldType>, DeviceAdapter>
-      setHistogramBinDispatcher(binWorklet);
-    setHistogramBinDispatcher.Invoke(fieldArray, binIndex);
-
-    // Sort the resulting bin array for counting
-    DeviceAlgorithms::Sort(binIndex);
-
-    // Get the upper bound of each bin number
-    vtkm::cont::ArrayHandle<vtkm::Id> totalCount;
-    vtkm::cont::ArrayHandleCounting<vtkm::Id> binCounter(0, 1, numberOfBins);
-    DeviceAlgorithms::UpperBounds(binIndex, binCounter, totalCount);
-
-    // Difference between adjacent items is the bin count
-    vtkm::worklet::DispatcherMapField<AdjacentDifference, DeviceAdapter> dispatcher;
-    dispatcher.Invoke(binCounter, totalCount, binArray);
+    // Count the values of each bin with private bins per block instead of
+    // sorting the bin indices
+    auto binIndex = vtkm::cont::make_ArrayHandleTransform(
+      fieldArray, ComputeBin<FieldType>(numberOfBins, fieldMinValue, fieldDelta));
+    DeviceAlgorithms::Histogram(binIndex, numberOfBins, binArray);
 
     //update the users data
     binDelta = fieldDelta;
@@ -23,9 +23,11 @@
 
 #include <vtkm/Math.h>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleTransform.h>
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/statistics/Moments.h>
 
 #include <vtkm/cont/Field.h>
 
@@ -62,131 +64,47 @@ public:
     FieldType centralMoment[4];
   };
 
-  class CalculatePowers : public vtkm::worklet::WorkletMapField
-  {
-  public:
-    using ControlSignature = void(FieldIn<> value,
-                                  FieldOut<> pow1Array,
-                                  FieldOut<> pow2Array,
-                                  FieldOut<> pow3Array,
-                                  FieldOut<> pow4Array);
-    using ExecutionSignature = void(_1, _2, _3, _4, _5);
-    using InputDomain = _1;
-
-    vtkm::Id numPowers;
-
-    VTKM_CONT
-    CalculatePowers(vtkm::Id num)
-      : numPowers(num)
-    {
-    }
-
-    VTKM_EXEC
-    void operator()(const FieldType& value,
-                    FieldType& pow1,
-                    FieldType& pow2,
-                    FieldType& pow3,
-                    FieldType& pow4) const
-    {
-      pow1 = value;
-      pow2 = pow1 * value;
-      pow3 = pow2 * value;
-      pow4 = pow3 * value;
-    }
-  };
-
-  class SubtractConst : public vtkm::worklet::WorkletMapField
-  {
-  public:
-    using ControlSignature = void(FieldIn<> value, FieldOut<> diff);
-    using ExecutionSignature = _2(_1);
-    using InputDomain = _1;
-
-    FieldType constant;
-
-    VTKM_CONT
-    SubtractConst(const FieldType& constant0)
-      : constant(constant0)
-    {
-    }
-
-    VTKM_EXEC
-    FieldType operator()(const FieldType& value) const { return (value - constant); }
-  };
-
   template <typename Storage>
   void Run(vtkm::cont::ArrayHandle<FieldType, Storage> fieldArray, StatInfo& statinfo)
   {
     using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
-    using FieldPortal = typename vtkm::cont::ArrayHandle<FieldType, Storage>::PortalConstControl;
-
-    // Copy original data to array for sorting
-    vtkm::cont::ArrayHandle<FieldType> tempArray;
-    DeviceAlgorithms::Copy(fieldArray, tempArray);
-    DeviceAlgorithms::Sort(tempArray);
-
-    FieldPortal tempPortal = tempArray.GetPortalConstControl();
-    vtkm::Id dataSize = tempPortal.GetNumberOfValues();
-    FieldType numValues = static_cast<FieldType>(dataSize);
-
-    // Median
-    statinfo.median = tempPortal.Get(dataSize / 2);
-
-    // Minimum and maximum
-    const vtkm::Vec<FieldType, 2> initValue(tempPortal.Get(0));
-    vtkm::Vec<FieldType, 2> result =
-      DeviceAlgorithms::Reduce(fieldArray, initValue, vtkm::MinAndMax<FieldType>());
-    statinfo.minimum = result[0];
-    statinfo.maximum = result[1];
-
-    // Mean
-    FieldType sum = DeviceAlgorithms::ScanInclusive(fieldArray, tempArray);
-    statinfo.mean = sum / numValues;
-    statinfo.rawMoment[FIRST] = sum / numValues;
-
-    // Create the power sum vector for each value
-    vtkm::cont::ArrayHandle<FieldType> pow1Array, pow2Array, pow3Array, pow4Array;
-    pow1Array.Allocate(dataSize);
-    pow2Array.Allocate(dataSize);
-    pow3Array.Allocate(dataSize);
-    pow4Array.Allocate(dataSize);
-
-    // Raw moments via Worklet
-    vtkm::worklet::DispatcherMapField<CalculatePowers, DeviceAdapter> calculatePowersDispatcher(
-      CalculatePowers(4));
-    calculatePowersDispatcher.Invoke(fieldArray, pow1Array, pow2Array, pow3Array, pow4Array);
-
-    // Accumulate the results using ScanInclusive
-    statinfo.rawMoment[FIRST] = DeviceAlgorithms::ScanInclusive(pow1Array, pow1Array) / numValues;
-    statinfo.rawMoment[SECOND] = DeviceAlgorithms::ScanInclusive(pow2Array, pow2Array) / numValues;
-    statinfo.rawMoment[THIRD] = DeviceAlgorithms::ScanInclusive(pow3Array, pow3Array) / numValues;
-    statinfo.rawMoment[FOURTH] = DeviceAlgorithms::ScanInclusive(pow4Array, pow4Array) / numValues;
-
-    // Subtract the mean from every value and leave in tempArray
-    vtkm::worklet::DispatcherMapField<SubtractConst, DeviceAdapter> subtractConstDispatcher(
-      SubtractConst(statinfo.mean));
-    subtractConstDispatcher.Invoke(fieldArray, tempArray);
-
-    // Calculate sums of powers on the (value - mean) array
-    calculatePowersDispatcher.Invoke(tempArray, pow1Array, pow2Array, pow3Array, pow4Array);
 
-    // Accumulate the results using ScanInclusive
-    statinfo.centralMoment[FIRST] =
-      DeviceAlgorithms::ScanInclusive(pow1Array, pow1Array) / numValues;
-    statinfo.centralMoment[SECOND] =
-      DeviceAlgorithms::ScanInclusive(pow2Array, pow2Array) / numValues;
-    statinfo.centralMoment[THIRD] =
-      DeviceAlgorithms::ScanInclusive(pow3Array, pow3Array) / numValues;
-    statinfo.centralMoment[FOURTH] =
-      DeviceAlgorithms::ScanInclusive(pow4Array, pow4Array) / numValues;
+    vtkm::Id dataSize = fieldArray.GetNumberOfValues();
+
+    // Median, selected without sorting the data
+    statinfo.median = DeviceAlgorithms::SelectNth(fieldArray, dataSize / 2);
+
+    // Minimum, maximum, mean and central moments in a single pass
+    auto moments =
+      vtkm::cont::make_ArrayHandleTransform(fieldArray, vtkm::worklet::statistics::MakeMoments());
+    const vtkm::worklet::statistics::Moments result = DeviceAlgorithms::Reduce(
+      moments, vtkm::worklet::statistics::Moments(), vtkm::worklet::statistics::CombineMoments());
+    statinfo.minimum = static_cast<FieldType>(result.Minimum);
+    statinfo.maximum = static_cast<FieldType>(result.Maximum);
+    statinfo.mean = static_cast<FieldType>(result.Mean);
+
+    const vtkm::Float64 mean = result.Mean;
+    const vtkm::Float64 central2 = result.M2 / result.Count;
+    const vtkm::Float64 central3 = result.M3 / result.Count;
+    const vtkm::Float64 central4 = result.M4 / result.Count;
+    statinfo.centralMoment[FIRST] = static_cast<FieldType>(0);
+    statinfo.centralMoment[SECOND] = static_cast<FieldType>(central2);
+    statinfo.centralMoment[THIRD] = static_cast<FieldType>(central3);
+    statinfo.centralMoment[FOURTH] = static_cast<FieldType>(central4);
+
+    // Raw moments from the central moments
+    statinfo.rawMoment[FIRST] = static_cast<FieldType>(mean);
+    statinfo.rawMoment[SECOND] = static_cast<FieldType>(central2 + mean * mean);
+    statinfo.rawMoment[THIRD] =
+      static_cast<FieldType>(central3 + 3 * mean * central2 + mean * mean * mean);
+    statinfo.rawMoment[FOURTH] = static_cast<FieldType>(
+      central4 + 4 * mean * central3 + 6 * mean * mean * central2 + mean * mean * mean * mean);
 
     // Statistics from the moments
-    statinfo.variance = statinfo.centralMoment[SECOND];
-    statinfo.stddev = Sqrt(statinfo.variance);
-    statinfo.skewness =
-      statinfo.centralMoment[THIRD] / Pow(statinfo.stddev, static_cast<FieldType>(3.0));
-    statinfo.kurtosis =
-      statinfo.centralMoment[FOURTH] / Pow(statinfo.stddev, static_cast<FieldType>(4.0));
+    statinfo.variance = static_cast<FieldType>(central2);
+    statinfo.stddev = static_cast<FieldType>(vtkm::Sqrt(central2));
+    statinfo.skewness = static_cast<FieldType>(result.GetSkewness());
+    statinfo.kurtosis = static_cast<FieldType>(result.GetKurtosis());
   }
 };
 }
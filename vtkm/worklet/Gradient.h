@@ -21,6 +21,8 @@
 #ifndef vtk_m_worklet_Gradient_h
 #define vtk_m_worklet_Gradient_h
 
+#include <vtkm/cont/CellSetStructured.h>
+
 #include <vtkm/worklet/DispatcherMapTopology.h>
 #include <vtkm/worklet/DispatcherPointNeighborhood.h>
 
@@ -29,6 +31,7 @@
 #include <vtkm/worklet/gradient/GradientOutput.h>
 #include <vtkm/worklet/gradient/PointGradient.h>
 #include <vtkm/worklet/gradient/QCriterion.h>
+#include <vtkm/worklet/gradient/StructuredPointDerivatives.h>
 #include <vtkm/worklet/gradient/StructuredPointGradient.h>
 #include <vtkm/worklet/gradient/Transpose.h>
 #include <vtkm/worklet/gradient/Vorticity.h>
@@ -44,6 +47,20 @@ struct GradientOutputFields;
 namespace gradient
 {
 
+//-----------------------------------------------------------------------------
+template <typename T>
+struct IsVec3 : std::false_type
+{
+};
+template <>
+struct IsVec3<vtkm::Vec<vtkm::Float32, 3>> : std::true_type
+{
+};
+template <>
+struct IsVec3<vtkm::Vec<vtkm::Float64, 3>> : std::true_type
+{
+};
+
 //-----------------------------------------------------------------------------
 template <typename CoordinateSystem, typename T, typename S, typename Device>
 struct DeducedPointGrad
@@ -70,6 +87,16 @@ struct DeducedPointGrad
 
   void operator()(const vtkm::cont::CellSetStructured<3>& cellset) const
   {
+    //When only derived quantities of a vector field are requested, compute
+    //them directly from the neighborhood instead of through the gradient
+    if (!this->Result->GetComputeGradient() &&
+        (this->Result->GetComputeDivergence() || this->Result->GetComputeVorticity() ||
+         this->Result->GetComputeQCriterion()))
+    {
+      this->Derivatives(cellset, typename IsVec3<T>::type());
+      return;
+    }
+
     vtkm::worklet::DispatcherPointNeighborhood<StructuredPointGradient<T>, Device> dispatcher;
     dispatcher.Invoke(cellset, //topology to iterate on a per point basis
                       *this->Points,
@@ -77,6 +104,25 @@ struct DeducedPointGrad
                       *this->Result);
   }
 
+  void Derivatives(const vtkm::cont::CellSetStructured<3>& cellset, std::true_type) const
+  {
+    StructuredPointDerivativesOutput<T> output(this->Result->GetComputeDivergence(),
+                                               this->Result->GetComputeVorticity(),
+                                               this->Result->GetComputeQCriterion(),
+                                               this->Result->Divergence,
+                                               this->Result->Vorticity,
+                                               this->Result->QCriterion,
+                                               cellset.GetNumberOfPoints());
+    vtkm::worklet::DispatcherPointNeighborhood<StructuredPointDerivatives<T>, Device> dispatcher;
+    dispatcher.Invoke(cellset, *this->Points, *this->Field, output);
+  }
+
+  void Derivatives(const vtkm::cont::CellSetStructured<3>& cellset, std::false_type) const
+  {
+    vtkm::worklet::DispatcherPointNeighborhood<StructuredPointGradient<T>, Device> dispatcher;
+    dispatcher.Invoke(cellset, *this->Points, *this->Field, *this->Result);
+  }
+
   template <typename PermIterType>
   void operator()(const vtkm::cont::CellSetPermutation<vtkm::cont::CellSetStructured<3>,
                                                        PermIterType>& cellset) const
@@ -21,7 +21,9 @@
 #define vtkm_m_worklet_KdTree3D_h
 
 #include <vtkm/worklet/spatialstructure/KdTree3DConstruction.h>
+#include <vtkm/worklet/spatialstructure/KdTree3DMortonConstruction.h>
 #include <vtkm/worklet/spatialstructure/KdTree3DNNSearch.h>
+#include <vtkm/worklet/spatialstructure/KdTree3DNeighborSearch.h>
 
 namespace vtkm
 {
@@ -31,8 +33,33 @@ namespace worklet
 class KdTree3D
 {
 public:
+  // BUILD_BALANCED splits every node at the median point along alternating
+  // axes, which takes three sorts up front and several passes over all points
+  // per level. BUILD_MORTON sorts the points once along a Morton curve and
+  // builds a tree of bounding boxes over buckets of consecutive points, which
+  // is much faster to build and uses less memory for large point sets.
+  enum BuildModeEnum
+  {
+    BUILD_BALANCED,
+    BUILD_MORTON
+  };
+
   KdTree3D() = default;
 
+  /// The build mode is used by the next call to \c Build.
+  VTKM_CONT
+  void SetBuildMode(BuildModeEnum mode) { this->BuildMode = mode; }
+
+  VTKM_CONT
+  BuildModeEnum GetBuildMode() const { return this->BuildMode; }
+
+  /// Number of points in each leaf of a \c BUILD_MORTON tree.
+  VTKM_CONT
+  void SetBucketSize(vtkm::Id bucketSize) { this->BucketSize = bucketSize; }
+
+  VTKM_CONT
+  vtkm::Id GetBucketSize() const { return this->BucketSize; }
+
   /// \brief Construct a 3D KD-tree for 3D point positions.
   ///
   /// \tparam CoordType type of the x, y, z component of the point coordinates.
@@ -45,8 +72,27 @@ public:
   void Build(const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag>& coords,
              DeviceAdapter device)
   {
-    vtkm::worklet::spatialstructure::KdTree3DConstruction().Run(
-      coords, this->PointIds, this->SplitIds, device);
+    this->TreeMode = this->BuildMode;
+    this->TreeBucketSize = this->BucketSize;
+    if (this->TreeMode == BUILD_MORTON)
+    {
+      this->SplitIds.ReleaseResources();
+      vtkm::worklet::spatialstructure::KdTree3DMortonConstruction().Run(coords,
+                                                                        this->TreeBucketSize,
+                                                                        this->PointIds,
+                                                                        this->NodeMin,
+                                                                        this->NodeMax,
+                                                                        this->MortonMin,
+                                                                        this->MortonInverseExtent,
+                                                                        device);
+    }
+    else
+    {
+      this->NodeMin.ReleaseResources();
+      this->NodeMax.ReleaseResources();
+      vtkm::worklet::spatialstructure::KdTree3DConstruction().Run(
+        coords, this->PointIds, this->SplitIds, device);
+    }
   }
 
   /// \brief Nearest neighbor search using KD-Tree
@@ -75,13 +121,127 @@ public:
            vtkm::cont::ArrayHandle<CoordType>& distances,
            DeviceAdapter device)
   {
+    if (this->TreeMode == BUILD_MORTON)
+    {
+      this->FindKNearestNeighbors(coords, queryPoints, 1, nearestNeighborIds, distances, device);
+      return;
+    }
     vtkm::worklet::spatialstructure::KdTree3DNNSearch().Run(
       coords, this->PointIds, this->SplitIds, queryPoints, nearestNeighborIds, distances, device);
   }
 
+  /// \brief k-nearest-neighbor search using KD-Tree
+  ///
+  /// Parallel search of the \c k nearest neighbors of each point in \c queryPoints in the set
+  /// of \c coords. Each query keeps a bounded heap of its \c k best candidates, which lives in
+  /// its own slice of the output arrays.
+  ///
+  /// \param coords Point coordinates the tree was built from.
+  /// \param queryPoints Point coordinates to find the neighbors of.
+  /// \param k Number of neighbors to find. It is clamped to the number of points in the tree.
+  /// \param neighborIds The neighbors of query \c i in entries [i * k, (i + 1) * k), sorted by
+  ///                    increasing distance.
+  /// \param distances Distances between the query points and their neighbors.
+  /// \param device Tag for selecting device adapter.
+  /// \return The number of neighbors found for each query, that is the clamped \c k.
+  template <typename CoordType,
+            typename CoordStorageTag1,
+            typename CoordStorageTag2,
+            typename DeviceAdapter>
+  vtkm::Id FindKNearestNeighbors(
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag1>& coords,
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag2>& queryPoints,
+    vtkm::Id k,
+    vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+    vtkm::cont::ArrayHandle<CoordType>& distances,
+    DeviceAdapter device)
+  {
+    using CoordHandleType = vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag1>;
+    vtkm::worklet::spatialstructure::KdTree3DNeighborSearch search;
+    if (this->TreeMode == BUILD_MORTON)
+    {
+      vtkm::worklet::spatialstructure::KdTree3DMortonExecutionObject<CoordHandleType> tree(
+        coords,
+        this->PointIds,
+        this->NodeMin,
+        this->NodeMax,
+        this->TreeBucketSize,
+        this->MortonMin,
+        this->MortonInverseExtent);
+      return search.RunKNearest(tree, queryPoints, k, neighborIds, distances, device);
+    }
+    vtkm::worklet::spatialstructure::KdTree3DExecutionObject<CoordHandleType> tree(
+      coords, this->PointIds, this->SplitIds);
+    return search.RunKNearest(tree, queryPoints, k, neighborIds, distances, device);
+  }
+
+  /// \brief Fixed-radius neighbor search using KD-Tree
+  ///
+  /// Parallel search of all points of \c coords within \c radius of each point in
+  /// \c queryPoints. The result is in compressed sparse row form: the neighbors of query \c i
+  /// start at \c offsets[i] in \c neighborIds and \c distances and there are
+  /// \c numNeighbors[i] of them, in no particular order. The neighbors are counted in a first
+  /// pass and written in a second one, so no query needs a bound on its number of neighbors.
+  ///
+  /// \param coords Point coordinates the tree was built from.
+  /// \param queryPoints Point coordinates to find the neighbors of.
+  /// \param radius Search radius. Points at exactly this distance are included.
+  /// \param numNeighbors Number of neighbors of each query point.
+  /// \param offsets Offset of the first neighbor of each query point.
+  /// \param neighborIds Neighbors of all query points.
+  /// \param distances Distances between the query points and their neighbors.
+  /// \param device Tag for selecting device adapter.
+  template <typename CoordType,
+            typename CoordStorageTag1,
+            typename CoordStorageTag2,
+            typename DeviceAdapter>
+  void FindNeighborsInRadius(
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag1>& coords,
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag2>& queryPoints,
+    vtkm::Float64 radius,
+    vtkm::cont::ArrayHandle<vtkm::IdComponent>& numNeighbors,
+    vtkm::cont::ArrayHandle<vtkm::Id>& offsets,
+    vtkm::cont::ArrayHandle<vtkm::Id>& neighborIds,
+    vtkm::cont::ArrayHandle<CoordType>& distances,
+    DeviceAdapter device)
+  {
+    using CoordHandleType = vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag1>;
+    vtkm::worklet::spatialstructure::KdTree3DNeighborSearch search;
+    if (this->TreeMode == BUILD_MORTON)
+    {
+      vtkm::worklet::spatialstructure::KdTree3DMortonExecutionObject<CoordHandleType> tree(
+        coords,
+        this->PointIds,
+        this->NodeMin,
+        this->NodeMax,
+        this->TreeBucketSize,
+        this->MortonMin,
+        this->MortonInverseExtent);
+      search.RunRadius(
+        tree, queryPoints, radius, numNeighbors, offsets, neighborIds, distances, device);
+      return;
+    }
+    vtkm::worklet::spatialstructure::KdTree3DExecutionObject<CoordHandleType> tree(
+      coords, this->PointIds, this->SplitIds);
+    search.RunRadius(
+      tree, queryPoints, radius, numNeighbors, offsets, neighborIds, distances, device);
+  }
+
 private:
+  BuildModeEnum BuildMode = BUILD_BALANCED;
+  vtkm::Id BucketSize = 16;
+  // mode and bucket size of the tree that was last built
+  BuildModeEnum TreeMode = BUILD_BALANCED;
+  vtkm::Id TreeBucketSize = 16;
+
   vtkm::cont::ArrayHandle<vtkm::Id> PointIds;
+  // split points of a BUILD_BALANCED tree
   vtkm::cont::ArrayHandle<vtkm::Id> SplitIds;
+  // node bounding boxes of a BUILD_MORTON tree
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 3>> NodeMin;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 3>> NodeMax;
+  vtkm::Vec<vtkm::Float64, 3> MortonMin;
+  vtkm::Vec<vtkm::Float64, 3> MortonInverseExtent;
 };
 }
 } // namespace vtkm::worklet
@@ -29,6 +29,7 @@
 
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/ArrayHandleCompositeVector.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
 #include <vtkm/cont/ArrayHandleGroupVec.h>
 #include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ArrayHandlePermutation.h>
@@ -38,8 +39,10 @@
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/cont/DynamicArrayHandle.h>
+#include <vtkm/cont/ExecutionObjectBase.h>
 #include <vtkm/cont/Field.h>
 
+#include <vtkm/worklet/BrickRangeIndex.h>
 #include <vtkm/worklet/DispatcherMapTopology.h>
 #include <vtkm/worklet/DispatcherPointNeighborhood.h>
 #include <vtkm/worklet/DispatcherReduceByKey.h>
@@ -219,6 +222,72 @@ public:
   typename PortalTypes<vtkm::IdComponent>::PortalConst TriTable;
 };
 
+/// \brief Computes the edges and weights of the points of the triangle
+/// `visitIndex` of a hexahedron, counting the triangles of all the isovalues
+/// in order, and stores them for the output triangle `outputCellId`.
+// -----------------------------------------------------------------------------
+template <typename DeviceAdapter,
+          typename IsoValuesType,
+          typename FieldInType, // Vec-like, one per input point
+          typename IndicesVecType>
+VTKM_EXEC void GenerateEdgeWeights(const EdgeWeightGenerateMetaData<DeviceAdapter>& metaData,
+                                   const IsoValuesType& isovalues,
+                                   const FieldInType& fieldIn,
+                                   vtkm::Id inputCellId,
+                                   vtkm::Id outputCellId,
+                                   vtkm::IdComponent visitIndex,
+                                   const IndicesVecType& indices)
+{
+  const vtkm::Id outputPointId = 3 * outputCellId;
+  using FieldType = typename vtkm::VecTraits<FieldInType>::ComponentType;
+
+  vtkm::IdComponent sum = 0, caseNumber = 0;
+  vtkm::IdComponent i = 0, size = static_cast<vtkm::IdComponent>(isovalues.GetNumberOfValues());
+  for (i = 0; i < size; ++i)
+  {
+    const FieldType ivalue = isovalues[i];
+    // Compute the Marching Cubes case number for this cell. We need to iterate
+    // the isovalues until the sum >= our visit index. But we need to make
+    // sure the caseNumber is correct before stopping
+    caseNumber =
+      ((fieldIn[0] > ivalue) | (fieldIn[1] > ivalue) << 1 | (fieldIn[2] > ivalue) << 2 |
+       (fieldIn[3] > ivalue) << 3 | (fieldIn[4] > ivalue) << 4 | (fieldIn[5] > ivalue) << 5 |
+       (fieldIn[6] > ivalue) << 6 | (fieldIn[7] > ivalue) << 7);
+    sum += metaData.NumTriTable.Get(caseNumber);
+    if (sum > visitIndex)
+    {
+      break;
+    }
+  }
+
+  visitIndex = sum - visitIndex - 1;
+
+  // Interpolate for vertex positions and associated scalar values
+  const vtkm::Id triTableOffset = static_cast<vtkm::Id>(caseNumber * 16 + visitIndex * 3);
+  for (vtkm::IdComponent triVertex = 0; triVertex < 3; triVertex++)
+  {
+    const vtkm::IdComponent edgeIndex = metaData.TriTable.Get(triTableOffset + triVertex);
+    const vtkm::IdComponent edgeVertex0 = metaData.EdgeTable.Get(2 * edgeIndex + 0);
+    const vtkm::IdComponent edgeVertex1 = metaData.EdgeTable.Get(2 * edgeIndex + 1);
+    const FieldType fieldValue0 = fieldIn[edgeVertex0];
+    const FieldType fieldValue1 = fieldIn[edgeVertex1];
+
+    // Store the input cell id so that we can properly generate the normals
+    // in a subsequent call, after we have merged duplicate points
+    metaData.InterpCellIdPortal.Set(outputPointId + triVertex, inputCellId);
+
+    metaData.InterpContourPortal.Set(outputPointId + triVertex, static_cast<vtkm::UInt8>(i));
+
+    metaData.InterpIdPortal.Set(outputPointId + triVertex,
+                                vtkm::Id2(indices[edgeVertex0], indices[edgeVertex1]));
+
+    vtkm::FloatDefault interpolant = static_cast<vtkm::FloatDefault>(isovalues[i] - fieldValue0) /
+      static_cast<vtkm::FloatDefault>(fieldValue1 - fieldValue0);
+
+    metaData.InterpWeightsPortal.Set(outputPointId + triVertex, interpolant);
+  }
+}
+
 /// \brief Compute the weights for each edge that is used to generate
 /// a point in the resulting iso-surface
 // -----------------------------------------------------------------------------
@@ -302,54 +371,8 @@ public:
                             vtkm::IdComponent visitIndex,
                             const IndicesVecType& indices) const
   { //covers when we have hexs coming from 3d structured data
-    const vtkm::Id outputPointId = 3 * outputCellId;
-    using FieldType = typename vtkm::VecTraits<FieldInType>::ComponentType;
-
-    vtkm::IdComponent sum = 0, caseNumber = 0;
-    vtkm::IdComponent i = 0, size = static_cast<vtkm::IdComponent>(isovalues.GetNumberOfValues());
-    for (i = 0; i < size; ++i)
-    {
-      const FieldType ivalue = isovalues[i];
-      // Compute the Marching Cubes case number for this cell. We need to iterate
-      // the isovalues until the sum >= our visit index. But we need to make
-      // sure the caseNumber is correct before stopping
-      caseNumber =
-        ((fieldIn[0] > ivalue) | (fieldIn[1] > ivalue) << 1 | (fieldIn[2] > ivalue) << 2 |
-         (fieldIn[3] > ivalue) << 3 | (fieldIn[4] > ivalue) << 4 | (fieldIn[5] > ivalue) << 5 |
-         (fieldIn[6] > ivalue) << 6 | (fieldIn[7] > ivalue) << 7);
-      sum += MetaData.NumTriTable.Get(caseNumber);
-      if (sum > visitIndex)
-      {
-        break;
-      }
-    }
-
-    visitIndex = sum - visitIndex - 1;
-
-    // Interpolate for vertex positions and associated scalar values
-    const vtkm::Id triTableOffset = static_cast<vtkm::Id>(caseNumber * 16 + visitIndex * 3);
-    for (vtkm::IdComponent triVertex = 0; triVertex < 3; triVertex++)
-    {
-      const vtkm::IdComponent edgeIndex = MetaData.TriTable.Get(triTableOffset + triVertex);
-      const vtkm::IdComponent edgeVertex0 = MetaData.EdgeTable.Get(2 * edgeIndex + 0);
-      const vtkm::IdComponent edgeVertex1 = MetaData.EdgeTable.Get(2 * edgeIndex + 1);
-      const FieldType fieldValue0 = fieldIn[edgeVertex0];
-      const FieldType fieldValue1 = fieldIn[edgeVertex1];
-
-      // Store the input cell id so that we can properly generate the normals
-      // in a subsequent call, after we have merged duplicate points
-      MetaData.InterpCellIdPortal.Set(outputPointId + triVertex, inputCellId);
-
-      MetaData.InterpContourPortal.Set(outputPointId + triVertex, static_cast<vtkm::UInt8>(i));
-
-      MetaData.InterpIdPortal.Set(outputPointId + triVertex,
-                                  vtkm::Id2(indices[edgeVertex0], indices[edgeVertex1]));
-
-      vtkm::FloatDefault interpolant = static_cast<vtkm::FloatDefault>(isovalues[i] - fieldValue0) /
-        static_cast<vtkm::FloatDefault>(fieldValue1 - fieldValue0);
-
-      MetaData.InterpWeightsPortal.Set(outputPointId + triVertex, interpolant);
-    }
+    GenerateEdgeWeights(
+      this->MetaData, isovalues, fieldIn, inputCellId, outputCellId, visitIndex, indices);
   }
 
 private:
@@ -384,6 +407,370 @@ public:
   }
 };
 
+// ---------------------------------------------------------------------------
+/// Execution object giving access to several point fields of the same type and
+/// to their interpolated outputs, so that they can all be interpolated by a
+/// single dispatch.
+template <typename ValueType, typename StorageType, typename DeviceAdapter>
+class PointFieldBatch : public vtkm::cont::ExecutionObjectBase
+{
+public:
+  using InputHandle = vtkm::cont::ArrayHandle<ValueType, StorageType>;
+  using OutputHandle = vtkm::cont::ArrayHandle<ValueType>;
+  using InputPortalType =
+    typename InputHandle::template ExecutionTypes<DeviceAdapter>::PortalConst;
+  using OutputPortalType = typename OutputHandle::template ExecutionTypes<DeviceAdapter>::Portal;
+  using InputPortalsPortalType = typename vtkm::cont::ArrayHandle<
+    InputPortalType>::template ExecutionTypes<DeviceAdapter>::PortalConst;
+  using OutputPortalsPortalType = typename vtkm::cont::ArrayHandle<
+    OutputPortalType>::template ExecutionTypes<DeviceAdapter>::PortalConst;
+
+  class ExecObject
+  {
+  public:
+    VTKM_EXEC_CONT
+    ExecObject() {}
+
+    VTKM_CONT
+    ExecObject(const InputPortalsPortalType& inputs, const OutputPortalsPortalType& outputs)
+      : Inputs(inputs)
+      , Outputs(outputs)
+    {
+    }
+
+    VTKM_EXEC
+    vtkm::Id GetNumberOfFields() const { return this->Inputs.GetNumberOfValues(); }
+
+    VTKM_EXEC
+    InputPortalType GetInput(vtkm::Id index) const { return this->Inputs.Get(index); }
+
+    VTKM_EXEC
+    OutputPortalType GetOutput(vtkm::Id index) const { return this->Outputs.Get(index); }
+
+  private:
+    InputPortalsPortalType Inputs;
+    OutputPortalsPortalType Outputs;
+  };
+
+  /// Read only access to the fields in `inputs`.
+  VTKM_CONT
+  PointFieldBatch(const std::vector<InputHandle>& inputs)
+    : PointFieldBatch(inputs, std::vector<OutputHandle>(), 0)
+  {
+  }
+
+  /// The execution portals of every field are gathered in arrays so the
+  /// worklet can index them at run time. This happens here, before the
+  /// dispatch, and allocates every output to `numOutputValues` so that it is
+  /// written in place.
+  VTKM_CONT
+  PointFieldBatch(const std::vector<InputHandle>& inputs,
+                  const std::vector<OutputHandle>& outputs,
+                  vtkm::Id numOutputValues)
+    : Inputs(inputs)
+    , Outputs(outputs)
+  {
+    const vtkm::Id numInputs = static_cast<vtkm::Id>(this->Inputs.size());
+    this->InputPortals.Allocate(numInputs);
+    for (vtkm::Id cc = 0; cc < numInputs; ++cc)
+    {
+      this->InputPortals.GetPortalControl().Set(
+        cc, this->Inputs[static_cast<std::size_t>(cc)].PrepareForInput(DeviceAdapter()));
+    }
+
+    const vtkm::Id numOutputs = static_cast<vtkm::Id>(this->Outputs.size());
+    this->OutputPortals.Allocate(numOutputs);
+    for (vtkm::Id cc = 0; cc < numOutputs; ++cc)
+    {
+      this->OutputPortals.GetPortalControl().Set(
+        cc,
+        this->Outputs[static_cast<std::size_t>(cc)].PrepareForOutput(numOutputValues,
+                                                                     DeviceAdapter()));
+    }
+  }
+
+  VTKM_CONT
+  ExecObject PrepareForExecution(DeviceAdapter) const
+  {
+    return ExecObject(this->InputPortals.PrepareForInput(DeviceAdapter()),
+                      this->OutputPortals.PrepareForInput(DeviceAdapter()));
+  }
+
+private:
+  // Keep the fields alive, and their execution arrays valid, while the
+  // portals are used.
+  std::vector<InputHandle> Inputs;
+  std::vector<OutputHandle> Outputs;
+  vtkm::cont::ArrayHandle<InputPortalType> InputPortals;
+  vtkm::cont::ArrayHandle<OutputPortalType> OutputPortals;
+};
+
+// ---------------------------------------------------------------------------
+class MapPointFields : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<Id2Type> interpolation_ids,
+                                FieldIn<Scalar> interpolation_weights,
+                                ExecObject fields);
+  using ExecutionSignature = void(_1, _2, _3, WorkIndex);
+  using InputDomain = _1;
+
+  VTKM_CONT
+  MapPointFields() {}
+
+  template <typename WeightType, typename FieldsType>
+  VTKM_EXEC void operator()(const vtkm::Id2& low_high,
+                            const WeightType& weight,
+                            const FieldsType& fields,
+                            vtkm::Id index) const
+  {
+    const vtkm::Id numFields = fields.GetNumberOfFields();
+    for (vtkm::Id fieldId = 0; fieldId < numFields; ++fieldId)
+    {
+      auto inPortal = fields.GetInput(fieldId);
+      auto outPortal = fields.GetOutput(fieldId);
+      using OutValueType = typename decltype(outPortal)::ValueType;
+      outPortal.Set(index,
+                    static_cast<OutValueType>(vtkm::Lerp(
+                      inPortal.Get(low_high[0]), inPortal.Get(low_high[1]), weight)));
+    }
+  }
+};
+
+// ---------------------------------------------------------------------------
+/// Counts the triangles generated in each cell for all the isovalues of all
+/// the scalar fields of a `PointFieldBatch`, so that the cells are classified
+/// once for every field.
+template <typename T>
+class ClassifyCellBatch : public vtkm::worklet::WorkletMapPointToCell
+{
+public:
+  struct ClassifyCellTagType : vtkm::ListTagBase<T>
+  {
+  };
+
+  using ControlSignature = void(CellSetIn cellset,
+                                WholeArrayIn<ClassifyCellTagType> isoValues,
+                                ExecObject fields,
+                                FieldOutCell<IdComponentType> outNumTriangles,
+                                WholeArrayIn<IdComponentType> numTrianglesTable);
+  using ExecutionSignature = void(CellShape, _2, _3, FromIndices, _4, _5);
+  using InputDomain = _1;
+
+  template <typename IsoValuesType,
+            typename FieldsType,
+            typename IndicesVecType,
+            typename NumTrianglesTablePortalType>
+  VTKM_EXEC void operator()(vtkm::CellShapeTagGeneric shape,
+                            const IsoValuesType& isovalues,
+                            const FieldsType& fields,
+                            const IndicesVecType& indices,
+                            vtkm::IdComponent& numTriangles,
+                            const NumTrianglesTablePortalType& numTrianglesTable) const
+  {
+    if (shape.Id == CELL_SHAPE_HEXAHEDRON)
+    {
+      this->operator()(vtkm::CellShapeTagHexahedron(),
+                       isovalues,
+                       fields,
+                       indices,
+                       numTriangles,
+                       numTrianglesTable);
+    }
+    else
+    {
+      numTriangles = 0;
+    }
+  }
+
+  template <typename IsoValuesType,
+            typename FieldsType,
+            typename IndicesVecType,
+            typename NumTrianglesTablePortalType>
+  VTKM_EXEC void operator()(vtkm::CellShapeTagQuad vtkmNotUsed(shape),
+                            const IsoValuesType& vtkmNotUsed(isovalues),
+                            const FieldsType& vtkmNotUsed(fields),
+                            const IndicesVecType& vtkmNotUsed(indices),
+                            vtkm::IdComponent& numTriangles,
+                            const NumTrianglesTablePortalType& vtkmNotUsed(numTrianglesTable)) const
+  {
+    numTriangles = 0;
+  }
+
+  template <typename IsoValuesType,
+            typename FieldsType,
+            typename IndicesVecType,
+            typename NumTrianglesTablePortalType>
+  VTKM_EXEC void operator()(vtkm::CellShapeTagHexahedron vtkmNotUsed(shape),
+                            const IsoValuesType& isovalues,
+                            const FieldsType& fields,
+                            const IndicesVecType& indices,
+                            vtkm::IdComponent& numTriangles,
+                            const NumTrianglesTablePortalType& numTrianglesTable) const
+  {
+    vtkm::IdComponent sum = 0;
+    for (vtkm::Id fieldId = 0; fieldId < fields.GetNumberOfFields(); ++fieldId)
+    {
+      const auto fieldPortal = fields.GetInput(fieldId);
+      vtkm::Vec<T, 8> fieldIn;
+      for (vtkm::IdComponent i = 0; i < 8; ++i)
+      {
+        fieldIn[i] = fieldPortal.Get(indices[i]);
+      }
+      for (vtkm::Id i = 0; i < isovalues.GetNumberOfValues(); ++i)
+      {
+        const vtkm::IdComponent caseNumber =
+          ((fieldIn[0] > isovalues[i]) | (fieldIn[1] > isovalues[i]) << 1 |
+           (fieldIn[2] > isovalues[i]) << 2 | (fieldIn[3] > isovalues[i]) << 3 |
+           (fieldIn[4] > isovalues[i]) << 4 | (fieldIn[5] > isovalues[i]) << 5 |
+           (fieldIn[6] > isovalues[i]) << 6 | (fieldIn[7] > isovalues[i]) << 7);
+        sum += numTrianglesTable.Get(caseNumber);
+      }
+    }
+    numTriangles = sum;
+  }
+};
+
+// ---------------------------------------------------------------------------
+/// Generates the triangles counted by `ClassifyCellBatch`. The triangles of a
+/// cell are ordered by field, then by isovalue, and the field of each output
+/// point is stored so the triangles can be split into one contour per field.
+template <typename T, typename DeviceAdapter>
+class EdgeWeightGenerateBatch : public vtkm::worklet::WorkletMapPointToCell
+{
+  using FieldIdPortalType = typename vtkm::cont::ArrayHandle<
+    vtkm::IdComponent>::template ExecutionTypes<DeviceAdapter>::Portal;
+
+public:
+  struct ClassifyCellTagType : vtkm::ListTagBase<T>
+  {
+  };
+
+  using ScatterType = vtkm::worklet::ScatterCounting;
+
+  template <typename ArrayHandleType>
+  VTKM_CONT static ScatterType MakeScatter(const ArrayHandleType& numOutputTrisPerCell)
+  {
+    return ScatterType(numOutputTrisPerCell, DeviceAdapter());
+  }
+
+  using ControlSignature = void(CellSetIn cellset,
+                                WholeArrayIn<ClassifyCellTagType> isoValues,
+                                ExecObject fields);
+  using ExecutionSignature =
+    void(CellShape, _2, _3, InputIndex, WorkIndex, VisitIndex, FromIndices);
+  using InputDomain = _1;
+
+  /// `pointFieldIds` is allocated to the number of output points here, like
+  /// the arrays of `meta`.
+  VTKM_CONT
+  EdgeWeightGenerateBatch(const EdgeWeightGenerateMetaData<DeviceAdapter>& meta,
+                          vtkm::cont::ArrayHandle<vtkm::IdComponent>& pointFieldIds,
+                          vtkm::Id numTriangles)
+    : MetaData(meta)
+    , PointFieldIds(pointFieldIds.PrepareForOutput(3 * numTriangles, DeviceAdapter()))
+  {
+  }
+
+  template <typename IsoValuesType, typename FieldsType, typename IndicesVecType>
+  VTKM_EXEC void operator()(vtkm::CellShapeTagGeneric shape,
+                            const IsoValuesType& isovalues,
+                            const FieldsType& fields,
+                            vtkm::Id inputCellId,
+                            vtkm::Id outputCellId,
+                            vtkm::IdComponent visitIndex,
+                            const IndicesVecType& indices) const
+  {
+    if (shape.Id == CELL_SHAPE_HEXAHEDRON)
+    {
+      this->operator()(vtkm::CellShapeTagHexahedron(),
+                       isovalues,
+                       fields,
+                       inputCellId,
+                       outputCellId,
+                       visitIndex,
+                       indices);
+    }
+  }
+
+  template <typename IsoValuesType, typename FieldsType, typename IndicesVecType>
+  VTKM_EXEC void operator()(CellShapeTagQuad vtkmNotUsed(shape),
+                            const IsoValuesType& vtkmNotUsed(isovalues),
+                            const FieldsType& vtkmNotUsed(fields),
+                            vtkm::Id vtkmNotUsed(inputCellId),
+                            vtkm::Id vtkmNotUsed(outputCellId),
+                            vtkm::IdComponent vtkmNotUsed(visitIndex),
+                            const IndicesVecType& vtkmNotUsed(indices)) const
+  {
+  }
+
+  template <typename IsoValuesType, typename FieldsType, typename IndicesVecType>
+  VTKM_EXEC void operator()(vtkm::CellShapeTagHexahedron,
+                            const IsoValuesType& isovalues,
+                            const FieldsType& fields,
+                            vtkm::Id inputCellId,
+                            vtkm::Id outputCellId,
+                            vtkm::IdComponent visitIndex,
+                            const IndicesVecType& indices) const
+  {
+    // Skip the triangles of the fields before the one this triangle belongs to
+    for (vtkm::Id fieldId = 0; fieldId < fields.GetNumberOfFields(); ++fieldId)
+    {
+      const auto fieldPortal = fields.GetInput(fieldId);
+      vtkm::Vec<T, 8> fieldIn;
+      for (vtkm::IdComponent i = 0; i < 8; ++i)
+      {
+        fieldIn[i] = fieldPortal.Get(indices[i]);
+      }
+
+      vtkm::IdComponent numTriangles = 0;
+      for (vtkm::Id i = 0; i < isovalues.GetNumberOfValues(); ++i)
+      {
+        const vtkm::IdComponent caseNumber =
+          ((fieldIn[0] > isovalues[i]) | (fieldIn[1] > isovalues[i]) << 1 |
+           (fieldIn[2] > isovalues[i]) << 2 | (fieldIn[3] > isovalues[i]) << 3 |
+           (fieldIn[4] > isovalues[i]) << 4 | (fieldIn[5] > isovalues[i]) << 5 |
+           (fieldIn[6] > isovalues[i]) << 6 | (fieldIn[7] > isovalues[i]) << 7);
+        numTriangles += this->MetaData.NumTriTable.Get(caseNumber);
+      }
+
+      if (visitIndex < numTriangles)
+      {
+        GenerateEdgeWeights(
+          this->MetaData, isovalues, fieldIn, inputCellId, outputCellId, visitIndex, indices);
+        for (vtkm::IdComponent triVertex = 0; triVertex < 3; triVertex++)
+        {
+          this->PointFieldIds.Set(3 * outputCellId + triVertex,
+                                  static_cast<vtkm::IdComponent>(fieldId));
+        }
+        return;
+      }
+      visitIndex -= numTriangles;
+    }
+  }
+
+private:
+  EdgeWeightGenerateMetaData<DeviceAdapter> MetaData;
+  FieldIdPortalType PointFieldIds;
+
+  void operator=(const EdgeWeightGenerateBatch<T, DeviceAdapter>&) = delete;
+};
+
+// ---------------------------------------------------------------------------
+struct IsFieldId
+{
+  VTKM_EXEC_CONT
+  IsFieldId(vtkm::IdComponent fieldId)
+    : FieldId(fieldId)
+  {
+  }
+
+  VTKM_EXEC_CONT
+  bool operator()(vtkm::IdComponent fieldId) const { return fieldId == this->FieldId; }
+
+  vtkm::IdComponent FieldId;
+};
+
 // ---------------------------------------------------------------------------
 struct MultiContourLess
 {
@@ -806,6 +1193,96 @@ public:
     return output;
   }
 
+  //----------------------------------------------------------------------------
+  /// Contours several scalar fields, each at the same isovalues, and
+  /// interpolates a list of point fields onto every contour. The cells are
+  /// classified, and their triangles generated, in a single pass for all the
+  /// scalar fields and isovalues. All the point fields are interpolated in a
+  /// single pass over the points of each contour. The brick range index is
+  /// not used.
+  ///
+  /// Returns one cell set per scalar field. `vertices` receives the points of
+  /// each contour and `interpolated[k][m]` the point field `m` on contour `k`.
+  /// Afterwards ProcessPointField and ProcessCellField map onto the contour of
+  /// the last scalar field.
+  template <typename ValueType,
+            typename CellSetType,
+            typename CoordinateSystem,
+            typename StorageTagField,
+            typename CoordinateType,
+            typename FieldType,
+            typename StorageTagPointField,
+            typename DeviceAdapter>
+  std::vector<vtkm::cont::CellSetSingleType<>> RunBatch(
+    const ValueType* const isovalues,
+    const vtkm::Id numIsoValues,
+    const CellSetType& cells,
+    const CoordinateSystem& coordinateSystem,
+    const std::vector<vtkm::cont::ArrayHandle<ValueType, StorageTagField>>& inputs,
+    const std::vector<vtkm::cont::ArrayHandle<FieldType, StorageTagPointField>>& pointFields,
+    std::vector<vtkm::cont::ArrayHandle<vtkm::Vec<CoordinateType, 3>>>& vertices,
+    std::vector<std::vector<vtkm::cont::ArrayHandle<FieldType>>>& interpolated,
+    const DeviceAdapter&)
+  {
+    std::vector<vtkm::cont::CellSetSingleType<>> outputCells(inputs.size());
+    vertices.resize(inputs.size());
+    interpolated.resize(inputs.size());
+    if (inputs.empty())
+    {
+      return outputCells;
+    }
+
+    DeduceBatchCellType<ValueType,
+                        CoordinateSystem,
+                        StorageTagField,
+                        CoordinateType,
+                        FieldType,
+                        StorageTagPointField,
+                        DeviceAdapter>
+      functor;
+    functor.MC = this;
+    functor.isovalues = isovalues;
+    functor.numIsoValues = numIsoValues;
+    functor.coordinateSystem = &coordinateSystem;
+    functor.inputs = &inputs;
+    functor.pointFields = &pointFields;
+    functor.vertices = &vertices;
+    functor.interpolated = &interpolated;
+    functor.result = &outputCells;
+
+    vtkm::cont::CastAndCall(cells, functor);
+
+    return outputCells;
+  }
+
+  //----------------------------------------------------------------------------
+  /// Interpolates several point fields of the same type onto the contour.
+  /// Equivalent to calling ProcessPointField for each field, but the
+  /// interpolation ids and weights are read only once for all the fields and
+  /// every field is written directly to its output.
+  template <typename ValueType, typename StorageType, typename DeviceAdapter>
+  std::vector<vtkm::cont::ArrayHandle<ValueType>> ProcessPointFields(
+    const std::vector<vtkm::cont::ArrayHandle<ValueType, StorageType>>& inputs,
+    const DeviceAdapter&) const
+  {
+    using vtkm::worklet::marchingcubes::MapPointFields;
+    using vtkm::worklet::marchingcubes::PointFieldBatch;
+
+    std::vector<vtkm::cont::ArrayHandle<ValueType>> outputs(inputs.size());
+    if (inputs.empty())
+    {
+      return outputs;
+    }
+
+    PointFieldBatch<ValueType, StorageType, DeviceAdapter> batch(
+      inputs, outputs, this->InterpolationEdgeIds.GetNumberOfValues());
+    MapPointFields applyToFields;
+    vtkm::worklet::DispatcherMapField<MapPointFields, DeviceAdapter> applyFieldsDispatcher(
+      applyToFields);
+    applyFieldsDispatcher.Invoke(this->InterpolationEdgeIds, this->InterpolationWeights, batch);
+    return outputs;
+  }
+
   //----------------------------------------------------------------------------
   template <typename ValueType, typename StorageType, typename DeviceAdapter>
   vtkm::cont::ArrayHandle<ValueType> ProcessCellField(
@@ -824,6 +1301,16 @@ public:
     return result;
   }
 
+  //----------------------------------------------------------------------------
+  /// Sets a brick range index over the contoured field. When the index was
+  /// built for the structured cell set passed to Run, only the cells of the
+  /// bricks containing an isovalue are classified. The output is the same as
+  /// without the index. The index must be rebuilt when the field changes.
+  void SetBrickRangeIndex(const vtkm::worklet::BrickRangeIndex& index) { this->BrickIndex = index; }
+
+  //----------------------------------------------------------------------------
+  const vtkm::worklet::BrickRangeIndex& GetBrickRangeIndex() const { return this->BrickIndex; }
+
   //----------------------------------------------------------------------------
   void ReleaseCellMapArrays() { this->CellIdMap.ReleaseResources(); }
 
@@ -866,6 +1353,46 @@ private:
     }
   };
 
+  //----------------------------------------------------------------------------
+  template <typename ValueType,
+            typename CoordinateSystem,
+            typename StorageTagField,
+            typename CoordinateType,
+            typename FieldType,
+            typename StorageTagPointField,
+            typename DeviceAdapter>
+  struct DeduceBatchCellType
+  {
+    MarchingCubes* MC = nullptr;
+    const ValueType* isovalues = nullptr;
+    vtkm::Id numIsoValues = 0;
+    const CoordinateSystem* coordinateSystem = nullptr;
+    const std::vector<vtkm::cont::ArrayHandle<ValueType, StorageTagField>>* inputs = nullptr;
+    const std::vector<vtkm::cont::ArrayHandle<FieldType, StorageTagPointField>>* pointFields =
+      nullptr;
+    std::vector<vtkm::cont::ArrayHandle<vtkm::Vec<CoordinateType, 3>>>* vertices = nullptr;
+    std::vector<std::vector<vtkm::cont::ArrayHandle<FieldType>>>* interpolated = nullptr;
+    std::vector<vtkm::cont::CellSetSingleType<>>* result = nullptr;
+
+    template <typename CellSetType>
+    void operator()(const CellSetType& cells) const
+    {
+      if (this->MC)
+      {
+        this->MC->DoRunBatch(isovalues,
+                             numIsoValues,
+                             cells,
+                             *coordinateSystem,
+                             *inputs,
+                             *pointFields,
+                             *vertices,
+                             *interpolated,
+                             *result,
+                             DeviceAdapter());
+      }
+    }
+  };
+
   //----------------------------------------------------------------------------
   template <typename ValueType,
             typename CellSetType,
@@ -916,28 +1443,79 @@ private:
   //----------------------------------------------------------------------------
   template <typename ValueType,
             typename CellSetType,
-            typename CoordinateSystem,
             typename StorageTagField,
-            typename StorageTagVertices,
-            typename StorageTagNormals,
-            typename CoordinateType,
-            typename NormalType,
             typename DeviceAdapter>
-  vtkm::cont::CellSetSingleType<> DoRun(
-    const ValueType* isovalues,
-    const vtkm::Id numIsoValues,
+  void ClassifyAndGenerateEdges(
+    const vtkm::cont::ArrayHandle<ValueType>& isoValuesHandle,
     const CellSetType& cells,
-    const CoordinateSystem& coordinateSystem,
     const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
-    vtkm::cont::ArrayHandle<vtkm::Vec<CoordinateType, 3>, StorageTagVertices> vertices,
-    vtkm::cont::ArrayHandle<vtkm::Vec<NormalType, 3>, StorageTagNormals> normals,
-    bool withNormals,
+    vtkm::cont::ArrayHandle<vtkm::UInt8>& contourIds,
+    vtkm::cont::ArrayHandle<vtkm::Id>& originalCellIdsForPoints,
+    const DeviceAdapter&)
+  {
+    this->GenerateEdges(
+      isoValuesHandle, cells, inputField, contourIds, originalCellIdsForPoints, DeviceAdapter());
+  }
+
+  //----------------------------------------------------------------------------
+  // Uniform and rectilinear grids can restrict the classification to the
+  // cells of the bricks of BrickIndex that contain one of the isovalues.
+  template <typename ValueType, typename StorageTagField, typename DeviceAdapter>
+  void ClassifyAndGenerateEdges(
+    const vtkm::cont::ArrayHandle<ValueType>& isoValuesHandle,
+    const vtkm::cont::CellSetStructured<3>& cells,
+    const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
+    vtkm::cont::ArrayHandle<vtkm::UInt8>& contourIds,
+    vtkm::cont::ArrayHandle<vtkm::Id>& originalCellIdsForPoints,
     const DeviceAdapter&)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    if (!this->BrickIndex.IsValidFor(cells, inputField))
+    {
+      this->GenerateEdges(
+        isoValuesHandle, cells, inputField, contourIds, originalCellIdsForPoints, DeviceAdapter());
+      return;
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::Id> candidateCellIds =
+      this->BrickIndex.GetCellsStraddling(isoValuesHandle, DeviceAdapter());
+    this->GenerateEdges(isoValuesHandle,
+                        vtkm::cont::make_CellSetPermutation(candidateCellIds, cells),
+                        inputField,
+                        contourIds,
+                        originalCellIdsForPoints,
+                        DeviceAdapter());
+
+    // The generated cell ids index the candidate cells, map them back to
+    // the cells of the input.
+    vtkm::cont::ArrayHandle<vtkm::Id> cellIds;
+    Algorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(this->CellIdMap, candidateCellIds),
+                    cellIds);
+    this->CellIdMap = cellIds;
+
+    vtkm::cont::ArrayHandle<vtkm::Id> pointCellIds;
+    Algorithm::Copy(
+      vtkm::cont::make_ArrayHandlePermutation(originalCellIdsForPoints, candidateCellIds),
+      pointCellIds);
+    originalCellIdsForPoints = pointCellIds;
+  }
+
+  //----------------------------------------------------------------------------
+  template <typename ValueType,
+            typename CellSetType,
+            typename StorageTagField,
+            typename DeviceAdapter>
+  void GenerateEdges(const vtkm::cont::ArrayHandle<ValueType>& isoValuesHandle,
+                     const CellSetType& cells,
+                     const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
+                     vtkm::cont::ArrayHandle<vtkm::UInt8>& contourIds,
+                     vtkm::cont::ArrayHandle<vtkm::Id>& originalCellIdsForPoints,
+                     const DeviceAdapter&)
   {
     using vtkm::worklet::marchingcubes::ClassifyCell;
     using vtkm::worklet::marchingcubes::EdgeWeightGenerate;
     using vtkm::worklet::marchingcubes::EdgeWeightGenerateMetaData;
-    using vtkm::worklet::marchingcubes::MapPointField;
 
     // Setup the Dispatcher Typedefs
     using ClassifyDispatcher =
@@ -947,8 +1525,6 @@ private:
       typename vtkm::worklet::DispatcherMapTopology<EdgeWeightGenerate<ValueType, DeviceAdapter>,
                                                     DeviceAdapter>;
 
-    vtkm::cont::ArrayHandle<ValueType> isoValuesHandle =
-      vtkm::cont::make_ArrayHandle(isovalues, numIsoValues);
     // Call the ClassifyCell functor to compute the Marching Cubes case numbers
     // for each cell, and the number of vertices to be generated
 
@@ -962,8 +1538,6 @@ private:
     }
 
     //Pass 2 Generate the edges
-    vtkm::cont::ArrayHandle<vtkm::UInt8> contourIds;
-    vtkm::cont::ArrayHandle<vtkm::Id> originalCellIdsForPoints;
     {
       auto scatter =
         EdgeWeightGenerate<ValueType, DeviceAdapter>::MakeScatter(numOutputTrisPerCell);
@@ -990,6 +1564,76 @@ private:
         inputField);
     }
 
+  }
+
+  //----------------------------------------------------------------------------
+  template <typename ValueType,
+            typename CellSetType,
+            typename CoordinateSystem,
+            typename StorageTagField,
+            typename StorageTagVertices,
+            typename StorageTagNormals,
+            typename CoordinateType,
+            typename NormalType,
+            typename DeviceAdapter>
+  vtkm::cont::CellSetSingleType<> DoRun(
+    const ValueType* isovalues,
+    const vtkm::Id numIsoValues,
+    const CellSetType& cells,
+    const CoordinateSystem& coordinateSystem,
+    const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
+    vtkm::cont::ArrayHandle<vtkm::Vec<CoordinateType, 3>, StorageTagVertices> vertices,
+    vtkm::cont::ArrayHandle<vtkm::Vec<NormalType, 3>, StorageTagNormals> normals,
+    bool withNormals,
+    const DeviceAdapter&)
+  {
+    vtkm::cont::ArrayHandle<ValueType> isoValuesHandle =
+      vtkm::cont::make_ArrayHandle(isovalues, numIsoValues);
+
+    vtkm::cont::ArrayHandle<vtkm::UInt8> contourIds;
+    vtkm::cont::ArrayHandle<vtkm::Id> originalCellIdsForPoints;
+    this->ClassifyAndGenerateEdges(
+      isoValuesHandle, cells, inputField, contourIds, originalCellIdsForPoints, DeviceAdapter());
+
+    return this->BuildContour(numIsoValues,
+                              cells,
+                              coordinateSystem,
+                              inputField,
+                              contourIds,
+                              originalCellIdsForPoints,
+                              vertices,
+                              normals,
+                              withNormals,
+                              DeviceAdapter());
+  }
+
+  //----------------------------------------------------------------------------
+  // Merges the points generated by the classification, which are in
+  // InterpolationEdgeIds and InterpolationWeights, and computes their
+  // coordinates, the connectivity and optionally the normals of the contour.
+  template <typename ValueType,
+            typename CellSetType,
+            typename CoordinateSystem,
+            typename StorageTagField,
+            typename StorageTagVertices,
+            typename StorageTagNormals,
+            typename CoordinateType,
+            typename NormalType,
+            typename DeviceAdapter>
+  vtkm::cont::CellSetSingleType<> BuildContour(
+    const vtkm::Id numIsoValues,
+    const CellSetType& cells,
+    const CoordinateSystem& coordinateSystem,
+    const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
+    vtkm::cont::ArrayHandle<vtkm::UInt8>& contourIds,
+    vtkm::cont::ArrayHandle<vtkm::Id>& originalCellIdsForPoints,
+    vtkm::cont::ArrayHandle<vtkm::Vec<CoordinateType, 3>, StorageTagVertices> vertices,
+    vtkm::cont::ArrayHandle<vtkm::Vec<NormalType, 3>, StorageTagNormals> normals,
+    bool withNormals,
+    const DeviceAdapter&)
+  {
+    using vtkm::worklet::marchingcubes::MapPointField;
+
     if (numIsoValues <= 1 || !this->MergeDuplicatePoints)
     { //release memory early that we are not going to need again
       contourIds.ReleaseResources();
@@ -1059,6 +1703,107 @@ private:
     return outputCells;
   }
 
+  //----------------------------------------------------------------------------
+  template <typename ValueType,
+            typename CellSetType,
+            typename CoordinateSystem,
+            typename StorageTagField,
+            typename CoordinateType,
+            typename FieldType,
+            typename StorageTagPointField,
+            typename DeviceAdapter>
+  void DoRunBatch(
+    const ValueType* isovalues,
+    const vtkm::Id numIsoValues,
+    const CellSetType& cells,
+    const CoordinateSystem& coordinateSystem,
+    const std::vector<vtkm::cont::ArrayHandle<ValueType, StorageTagField>>& inputs,
+    const std::vector<vtkm::cont::ArrayHandle<FieldType, StorageTagPointField>>& pointFields,
+    std::vector<vtkm::cont::ArrayHandle<vtkm::Vec<CoordinateType, 3>>>& vertices,
+    std::vector<std::vector<vtkm::cont::ArrayHandle<FieldType>>>& interpolated,
+    std::vector<vtkm::cont::CellSetSingleType<>>& outputCells,
+    const DeviceAdapter&)
+  {
+    using vtkm::worklet::marchingcubes::ClassifyCellBatch;
+    using vtkm::worklet::marchingcubes::EdgeWeightGenerateBatch;
+    using vtkm::worklet::marchingcubes::EdgeWeightGenerateMetaData;
+    using vtkm::worklet::marchingcubes::IsFieldId;
+    using vtkm::worklet::marchingcubes::PointFieldBatch;
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    using ClassifyDispatcher =
+      typename vtkm::worklet::DispatcherMapTopology<ClassifyCellBatch<ValueType>, DeviceAdapter>;
+    using GenerateDispatcher = typename vtkm::worklet::
+      DispatcherMapTopology<EdgeWeightGenerateBatch<ValueType, DeviceAdapter>, DeviceAdapter>;
+
+    vtkm::cont::ArrayHandle<ValueType> isoValuesHandle =
+      vtkm::cont::make_ArrayHandle(isovalues, numIsoValues);
+    PointFieldBatch<ValueType, StorageTagField, DeviceAdapter> scalarFields(inputs);
+
+    // Classify the cells and generate the triangles once for all the fields
+    vtkm::cont::ArrayHandle<vtkm::IdComponent> numOutputTrisPerCell;
+    {
+      ClassifyCellBatch<ValueType> classifyCell;
+      ClassifyDispatcher classifyCellDispatcher(classifyCell);
+      classifyCellDispatcher.Invoke(
+        cells, isoValuesHandle, scalarFields, numOutputTrisPerCell, this->NumTrianglesTable);
+    }
+
+    auto scatter =
+      EdgeWeightGenerateBatch<ValueType, DeviceAdapter>::MakeScatter(numOutputTrisPerCell);
+    const vtkm::Id numTriangles = scatter.GetOutputRange(numOutputTrisPerCell.GetNumberOfValues());
+    vtkm::cont::ArrayHandle<vtkm::Id> cellIdMap = scatter.GetOutputToInputMap();
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> weights;
+    vtkm::cont::ArrayHandle<vtkm::Id2> edgeIds;
+    vtkm::cont::ArrayHandle<vtkm::Id> originalCellIdsForPoints;
+    vtkm::cont::ArrayHandle<vtkm::UInt8> contourIds;
+    vtkm::cont::ArrayHandle<vtkm::IdComponent> pointFieldIds;
+    {
+      EdgeWeightGenerateMetaData<DeviceAdapter> metaData(numTriangles,
+                                                         weights,
+                                                         edgeIds,
+                                                         originalCellIdsForPoints,
+                                                         contourIds,
+                                                         this->EdgeTable,
+                                                         this->NumTrianglesTable,
+                                                         this->TriangleTable);
+
+      EdgeWeightGenerateBatch<ValueType, DeviceAdapter> weightGenerate(
+        metaData, pointFieldIds, numTriangles);
+      GenerateDispatcher edgeDispatcher(weightGenerate, scatter);
+      edgeDispatcher.Invoke(cells, isoValuesHandle, scalarFields);
+    }
+
+    // The triangles of a cell are ordered by field, so selecting the ones of
+    // a field keeps them in the order Run would generate them.
+    auto triangleFieldIds = vtkm::cont::make_ArrayHandlePermutation(
+      vtkm::cont::make_ArrayHandleCounting<vtkm::Id>(0, 3, numTriangles), pointFieldIds);
+    for (std::size_t k = 0; k < inputs.size(); ++k)
+    {
+      const IsFieldId isField(static_cast<vtkm::IdComponent>(k));
+      Algorithm::CopyIf(cellIdMap, triangleFieldIds, this->CellIdMap, isField);
+      Algorithm::CopyIf(weights, pointFieldIds, this->InterpolationWeights, isField);
+      Algorithm::CopyIf(edgeIds, pointFieldIds, this->InterpolationEdgeIds, isField);
+      vtkm::cont::ArrayHandle<vtkm::Id> fieldCellIdsForPoints;
+      Algorithm::CopyIf(originalCellIdsForPoints, pointFieldIds, fieldCellIdsForPoints, isField);
+      vtkm::cont::ArrayHandle<vtkm::UInt8> fieldContourIds;
+      Algorithm::CopyIf(contourIds, pointFieldIds, fieldContourIds, isField);
+
+      vtkm::cont::ArrayHandle<vtkm::Vec<CoordinateType, 3>> normals;
+      outputCells[k] = this->BuildContour(numIsoValues,
+                                          cells,
+                                          coordinateSystem,
+                                          inputs[k],
+                                          fieldContourIds,
+                                          fieldCellIdsForPoints,
+                                          vertices[k],
+                                          normals,
+                                          false,
+                                          DeviceAdapter());
+      interpolated[k] = this->ProcessPointFields(pointFields, DeviceAdapter());
+    }
+  }
+
   bool MergeDuplicatePoints;
 
   vtkm::cont::ArrayHandle<vtkm::IdComponent> EdgeTable;
@@ -1069,6 +1814,8 @@ private:
   vtkm::cont::ArrayHandle<vtkm::Id2> InterpolationEdgeIds;
 
   vtkm::cont::ArrayHandle<vtkm::Id> CellIdMap;
+
+  vtkm::worklet::BrickRangeIndex BrickIndex;
 };
 }
 } // namespace vtkm::worklet
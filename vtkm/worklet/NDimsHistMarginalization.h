@@ -29,11 +29,8 @@
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
 #include <vtkm/worklet/histogram/ComputeNDHistogram.h>
-#include <vtkm/worklet/histogram/ComputeNDHistogram.h>
-#include <vtkm/worklet/histogram/ComputeNDHistogram.h>
-#include <vtkm/worklet/histogram/MarginalizeNDHistogram.h>
-#include <vtkm/worklet/histogram/MarginalizeNDHistogram.h>
 #include <vtkm/worklet/histogram/MarginalizeNDHistogram.h>
+#include <vtkm/worklet/histogram/SparseHistogram.h>
 
 #include <vtkm/cont/Field.h>
 
@@ -71,7 +68,7 @@ public:
            BinaryCompare conditionFunc,
            std::vector<vtkm::cont::ArrayHandle<vtkm::Id>>& marginalBinId,
            vtkm::cont::ArrayHandle<vtkm::Id>& marginalFreqs,
-           DeviceAdapter vtkmNotUsed(device))
+           DeviceAdapter device)
   {
     using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
 
@@ -115,19 +112,16 @@ public:
       }
     }
 
-
-    // Sort the freq array for counting by key(1DIndex)
-    DeviceAlgorithms::SortByKey(bin1DIndex, freqs);
-
-    // Add frequency within same 1d index bin (this get a nonSparse representation)
-    vtkm::cont::ArrayHandle<vtkm::Id> nonSparseMarginalFreqs;
-    DeviceAlgorithms::ReduceByKey(
-      bin1DIndex, freqs, bin1DIndex, nonSparseMarginalFreqs, vtkm::Add());
-
-    // Convert to sparse representation(remove all zero freqncy entities)
+    // Add frequency within same 1d index bin. Entities whose frequency was set
+    // to 0 by the condition are skipped, so the result is sparse.
     vtkm::cont::ArrayHandle<vtkm::Id> sparseMarginal1DBinId;
-    DeviceAlgorithms::CopyIf(bin1DIndex, nonSparseMarginalFreqs, sparseMarginal1DBinId);
-    DeviceAlgorithms::CopyIf(nonSparseMarginalFreqs, nonSparseMarginalFreqs, marginalFreqs);
+    this->SumFrequencies(bin1DIndex,
+                         freqs,
+                         marginalVariables,
+                         numberOfBins,
+                         sparseMarginal1DBinId,
+                         marginalFreqs,
+                         device);
 
     //convert back to multi variate binId
     marginalBinId.resize(static_cast<size_t>(numMarginalVariables));
@@ -158,7 +152,7 @@ public:
            vtkm::cont::ArrayHandle<bool>& marginalVariables,
            std::vector<vtkm::cont::ArrayHandle<vtkm::Id>>& marginalBinId,
            vtkm::cont::ArrayHandle<vtkm::Id>& marginalFreqs,
-           DeviceAdapter vtkmNotUsed(device))
+           DeviceAdapter device)
   {
     using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
 
@@ -188,11 +182,9 @@ public:
       }
     }
 
-    // Sort the freq array for counting by key (1DIndex)
-    DeviceAlgorithms::SortByKey(bin1DIndex, freqs);
-
     // Add frequency within same 1d index bin
-    DeviceAlgorithms::ReduceByKey(bin1DIndex, freqs, bin1DIndex, marginalFreqs, vtkm::Add());
+    this->SumFrequencies(
+      bin1DIndex, freqs, marginalVariables, numberOfBins, bin1DIndex, marginalFreqs, device);
 
     //convert back to multi variate binId
     marginalBinId.resize(static_cast<size_t>(numMarginalVariables));
@@ -212,6 +204,33 @@ public:
       }
     }
   } //Run()
+
+private:
+  // Sum the frequencies of the entities falling in the same marginal bin by
+  // hashing their 1D index, which avoids sorting all entities of the input
+  // histogram. Only the (usually much fewer) marginal bins are sorted.
+  template <typename DeviceAdapter>
+  void SumFrequencies(const vtkm::cont::ArrayHandle<vtkm::Id>& bin1DIndex,
+                      const vtkm::cont::ArrayHandle<vtkm::Id>& freqs,
+                      vtkm::cont::ArrayHandle<bool>& marginalVariables,
+                      vtkm::cont::ArrayHandle<vtkm::Id>& numberOfBins,
+                      vtkm::cont::ArrayHandle<vtkm::Id>& marginal1DBinId,
+                      vtkm::cont::ArrayHandle<vtkm::Id>& marginalFreqs,
+                      DeviceAdapter device)
+  {
+    vtkm::Id numMarginalBins = 1;
+    for (vtkm::Id i = 0; i < numberOfBins.GetNumberOfValues(); i++)
+    {
+      if (marginalVariables.GetPortalConstControl().Get(i) == true)
+      {
+        numMarginalBins *= numberOfBins.GetPortalConstControl().Get(i);
+      }
+    }
+
+    vtkm::worklet::histogram::SparseHistogram marginalHistogram;
+    marginalHistogram.Insert(bin1DIndex, freqs, numMarginalBins, device);
+    marginalHistogram.GetBins(marginal1DBinId, marginalFreqs, device);
+  }
 };
 }
 } // namespace vtkm::worklet
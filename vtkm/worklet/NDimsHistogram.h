@@ -30,8 +30,9 @@
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/WorkletMapField.h>
 #include <vtkm/worklet/histogram/ComputeNDHistogram.h>
-#include <vtkm/worklet/histogram/ComputeNDHistogram.h>
-#include <vtkm/worklet/histogram/ComputeNDHistogram.h>
+#include <vtkm/worklet/histogram/SparseHistogram.h>
+
+#include <limits>
 
 #include <vtkm/cont/Field.h>
 
@@ -43,12 +44,29 @@ namespace worklet
 class NDimsHistogram
 {
 public:
+  VTKM_CONT
+  NDimsHistogram()
+    : NumDataPoints(0)
+    , NumFieldsAdded(0)
+    , TotalNumberOfBins(1)
+    , NumBlocksAccumulated(0)
+    , BlockPending(false)
+  {
+  }
+
+  // Start binning a block of _numDataPoints points. If the fields of a
+  // previous block were added, that block is accumulated into the histogram
+  // first, so the histogram of several blocks (or time steps) is built by
+  // calling SetNumOfDataPoints and AddField again for each of them.
   template <typename DeviceAdapter>
-  void SetNumOfDataPoints(vtkm::Id _numDataPoints, DeviceAdapter vtkmNotUsed(device))
+  void SetNumOfDataPoints(vtkm::Id _numDataPoints, DeviceAdapter device)
   {
     using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
 
+    this->Accumulate(device);
+
     NumDataPoints = _numDataPoints;
+    NumFieldsAdded = 0;
 
     // Initialize bin1DIndex array
     vtkm::cont::ArrayHandleConstant<vtkm::Id> constant0Array(0, NumDataPoints);
@@ -58,6 +76,8 @@ public:
   // Add a field and the bin number for this field
   // Return: rangeOfRange is min max value of this array
   //         binDelta is delta of a bin
+  // Each block would get bins of its own range, so this overload can only be
+  // used by a histogram of a single block.
   template <typename HandleType, typename DeviceAdapter>
   void AddField(const HandleType& fieldArray,
                 vtkm::Id numberOfBins,
@@ -65,7 +85,7 @@ public:
                 vtkm::Float64& binDelta,
                 DeviceAdapter vtkmNotUsed(device))
   {
-    NumberOfBins.push_back(numberOfBins);
+    this->AddNumberOfBins(numberOfBins, false);
 
     if (fieldArray.GetNumberOfValues() != NumDataPoints)
     {
@@ -79,6 +99,56 @@ public:
     }
   }
 
+  // Add a field binned over a given range instead of the range of its values.
+  // Blocks accumulated into the same histogram must use the same range for
+  // each field for their bins to match, so a field added with this overload
+  // cannot be added over the range of its values in another block.
+  template <typename HandleType, typename DeviceAdapter>
+  void AddField(const HandleType& fieldArray,
+                vtkm::Id numberOfBins,
+                const vtkm::Range& rangeOfValues,
+                DeviceAdapter vtkmNotUsed(device))
+  {
+    this->AddNumberOfBins(numberOfBins, true);
+
+    if (fieldArray.GetNumberOfValues() != NumDataPoints)
+    {
+      throw vtkm::cont::ErrorBadValue("Array lengths does not match");
+    }
+    else
+    {
+      vtkm::Range range = rangeOfValues;
+      vtkm::Float64 binDelta;
+      CastAndCall(fieldArray.ResetTypeList(vtkm::TypeListTagScalarAll()),
+                  vtkm::worklet::histogram::ComputeBins<DeviceAdapter>(
+                    Bin1DIndex, numberOfBins, range, binDelta, false));
+    }
+  }
+
+  // Count the points of the current block into the histogram. This is done
+  // by SetNumOfDataPoints and Run, so it only needs to be called directly to
+  // release the per point bin indices early.
+  template <typename DeviceAdapter>
+  void Accumulate(DeviceAdapter device)
+  {
+    if (!BlockPending)
+    {
+      return;
+    }
+    if (NumFieldsAdded != NumberOfBins.size())
+    {
+      throw vtkm::cont::ErrorBadValue("Not all fields of the histogram were added to the block");
+    }
+
+    vtkm::cont::ArrayHandleConstant<vtkm::Id> constArray(1, NumDataPoints);
+    Histogram.Insert(Bin1DIndex, constArray, TotalNumberOfBins, device);
+
+    Bin1DIndex.ReleaseResources();
+    NumDataPoints = 0;
+    NumBlocksAccumulated++;
+    BlockPending = false;
+  }
+
   // Execute N-Dim histogram worklet to get N-Dims histogram from input fields
   // Input arguments:
   //   binId: returned bin id of NDims-histogram, binId has n arrays, if length of fieldName is n
@@ -88,21 +158,19 @@ public:
   //           the length of all arrays in binId and freqs array must be the same
   //           if the length of fieldNames is n (compute a n-dimensional hisotgram)
   //           freqs[i] is the frequency of the bin with bin Ids{ binId[0][i], binId[1][i], ... binId[n-1][i] }
+  //     The histogram holds all blocks added so far and is kept, so more blocks can
+  //     still be accumulated after Run.
   template <typename DeviceAdapter>
   void Run(std::vector<vtkm::cont::ArrayHandle<vtkm::Id>>& binId,
            vtkm::cont::ArrayHandle<vtkm::Id>& freqs,
-           DeviceAdapter vtkmNotUsed(device))
+           DeviceAdapter device)
   {
-    using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
-
     binId.resize(NumberOfBins.size());
 
-    // Sort the resulting bin(1D) array for counting
-    DeviceAlgorithms::Sort(Bin1DIndex);
-
-    // Count frequency of each bin
-    vtkm::cont::ArrayHandleConstant<vtkm::Id> constArray(1, NumDataPoints);
-    DeviceAlgorithms::ReduceByKey(Bin1DIndex, constArray, Bin1DIndex, freqs, vtkm::Add());
+    // Count the bins of the last block and get the sorted non-empty bins
+    this->Accumulate(device);
+    vtkm::cont::ArrayHandle<vtkm::Id> bin1DIndex;
+    Histogram.GetBins(bin1DIndex, freqs, device);
 
     //convert back to multi variate binId
     for (vtkm::Id i = static_cast<vtkm::Id>(NumberOfBins.size()) - 1; i >= 0; i--)
@@ -112,14 +180,56 @@ public:
       vtkm::worklet::DispatcherMapField<vtkm::worklet::histogram::ConvertHistBinToND, DeviceAdapter>
         ConvertHistBinToNDDispatcher(binWorklet);
       size_t vectorId = static_cast<size_t>(i);
-      ConvertHistBinToNDDispatcher.Invoke(Bin1DIndex, Bin1DIndex, binId[vectorId]);
+      ConvertHistBinToNDDispatcher.Invoke(bin1DIndex, bin1DIndex, binId[vectorId]);
     }
   }
 
 private:
+  void AddNumberOfBins(vtkm::Id numberOfBins, bool fixedRange)
+  {
+    if (!fixedRange && NumBlocksAccumulated > 0)
+    {
+      throw vtkm::cont::ErrorBadValue(
+        "Fields of a histogram of several blocks must be binned over a fixed range");
+    }
+    if (NumFieldsAdded < NumberOfBins.size())
+    {
+      // Later blocks must be binned the same way as the first one
+      if (NumberOfBins[NumFieldsAdded] != numberOfBins)
+      {
+        throw vtkm::cont::ErrorBadValue("Number of bins differs from the previous block");
+      }
+      if (FixedRange[NumFieldsAdded] != fixedRange)
+      {
+        throw vtkm::cont::ErrorBadValue(
+          "Field binned over the range of its values and over a fixed range in different blocks");
+      }
+    }
+    else
+    {
+      // The linearized bin index of all fields has to fit in a vtkm::Id
+      if (numberOfBins < 1 ||
+          TotalNumberOfBins > std::numeric_limits<vtkm::Id>::max() / numberOfBins)
+      {
+        throw vtkm::cont::ErrorBadValue("Too many bins for an N-dimensional histogram");
+      }
+      TotalNumberOfBins *= numberOfBins;
+      NumberOfBins.push_back(numberOfBins);
+      FixedRange.push_back(fixedRange);
+    }
+    NumFieldsAdded++;
+    BlockPending = true;
+  }
+
   std::vector<vtkm::Id> NumberOfBins;
+  std::vector<bool> FixedRange;
   vtkm::cont::ArrayHandle<vtkm::Id> Bin1DIndex;
   vtkm::Id NumDataPoints;
+  size_t NumFieldsAdded;
+  vtkm::Id TotalNumberOfBins;
+  vtkm::Id NumBlocksAccumulated;
+  bool BlockPending;
+  vtkm::worklet::histogram::SparseHistogram Histogram;
 };
 }
 } // namespace vtkm::worklet
@@ -0,0 +1,198 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_StreamingStatistics_h
+#define vtk_m_worklet_StreamingStatistics_h
+
+#include <vtkm/Math.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/worklet/statistics/Moments.h>
+#include <vtkm/worklet/statistics/TDigest.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+
+// Accumulates the statistics of a field block by block without sorting it.
+// The moments (count, min, max, mean, variance, skewness, kurtosis) of a block
+// are computed with one parallel reduction and quantiles are estimated with a
+// t-digest, which is seeded from a fine histogram of the block. Accumulators
+// of different blocks (e.g. of a MultiBlock) or ranks are combined with Merge;
+// their state is GetMoments() and GetDigest(), from which an accumulator can
+// be rebuilt. statistics/ReduceStatistics.h serializes accumulators with DIY
+// and merges them over all ranks.
+class StreamingStatistics
+{
+public:
+  // compression bounds the number of centroids of the digest. The histogram a
+  // block is summarized with has numberOfSketchBins bins, and the value of a
+  // quantile is found to within about a bin width of the range of the block.
+  VTKM_CONT
+  StreamingStatistics(vtkm::Float64 compression = 200, vtkm::Id numberOfSketchBins = 4096)
+    : NumberOfSketchBins(numberOfSketchBins)
+    , Digest(compression)
+  {
+  }
+
+  // Rebuild an accumulator from its moments and digest.
+  VTKM_CONT
+  StreamingStatistics(const vtkm::worklet::statistics::Moments& moments,
+                      const vtkm::worklet::statistics::TDigest& digest,
+                      vtkm::Id numberOfSketchBins = 4096)
+    : NumberOfSketchBins(numberOfSketchBins)
+    , Moments(moments)
+    , Digest(digest)
+  {
+  }
+
+  // Computes the bin of a value in the histogram the digest is built from.
+  class ComputeSketchBin
+  {
+  public:
+    vtkm::Id NumberOfBins;
+    vtkm::Float64 MinValue;
+    vtkm::Float64 InverseDelta;
+
+    ComputeSketchBin() = default;
+
+    VTKM_CONT
+    ComputeSketchBin(vtkm::Id numberOfBins, vtkm::Float64 minValue, vtkm::Float64 inverseDelta)
+      : NumberOfBins(numberOfBins)
+      , MinValue(minValue)
+      , InverseDelta(inverseDelta)
+    {
+    }
+
+    template <typename T>
+    VTKM_EXEC_CONT vtkm::Id operator()(const T& value) const
+    {
+      const vtkm::Float64 bin =
+        (static_cast<vtkm::Float64>(value) - this->MinValue) * this->InverseDelta;
+      return vtkm::Max(vtkm::Id(0), vtkm::Min(static_cast<vtkm::Id>(bin), this->NumberOfBins - 1));
+    }
+  };
+
+  // Add the values of a block to the statistics.
+  template <typename FieldType, typename Storage, typename DeviceAdapter>
+  VTKM_CONT void AddBlock(const vtkm::cont::ArrayHandle<FieldType, Storage>& fieldArray,
+                          DeviceAdapter)
+  {
+    using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    if (fieldArray.GetNumberOfValues() == 0)
+    {
+      return;
+    }
+
+    // All moments of the block in one pass
+    auto moments =
+      vtkm::cont::make_ArrayHandleTransform(fieldArray, vtkm::worklet::statistics::MakeMoments());
+    const vtkm::worklet::statistics::Moments blockMoments = DeviceAlgorithms::Reduce(
+      moments, vtkm::worklet::statistics::Moments(), vtkm::worklet::statistics::CombineMoments());
+
+    // Digest of the block from its histogram over [Minimum, Maximum]
+    vtkm::worklet::statistics::TDigest blockDigest(this->Digest.GetCompression());
+    blockDigest.ExtendRange(blockMoments.Minimum, blockMoments.Maximum);
+    const vtkm::Float64 range = blockMoments.Maximum - blockMoments.Minimum;
+    if (range > 0)
+    {
+      const vtkm::Float64 delta = range / static_cast<vtkm::Float64>(this->NumberOfSketchBins);
+      auto binIndex = vtkm::cont::make_ArrayHandleTransform(
+        fieldArray, ComputeSketchBin(this->NumberOfSketchBins, blockMoments.Minimum, 1.0 / delta));
+      vtkm::cont::ArrayHandle<vtkm::Id> binCounts;
+      DeviceAlgorithms::Histogram(binIndex, this->NumberOfSketchBins, binCounts);
+
+      auto binPortal = binCounts.GetPortalConstControl();
+      for (vtkm::Id i = 0; i < this->NumberOfSketchBins; i++)
+      {
+        const vtkm::Float64 center =
+          blockMoments.Minimum + (static_cast<vtkm::Float64>(i) + 0.5) * delta;
+        blockDigest.Add(center, static_cast<vtkm::Float64>(binPortal.Get(i)));
+      }
+    }
+    else
+    {
+      blockDigest.Add(blockMoments.Minimum, blockMoments.Count);
+    }
+    blockDigest.Compress();
+
+    this->Moments = vtkm::worklet::statistics::CombineMoments()(this->Moments, blockMoments);
+    this->Digest.Merge(blockDigest);
+  }
+
+  // Add the statistics of other blocks or ranks.
+  VTKM_CONT
+  void Merge(const StreamingStatistics& other)
+  {
+    this->Moments = vtkm::worklet::statistics::CombineMoments()(this->Moments, other.Moments);
+    this->Digest.Merge(other.Digest);
+  }
+
+  VTKM_CONT
+  vtkm::Id GetNumberOfValues() const { return static_cast<vtkm::Id>(this->Moments.Count); }
+
+  VTKM_CONT
+  vtkm::Float64 GetMinimum() const { return this->Moments.Minimum; }
+
+  VTKM_CONT
+  vtkm::Float64 GetMaximum() const { return this->Moments.Maximum; }
+
+  VTKM_CONT
+  vtkm::Float64 GetMean() const { return this->Moments.Mean; }
+
+  VTKM_CONT
+  vtkm::Float64 GetVariance() const { return this->Moments.GetVariance(); }
+
+  VTKM_CONT
+  vtkm::Float64 GetStandardDeviation() const { return vtkm::Sqrt(this->GetVariance()); }
+
+  VTKM_CONT
+  vtkm::Float64 GetSkewness() const { return this->Moments.GetSkewness(); }
+
+  VTKM_CONT
+  vtkm::Float64 GetKurtosis() const { return this->Moments.GetKurtosis(); }
+
+  // Approximate quantile, q in [0, 1]
+  VTKM_CONT
+  vtkm::Float64 GetQuantile(vtkm::Float64 q) const { return this->Digest.GetQuantile(q); }
+
+  VTKM_CONT
+  vtkm::Float64 GetMedian() const { return this->GetQuantile(0.5); }
+
+  VTKM_CONT
+  const vtkm::worklet::statistics::Moments& GetMoments() const { return this->Moments; }
+
+  VTKM_CONT
+  const vtkm::worklet::statistics::TDigest& GetDigest() const { return this->Digest; }
+
+  VTKM_CONT
+  vtkm::Id GetNumberOfSketchBins() const { return this->NumberOfSketchBins; }
+
+private:
+  vtkm::Id NumberOfSketchBins;
+  vtkm::worklet::statistics::Moments Moments;
+  vtkm::worklet::statistics::TDigest Digest;
+};
+}
+} // namespace vtkm::worklet
+
+#endif // vtk_m_worklet_StreamingStatistics_h
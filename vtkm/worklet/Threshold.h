@@ -167,6 +167,37 @@ public:
     return OutputType(this->ValidCellIds, cellSet, cellSet.GetName());
   }
 
+  /// Same as Run, but only the cells listed in `candidateCellIds` are tested
+  /// against the predicate on a point field. `candidateCellIds` must be sorted
+  /// and contain every cell that can pass, e.g. the cells returned by a
+  /// BrickRangeIndex query, for the result to be the same as with Run.
+  template <typename CellSetType,
+            typename ValueType,
+            typename StorageType,
+            typename UnaryPredicate,
+            typename DeviceAdapter>
+  vtkm::cont::CellSetPermutation<CellSetType> RunOnCandidates(
+    const CellSetType& cellSet,
+    const vtkm::cont::ArrayHandle<ValueType, StorageType>& field,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& candidateCellIds,
+    const UnaryPredicate& predicate,
+    DeviceAdapter)
+  {
+    using OutputType = vtkm::cont::CellSetPermutation<CellSetType>;
+    using ThresholdWorklet = ThresholdByPointField<UnaryPredicate>;
+
+    vtkm::cont::ArrayHandle<bool> passFlags;
+    ThresholdWorklet worklet(predicate);
+    DispatcherMapTopology<ThresholdWorklet, DeviceAdapter> dispatcher(worklet);
+    dispatcher.Invoke(
+      vtkm::cont::make_CellSetPermutation(candidateCellIds, cellSet), field, passFlags);
+
+    vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>::CopyIf(
+      candidateCellIds, passFlags, this->ValidCellIds);
+
+    return OutputType(this->ValidCellIds, cellSet, cellSet.GetName());
+  }
+
   template <typename CellSetList, typename FieldArrayType, typename UnaryPredicate, typename Device>
   struct CallWorklet
   {
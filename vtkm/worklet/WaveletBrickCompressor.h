@@ -0,0 +1,389 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#ifndef vtk_m_worklet_waveletbrickcompressor_h
+#define vtk_m_worklet_waveletbrickcompressor_h
+
+#include <vtkm/worklet/WaveletCompressor.h>
+#include <vtkm/worklet/wavelets/CompressedBricks.h>
+
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace vtkm
+{
+namespace worklet
+{
+
+// Compresses a volume brick by brick into a wavelets::CompressedBricks
+// container. Every brick is decomposed with WaveDecompose3D, its small
+// coefficients are squashed, and only the surviving coefficients are encoded,
+// so that the container is actually smaller than the volume. Because bricks
+// are independent, a volume that does not fit in memory can be compressed by
+// passing its bricks to AddBrick() one at a time, and single bricks can be
+// reconstructed at a coarser level of detail without touching the others.
+class WaveletBrickCompressor : public vtkm::worklet::WaveletCompressor
+{
+public:
+  // Constructor
+  WaveletBrickCompressor(wavelets::WaveletName name)
+    : WaveletCompressor(name)
+  {
+  }
+
+  // Number of levels of transform applied to a brick of the given size. Bricks
+  // too small for the requested number of levels use as many as they support.
+  vtkm::Id GetBrickLevels(const vtkm::Id3& brickDims, vtkm::Id nLevels)
+  {
+    vtkm::Id levels = nLevels;
+    for (vtkm::IdComponent i = 0; i < 3; i++)
+    {
+      levels = vtkm::Min(levels, WaveletBase::GetWaveletMaxLevel(brickDims[i]));
+    }
+    return levels;
+  }
+
+  // Compresses one brick of the volume. The brick array holds the
+  // bricks.GetBrickDimensions(brickIndex) points of the brick.
+  template <typename BrickArrayType, typename DeviceTag>
+  void AddBrick(const BrickArrayType& brick,
+                const vtkm::Id3& brickIndex,
+                vtkm::Float64 ratio,
+                wavelets::CompressedBricks& bricks,
+                DeviceTag)
+  {
+    this->CheckWavelet(bricks);
+    vtkm::Id brickId = bricks.GetBrickId(brickIndex);
+    vtkm::Id3 dims = bricks.GetBrickDimensions(brickIndex);
+    if (brick.GetNumberOfValues() != dims[0] * dims[1] * dims[2])
+    {
+      throw vtkm::cont::ErrorBadValue("Brick array does not match the brick dimensions.");
+    }
+
+    BrickArrayType sigIn = brick; // WaveDecompose3D takes its input by non-const reference
+    vtkm::Id nLevels = this->GetBrickLevels(dims, bricks.GetNumberOfLevels());
+    vtkm::cont::ArrayHandle<vtkm::Float32> coeffs;
+    this->WaveDecompose3D(sigIn, nLevels, dims[0], dims[1], dims[2], coeffs, false, DeviceTag());
+
+    // Thin bricks on the faces of the volume get fewer levels of transform,
+    // so their approximation can hold more than 1/ratio of the coefficients.
+    // Keep at least as many coefficients as the approximation has, which
+    // leaves bricks that could not be transformed at all untouched.
+    vtkm::Id3 approxDims = dims;
+    for (vtkm::Id i = 0; i < nLevels; i++)
+    {
+      for (vtkm::IdComponent j = 0; j < 3; j++)
+      {
+        approxDims[j] = WaveletBase::GetApproxLength(approxDims[j]);
+      }
+    }
+    vtkm::Float64 maxRatio = static_cast<vtkm::Float64>(dims[0] * dims[1] * dims[2]) /
+      static_cast<vtkm::Float64>(approxDims[0] * approxDims[1] * approxDims[2]);
+    this->SquashCoefficients(coeffs, vtkm::Min(ratio, maxRatio), DeviceTag());
+
+    std::vector<vtkm::UInt8> bytes;
+    this->EncodeCoefficients(coeffs, bytes, DeviceTag());
+    bricks.SetBrick(brickId, std::move(bytes));
+  }
+
+  // Compresses a whole in-memory volume of bricks.GetDimensions() points
+  template <typename VolumeArrayType, typename DeviceTag>
+  void Compress(const VolumeArrayType& volume,
+                vtkm::Float64 ratio,
+                wavelets::CompressedBricks& bricks,
+                DeviceTag)
+  {
+    const vtkm::Id3& volDims = bricks.GetDimensions();
+    if (volume.GetNumberOfValues() != volDims[0] * volDims[1] * volDims[2])
+    {
+      throw vtkm::cont::ErrorBadValue("Volume array does not match the volume dimensions.");
+    }
+
+    using ValueType = typename VolumeArrayType::ValueType;
+    vtkm::Id3 grid = bricks.GetBrickGridDimensions();
+    vtkm::Id3 brickIndex;
+    for (brickIndex[2] = 0; brickIndex[2] < grid[2]; brickIndex[2]++)
+    {
+      for (brickIndex[1] = 0; brickIndex[1] < grid[1]; brickIndex[1]++)
+      {
+        for (brickIndex[0] = 0; brickIndex[0] < grid[0]; brickIndex[0]++)
+        {
+          vtkm::Id3 origin = bricks.GetBrickOrigin(brickIndex);
+          vtkm::Id3 dims = bricks.GetBrickDimensions(brickIndex);
+          vtkm::cont::ArrayHandle<ValueType> brick;
+          WaveletBase::DeviceCubeCopyFrom(volume,
+                                          volDims[0],
+                                          volDims[1],
+                                          volDims[2],
+                                          brick,
+                                          dims[0],
+                                          dims[1],
+                                          dims[2],
+                                          origin[0],
+                                          origin[1],
+                                          origin[2],
+                                          DeviceTag());
+          this->AddBrick(brick, brickIndex, ratio, bricks, DeviceTag());
+        }
+      }
+    }
+  }
+
+  // Reconstructs one brick. Level 0 gives the brick at full resolution; level
+  // j gives the approximation after j levels of transform, which has about
+  // 1/2^j as many points along each axis and is scaled to the range of the
+  // data. Bricks that were transformed with fewer levels than requested are
+  // returned at their coarsest level. The dimensions of the output are
+  // returned in outDims.
+  template <typename OutArrayType, typename DeviceTag>
+  void ReconstructBrick(const wavelets::CompressedBricks& bricks,
+                        const vtkm::Id3& brickIndex,
+                        vtkm::Id level,
+                        OutArrayType& brickOut,
+                        vtkm::Id3& outDims,
+                        DeviceTag)
+  {
+    this->CheckWavelet(bricks);
+    if (level < 0 || level > bricks.GetNumberOfLevels())
+    {
+      throw vtkm::cont::ErrorBadValue("Level of detail is not supported! ");
+    }
+    vtkm::Id3 dims = bricks.GetBrickDimensions(brickIndex);
+    vtkm::Id nLevels = this->GetBrickLevels(dims, bricks.GetNumberOfLevels());
+    level = vtkm::Min(level, nLevels);
+
+    vtkm::cont::ArrayHandle<vtkm::Float32> coeffs;
+    this->DecodeCoefficients(bricks.GetBrick(bricks.GetBrickId(brickIndex)),
+                             dims[0] * dims[1] * dims[2],
+                             coeffs,
+                             DeviceTag());
+
+    outDims = dims;
+    for (vtkm::Id i = 0; i < level; i++)
+    {
+      for (vtkm::IdComponent j = 0; j < 3; j++)
+      {
+        outDims[j] = WaveletBase::GetApproxLength(outDims[j]);
+      }
+    }
+
+    if (level == 0)
+    {
+      this->WaveReconstruct3D(
+        coeffs, nLevels, dims[0], dims[1], dims[2], brickOut, true, DeviceTag());
+      return;
+    }
+
+    // The coefficients of the level-j approximation occupy the low corner of
+    // the coefficient array, transformed by the remaining levels
+    vtkm::cont::ArrayHandle<vtkm::Float32> corner;
+    WaveletBase::DeviceCubeCopyFrom(coeffs,
+                                    dims[0],
+                                    dims[1],
+                                    dims[2],
+                                    corner,
+                                    outDims[0],
+                                    outDims[1],
+                                    outDims[2],
+                                    0,
+                                    0,
+                                    0,
+                                    DeviceTag());
+    coeffs.ReleaseResources();
+    this->WaveReconstruct3D(
+      corner, nLevels - level, outDims[0], outDims[1], outDims[2], brickOut, true, DeviceTag());
+
+    // Every level of 3D transform scales the approximation by 2^(3/2)
+    vtkm::Float64 scale = vtkm::Pow(2.0, -1.5 * static_cast<vtkm::Float64>(level));
+    using ScaleType = vtkm::worklet::wavelets::ScaleWorklet;
+    ScaleType scaleWorklet(scale);
+    vtkm::worklet::DispatcherMapField<ScaleType, DeviceTag> dispatcher(scaleWorklet);
+    dispatcher.Invoke(brickOut);
+  }
+
+  // Reconstructs the whole volume at full resolution
+  template <typename OutArrayType, typename DeviceTag>
+  void Reconstruct(const wavelets::CompressedBricks& bricks, OutArrayType& volumeOut, DeviceTag)
+  {
+    const vtkm::Id3& volDims = bricks.GetDimensions();
+    volumeOut.Allocate(volDims[0] * volDims[1] * volDims[2]);
+
+    using ValueType = typename OutArrayType::ValueType;
+    vtkm::Id3 grid = bricks.GetBrickGridDimensions();
+    vtkm::Id3 brickIndex;
+    for (brickIndex[2] = 0; brickIndex[2] < grid[2]; brickIndex[2]++)
+    {
+      for (brickIndex[1] = 0; brickIndex[1] < grid[1]; brickIndex[1]++)
+      {
+        for (brickIndex[0] = 0; brickIndex[0] < grid[0]; brickIndex[0]++)
+        {
+          vtkm::cont::ArrayHandle<ValueType> brick;
+          vtkm::Id3 dims;
+          this->ReconstructBrick(bricks, brickIndex, 0, brick, dims, DeviceTag());
+          vtkm::Id3 origin = bricks.GetBrickOrigin(brickIndex);
+          WaveletBase::DeviceCubeCopyTo(brick,
+                                        dims[0],
+                                        dims[1],
+                                        dims[2],
+                                        volumeOut,
+                                        volDims[0],
+                                        volDims[1],
+                                        volDims[2],
+                                        origin[0],
+                                        origin[1],
+                                        origin[2],
+                                        DeviceTag());
+        }
+      }
+    }
+  }
+
+private:
+  struct IsNonZero
+  {
+    VTKM_EXEC_CONT bool operator()(vtkm::Float32 value) const { return value != 0.0f; }
+  };
+
+  void CheckWavelet(const wavelets::CompressedBricks& bricks) const
+  {
+    if (bricks.GetWaveletName() != this->wname)
+    {
+      throw vtkm::cont::ErrorBadValue("Compressed bricks use a different wavelet kernel.");
+    }
+  }
+
+  // A brick is encoded as the number of non-zero coefficients, the gaps
+  // between consecutive non-zero coefficients, and then their values. Counts
+  // and gaps are written as base-128 variable length integers, so runs of
+  // squashed coefficients cost one or two bytes instead of four per value.
+  template <typename DeviceTag>
+  void EncodeCoefficients(const vtkm::cont::ArrayHandle<vtkm::Float32>& coeffs,
+                          std::vector<vtkm::UInt8>& bytes,
+                          DeviceTag)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceTag>;
+    vtkm::cont::ArrayHandle<vtkm::Id> indices;
+    vtkm::cont::ArrayHandle<vtkm::Float32> values;
+    Algorithm::CopyIf(
+      vtkm::cont::ArrayHandleIndex(coeffs.GetNumberOfValues()), coeffs, indices, IsNonZero());
+    Algorithm::CopyIf(coeffs, coeffs, values, IsNonZero());
+
+    vtkm::Id count = indices.GetNumberOfValues();
+    auto indexPortal = indices.GetPortalConstControl();
+    auto valuePortal = values.GetPortalConstControl();
+
+    bytes.clear();
+    bytes.reserve(static_cast<std::size_t>(count) * (sizeof(vtkm::Float32) + 2) + 10);
+    WriteVarInt(bytes, static_cast<vtkm::UInt64>(count));
+    vtkm::Id next = 0;
+    for (vtkm::Id i = 0; i < count; i++)
+    {
+      vtkm::Id index = indexPortal.Get(i);
+      WriteVarInt(bytes, static_cast<vtkm::UInt64>(index - next));
+      next = index + 1;
+    }
+    for (vtkm::Id i = 0; i < count; i++)
+    {
+      vtkm::Float32 value = valuePortal.Get(i);
+      const vtkm::UInt8* valueBytes = reinterpret_cast<const vtkm::UInt8*>(&value);
+      bytes.insert(bytes.end(), valueBytes, valueBytes + sizeof(vtkm::Float32));
+    }
+  }
+
+  template <typename DeviceTag>
+  void DecodeCoefficients(const std::vector<vtkm::UInt8>& bytes,
+                          vtkm::Id numberOfCoeffs,
+                          vtkm::cont::ArrayHandle<vtkm::Float32>& coeffs,
+                          DeviceTag)
+  {
+    std::size_t pos = 0;
+    vtkm::Id count = static_cast<vtkm::Id>(ReadVarInt(bytes, pos));
+    if (count > numberOfCoeffs)
+    {
+      throw vtkm::cont::ErrorBadValue("Corrupted compressed brick.");
+    }
+
+    std::vector<vtkm::Float32> dense(static_cast<std::size_t>(numberOfCoeffs), 0.0f);
+    std::vector<vtkm::Id> indices(static_cast<std::size_t>(count));
+    vtkm::Id next = 0;
+    for (auto& index : indices)
+    {
+      index = next + static_cast<vtkm::Id>(ReadVarInt(bytes, pos));
+      if (index < next || index >= numberOfCoeffs)
+      {
+        throw vtkm::cont::ErrorBadValue("Corrupted compressed brick.");
+      }
+      next = index + 1;
+    }
+    if (bytes.size() - pos != indices.size() * sizeof(vtkm::Float32))
+    {
+      throw vtkm::cont::ErrorBadValue("Corrupted compressed brick.");
+    }
+    for (vtkm::Id index : indices)
+    {
+      vtkm::Float32 value;
+      std::copy(bytes.begin() + static_cast<std::ptrdiff_t>(pos),
+                bytes.begin() + static_cast<std::ptrdiff_t>(pos + sizeof(vtkm::Float32)),
+                reinterpret_cast<vtkm::UInt8*>(&value));
+      dense[static_cast<std::size_t>(index)] = value;
+      pos += sizeof(vtkm::Float32);
+    }
+
+    vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(dense), coeffs, DeviceTag());
+  }
+
+  static void WriteVarInt(std::vector<vtkm::UInt8>& bytes, vtkm::UInt64 value)
+  {
+    while (value >= 0x80)
+    {
+      bytes.push_back(static_cast<vtkm::UInt8>(value | 0x80));
+      value >>= 7;
+    }
+    bytes.push_back(static_cast<vtkm::UInt8>(value));
+  }
+
+  static vtkm::UInt64 ReadVarInt(const std::vector<vtkm::UInt8>& bytes, std::size_t& pos)
+  {
+    vtkm::UInt64 value = 0;
+    for (vtkm::UInt32 shift = 0; shift < 64; shift += 7)
+    {
+      if (pos >= bytes.size())
+      {
+        throw vtkm::cont::ErrorBadValue("Corrupted compressed brick.");
+      }
+      vtkm::UInt8 byte = bytes[pos++];
+      value |= static_cast<vtkm::UInt64>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+      {
+        return value;
+      }
+    }
+    throw vtkm::cont::ErrorBadValue("Corrupted compressed brick.");
+  }
+};
+
+} // namespace worklet
+} // namespace vtkm
+
+#endif // vtk_m_worklet_waveletbrickcompressor_h
@@ -472,15 +472,12 @@ public:
     if (ratio > 1.0)
     {
       vtkm::Id coeffLen = coeffIn.GetNumberOfValues();
-      using ValueType = typename CoeffArrayType::ValueType;
-      using CoeffArrayBasic = vtkm::cont::ArrayHandle<ValueType>;
-      CoeffArrayBasic sortedArray;
-      vtkm::cont::ArrayCopy(coeffIn, sortedArray, DeviceTag());
-
-      WaveletBase::DeviceSort(sortedArray, DeviceTag());
 
+      // Only the n-th smallest magnitude is needed, so select it instead of
+      // sorting all coefficients
       vtkm::Id n = coeffLen - static_cast<vtkm::Id>(static_cast<vtkm::Float64>(coeffLen) / ratio);
-      vtkm::Float64 nthVal = static_cast<vtkm::Float64>(sortedArray.GetPortalConstControl().Get(n));
+      vtkm::Float64 nthVal =
+        static_cast<vtkm::Float64>(WaveletBase::DeviceSelectNth(coeffIn, n, DeviceTag()));
       if (nthVal < 0.0)
       {
         nthVal *= -1.0;
@@ -0,0 +1,420 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#ifndef vtkm_worklet_contourtree_boundary_tree_h
+#define vtkm_worklet_contourtree_boundary_tree_h
+
+#include <vtkm/Pair.h>
+#include <vtkm/Types.h>
+#include <vtkm/worklet/contourtree/Types.h>
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <vector>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace contourtree
+{
+
+// The join and split trees of one block of a decomposed volume, or of a group of blocks
+// that have already been merged, kept only on the vertices needed to continue merging:
+// the critical points of either tree and the vertices still shared with blocks outside
+// the group. Vertices that are regular in both trees and no longer shared are spliced out,
+// so the trees shrink towards the size of the contour tree as the groups grow.
+//
+// Vertices are identified by their index in the whole volume, which also breaks ties
+// between equal values as in VertexValueComparator. As in MergeTree, join arcs point
+// down towards the global minimum and split arcs up towards the global maximum.
+class BoundaryTree
+{
+public:
+  // global index of each vertex, in ascending order
+  std::vector<vtkm::Id> vertexIds;
+
+  // data value of each vertex
+  std::vector<vtkm::Float64> values;
+
+  // global index of the next vertex down the join tree, or NO_VERTEX_ASSIGNED at the root
+  std::vector<vtkm::Id> joinArcs;
+
+  // global index of the next vertex up the split tree, or NO_VERTEX_ASSIGNED at the root
+  std::vector<vtkm::Id> splitArcs;
+
+  // number of blocks of the volume that contain each vertex
+  std::vector<vtkm::Id> nSharing;
+
+  // number of those blocks that have been merged into this tree
+  std::vector<vtkm::Id> nMerged;
+
+  vtkm::Id GetNumberOfVertices() const { return static_cast<vtkm::Id>(vertexIds.size()); }
+
+  // appends a vertex; vertices have to be added in ascending order of global index
+  void AddVertex(vtkm::Id vertexId,
+                 vtkm::Float64 value,
+                 vtkm::Id joinArc,
+                 vtkm::Id splitArc,
+                 vtkm::Id sharing,
+                 vtkm::Id merged);
+
+  // glues the trees of another group of blocks to these along the vertices they share
+  void Merge(const BoundaryTree& other);
+
+  // splices out the vertices that are regular in both trees and no longer shared
+  void Simplify();
+
+  // marks every vertex as no longer shared once all blocks have been merged, even where
+  // the blocks did not agree on how many of them meet at a vertex, and simplifies
+  void Finish();
+
+  // combines the join and split trees into the contour tree once every block has been
+  // merged in. Superarcs are stored with the lower global index first and sorted in the
+  // same way as ContourTree::CollectSaddlePeak
+  void CollectSaddlePeak(std::vector<vtkm::Pair<vtkm::Id, vtkm::Id>>& saddlePeak) const;
+
+  // position of a vertex given its global index, or NO_VERTEX_ASSIGNED
+  vtkm::Id FindVertex(vtkm::Id vertexId) const;
+
+  // whether vertex i comes after vertex j in ascending order, given their positions
+  bool IsHigher(vtkm::Id i, vtkm::Id j) const;
+
+private:
+  // computes the join (or split) tree of the graph formed by a set of edges between the
+  // vertices of this tree with union-find, returning the arc of each vertex as a position
+  std::vector<vtkm::Id> ComputeMergeArcs(const std::vector<vtkm::Pair<vtkm::Id, vtkm::Id>>& edges,
+                                         bool isJoinTree) const;
+}; // class BoundaryTree
+
+inline void BoundaryTree::AddVertex(vtkm::Id vertexId,
+                                    vtkm::Float64 value,
+                                    vtkm::Id joinArc,
+                                    vtkm::Id splitArc,
+                                    vtkm::Id sharing,
+                                    vtkm::Id merged)
+{
+  vertexIds.push_back(vertexId);
+  values.push_back(value);
+  joinArcs.push_back(joinArc);
+  splitArcs.push_back(splitArc);
+  nSharing.push_back(sharing);
+  nMerged.push_back(merged);
+} // AddVertex()
+
+inline vtkm::Id BoundaryTree::FindVertex(vtkm::Id vertexId) const
+{
+  auto found = std::lower_bound(vertexIds.begin(), vertexIds.end(), vertexId);
+  if (found == vertexIds.end() || *found != vertexId)
+    return NO_VERTEX_ASSIGNED;
+  return static_cast<vtkm::Id>(found - vertexIds.begin());
+} // FindVertex()
+
+inline bool BoundaryTree::IsHigher(vtkm::Id i, vtkm::Id j) const
+{
+  const std::size_t a = static_cast<std::size_t>(i);
+  const std::size_t b = static_cast<std::size_t>(j);
+  if (values[a] != values[b])
+    return values[a] > values[b];
+  return vertexIds[a] > vertexIds[b];
+} // IsHigher()
+
+inline std::vector<vtkm::Id> BoundaryTree::ComputeMergeArcs(
+  const std::vector<vtkm::Pair<vtkm::Id, vtkm::Id>>& edges,
+  bool isJoinTree) const
+{
+  const vtkm::Id nVertices = GetNumberOfVertices();
+
+  // adjacency lists in compressed form
+  std::vector<vtkm::Id> offsets(static_cast<std::size_t>(nVertices + 1), 0);
+  for (const auto& edge : edges)
+  {
+    offsets[static_cast<std::size_t>(edge.first + 1)]++;
+    offsets[static_cast<std::size_t>(edge.second + 1)]++;
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<vtkm::Id> neighbours(static_cast<std::size_t>(offsets.back()));
+  std::vector<vtkm::Id> fill(offsets.begin(), offsets.end() - 1);
+  for (const auto& edge : edges)
+  {
+    neighbours[static_cast<std::size_t>(fill[static_cast<std::size_t>(edge.first)]++)] =
+      edge.second;
+    neighbours[static_cast<std::size_t>(fill[static_cast<std::size_t>(edge.second)]++)] =
+      edge.first;
+  }
+
+  // the join tree sweeps from the highest vertex down, the split tree from the lowest up
+  std::vector<vtkm::Id> order(static_cast<std::size_t>(nVertices));
+  std::iota(order.begin(), order.end(), vtkm::Id(0));
+  std::sort(order.begin(), order.end(), [&](vtkm::Id i, vtkm::Id j) {
+    return isJoinTree ? IsHigher(i, j) : IsHigher(j, i);
+  });
+  std::vector<vtkm::Id> sweepIndex(static_cast<std::size_t>(nVertices));
+  for (vtkm::Id index = 0; index < nVertices; index++)
+    sweepIndex[static_cast<std::size_t>(order[static_cast<std::size_t>(index)])] = index;
+
+  // union-find over the swept vertices; each component remembers the last vertex that was
+  // added to it, which is where the arc goes when the component is merged into another
+  std::vector<vtkm::Id> component(static_cast<std::size_t>(nVertices));
+  std::vector<vtkm::Id> lastVertex(static_cast<std::size_t>(nVertices));
+  std::vector<vtkm::Id> arcs(static_cast<std::size_t>(nVertices), NO_VERTEX_ASSIGNED);
+  auto findRoot = [&](vtkm::Id vertex) {
+    while (component[static_cast<std::size_t>(vertex)] != vertex)
+    {
+      vtkm::Id& up = component[static_cast<std::size_t>(vertex)];
+      up = component[static_cast<std::size_t>(up)];
+      vertex = up;
+    }
+    return vertex;
+  };
+
+  for (vtkm::Id index = 0; index < nVertices; index++)
+  {
+    const vtkm::Id vertex = order[static_cast<std::size_t>(index)];
+    component[static_cast<std::size_t>(vertex)] = vertex;
+    lastVertex[static_cast<std::size_t>(vertex)] = vertex;
+    for (vtkm::Id nbr = offsets[static_cast<std::size_t>(vertex)];
+         nbr < offsets[static_cast<std::size_t>(vertex + 1)];
+         nbr++)
+    {
+      const vtkm::Id neighbour = neighbours[static_cast<std::size_t>(nbr)];
+      if (sweepIndex[static_cast<std::size_t>(neighbour)] > index)
+        continue;
+      const vtkm::Id root = findRoot(neighbour);
+      if (root == vertex)
+        continue;
+      arcs[static_cast<std::size_t>(lastVertex[static_cast<std::size_t>(root)])] = vertex;
+      component[static_cast<std::size_t>(root)] = vertex;
+    }
+  }
+  return arcs;
+} // ComputeMergeArcs()
+
+inline void BoundaryTree::Merge(const BoundaryTree& other)
+{
+  // take the union of the two vertex sets, both of which are sorted
+  BoundaryTree merged;
+  std::size_t i = 0, j = 0;
+  while (i < vertexIds.size() || j < other.vertexIds.size())
+  {
+    if (j == other.vertexIds.size() || (i < vertexIds.size() && vertexIds[i] < other.vertexIds[j]))
+    {
+      merged.AddVertex(vertexIds[i],
+                       values[i],
+                       NO_VERTEX_ASSIGNED,
+                       NO_VERTEX_ASSIGNED,
+                       nSharing[i],
+                       nMerged[i]);
+      i++;
+    }
+    else if (i == vertexIds.size() || other.vertexIds[j] < vertexIds[i])
+    {
+      merged.AddVertex(other.vertexIds[j],
+                       other.values[j],
+                       NO_VERTEX_ASSIGNED,
+                       NO_VERTEX_ASSIGNED,
+                       other.nSharing[j],
+                       other.nMerged[j]);
+      j++;
+    }
+    else
+    { // shared vertex
+      merged.AddVertex(vertexIds[i],
+                       values[i],
+                       NO_VERTEX_ASSIGNED,
+                       NO_VERTEX_ASSIGNED,
+                       std::max(nSharing[i], other.nSharing[j]),
+                       nMerged[i] + other.nMerged[j]);
+      i++;
+      j++;
+    } // shared vertex
+  }
+
+  // the arcs of both trees become the edges of a graph whose merge trees are the merge
+  // trees of the union of the two groups of blocks
+  std::vector<vtkm::Pair<vtkm::Id, vtkm::Id>> joinEdges, splitEdges;
+  const BoundaryTree* trees[2] = { this, &other };
+  for (const BoundaryTree* tree : trees)
+  {
+    for (std::size_t vertex = 0; vertex < tree->vertexIds.size(); vertex++)
+    {
+      vtkm::Id from = merged.FindVertex(tree->vertexIds[vertex]);
+      if (tree->joinArcs[vertex] != NO_VERTEX_ASSIGNED)
+        joinEdges.push_back(vtkm::make_Pair(from, merged.FindVertex(tree->joinArcs[vertex])));
+      if (tree->splitArcs[vertex] != NO_VERTEX_ASSIGNED)
+        splitEdges.push_back(vtkm::make_Pair(from, merged.FindVertex(tree->splitArcs[vertex])));
+    }
+  }
+
+  std::vector<vtkm::Id> joinTargets = merged.ComputeMergeArcs(joinEdges, true);
+  std::vector<vtkm::Id> splitTargets = merged.ComputeMergeArcs(splitEdges, false);
+  for (std::size_t vertex = 0; vertex < merged.vertexIds.size(); vertex++)
+  {
+    if (joinTargets[vertex] != NO_VERTEX_ASSIGNED)
+      merged.joinArcs[vertex] = merged.vertexIds[static_cast<std::size_t>(joinTargets[vertex])];
+    if (splitTargets[vertex] != NO_VERTEX_ASSIGNED)
+      merged.splitArcs[vertex] = merged.vertexIds[static_cast<std::size_t>(splitTargets[vertex])];
+  }
+
+  *this = std::move(merged);
+} // Merge()
+
+inline void BoundaryTree::Simplify()
+{
+  const std::size_t nVertices = vertexIds.size();
+
+  std::vector<vtkm::Id> joinTargets(nVertices), splitTargets(nVertices);
+  std::vector<vtkm::Id> joinUpDegree(nVertices, 0), splitDownDegree(nVertices, 0);
+  for (std::size_t vertex = 0; vertex < nVertices; vertex++)
+  {
+    joinTargets[vertex] = FindVertex(joinArcs[vertex]);
+    splitTargets[vertex] = FindVertex(splitArcs[vertex]);
+    if (joinTargets[vertex] != NO_VERTEX_ASSIGNED)
+      joinUpDegree[static_cast<std::size_t>(joinTargets[vertex])]++;
+    if (splitTargets[vertex] != NO_VERTEX_ASSIGNED)
+      splitDownDegree[static_cast<std::size_t>(splitTargets[vertex])]++;
+  }
+
+  std::vector<bool> keep(nVertices);
+  for (std::size_t vertex = 0; vertex < nVertices; vertex++)
+  {
+    bool joinRegular = joinUpDegree[vertex] == 1 && joinTargets[vertex] != NO_VERTEX_ASSIGNED;
+    bool splitRegular = splitDownDegree[vertex] == 1 && splitTargets[vertex] != NO_VERTEX_ASSIGNED;
+    keep[vertex] = !(joinRegular && splitRegular && nMerged[vertex] >= nSharing[vertex]);
+  }
+
+  // every spliced vertex has exactly one vertex above and below it, so following the
+  // arcs to the next kept vertex visits each of them once per tree
+  BoundaryTree simplified;
+  for (std::size_t vertex = 0; vertex < nVertices; vertex++)
+  {
+    if (!keep[vertex])
+      continue;
+    vtkm::Id joinTo = joinTargets[vertex];
+    while (joinTo != NO_VERTEX_ASSIGNED && !keep[static_cast<std::size_t>(joinTo)])
+      joinTo = joinTargets[static_cast<std::size_t>(joinTo)];
+    vtkm::Id splitTo = splitTargets[vertex];
+    while (splitTo != NO_VERTEX_ASSIGNED && !keep[static_cast<std::size_t>(splitTo)])
+      splitTo = splitTargets[static_cast<std::size_t>(splitTo)];
+    simplified.AddVertex(
+      vertexIds[vertex],
+      values[vertex],
+      joinTo == NO_VERTEX_ASSIGNED ? joinTo : vertexIds[static_cast<std::size_t>(joinTo)],
+      splitTo == NO_VERTEX_ASSIGNED ? splitTo : vertexIds[static_cast<std::size_t>(splitTo)],
+      nSharing[vertex],
+      nMerged[vertex]);
+  }
+
+  *this = std::move(simplified);
+} // Simplify()
+
+inline void BoundaryTree::Finish()
+{
+  nMerged = nSharing;
+  Simplify();
+} // Finish()
+
+inline void BoundaryTree::CollectSaddlePeak(
+  std::vector<vtkm::Pair<vtkm::Id, vtkm::Id>>& saddlePeak) const
+{
+  BoundaryTree tree(*this);
+  tree.Finish();
+
+  const vtkm::Id nVertices = tree.GetNumberOfVertices();
+  std::vector<vtkm::Id> joinTargets(static_cast<std::size_t>(nVertices));
+  std::vector<vtkm::Id> splitTargets(static_cast<std::size_t>(nVertices));
+  std::vector<std::set<vtkm::Id>> joinUp(static_cast<std::size_t>(nVertices));
+  std::vector<std::set<vtkm::Id>> splitDown(static_cast<std::size_t>(nVertices));
+  for (vtkm::Id vertex = 0; vertex < nVertices; vertex++)
+  {
+    const std::size_t v = static_cast<std::size_t>(vertex);
+    joinTargets[v] = tree.FindVertex(tree.joinArcs[v]);
+    splitTargets[v] = tree.FindVertex(tree.splitArcs[v]);
+    if (joinTargets[v] != NO_VERTEX_ASSIGNED)
+      joinUp[static_cast<std::size_t>(joinTargets[v])].insert(vertex);
+    if (splitTargets[v] != NO_VERTEX_ASSIGNED)
+      splitDown[static_cast<std::size_t>(splitTargets[v])].insert(vertex);
+  }
+
+  // transfer leaves to the contour tree one at a time: an upper leaf of the join tree
+  // with a single vertex below it in the split tree hangs off its join arc, and a lower
+  // leaf of the split tree with a single vertex above it in the join tree hangs off its
+  // split arc. The leaf is then removed from both trees.
+  std::vector<vtkm::Pair<vtkm::Id, vtkm::Id>> superarcs;
+  std::vector<bool> removed(static_cast<std::size_t>(nVertices), false);
+  std::vector<vtkm::Id> candidates(static_cast<std::size_t>(nVertices));
+  std::iota(candidates.begin(), candidates.end(), vtkm::Id(0));
+  vtkm::Id nRemaining = nVertices;
+  while (nRemaining > 1 && !candidates.empty())
+  {
+    const vtkm::Id vertex = candidates.back();
+    const std::size_t v = static_cast<std::size_t>(vertex);
+    candidates.pop_back();
+    if (removed[v])
+      continue;
+
+    bool upperLeaf = joinUp[v].empty() && splitDown[v].size() == 1;
+    bool lowerLeaf = splitDown[v].empty() && joinUp[v].size() == 1;
+    if (!upperLeaf && !lowerLeaf)
+      continue;
+
+    // the tree the leaf hangs from, and the one it has to be spliced out of
+    std::vector<vtkm::Id>& leafTargets = upperLeaf ? joinTargets : splitTargets;
+    std::vector<std::set<vtkm::Id>>& leafNeighbours = upperLeaf ? joinUp : splitDown;
+    std::vector<vtkm::Id>& otherTargets = upperLeaf ? splitTargets : joinTargets;
+    std::vector<std::set<vtkm::Id>>& otherNeighbours = upperLeaf ? splitDown : joinUp;
+
+    const vtkm::Id target = leafTargets[v];
+    if (target == NO_VERTEX_ASSIGNED)
+      continue;
+    superarcs.push_back(vtkm::make_Pair(tree.vertexIds[v],
+                                        tree.vertexIds[static_cast<std::size_t>(target)]));
+    leafNeighbours[static_cast<std::size_t>(target)].erase(vertex);
+
+    const vtkm::Id inner = *otherNeighbours[v].begin();
+    const vtkm::Id outer = otherTargets[v];
+    otherTargets[static_cast<std::size_t>(inner)] = outer;
+    if (outer != NO_VERTEX_ASSIGNED)
+    {
+      otherNeighbours[static_cast<std::size_t>(outer)].erase(vertex);
+      otherNeighbours[static_cast<std::size_t>(outer)].insert(inner);
+    }
+
+    removed[v] = true;
+    nRemaining--;
+    candidates.push_back(target);
+    candidates.push_back(inner);
+  }
+
+  saddlePeak.clear();
+  for (const auto& superarc : superarcs)
+  {
+    saddlePeak.push_back(superarc.first < superarc.second
+                           ? superarc
+                           : vtkm::make_Pair(superarc.second, superarc.first));
+  }
+  std::sort(saddlePeak.begin(), saddlePeak.end());
+} // CollectSaddlePeak()
+}
+}
+}
+
+#endif
@@ -0,0 +1,181 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#ifndef vtkm_worklet_contourtree_branch_decomposition_h
+#define vtkm_worklet_contourtree_branch_decomposition_h
+
+#include <vtkm/Math.h>
+#include <vtkm/Types.h>
+#include <vtkm/worklet/contourtree/BoundaryTree.h>
+#include <vtkm/worklet/contourtree/Types.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace contourtree
+{
+
+// Branch decomposition of the contour tree by persistence, used to simplify it.
+//
+// Maxima are paired with join saddles by sweeping the join tree from the top: where the
+// components of several maxima meet, every maximum but the highest ends its branch at the
+// saddle, and the branch of the highest maximum is its parent. Minima are paired with
+// split saddles in the same way along the split tree. The main branch runs from the
+// global minimum to the global maximum.
+//
+// Branches are sorted by increasing persistence, the difference in value between their
+// two ends, and a branch always has a larger persistence than its children. Simplifying
+// the tree at a threshold amounts to dropping the branches whose persistence is below it.
+class BranchDecomposition
+{
+public:
+  // global index of the extremum at the free end of each branch; the global maximum for
+  // the main branch
+  std::vector<vtkm::Id> extrema;
+
+  // global index of the saddle where each branch joins its parent; the global minimum
+  // for the main branch
+  std::vector<vtkm::Id> saddles;
+
+  // absolute difference of the values at both ends
+  std::vector<vtkm::Float64> persistence;
+
+  // index of the parent branch, or NO_VERTEX_ASSIGNED for the main branch
+  std::vector<vtkm::Id> parents;
+
+  vtkm::Id GetNumberOfBranches() const { return static_cast<vtkm::Id>(extrema.size()); }
+
+  // decomposes the contour tree of a boundary tree that every block has been merged into
+  void Compute(const BoundaryTree& boundaryTree);
+}; // class BranchDecomposition
+
+inline void BranchDecomposition::Compute(const BoundaryTree& boundaryTree)
+{
+  BoundaryTree tree(boundaryTree);
+  tree.Finish();
+
+  extrema.clear();
+  saddles.clear();
+  persistence.clear();
+  parents.clear();
+
+  const vtkm::Id nVertices = tree.GetNumberOfVertices();
+  if (nVertices == 0)
+    return;
+
+  std::vector<vtkm::Id> order(static_cast<std::size_t>(nVertices));
+  std::iota(order.begin(), order.end(), vtkm::Id(0));
+  std::sort(
+    order.begin(), order.end(), [&](vtkm::Id i, vtkm::Id j) { return tree.IsHigher(i, j); });
+
+  // pairs of extremum, saddle and the surviving extremum, as positions in the tree
+  std::vector<vtkm::Id> pairExtrema, pairSaddles, pairSurvivors;
+
+  // sweep the join tree from the top and the split tree from the bottom, keeping for
+  // every vertex the extremum of the component it belongs to once it has been swept
+  for (bool isJoinTree : { true, false })
+  {
+    const std::vector<vtkm::Id>& arcs = isJoinTree ? tree.joinArcs : tree.splitArcs;
+    std::vector<vtkm::Id> componentExtremum(static_cast<std::size_t>(nVertices),
+                                            NO_VERTEX_ASSIGNED);
+    for (vtkm::Id index = 0; index < nVertices; index++)
+    {
+      const vtkm::Id vertex =
+        order[static_cast<std::size_t>(isJoinTree ? index : nVertices - 1 - index)];
+      vtkm::Id& extremum = componentExtremum[static_cast<std::size_t>(vertex)];
+      if (extremum == NO_VERTEX_ASSIGNED)
+        extremum = vertex;
+
+      const vtkm::Id target = tree.FindVertex(arcs[static_cast<std::size_t>(vertex)]);
+      if (target == NO_VERTEX_ASSIGNED)
+        continue;
+
+      // the component of the vertex is merged into the one at the far end of its arc;
+      // where two meet, the less extreme extremum ends its branch at the saddle
+      vtkm::Id& targetExtremum = componentExtremum[static_cast<std::size_t>(target)];
+      if (targetExtremum == NO_VERTEX_ASSIGNED)
+      {
+        targetExtremum = extremum;
+        continue;
+      }
+      vtkm::Id survivor = targetExtremum;
+      vtkm::Id victim = extremum;
+      if (tree.IsHigher(victim, survivor) == isJoinTree)
+        std::swap(survivor, victim);
+      pairExtrema.push_back(victim);
+      pairSaddles.push_back(target);
+      pairSurvivors.push_back(survivor);
+      targetExtremum = survivor;
+    }
+  }
+
+  const vtkm::Id globalMax = order.front();
+  const vtkm::Id globalMin = order.back();
+  pairExtrema.push_back(globalMax);
+  pairSaddles.push_back(globalMin);
+  pairSurvivors.push_back(NO_VERTEX_ASSIGNED);
+
+  // sort the branches by persistence; ties keep the main branch last
+  const std::size_t nBranches = pairExtrema.size();
+  std::vector<vtkm::Float64> pairPersistence(nBranches);
+  for (std::size_t pair = 0; pair < nBranches; pair++)
+  {
+    pairPersistence[pair] =
+      vtkm::Abs(tree.values[static_cast<std::size_t>(pairExtrema[pair])] -
+                tree.values[static_cast<std::size_t>(pairSaddles[pair])]);
+  }
+  std::vector<std::size_t> branchOrder(nBranches);
+  std::iota(branchOrder.begin(), branchOrder.end(), std::size_t(0));
+  std::stable_sort(branchOrder.begin(), branchOrder.end(), [&](std::size_t a, std::size_t b) {
+    return pairPersistence[a] < pairPersistence[b];
+  });
+
+  // a branch is identified by its extremum, except for the main branch which owns both
+  // the global maximum and the global minimum
+  std::vector<vtkm::Id> extremumBranch(static_cast<std::size_t>(nVertices), NO_VERTEX_ASSIGNED);
+  for (std::size_t branch = 0; branch < nBranches; branch++)
+  {
+    const std::size_t pair = branchOrder[branch];
+    extremumBranch[static_cast<std::size_t>(pairExtrema[pair])] = static_cast<vtkm::Id>(branch);
+  }
+  extremumBranch[static_cast<std::size_t>(globalMin)] =
+    extremumBranch[static_cast<std::size_t>(globalMax)];
+
+  for (std::size_t branch = 0; branch < nBranches; branch++)
+  {
+    const std::size_t pair = branchOrder[branch];
+    extrema.push_back(tree.vertexIds[static_cast<std::size_t>(pairExtrema[pair])]);
+    saddles.push_back(tree.vertexIds[static_cast<std::size_t>(pairSaddles[pair])]);
+    persistence.push_back(pairPersistence[pair]);
+    parents.push_back(pairSurvivors[pair] == NO_VERTEX_ASSIGNED
+                        ? NO_VERTEX_ASSIGNED
+                        : extremumBranch[static_cast<std::size_t>(pairSurvivors[pair])]);
+  }
+} // Compute()
+}
+}
+}
+
+#endif
@@ -0,0 +1,118 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+//  This code is based on the algorithm presented in the paper:
+//  “Parallel Peak Pruning for Scalable SMP Contour Tree Computation.”
+//  Hamish Carr, Gunther Weber, Christopher Sewell, and James Ahrens.
+//  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
+//  (LDAV), October 2016, Baltimore, Maryland.
+
+//=======================================================================================
+//
+// COMMENTS:
+//
+// Labels the connected components of an explicit mesh, so that meshes the contour tree
+// cannot handle are rejected up front. Every vertex starts with its own index as label.
+// Each pass gives every cell the smallest label of its points, then every vertex the
+// smallest label of its incident cells, or the label of its own label if smaller, which
+// lets the labels jump ahead. When a pass changes nothing, each vertex is labelled with
+// the smallest vertex of its component.
+//
+//=======================================================================================
+
+#ifndef vtkm_worklet_contourtree_mesh_explicit_component_labeller_h
+#define vtkm_worklet_contourtree_mesh_explicit_component_labeller_h
+
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/contourtree/Types.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace contourtree
+{
+
+// Worklet for giving each cell the smallest label of its points
+class MeshExplicit_CellLabeller : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<IdType> cellFirstPoint,  // (input) first point
+                                FieldIn<IdType> cellNPoints,     // (input) number of points
+                                WholeArrayIn<IdType> cellPoints, // (input) points of cells
+                                WholeArrayIn<IdType> label,      // (input) vertex labels
+                                FieldOut<IdType> cellLabel);     // (output) cell label
+  using ExecutionSignature = void(_1, _2, _3, _4, _5);
+  using InputDomain = _1;
+
+  template <typename InFieldPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& cellFirstPoint,
+                            const vtkm::Id& cellNPoints,
+                            const InFieldPortalType& cellPoints,
+                            const InFieldPortalType& label,
+                            vtkm::Id& cellLabel) const
+  {
+    vtkm::Id smallest = label.Get(cellPoints.Get(cellFirstPoint));
+    for (vtkm::Id point = cellFirstPoint + 1; point < cellFirstPoint + cellNPoints; point++)
+      smallest = vtkm::Min(smallest, label.Get(cellPoints.Get(point)));
+    cellLabel = smallest;
+  }
+}; // MeshExplicit_CellLabeller
+
+// Worklet for giving each vertex the smallest label of its incident cells
+class MeshExplicit_VertexLabeller : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<IdType> vertexID,           // (input) index of vertex
+                                FieldIn<IdType> firstCell,          // (input) first slot
+                                FieldIn<IdType> nIncidentCells,     // (input) number of slots
+                                WholeArrayIn<IdType> incidentCells, // (input) cells of slots
+                                WholeArrayIn<IdType> cellLabel,     // (input) cell labels
+                                WholeArrayIn<IdType> label,         // (input) vertex labels
+                                FieldOut<IdType> newLabel,          // (output) vertex label
+                                FieldOut<IdType> changed);          // (output) whether changed
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8);
+  using InputDomain = _1;
+
+  template <typename InFieldPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& vertexID,
+                            const vtkm::Id& firstCell,
+                            const vtkm::Id& nIncidentCells,
+                            const InFieldPortalType& incidentCells,
+                            const InFieldPortalType& cellLabel,
+                            const InFieldPortalType& label,
+                            vtkm::Id& newLabel,
+                            vtkm::Id& changed) const
+  {
+    vtkm::Id oldLabel = label.Get(vertexID);
+    vtkm::Id smallest = label.Get(oldLabel);
+    for (vtkm::Id slot = firstCell; slot < firstCell + nIncidentCells; slot++)
+      smallest = vtkm::Min(smallest, cellLabel.Get(incidentCells.Get(slot)));
+    newLabel = smallest;
+    changed = (smallest != oldLabel) ? 1 : 0;
+  }
+}; // MeshExplicit_VertexLabeller
+
+} // namespace contourtree
+} // namespace worklet
+} // namespace vtkm
+
+#endif
@@ -0,0 +1,130 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+//  This code is based on the algorithm presented in the paper:
+//  “Parallel Peak Pruning for Scalable SMP Contour Tree Computation.”
+//  Hamish Carr, Gunther Weber, Christopher Sewell, and James Ahrens.
+//  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
+//  (LDAV), October 2016, Baltimore, Maryland.
+
+//=======================================================================================
+//
+// COMMENTS:
+//
+// The explicit mesh counterpart of Mesh3D_DEM_SaddleStarter. It walks the link components
+// of a critical vertex in the same order as MeshExplicit_VertexOutdegreeStarter and adds
+// an edge to the chain extremum of each of them, skipping extrema already reached.
+//
+//=======================================================================================
+
+#ifndef vtkm_worklet_contourtree_mesh_explicit_saddle_starter_h
+#define vtkm_worklet_contourtree_mesh_explicit_saddle_starter_h
+
+#include <vtkm/Pair.h>
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/contourtree/Types.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace contourtree
+{
+
+// Worklet for setting the outgoing edges of the critical vertices
+class MeshExplicit_SaddleStarter : public vtkm::worklet::WorkletMapField
+{
+public:
+  struct PairType : vtkm::ListTagBase<vtkm::Pair<vtkm::Id, vtkm::Id>>
+  {
+  };
+
+  using ControlSignature =
+    void(FieldIn<IdType> vertex,              // (input) index into active vertices
+         FieldIn<PairType> outDegFirstEdge,   // (input) out degree/first edge of vertex
+         FieldIn<IdType> valueIndex,          // (input) index into regular graph
+         WholeArrayIn<IdType> firstCell,      // (input) first slot of each vertex
+         WholeArrayIn<IdType> nIncidentCells, // (input) number of slots of each vertex
+         WholeArrayIn<IdType> linkComponent,  // (input) link components
+         WholeArrayIn<IdType> linkNeighbour,  // (input) link points
+         WholeArrayIn<IdType> arcArray,       // (input) chain extrema per vertex
+         WholeArrayIn<IdType> inverseIndex,   // (input) permutation of index
+         WholeArrayOut<IdType> edgeNear,      // (output) low end of edges
+         WholeArrayOut<IdType> edgeFar,       // (output) high end of edges
+         WholeArrayOut<IdType> activeEdges);  // (output) active edge list
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12);
+  using InputDomain = _1;
+
+  // operator() routine that executes the loop
+  template <typename InFieldPortalType, typename OutFieldPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& vertex,
+                            const vtkm::Pair<vtkm::Id, vtkm::Id>& outDegFirstEdge,
+                            const vtkm::Id& valueIndex,
+                            const InFieldPortalType& firstCell,
+                            const InFieldPortalType& nIncidentCells,
+                            const InFieldPortalType& linkComponent,
+                            const InFieldPortalType& linkNeighbour,
+                            const InFieldPortalType& arcArray,
+                            const InFieldPortalType& inverseIndex,
+                            const OutFieldPortalType& edgeNear,
+                            const OutFieldPortalType& edgeFar,
+                            const OutFieldPortalType& activeEdges) const
+  {
+    vtkm::Id outdegree = outDegFirstEdge.first;
+    vtkm::Id edgeID = outDegFirstEdge.second;
+    // skip local extrema
+    if (outdegree == 0)
+      return;
+
+    vtkm::Id startSlot = firstCell.Get(valueIndex);
+    vtkm::Id endSlot = startSlot + nIncidentCells.Get(valueIndex);
+
+    for (vtkm::Id slot = startSlot; slot < endSlot; slot++)
+    {
+      // only the first slot of each component is considered
+      if (linkComponent.Get(slot) != slot)
+        continue;
+      vtkm::Id farEnd = arcArray.Get(linkNeighbour.Get(slot));
+
+      // and only if no earlier component led to the same extremum
+      bool isNew = true;
+      for (vtkm::Id prevSlot = startSlot; isNew && (prevSlot < slot); prevSlot++)
+      {
+        if ((linkComponent.Get(prevSlot) == prevSlot) &&
+            (arcArray.Get(linkNeighbour.Get(prevSlot)) == farEnd))
+          isNew = false;
+      }
+      if (!isNew)
+        continue;
+
+      // now set the near and far ends and save the edge itself
+      edgeNear.Set(edgeID, vertex);
+      edgeFar.Set(edgeID, inverseIndex.Get(farEnd));
+      activeEdges.Set(edgeID, edgeID);
+      edgeID++;
+    } // per component
+  }   // operator()
+
+}; // MeshExplicit_SaddleStarter
+}
+}
+}
+
+#endif
@@ -0,0 +1,316 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+//  This code is based on the algorithm presented in the paper:
+//  “Parallel Peak Pruning for Scalable SMP Contour Tree Computation.”
+//  Hamish Carr, Gunther Weber, Christopher Sewell, and James Ahrens.
+//  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
+//  (LDAV), October 2016, Baltimore, Maryland.
+
+//=======================================================================================
+//
+// COMMENTS:
+//
+//	The counterpart of Mesh2D_DEM_Triangulation and Mesh3D_DEM_Triangulation for the
+//	points of an explicit cell set, for example a tetrahedral mesh. It offers the same
+//	SetStarts and SetSaddleStarts, so the merge trees, chain graphs and contour tree
+//	are built the same way as for the regular meshes.
+//
+//	The neighbourhood of a vertex is given by the cells incident to it, taken from the
+//	point to cell connectivity of the cell set. In place of the case tables, the
+//	components of the upper (or lower) link of each vertex are computed from these
+//	cells, with the cells treated as simplices (see MeshExplicit_VertexStarter).
+//
+//	The mesh is expected to be connected, as for any contour tree. CountComponents
+//	labels the connected components with MeshExplicit_ComponentLabeller, so that
+//	callers can reject other meshes.
+//
+//=======================================================================================
+
+#ifndef vtkm_worklet_contourtree_mesh_explicit_triangulation_h
+#define vtkm_worklet_contourtree_mesh_explicit_triangulation_h
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCast.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleZip.h>
+#include <vtkm/worklet/DispatcherMapField.h>
+
+#include <vtkm/worklet/contourtree/ChainGraph.h>
+#include <vtkm/worklet/contourtree/MeshExplicit_ComponentLabeller.h>
+#include <vtkm/worklet/contourtree/MeshExplicit_SaddleStarter.h>
+#include <vtkm/worklet/contourtree/MeshExplicit_VertexOutdegreeStarter.h>
+#include <vtkm/worklet/contourtree/MeshExplicit_VertexStarter.h>
+#include <vtkm/worklet/contourtree/PrintVectors.h>
+#include <vtkm/worklet/contourtree/Types.h>
+
+#include <utility>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace contourtree
+{
+
+template <typename T, typename StorageType, typename DeviceAdapter>
+class MeshExplicit_Triangulation
+{
+public:
+  using DeviceAlgorithm = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+  // original data array
+  const vtkm::cont::ArrayHandle<T, StorageType>& values;
+
+  // size of the mesh
+  vtkm::Id nVertices, nLogSteps;
+
+  // points of each cell
+  vtkm::cont::ArrayHandle<vtkm::Id> cellFirstPoint;
+  vtkm::cont::ArrayHandle<vtkm::Id> cellNPoints;
+  vtkm::cont::ArrayHandle<vtkm::Id> cellPoints;
+
+  // cells incident to each vertex, one slot per cell
+  vtkm::cont::ArrayHandle<vtkm::Id> firstCell;
+  vtkm::cont::ArrayHandle<vtkm::Id> nIncidentCells;
+  vtkm::cont::ArrayHandle<vtkm::Id> incidentCells;
+
+  // link components of each vertex, one entry per slot
+  vtkm::cont::ArrayHandle<vtkm::Id> linkComponent;
+  vtkm::cont::ArrayHandle<vtkm::Id> linkNeighbour;
+
+  // constructor
+  template <typename CellSetType>
+  MeshExplicit_Triangulation(const vtkm::cont::ArrayHandle<T, StorageType>& Values,
+                             const CellSetType& cellSet);
+
+  // number of connected components of the mesh, isolated points included
+  vtkm::Id CountComponents();
+
+  // sets all vertices to point along an outgoing edge (except extrema)
+  void SetStarts(vtkm::cont::ArrayHandle<vtkm::Id>& chains, bool ascending);
+
+  // sets outgoing paths for saddles
+  void SetSaddleStarts(ChainGraph<T, StorageType, DeviceAdapter>& mergeGraph, bool ascending);
+};
+
+// creates input mesh
+template <typename T, typename StorageType, typename DeviceAdapter>
+template <typename CellSetType>
+MeshExplicit_Triangulation<T, StorageType, DeviceAdapter>::MeshExplicit_Triangulation(
+  const vtkm::cont::ArrayHandle<T, StorageType>& Values,
+  const CellSetType& cellSet)
+  : values(Values)
+{
+  nVertices = values.GetNumberOfValues();
+
+  // compute the number of log-jumping steps (i.e. lg_2 (nVertices))
+  nLogSteps = 1;
+  for (vtkm::Id shifter = nVertices; shifter > 0; shifter >>= 1)
+    nLogSteps++;
+
+  vtkm::TopologyElementTagPoint point;
+  vtkm::TopologyElementTagCell cell;
+
+  DeviceAlgorithm::Copy(cellSet.GetIndexOffsetArray(point, cell), cellFirstPoint);
+  DeviceAlgorithm::Copy(
+    vtkm::cont::make_ArrayHandleCast(cellSet.GetNumIndicesArray(point, cell), vtkm::Id()),
+    cellNPoints);
+  DeviceAlgorithm::Copy(cellSet.GetConnectivityArray(point, cell), cellPoints);
+
+  // the point to cell connectivity is built by the cell set on first use
+  DeviceAlgorithm::Copy(cellSet.GetIndexOffsetArray(cell, point), firstCell);
+  DeviceAlgorithm::Copy(
+    vtkm::cont::make_ArrayHandleCast(cellSet.GetNumIndicesArray(cell, point), vtkm::Id()),
+    nIncidentCells);
+  DeviceAlgorithm::Copy(cellSet.GetConnectivityArray(cell, point), incidentCells);
+}
+
+// counts the connected components of the mesh
+template <typename T, typename StorageType, typename DeviceAdapter>
+vtkm::Id MeshExplicit_Triangulation<T, StorageType, DeviceAdapter>::CountComponents()
+{
+  // every vertex starts in a component of its own
+  vtkm::cont::ArrayHandle<vtkm::Id> label, newLabel, cellLabel, changed;
+  vtkm::cont::ArrayHandleIndex vertexIndexArray(nVertices);
+  DeviceAlgorithm::Copy(vertexIndexArray, label);
+
+  vtkm::worklet::DispatcherMapField<MeshExplicit_CellLabeller, DeviceAdapter>
+    cellLabellerDispatcher;
+  vtkm::worklet::DispatcherMapField<MeshExplicit_VertexLabeller, DeviceAdapter>
+    vertexLabellerDispatcher;
+
+  // propagate the smallest label until nothing changes
+  vtkm::Id nChanged = 1;
+  while (nChanged > 0)
+  {
+    cellLabellerDispatcher.Invoke(cellFirstPoint, // input
+                                  cellNPoints,    // input
+                                  cellPoints,     // input (whole array)
+                                  label,          // input (whole array)
+                                  cellLabel);     // output
+    vertexLabellerDispatcher.Invoke(vertexIndexArray, // input
+                                    firstCell,        // input
+                                    nIncidentCells,   // input
+                                    incidentCells,    // input (whole array)
+                                    cellLabel,        // input (whole array)
+                                    label,            // input (whole array)
+                                    newLabel,         // output
+                                    changed);         // output
+    nChanged = DeviceAlgorithm::Reduce(changed, vtkm::Id(0));
+    std::swap(label, newLabel);
+  }
+
+  // each component is left with the label of its smallest vertex
+  DeviceAlgorithm::Sort(label);
+  DeviceAlgorithm::Unique(label);
+  return label.GetNumberOfValues();
+} // CountComponents()
+
+// sets outgoing paths for vertices
+template <typename T, typename StorageType, typename DeviceAdapter>
+void MeshExplicit_Triangulation<T, StorageType, DeviceAdapter>::SetStarts(
+  vtkm::cont::ArrayHandle<vtkm::Id>& chains,
+  bool ascending)
+{
+  // create the link components
+  linkComponent.Allocate(incidentCells.GetNumberOfValues());
+  linkNeighbour.Allocate(incidentCells.GetNumberOfValues());
+
+  // For each vertex set the next vertex in the chain
+  vtkm::cont::ArrayHandleIndex vertexIndexArray(nVertices);
+  MeshExplicit_VertexStarter<T> vertexStarter(ascending);
+  vtkm::worklet::DispatcherMapField<MeshExplicit_VertexStarter<T>, DeviceAdapter>
+    vertexStarterDispatcher(vertexStarter);
+
+  vertexStarterDispatcher.Invoke(vertexIndexArray, // input
+                                 firstCell,        // input
+                                 nIncidentCells,   // input
+                                 values,           // input (whole array)
+                                 incidentCells,    // input (whole array)
+                                 cellFirstPoint,   // input (whole array)
+                                 cellNPoints,      // input (whole array)
+                                 cellPoints,       // input (whole array)
+                                 chains,           // output
+                                 linkComponent,    // i/o (whole array)
+                                 linkNeighbour);   // output (whole array)
+} // SetStarts()
+
+// sets outgoing paths for saddles
+template <typename T, typename StorageType, typename DeviceAdapter>
+void MeshExplicit_Triangulation<T, StorageType, DeviceAdapter>::SetSaddleStarts(
+  ChainGraph<T, StorageType, DeviceAdapter>& mergeGraph,
+  bool ascending)
+{
+  (void)ascending; // the link components were set up for this direction by SetStarts
+
+  // we need a temporary inverse index to change vertex IDs
+  vtkm::cont::ArrayHandle<vtkm::Id> inverseIndex;
+  vtkm::cont::ArrayHandle<vtkm::Id> isCritical;
+  vtkm::cont::ArrayHandle<vtkm::Id> outdegree;
+  inverseIndex.Allocate(nVertices);
+  isCritical.Allocate(nVertices);
+  outdegree.Allocate(nVertices);
+
+  vtkm::cont::ArrayHandleIndex vertexIndexArray(nVertices);
+  MeshExplicit_VertexOutdegreeStarter vertexOutdegreeStarter;
+  vtkm::worklet::DispatcherMapField<MeshExplicit_VertexOutdegreeStarter, DeviceAdapter>
+    vertexOutdegreeStarterDispatcher(vertexOutdegreeStarter);
+
+  vertexOutdegreeStarterDispatcher.Invoke(firstCell,           // input
+                                          nIncidentCells,      // input
+                                          linkComponent,       // input (whole array)
+                                          linkNeighbour,       // input (whole array)
+                                          mergeGraph.arcArray, // input (whole array)
+                                          outdegree,           // output
+                                          isCritical);         // output
+
+  DeviceAlgorithm::ScanExclusive(isCritical, inverseIndex);
+
+  // now we can compute how many critical points we carry forward
+  vtkm::Id nCriticalPoints = inverseIndex.GetPortalConstControl().Get(nVertices - 1) +
+    isCritical.GetPortalConstControl().Get(nVertices - 1);
+
+  // allocate space for the join graph vertex arrays
+  mergeGraph.AllocateVertexArrays(nCriticalPoints);
+
+  // compact the set of vertex indices to critical ones only
+  DeviceAlgorithm::CopyIf(vertexIndexArray, isCritical, mergeGraph.valueIndex);
+
+  // we initialise the prunesTo array to "NONE"
+  vtkm::cont::ArrayHandleConstant<vtkm::Id> notAssigned(NO_VERTEX_ASSIGNED, nCriticalPoints);
+  DeviceAlgorithm::Copy(notAssigned, mergeGraph.prunesTo);
+
+  // copy the outdegree from our temporary array
+  // : mergeGraph.outdegree[vID] <= outdegree[mergeGraph.valueIndex[vID]]
+  DeviceAlgorithm::CopyIf(outdegree, isCritical, mergeGraph.outdegree);
+
+  // copy the chain maximum from arcArray
+  // : mergeGraph.chainExtremum[vID] = inverseIndex[mergeGraph.arcArray[mergeGraph.valueIndex[vID]]]
+  using IdArrayType = vtkm::cont::ArrayHandle<vtkm::Id>;
+  using PermuteIndexType = vtkm::cont::ArrayHandlePermutation<IdArrayType, IdArrayType>;
+
+  vtkm::cont::ArrayHandle<vtkm::Id> tArray;
+  tArray.Allocate(nCriticalPoints);
+  DeviceAlgorithm::CopyIf(mergeGraph.arcArray, isCritical, tArray);
+  DeviceAlgorithm::Copy(PermuteIndexType(tArray, inverseIndex), mergeGraph.chainExtremum);
+
+  // and set up the active vertices - initially to identity
+  vtkm::cont::ArrayHandleIndex criticalVertsIndexArray(nCriticalPoints);
+  DeviceAlgorithm::Copy(criticalVertsIndexArray, mergeGraph.activeVertices);
+
+  // now we need to compute the firstEdge array from the outdegrees
+  DeviceAlgorithm::ScanExclusive(mergeGraph.outdegree, mergeGraph.firstEdge);
+
+  vtkm::Id nCriticalEdges = mergeGraph.firstEdge.GetPortalConstControl().Get(nCriticalPoints - 1) +
+    mergeGraph.outdegree.GetPortalConstControl().Get(nCriticalPoints - 1);
+
+  // now we allocate the edge arrays
+  mergeGraph.AllocateEdgeArrays(nCriticalEdges);
+
+  // and we have to set them, so we go back to the vertices
+  MeshExplicit_SaddleStarter saddleStarter;
+  vtkm::worklet::DispatcherMapField<MeshExplicit_SaddleStarter, DeviceAdapter>
+    saddleStarterDispatcher(saddleStarter);
+
+  vtkm::cont::ArrayHandleZip<vtkm::cont::ArrayHandle<vtkm::Id>, vtkm::cont::ArrayHandle<vtkm::Id>>
+    outDegFirstEdge = vtkm::cont::make_ArrayHandleZip(mergeGraph.outdegree, mergeGraph.firstEdge);
+
+  saddleStarterDispatcher.Invoke(criticalVertsIndexArray, // input
+                                 outDegFirstEdge,         // input (pair)
+                                 mergeGraph.valueIndex,   // input
+                                 firstCell,               // input (whole array)
+                                 nIncidentCells,          // input (whole array)
+                                 linkComponent,           // input (whole array)
+                                 linkNeighbour,           // input (whole array)
+                                 mergeGraph.arcArray,     // input (whole array)
+                                 inverseIndex,            // input (whole array)
+                                 mergeGraph.edgeNear,     // output (whole array)
+                                 mergeGraph.edgeFar,      // output (whole array)
+                                 mergeGraph.activeEdges); // output (whole array)
+
+  // finally, allocate and initialise the edgeSorter array
+  DeviceAlgorithm::Copy(mergeGraph.activeEdges, mergeGraph.edgeSorter);
+} // SetSaddleStarts()
+}
+}
+}
+
+#endif
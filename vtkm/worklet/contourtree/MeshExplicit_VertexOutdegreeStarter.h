@@ -0,0 +1,109 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+//  This code is based on the algorithm presented in the paper:
+//  “Parallel Peak Pruning for Scalable SMP Contour Tree Computation.”
+//  Hamish Carr, Gunther Weber, Christopher Sewell, and James Ahrens.
+//  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
+//  (LDAV), October 2016, Baltimore, Maryland.
+
+//=======================================================================================
+//
+// COMMENTS:
+//
+// The explicit mesh counterpart of Mesh3D_DEM_VertexOutdegreeStarter. The link components
+// set up by MeshExplicit_VertexStarter take the place of the case table: each component
+// is represented by its first slot, and the outdegree counts the distinct chain extrema
+// reached from the components, so that components leading to the same extremum are
+// treated as one, as for the regular meshes.
+//
+//=======================================================================================
+
+#ifndef vtkm_worklet_contourtree_mesh_explicit_vertex_outdegree_starter_h
+#define vtkm_worklet_contourtree_mesh_explicit_vertex_outdegree_starter_h
+
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/contourtree/Types.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace contourtree
+{
+
+// Worklet for computing the outdegree of each vertex
+class MeshExplicit_VertexOutdegreeStarter : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<IdType> firstCell,            // (input) first slot
+                                FieldIn<IdType> nIncidentCells,       // (input) number of slots
+                                WholeArrayIn<IdType> linkComponent,   // (input) link components
+                                WholeArrayIn<IdType> linkNeighbour,   // (input) link points
+                                WholeArrayIn<IdType> arcArray,        // (input) chain extrema
+                                FieldOut<IdType> outdegree,           // (output) outdegree
+                                FieldOut<IdType> isCritical);         // (output) whether critical
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+  using InputDomain = _1;
+
+  template <typename InFieldPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& firstCell,
+                            const vtkm::Id& nIncidentCells,
+                            const InFieldPortalType& linkComponent,
+                            const InFieldPortalType& linkNeighbour,
+                            const InFieldPortalType& arcArray,
+                            vtkm::Id& outdegree,
+                            vtkm::Id& isCritical) const
+  {
+    vtkm::Id outDegree = 0;
+    vtkm::Id endSlot = firstCell + nIncidentCells;
+
+    for (vtkm::Id slot = firstCell; slot < endSlot; slot++)
+    {
+      // only the first slot of each component is considered
+      if (linkComponent.Get(slot) != slot)
+        continue;
+      vtkm::Id farEnd = arcArray.Get(linkNeighbour.Get(slot));
+
+      // and only if no earlier component led to the same extremum
+      bool isNew = true;
+      for (vtkm::Id prevSlot = firstCell; isNew && (prevSlot < slot); prevSlot++)
+      {
+        if ((linkComponent.Get(prevSlot) == prevSlot) &&
+            (arcArray.Get(linkNeighbour.Get(prevSlot)) == farEnd))
+          isNew = false;
+      }
+      if (isNew)
+        outDegree++;
+    }
+
+    // now store the outDegree
+    outdegree = outDegree;
+
+    // and set the initial inverse index to a flag
+    isCritical = (outDegree != 1) ? 1 : 0;
+  }
+}; // MeshExplicit_VertexOutdegreeStarter
+
+} // namespace contourtree
+} // namespace worklet
+} // namespace vtkm
+
+#endif
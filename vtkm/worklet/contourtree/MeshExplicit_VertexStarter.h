@@ -0,0 +1,208 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+//  This code is based on the algorithm presented in the paper:
+//  “Parallel Peak Pruning for Scalable SMP Contour Tree Computation.”
+//  Hamish Carr, Gunther Weber, Christopher Sewell, and James Ahrens.
+//  Proceedings of the IEEE Symposium on Large Data Analysis and Visualization
+//  (LDAV), October 2016, Baltimore, Maryland.
+
+//=======================================================================================
+//
+// COMMENTS:
+//
+// The explicit mesh counterpart of Mesh3D_DEM_VertexStarter. There is no case table for
+// an arbitrary neighbourhood, so instead of a neighbourhood mask each vertex records the
+// components of its upper (or lower) link, with one entry per incident cell:
+//
+//   linkNeighbour[slot]  - a point of the cell beyond the vertex, or NO_VERTEX_ASSIGNED
+//   linkComponent[slot]  - the first slot of the same link component, or NO_VERTEX_ASSIGNED
+//
+// where the slots of a vertex are the positions of its incident cells in the point to cell
+// connectivity. Cells are treated as simplices: the points of a cell beyond the vertex are
+// all in one link component, and two cells are in the same component if they share such a
+// point. This is exact for triangles and tetrahedra.
+//
+// The I/O vectors are only read and written in the slots of the vertex itself, so the
+// writes of different vertices are independent.
+//
+//=======================================================================================
+
+#ifndef vtkm_worklet_contourtree_mesh_explicit_vertex_starter_h
+#define vtkm_worklet_contourtree_mesh_explicit_vertex_starter_h
+
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/contourtree/Types.h>
+#include <vtkm/worklet/contourtree/VertexValueComparator.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace contourtree
+{
+
+// Worklet for setting initial chain maximum value and the link components
+template <typename T>
+class MeshExplicit_VertexStarter : public vtkm::worklet::WorkletMapField
+{
+public:
+  struct TagType : vtkm::ListTagBase<T>
+  {
+  };
+
+  using ControlSignature = void(FieldIn<IdType> vertex,              // (input) index of vertex
+                                FieldIn<IdType> firstCell,           // (input) first slot
+                                FieldIn<IdType> nIncidentCells,      // (input) number of slots
+                                WholeArrayIn<TagType> values,        // (input) values within mesh
+                                WholeArrayIn<IdType> incidentCells,  // (input) cells of slots
+                                WholeArrayIn<IdType> cellFirstPoint, // (input) offsets of cells
+                                WholeArrayIn<IdType> cellNPoints,    // (input) sizes of cells
+                                WholeArrayIn<IdType> cellPoints,     // (input) points of cells
+                                FieldOut<IdType> chain,              // (output) modify the chains
+                                WholeArrayInOut<IdType> linkComponent, // (i/o) link components
+                                WholeArrayOut<IdType> linkNeighbour);  // (output) link points
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11);
+  using InputDomain = _1;
+
+  bool ascending; // ascending or descending (join or split tree)
+
+  // Constructor
+  VTKM_EXEC_CONT
+  MeshExplicit_VertexStarter(bool Ascending)
+    : ascending(Ascending)
+  {
+  }
+
+  // Locate the next vertex in direction indicated and the components of the link
+  template <typename InFieldPortalType,
+            typename InIdPortalType,
+            typename InOutIdPortalType,
+            typename OutIdPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& vertex,
+                            const vtkm::Id& firstCell,
+                            const vtkm::Id& nIncidentCells,
+                            const InFieldPortalType& values,
+                            const InIdPortalType& incidentCells,
+                            const InIdPortalType& cellFirstPoint,
+                            const InIdPortalType& cellNPoints,
+                            const InIdPortalType& cellPoints,
+                            vtkm::Id& chain,
+                            const InOutIdPortalType& linkComponent,
+                            const OutIdPortalType& linkNeighbour) const
+  {
+    VertexValueComparator<InFieldPortalType> lessThan(values);
+    vtkm::Id destination = vertex;
+
+    // find the steepest neighbour and a neighbour beyond the vertex in each cell
+    for (vtkm::Id cellNo = 0; cellNo < nIncidentCells; cellNo++)
+    {
+      vtkm::Id slot = firstCell + cellNo;
+      vtkm::Id cell = incidentCells.Get(slot);
+      vtkm::Id firstPoint = cellFirstPoint.Get(cell);
+      vtkm::Id neighbour = NO_VERTEX_ASSIGNED;
+
+      for (vtkm::Id pointNo = 0; pointNo < cellNPoints.Get(cell); pointNo++)
+      {
+        vtkm::Id nbr = cellPoints.Get(firstPoint + pointNo);
+        if ((nbr == vertex) || lessThan(vertex, nbr, ascending))
+          continue;
+        neighbour = nbr;
+        if (!lessThan(destination, nbr, ascending))
+          destination = nbr;
+      }
+
+      linkNeighbour.Set(slot, neighbour);
+      linkComponent.Set(slot, (neighbour == NO_VERTEX_ASSIGNED) ? NO_VERTEX_ASSIGNED : slot);
+    }
+    chain = destination;
+
+    // join the cells that share a point beyond the vertex
+    for (vtkm::Id cellNo = 1; cellNo < nIncidentCells; cellNo++)
+    {
+      vtkm::Id slot = firstCell + cellNo;
+      if (linkNeighbour.Get(slot) == NO_VERTEX_ASSIGNED)
+        continue;
+      vtkm::Id cell = incidentCells.Get(slot);
+      vtkm::Id firstPoint = cellFirstPoint.Get(cell);
+
+      for (vtkm::Id pointNo = 0; pointNo < cellNPoints.Get(cell); pointNo++)
+      {
+        vtkm::Id nbr = cellPoints.Get(firstPoint + pointNo);
+        if ((nbr == vertex) || lessThan(vertex, nbr, ascending))
+          continue;
+
+        for (vtkm::Id otherSlot = firstCell; otherSlot < slot; otherSlot++)
+        {
+          if (linkNeighbour.Get(otherSlot) == NO_VERTEX_ASSIGNED)
+            continue;
+          vtkm::Id otherCell = incidentCells.Get(otherSlot);
+          if (!CellContains(otherCell, nbr, cellFirstPoint, cellNPoints, cellPoints))
+            continue;
+
+          // union by the lower slot, so that each component ends at its first slot
+          vtkm::Id root = FindRoot(slot, linkComponent);
+          vtkm::Id otherRoot = FindRoot(otherSlot, linkComponent);
+          if (root < otherRoot)
+            linkComponent.Set(otherRoot, root);
+          else if (otherRoot < root)
+            linkComponent.Set(root, otherRoot);
+        }
+      }
+    }
+
+    // and point every slot directly at the first slot of its component
+    for (vtkm::Id slot = firstCell; slot < firstCell + nIncidentCells; slot++)
+    {
+      if (linkNeighbour.Get(slot) != NO_VERTEX_ASSIGNED)
+        linkComponent.Set(slot, FindRoot(slot, linkComponent));
+    }
+  } // operator()
+
+private:
+  template <typename InOutIdPortalType>
+  VTKM_EXEC vtkm::Id FindRoot(vtkm::Id slot, const InOutIdPortalType& linkComponent) const
+  {
+    while (linkComponent.Get(slot) != slot)
+      slot = linkComponent.Get(slot);
+    return slot;
+  }
+
+  template <typename InIdPortalType>
+  VTKM_EXEC bool CellContains(vtkm::Id cell,
+                              vtkm::Id point,
+                              const InIdPortalType& cellFirstPoint,
+                              const InIdPortalType& cellNPoints,
+                              const InIdPortalType& cellPoints) const
+  {
+    vtkm::Id firstPoint = cellFirstPoint.Get(cell);
+    for (vtkm::Id pointNo = 0; pointNo < cellNPoints.Get(cell); pointNo++)
+    {
+      if (cellPoints.Get(firstPoint + pointNo) == point)
+        return true;
+    }
+    return false;
+  }
+}; // MeshExplicit_VertexStarter
+}
+}
+}
+
+#endif
@@ -0,0 +1,81 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#ifndef vtkm_worklet_contourtree_shared_vertex_counter_h
+#define vtkm_worklet_contourtree_shared_vertex_counter_h
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace contourtree
+{
+
+// Worklet counting the number of blocks of a decomposed volume that contain a vertex
+// of one block. Neighbouring blocks are expected to share the points on their common
+// faces, so a vertex on such a face is shared by 2 blocks, on an edge by 4, and on a
+// corner by 8. Faces on the boundary of the whole volume are not shared.
+class SharedVertexCounter : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<IdType> vertex,      // (input) local index of vertex
+                                FieldOut<IdType> nSharing);  // (output) number of blocks
+  using ExecutionSignature = _2(_1);
+  using InputDomain = _1;
+
+  vtkm::Id3 blockDims;   // (input) point dimensions of the block
+  vtkm::Id3 blockOrigin; // (input) index of the first point of the block in the volume
+  vtkm::Id3 globalDims;  // (input) point dimensions of the whole volume
+
+  // Constructor
+  VTKM_EXEC_CONT
+  SharedVertexCounter(const vtkm::Id3& BlockDims,
+                      const vtkm::Id3& BlockOrigin,
+                      const vtkm::Id3& GlobalDims)
+    : blockDims(BlockDims)
+    , blockOrigin(BlockOrigin)
+    , globalDims(GlobalDims)
+  {
+  }
+
+  VTKM_EXEC vtkm::Id operator()(const vtkm::Id& vertex) const
+  {
+    vtkm::Id3 ijk(vertex % blockDims[0],
+                  (vertex / blockDims[0]) % blockDims[1],
+                  vertex / (blockDims[0] * blockDims[1]));
+
+    vtkm::Id nSharing = 1;
+    for (vtkm::IdComponent dim = 0; dim < 3; dim++)
+    {
+      if (ijk[dim] == 0 && blockOrigin[dim] > 0)
+        nSharing *= 2;
+      if (ijk[dim] == blockDims[dim] - 1 && blockOrigin[dim] + ijk[dim] < globalDims[dim] - 1)
+        nSharing *= 2;
+    }
+    return nSharing;
+  }
+}; // SharedVertexCounter
+}
+}
+}
+
+#endif
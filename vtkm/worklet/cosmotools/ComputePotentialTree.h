@@ -0,0 +1,249 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+//  Copyright (c) 2016, Los Alamos National Security, LLC
+//  All rights reserved.
+//
+//  Copyright 2016. Los Alamos National Security, LLC.
+//  This software was produced under U.S. Government contract DE-AC52-06NA25396
+//  for Los Alamos National Laboratory (LANL), which is operated by
+//  Los Alamos National Security, LLC for the U.S. Department of Energy.
+//  The U.S. Government has rights to use, reproduce, and distribute this
+//  software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY, LLC
+//  MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY FOR THE
+//  USE OF THIS SOFTWARE.  If software is modified to produce derivative works,
+//  such modified software should be clearly marked, so as not to confuse it
+//  with the version available from LANL.
+//
+//  Additionally, redistribution and use in source and binary forms, with or
+//  without modification, are permitted provided that the following conditions
+//  are met:
+//
+//  1. Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//  3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+//     National Laboratory, LANL, the U.S. Government, nor the names of its
+//     contributors may be used to endorse or promote products derived from
+//     this software without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+//  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+//  BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS ALAMOS
+//  NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+//  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+//  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+//  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+//  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef vtkm_worklet_cosmotools_compute_potential_tree_h
+#define vtkm_worklet_cosmotools_compute_potential_tree_h
+
+#include <vtkm/Assert.h>
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace cosmotools
+{
+
+// Most finest bins along each axis of the bin tree, 2^MAX_TREE_BIN_BITS, which bounds
+// the number of levels of the tree
+static const vtkm::IdComponent MAX_TREE_BIN_BITS = 20;
+static const vtkm::Id MAX_TREE_BINS = vtkm::Id(1) << MAX_TREE_BIN_BITS;
+static const vtkm::IdComponent MAX_TREE_LEVELS = MAX_TREE_BIN_BITS + 1;
+
+// Largest number of bins waiting to be visited while walking the bin tree, enough
+// for 7 unvisited siblings on each level but the last one, which may hold all 8
+static const vtkm::IdComponent MAX_TREE_STACK = 7 * MAX_TREE_LEVELS + 1;
+
+// Average number of particles wanted in the finest bins of the bin tree
+static const vtkm::Id TREE_LEAF_PARTICLES = 8;
+
+// Most particles wanted in any finest bin, whose particles are summed one by one, and
+// the number of times the finest bins may be halved to get there
+static const vtkm::Id TREE_LEAF_MAX_PARTICLES = 32;
+static const vtkm::IdComponent TREE_LEAF_REFINEMENTS = 10;
+
+// Worklet for computing the potential for a particle in one halo with a tree code.
+// Particles are sorted by bin, and the bins of all levels of the bin tree are stored
+// one level after the other, from the finest bins of size binSize up to a single bin
+// holding the whole halo. Each bin stores its number of particles and the sum of their
+// positions, and a range which is the range of its particles for the finest bins and
+// the range of its children within the level below for all others. Starting from the
+// top, a bin that does not contain the particle and is small enough compared to its
+// distance, size < theta * distance, adds the potential of its particles as if they
+// were all at their center of mass. Other bins are opened, down to the finest bins
+// whose particles are added one by one. With theta = 0 every bin is opened and the
+// potential is the same as the one of ComputePotentialNxN.
+template <typename T>
+class ComputePotentialTree : public vtkm::worklet::WorkletMapField
+{
+public:
+  struct TagType : vtkm::ListTagBase<T>
+  {
+  };
+  struct Vec4TagType : vtkm::ListTagBase<vtkm::Vec<T, 4>>
+  {
+  };
+
+  using ControlSignature =
+    void(FieldIn<IdType> partIndx,                // (input) index of particle in bin order
+         FieldIn<IdType> binId,                   // (input) finest bin of particle
+         WholeArrayIn<TagType> xLoc,              // (input) x location in bin order
+         WholeArrayIn<TagType> yLoc,              // (input) y location in bin order
+         WholeArrayIn<TagType> zLoc,              // (input) z location in bin order
+         WholeArrayIn<IdType> treeBinId,          // (input) bin Id of bins of all levels
+         WholeArrayIn<Vec4TagType> treeBinMoment, // (input) count and position sums
+         WholeArrayIn<Id2Type> treeBinRange,      // (input) first and number of contents
+         WholeArrayIn<IdType> levelOffset,        // (input) first bin of each level
+         FieldOut<TagType> potential);            // (output) potential
+  using ExecutionSignature = _10(_1, _2, _3, _4, _5, _6, _7, _8, _9);
+  using InputDomain = _1;
+
+  vtkm::Id numBinsX, numBinsY, numBinsZ; // Number of finest bins each dimension
+  vtkm::Id numLevels;                    // Number of levels in bin tree
+  T binSize;                             // Largest side of the finest bins
+  T mass;                                // Particle mass
+  T theta;                               // Opening angle
+
+  // Constructor
+  VTKM_EXEC_CONT
+  ComputePotentialTree(vtkm::Id NX,
+                       vtkm::Id NY,
+                       vtkm::Id NZ,
+                       vtkm::Id NumLevels,
+                       T BinSize,
+                       T Mass,
+                       T Theta)
+    : numBinsX(NX)
+    , numBinsY(NY)
+    , numBinsZ(NZ)
+    , numLevels(NumLevels)
+    , binSize(BinSize)
+    , mass(Mass)
+    , theta(Theta)
+  {
+  }
+
+  template <typename InFieldPortalType,
+            typename InIdPortalType,
+            typename InVec4PortalType,
+            typename InId2PortalType>
+  VTKM_EXEC T operator()(const vtkm::Id& i,
+                         const vtkm::Id& binId,
+                         const InFieldPortalType& xLoc,
+                         const InFieldPortalType& yLoc,
+                         const InFieldPortalType& zLoc,
+                         const InIdPortalType& treeBinId,
+                         const InVec4PortalType& treeBinMoment,
+                         const InId2PortalType& treeBinRange,
+                         const InIdPortalType& levelOffset) const
+  {
+    T xLoc_i = xLoc.Get(i);
+    T yLoc_i = yLoc.Get(i);
+    T zLoc_i = zLoc.Get(i);
+    vtkm::Id ibinX = binId % numBinsX;
+    vtkm::Id ibinY = (binId / numBinsX) % numBinsY;
+    vtkm::Id ibinZ = binId / (numBinsX * numBinsY);
+
+    vtkm::Id stackLevel[MAX_TREE_STACK];
+    vtkm::Id stackBin[MAX_TREE_STACK];
+    vtkm::IdComponent stackSize = 1;
+    stackLevel[0] = numLevels - 1;
+    stackBin[0] = levelOffset.Get(numLevels - 1);
+
+    T potential = 0.0f;
+    while (stackSize > 0)
+    {
+      stackSize--;
+      vtkm::Id level = stackLevel[stackSize];
+      vtkm::Id bin = stackBin[stackSize];
+
+      // Position of the bin within the bins of its level
+      vtkm::Id numX = ((numBinsX - 1) >> level) + 1;
+      vtkm::Id numY = ((numBinsY - 1) >> level) + 1;
+      vtkm::Id id = treeBinId.Get(bin);
+      vtkm::Id binX = id % numX;
+      vtkm::Id binY = (id / numX) % numY;
+      vtkm::Id binZ = id / (numX * numY);
+      bool ownBin =
+        ((ibinX >> level) == binX) && ((ibinY >> level) == binY) && ((ibinZ >> level) == binZ);
+
+      // Far enough bins act as one particle at their center of mass
+      if (!ownBin)
+      {
+        vtkm::Vec<T, 4> moment = treeBinMoment.Get(bin);
+        T xDist = xLoc_i - moment[1] / moment[0];
+        T yDist = yLoc_i - moment[2] / moment[0];
+        T zDist = zLoc_i - moment[3] / moment[0];
+        T r = vtkm::Sqrt((xDist * xDist) + (yDist * yDist) + (zDist * zDist));
+        T size = binSize * static_cast<T>(vtkm::Id(1) << level);
+        if (size < theta * r)
+        {
+          potential -= (moment[0] * mass) / r;
+          continue;
+        }
+      }
+
+      // The finest bins add their particles one by one
+      vtkm::Id2 range = treeBinRange.Get(bin);
+      if (level == 0)
+      {
+        for (vtkm::Id j = range[0]; j < range[0] + range[1]; j++)
+        {
+          T xDist = xLoc_i - xLoc.Get(j);
+          T yDist = yLoc_i - yLoc.Get(j);
+          T zDist = zLoc_i - zLoc.Get(j);
+          T r = vtkm::Sqrt((xDist * xDist) + (yDist * yDist) + (zDist * zDist));
+          if ((i != j) && (fabs(r) > 0.00000000001f))
+          {
+            potential -= mass / r;
+          }
+        }
+        continue;
+      }
+
+      // Otherwise open the bin and visit its children
+      vtkm::Id childFirst = levelOffset.Get(level - 1) + range[0];
+      for (vtkm::Id child = childFirst; child < childFirst + range[1]; child++)
+      {
+        VTKM_ASSERT(stackSize < MAX_TREE_STACK);
+        stackLevel[stackSize] = level - 1;
+        stackBin[stackSize] = child;
+        stackSize++;
+      }
+    }
+    return potential;
+  }
+}; // ComputePotentialTree
+}
+}
+}
+
+#endif
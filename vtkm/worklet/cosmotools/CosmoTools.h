@@ -65,6 +65,7 @@
 #include <vtkm/worklet/cosmotools/ComputeBinRange.h>
 #include <vtkm/worklet/cosmotools/ComputeBins.h>
 #include <vtkm/worklet/cosmotools/ComputeNeighborBins.h>
+#include <vtkm/worklet/cosmotools/ComputeParentBins.h>
 #include <vtkm/worklet/cosmotools/GraftParticles.h>
 #include <vtkm/worklet/cosmotools/IsStar.h>
 #include <vtkm/worklet/cosmotools/MarkActiveNeighbors.h>
@@ -77,15 +78,20 @@
 #include <vtkm/worklet/cosmotools/ComputePotentialNeighbors.h>
 #include <vtkm/worklet/cosmotools/ComputePotentialNxN.h>
 #include <vtkm/worklet/cosmotools/ComputePotentialOnCandidates.h>
+#include <vtkm/worklet/cosmotools/ComputePotentialTree.h>
 #include <vtkm/worklet/cosmotools/EqualsMinimumPotential.h>
+#include <vtkm/worklet/cosmotools/MinimumPotential.h>
 #include <vtkm/worklet/cosmotools/SetCandidateParticles.h>
 
 #include <vtkm/cont/ArrayHandleCompositeVector.h>
 #include <vtkm/cont/ArrayHandleConstant.h>
 #include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleExtractComponent.h>
 #include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
 #include <vtkm/cont/ArrayHandleReverse.h>
 #include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/cont/ArrayHandleZip.h>
 #include <vtkm/worklet/DispatcherMapField.h>
 #include <vtkm/worklet/ScatterCounting.h>
 
@@ -97,6 +103,7 @@
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <vector>
 
 //#define DEBUG_PRINT 1
 
@@ -193,6 +200,7 @@ public:
   vtkm::Id numBinsX;
   vtkm::Id numBinsY;
   vtkm::Id numBinsZ;
+  T binSize; // largest side of the bins of BinParticlesHalo
 
   // particle locations within domain
   using LocationType = typename vtkm::cont::ArrayHandle<T, StorageType>;
@@ -236,6 +244,9 @@ public:
   // MBP Center finding on single halo using MxN estimation
   vtkm::Id MBPCenterFinderMxN(T* mxnPotential);
 
+  // MBP Center finding on single halo using a tree code with opening angle theta
+  vtkm::Id MBPCenterFinderTree(T* treePotential, T theta);
+
   void BinParticlesHalo(vtkm::cont::ArrayHandle<vtkm::Id>& partId,
                         vtkm::cont::ArrayHandle<vtkm::Id>& binId,
                         vtkm::cont::ArrayHandle<vtkm::Id>& uniqueBins,
@@ -243,7 +254,8 @@ public:
                         vtkm::cont::ArrayHandle<vtkm::Id>& particleOffset,
                         vtkm::cont::ArrayHandle<vtkm::Id>& binX,
                         vtkm::cont::ArrayHandle<vtkm::Id>& binY,
-                        vtkm::cont::ArrayHandle<vtkm::Id>& binZ);
+                        vtkm::cont::ArrayHandle<vtkm::Id>& binZ,
+                        T binLen);
   void MBPCenterFindingByKey(vtkm::cont::ArrayHandle<vtkm::Id>& keyId,
                              vtkm::cont::ArrayHandle<vtkm::Id>& partId,
                              vtkm::cont::ArrayHandle<T>& minPotential);
@@ -266,6 +278,7 @@ CosmoTools<T, StorageType, DeviceAdapter>::CosmoTools(const vtkm::Id NParticles,
   , particleMass(mass)
   , minPartPerHalo(pmin)
   , linkLen(bb)
+  , binSize(bb)
   , xLoc(X)
   , yLoc(Y)
   , zLoc(Z)
@@ -287,6 +300,7 @@ CosmoTools<T, StorageType, DeviceAdapter>::CosmoTools(const vtkm::Id NParticles,
   , particleMass(mass)
   , minPartPerHalo(10)
   , linkLen(0.2f)
+  , binSize(0.2f)
   , xLoc(X)
   , yLoc(Y)
   , zLoc(Z)
@@ -92,7 +92,8 @@ vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderMxN(T* mxnPot
   vtkm::cont::ArrayHandle<vtkm::Id> binZ;
 
   // Bin all particles in the halo into bins of size linking length
-  BinParticlesHalo(partId, binId, uniqueBins, partPerBin, particleOffset, binX, binY, binZ);
+  BinParticlesHalo(
+    partId, binId, uniqueBins, partPerBin, particleOffset, binX, binY, binZ, linkLen);
 #ifdef DEBUG_PRINT
   DebugPrint("uniqueBins", uniqueBins);
   DebugPrint("partPerBin", partPerBin);
@@ -102,17 +103,18 @@ vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderMxN(T* mxnPot
   vtkm::cont::ArrayHandle<T> partPotential;
   MBPCenterFindingByKey(binId, partId, partPotential);
 
-  // Reduce by key to get the estimated minimum potential per bin within 27 neighbors
+  // Reduce by key to get the estimated minimum and maximum potential per bin within
+  // 27 neighbors, both in one pass
   vtkm::cont::ArrayHandle<vtkm::Id> tempId;
-  vtkm::cont::ArrayHandle<T> minPotential;
-  DeviceAlgorithm::ReduceByKey(binId, partPotential, tempId, minPotential, vtkm::Minimum());
-
-  // Reduce by key to get the estimated maximum potential per bin within 27 neighbors
-  vtkm::cont::ArrayHandle<T> maxPotential;
-  DeviceAlgorithm::ReduceByKey(binId, partPotential, tempId, maxPotential, vtkm::Maximum());
+  vtkm::cont::ArrayHandle<vtkm::Vec<T, 2>> minMaxPotential;
+  DeviceAlgorithm::ReduceByKey(binId,
+                               vtkm::cont::make_ArrayHandleCompositeVector(partPotential,
+                                                                           partPotential),
+                               tempId,
+                               minMaxPotential,
+                               vtkm::MinAndMax<T>());
 #ifdef DEBUG_PRINT
-  DebugPrint("minPotential", minPotential);
-  DebugPrint("maxPotential", maxPotential);
+  DebugPrint("minMaxPotential", minMaxPotential);
 #endif
 
   // Compute potentials estimate for a bin using all other bins
@@ -122,8 +124,10 @@ vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderMxN(T* mxnPot
   vtkm::cont::ArrayHandle<T> worstEstPotential;
 
   // Initialize each bin potential with the nxn for that bin
-  DeviceAlgorithm::Copy(minPotential, bestEstPotential);
-  DeviceAlgorithm::Copy(maxPotential, worstEstPotential);
+  DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandleExtractComponent(minMaxPotential, 0),
+                        bestEstPotential);
+  DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandleExtractComponent(minMaxPotential, 1),
+                        worstEstPotential);
 
   // Estimate only across the uniqueBins that contain particles
   ComputePotentialBin<T> computePotentialBin(uniqueBins.GetNumberOfValues(), particleMass, linkLen);
@@ -144,14 +148,15 @@ vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderMxN(T* mxnPot
   std::cout << "Number of worstEstPotential " << worstEstPotential.GetNumberOfValues() << std::endl;
 #endif
 
-  // Sort everything by the best estimated potential per bin
-  vtkm::cont::ArrayHandle<T> tempBest;
-  DeviceAlgorithm::Copy(bestEstPotential, tempBest);
-  DeviceAlgorithm::SortByKey(tempBest, worstEstPotential);
-
-  // Use the worst estimate for the first selected bin to compare to best of all others
+  // Use the worst estimate for the bin with the best estimated potential to compare to
+  // best of all others, found with one reduction rather than sorting all bins
   // Any bin that passes is a candidate for having the MBP
-  T cutoffPotential = worstEstPotential.GetPortalControl().Get(0);
+  vtkm::Pair<T, T> bestBin = DeviceAlgorithm::Reduce(
+    vtkm::cont::make_ArrayHandleZip(bestEstPotential, worstEstPotential),
+    vtkm::make_Pair(bestEstPotential.GetPortalConstControl().Get(0),
+                    worstEstPotential.GetPortalConstControl().Get(0)),
+    MinimumPotential<T, T>());
+  T cutoffPotential = bestBin.second;
 
   vtkm::cont::ArrayHandle<vtkm::Id> candidate;
   DeviceAlgorithm::Copy(vtkm::cont::ArrayHandleConstant<vtkm::Id>(0, nParticles), candidate);
@@ -180,18 +185,22 @@ vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderMxN(T* mxnPot
                                                 zLoc,        // input (whole array)
                                                 mpotential); // output
 
-  // Of the M candidate particles which has the minimum potential
-  DeviceAlgorithm::SortByKey(mpotential, mparticles);
 #ifdef DEBUG_PRINT
   DebugPrint("mparticles", mparticles);
   DebugPrint("mpotential", mpotential);
 #endif
 
+  // Of the M candidate particles which has the minimum potential
+  vtkm::Pair<T, vtkm::Id> mbp =
+    DeviceAlgorithm::Reduce(vtkm::cont::make_ArrayHandleZip(mpotential, mparticles),
+                            vtkm::make_Pair(mpotential.GetPortalConstControl().Get(0),
+                                            mparticles.GetPortalConstControl().Get(0)),
+                            MinimumPotential<T, vtkm::Id>());
+
   // Return the found MBP particle and its potential
-  vtkm::Id mxnMBP = mparticles.GetPortalControl().Get(0);
-  *mxnPotential = mpotential.GetPortalControl().Get(0);
+  *mxnPotential = mbp.first;
 
-  return mxnMBP;
+  return mbp.second;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -208,7 +217,8 @@ void CosmoTools<T, StorageType, DeviceAdapter>::BinParticlesHalo(
   vtkm::cont::ArrayHandle<vtkm::Id>& particleOffset,
   vtkm::cont::ArrayHandle<vtkm::Id>& binX,
   vtkm::cont::ArrayHandle<vtkm::Id>& binY,
-  vtkm::cont::ArrayHandle<vtkm::Id>& binZ)
+  vtkm::cont::ArrayHandle<vtkm::Id>& binZ,
+  T binLen)
 {
   // Compute number of bins and ranges for each bin
   vtkm::Vec<T, 2> xRange(xLoc.GetPortalConstControl().Get(0));
@@ -224,11 +234,12 @@ void CosmoTools<T, StorageType, DeviceAdapter>::BinParticlesHalo(
   T minZ = zRange[0];
   T maxZ = zRange[1];
 
-  numBinsX = static_cast<vtkm::Id>(vtkm::Floor((maxX - minX) / linkLen));
-  numBinsY = static_cast<vtkm::Id>(vtkm::Floor((maxY - minY) / linkLen));
-  numBinsZ = static_cast<vtkm::Id>(vtkm::Floor((maxZ - minZ) / linkLen));
+  numBinsX = static_cast<vtkm::Id>(vtkm::Floor((maxX - minX) / binLen));
+  numBinsY = static_cast<vtkm::Id>(vtkm::Floor((maxY - minY) / binLen));
+  numBinsZ = static_cast<vtkm::Id>(vtkm::Floor((maxZ - minZ) / binLen));
 
-  vtkm::Id maxBins = 1048576;
+  // The bin tree built on these bins has at most MAX_TREE_LEVELS levels
+  vtkm::Id maxBins = MAX_TREE_BINS;
   numBinsX = std::min(maxBins, numBinsX);
   numBinsY = std::min(maxBins, numBinsY);
   numBinsZ = std::min(maxBins, numBinsZ);
@@ -238,6 +249,10 @@ void CosmoTools<T, StorageType, DeviceAdapter>::BinParticlesHalo(
   numBinsY = std::max(minBins, numBinsY);
   numBinsZ = std::max(minBins, numBinsZ);
 
+  binSize = std::max((maxX - minX) / static_cast<T>(numBinsX),
+                     std::max((maxY - minY) / static_cast<T>(numBinsY),
+                              (maxZ - minZ) / static_cast<T>(numBinsZ)));
+
 #ifdef DEBUG_PRINT
   std::cout << std::endl
             << "** BinParticlesHalo (" << numBinsX << ", " << numBinsY << ", " << numBinsZ << ") ("
@@ -385,16 +400,13 @@ void CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFindingByKey(
 //
 // Center finder for particles in a single halo given location and particle id
 // MBP (Most Bound Particle) is particle with the minimum potential energy
-// Method uses ScanInclusiveByKey() and ArrayHandleReverse
+// Method computes all N^2 potentials and reduces to the minimum with Reduce()
 //
 ///////////////////////////////////////////////////////////////////////////////
 template <typename T, typename StorageType, typename DeviceAdapter>
 vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderNxN(T* nxnPotential)
 {
   vtkm::cont::ArrayHandle<T> potential;
-  vtkm::cont::ArrayHandle<T> minPotential;
-
-  vtkm::cont::ArrayHandleReverse<vtkm::cont::ArrayHandle<T>> minPotReverse(minPotential);
 
   vtkm::cont::ArrayHandleIndex particleIndex(nParticles);
 
@@ -409,27 +421,223 @@ vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderNxN(T* nxnPot
                                         zLoc,          // input (whole array)
                                         potential);    // output
 
-  // Find minimum potential for all particles in a halo
-  DeviceAlgorithm::ScanInclusive(potential, minPotential, vtkm::Minimum());
-  DeviceAlgorithm::ScanInclusive(minPotReverse, minPotReverse, vtkm::Minimum());
+  // Find the particle with the minimum potential in one reduction
+  vtkm::Pair<T, vtkm::Id> mbp =
+    DeviceAlgorithm::Reduce(vtkm::cont::make_ArrayHandleZip(potential, particleIndex),
+                            vtkm::make_Pair(potential.GetPortalConstControl().Get(0), vtkm::Id(0)),
+                            MinimumPotential<T, vtkm::Id>());
 
-  // Find the particle id matching the minimum potential
-  vtkm::cont::ArrayHandle<vtkm::Id> centerId;
-  EqualsMinimumPotential<T> equalsMinimumPotential;
-  vtkm::worklet::DispatcherMapField<EqualsMinimumPotential<T>, DeviceAdapter>
-    equalsMinimumPotentialDispatcher(equalsMinimumPotential);
+  *nxnPotential = mbp.first;
 
-  equalsMinimumPotentialDispatcher.Invoke(particleIndex, potential, minPotential, centerId);
+  return mbp.second;
+}
 
-  // Fill out entire array with center index
-  vtkm::cont::ArrayHandleReverse<vtkm::cont::ArrayHandle<vtkm::Id>> centerIdReverse(centerId);
-  DeviceAlgorithm::ScanInclusive(centerId, centerId, vtkm::Maximum());
-  DeviceAlgorithm::ScanInclusive(centerIdReverse, centerIdReverse, vtkm::Maximum());
+///////////////////////////////////////////////////////////////////////////////
+//
+// Center finder for particles in a single halo given location and particle id
+// MBP (Most Bound Particle) is particle with the minimum potential energy
+// Method uses a tree code over a hierarchy of bins, see ComputePotentialTree
+// The opening angle theta sets the accuracy, and theta = 0 gives the NxN potentials
+//
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename StorageType, typename DeviceAdapter>
+vtkm::Id CosmoTools<T, StorageType, DeviceAdapter>::MBPCenterFinderTree(T* treePotential, T theta)
+{
+  vtkm::cont::ArrayHandle<vtkm::Id> partId;
+  vtkm::cont::ArrayHandle<vtkm::Id> binId;
+
+  vtkm::cont::ArrayHandle<vtkm::Id> uniqueBins;
+  vtkm::cont::ArrayHandle<vtkm::Id> partPerBin;
+  vtkm::cont::ArrayHandle<vtkm::Id> particleOffset;
+
+  vtkm::cont::ArrayHandle<vtkm::Id> binX;
+  vtkm::cont::ArrayHandle<vtkm::Id> binY;
+  vtkm::cont::ArrayHandle<vtkm::Id> binZ;
 
-  vtkm::Id nxnMBP = centerId.GetPortalConstControl().Get(0);
-  *nxnPotential = potential.GetPortalConstControl().Get(nxnMBP);
+  // Size the finest bins of the tree to hold a few particles on average, and at first
+  // never less than the linking length
+  vtkm::Vec<T, 2> xRange(xLoc.GetPortalConstControl().Get(0));
+  vtkm::Vec<T, 2> yRange(yLoc.GetPortalConstControl().Get(0));
+  vtkm::Vec<T, 2> zRange(zLoc.GetPortalConstControl().Get(0));
+  xRange = DeviceAlgorithm::Reduce(xLoc, xRange, vtkm::MinAndMax<T>());
+  yRange = DeviceAlgorithm::Reduce(yLoc, yRange, vtkm::MinAndMax<T>());
+  zRange = DeviceAlgorithm::Reduce(zLoc, zRange, vtkm::MinAndMax<T>());
+  T volume = std::max(xRange[1] - xRange[0], linkLen) * std::max(yRange[1] - yRange[0], linkLen) *
+    std::max(zRange[1] - zRange[0], linkLen);
+  T leafLen = vtkm::Cbrt(volume * static_cast<T>(TREE_LEAF_PARTICLES) / static_cast<T>(nParticles));
+  leafLen = std::max(linkLen, leafLen);
+
+  // Bin all particles in the halo into the finest bins of the tree. The core of a halo
+  // is much denser than average, so the bins are halved while the fullest one is
+  // crowded, as its particles would otherwise be summed one by one for each other
+  BinParticlesHalo(
+    partId, binId, uniqueBins, partPerBin, particleOffset, binX, binY, binZ, leafLen);
+  vtkm::Id maxPartPerBin = DeviceAlgorithm::Reduce(partPerBin, vtkm::Id(0), vtkm::Maximum());
+  for (vtkm::IdComponent refinement = 0;
+       (refinement < TREE_LEAF_REFINEMENTS) && (maxPartPerBin > TREE_LEAF_MAX_PARTICLES);
+       refinement++)
+  {
+    leafLen /= 2;
+    BinParticlesHalo(
+      partId, binId, uniqueBins, partPerBin, particleOffset, binX, binY, binZ, leafLen);
+    maxPartPerBin = DeviceAlgorithm::Reduce(partPerBin, vtkm::Id(0), vtkm::Maximum());
+  }
+
+  // Gather the locations in bin order so that the particles of a bin are contiguous
+  using PermuteLocationType = vtkm::cont::ArrayHandlePermutation<vtkm::cont::ArrayHandle<vtkm::Id>,
+                                                                 LocationType>;
+  vtkm::cont::ArrayHandle<T> xSorted;
+  vtkm::cont::ArrayHandle<T> ySorted;
+  vtkm::cont::ArrayHandle<T> zSorted;
+  DeviceAlgorithm::Copy(PermuteLocationType(partId, xLoc), xSorted);
+  DeviceAlgorithm::Copy(PermuteLocationType(partId, yLoc), ySorted);
+  DeviceAlgorithm::Copy(PermuteLocationType(partId, zLoc), zSorted);
+
+  // Number of particles and sum of their locations for the finest bins
+  vtkm::cont::ArrayHandle<T> partCount;
+  DeviceAlgorithm::Copy(vtkm::cont::ArrayHandleConstant<T>(1, nParticles), partCount);
+
+  vtkm::cont::ArrayHandle<vtkm::Vec<T, 4>> partMoment;
+  DeviceAlgorithm::Copy(
+    vtkm::cont::make_ArrayHandleCompositeVector(partCount, xSorted, ySorted, zSorted), partMoment);
+
+  // Each bin of the tree has an Id, a moment and a range, which is the range of its
+  // particles for the finest bins and the range of its children in the level below
+  // for all others
+  std::vector<vtkm::cont::ArrayHandle<vtkm::Id>> levelBins(1);
+  std::vector<vtkm::cont::ArrayHandle<vtkm::Vec<T, 4>>> levelMoments(1);
+  std::vector<vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 2>>> levelRanges(1);
+  DeviceAlgorithm::ReduceByKey(binId, partMoment, levelBins[0], levelMoments[0], vtkm::Add());
+  DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandleCompositeVector(particleOffset, partPerBin),
+                        levelRanges[0]);
+
+  // Merge 2x2x2 bins into their parent until a single bin holds the whole halo
+  using PermuteIdType = vtkm::cont::ArrayHandlePermutation<vtkm::cont::ArrayHandle<vtkm::Id>,
+                                                           vtkm::cont::ArrayHandle<vtkm::Id>>;
+  using PermuteMomentType =
+    vtkm::cont::ArrayHandlePermutation<vtkm::cont::ArrayHandle<vtkm::Id>,
+                                       vtkm::cont::ArrayHandle<vtkm::Vec<T, 4>>>;
+  using PermuteRangeType =
+    vtkm::cont::ArrayHandlePermutation<vtkm::cont::ArrayHandle<vtkm::Id>,
+                                       vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 2>>>;
+  vtkm::Id numX = numBinsX;
+  vtkm::Id numY = numBinsY;
+  vtkm::Id numZ = numBinsZ;
+  while ((numX > 1) || (numY > 1) || (numZ > 1))
+  {
+    std::size_t level = levelBins.size() - 1;
+    vtkm::Id numChildren = levelBins[level].GetNumberOfValues();
+
+    vtkm::cont::ArrayHandle<vtkm::Id> parentId;
+    ComputeParentBins computeParentBins(numX, numY);
+    vtkm::worklet::DispatcherMapField<ComputeParentBins, DeviceAdapter>
+      computeParentBinsDispatcher(computeParentBins);
+    computeParentBinsDispatcher.Invoke(levelBins[level], parentId);
+
+    // Reorder the bins of this level so the children of each parent are contiguous
+    vtkm::cont::ArrayHandle<vtkm::Id> order;
+    DeviceAlgorithm::Copy(vtkm::cont::ArrayHandleIndex(numChildren), order);
+    DeviceAlgorithm::SortByKey(parentId, order);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> childBins;
+    vtkm::cont::ArrayHandle<vtkm::Vec<T, 4>> childMoments;
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 2>> childRanges;
+    DeviceAlgorithm::Copy(PermuteIdType(order, levelBins[level]), childBins);
+    DeviceAlgorithm::Copy(PermuteMomentType(order, levelMoments[level]), childMoments);
+    DeviceAlgorithm::Copy(PermuteRangeType(order, levelRanges[level]), childRanges);
+    levelBins[level] = childBins;
+    levelMoments[level] = childMoments;
+    levelRanges[level] = childRanges;
+
+    vtkm::cont::ArrayHandle<vtkm::Id> parentBins;
+    vtkm::cont::ArrayHandle<vtkm::Vec<T, 4>> parentMoments;
+    vtkm::cont::ArrayHandle<vtkm::Id> childCount;
+    vtkm::cont::ArrayHandle<vtkm::Id> childOffset;
+    DeviceAlgorithm::ReduceByKey(parentId, childMoments, parentBins, parentMoments, vtkm::Add());
+    DeviceAlgorithm::ReduceByKey(parentId,
+                                 vtkm::cont::ArrayHandleConstant<vtkm::Id>(1, numChildren),
+                                 parentBins,
+                                 childCount,
+                                 vtkm::Add());
+    DeviceAlgorithm::ScanExclusive(childCount, childOffset);
+
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 2>> parentRanges;
+    DeviceAlgorithm::Copy(vtkm::cont::make_ArrayHandleCompositeVector(childOffset, childCount),
+                          parentRanges);
+
+    levelBins.push_back(parentBins);
+    levelMoments.push_back(parentMoments);
+    levelRanges.push_back(parentRanges);
+
+    numX = (numX + 1) / 2;
+    numY = (numY + 1) / 2;
+    numZ = (numZ + 1) / 2;
+  }
+
+  // Store the bins of all levels one level after the other
+  vtkm::Id numLevels = static_cast<vtkm::Id>(levelBins.size());
+  VTKM_ASSERT(numLevels <= MAX_TREE_LEVELS);
+  vtkm::cont::ArrayHandle<vtkm::Id> levelOffset;
+  levelOffset.Allocate(numLevels + 1);
+  levelOffset.GetPortalControl().Set(0, 0);
+  for (vtkm::Id level = 0; level < numLevels; level++)
+  {
+    levelOffset.GetPortalControl().Set(
+      level + 1,
+      levelOffset.GetPortalControl().Get(level) +
+        levelBins[static_cast<std::size_t>(level)].GetNumberOfValues());
+  }
+
+  vtkm::Id numTreeBins = levelOffset.GetPortalConstControl().Get(numLevels);
+  vtkm::cont::ArrayHandle<vtkm::Id> treeBinId;
+  vtkm::cont::ArrayHandle<vtkm::Vec<T, 4>> treeBinMoment;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Id, 2>> treeBinRange;
+  treeBinId.Allocate(numTreeBins);
+  treeBinMoment.Allocate(numTreeBins);
+  treeBinRange.Allocate(numTreeBins);
+  for (vtkm::Id level = 0; level < numLevels; level++)
+  {
+    std::size_t index = static_cast<std::size_t>(level);
+    vtkm::Id offset = levelOffset.GetPortalConstControl().Get(level);
+    vtkm::Id count = levelBins[index].GetNumberOfValues();
+    DeviceAlgorithm::CopySubRange(levelBins[index], 0, count, treeBinId, offset);
+    DeviceAlgorithm::CopySubRange(levelMoments[index], 0, count, treeBinMoment, offset);
+    DeviceAlgorithm::CopySubRange(levelRanges[index], 0, count, treeBinRange, offset);
+  }
+#ifdef DEBUG_PRINT
+  DebugPrint("levelOffset", levelOffset);
+  DebugPrint("treeBinId", treeBinId);
+#endif
 
-  return nxnMBP;
+  // Compute potentials on all particles by walking the bin tree
+  vtkm::cont::ArrayHandle<T> potential;
+  vtkm::cont::ArrayHandleIndex particleIndex(nParticles);
+  ComputePotentialTree<T> computePotentialTree(
+    numBinsX, numBinsY, numBinsZ, numLevels, binSize, particleMass, theta);
+  vtkm::worklet::DispatcherMapField<ComputePotentialTree<T>, DeviceAdapter>
+    computePotentialTreeDispatcher(computePotentialTree);
+
+  computePotentialTreeDispatcher.Invoke(particleIndex,  // input
+                                        binId,          // input
+                                        xSorted,        // input (whole array)
+                                        ySorted,        // input (whole array)
+                                        zSorted,        // input (whole array)
+                                        treeBinId,      // input (whole array)
+                                        treeBinMoment,  // input (whole array)
+                                        treeBinRange,   // input (whole array)
+                                        levelOffset,    // input (whole array)
+                                        potential);     // output
+
+  // Find the particle with the minimum potential in one reduction
+  vtkm::Pair<T, vtkm::Id> mbp =
+    DeviceAlgorithm::Reduce(vtkm::cont::make_ArrayHandleZip(potential, partId),
+                            vtkm::make_Pair(potential.GetPortalConstControl().Get(0),
+                                            partId.GetPortalConstControl().Get(0)),
+                            MinimumPotential<T, vtkm::Id>());
+
+  *treePotential = mbp.first;
+
+  return mbp.second;
 }
 }
 }
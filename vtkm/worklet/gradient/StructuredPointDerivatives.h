@@ -0,0 +1,277 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_gradient_StructuredPointDerivatives_h
+#define vtk_m_worklet_gradient_StructuredPointDerivatives_h
+
+#include <vtkm/BaseComponent.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ExecutionObjectBase.h>
+#include <vtkm/worklet/WorkletPointNeighborhood.h>
+
+namespace vtkm
+{
+namespace exec
+{
+template <typename T, typename DeviceAdapter>
+struct StructuredPointDerivativesOutputExecutionObject
+{
+  using BaseTType = typename vtkm::BaseComponent<T>::Type;
+
+  template <typename FieldType>
+  struct PortalTypes
+  {
+    using HandleType = vtkm::cont::ArrayHandle<FieldType>;
+    using ExecutionTypes = typename HandleType::template ExecutionTypes<DeviceAdapter>;
+    using Portal = typename ExecutionTypes::Portal;
+  };
+
+  StructuredPointDerivativesOutputExecutionObject() = default;
+
+  StructuredPointDerivativesOutputExecutionObject(
+    bool d,
+    bool v,
+    bool q,
+    vtkm::cont::ArrayHandle<BaseTType> divergence,
+    vtkm::cont::ArrayHandle<vtkm::Vec<BaseTType, 3>> vorticity,
+    vtkm::cont::ArrayHandle<BaseTType> qcriterion,
+    vtkm::Id size)
+  {
+    this->SetDivergence = d;
+    this->SetVorticity = v;
+    this->SetQCriterion = q;
+
+    DeviceAdapter device;
+    if (d)
+    {
+      this->DivergencePortal = divergence.PrepareForOutput(size, device);
+    }
+    if (v)
+    {
+      this->VorticityPortal = vorticity.PrepareForOutput(size, device);
+    }
+    if (q)
+    {
+      this->QCriterionPortal = qcriterion.PrepareForOutput(size, device);
+    }
+  }
+
+  bool SetDivergence;
+  bool SetVorticity;
+  bool SetQCriterion;
+
+  typename PortalTypes<BaseTType>::Portal DivergencePortal;
+  typename PortalTypes<vtkm::Vec<BaseTType, 3>>::Portal VorticityPortal;
+  typename PortalTypes<BaseTType>::Portal QCriterionPortal;
+};
+}
+} // namespace vtkm::exec
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace gradient
+{
+
+/// Output arrays of \c StructuredPointDerivatives. Only the requested
+/// quantities are allocated and written.
+template <typename T>
+struct StructuredPointDerivativesOutput : public vtkm::cont::ExecutionObjectBase
+{
+  using BaseTType = typename vtkm::BaseComponent<T>::Type;
+
+  template <typename Device>
+  VTKM_CONT vtkm::exec::StructuredPointDerivativesOutputExecutionObject<T, Device>
+    PrepareForExecution(Device) const
+  {
+    return vtkm::exec::StructuredPointDerivativesOutputExecutionObject<T, Device>(
+      this->D, this->V, this->Q, this->Divergence, this->Vorticity, this->QCriterion, this->Size);
+  }
+
+  StructuredPointDerivativesOutput() = default;
+
+  StructuredPointDerivativesOutput(bool d,
+                                   bool v,
+                                   bool q,
+                                   vtkm::cont::ArrayHandle<BaseTType>& divergence,
+                                   vtkm::cont::ArrayHandle<vtkm::Vec<BaseTType, 3>>& vorticity,
+                                   vtkm::cont::ArrayHandle<BaseTType>& qcriterion,
+                                   vtkm::Id size)
+    : D(d)
+    , V(v)
+    , Q(q)
+    , Divergence(divergence)
+    , Vorticity(vorticity)
+    , QCriterion(qcriterion)
+    , Size(size)
+  {
+  }
+
+  bool D;
+  bool V;
+  bool Q;
+  vtkm::cont::ArrayHandle<BaseTType> Divergence;
+  vtkm::cont::ArrayHandle<vtkm::Vec<BaseTType, 3>> Vorticity;
+  vtkm::cont::ArrayHandle<BaseTType> QCriterion;
+  vtkm::Id Size;
+};
+
+template <typename T>
+struct StructuredPointDerivativesInType : vtkm::ListTagBase<T>
+{
+};
+
+/// Computes divergence, vorticity and/or Q-criterion of a 3 component point
+/// field directly from the 3x3x3 neighborhood, without going through the
+/// gradient. Only the partial derivatives that the requested quantities use
+/// are evaluated, e.g. divergence only needs the diagonal of the Jacobian.
+/// The differencing matches \c StructuredPointGradient.
+template <typename T>
+struct StructuredPointDerivatives : public vtkm::worklet::WorkletPointNeighborhood3x3x3
+{
+  using ControlSignature = void(CellSetIn,
+                                FieldInNeighborhood<Vec3> points,
+                                FieldInNeighborhood<StructuredPointDerivativesInType<T>>,
+                                ExecObject outputFields);
+
+  using ExecutionSignature = void(OnBoundary, _2, _3, _4, WorkIndex);
+
+  using InputDomain = _1;
+
+  template <typename PointsIn, typename FieldIn, typename OutputType>
+  VTKM_EXEC void operator()(const vtkm::exec::arg::BoundaryState& boundary,
+                            const PointsIn& inputPoints,
+                            const FieldIn& inputField,
+                            const OutputType& output,
+                            vtkm::Id index) const
+  {
+    using CoordType = typename PointsIn::ValueType;
+    using CT = typename vtkm::BaseComponent<CoordType>::Type;
+
+    CoordType xi = inputPoints.Get(1, 0, 0) - inputPoints.Get(-1, 0, 0);
+    CoordType eta = inputPoints.Get(0, 1, 0) - inputPoints.Get(0, -1, 0);
+    CoordType zeta = inputPoints.Get(0, 0, 1) - inputPoints.Get(0, 0, -1);
+
+    xi = (boundary.OnX() ? xi : xi * 0.5f);
+    eta = (boundary.OnY() ? eta : eta * 0.5f);
+    zeta = (boundary.OnZ() ? zeta : zeta * 0.5f);
+
+    CT aj = xi[0] * eta[1] * zeta[2] + xi[1] * eta[2] * zeta[0] + xi[2] * eta[0] * zeta[1] -
+      xi[2] * eta[1] * zeta[0] - xi[1] * eta[0] * zeta[2] - xi[0] * eta[2] * zeta[1];
+    aj = (aj != 0.0) ? 1.f / aj : aj;
+
+    vtkm::Vec<vtkm::Vec<CT, 3>, 3> metrics;
+    metrics[0][0] = aj * (eta[1] * zeta[2] - eta[2] * zeta[1]);
+    metrics[0][1] = -aj * (eta[0] * zeta[2] - eta[2] * zeta[0]);
+    metrics[0][2] = aj * (eta[0] * zeta[1] - eta[1] * zeta[0]);
+    metrics[1][0] = -aj * (xi[1] * zeta[2] - xi[2] * zeta[1]);
+    metrics[1][1] = aj * (xi[0] * zeta[2] - xi[2] * zeta[0]);
+    metrics[1][2] = -aj * (xi[0] * zeta[1] - xi[1] * zeta[0]);
+    metrics[2][0] = aj * (xi[1] * eta[2] - xi[2] * eta[1]);
+    metrics[2][1] = -aj * (xi[0] * eta[2] - xi[2] * eta[0]);
+    metrics[2][2] = aj * (xi[0] * eta[1] - xi[1] * eta[0]);
+
+    this->Compute(boundary, metrics, inputField, output, index);
+  }
+
+  template <typename FieldIn, typename OutputType>
+  VTKM_EXEC void operator()(
+    const vtkm::exec::arg::BoundaryState& boundary,
+    const vtkm::exec::arg::Neighborhood<1, vtkm::internal::ArrayPortalUniformPointCoordinates>&
+      inputPoints,
+    const FieldIn& inputField,
+    const OutputType& output,
+    vtkm::Id index) const
+  {
+    //On uniform grids the metrics are diagonal, see StructuredPointGradient.
+    //The central difference halving is applied to the field deltas instead.
+    using CoordType = vtkm::internal::ArrayPortalUniformPointCoordinates::ValueType;
+    using CT = typename vtkm::BaseComponent<CoordType>::Type;
+
+    const CoordType r = inputPoints.Portal.GetSpacing();
+    vtkm::Vec<vtkm::Vec<CT, 3>, 3> metrics(vtkm::Vec<CT, 3>(0));
+    metrics[0][0] = r[0];
+    metrics[1][1] = r[1];
+    metrics[2][2] = r[2];
+
+    this->Compute(boundary, metrics, inputField, output, index);
+  }
+
+private:
+  template <typename CT, typename FieldIn, typename OutputType>
+  VTKM_EXEC void Compute(const vtkm::exec::arg::BoundaryState& boundary,
+                         const vtkm::Vec<vtkm::Vec<CT, 3>, 3>& metrics,
+                         const FieldIn& inputField,
+                         const OutputType& output,
+                         vtkm::Id index) const
+  {
+    using OT = typename vtkm::BaseComponent<T>::Type;
+
+    // Index space differences of the field, one row per logical axis.
+    vtkm::Vec<T, 3> delta;
+    delta[0] = inputField.Get(1, 0, 0) - inputField.Get(-1, 0, 0);
+    delta[1] = inputField.Get(0, 1, 0) - inputField.Get(0, -1, 0);
+    delta[2] = inputField.Get(0, 0, 1) - inputField.Get(0, 0, -1);
+    delta[0] = (boundary.OnX() ? delta[0] : delta[0] * 0.5f);
+    delta[1] = (boundary.OnY() ? delta[1] : delta[1] * 0.5f);
+    delta[2] = (boundary.OnZ() ? delta[2] : delta[2] * 0.5f);
+
+    // grad[i][j] is the derivative of component j along axis i, the same
+    // layout as the gradient output. Off diagonal terms are only needed for
+    // vorticity and Q-criterion.
+    const bool offDiagonal = output.SetVorticity || output.SetQCriterion;
+    vtkm::Vec<vtkm::Vec<OT, 3>, 3> grad(vtkm::Vec<OT, 3>(0));
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      for (vtkm::IdComponent j = 0; j < 3; ++j)
+      {
+        if (i == j || offDiagonal)
+        {
+          grad[i][j] = static_cast<OT>(metrics[0][i] * delta[0][j] +
+                                       metrics[1][i] * delta[1][j] + metrics[2][i] * delta[2][j]);
+        }
+      }
+    }
+
+    if (output.SetDivergence)
+    {
+      output.DivergencePortal.Set(index, grad[0][0] + grad[1][1] + grad[2][2]);
+    }
+    if (output.SetVorticity)
+    {
+      output.VorticityPortal.Set(index,
+                                 vtkm::Vec<OT, 3>(grad[1][2] - grad[2][1],
+                                                  grad[2][0] - grad[0][2],
+                                                  grad[0][1] - grad[1][0]));
+    }
+    if (output.SetQCriterion)
+    {
+      const OT q =
+        -(grad[0][0] * grad[0][0] + grad[1][1] * grad[1][1] + grad[2][2] * grad[2][2]) / 2 -
+        (grad[1][0] * grad[0][1] + grad[2][0] * grad[0][2] + grad[2][1] * grad[1][2]);
+      output.QCriterionPortal.Set(index, q);
+    }
+  }
+};
+}
+}
+}
+
+#endif
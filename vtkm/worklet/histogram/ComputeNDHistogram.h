@@ -92,11 +92,13 @@ public:
   ComputeBins(vtkm::cont::ArrayHandle<vtkm::Id>& _bin1DIdx,
               vtkm::Id& _numOfBins,
               vtkm::Range& _minMax,
-              vtkm::Float64& _binDelta)
+              vtkm::Float64& _binDelta,
+              bool _computeRange = true)
     : Bin1DIdx(_bin1DIdx)
     , NumOfBins(_numOfBins)
     , MinMax(_minMax)
     , BinDelta(_binDelta)
+    , ComputeRange(_computeRange)
   {
   }
 
@@ -105,10 +107,14 @@ public:
   {
     using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
 
-    const vtkm::Vec<T, 2> initValue(field.GetPortalConstControl().Get(0));
-    vtkm::Vec<T, 2> minMax = Algorithm::Reduce(field, initValue, vtkm::MinAndMax<T>());
-    MinMax.Min = static_cast<vtkm::Float64>(minMax[0]);
-    MinMax.Max = static_cast<vtkm::Float64>(minMax[1]);
+    // When the range is given (e.g. shared by several blocks) it is used as is
+    if (ComputeRange)
+    {
+      const vtkm::Vec<T, 2> initValue(field.GetPortalConstControl().Get(0));
+      vtkm::Vec<T, 2> minMax = Algorithm::Reduce(field, initValue, vtkm::MinAndMax<T>());
+      MinMax.Min = static_cast<vtkm::Float64>(minMax[0]);
+      MinMax.Max = static_cast<vtkm::Float64>(minMax[1]);
+    }
     BinDelta = compute_delta(MinMax.Min, MinMax.Max, NumOfBins);
 
     SetHistogramBin<T> binWorklet(NumOfBins, MinMax.Min, BinDelta);
@@ -122,6 +128,7 @@ private:
   vtkm::Id& NumOfBins;
   vtkm::Range& MinMax;
   vtkm::Float64& BinDelta;
+  bool ComputeRange;
 };
 
 // Convert N-dims bin index into 1D index
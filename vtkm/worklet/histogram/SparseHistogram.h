@@ -0,0 +1,297 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_SparseHistogram_h
+#define vtk_m_worklet_SparseHistogram_h
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace histogram
+{
+// Adds weighted bin ids into an open addressing (linear probing) hash table.
+// The first thread that hits an empty slot claims it for its bin with an
+// atomic compare and swap, so all points are binned in a single pass. A new
+// bin is only added while the table holds fewer than maxNumberOfEntries bins;
+// points that would go over are flagged so they can be inserted again once
+// the table has grown.
+class InsertSparseBins : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn<> bin,
+                                FieldIn<> weight,
+                                AtomicArrayInOut<> tableBins,
+                                AtomicArrayInOut<> tableFreqs,
+                                AtomicArrayInOut<> numberOfEntries,
+                                FieldOut<> full);
+  using ExecutionSignature = _6(_1, _2, _3, _4, _5);
+  using InputDomain = _1;
+
+  VTKM_EXEC_CONT
+  static vtkm::Id EmptySlot() { return -1; }
+
+  vtkm::Id Mask;
+  vtkm::UInt32 Shift;
+  vtkm::Id MaxNumberOfEntries;
+
+  VTKM_CONT
+  InsertSparseBins(vtkm::UInt32 log2Capacity, vtkm::Id maxNumberOfEntries)
+    : Mask((vtkm::Id(1) << log2Capacity) - 1)
+    , Shift(64 - log2Capacity)
+    , MaxNumberOfEntries(maxNumberOfEntries)
+  {
+  }
+
+  VTKM_EXEC
+  vtkm::Id HashSlot(vtkm::Id bin) const
+  {
+    // Fibonacci hashing spreads the runs of consecutive bin ids that come
+    // from the linearized ND bin index over the whole table.
+    const vtkm::UInt64 hash = static_cast<vtkm::UInt64>(bin) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<vtkm::Id>(hash >> this->Shift);
+  }
+
+  // Returns 1 if the bin was not counted because the table is full.
+  template <typename AtomicArrayType>
+  VTKM_EXEC vtkm::Id operator()(const vtkm::Id& bin,
+                                const vtkm::Id& weight,
+                                const AtomicArrayType& tableBins,
+                                const AtomicArrayType& tableFreqs,
+                                const AtomicArrayType& numberOfEntries) const
+  {
+    if (weight == 0)
+    {
+      return 0;
+    }
+
+    const vtkm::Id emptySlot = EmptySlot();
+    vtkm::Id slot = this->HashSlot(bin);
+    while (true)
+    {
+      // Swapping an empty slot with itself just reads the slot.
+      vtkm::Id previous = tableBins.CompareAndSwap(slot, emptySlot, emptySlot);
+      if (previous == emptySlot)
+      {
+        // Reserve room for a new bin before claiming the slot.
+        if (numberOfEntries.Add(0, 1) >= this->MaxNumberOfEntries)
+        {
+          numberOfEntries.Add(0, -1);
+          return 1;
+        }
+        previous = tableBins.CompareAndSwap(slot, bin, emptySlot);
+        if (previous == emptySlot)
+        {
+          break;
+        }
+        numberOfEntries.Add(0, -1);
+      }
+      if (previous == bin)
+      {
+        break;
+      }
+      slot = (slot + 1) & this->Mask;
+    }
+    tableFreqs.Add(slot, weight);
+    return 0;
+  }
+};
+
+// Sparse 1D histogram over (linearized) bin ids, kept in a hash table.
+// Unlike sorting the bin id of every point and reducing by key, points are
+// counted in one pass and only the non-empty bins are ever sorted. The table
+// keeps its counts between calls to Insert, so histograms of several blocks
+// or time steps can be accumulated, and it can be filled with weighted bins,
+// which is how a histogram is marginalized without re-sorting it.
+class SparseHistogram
+{
+public:
+  VTKM_CONT
+  SparseHistogram()
+    : Log2Capacity(0)
+    , NumberOfEntries(0)
+  {
+  }
+
+  // Number of non-empty bins in the histogram
+  VTKM_CONT
+  vtkm::Id GetNumberOfBins() const { return this->NumberOfEntries; }
+
+  VTKM_CONT
+  void Reset()
+  {
+    this->TableBins.ReleaseResources();
+    this->TableFreqs.ReleaseResources();
+    this->Log2Capacity = 0;
+    this->NumberOfEntries = 0;
+  }
+
+  // Add weights[i] to the frequency of bins[i]. Zero weights are skipped.
+  // The table starts small and grows as it fills, since the number of
+  // distinct bins is usually far below the number of values. maxNumberOfBins
+  // bounds the number of distinct bin ids that can occur (e.g. the product of
+  // the number of bins of each variable) and caps how far the table grows.
+  template <typename BinStorage, typename WeightStorage, typename DeviceAdapter>
+  VTKM_CONT void Insert(const vtkm::cont::ArrayHandle<vtkm::Id, BinStorage>& bins,
+                        const vtkm::cont::ArrayHandle<vtkm::Id, WeightStorage>& weights,
+                        vtkm::Id maxNumberOfBins,
+                        DeviceAdapter device)
+  {
+    using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    if (bins.GetNumberOfValues() == 0)
+    {
+      return;
+    }
+    const vtkm::Id initialNumberOfBins = 512;
+    this->Reserve(vtkm::Min(vtkm::Max(this->NumberOfEntries, initialNumberOfBins),
+                            maxNumberOfBins),
+                  device);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> full;
+    this->InsertPass(bins, weights, full, device);
+
+    // Insert the values that did not fit again, growing the table when it is full.
+    vtkm::cont::ArrayHandle<vtkm::Id> remainingBins;
+    vtkm::cont::ArrayHandle<vtkm::Id> remainingWeights;
+    DeviceAlgorithms::CopyIf(bins, full, remainingBins);
+    DeviceAlgorithms::CopyIf(weights, full, remainingWeights);
+    while (remainingBins.GetNumberOfValues() > 0)
+    {
+      if (this->NumberOfEntries >= this->GetMaxNumberOfEntries())
+      {
+        vtkm::Id numberOfEntries = 4 * this->NumberOfEntries;
+        if (maxNumberOfBins > this->NumberOfEntries)
+        {
+          numberOfEntries = vtkm::Min(numberOfEntries, maxNumberOfBins);
+        }
+        this->Reserve(numberOfEntries, device);
+      }
+
+      vtkm::cont::ArrayHandle<vtkm::Id> retryBins;
+      vtkm::cont::ArrayHandle<vtkm::Id> retryWeights;
+      this->InsertPass(remainingBins, remainingWeights, full, device);
+      DeviceAlgorithms::CopyIf(remainingBins, full, retryBins);
+      DeviceAlgorithms::CopyIf(remainingWeights, full, retryWeights);
+      remainingBins = retryBins;
+      remainingWeights = retryWeights;
+    }
+  }
+
+  // Return the non-empty bins, sorted by bin id, and their frequencies.
+  template <typename DeviceAdapter>
+  VTKM_CONT void GetBins(vtkm::cont::ArrayHandle<vtkm::Id>& bins,
+                         vtkm::cont::ArrayHandle<vtkm::Id>& freqs,
+                         DeviceAdapter device) const
+  {
+    using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    this->Compact(bins, freqs, device);
+    DeviceAlgorithms::SortByKey(bins, freqs);
+  }
+
+private:
+  // A new bin is only added while the table is less than half full.
+  VTKM_CONT
+  vtkm::Id GetMaxNumberOfEntries() const { return (vtkm::Id(1) << this->Log2Capacity) / 2; }
+
+  // Insert as many values as fit and flag the others in full.
+  template <typename BinStorage, typename WeightStorage, typename DeviceAdapter>
+  VTKM_CONT void InsertPass(const vtkm::cont::ArrayHandle<vtkm::Id, BinStorage>& bins,
+                            const vtkm::cont::ArrayHandle<vtkm::Id, WeightStorage>& weights,
+                            vtkm::cont::ArrayHandle<vtkm::Id>& full,
+                            DeviceAdapter)
+  {
+    vtkm::cont::ArrayHandle<vtkm::Id> numberOfEntries;
+    numberOfEntries.Allocate(1);
+    numberOfEntries.GetPortalControl().Set(0, this->NumberOfEntries);
+
+    vtkm::worklet::DispatcherMapField<InsertSparseBins, DeviceAdapter> dispatcher(
+      InsertSparseBins(this->Log2Capacity, this->GetMaxNumberOfEntries()));
+    dispatcher.Invoke(bins, weights, this->TableBins, this->TableFreqs, numberOfEntries, full);
+
+    this->NumberOfEntries = numberOfEntries.GetPortalConstControl().Get(0);
+  }
+
+  template <typename DeviceAdapter>
+  VTKM_CONT void Compact(vtkm::cont::ArrayHandle<vtkm::Id>& bins,
+                         vtkm::cont::ArrayHandle<vtkm::Id>& freqs,
+                         DeviceAdapter) const
+  {
+    using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    if (this->NumberOfEntries == 0)
+    {
+      bins.Shrink(0);
+      freqs.Shrink(0);
+      return;
+    }
+    DeviceAlgorithms::CopyIf(this->TableBins, this->TableFreqs, bins);
+    DeviceAlgorithms::CopyIf(this->TableFreqs, this->TableFreqs, freqs);
+  }
+
+  // Grow the table so that it is at most half full with numberOfEntries
+  // entries, re-inserting the bins already counted.
+  template <typename DeviceAdapter>
+  VTKM_CONT void Reserve(vtkm::Id numberOfEntries, DeviceAdapter device)
+  {
+    using DeviceAlgorithms = typename vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+
+    vtkm::UInt32 log2Capacity = 4;
+    while ((vtkm::Id(1) << log2Capacity) < 2 * numberOfEntries)
+    {
+      log2Capacity++;
+    }
+    if (log2Capacity <= this->Log2Capacity)
+    {
+      return;
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::Id> oldBins;
+    vtkm::cont::ArrayHandle<vtkm::Id> oldFreqs;
+    this->Compact(oldBins, oldFreqs, device);
+
+    const vtkm::Id capacity = vtkm::Id(1) << log2Capacity;
+    DeviceAlgorithms::Copy(
+      vtkm::cont::ArrayHandleConstant<vtkm::Id>(InsertSparseBins::EmptySlot(), capacity),
+      this->TableBins);
+    DeviceAlgorithms::Copy(vtkm::cont::ArrayHandleConstant<vtkm::Id>(0, capacity),
+                           this->TableFreqs);
+    this->Log2Capacity = log2Capacity;
+    this->NumberOfEntries = 0;
+
+    this->Insert(oldBins, oldFreqs, oldBins.GetNumberOfValues(), device);
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> TableBins;
+  vtkm::cont::ArrayHandle<vtkm::Id> TableFreqs;
+  vtkm::UInt32 Log2Capacity;
+  vtkm::Id NumberOfEntries;
+};
+}
+}
+} // namespace vtkm::worklet
+
+#endif // vtk_m_worklet_SparseHistogram_h
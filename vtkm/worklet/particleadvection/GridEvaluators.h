@@ -21,13 +21,22 @@
 #ifndef vtk_m_worklet_particleadvection_GridEvaluators_h
 #define vtk_m_worklet_particleadvection_GridEvaluators_h
 
+#include <vtkm/TopologyElementTag.h>
 #include <vtkm/Types.h>
+#include <vtkm/VecFromPortalPermute.h>
 #include <vtkm/VectorAnalysis.h>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/CellLocator.h>
+#include <vtkm/cont/CellSetExplicit.h>
 #include <vtkm/cont/CellSetStructured.h>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/cont/DynamicArrayHandle.h>
+#include <vtkm/exec/CellInside.h>
+#include <vtkm/exec/CellInterpolate.h>
+#include <vtkm/exec/CellLocator.h>
+#include <vtkm/exec/FunctorBase.h>
+#include <vtkm/exec/ParametricCoordinates.h>
 
 namespace vtkm
 {
@@ -84,6 +93,15 @@ public:
     return Evaluate(pos, out);
   }
 
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& pos,
+                FieldType vtkmNotUsed(time),
+                vtkm::Vec<FieldType, 3>& out,
+                vtkm::Id& vtkmNotUsed(cellHint)) const
+  {
+    return Evaluate(pos, out);
+  }
+
   VTKM_EXEC
   bool Evaluate(const vtkm::Vec<FieldType, 3>& pos, vtkm::Vec<FieldType, 3>& out) const
   {
@@ -148,6 +166,15 @@ public:
     return Evaluate(pos, out);
   }
 
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& pos,
+                FieldType vtkmNotUsed(time),
+                vtkm::Vec<FieldType, 3>& out,
+                vtkm::Id& vtkmNotUsed(cellHint)) const
+  {
+    return Evaluate(pos, out);
+  }
+
 
   VTKM_EXEC bool Evaluate(const vtkm::Vec<FieldType, 3>& pos, vtkm::Vec<FieldType, 3>& out) const
   {
@@ -290,6 +317,15 @@ public:
     return Evaluate(pos, out);
   }
 
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& pos,
+                FieldType vtkmNotUsed(time),
+                vtkm::Vec<FieldType, 3>& out,
+                vtkm::Id& vtkmNotUsed(cellHint)) const
+  {
+    return Evaluate(pos, out);
+  }
+
   VTKM_EXEC
   bool Evaluate(const vtkm::Vec<FieldType, 3>& pos, vtkm::Vec<FieldType, 3>& out) const
   {
@@ -486,6 +522,15 @@ public:
     return Evaluate(pos, out);
   }
 
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& pos,
+                FieldType vtkmNotUsed(time),
+                vtkm::Vec<FieldType, 3>& out,
+                vtkm::Id& vtkmNotUsed(cellHint)) const
+  {
+    return Evaluate(pos, out);
+  }
+
   VTKM_EXEC
   bool Evaluate(const vtkm::Vec<FieldType, 3>& pos, vtkm::Vec<FieldType, 3>& out) const
   {
@@ -610,6 +655,206 @@ private:
 
 }; //RectilinearGridEvaluate
 
+//Unstructured Grid Evaluator
+template <typename PortalType,
+          typename FieldType,
+          typename DeviceAdapterTag,
+          typename StorageTag = VTKM_DEFAULT_STORAGE_TAG,
+          typename CellSetType = vtkm::cont::CellSetExplicit<>,
+          typename CoordsHandleType = vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>>>
+class UnstructuredGridEvaluate
+{
+  using FieldHandle = vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>, StorageTag>;
+  using PointCoordType = vtkm::Vec<vtkm::FloatDefault, 3>;
+
+public:
+  VTKM_CONT UnstructuredGridEvaluate() = default;
+
+  // The locator has to be set up with the same cell set and coordinates, and
+  // has to outlive the evaluator as only its execution object is kept here.
+  // It is shared so that it can be built once and reused for many seeds and
+  // time steps. The coordinates are accessed through their concrete array
+  // type, as preparing the virtual coordinates again would invalidate the
+  // portal held by the locator.
+  VTKM_CONT
+  UnstructuredGridEvaluate(const vtkm::cont::CoordinateSystem& coords,
+                           const vtkm::cont::DynamicCellSet& cellSet,
+                           const FieldHandle& vectorField,
+                           vtkm::cont::CellLocator& locator)
+  {
+    if (!coords.GetData().IsType<CoordsHandleType>())
+      throw vtkm::cont::ErrorInternal("Coordinates are not of the expected type.");
+    if (!cellSet.IsSameType(CellSetType()))
+      throw vtkm::cont::ErrorInternal("Cells are not of the expected explicit type.");
+
+    CellSetType cells;
+    cellSet.CopyTo(cells);
+
+    bounds = coords.GetBounds();
+    vectors = vectorField.PrepareForInput(DeviceAdapterTag());
+    points = coords.GetData().Cast<CoordsHandleType>().PrepareForInput(DeviceAdapterTag());
+    cellPoints = cells.PrepareForInput(
+      DeviceAdapterTag(), vtkm::TopologyElementTagPoint(), vtkm::TopologyElementTagCell());
+    pointCells = cells.PrepareForInput(
+      DeviceAdapterTag(), vtkm::TopologyElementTagCell(), vtkm::TopologyElementTagPoint());
+
+    locator.Update();
+    cellLocator = locator.PrepareForExecution(DeviceAdapterTag());
+  }
+
+  VTKM_EXEC_CONT
+  bool IsWithinSpatialBoundary(const vtkm::Vec<FieldType, 3>& position) const
+  {
+    if (!bounds.Contains(position))
+      return false;
+    return true;
+  }
+
+  VTKM_EXEC_CONT
+  bool IsWithinTemporalBoundary(const FieldType vtkmNotUsed(time)) const { return true; }
+
+  VTKM_EXEC_CONT
+  void GetSpatialBoundary(vtkm::Vec<FieldType, 3>& dir, vtkm::Vec<FieldType, 3>& boundary) const
+  {
+    // Based on the direction of the velocity we need to be able to tell where
+    // the particle will exit the domain from to actually push it out of domain.
+    boundary[0] = static_cast<FieldType>(dir[0] > 0 ? bounds.X.Max : bounds.X.Min);
+    boundary[1] = static_cast<FieldType>(dir[1] > 0 ? bounds.Y.Max : bounds.Y.Min);
+    boundary[2] = static_cast<FieldType>(dir[2] > 0 ? bounds.Z.Max : bounds.Z.Min);
+  }
+
+  VTKM_EXEC_CONT
+  void GetTemporalBoundary(FieldType& boundary) const
+  {
+    // Return the time of the newest time slice
+    boundary = 0;
+  }
+
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& pos,
+                FieldType vtkmNotUsed(time),
+                vtkm::Vec<FieldType, 3>& out) const
+  {
+    return Evaluate(pos, out);
+  }
+
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& pos, vtkm::Vec<FieldType, 3>& out) const
+  {
+    vtkm::Id cellHint = -1;
+    return Evaluate(pos, out, cellHint);
+  }
+
+  // cellHint is the cell found by the previous evaluation along the same curve,
+  // or -1, and is updated to the cell containing pos. It is kept by the caller
+  // for each particle, as the evaluator is shared by all of them.
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& pos,
+                FieldType vtkmNotUsed(time),
+                vtkm::Vec<FieldType, 3>& out,
+                vtkm::Id& cellHint) const
+  {
+    return Evaluate(pos, out, cellHint);
+  }
+
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& pos,
+                vtkm::Vec<FieldType, 3>& out,
+                vtkm::Id& cellHint) const
+  {
+    if (!bounds.Contains(pos))
+      return false;
+
+    PointCoordType point(static_cast<vtkm::FloatDefault>(pos[0]),
+                         static_cast<vtkm::FloatDefault>(pos[1]),
+                         static_cast<vtkm::FloatDefault>(pos[2]));
+    PointCoordType parametric;
+    vtkm::Id cellId = FindCell(point, parametric, cellHint);
+    if (cellId < 0)
+      return false;
+
+    IndicesType indices = cellPoints.GetIndices(cellId);
+    vtkm::VecFromPortalPermute<IndicesType, PortalType> cellVectors(&indices, vectors);
+    out = vtkm::exec::CellInterpolate(
+      cellVectors, parametric, cellPoints.GetCellShape(cellId), worklet);
+    return true;
+  }
+
+private:
+  // An integration step moves a particle by a fraction of a cell, so the cell
+  // that contained the last evaluated position, or one sharing a point with it,
+  // nearly always contains the next one. Only when that local walk fails is
+  // the (much more expensive) locator searched.
+  VTKM_EXEC
+  vtkm::Id FindCell(const PointCoordType& point,
+                    PointCoordType& parametric,
+                    vtkm::Id& cellHint) const
+  {
+    if (cellHint >= 0)
+    {
+      if (IsPointInCell(point, cellHint, parametric))
+        return cellHint;
+
+      IndicesType hintPoints = cellPoints.GetIndices(cellHint);
+      const vtkm::IdComponent numPoints = hintPoints.GetNumberOfComponents();
+      for (vtkm::IdComponent p = 0; p < numPoints; ++p)
+      {
+        auto incidentCells = pointCells.GetIndices(hintPoints[p]);
+        const vtkm::IdComponent numCells = incidentCells.GetNumberOfComponents();
+        for (vtkm::IdComponent c = 0; c < numCells; ++c)
+        {
+          vtkm::Id cellId = incidentCells[c];
+          if (cellId != cellHint && IsPointInCell(point, cellId, parametric))
+          {
+            cellHint = cellId;
+            return cellId;
+          }
+        }
+      }
+    }
+
+    vtkm::Id cellId = -1;
+    cellLocator->FindCell(point, cellId, parametric, worklet);
+    cellHint = cellId;
+    return cellId;
+  }
+
+  VTKM_EXEC
+  bool IsPointInCell(const PointCoordType& point,
+                     vtkm::Id cellId,
+                     PointCoordType& parametric) const
+  {
+    IndicesType indices = cellPoints.GetIndices(cellId);
+    vtkm::VecFromPortalPermute<IndicesType, CoordsPortalType> cellCoords(&indices, points);
+    vtkm::CellShapeTagGeneric cellShape = cellPoints.GetCellShape(cellId);
+
+    bool success = false;
+    parametric = vtkm::exec::WorldCoordinatesToParametricCoordinates(
+      cellCoords, point, cellShape, success, worklet);
+    return success && vtkm::exec::CellInside(parametric, cellShape);
+  }
+
+  using CoordsPortalType =
+    typename CoordsHandleType::template ExecutionTypes<DeviceAdapterTag>::PortalConst;
+  using CellPointsType = typename CellSetType::template ExecutionTypes<
+    DeviceAdapterTag,
+    vtkm::TopologyElementTagPoint,
+    vtkm::TopologyElementTagCell>::ExecObjectType;
+  using PointCellsType = typename CellSetType::template ExecutionTypes<
+    DeviceAdapterTag,
+    vtkm::TopologyElementTagCell,
+    vtkm::TopologyElementTagPoint>::ExecObjectType;
+  using IndicesType = typename CellPointsType::IndicesType;
+
+  vtkm::Bounds bounds;
+  PortalType vectors;
+  CoordsPortalType points;
+  CellPointsType cellPoints;
+  PointCellsType pointCells;
+  const vtkm::exec::CellLocator* cellLocator = nullptr;
+  vtkm::exec::FunctorBase worklet;
+}; //UnstructuredGridEvaluate
+
 } //namespace particleadvection
 } //namespace worklet
 } //namespace vtkm
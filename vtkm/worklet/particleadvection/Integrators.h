@@ -61,25 +61,35 @@ public:
   ParticleStatus Step(const vtkm::Vec<FieldType, 3>& inpos,
                       FieldType& time,
                       vtkm::Vec<FieldType, 3>& outpos) const
+  {
+    vtkm::Id cellHint = -1;
+    return Step(inpos, time, outpos, cellHint);
+  }
+
+  // cellHint is passed on to the evaluator, which may use it to find the
+  // cell containing the particle faster. The caller keeps it for each
+  // particle between steps, starting from -1.
+  VTKM_EXEC
+  ParticleStatus Step(const vtkm::Vec<FieldType, 3>& inpos,
+                      FieldType& time,
+                      vtkm::Vec<FieldType, 3>& outpos,
+                      vtkm::Id& cellHint) const
   {
     // If without taking the step the particle is out of either spatial
     // or temporal boundary, then return the corresponding status.
+    outpos = inpos;
     if (!this->Evaluator.IsWithinSpatialBoundary(inpos))
       return ParticleStatus::EXITED_SPATIAL_BOUNDARY;
     if (!this->Evaluator.IsWithinTemporalBoundary(time))
       return ParticleStatus::EXITED_TEMPORAL_BOUNDARY;
 
     vtkm::Vec<FieldType, 3> velocity;
-    ParticleStatus status = CheckStep(inpos, this->StepLength, time, velocity);
+    ParticleStatus status = CheckStep(inpos, this->StepLength, time, velocity, cellHint);
     if (status == ParticleStatus::STATUS_OK)
     {
       outpos = inpos + StepLength * velocity;
       time += StepLength;
     }
-    else
-    {
-      outpos = inpos;
-    }
     return status;
   }
 
@@ -90,10 +100,26 @@ public:
                                    FieldType& time,
                                    ParticleStatus status,
                                    vtkm::Vec<FieldType, 3>& outpos) const
+  {
+    vtkm::Id cellHint = -1;
+    return PushOutOfBoundary(inpos, numSteps, time, status, outpos, cellHint);
+  }
+
+  VTKM_EXEC
+  ParticleStatus PushOutOfBoundary(vtkm::Vec<FieldType, 3>& inpos,
+                                   vtkm::Id numSteps,
+                                   FieldType& time,
+                                   ParticleStatus status,
+                                   vtkm::Vec<FieldType, 3>& outpos,
+                                   vtkm::Id& cellHint) const
   {
     FieldType stepLength = StepLength;
     vtkm::Vec<FieldType, 3> velocity, currentVelocity;
-    CheckStep(inpos, 0.0f, time, currentVelocity);
+    // Without a velocity at the current position, e.g. in a hole of an
+    // unstructured mesh, the particle cannot be pushed anywhere.
+    outpos = inpos;
+    if (CheckStep(inpos, 0.0f, time, currentVelocity, cellHint) != ParticleStatus::STATUS_OK)
+      return ParticleStatus::EXITED_SPATIAL_BOUNDARY;
     numSteps = numSteps == 0 ? 1 : numSteps;
     if (MinimizeError)
     {
@@ -102,7 +128,7 @@ public:
       do
       {
         stepLength /= static_cast<FieldType>(2.0);
-        status = CheckStep(inpos, stepLength, time, velocity);
+        status = CheckStep(inpos, stepLength, time, velocity, cellHint);
         if (status == ParticleStatus::STATUS_OK)
         {
           outpos = inpos + stepLength * velocity;
@@ -154,10 +180,12 @@ public:
   ParticleStatus CheckStep(const vtkm::Vec<FieldType, 3>& inpos,
                            FieldType stepLength,
                            FieldType time,
-                           vtkm::Vec<FieldType, 3>& velocity) const
+                           vtkm::Vec<FieldType, 3>& velocity,
+                           vtkm::Id& cellHint) const
   {
     using ConcreteType = IntegratorType<FieldEvaluateType, FieldType>;
-    return static_cast<const ConcreteType*>(this)->CheckStep(inpos, stepLength, time, velocity);
+    return static_cast<const ConcreteType*>(this)->CheckStep(
+      inpos, stepLength, time, velocity, cellHint);
   }
 
   VTKM_EXEC_CONT
@@ -193,7 +221,8 @@ public:
   ParticleStatus CheckStep(const vtkm::Vec<FieldType, 3>& inpos,
                            FieldType stepLength,
                            FieldType time,
-                           vtkm::Vec<FieldType, 3>& velocity) const
+                           vtkm::Vec<FieldType, 3>& velocity,
+                           vtkm::Id& cellHint) const
   {
     FieldType var1 = (stepLength / static_cast<FieldType>(2));
     FieldType var2 = time + var1;
@@ -202,10 +231,10 @@ public:
     vtkm::Vec<FieldType, 3> k1 = vtkm::TypeTraits<vtkm::Vec<FieldType, 3>>::ZeroInitialization();
     vtkm::Vec<FieldType, 3> k2 = k1, k3 = k1, k4 = k1;
 
-    bool status1 = this->Evaluator.Evaluate(inpos, time, k1);
-    bool status2 = this->Evaluator.Evaluate(inpos + var1 * k1, var2, k2);
-    bool status3 = this->Evaluator.Evaluate(inpos + var1 * k2, var2, k3);
-    bool status4 = this->Evaluator.Evaluate(inpos + stepLength * k3, var3, k4);
+    bool status1 = this->Evaluator.Evaluate(inpos, time, k1, cellHint);
+    bool status2 = this->Evaluator.Evaluate(inpos + var1 * k1, var2, k2, cellHint);
+    bool status3 = this->Evaluator.Evaluate(inpos + var1 * k2, var2, k3, cellHint);
+    bool status4 = this->Evaluator.Evaluate(inpos + stepLength * k3, var3, k4, cellHint);
 
     if ((status1 & status2 & status3 & status4) == ParticleStatus::STATUS_OK)
     {
@@ -241,9 +270,10 @@ public:
   ParticleStatus CheckStep(const vtkm::Vec<FieldType, 3>& inpos,
                            FieldType vtkmNotUsed(stepLength),
                            FieldType time,
-                           vtkm::Vec<FieldType, 3>& velocity) const
+                           vtkm::Vec<FieldType, 3>& velocity,
+                           vtkm::Id& cellHint) const
   {
-    bool result = this->Evaluator.Evaluate(inpos, time, velocity);
+    bool result = this->Evaluator.Evaluate(inpos, time, velocity, cellHint);
     if (result)
       return ParticleStatus::STATUS_OK;
     else
@@ -53,9 +53,12 @@ public:
     vtkm::Vec<FieldType, 3> outpos;
     FieldType time = ic.GetTime(idx);
     ParticleStatus status;
+    // Cell found by the last evaluation along this particle's curve, so the
+    // next one can start its search there
+    vtkm::Id cellHint = -1;
     while (!ic.Done(idx))
     {
-      status = integrator.Step(inpos, time, outpos);
+      status = integrator.Step(inpos, time, outpos, cellHint);
       // If the status is OK, we only need to check if the particle
       // has completed the maximum steps required.
       if (status == ParticleStatus::STATUS_OK)
@@ -75,7 +78,7 @@ public:
           status == ParticleStatus::AT_TEMPORAL_BOUNDARY)
       {
         vtkm::Id numSteps = ic.GetStep(idx);
-        status = integrator.PushOutOfBoundary(inpos, numSteps, time, status, outpos);
+        status = integrator.PushOutOfBoundary(inpos, numSteps, time, status, outpos, cellHint);
         ic.TakeStep(idx, outpos, status);
         ic.SetTime(idx, time);
         if (status == ParticleStatus::EXITED_SPATIAL_BOUNDARY)
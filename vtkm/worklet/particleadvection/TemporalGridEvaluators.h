@@ -277,6 +277,15 @@ public:
     return true;
   }
 
+  VTKM_EXEC
+  bool Evaluate(const vtkm::Vec<FieldType, 3>& position,
+                const FieldType particleTime,
+                vtkm::Vec<FieldType, 3>& velocity,
+                vtkm::Id& vtkmNotUsed(cellHint)) const
+  {
+    return Evaluate(position, particleTime, velocity);
+  }
+
   VTKM_EXEC
   bool Evaluate(const vtkm::Vec<FieldType, 3>& position,
                 const FieldType particleTime,
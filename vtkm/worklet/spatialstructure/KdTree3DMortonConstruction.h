@@ -0,0 +1,498 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_KdTree3DMortonConstruction_h
+#define vtk_m_worklet_KdTree3DMortonConstruction_h
+
+#include <vtkm/BinaryOperators.h>
+#include <vtkm/Math.h>
+#include <vtkm/Swap.h>
+#include <vtkm/VectorAnalysis.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/ExecutionObjectBase.h>
+
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace spatialstructure
+{
+
+/// \brief Builds a compact 3D KD-tree from points presorted along a Morton curve.
+///
+/// The points are sorted once by their Morton code and cut into buckets of
+/// \c bucketSize consecutive points. The buckets are the leaves of a complete
+/// binary tree stored without pointers: node \c i has the children
+/// \c 2i+1 and \c 2i+2, and the leaves are the last nodes. Every node splits
+/// its points at their median along the curve, so the tree is balanced, and
+/// stores the bounding box of its points. The boxes are computed bottom up
+/// with one pass per level.
+///
+/// This replaces the three global sorts and the many full array passes per
+/// level of \c KdTree3DConstruction with one sort and a few small passes.
+///
+class KdTree3DMortonConstruction
+{
+public:
+  using BoundsHandle = vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 3>>;
+
+  VTKM_EXEC_CONT
+  static vtkm::UInt64 ExpandBits(vtkm::UInt64 x)
+  {
+    x &= 0x1FFFFF;
+    x = (x | x << 32) & 0x1F00000000FFFF;
+    x = (x | x << 16) & 0x1F0000FF0000FF;
+    x = (x | x << 8) & 0x100F00F00F00F00F;
+    x = (x | x << 4) & 0x10C30C30C30C30C3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+  }
+
+  /// 63 bit Morton code of a point, with 21 bits per axis.
+  template <typename CoordVecType>
+  VTKM_EXEC_CONT static vtkm::UInt64 MortonCode(const CoordVecType& coord,
+                                                const vtkm::Vec<vtkm::Float64, 3>& minCoord,
+                                                const vtkm::Vec<vtkm::Float64, 3>& inverseExtent)
+  {
+    vtkm::UInt64 code = 0;
+    for (vtkm::IdComponent d = 0; d < 3; ++d)
+    {
+      vtkm::Float64 scaled =
+        (static_cast<vtkm::Float64>(coord[d]) - minCoord[d]) * inverseExtent[d] * 2097152.0;
+      scaled = vtkm::Min(vtkm::Max(scaled, 0.0), 2097151.0);
+      code |= ExpandBits(static_cast<vtkm::UInt64>(scaled)) << d;
+    }
+    return code;
+  }
+
+  class ComputeMortonCodes : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn<> coord, FieldOut<> code);
+    using ExecutionSignature = void(_1, _2);
+
+    VTKM_CONT
+    ComputeMortonCodes(const vtkm::Vec<vtkm::Float64, 3>& minCoord,
+                       const vtkm::Vec<vtkm::Float64, 3>& inverseExtent)
+      : MinCoord(minCoord)
+      , InverseExtent(inverseExtent)
+    {
+    }
+
+    template <typename CoordVecType>
+    VTKM_EXEC void operator()(const CoordVecType& coord, vtkm::UInt64& code) const
+    {
+      code = MortonCode(coord, this->MinCoord, this->InverseExtent);
+    }
+
+  private:
+    vtkm::Vec<vtkm::Float64, 3> MinCoord;
+    vtkm::Vec<vtkm::Float64, 3> InverseExtent;
+  };
+
+  class LeafBounds : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn<> leafIndex,
+                                  WholeArrayIn<> pointIds,
+                                  WholeArrayIn<> coords,
+                                  WholeArrayOut<> nodeMin,
+                                  WholeArrayOut<> nodeMax);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5);
+
+    VTKM_CONT
+    LeafBounds(vtkm::Id bucketSize, vtkm::Id firstLeaf)
+      : BucketSize(bucketSize)
+      , FirstLeaf(firstLeaf)
+    {
+    }
+
+    template <typename IdPortalType,
+              typename CoordPortalType,
+              typename MinPortalType,
+              typename MaxPortalType>
+    VTKM_EXEC void operator()(vtkm::Id leafIndex,
+                              const IdPortalType& pointIds,
+                              const CoordPortalType& coords,
+                              const MinPortalType& nodeMin,
+                              const MaxPortalType& nodeMax) const
+    {
+      vtkm::Vec<vtkm::Float64, 3> boxMin(vtkm::Infinity64());
+      vtkm::Vec<vtkm::Float64, 3> boxMax(vtkm::NegativeInfinity64());
+      vtkm::Id start = leafIndex * this->BucketSize;
+      vtkm::Id end = vtkm::Min(start + this->BucketSize, pointIds.GetNumberOfValues());
+      for (vtkm::Id i = start; i < end; ++i)
+      {
+        vtkm::Vec<vtkm::Float64, 3> point(coords.Get(pointIds.Get(i)));
+        boxMin = vtkm::Min(boxMin, point);
+        boxMax = vtkm::Max(boxMax, point);
+      }
+      nodeMin.Set(this->FirstLeaf + leafIndex, boxMin);
+      nodeMax.Set(this->FirstLeaf + leafIndex, boxMax);
+    }
+
+  private:
+    vtkm::Id BucketSize;
+    vtkm::Id FirstLeaf;
+  };
+
+  class ParentBounds : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn<> nodeIndex,
+                                  WholeArrayInOut<> nodeMin,
+                                  WholeArrayInOut<> nodeMax);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    template <typename MinPortalType, typename MaxPortalType>
+    VTKM_EXEC void operator()(vtkm::Id node,
+                              const MinPortalType& nodeMin,
+                              const MaxPortalType& nodeMax) const
+    {
+      nodeMin.Set(node, vtkm::Min(nodeMin.Get(2 * node + 1), nodeMin.Get(2 * node + 2)));
+      nodeMax.Set(node, vtkm::Max(nodeMax.Get(2 * node + 1), nodeMax.Get(2 * node + 2)));
+    }
+  };
+
+  /// \brief Build the tree.
+  ///
+  /// Returns in \c pointId_Handle the point ids in Morton order and in
+  /// \c nodeMin_Handle and \c nodeMax_Handle the bounding boxes of the
+  /// nodes. Leaf \c j holds the points [j * bucketSize, (j + 1) * bucketSize)
+  /// of \c pointId_Handle and is node \c j + (number of nodes - 1) / 2.
+  /// Leaves past the last point have an empty box, with its minimum above its
+  /// maximum. \c mortonMin and \c mortonInverseExtent map the points to the
+  /// unit cube for their Morton codes.
+  ///
+  template <typename CoordType, typename CoordStorageTag, typename DeviceAdapter>
+  void Run(const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag>& coordi_Handle,
+           vtkm::Id bucketSize,
+           vtkm::cont::ArrayHandle<vtkm::Id>& pointId_Handle,
+           BoundsHandle& nodeMin_Handle,
+           BoundsHandle& nodeMax_Handle,
+           vtkm::Vec<vtkm::Float64, 3>& mortonMin,
+           vtkm::Vec<vtkm::Float64, 3>& mortonInverseExtent,
+           DeviceAdapter)
+  {
+    using Algorithm = vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>;
+    using CoordVecType = vtkm::Vec<CoordType, 3>;
+
+    if (bucketSize < 1)
+    {
+      throw vtkm::cont::ErrorBadValue("KD-tree bucket size must be positive.");
+    }
+
+    vtkm::Id numberOfPoints = coordi_Handle.GetNumberOfValues();
+    Algorithm::Copy(vtkm::cont::ArrayHandleCounting<vtkm::Id>(0, 1, numberOfPoints),
+                    pointId_Handle);
+    mortonMin = vtkm::Vec<vtkm::Float64, 3>(0.0);
+    mortonInverseExtent = vtkm::Vec<vtkm::Float64, 3>(0.0);
+    if (numberOfPoints < 1)
+    {
+      nodeMin_Handle.Allocate(0);
+      nodeMax_Handle.Allocate(0);
+      return;
+    }
+
+    CoordVecType first = coordi_Handle.GetPortalConstControl().Get(0);
+    vtkm::Vec<CoordVecType, 2> range = Algorithm::Reduce(
+      coordi_Handle, vtkm::make_Vec(first, first), vtkm::MinAndMax<CoordVecType>());
+    mortonMin = vtkm::Vec<vtkm::Float64, 3>(range[0]);
+    for (vtkm::IdComponent d = 0; d < 3; ++d)
+    {
+      vtkm::Float64 extent = static_cast<vtkm::Float64>(range[1][d]) - mortonMin[d];
+      mortonInverseExtent[d] = extent > 0.0 ? 1.0 / extent : 0.0;
+    }
+
+    {
+      vtkm::cont::ArrayHandle<vtkm::UInt64> mortonCodes;
+      vtkm::worklet::DispatcherMapField<ComputeMortonCodes, DeviceAdapter> mortonDispatcher(
+        ComputeMortonCodes(mortonMin, mortonInverseExtent));
+      mortonDispatcher.Invoke(coordi_Handle, mortonCodes);
+      Algorithm::SortByKey(mortonCodes, pointId_Handle);
+    }
+
+    vtkm::Id numberOfBuckets = (numberOfPoints + bucketSize - 1) / bucketSize;
+    vtkm::Id numberOfLeaves = 1;
+    while (numberOfLeaves < numberOfBuckets)
+    {
+      numberOfLeaves *= 2;
+    }
+    vtkm::Id firstLeaf = numberOfLeaves - 1;
+    nodeMin_Handle.Allocate(firstLeaf + numberOfLeaves);
+    nodeMax_Handle.Allocate(firstLeaf + numberOfLeaves);
+
+    vtkm::worklet::DispatcherMapField<LeafBounds, DeviceAdapter> leafDispatcher(
+      LeafBounds(bucketSize, firstLeaf));
+    leafDispatcher.Invoke(vtkm::cont::ArrayHandleCounting<vtkm::Id>(0, 1, numberOfLeaves),
+                          pointId_Handle,
+                          coordi_Handle,
+                          nodeMin_Handle,
+                          nodeMax_Handle);
+
+    vtkm::worklet::DispatcherMapField<ParentBounds, DeviceAdapter> parentDispatcher;
+    for (vtkm::Id levelSize = numberOfLeaves / 2; levelSize > 0; levelSize /= 2)
+    {
+      parentDispatcher.Invoke(
+        vtkm::cont::ArrayHandleCounting<vtkm::Id>(levelSize - 1, 1, levelSize),
+        nodeMin_Handle,
+        nodeMax_Handle);
+    }
+  }
+};
+
+/// \brief Execution side of a tree built by \c KdTree3DMortonConstruction.
+///
+/// Provides the same \c Traverse as \c KdTree3DExecution, so it works with the
+/// worklets of \c KdTree3DNeighborSearch. When the search starts without a
+/// bound, as a k-nearest-neighbor search does, the leaf that the Morton code of
+/// the query falls into is searched first to get a tight bound right away.
+/// Sibling boxes of a Morton ordered tree overlap, so without it the first
+/// leaf reached is often far from the query. Then the tree is traversed
+/// nearest box first, skipping boxes beyond the bound.
+///
+template <typename IdPortalType, typename BoundsPortalType, typename CoordPortalType>
+class KdTree3DMortonExecution
+{
+public:
+  /// Deepest tree that can be traversed.
+  ///
+  static constexpr vtkm::IdComponent MAX_DEPTH = 64;
+
+  KdTree3DMortonExecution() = default;
+
+  VTKM_CONT
+  KdTree3DMortonExecution(const IdPortalType& pointIds,
+                          const BoundsPortalType& nodeMin,
+                          const BoundsPortalType& nodeMax,
+                          const CoordPortalType& coords,
+                          vtkm::Id bucketSize,
+                          const vtkm::Vec<vtkm::Float64, 3>& mortonMin,
+                          const vtkm::Vec<vtkm::Float64, 3>& mortonInverseExtent)
+    : PointIds(pointIds)
+    , NodeMin(nodeMin)
+    , NodeMax(nodeMax)
+    , Coords(coords)
+    , BucketSize(bucketSize)
+    , MortonMin(mortonMin)
+    , MortonInverseExtent(mortonInverseExtent)
+  {
+  }
+
+  template <typename CoordVecType, typename VisitorType>
+  VTKM_EXEC void Traverse(const CoordVecType& qc, VisitorType& visitor) const
+  {
+    vtkm::Id numberOfNodes = this->NodeMin.GetNumberOfValues();
+    if (numberOfNodes < 1)
+    {
+      return;
+    }
+    vtkm::Id firstLeaf = numberOfNodes / 2;
+    vtkm::Vec<vtkm::Float64, 3> query(qc);
+
+    // only worth it when the search starts without a bound
+    vtkm::Id seedLeaf = -1;
+    if (!(static_cast<vtkm::Float64>(visitor.GetBound()) < vtkm::Infinity64()))
+    {
+      seedLeaf = firstLeaf + this->FindBucket(qc);
+      this->VisitLeaf(seedLeaf - firstLeaf, qc, visitor);
+    }
+
+    vtkm::Id stackNode[MAX_DEPTH + 1];
+    vtkm::Float64 stackDistance2[MAX_DEPTH + 1];
+    stackNode[0] = 0;
+    stackDistance2[0] = this->BoxDistance2(0, query);
+    vtkm::IdComponent top = 1;
+
+    while (top > 0)
+    {
+      --top;
+      vtkm::Id node = stackNode[top];
+      if (stackDistance2[top] > static_cast<vtkm::Float64>(visitor.GetBound()))
+      {
+        continue;
+      }
+
+      if (node >= firstLeaf)
+      { ///// leaf bucket
+        if (node != seedLeaf)
+        {
+          this->VisitLeaf(node - firstLeaf, qc, visitor);
+        }
+        continue;
+      }
+
+      vtkm::Id nearChild = 2 * node + 1;
+      vtkm::Id farChild = 2 * node + 2;
+      vtkm::Float64 nearDistance2 = this->BoxDistance2(nearChild, query);
+      vtkm::Float64 farDistance2 = this->BoxDistance2(farChild, query);
+      if (farDistance2 < nearDistance2)
+      {
+        vtkm::Swap(nearChild, farChild);
+        vtkm::Swap(nearDistance2, farDistance2);
+      }
+
+      if (top + 2 > MAX_DEPTH + 1)
+      { // cannot happen for a complete tree of fewer than 2^63 leaves
+        continue;
+      }
+      // push the far child first so that the near child is searched first
+      stackNode[top] = farChild;
+      stackDistance2[top] = farDistance2;
+      ++top;
+      stackNode[top] = nearChild;
+      stackDistance2[top] = nearDistance2;
+      ++top;
+    }
+  }
+
+private:
+  IdPortalType PointIds;
+  BoundsPortalType NodeMin;
+  BoundsPortalType NodeMax;
+  CoordPortalType Coords;
+  vtkm::Id BucketSize;
+  vtkm::Vec<vtkm::Float64, 3> MortonMin;
+  vtkm::Vec<vtkm::Float64, 3> MortonInverseExtent;
+
+  /// Bucket of the first point whose Morton code is not below the one of
+  /// \c qc, found by a binary search over the sorted points.
+  template <typename CoordVecType>
+  VTKM_EXEC vtkm::Id FindBucket(const CoordVecType& qc) const
+  {
+    vtkm::UInt64 code =
+      KdTree3DMortonConstruction::MortonCode(qc, this->MortonMin, this->MortonInverseExtent);
+    vtkm::Id low = 0;
+    vtkm::Id high = this->PointIds.GetNumberOfValues();
+    while (low < high)
+    {
+      vtkm::Id mid = low + (high - low) / 2;
+      vtkm::UInt64 midCode = KdTree3DMortonConstruction::MortonCode(
+        this->Coords.Get(this->PointIds.Get(mid)), this->MortonMin, this->MortonInverseExtent);
+      if (midCode < code)
+      {
+        low = mid + 1;
+      }
+      else
+      {
+        high = mid;
+      }
+    }
+    vtkm::Id lastBucket = (this->PointIds.GetNumberOfValues() - 1) / this->BucketSize;
+    return vtkm::Min(low / this->BucketSize, lastBucket);
+  }
+
+  template <typename CoordVecType, typename VisitorType>
+  VTKM_EXEC void VisitLeaf(vtkm::Id leaf, const CoordVecType& qc, VisitorType& visitor) const
+  {
+    using CoordType = typename CoordVecType::ComponentType;
+    vtkm::Id start = leaf * this->BucketSize;
+    vtkm::Id end = vtkm::Min(start + this->BucketSize, this->PointIds.GetNumberOfValues());
+    for (vtkm::Id i = start; i < end; ++i)
+    {
+      vtkm::Id pointId = this->PointIds.Get(i);
+      auto diff = this->Coords.Get(pointId) - qc;
+      visitor.Visit(
+        pointId,
+        static_cast<CoordType>(diff[0] * diff[0] + diff[1] * diff[1] + diff[2] * diff[2]));
+    }
+  }
+
+  /// Squared distance from the query to the box of a node, infinite for an
+  /// empty box.
+  VTKM_EXEC
+  vtkm::Float64 BoxDistance2(vtkm::Id node, const vtkm::Vec<vtkm::Float64, 3>& query) const
+  {
+    vtkm::Vec<vtkm::Float64, 3> boxMin = this->NodeMin.Get(node);
+    vtkm::Vec<vtkm::Float64, 3> boxMax = this->NodeMax.Get(node);
+    if (boxMin[0] > boxMax[0])
+    {
+      return vtkm::Infinity64();
+    }
+    vtkm::Vec<vtkm::Float64, 3> outside =
+      vtkm::Max(vtkm::Max(boxMin - query, query - boxMax), vtkm::Vec<vtkm::Float64, 3>(0.0));
+    return vtkm::dot(outside, outside);
+  }
+};
+
+/// \brief Gives worklets a \c KdTree3DMortonExecution of a tree and its points.
+///
+template <typename CoordHandleType>
+class KdTree3DMortonExecutionObject : public vtkm::cont::ExecutionObjectBase
+{
+public:
+  using BoundsHandle = KdTree3DMortonConstruction::BoundsHandle;
+
+  VTKM_CONT
+  KdTree3DMortonExecutionObject(const CoordHandleType& coordi_Handle,
+                                const vtkm::cont::ArrayHandle<vtkm::Id>& pointId_Handle,
+                                const BoundsHandle& nodeMin_Handle,
+                                const BoundsHandle& nodeMax_Handle,
+                                vtkm::Id bucketSize,
+                                const vtkm::Vec<vtkm::Float64, 3>& mortonMin,
+                                const vtkm::Vec<vtkm::Float64, 3>& mortonInverseExtent)
+    : Coordi_Handle(coordi_Handle)
+    , PointId_Handle(pointId_Handle)
+    , NodeMin_Handle(nodeMin_Handle)
+    , NodeMax_Handle(nodeMax_Handle)
+    , BucketSize(bucketSize)
+    , MortonMin(mortonMin)
+    , MortonInverseExtent(mortonInverseExtent)
+  {
+  }
+
+  VTKM_CONT
+  vtkm::Id GetNumberOfPoints() const { return this->PointId_Handle.GetNumberOfValues(); }
+
+  template <typename DeviceAdapter>
+  VTKM_CONT KdTree3DMortonExecution<
+    typename vtkm::cont::ArrayHandle<vtkm::Id>::template ExecutionTypes<DeviceAdapter>::PortalConst,
+    typename BoundsHandle::template ExecutionTypes<DeviceAdapter>::PortalConst,
+    typename CoordHandleType::template ExecutionTypes<DeviceAdapter>::PortalConst>
+    PrepareForExecution(DeviceAdapter) const
+  {
+    return { this->PointId_Handle.PrepareForInput(DeviceAdapter()),
+             this->NodeMin_Handle.PrepareForInput(DeviceAdapter()),
+             this->NodeMax_Handle.PrepareForInput(DeviceAdapter()),
+             this->Coordi_Handle.PrepareForInput(DeviceAdapter()),
+             this->BucketSize,
+             this->MortonMin,
+             this->MortonInverseExtent };
+  }
+
+private:
+  CoordHandleType Coordi_Handle;
+  vtkm::cont::ArrayHandle<vtkm::Id> PointId_Handle;
+  BoundsHandle NodeMin_Handle;
+  BoundsHandle NodeMax_Handle;
+  vtkm::Id BucketSize;
+  vtkm::Vec<vtkm::Float64, 3> MortonMin;
+  vtkm::Vec<vtkm::Float64, 3> MortonInverseExtent;
+};
+}
+}
+} // namespace vtkm::worklet::spatialstructure
+
+#endif // vtk_m_worklet_KdTree3DMortonConstruction_h
@@ -0,0 +1,389 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_KdTree3DNeighborSearch_h
+#define vtk_m_worklet_KdTree3DNeighborSearch_h
+
+#include <vtkm/Math.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleGroupVecVariable.h>
+#include <vtkm/cont/DeviceAdapterAlgorithm.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/ExecutionObjectBase.h>
+
+#include <vtkm/exec/internal/NeighborSearch.h>
+
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace spatialstructure
+{
+
+/// \brief Execution side of a 3D KD-tree built by \c KdTree3DConstruction.
+///
+/// The traversal is iterative with a small fixed stack, so unlike
+/// \c KdTree3DNNSearch it does not need a larger CUDA stack. Subtrees are
+/// visited near side first and skipped once the splitting plane is farther
+/// than the current search bound.
+///
+template <typename IdPortalType, typename CoordPortalType>
+class KdTree3DExecution
+{
+public:
+  /// Deepest tree that can be traversed. The tree splits every node at its
+  /// median, so its depth is about log2 of the number of points.
+  ///
+  static constexpr vtkm::IdComponent MAX_DEPTH = 64;
+
+  KdTree3DExecution() = default;
+
+  VTKM_CONT
+  KdTree3DExecution(const IdPortalType& treePortal,
+                    const IdPortalType& splitIdPortal,
+                    const CoordPortalType& coordiPortal)
+    : TreePortal(treePortal)
+    , SplitIdPortal(splitIdPortal)
+    , CoordiPortal(coordiPortal)
+  {
+  }
+
+  /// Visits every point of the tree that can lie within the bound of
+  /// \c visitor. The visitor provides the current squared search distance
+  /// with \c GetBound() and receives candidates with \c Visit(id, distance2).
+  ///
+  template <typename CoordVecType, typename VisitorType>
+  VTKM_EXEC void Traverse(const CoordVecType& qc, VisitorType& visitor) const
+  {
+    using CoordType = typename CoordVecType::ComponentType;
+
+    vtkm::Id numberOfPoints = this->TreePortal.GetNumberOfValues();
+    if (numberOfPoints < 1)
+    {
+      return;
+    }
+
+    vtkm::Id stackStart[MAX_DEPTH + 1];
+    vtkm::Id stackEnd[MAX_DEPTH + 1];
+    vtkm::IdComponent stackLevel[MAX_DEPTH + 1];
+    CoordType stackDistance2[MAX_DEPTH + 1];
+
+    stackStart[0] = 0;
+    stackEnd[0] = numberOfPoints;
+    stackLevel[0] = 0;
+    stackDistance2[0] = CoordType(0);
+    vtkm::IdComponent top = 1;
+
+    while (top > 0)
+    {
+      --top;
+      vtkm::Id sIdx = stackStart[top];
+      vtkm::Id tIdx = stackEnd[top];
+      vtkm::IdComponent level = stackLevel[top];
+      if (stackDistance2[top] > visitor.GetBound())
+      {
+        continue;
+      }
+
+      if (tIdx - sIdx == 1)
+      { ///// leaf node
+        vtkm::Id leafNodeIdx = this->TreePortal.Get(sIdx);
+        auto diff = this->CoordiPortal.Get(leafNodeIdx) - qc;
+        visitor.Visit(leafNodeIdx,
+                      static_cast<CoordType>(diff[0] * diff[0] + diff[1] * diff[1] +
+                                             diff[2] * diff[2]));
+        continue;
+      }
+
+      // Points in [sIdx, splitNodeLoc) are at or below the split point along
+      // the axis of this level, points in [splitNodeLoc, tIdx) at or above it.
+      vtkm::Id splitNodeLoc = (sIdx + tIdx + 1) / 2;
+      vtkm::IdComponent axis = level % 3;
+      CoordType planeDistance = static_cast<CoordType>(
+        qc[axis] - this->CoordiPortal.Get(this->SplitIdPortal.Get(splitNodeLoc))[axis]);
+
+      vtkm::Id nearStart = sIdx, nearEnd = splitNodeLoc;
+      vtkm::Id farStart = splitNodeLoc, farEnd = tIdx;
+      if (planeDistance > CoordType(0))
+      {
+        nearStart = splitNodeLoc;
+        nearEnd = tIdx;
+        farStart = sIdx;
+        farEnd = splitNodeLoc;
+      }
+
+      if (top + 2 > MAX_DEPTH + 1)
+      { // cannot happen for a median split tree of fewer than 2^63 points
+        continue;
+      }
+      // push the far side first so that the near side is searched first
+      stackStart[top] = farStart;
+      stackEnd[top] = farEnd;
+      stackLevel[top] = level + 1;
+      stackDistance2[top] = planeDistance * planeDistance;
+      ++top;
+      stackStart[top] = nearStart;
+      stackEnd[top] = nearEnd;
+      stackLevel[top] = level + 1;
+      stackDistance2[top] = CoordType(0);
+      ++top;
+    }
+  }
+
+private:
+  IdPortalType TreePortal;
+  IdPortalType SplitIdPortal;
+  CoordPortalType CoordiPortal;
+};
+
+/// \brief Gives worklets a \c KdTree3DExecution of a tree and its points.
+///
+template <typename CoordHandleType>
+class KdTree3DExecutionObject : public vtkm::cont::ExecutionObjectBase
+{
+public:
+  VTKM_CONT
+  KdTree3DExecutionObject(const CoordHandleType& coordi_Handle,
+                          const vtkm::cont::ArrayHandle<vtkm::Id>& pointId_Handle,
+                          const vtkm::cont::ArrayHandle<vtkm::Id>& splitId_Handle)
+    : Coordi_Handle(coordi_Handle)
+    , PointId_Handle(pointId_Handle)
+    , SplitId_Handle(splitId_Handle)
+  {
+  }
+
+  VTKM_CONT
+  vtkm::Id GetNumberOfPoints() const { return this->PointId_Handle.GetNumberOfValues(); }
+
+  template <typename DeviceAdapter>
+  VTKM_CONT KdTree3DExecution<
+    typename vtkm::cont::ArrayHandle<vtkm::Id>::template ExecutionTypes<DeviceAdapter>::PortalConst,
+    typename CoordHandleType::template ExecutionTypes<DeviceAdapter>::PortalConst>
+    PrepareForExecution(DeviceAdapter) const
+  {
+    return { this->PointId_Handle.PrepareForInput(DeviceAdapter()),
+             this->SplitId_Handle.PrepareForInput(DeviceAdapter()),
+             this->Coordi_Handle.PrepareForInput(DeviceAdapter()) };
+  }
+
+private:
+  CoordHandleType Coordi_Handle;
+  vtkm::cont::ArrayHandle<vtkm::Id> PointId_Handle;
+  vtkm::cont::ArrayHandle<vtkm::Id> SplitId_Handle;
+};
+
+/// \brief k-nearest-neighbor and fixed-radius queries on a 3D KD-tree.
+///
+/// The worklets take the tree as an execution object that provides
+/// \c Traverse(queryPoint, visitor), such as \c KdTree3DExecutionObject.
+///
+class KdTree3DNeighborSearch
+{
+public:
+  class KNearestNeighborSearch3DWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn<> qcIn,
+                                  ExecObject tree,
+                                  WholeArrayOut<> knnIdOut,
+                                  WholeArrayOut<> knnDisOut);
+    using ExecutionSignature = void(_1, _2, _3, _4, WorkIndex);
+
+    VTKM_CONT
+    KNearestNeighborSearch3DWorklet(vtkm::Id k)
+      : K(k)
+    {
+    }
+
+    template <typename CoordiVecType,
+              typename TreeType,
+              typename OutIdPortalType,
+              typename OutDisPortalType>
+    VTKM_EXEC void operator()(const CoordiVecType& qc,
+                              const TreeType& tree,
+                              const OutIdPortalType& knnIdPortal,
+                              const OutDisPortalType& knnDisPortal,
+                              vtkm::Id queryIndex) const
+    {
+      using HeapType = vtkm::exec::internal::NeighborHeap<OutIdPortalType, OutDisPortalType>;
+      vtkm::Id offset = queryIndex * this->K;
+      HeapType heap(knnIdPortal, knnDisPortal, offset, this->K);
+      vtkm::exec::internal::KNearestVisitor<HeapType> visitor{ heap };
+      tree.Traverse(qc, visitor);
+      heap.Finish();
+
+      for (vtkm::Id i = offset; i < offset + this->K; ++i)
+      {
+        knnDisPortal.Set(i, vtkm::Sqrt(knnDisPortal.Get(i)));
+      }
+    }
+
+  private:
+    vtkm::Id K;
+  };
+
+  class RadiusCount3DWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn<> qcIn, ExecObject tree, FieldOut<> countOut);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    VTKM_CONT
+    RadiusCount3DWorklet(vtkm::Float64 radius)
+      : Radius(radius)
+    {
+    }
+
+    template <typename CoordiVecType, typename TreeType>
+    VTKM_EXEC void operator()(const CoordiVecType& qc,
+                              const TreeType& tree,
+                              vtkm::IdComponent& count) const
+    {
+      using CoordType = typename CoordiVecType::ComponentType;
+      CoordType radius = static_cast<CoordType>(this->Radius);
+      vtkm::exec::internal::RadiusCountVisitor<CoordType> visitor{ radius * radius, 0 };
+      tree.Traverse(qc, visitor);
+      count = visitor.Count;
+    }
+
+  private:
+    vtkm::Float64 Radius;
+  };
+
+  class RadiusFill3DWorklet : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    using ControlSignature = void(FieldIn<> qcIn,
+                                  FieldIn<> offsetIn,
+                                  ExecObject tree,
+                                  WholeArrayOut<> neighborIdOut,
+                                  WholeArrayOut<> neighborDisOut);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5);
+
+    VTKM_CONT
+    RadiusFill3DWorklet(vtkm::Float64 radius)
+      : Radius(radius)
+    {
+    }
+
+    template <typename CoordiVecType,
+              typename TreeType,
+              typename OutIdPortalType,
+              typename OutDisPortalType>
+    VTKM_EXEC void operator()(const CoordiVecType& qc,
+                              vtkm::Id offset,
+                              const TreeType& tree,
+                              const OutIdPortalType& neighborIdPortal,
+                              const OutDisPortalType& neighborDisPortal) const
+    {
+      using CoordType = typename CoordiVecType::ComponentType;
+      CoordType radius = static_cast<CoordType>(this->Radius);
+      vtkm::exec::internal::RadiusFillVisitor<OutIdPortalType, OutDisPortalType> visitor{
+        radius * radius, offset, neighborIdPortal, neighborDisPortal
+      };
+      tree.Traverse(qc, visitor);
+
+      for (vtkm::Id i = offset; i < visitor.Offset; ++i)
+      {
+        neighborDisPortal.Set(i, vtkm::Sqrt(neighborDisPortal.Get(i)));
+      }
+    }
+
+  private:
+    vtkm::Float64 Radius;
+  };
+
+  /// \brief Find the \c k nearest neighbors of each query point.
+  ///
+  /// \c k is clamped to the number of points in the tree. The neighbors of
+  /// query \c i are stored in entries [i * k, (i + 1) * k) of
+  /// \c knnId_Handle and \c knnDis_Handle, sorted by increasing distance.
+  /// Returns the clamped \c k.
+  ///
+  template <typename TreeType, typename CoordType, typename CoordStorageTag, typename DeviceAdapter>
+  vtkm::Id RunKNearest(
+    TreeType& tree,
+    const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag>& qc_Handle,
+    vtkm::Id k,
+    vtkm::cont::ArrayHandle<vtkm::Id>& knnId_Handle,
+    vtkm::cont::ArrayHandle<CoordType>& knnDis_Handle,
+    DeviceAdapter)
+  {
+    if (k < 0)
+    {
+      throw vtkm::cont::ErrorBadValue("Number of nearest neighbors must not be negative.");
+    }
+    k = vtkm::Min(k, tree.GetNumberOfPoints());
+
+    knnId_Handle.Allocate(qc_Handle.GetNumberOfValues() * k);
+    knnDis_Handle.Allocate(qc_Handle.GetNumberOfValues() * k);
+
+    KNearestNeighborSearch3DWorklet knnWorklet(k);
+    vtkm::worklet::DispatcherMapField<KNearestNeighborSearch3DWorklet, DeviceAdapter>
+      knnDispatcher(knnWorklet);
+    knnDispatcher.Invoke(qc_Handle, tree, knnId_Handle, knnDis_Handle);
+    return k;
+  }
+
+  /// \brief Find all neighbors within \c radius of each query point.
+  ///
+  /// The neighbor lists are returned in compressed sparse row form. The
+  /// number of neighbors of each query is counted first, the counts are
+  /// scanned into \c offsets_Handle and a second pass writes the neighbors of
+  /// query \c i starting at its offset into \c neighborId_Handle and
+  /// \c neighborDis_Handle. The neighbors of a query are not ordered by
+  /// distance. \c numNeighbors_Handle holds the number of neighbors of each
+  /// query, so the two arrays can be given to \c ArrayHandleGroupVecVariable.
+  ///
+  template <typename TreeType, typename CoordType, typename CoordStorageTag, typename DeviceAdapter>
+  void RunRadius(TreeType& tree,
+                 const vtkm::cont::ArrayHandle<vtkm::Vec<CoordType, 3>, CoordStorageTag>& qc_Handle,
+                 vtkm::Float64 radius,
+                 vtkm::cont::ArrayHandle<vtkm::IdComponent>& numNeighbors_Handle,
+                 vtkm::cont::ArrayHandle<vtkm::Id>& offsets_Handle,
+                 vtkm::cont::ArrayHandle<vtkm::Id>& neighborId_Handle,
+                 vtkm::cont::ArrayHandle<CoordType>& neighborDis_Handle,
+                 DeviceAdapter device)
+  {
+    RadiusCount3DWorklet countWorklet(radius);
+    vtkm::worklet::DispatcherMapField<RadiusCount3DWorklet, DeviceAdapter> countDispatcher(
+      countWorklet);
+    countDispatcher.Invoke(qc_Handle, tree, numNeighbors_Handle);
+
+    vtkm::Id totalNeighbors;
+    vtkm::cont::ConvertNumComponentsToOffsets(
+      numNeighbors_Handle, offsets_Handle, totalNeighbors, device);
+
+    neighborId_Handle.Allocate(totalNeighbors);
+    neighborDis_Handle.Allocate(totalNeighbors);
+
+    RadiusFill3DWorklet fillWorklet(radius);
+    vtkm::worklet::DispatcherMapField<RadiusFill3DWorklet, DeviceAdapter> fillDispatcher(
+      fillWorklet);
+    fillDispatcher.Invoke(qc_Handle, offsets_Handle, tree, neighborId_Handle, neighborDis_Handle);
+  }
+};
+}
+}
+} // namespace vtkm::worklet::spatialstructure
+
+#endif // vtk_m_worklet_KdTree3DNeighborSearch_h
@@ -0,0 +1,139 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_statistics_Moments_h
+#define vtk_m_worklet_statistics_Moments_h
+
+#include <vtkm/Math.h>
+#include <vtkm/Types.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace statistics
+{
+
+// Count, extremes, mean and sums of powers of the differences from the mean
+// (M2, M3, M4) of a set of values. Two sets are combined with the pairwise
+// update formulas of Pebay (SAND2008-6212), so the moments of an array are
+// computed with a single parallel Reduce, and those of blocks or ranks are
+// merged without revisiting the values.
+struct Moments
+{
+  vtkm::Float64 Count;
+  vtkm::Float64 Minimum;
+  vtkm::Float64 Maximum;
+  vtkm::Float64 Mean;
+  vtkm::Float64 M2;
+  vtkm::Float64 M3;
+  vtkm::Float64 M4;
+
+  VTKM_EXEC_CONT
+  Moments()
+    : Count(0)
+    , Minimum(vtkm::Infinity64())
+    , Maximum(vtkm::NegativeInfinity64())
+    , Mean(0)
+    , M2(0)
+    , M3(0)
+    , M4(0)
+  {
+  }
+
+  VTKM_EXEC_CONT
+  explicit Moments(vtkm::Float64 value)
+    : Count(1)
+    , Minimum(value)
+    , Maximum(value)
+    , Mean(value)
+    , M2(0)
+    , M3(0)
+    , M4(0)
+  {
+  }
+
+  VTKM_EXEC_CONT
+  vtkm::Float64 GetVariance() const { return (this->Count > 0) ? this->M2 / this->Count : 0; }
+
+  VTKM_EXEC_CONT
+  vtkm::Float64 GetSkewness() const
+  {
+    return (this->M2 > 0) ? vtkm::Sqrt(this->Count) * this->M3 / vtkm::Pow(this->M2, 1.5) : 0;
+  }
+
+  // Kurtosis (not the excess kurtosis), E[(x - mean)^4] / variance^2
+  VTKM_EXEC_CONT
+  vtkm::Float64 GetKurtosis() const
+  {
+    return (this->M2 > 0) ? this->Count * this->M4 / (this->M2 * this->M2) : 0;
+  }
+};
+
+// Moments of a single value, applied through an ArrayHandleTransform.
+struct MakeMoments
+{
+  template <typename T>
+  VTKM_EXEC_CONT Moments operator()(const T& value) const
+  {
+    return Moments(static_cast<vtkm::Float64>(value));
+  }
+};
+
+// Moments of the union of two sets of values.
+struct CombineMoments
+{
+  VTKM_EXEC_CONT
+  Moments operator()(const Moments& a, const Moments& b) const
+  {
+    if (a.Count == 0)
+    {
+      return b;
+    }
+    if (b.Count == 0)
+    {
+      return a;
+    }
+
+    const vtkm::Float64 na = a.Count;
+    const vtkm::Float64 nb = b.Count;
+    const vtkm::Float64 n = na + nb;
+    const vtkm::Float64 delta = b.Mean - a.Mean;
+    const vtkm::Float64 deltaN = delta / n;
+    const vtkm::Float64 deltaN2 = deltaN * deltaN;
+    const vtkm::Float64 term = delta * deltaN * na * nb;
+
+    Moments result;
+    result.Count = n;
+    result.Minimum = vtkm::Min(a.Minimum, b.Minimum);
+    result.Maximum = vtkm::Max(a.Maximum, b.Maximum);
+    result.Mean = a.Mean + nb * deltaN;
+    result.M2 = a.M2 + b.M2 + term;
+    result.M3 =
+      a.M3 + b.M3 + term * deltaN * (na - nb) + 3.0 * deltaN * (na * b.M2 - nb * a.M2);
+    result.M4 = a.M4 + b.M4 + term * deltaN2 * (na * na - na * nb + nb * nb) +
+      6.0 * deltaN2 * (na * na * b.M2 + nb * nb * a.M2) + 4.0 * deltaN * (na * b.M3 - nb * a.M3);
+    return result;
+  }
+};
+}
+}
+} // namespace vtkm::worklet::statistics
+
+#endif // vtk_m_worklet_statistics_Moments_h
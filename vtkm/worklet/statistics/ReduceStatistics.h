@@ -0,0 +1,195 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_statistics_ReduceStatistics_h
+#define vtk_m_worklet_statistics_ReduceStatistics_h
+
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/worklet/StreamingStatistics.h>
+
+// clang-format off
+VTKM_THIRDPARTY_PRE_INCLUDE
+#include <vtkm/thirdparty/diy/Configure.h>
+#include VTKM_DIY(diy/decomposition.hpp)
+#include VTKM_DIY(diy/master.hpp)
+#include VTKM_DIY(diy/partners/broadcast.hpp)
+#include VTKM_DIY(diy/partners/merge.hpp)
+#include VTKM_DIY(diy/reduce.hpp)
+#include VTKM_DIY(diy/serialization.hpp)
+VTKM_THIRDPARTY_POST_INCLUDE
+// clang-format on
+
+namespace diy
+{
+template <>
+struct Serialization<vtkm::worklet::statistics::TDigest>
+{
+  static void save(BinaryBuffer& bb, const vtkm::worklet::statistics::TDigest& digest)
+  {
+    diy::save(bb, digest.GetCompression());
+    diy::save(bb, digest.GetMinimum());
+    diy::save(bb, digest.GetMaximum());
+    diy::save(bb, digest.GetCentroids());
+  }
+
+  static void load(BinaryBuffer& bb, vtkm::worklet::statistics::TDigest& digest)
+  {
+    vtkm::Float64 compression;
+    vtkm::Float64 minimum;
+    vtkm::Float64 maximum;
+    std::vector<vtkm::worklet::statistics::TDigest::Centroid> centroids;
+    diy::load(bb, compression);
+    diy::load(bb, minimum);
+    diy::load(bb, maximum);
+    diy::load(bb, centroids);
+    digest = vtkm::worklet::statistics::TDigest(compression, minimum, maximum, centroids);
+  }
+};
+
+template <>
+struct Serialization<vtkm::worklet::StreamingStatistics>
+{
+  static void save(BinaryBuffer& bb, const vtkm::worklet::StreamingStatistics& stats)
+  {
+    diy::save(bb, stats.GetNumberOfSketchBins());
+    diy::save(bb, stats.GetMoments());
+    diy::save(bb, stats.GetDigest());
+  }
+
+  static void load(BinaryBuffer& bb, vtkm::worklet::StreamingStatistics& stats)
+  {
+    vtkm::Id numberOfSketchBins;
+    vtkm::worklet::statistics::Moments moments;
+    vtkm::worklet::statistics::TDigest digest;
+    diy::load(bb, numberOfSketchBins);
+    diy::load(bb, moments);
+    diy::load(bb, digest);
+    stats = vtkm::worklet::StreamingStatistics(moments, digest, numberOfSketchBins);
+  }
+};
+} // namespace diy
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace statistics
+{
+namespace detail
+{
+// Merges the accumulators received from the partners of a block and sends
+// the result on.
+struct MergeStatistics
+{
+  void operator()(vtkm::worklet::StreamingStatistics* stats,
+                  const diy::ReduceProxy& srp,
+                  const diy::RegularMergePartners&) const
+  {
+    const int selfid = srp.gid();
+    std::vector<int> incoming;
+    srp.incoming(incoming);
+    for (const int gid : incoming)
+    {
+      if (gid != selfid)
+      {
+        vtkm::worklet::StreamingStatistics in;
+        srp.dequeue(gid, in);
+        stats->Merge(in);
+      }
+    }
+
+    for (int cc = 0; cc < srp.out_link().size(); ++cc)
+    {
+      auto target = srp.out_link().target(cc);
+      if (target.gid != selfid)
+      {
+        srp.enqueue(target, *stats);
+      }
+    }
+  }
+};
+
+// Replaces the accumulator of a block by the merged one and sends it on.
+struct BroadcastStatistics
+{
+  void operator()(vtkm::worklet::StreamingStatistics* stats,
+                  const diy::ReduceProxy& srp,
+                  const diy::RegularMergePartners&) const
+  {
+    const int selfid = srp.gid();
+    std::vector<int> incoming;
+    srp.incoming(incoming);
+    for (const int gid : incoming)
+    {
+      if (gid != selfid)
+      {
+        srp.dequeue(gid, *stats);
+      }
+    }
+
+    for (int cc = 0; cc < srp.out_link().size(); ++cc)
+    {
+      auto target = srp.out_link().target(cc);
+      if (target.gid != selfid)
+      {
+        srp.enqueue(target, *stats);
+      }
+    }
+  }
+};
+} // namespace detail
+
+// Merge the accumulators of all ranks of the communicator of the
+// EnvironmentTracker. Every rank gets the statistics of all the values.
+inline vtkm::worklet::StreamingStatistics ReduceStatistics(
+  const vtkm::worklet::StreamingStatistics& local)
+{
+  using StatisticsType = vtkm::worklet::StreamingStatistics;
+
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  if (comm.size() == 1)
+  {
+    return local;
+  }
+
+  diy::Master master(comm,
+                     /*threads*/ 1,
+                     /*limit*/ -1,
+                     []() -> void* { return new StatisticsType(); },
+                     [](void* ptr) { delete static_cast<StatisticsType*>(ptr); });
+
+  diy::ContiguousAssigner assigner(comm.size(), comm.size());
+  diy::RegularDecomposer<diy::DiscreteBounds> decomposer(
+    1, diy::interval(0, comm.size() - 1), comm.size());
+  decomposer.decompose(comm.rank(), assigner, master);
+  *master.block<StatisticsType>(0) = local;
+
+  // reduce to block-0, then broadcast back.
+  diy::RegularMergePartners mergePartners(decomposer, /*k=*/2);
+  diy::reduce(master, assigner, mergePartners, detail::MergeStatistics());
+  diy::RegularBroadcastPartners broadcastPartners(decomposer, /*k=*/2);
+  diy::reduce(master, assigner, broadcastPartners, detail::BroadcastStatistics());
+
+  return *master.block<StatisticsType>(0);
+}
+}
+}
+} // namespace vtkm::worklet::statistics
+
+#endif // vtk_m_worklet_statistics_ReduceStatistics_h
@@ -0,0 +1,226 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_statistics_TDigest_h
+#define vtk_m_worklet_statistics_TDigest_h
+
+#include <vtkm/Math.h>
+#include <vtkm/Types.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace statistics
+{
+
+// A merging t-digest (Dunning and Ertl, "Computing extremely accurate
+// quantiles using t-digests") for approximate quantiles. The distribution is
+// summarized by at most a few times Compression weighted centroids, which are
+// small near the tails so extreme quantiles stay accurate. Digests of blocks
+// or ranks are merged by pooling and re-compressing their centroids.
+class TDigest
+{
+public:
+  struct Centroid
+  {
+    vtkm::Float64 Mean;
+    vtkm::Float64 Weight;
+
+    bool operator<(const Centroid& other) const { return this->Mean < other.Mean; }
+  };
+
+  VTKM_CONT
+  TDigest(vtkm::Float64 compression = 100)
+    : Compression(compression)
+    , TotalWeight(0)
+    , Minimum(vtkm::Infinity64())
+    , Maximum(vtkm::NegativeInfinity64())
+  {
+  }
+
+  // Rebuild a digest from the state of another one, e.g. sent by another rank.
+  VTKM_CONT
+  TDigest(vtkm::Float64 compression,
+          vtkm::Float64 minimum,
+          vtkm::Float64 maximum,
+          const std::vector<Centroid>& centroids)
+    : Compression(compression)
+    , TotalWeight(0)
+    , Minimum(minimum)
+    , Maximum(maximum)
+    , Centroids(centroids)
+  {
+    for (const Centroid& centroid : this->Centroids)
+    {
+      this->TotalWeight += centroid.Weight;
+    }
+    this->Compress();
+  }
+
+  VTKM_CONT
+  vtkm::Float64 GetCompression() const { return this->Compression; }
+
+  VTKM_CONT
+  vtkm::Float64 GetTotalWeight() const { return this->TotalWeight; }
+
+  VTKM_CONT
+  vtkm::Float64 GetMinimum() const { return this->Minimum; }
+
+  VTKM_CONT
+  vtkm::Float64 GetMaximum() const { return this->Maximum; }
+
+  VTKM_CONT
+  const std::vector<Centroid>& GetCentroids() const { return this->Centroids; }
+
+  // Add weight at value mean. Call Compress once all values are added.
+  VTKM_CONT
+  void Add(vtkm::Float64 mean, vtkm::Float64 weight)
+  {
+    if (weight <= 0)
+    {
+      return;
+    }
+    this->Centroids.push_back(Centroid{ mean, weight });
+    this->TotalWeight += weight;
+    this->ExtendRange(mean, mean);
+  }
+
+  // Exact extremes of the values summarized by the centroids.
+  VTKM_CONT
+  void ExtendRange(vtkm::Float64 minimum, vtkm::Float64 maximum)
+  {
+    this->Minimum = vtkm::Min(this->Minimum, minimum);
+    this->Maximum = vtkm::Max(this->Maximum, maximum);
+  }
+
+  VTKM_CONT
+  void Merge(const TDigest& other)
+  {
+    this->Centroids.insert(
+      this->Centroids.end(), other.Centroids.begin(), other.Centroids.end());
+    this->TotalWeight += other.TotalWeight;
+    this->ExtendRange(other.Minimum, other.Maximum);
+    this->Compress();
+  }
+
+  // Sort the centroids and merge neighbours as long as the merged centroid
+  // spans less than one unit of the k1 scale function
+  // k(q) = Compression / (2 pi) * asin(2q - 1).
+  VTKM_CONT
+  void Compress()
+  {
+    if (this->Centroids.size() < 2)
+    {
+      return;
+    }
+    std::sort(this->Centroids.begin(), this->Centroids.end());
+
+    std::vector<Centroid> merged;
+    merged.reserve(static_cast<std::size_t>(2 * this->Compression));
+    Centroid current = this->Centroids[0];
+    vtkm::Float64 weightSoFar = 0;
+    vtkm::Float64 weightLimit = this->TotalWeight * this->NextQuantileLimit(0);
+    for (std::size_t i = 1; i < this->Centroids.size(); i++)
+    {
+      const Centroid& next = this->Centroids[i];
+      if (weightSoFar + current.Weight + next.Weight <= weightLimit)
+      {
+        current.Weight += next.Weight;
+        current.Mean += (next.Mean - current.Mean) * next.Weight / current.Weight;
+      }
+      else
+      {
+        weightSoFar += current.Weight;
+        merged.push_back(current);
+        weightLimit = this->TotalWeight * this->NextQuantileLimit(weightSoFar / this->TotalWeight);
+        current = next;
+      }
+    }
+    merged.push_back(current);
+    this->Centroids.swap(merged);
+  }
+
+  // Approximate value below which a fraction q of the weight lies,
+  // interpolating between the centers of the (compressed) centroids.
+  VTKM_CONT
+  vtkm::Float64 GetQuantile(vtkm::Float64 q) const
+  {
+    if (this->Centroids.empty())
+    {
+      return vtkm::Nan64();
+    }
+    q = vtkm::Max(0.0, vtkm::Min(1.0, q));
+    const vtkm::Float64 target = q * this->TotalWeight;
+
+    const Centroid& first = this->Centroids.front();
+    if (target < first.Weight / 2)
+    {
+      return this->Minimum + (first.Mean - this->Minimum) * target / (first.Weight / 2);
+    }
+
+    vtkm::Float64 center = first.Weight / 2;
+    for (std::size_t i = 1; i < this->Centroids.size(); i++)
+    {
+      const Centroid& previous = this->Centroids[i - 1];
+      const Centroid& next = this->Centroids[i];
+      const vtkm::Float64 nextCenter = center + (previous.Weight + next.Weight) / 2;
+      if (target < nextCenter)
+      {
+        const vtkm::Float64 t = (target - center) / (nextCenter - center);
+        return previous.Mean + t * (next.Mean - previous.Mean);
+      }
+      center = nextCenter;
+    }
+
+    const Centroid& last = this->Centroids.back();
+    const vtkm::Float64 tailWeight = this->TotalWeight - center;
+    if (tailWeight <= 0)
+    {
+      return this->Maximum;
+    }
+    return last.Mean + (this->Maximum - last.Mean) * (target - center) / tailWeight;
+  }
+
+private:
+  VTKM_CONT
+  vtkm::Float64 NextQuantileLimit(vtkm::Float64 q) const
+  {
+    const vtkm::Float64 k = this->Compression / vtkm::TwoPi() * vtkm::ASin(2 * q - 1);
+    if (k + 1 >= this->Compression / 4)
+    {
+      return 1;
+    }
+    return (vtkm::Sin(vtkm::TwoPi() * (k + 1) / this->Compression) + 1) / 2;
+  }
+
+  vtkm::Float64 Compression;
+  vtkm::Float64 TotalWeight;
+  vtkm::Float64 Minimum;
+  vtkm::Float64 Maximum;
+  std::vector<Centroid> Centroids;
+};
+}
+}
+} // namespace vtkm::worklet::statistics
+
+#endif // vtk_m_worklet_statistics_TDigest_h
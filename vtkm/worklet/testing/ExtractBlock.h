@@ -0,0 +1,53 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_testing_ExtractBlock_h
+#define vtk_m_worklet_testing_ExtractBlock_h
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace testing
+{
+
+// Copy the values [begin, end) of an array, to split test data into blocks
+// that are processed separately and then merged.
+template <typename T, typename Storage>
+inline vtkm::cont::ArrayHandle<T> ExtractBlock(const vtkm::cont::ArrayHandle<T, Storage>& values,
+                                               vtkm::Id begin,
+                                               vtkm::Id end)
+{
+  vtkm::cont::ArrayHandle<T> block;
+  vtkm::cont::ArrayCopy(
+    vtkm::cont::make_ArrayHandlePermutation(
+      vtkm::cont::make_ArrayHandleCounting(begin, vtkm::Id(1), end - begin), values),
+    block);
+  return block;
+}
+}
+}
+} // namespace vtkm::worklet::testing
+
+#endif // vtk_m_worklet_testing_ExtractBlock_h
@@ -0,0 +1,89 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+#ifndef vtk_m_worklet_testing_GridSimplices_h
+#define vtk_m_worklet_testing_GridSimplices_h
+
+#include <vtkm/CellShape.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/CellSetSingleType.h>
+
+#include <vector>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace testing
+{
+
+// Splits the squares or cubes of a 5x5 or 5x5x5 grid into triangles or tetrahedra along
+// their diagonal from the lowest to the highest corner, which is the triangulation the
+// regular meshes use
+inline vtkm::cont::CellSetSingleType<> MakeGridSimplices(bool is3D)
+{
+  const vtkm::Id dim = 5;
+  vtkm::Id nSlices = is3D ? dim : 1;
+  vtkm::Id3 step(1, dim, dim * dim);
+
+  std::vector<vtkm::Id> connectivity;
+  for (vtkm::Id slice = 0; slice < (is3D ? dim - 1 : 1); slice++)
+    for (vtkm::Id row = 0; row < dim - 1; row++)
+      for (vtkm::Id col = 0; col < dim - 1; col++)
+      {
+        vtkm::Id corner = slice * step[2] + row * step[1] + col;
+        if (is3D)
+        {
+          // one tetrahedron for each order of stepping along the three axes
+          const vtkm::IdComponent orders[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 },
+                                                   { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+          for (vtkm::IdComponent order = 0; order < 6; order++)
+          {
+            vtkm::Id point = corner;
+            connectivity.push_back(point);
+            for (vtkm::IdComponent axis = 0; axis < 3; axis++)
+            {
+              point += step[orders[order][axis]];
+              connectivity.push_back(point);
+            }
+          }
+        }
+        else
+        {
+          const vtkm::Id triangles[6] = { 0, 1, dim + 1, 0, dim, dim + 1 };
+          for (vtkm::IdComponent index = 0; index < 6; index++)
+            connectivity.push_back(corner + triangles[index]);
+        }
+      }
+
+  vtkm::cont::ArrayHandle<vtkm::Id> connectivityArray;
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(connectivity), connectivityArray);
+  vtkm::cont::CellSetSingleType<> cellSet("cells");
+  cellSet.Fill(dim * dim * nSlices,
+               is3D ? vtkm::CELL_SHAPE_TETRA : vtkm::CELL_SHAPE_TRIANGLE,
+               is3D ? 4 : 3,
+               connectivityArray);
+  return cellSet;
+}
+}
+}
+} // namespace vtkm::worklet::testing
+
+#endif // vtk_m_worklet_testing_GridSimplices_h
@@ -68,6 +68,9 @@
 
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
+#include <vtkm/worklet/testing/GridSimplices.h>
+
+#include <vector>
 
 namespace
 {
@@ -175,10 +178,101 @@ public:
                      "Wrong result for ContourTree filter");
   }
 
+  //
+  // Cut the 3D data set into two halves that share a slice and merge their boundary trees
+  //
+  void TestContourTree_Mesh3D_BoundaryTrees() const
+  {
+    std::cout << "Testing ContourTree_Mesh3D boundary trees" << std::endl;
+
+    vtkm::cont::DataSet dataSet = MakeTestDataSet().Make3DUniformDataSet1();
+    vtkm::cont::ArrayHandle<vtkm::Float32> fieldArray;
+    dataSet.GetField("pointvar").GetData().CopyTo(fieldArray);
+
+    vtkm::Id3 globalDims(5, 5, 5);
+    vtkm::cont::ArrayHandle<vtkm::Pair<vtkm::Id, vtkm::Id>> saddlePeak;
+    vtkm::worklet::ContourTreeMesh3D contourTreeMesh3D;
+    contourTreeMesh3D.Run(fieldArray, 5, 5, 5, saddlePeak, DeviceAdapter());
+
+    vtkm::worklet::contourtree::BoundaryTree trees[2];
+    for (vtkm::Id half = 0; half < 2; half++)
+    {
+      vtkm::Id3 blockOrigin(0, 0, 2 * half);
+      vtkm::Id3 blockDims(5, 5, 3);
+      std::vector<vtkm::Float32> values;
+      for (vtkm::Id vertex = 0; vertex < 75; vertex++)
+      {
+        values.push_back(fieldArray.GetPortalConstControl().Get(vertex + 50 * half));
+      }
+      contourTreeMesh3D.RunBoundaryTree(vtkm::cont::make_ArrayHandle(values),
+                                        blockDims,
+                                        blockOrigin,
+                                        globalDims,
+                                        trees[half],
+                                        DeviceAdapter());
+    }
+    trees[0].Merge(trees[1]);
+    trees[0].Simplify();
+
+    std::vector<vtkm::Pair<vtkm::Id, vtkm::Id>> merged;
+    trees[0].CollectSaddlePeak(merged);
+    VTKM_TEST_ASSERT(static_cast<vtkm::Id>(merged.size()) == saddlePeak.GetNumberOfValues(),
+                     "Wrong number of superarcs after merging");
+    for (std::size_t superarc = 0; superarc < merged.size(); superarc++)
+    {
+      VTKM_TEST_ASSERT(
+        test_equal(merged[superarc],
+                   saddlePeak.GetPortalConstControl().Get(static_cast<vtkm::Id>(superarc))),
+        "Wrong superarc after merging");
+    }
+  }
+
+  //
+  // Split the 2D and 3D data sets into triangles and tetrahedra and compare with the
+  // trees of the regular meshes
+  //
+  void TestContourTree_MeshExplicit_Triangulation() const
+  {
+    std::cout << "Testing ContourTree_MeshExplicit" << std::endl;
+
+    for (int is3D = 0; is3D < 2; is3D++)
+    {
+      vtkm::cont::DataSet dataSet = is3D ? MakeTestDataSet().Make3DUniformDataSet1()
+                                         : MakeTestDataSet().Make2DUniformDataSet1();
+      vtkm::cont::ArrayHandle<vtkm::Float32> fieldArray;
+      dataSet.GetField("pointvar").GetData().CopyTo(fieldArray);
+
+      vtkm::cont::ArrayHandle<vtkm::Pair<vtkm::Id, vtkm::Id>> expected;
+      if (is3D)
+      {
+        vtkm::worklet::ContourTreeMesh3D().Run(fieldArray, 5, 5, 5, expected, DeviceAdapter());
+      }
+      else
+      {
+        vtkm::worklet::ContourTreeMesh2D().Run(fieldArray, 5, 5, expected, DeviceAdapter());
+      }
+
+      vtkm::cont::ArrayHandle<vtkm::Pair<vtkm::Id, vtkm::Id>> saddlePeak;
+      vtkm::worklet::ContourTreeMeshExplicit().Run(
+        fieldArray, vtkm::worklet::testing::MakeGridSimplices(is3D != 0), saddlePeak, DeviceAdapter());
+
+      VTKM_TEST_ASSERT(saddlePeak.GetNumberOfValues() == expected.GetNumberOfValues(),
+                       "Wrong number of superarcs on explicit mesh");
+      for (vtkm::Id superarc = 0; superarc < expected.GetNumberOfValues(); superarc++)
+      {
+        VTKM_TEST_ASSERT(test_equal(saddlePeak.GetPortalConstControl().Get(superarc),
+                                    expected.GetPortalConstControl().Get(superarc)),
+                         "Wrong superarc on explicit mesh");
+      }
+    }
+  }
+
   void operator()() const
   {
     this->TestContourTree_Mesh2D_DEM_Triangulation();
     this->TestContourTree_Mesh3D_DEM_Triangulation();
+    this->TestContourTree_Mesh3D_BoundaryTrees();
+    this->TestContourTree_MeshExplicit_Triangulation();
   }
 };
 }
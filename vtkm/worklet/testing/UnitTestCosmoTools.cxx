@@ -22,6 +22,8 @@
 #include <vtkm/worklet/DispatcherMapField.h>
 
 #include <vtkm/Pair.h>
+#include <vtkm/VectorAnalysis.h>
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
@@ -340,6 +342,116 @@ void TestCosmo_3DCenterFind()
 
   VTKM_TEST_ASSERT(test_equal(nxnResult.first, mxnResult.first),
                    "NxN and MxN got different results");
+
+  // With no opening angle the tree code computes the exact potentials
+  vtkm::Pair<vtkm::Id, vtkm::Float32> treeResult;
+  cosmoTools.RunMBPCenterFinderTree(xLocArray,
+                                    yLocArray,
+                                    zLocArray,
+                                    nCells,
+                                    particleMass,
+                                    0.0f,
+                                    treeResult,
+                                    VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  VTKM_TEST_ASSERT(test_equal(nxnResult.first, treeResult.first),
+                   "NxN and exact tree got different results");
+  VTKM_TEST_ASSERT(test_equal(nxnResult.second, treeResult.second),
+                   "NxN and exact tree got different potentials");
+
+  cosmoTools.RunMBPCenterFinderTree(xLocArray,
+                                    yLocArray,
+                                    zLocArray,
+                                    nCells,
+                                    particleMass,
+                                    0.5f,
+                                    treeResult,
+                                    VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  VTKM_TEST_ASSERT(test_equal(nxnResult.first, treeResult.first),
+                   "NxN and approximate tree got different results");
+  VTKM_TEST_ASSERT(vtkm::Abs(treeResult.second - nxnResult.second) <=
+                     0.001f * vtkm::Abs(nxnResult.second),
+                   "Approximate tree potential is too far from the NxN potential");
+}
+
+//
+// Test the tree code on a halo with a dense core, whose finest bins have to be
+// refined, against the exact potential
+//
+void TestCosmo_3DCenterFindTree()
+{
+  std::cout << "Testing Center Finder Tree 3D" << std::endl;
+
+  // Particles fall off steeply from the center, with a small linear congruential
+  // generator so that the halo is the same on every platform
+  const vtkm::Id nParticles = 2000;
+  std::vector<vtkm::Float32> xLoc, yLoc, zLoc;
+  vtkm::UInt32 state = 12345;
+  auto random = [&state]() {
+    state = state * 1664525u + 1013904223u;
+    return static_cast<vtkm::Float32>(state >> 8) / 16777216.0f;
+  };
+  while (static_cast<vtkm::Id>(xLoc.size()) < nParticles)
+  {
+    vtkm::Vec<vtkm::Float32, 3> direction(
+      2.0f * random() - 1.0f, 2.0f * random() - 1.0f, 2.0f * random() - 1.0f);
+    vtkm::Float32 length = vtkm::Magnitude(direction);
+    if ((length > 1.0f) || (length < 0.01f))
+      continue;
+    vtkm::Float32 radius = random();
+    direction = direction * (10.0f * radius * radius / length);
+    xLoc.push_back(direction[0]);
+    yLoc.push_back(direction[1]);
+    zLoc.push_back(direction[2]);
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Float32> xLocArray, yLocArray, zLocArray;
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(xLoc), xLocArray);
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(yLoc), yLocArray);
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandle(zLoc), zLocArray);
+
+  vtkm::Float32 particleMass = 1.0f;
+  vtkm::Pair<vtkm::Id, vtkm::Float32> nxnResult;
+  vtkm::Pair<vtkm::Id, vtkm::Float32> treeResult;
+
+  vtkm::worklet::CosmoTools cosmoTools;
+  cosmoTools.RunMBPCenterFinderNxN(xLocArray,
+                                   yLocArray,
+                                   zLocArray,
+                                   nParticles,
+                                   particleMass,
+                                   nxnResult,
+                                   VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  cosmoTools.RunMBPCenterFinderTree(xLocArray,
+                                    yLocArray,
+                                    zLocArray,
+                                    nParticles,
+                                    particleMass,
+                                    0.0f,
+                                    treeResult,
+                                    VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  VTKM_TEST_ASSERT(test_equal(nxnResult.first, treeResult.first),
+                   "NxN and exact tree got different results");
+  VTKM_TEST_ASSERT(test_equal(nxnResult.second, treeResult.second),
+                   "NxN and exact tree got different potentials");
+
+  cosmoTools.RunMBPCenterFinderTree(xLocArray,
+                                    yLocArray,
+                                    zLocArray,
+                                    nParticles,
+                                    particleMass,
+                                    0.5f,
+                                    treeResult,
+                                    VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  VTKM_TEST_ASSERT(test_equal(nxnResult.first, treeResult.first),
+                   "NxN and approximate tree got different results");
+  VTKM_TEST_ASSERT(vtkm::Abs(treeResult.second - nxnResult.second) <=
+                     0.001f * vtkm::Abs(nxnResult.second),
+                   "Approximate tree potential is too far from the NxN potential");
 }
 
 void TestCosmoTools()
@@ -348,6 +460,7 @@ void TestCosmoTools()
   TestCosmo_3DHaloFind();
 
   TestCosmo_3DCenterFind();
+  TestCosmo_3DCenterFindTree();
 }
 
 int UnitTestCosmoTools(int, char* [])
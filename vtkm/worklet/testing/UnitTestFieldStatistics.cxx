@@ -21,9 +21,12 @@
 #include <algorithm>
 
 #include <vtkm/worklet/FieldStatistics.h>
+#include <vtkm/worklet/StreamingStatistics.h>
+#include <vtkm/worklet/statistics/ReduceStatistics.h>
 
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/testing/Testing.h>
+#include <vtkm/worklet/testing/ExtractBlock.h>
 
 //
 // Make a simple 2D, 10 cell dataset
@@ -408,10 +411,123 @@ void TestFieldStandardDistributions()
   PrintStatInfo(statinfo);
 } // TestFieldStatistics
 
+//
+// Accumulate blocks of the standard distributions and compare with all values at once
+//
+void TestStreamingStatistics()
+{
+  vtkm::cont::DataSet ds = Make2DUniformStatDataSet1();
+  const std::string fieldNames[4] = { "p_poisson", "p_normal", "p_chiSquare", "p_uniform" };
+
+  for (int f = 0; f < 4; f++)
+  {
+    vtkm::cont::ArrayHandle<vtkm::Float32> data;
+    ds.GetField(fieldNames[f]).GetData().CopyTo(data);
+    const vtkm::Id numValues = data.GetNumberOfValues();
+
+    vtkm::worklet::FieldStatistics<vtkm::Float32, VTKM_DEFAULT_DEVICE_ADAPTER_TAG>::StatInfo
+      statinfo;
+    vtkm::worklet::FieldStatistics<vtkm::Float32, VTKM_DEFAULT_DEVICE_ADAPTER_TAG>().Run(data,
+                                                                                         statinfo);
+
+    // Blocks 0 and 1 go to one accumulator, block 2 to another, as if on two ranks
+    vtkm::worklet::StreamingStatistics stats;
+    vtkm::worklet::StreamingStatistics otherStats;
+    using vtkm::worklet::testing::ExtractBlock;
+    stats.AddBlock(ExtractBlock(data, 0, 250), VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+    stats.AddBlock(ExtractBlock(data, 250, 600), VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+    otherStats.AddBlock(ExtractBlock(data, 600, numValues), VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+    stats.Merge(otherStats);
+
+    std::cout << "Streaming statistics of " << fieldNames[f] << ": median " << stats.GetMedian()
+              << ", 10% " << stats.GetQuantile(0.1) << ", 90% " << stats.GetQuantile(0.9)
+              << std::endl;
+
+    VTKM_TEST_ASSERT(stats.GetNumberOfValues() == numValues, "Error in number of values");
+    VTKM_TEST_ASSERT(test_equal(stats.GetMinimum(), statinfo.minimum), "Error in minimum");
+    VTKM_TEST_ASSERT(test_equal(stats.GetMaximum(), statinfo.maximum), "Error in maximum");
+    VTKM_TEST_ASSERT(test_equal(stats.GetMean(), statinfo.mean), "Error in mean");
+    VTKM_TEST_ASSERT(test_equal(stats.GetVariance(), statinfo.variance), "Error in variance");
+    VTKM_TEST_ASSERT(test_equal(stats.GetSkewness(), statinfo.skewness), "Error in skewness");
+    VTKM_TEST_ASSERT(test_equal(stats.GetKurtosis(), statinfo.kurtosis), "Error in kurtosis");
+
+    // Quantiles are approximate. Some rank of the estimate among the sorted values
+    // (a range of ranks when values repeat) must be close to the requested one.
+    // With the default compression the centroids near the median hold up to
+    // about 1.6% of the values.
+    std::vector<vtkm::Float32> sorted(static_cast<std::size_t>(numValues));
+    for (vtkm::Id i = 0; i < numValues; i++)
+    {
+      sorted[static_cast<std::size_t>(i)] = data.GetPortalConstControl().Get(i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    const vtkm::Float64 rankTolerance = 0.02 * static_cast<vtkm::Float64>(numValues);
+    const vtkm::Float32 valueTolerance = 2.0f * (statinfo.maximum - statinfo.minimum) / 4096;
+    const vtkm::Float64 quantiles[5] = { 0.01, 0.1, 0.5, 0.9, 0.99 };
+    for (vtkm::Float64 q : quantiles)
+    {
+      const vtkm::Float32 estimate = static_cast<vtkm::Float32>(stats.GetQuantile(q));
+      const vtkm::Float64 rank = q * static_cast<vtkm::Float64>(numValues);
+      const vtkm::Float64 lowerRank = static_cast<vtkm::Float64>(
+        std::lower_bound(sorted.begin(), sorted.end(), estimate - valueTolerance) - sorted.begin());
+      const vtkm::Float64 upperRank = static_cast<vtkm::Float64>(
+        std::upper_bound(sorted.begin(), sorted.end(), estimate + valueTolerance) - sorted.begin());
+      VTKM_TEST_ASSERT(lowerRank <= rank + rankTolerance && upperRank >= rank - rankTolerance,
+                       "Error in quantile");
+    }
+    VTKM_TEST_ASSERT(test_equal(stats.GetQuantile(0), statinfo.minimum), "Error in 0 quantile");
+    VTKM_TEST_ASSERT(test_equal(stats.GetQuantile(1), statinfo.maximum), "Error in 1 quantile");
+
+    // The merged blocks must agree with all values added as a single block
+    vtkm::worklet::StreamingStatistics singleStats;
+    singleStats.AddBlock(data, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+    VTKM_TEST_ASSERT(stats.GetNumberOfValues() == singleStats.GetNumberOfValues(),
+                     "Merged number of values differs from a single block");
+    VTKM_TEST_ASSERT(test_equal(stats.GetMean(), singleStats.GetMean()) &&
+                       test_equal(stats.GetVariance(), singleStats.GetVariance()) &&
+                       test_equal(stats.GetSkewness(), singleStats.GetSkewness()) &&
+                       test_equal(stats.GetKurtosis(), singleStats.GetKurtosis()),
+                     "Merged moments differ from a single block");
+    for (vtkm::Float64 q : quantiles)
+    {
+      VTKM_TEST_ASSERT(vtkm::Abs(stats.GetQuantile(q) - singleStats.GetQuantile(q)) <=
+                         0.02 * (statinfo.maximum - statinfo.minimum),
+                       "Merged quantile differs from a single block");
+    }
+
+    // Accumulators are rebuilt from their state, e.g. after being sent to
+    // another rank, and reduced over all ranks
+    diy::MemoryBuffer buffer;
+    diy::save(buffer, stats);
+    buffer.reset();
+    vtkm::worklet::StreamingStatistics loadedStats;
+    diy::load(buffer, loadedStats);
+    const vtkm::worklet::StreamingStatistics rebuiltStats(stats.GetMoments(), stats.GetDigest());
+    const vtkm::worklet::StreamingStatistics reducedStats =
+      vtkm::worklet::statistics::ReduceStatistics(stats);
+    const vtkm::worklet::StreamingStatistics* copies[3] = { &loadedStats,
+                                                            &rebuiltStats,
+                                                            &reducedStats };
+    for (const vtkm::worklet::StreamingStatistics* copy : copies)
+    {
+      VTKM_TEST_ASSERT(copy->GetNumberOfValues() == stats.GetNumberOfValues() &&
+                         copy->GetMean() == stats.GetMean() &&
+                         copy->GetKurtosis() == stats.GetKurtosis(),
+                       "Error in moments of rebuilt statistics");
+      for (vtkm::Float64 q : quantiles)
+      {
+        VTKM_TEST_ASSERT(copy->GetQuantile(q) == stats.GetQuantile(q),
+                         "Error in quantile of rebuilt statistics");
+      }
+    }
+  }
+}
+
 void TestFieldStatistics()
 {
   TestFieldStandardDistributions();
   TestFieldSimple();
+  TestStreamingStatistics();
 }
 
 int UnitTestFieldStatistics(int, char* [])
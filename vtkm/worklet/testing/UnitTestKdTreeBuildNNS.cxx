@@ -18,7 +18,10 @@
 //  this software.
 //============================================================================
 
+#include <algorithm>
 #include <random>
+#include <vector>
+#include <vtkm/VectorAnalysis.h>
 #include <vtkm/worklet/KdTree3D.h>
 
 namespace
@@ -74,7 +77,7 @@ public:
   }
 };
 
-void TestKdTreeBuildNNS()
+void TestKdTreeBuildNNS(vtkm::worklet::KdTree3D::BuildModeEnum buildMode)
 {
   vtkm::Int32 nTrainingPoints = 1000;
   vtkm::Int32 nTestingPoint = 1000;
@@ -95,6 +98,7 @@ void TestKdTreeBuildNNS()
 
   // Run data
   vtkm::worklet::KdTree3D kdtree3d;
+  kdtree3d.SetBuildMode(buildMode);
   kdtree3d.Build(coordi_Handle, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
 
   //Nearest Neighbor worklet Testing
@@ -138,9 +142,124 @@ void TestKdTreeBuildNNS()
   VTKM_TEST_ASSERT(passTest, "Kd tree NN search result incorrect.");
 }
 
+void TestKdTreeKNearestAndRadius(vtkm::worklet::KdTree3D::BuildModeEnum buildMode)
+{
+  vtkm::Int32 nTrainingPoints = 1000;
+  vtkm::Int32 nTestingPoint = 200;
+  const vtkm::Id k = 8;
+  const vtkm::Float32 radius = 1.5f;
+
+  std::default_random_engine dre;
+  std::uniform_real_distribution<vtkm::Float32> dr(0.0f, 10.0f);
+
+  std::vector<vtkm::Vec<vtkm::Float32, 3>> coordi;
+  for (vtkm::Int32 i = 0; i < nTrainingPoints; i++)
+  {
+    coordi.push_back(vtkm::make_Vec(dr(dre), dr(dre), dr(dre)));
+  }
+  std::vector<vtkm::Vec<vtkm::Float32, 3>> qcVec;
+  for (vtkm::Int32 i = 0; i < nTestingPoint; i++)
+  {
+    qcVec.push_back(vtkm::make_Vec(dr(dre), dr(dre), dr(dre)));
+  }
+  auto coordi_Handle = vtkm::cont::make_ArrayHandle(coordi);
+  auto qc_Handle = vtkm::cont::make_ArrayHandle(qcVec);
+
+  vtkm::worklet::KdTree3D kdtree3d;
+  kdtree3d.SetBuildMode(buildMode);
+  kdtree3d.Build(coordi_Handle, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  vtkm::cont::ArrayHandle<vtkm::Id> knnId_Handle;
+  vtkm::cont::ArrayHandle<vtkm::Float32> knnDis_Handle;
+  vtkm::Id kFound = kdtree3d.FindKNearestNeighbors(
+    coordi_Handle, qc_Handle, k, knnId_Handle, knnDis_Handle, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  VTKM_TEST_ASSERT(kFound == k, "Wrong number of nearest neighbors.");
+  VTKM_TEST_ASSERT(knnId_Handle.GetNumberOfValues() == nTestingPoint * k,
+                   "Wrong size of k-nearest-neighbor output.");
+
+  vtkm::cont::ArrayHandle<vtkm::IdComponent> numNeighbors_Handle;
+  vtkm::cont::ArrayHandle<vtkm::Id> offsets_Handle;
+  vtkm::cont::ArrayHandle<vtkm::Id> neighborId_Handle;
+  vtkm::cont::ArrayHandle<vtkm::Float32> neighborDis_Handle;
+  kdtree3d.FindNeighborsInRadius(coordi_Handle,
+                                 qc_Handle,
+                                 radius,
+                                 numNeighbors_Handle,
+                                 offsets_Handle,
+                                 neighborId_Handle,
+                                 neighborDis_Handle,
+                                 VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  auto knnIds = knnId_Handle.GetPortalConstControl();
+  auto knnDis = knnDis_Handle.GetPortalConstControl();
+  auto numNeighbors = numNeighbors_Handle.GetPortalConstControl();
+  auto offsets = offsets_Handle.GetPortalConstControl();
+  auto neighborIds = neighborId_Handle.GetPortalConstControl();
+  auto neighborDis = neighborDis_Handle.GetPortalConstControl();
+  for (vtkm::Int32 i = 0; i < nTestingPoint; i++)
+  {
+    ///// brute force: all points sorted by squared distance /////
+    std::vector<std::pair<vtkm::Float32, vtkm::Id>> sorted;
+    for (vtkm::Int32 j = 0; j < nTrainingPoints; j++)
+    {
+      sorted.push_back(std::make_pair(vtkm::MagnitudeSquared(coordi[j] - qcVec[i]), vtkm::Id(j)));
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    for (vtkm::Id n = 0; n < k; n++)
+    {
+      VTKM_TEST_ASSERT(test_equal(knnDis.Get(i * k + n), vtkm::Sqrt(sorted[n].first)),
+                       "Kd tree k-NN search distance incorrect.");
+    }
+    VTKM_TEST_ASSERT(knnIds.Get(i * k) == sorted[0].second, "Kd tree k-NN search incorrect.");
+
+    std::vector<vtkm::Id> expected;
+    for (const auto& candidate : sorted)
+    {
+      if (candidate.first <= radius * radius)
+      {
+        expected.push_back(candidate.second);
+      }
+    }
+    VTKM_TEST_ASSERT(numNeighbors.Get(i) == static_cast<vtkm::IdComponent>(expected.size()),
+                     "Kd tree radius search found the wrong number of neighbors.");
+    std::vector<vtkm::Id> found;
+    for (vtkm::IdComponent n = 0; n < numNeighbors.Get(i); n++)
+    {
+      vtkm::Id pointId = neighborIds.Get(offsets.Get(i) + n);
+      VTKM_TEST_ASSERT(test_equal(neighborDis.Get(offsets.Get(i) + n),
+                                  vtkm::Magnitude(coordi[pointId] - qcVec[i])),
+                       "Kd tree radius search distance incorrect.");
+      found.push_back(pointId);
+    }
+    std::sort(found.begin(), found.end());
+    std::sort(expected.begin(), expected.end());
+    VTKM_TEST_ASSERT(found == expected, "Kd tree radius search result incorrect.");
+  }
+
+  // asking for more neighbors than points returns all of them
+  kFound = kdtree3d.FindKNearestNeighbors(coordi_Handle,
+                                          qc_Handle,
+                                          nTrainingPoints + 10,
+                                          knnId_Handle,
+                                          knnDis_Handle,
+                                          VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  VTKM_TEST_ASSERT(kFound == nTrainingPoints, "k was not clamped to the number of points.");
+}
+
+void TestKdTree()
+{
+  std::cout << "Balanced KD-tree" << std::endl;
+  TestKdTreeBuildNNS(vtkm::worklet::KdTree3D::BUILD_BALANCED);
+  TestKdTreeKNearestAndRadius(vtkm::worklet::KdTree3D::BUILD_BALANCED);
+  std::cout << "Morton KD-tree" << std::endl;
+  TestKdTreeBuildNNS(vtkm::worklet::KdTree3D::BUILD_MORTON);
+  TestKdTreeKNearestAndRadius(vtkm::worklet::KdTree3D::BUILD_MORTON);
+}
+
 } // anonymous namespace
 
 int UnitTestKdTreeBuildNNS(int, char* [])
 {
-  return vtkm::cont::testing::Testing::Run(TestKdTreeBuildNNS);
+  return vtkm::cont::testing::Testing::Run(TestKdTree);
 }
@@ -20,6 +20,7 @@
 
 #include <vtkm/Math.h>
 #include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
 #include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
 #include <vtkm/cont/CellSetSingleType.h>
 #include <vtkm/cont/DataSet.h>
@@ -320,6 +321,24 @@ void TestMarchingCubesUniformGrid()
 
   scalarsArray = isosurfaceFilter.ProcessPointField(pointFieldArray, DeviceAdapter());
 
+  // Interpolating several fields at once matches interpolating them one by one.
+  std::vector<vtkm::cont::ArrayHandle<vtkm::Float32>> pointFields(2);
+  pointFields[0] = pointFieldArray;
+  pointFields[1].Allocate(pointFieldArray.GetNumberOfValues());
+  for (vtkm::Id i = 0; i < pointFieldArray.GetNumberOfValues(); ++i)
+  {
+    pointFields[1].GetPortalControl().Set(i, 2.0f * pointFieldArray.GetPortalConstControl().Get(i));
+  }
+  auto batchedScalars = isosurfaceFilter.ProcessPointFields(pointFields, DeviceAdapter());
+  VTKM_TEST_ASSERT(batchedScalars.size() == 2, "Wrong number of batched fields");
+  for (vtkm::Id i = 0; i < scalarsArray.GetNumberOfValues(); ++i)
+  {
+    const vtkm::Float32 expected = scalarsArray.GetPortalConstControl().Get(i);
+    VTKM_TEST_ASSERT(test_equal(batchedScalars[0].GetPortalConstControl().Get(i), expected) &&
+                       test_equal(batchedScalars[1].GetPortalConstControl().Get(i), 2.0f * expected),
+                     "Wrong batched point field interpolation");
+  }
+
   vtkm::cont::ArrayHandle<vtkm::FloatDefault> cellFieldArrayOut;
   cellFieldArrayOut = isosurfaceFilter.ProcessCellField(cellFieldArray, DeviceAdapter());
 
@@ -418,10 +437,210 @@ void TestMarchingCubesExplicit()
                    "Wrong scalars result for MarchingCubes filter");
 }
 
+void TestMarchingCubesBatch()
+{
+  std::cout << "Testing MarchingCubes with several scalar and point fields" << std::endl;
+
+  vtkm::Id3 dims(8, 8, 8);
+  vtkm::cont::DataSet dataSet = vtkm_ut_mc_worklet::MakeIsosurfaceTestDataSet(dims);
+
+  using DeviceAdapter = VTKM_DEFAULT_DEVICE_ADAPTER_TAG;
+  using Vec3Handle = vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 3>>;
+  using DataHandle = vtkm::cont::ArrayHandle<vtkm::Float32>;
+  vtkm::cont::CellSetStructured<3> cellSet;
+  dataSet.GetCellSet().CopyTo(cellSet);
+  DataHandle pointFieldArray;
+  dataSet.GetField("nodevar").GetData().CopyTo(pointFieldArray);
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> cellFieldArray;
+  dataSet.GetField("cellvar").GetData().CopyTo(cellFieldArray);
+
+  // Two scalar fields to contour, which are also the point fields to map
+  std::vector<DataHandle> fields(2);
+  fields[0] = pointFieldArray;
+  fields[1].Allocate(pointFieldArray.GetNumberOfValues());
+  for (vtkm::Id i = 0; i < pointFieldArray.GetNumberOfValues(); ++i)
+  {
+    const vtkm::Float32 value = pointFieldArray.GetPortalConstControl().Get(i);
+    fields[1].GetPortalControl().Set(i, 1.0f - value * value);
+  }
+
+  vtkm::Float32 contourValues[2] = { 0.3f, 0.6f };
+  vtkm::worklet::MarchingCubes batch;
+  std::vector<Vec3Handle> batchVertices;
+  std::vector<std::vector<DataHandle>> batchFields;
+  auto batchCells = batch.RunBatch(contourValues,
+                                   2,
+                                   cellSet,
+                                   dataSet.GetCoordinateSystem(),
+                                   fields,
+                                   fields,
+                                   batchVertices,
+                                   batchFields,
+                                   DeviceAdapter());
+  VTKM_TEST_ASSERT(batchCells.size() == 2 && batchVertices.size() == 2 && batchFields.size() == 2,
+                   "Wrong number of batched contours");
+
+  for (std::size_t k = 0; k < fields.size(); ++k)
+  {
+    vtkm::worklet::MarchingCubes single;
+    Vec3Handle vertices;
+    auto cells = single.Run(contourValues,
+                            2,
+                            cellSet,
+                            dataSet.GetCoordinateSystem(),
+                            fields[k],
+                            vertices,
+                            DeviceAdapter());
+    VTKM_TEST_ASSERT(cells.GetNumberOfCells() > 0, "Expected a contour");
+    VTKM_TEST_ASSERT(batchCells[k].GetNumberOfCells() == cells.GetNumberOfCells() &&
+                       batchVertices[k].GetNumberOfValues() == vertices.GetNumberOfValues(),
+                     "Wrong size of batched contour");
+    for (vtkm::Id i = 0; i < vertices.GetNumberOfValues(); ++i)
+    {
+      VTKM_TEST_ASSERT(test_equal(batchVertices[k].GetPortalConstControl().Get(i),
+                                  vertices.GetPortalConstControl().Get(i)),
+                       "Wrong batched contour vertices");
+    }
+    VTKM_TEST_ASSERT(batchFields[k].size() == fields.size(), "Wrong number of batched fields");
+    for (std::size_t m = 0; m < fields.size(); ++m)
+    {
+      DataHandle expected = single.ProcessPointField(fields[m], DeviceAdapter());
+      VTKM_TEST_ASSERT(batchFields[k][m].GetNumberOfValues() == expected.GetNumberOfValues(),
+                       "Wrong size of batched point field");
+      for (vtkm::Id i = 0; i < expected.GetNumberOfValues(); ++i)
+      {
+        VTKM_TEST_ASSERT(test_equal(batchFields[k][m].GetPortalConstControl().Get(i),
+                                    expected.GetPortalConstControl().Get(i)),
+                         "Wrong batched point field interpolation");
+      }
+    }
+
+    // The cell fields map onto the contour of the last scalar field
+    if (k + 1 == fields.size())
+    {
+      auto expected = single.ProcessCellField(cellFieldArray, DeviceAdapter());
+      auto mapped = batch.ProcessCellField(cellFieldArray, DeviceAdapter());
+      VTKM_TEST_ASSERT(mapped.GetNumberOfValues() == expected.GetNumberOfValues(),
+                       "Wrong size of batched cell field");
+      for (vtkm::Id i = 0; i < expected.GetNumberOfValues(); ++i)
+      {
+        VTKM_TEST_ASSERT(mapped.GetPortalConstControl().Get(i) ==
+                           expected.GetPortalConstControl().Get(i),
+                         "Wrong batched cell field");
+      }
+    }
+  }
+}
+
+void TestMarchingCubesBrickRangeIndex()
+{
+  std::cout << "Testing MarchingCubes with a brick range index" << std::endl;
+
+  vtkm::Id3 dims(21, 18, 13);
+  vtkm::cont::DataSet dataSet = vtkm_ut_mc_worklet::MakeIsosurfaceTestDataSet(dims);
+
+  using DeviceAdapter = VTKM_DEFAULT_DEVICE_ADAPTER_TAG;
+  vtkm::cont::CellSetStructured<3> cellSet;
+  dataSet.GetCellSet().CopyTo(cellSet);
+  vtkm::cont::ArrayHandle<vtkm::Float32> pointFieldArray;
+  dataSet.GetField("nodevar").GetData().CopyTo(pointFieldArray);
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> cellFieldArray;
+  dataSet.GetField("cellvar").GetData().CopyTo(cellFieldArray);
+
+  vtkm::worklet::BrickRangeIndex index(4);
+  index.Build(cellSet, pointFieldArray, DeviceAdapter());
+
+  vtkm::Float32 contourValues[2] = { 0.1f, 0.9f };
+  vtkm::cont::ArrayHandle<vtkm::Id> candidates =
+    index.GetCellsStraddling(vtkm::cont::make_ArrayHandle(contourValues, 1), DeviceAdapter());
+  VTKM_TEST_ASSERT(candidates.GetNumberOfValues() > 0 &&
+                     candidates.GetNumberOfValues() < cellSet.GetNumberOfCells(),
+                   "Brick range index should skip some cells");
+  for (vtkm::Id numContours = 1; numContours <= 2; ++numContours)
+  {
+    vtkm::worklet::MarchingCubes fullScan;
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 3>> fullVertices;
+    auto fullCells = fullScan.Run(contourValues,
+                                  numContours,
+                                  cellSet,
+                                  dataSet.GetCoordinateSystem(),
+                                  pointFieldArray,
+                                  fullVertices,
+                                  DeviceAdapter());
+    auto fullCellField = fullScan.ProcessCellField(cellFieldArray, DeviceAdapter());
+
+    vtkm::worklet::MarchingCubes indexed;
+    indexed.SetBrickRangeIndex(index);
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 3>> indexedVertices;
+    auto indexedCells = indexed.Run(contourValues,
+                                    numContours,
+                                    cellSet,
+                                    dataSet.GetCoordinateSystem(),
+                                    pointFieldArray,
+                                    indexedVertices,
+                                    DeviceAdapter());
+    auto indexedCellField = indexed.ProcessCellField(cellFieldArray, DeviceAdapter());
+
+    VTKM_TEST_ASSERT(fullCells.GetNumberOfCells() > 0, "Expected a contour");
+    VTKM_TEST_ASSERT(indexedCells.GetNumberOfCells() == fullCells.GetNumberOfCells(),
+                     "Wrong number of cells with brick range index");
+    VTKM_TEST_ASSERT(indexedVertices.GetNumberOfValues() == fullVertices.GetNumberOfValues(),
+                     "Wrong number of vertices with brick range index");
+    for (vtkm::Id i = 0; i < fullVertices.GetNumberOfValues(); ++i)
+    {
+      VTKM_TEST_ASSERT(indexedVertices.GetPortalConstControl().Get(i) ==
+                         fullVertices.GetPortalConstControl().Get(i),
+                       "Wrong vertices with brick range index");
+    }
+    for (vtkm::Id i = 0; i < fullCellField.GetNumberOfValues(); ++i)
+    {
+      VTKM_TEST_ASSERT(indexedCellField.GetPortalConstControl().Get(i) ==
+                         fullCellField.GetPortalConstControl().Get(i),
+                       "Wrong cell field with brick range index");
+    }
+  }
+
+  // An index built from another array must not be used
+  vtkm::cont::ArrayHandle<vtkm::Float32> otherField;
+  vtkm::cont::ArrayCopy(
+    vtkm::cont::make_ArrayHandleConstant(0.0f, pointFieldArray.GetNumberOfValues()), otherField);
+  vtkm::worklet::BrickRangeIndex staleIndex(4);
+  staleIndex.Build(cellSet, otherField, DeviceAdapter());
+  VTKM_TEST_ASSERT(staleIndex.IsValidFor(cellSet, otherField) &&
+                     !staleIndex.IsValidFor(cellSet, pointFieldArray),
+                   "Brick range index should only be valid for its own array");
+  VTKM_TEST_ASSERT(!staleIndex.IsValidFor(cellSet, "nodevar", otherField),
+                   "Brick range index should only be valid for its own field name");
+
+  vtkm::worklet::MarchingCubes fullScan;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 3>> fullVertices;
+  auto fullCells = fullScan.Run(contourValues,
+                                1,
+                                cellSet,
+                                dataSet.GetCoordinateSystem(),
+                                pointFieldArray,
+                                fullVertices,
+                                DeviceAdapter());
+  vtkm::worklet::MarchingCubes stale;
+  stale.SetBrickRangeIndex(staleIndex);
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float32, 3>> staleVertices;
+  auto staleCells = stale.Run(contourValues,
+                              1,
+                              cellSet,
+                              dataSet.GetCoordinateSystem(),
+                              pointFieldArray,
+                              staleVertices,
+                              DeviceAdapter());
+  VTKM_TEST_ASSERT(staleCells.GetNumberOfCells() == fullCells.GetNumberOfCells(),
+                   "Brick range index of another array was used");
+}
+
 void TestMarchingCubes()
 {
   TestMarchingCubesUniformGrid();
   TestMarchingCubesExplicit();
+  TestMarchingCubesBatch();
+  TestMarchingCubesBrickRangeIndex();
 }
 
 int UnitTestMarchingCubes(int, char* [])
@@ -20,8 +20,11 @@
 
 #include <vtkm/worklet/NDimsHistogram.h>
 
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/testing/Testing.h>
+#include <vtkm/worklet/testing/ExtractBlock.h>
 
 namespace
 {
@@ -136,9 +139,152 @@ void TestNDimsHistogram()
                      "Incorrect ND-histogram results");
   }
 } // TestNDHistogram
+
+void TestNDimsHistogramBlocks()
+{
+  vtkm::cont::DataSet ds = MakeTestDataSet();
+  const vtkm::Id numberOfValues = ds.GetField(0).GetData().GetNumberOfValues();
+  const std::string fieldNames[3] = { "fieldA", "fieldB", "fieldC" };
+  const vtkm::Range ranges[3] = { { 3, 19 }, { 10, 35 }, { 0, 16 } };
+
+  // Histogram of all points at once
+  vtkm::worklet::NDimsHistogram ndHistogram;
+  ndHistogram.SetNumOfDataPoints(numberOfValues, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  for (int f = 0; f < 3; f++)
+  {
+    ndHistogram.AddField(
+      ds.GetField(fieldNames[f]).GetData(), 4, ranges[f], VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  }
+  std::vector<vtkm::cont::ArrayHandle<vtkm::Id>> binIds;
+  vtkm::cont::ArrayHandle<vtkm::Id> freqs;
+  ndHistogram.Run(binIds, freqs, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  // Same histogram accumulated from three blocks of points
+  const vtkm::Id blockBounds[4] = { 0, 30, 65, numberOfValues };
+  vtkm::worklet::NDimsHistogram blockHistogram;
+  for (int b = 0; b < 3; b++)
+  {
+    blockHistogram.SetNumOfDataPoints(blockBounds[b + 1] - blockBounds[b],
+                                      VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+    for (int f = 0; f < 3; f++)
+    {
+      vtkm::cont::ArrayHandle<vtkm::Float32> values;
+      ds.GetField(fieldNames[f]).GetData().CopyTo(values);
+      blockHistogram.AddField(vtkm::cont::DynamicArrayHandle(vtkm::worklet::testing::ExtractBlock(
+                                values, blockBounds[b], blockBounds[b + 1])),
+                              4,
+                              ranges[f],
+                              VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+    }
+  }
+  std::vector<vtkm::cont::ArrayHandle<vtkm::Id>> blockBinIds;
+  vtkm::cont::ArrayHandle<vtkm::Id> blockFreqs;
+  blockHistogram.Run(blockBinIds, blockFreqs, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  const vtkm::Id nonSparseBins = freqs.GetNumberOfValues();
+  VTKM_TEST_ASSERT(blockFreqs.GetNumberOfValues() == nonSparseBins,
+                   "Incorrect accumulated ND-histogram size");
+  for (vtkm::Id i = 0; i < nonSparseBins; i++)
+  {
+    for (size_t f = 0; f < 3; f++)
+    {
+      VTKM_TEST_ASSERT(blockBinIds[f].GetPortalConstControl().Get(i) ==
+                         binIds[f].GetPortalConstControl().Get(i),
+                       "Incorrect accumulated ND-histogram bins");
+    }
+    VTKM_TEST_ASSERT(blockFreqs.GetPortalConstControl().Get(i) ==
+                       freqs.GetPortalConstControl().Get(i),
+                     "Incorrect accumulated ND-histogram frequencies");
+  }
+
+  // Blocks must be binned like the first one
+  blockHistogram.SetNumOfDataPoints(numberOfValues, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  try
+  {
+    blockHistogram.AddField(
+      ds.GetField("fieldA").GetData(), 8, ranges[0], VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+    VTKM_TEST_FAIL("Did not get expected error for mismatched number of bins");
+  }
+  catch (vtkm::cont::ErrorBadValue&)
+  {
+    std::cout << "Got expected error for mismatched number of bins" << std::endl;
+  }
+
+  // A field binned over a fixed range cannot be binned over its own range later
+  vtkm::worklet::NDimsHistogram mixedHistogram;
+  mixedHistogram.SetNumOfDataPoints(numberOfValues, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  mixedHistogram.AddField(
+    ds.GetField("fieldA").GetData(), 4, ranges[0], VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  mixedHistogram.SetNumOfDataPoints(numberOfValues, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  try
+  {
+    vtkm::Range range;
+    vtkm::Float64 delta;
+    mixedHistogram.AddField(
+      ds.GetField("fieldA").GetData(), 4, range, delta, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+    VTKM_TEST_FAIL("Did not get expected error for mixed bin ranges");
+  }
+  catch (vtkm::cont::ErrorBadValue&)
+  {
+    std::cout << "Got expected error for mixed bin ranges" << std::endl;
+  }
+
+  // Bins over the range of the values of each block would not match
+  vtkm::worklet::NDimsHistogram dataRangeHistogram;
+  vtkm::Range dataRange;
+  vtkm::Float64 dataDelta;
+  dataRangeHistogram.SetNumOfDataPoints(numberOfValues, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  dataRangeHistogram.AddField(
+    ds.GetField("fieldA").GetData(), 4, dataRange, dataDelta, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  dataRangeHistogram.SetNumOfDataPoints(numberOfValues, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  try
+  {
+    dataRangeHistogram.AddField(
+      ds.GetField("fieldA").GetData(), 4, dataRange, dataDelta, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+    VTKM_TEST_FAIL("Did not get expected error for data ranges of several blocks");
+  }
+  catch (vtkm::cont::ErrorBadValue&)
+  {
+    std::cout << "Got expected error for data ranges of several blocks" << std::endl;
+  }
+}
+
+// Many distinct bins, so the sparse table has to grow while it is filled
+void TestNDimsHistogramManyBins()
+{
+  const vtkm::Id numberOfValues = 100000;
+  vtkm::cont::ArrayHandle<vtkm::Float64> values;
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleCounting(0.5, 1.0, numberOfValues), values);
+
+  vtkm::worklet::NDimsHistogram ndHistogram;
+  ndHistogram.SetNumOfDataPoints(numberOfValues, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  ndHistogram.AddField(vtkm::cont::DynamicArrayHandle(values),
+                       numberOfValues,
+                       vtkm::Range(0, numberOfValues),
+                       VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+  std::vector<vtkm::cont::ArrayHandle<vtkm::Id>> binIds;
+  vtkm::cont::ArrayHandle<vtkm::Id> freqs;
+  ndHistogram.Run(binIds, freqs, VTKM_DEFAULT_DEVICE_ADAPTER_TAG());
+
+  VTKM_TEST_ASSERT(freqs.GetNumberOfValues() == numberOfValues,
+                   "Incorrect number of non-empty bins");
+  for (vtkm::Id i = 0; i < numberOfValues; i++)
+  {
+    VTKM_TEST_ASSERT(binIds[0].GetPortalConstControl().Get(i) == i &&
+                       freqs.GetPortalConstControl().Get(i) == 1,
+                     "Incorrect ND-histogram of distinct values");
+  }
+}
+
+void TestNDimsHistogramAll()
+{
+  TestNDimsHistogram();
+  TestNDimsHistogramBlocks();
+  TestNDimsHistogramManyBins();
+}
 }
 
 int UnitTestNDimsHistogram(int, char* [])
 {
-  return vtkm::cont::testing::Testing::Run(TestNDimsHistogram);
+  return vtkm::cont::testing::Testing::Run(TestNDimsHistogramAll);
 }
@@ -20,11 +20,13 @@
 
 #include <typeinfo>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/BoundingIntervalHierarchy.hxx>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/DataSetBuilderRectilinear.h>
 #include <vtkm/cont/DataSetBuilderUniform.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/cont/testing/Testing.h>
+#include <vtkm/worklet/CellDeepCopy.h>
 #include <vtkm/worklet/ParticleAdvection.h>
 #include <vtkm/worklet/particleadvection/GridEvaluators.h>
 #include <vtkm/worklet/particleadvection/Integrators.h>
@@ -532,9 +534,114 @@ void TestParticleWorklets()
   }
 }
 
+void TestUnstructuredEvaluator()
+{
+  using DeviceAdapter = VTKM_DEFAULT_DEVICE_ADAPTER_TAG;
+  using FieldType = vtkm::Float32;
+  using FieldHandle = vtkm::cont::ArrayHandle<vtkm::Vec<FieldType, 3>>;
+  using FieldPortalConstType = FieldHandle::template ExecutionTypes<DeviceAdapter>::PortalConst;
+
+  using UniformEvalType =
+    vtkm::worklet::particleadvection::UniformGridEvaluate<FieldPortalConstType,
+                                                          FieldType,
+                                                          DeviceAdapter>;
+  using RK4UniformType =
+    vtkm::worklet::particleadvection::RK4Integrator<UniformEvalType, FieldType>;
+  using UnstructuredEvalType =
+    vtkm::worklet::particleadvection::UnstructuredGridEvaluate<FieldPortalConstType,
+                                                               FieldType,
+                                                               DeviceAdapter>;
+  using RK4UnstructuredType =
+    vtkm::worklet::particleadvection::RK4Integrator<UnstructuredEvalType, FieldType>;
+
+  const vtkm::Id3 dims(5, 5, 5);
+  vtkm::Id nElements = dims[0] * dims[1] * dims[2] * 3;
+  std::vector<vtkm::Vec<FieldType, 3>> field;
+  for (vtkm::Id i = 0; i < nElements; i++)
+  {
+    FieldType x = vecData[i];
+    FieldType y = vecData[++i];
+    FieldType z = vecData[++i];
+    vtkm::Vec<FieldType, 3> vec(x, y, z);
+    field.push_back(vtkm::Normal(vec));
+  }
+  FieldHandle fieldArray = vtkm::cont::make_ArrayHandle(field);
+
+  // The same grid, once as uniform and once as explicit hexahedra, has to
+  // produce the same velocities and particle paths.
+  vtkm::cont::DataSet ds = vtkm::cont::DataSetBuilderUniform().Create(dims);
+  vtkm::cont::DynamicCellSet explicitCells =
+    vtkm::worklet::CellDeepCopy::Run(ds.GetCellSet(0), DeviceAdapter());
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>> explicitPoints;
+  vtkm::cont::ArrayCopy(ds.GetCoordinateSystem().GetData(), explicitPoints, DeviceAdapter());
+  vtkm::cont::CoordinateSystem explicitCoords("coords", explicitPoints);
+
+  vtkm::cont::BoundingIntervalHierarchy locator;
+  locator.SetCellSet(explicitCells);
+  locator.SetCoordinates(explicitCoords);
+  locator.Update();
+
+  FieldType stepSize = 0.01f;
+  UniformEvalType uniformEval(ds.GetCoordinateSystem(), ds.GetCellSet(0), fieldArray);
+  UnstructuredEvalType unstructuredEval(explicitCoords, explicitCells, fieldArray, locator);
+  RK4UniformType uniformRK4(uniformEval, stepSize);
+  RK4UnstructuredType unstructuredRK4(unstructuredEval, stepSize);
+
+  //Seeds stay inside the grid for the whole run.
+  srand(314);
+  std::vector<vtkm::Vec<FieldType, 3>> pts;
+  vtkm::Bounds seedBounds(1, 3, 1, 3, 1, 3);
+  for (int k = 0; k < 32; k++)
+  {
+    vtkm::Vec<FieldType, 3> p;
+    RandomPoint<FieldType>(seedBounds, p);
+    pts.push_back(p);
+  }
+
+  using UniformTester = TestEvaluatorWorklet<FieldType, UniformEvalType>;
+  using UnstructuredTester = TestEvaluatorWorklet<FieldType, UnstructuredEvalType>;
+  FieldHandle seedArray = vtkm::cont::make_ArrayHandle(pts);
+  vtkm::cont::ArrayHandle<bool> uniformStatus, unstructuredStatus;
+  FieldHandle uniformResults, unstructuredResults;
+  vtkm::worklet::DispatcherMapField<UniformTester>(UniformTester(uniformEval))
+    .Invoke(seedArray, uniformStatus, uniformResults);
+  vtkm::worklet::DispatcherMapField<UnstructuredTester>(UnstructuredTester(unstructuredEval))
+    .Invoke(seedArray, unstructuredStatus, unstructuredResults);
+  for (vtkm::Id k = 0; k < seedArray.GetNumberOfValues(); k++)
+  {
+    VTKM_TEST_ASSERT(unstructuredStatus.GetPortalConstControl().Get(k),
+                     "Error in evaluator for unstructured evaluator");
+    VTKM_TEST_ASSERT(test_equal(unstructuredResults.GetPortalConstControl().Get(k),
+                                uniformResults.GetPortalConstControl().Get(k),
+                                0.0001),
+                     "Error in evaluator result for unstructured evaluator");
+  }
+
+  vtkm::Id maxSteps = 50;
+  vtkm::worklet::ParticleAdvection particleAdvection;
+  FieldHandle uniformSeeds, unstructuredSeeds;
+  vtkm::cont::ArrayCopy(seedArray, uniformSeeds, DeviceAdapter());
+  vtkm::cont::ArrayCopy(seedArray, unstructuredSeeds, DeviceAdapter());
+  vtkm::worklet::ParticleAdvectionResult<FieldType> uniformRes =
+    particleAdvection.Run(uniformRK4, uniformSeeds, maxSteps, DeviceAdapter());
+  vtkm::worklet::ParticleAdvectionResult<FieldType> unstructuredRes =
+    particleAdvection.Run(unstructuredRK4, unstructuredSeeds, maxSteps, DeviceAdapter());
+
+  for (vtkm::Id k = 0; k < seedArray.GetNumberOfValues(); k++)
+  {
+    VTKM_TEST_ASSERT(unstructuredRes.stepsTaken.GetPortalConstControl().Get(k) == maxSteps,
+                     "Wrong number of steps taken in unstructured grid");
+    VTKM_TEST_ASSERT(test_equal(unstructuredRes.positions.GetPortalConstControl().Get(k),
+                                uniformRes.positions.GetPortalConstControl().Get(k),
+                                0.001),
+                     "Unstructured and uniform particle paths differ");
+  }
+}
+
 void TestParticleAdvection()
 {
   TestEvaluators();
+  TestUnstructuredEvaluator();
   TestParticleWorklets();
 }
 
@@ -21,6 +21,7 @@
 #include <vtkm/worklet/DispatcherMapTopology.h>
 #include <vtkm/worklet/Gradient.h>
 
+#include <vtkm/cont/DataSetBuilderRectilinear.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 
@@ -200,6 +201,66 @@ void TestPointGradientUniform3DWithVectorField2()
   }
 }
 
+template <typename DeviceAdapter>
+void TestPointDerivativesRectilinear()
+{
+  std::cout << "Testing PointGradient Worklet derived quantities on 3D rectilinear data"
+            << std::endl;
+  std::vector<vtkm::Float64> xs = { 0.0, 0.5, 1.5, 3.0 };
+  std::vector<vtkm::Float64> ys = { 0.0, 1.0, 1.25, 2.0, 4.0 };
+  std::vector<vtkm::Float64> zs = { -1.0, 0.0, 2.0 };
+  vtkm::cont::DataSetBuilderRectilinear builder;
+  vtkm::cont::DataSet dataSet = builder.Create(xs, ys, zs);
+
+  std::vector<vtkm::Vec<vtkm::Float64, 3>> vec;
+  for (vtkm::Float64 z : zs)
+  {
+    for (vtkm::Float64 y : ys)
+    {
+      for (vtkm::Float64 x : xs)
+      {
+        vec.push_back(vtkm::make_Vec(x * y + z, y * y - x * z, x + y * z * z));
+      }
+    }
+  }
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 3>> input = vtkm::cont::make_ArrayHandle(vec);
+  const vtkm::Id nVerts = static_cast<vtkm::Id>(vec.size());
+
+  //Derived quantities computed from the stored gradient
+  vtkm::worklet::GradientOutputFields<vtkm::Vec<vtkm::Float64, 3>> expected(true, true, true, true);
+  const auto& cells = dataSet.GetCellSet();
+  const auto& coords = dataSet.GetCoordinateSystem();
+  vtkm::worklet::PointGradient gradient;
+  gradient.Run(cells, coords, input, expected, DeviceAdapter());
+
+  //Derived quantities computed directly from the neighborhood
+  vtkm::worklet::GradientOutputFields<vtkm::Vec<vtkm::Float64, 3>> all(false, true, true, true);
+  gradient.Run(cells, coords, input, all, DeviceAdapter());
+  vtkm::worklet::GradientOutputFields<vtkm::Vec<vtkm::Float64, 3>> div(false, true, false, false);
+  gradient.Run(cells, coords, input, div, DeviceAdapter());
+
+  VTKM_TEST_ASSERT(all.Gradient.GetNumberOfValues() == 0, "Gradient shouldn't be generated");
+  VTKM_TEST_ASSERT(div.Vorticity.GetNumberOfValues() == 0, "Vorticity shouldn't be generated");
+  VTKM_TEST_ASSERT(div.QCriterion.GetNumberOfValues() == 0, "QCriterion shouldn't be generated");
+  VTKM_TEST_ASSERT(all.Divergence.GetNumberOfValues() == nVerts &&
+                     div.Divergence.GetNumberOfValues() == nVerts,
+                   "Divergence field should be generated");
+
+  for (vtkm::Id i = 0; i < nVerts; ++i)
+  {
+    const vtkm::Float64 d = expected.Divergence.GetPortalConstControl().Get(i);
+    VTKM_TEST_ASSERT(test_equal(d, all.Divergence.GetPortalConstControl().Get(i)) &&
+                       test_equal(d, div.Divergence.GetPortalConstControl().Get(i)),
+                     "Wrong Divergence on 3D rectilinear data");
+    VTKM_TEST_ASSERT(test_equal(expected.Vorticity.GetPortalConstControl().Get(i),
+                                all.Vorticity.GetPortalConstControl().Get(i)),
+                     "Wrong Vorticity on 3D rectilinear data");
+    VTKM_TEST_ASSERT(test_equal(expected.QCriterion.GetPortalConstControl().Get(i),
+                                all.QCriterion.GetPortalConstControl().Get(i)),
+                     "Wrong QCriterion on 3D rectilinear data");
+  }
+}
+
 template <typename DeviceAdapter>
 void TestPointGradientExplicit()
 {
@@ -230,6 +291,7 @@ void TestPointGradient()
   TestPointGradientUniform3D<DeviceAdapter>();
   TestPointGradientUniform3DWithVectorField<DeviceAdapter>();
   TestPointGradientUniform3DWithVectorField2<DeviceAdapter>();
+  TestPointDerivativesRectilinear<DeviceAdapter>();
   TestPointGradientExplicit<DeviceAdapter>();
 }
 }
@@ -18,6 +18,7 @@
 //  this software.
 //============================================================================
 
+#include <vtkm/worklet/WaveletBrickCompressor.h>
 #include <vtkm/worklet/WaveletCompressor.h>
 
 #include <vtkm/cont/ArrayHandlePermutation.h>
@@ -25,6 +26,7 @@
 #include <vtkm/cont/testing/Testing.h>
 
 #include <iomanip>
+#include <sstream>
 #include <vector>
 
 namespace vtkm
@@ -254,6 +256,114 @@ void TestDecomposeReconstruct3D(vtkm::Float64 cratio)
   std::cout << "Verification time      = " << elapsedTime1 << std::endl;
 }
 
+void TestBrickCompressor()
+{
+  std::cout << "Testing brick wavelet compressor on a (96x80x50) volume..." << std::endl;
+  using DeviceTag = VTKM_DEFAULT_DEVICE_ADAPTER_TAG;
+  vtkm::Id3 dims(96, 80, 50);
+  vtkm::Id sigLen = dims[0] * dims[1] * dims[2];
+  vtkm::cont::ArrayHandle<vtkm::Float32> inputArray;
+  inputArray.PrepareForOutput(sigLen, DeviceTag());
+  FillArray3D(inputArray, dims[0], dims[1], dims[2]);
+
+  vtkm::worklet::wavelets::WaveletName wname = vtkm::worklet::wavelets::BIOR2_2;
+  vtkm::worklet::WaveletBrickCompressor compressor(wname);
+  vtkm::worklet::wavelets::CompressedBricks bricks(wname, dims, vtkm::Id3(32, 32, 32), 2);
+  VTKM_TEST_ASSERT(bricks.GetNumberOfBricks() == 3 * 3 * 2, "Wrong number of bricks");
+  compressor.Compress(inputArray, 10.0, bricks, DeviceTag());
+
+  vtkm::Id rawSize = sigLen * static_cast<vtkm::Id>(sizeof(vtkm::Float32));
+  std::cout << "Compressed size        = " << bricks.GetCompressedSize() << " of " << rawSize
+            << " bytes" << std::endl;
+  VTKM_TEST_ASSERT(bricks.GetCompressedSize() < rawSize / 5, "Bricks are not compressed");
+
+  std::stringstream stream;
+  bricks.Save(stream);
+
+  // Reconstruct the whole volume from a loaded copy
+  vtkm::worklet::wavelets::CompressedBricks loaded;
+  loaded.Load(stream);
+  VTKM_TEST_ASSERT(loaded.GetDimensions() == dims, "Wrong dimensions after loading");
+  VTKM_TEST_ASSERT(loaded.GetCompressedSize() == bricks.GetCompressedSize(),
+                   "Wrong size after loading");
+  vtkm::cont::ArrayHandle<vtkm::Float32> reconstructArray;
+  compressor.Reconstruct(loaded, reconstructArray, DeviceTag());
+  VTKM_TEST_ASSERT(reconstructArray.GetNumberOfValues() == sigLen, "Wrong reconstruction size");
+  auto inPortal = inputArray.GetPortalConstControl();
+  auto outPortal = reconstructArray.GetPortalConstControl();
+  vtkm::Float32 maxError = 0.0f;
+  for (vtkm::Id i = 0; i < sigLen; i++)
+  {
+    maxError = vtkm::Max(maxError, vtkm::Abs(inPortal.Get(i) - outPortal.Get(i)));
+  }
+  std::cout << "L-infy norm            = " << maxError << std::endl;
+  VTKM_TEST_ASSERT(maxError < 0.2f, "Brick reconstruction error is too large");
+
+  // Read a single brick from the stream and reconstruct it at two levels
+  vtkm::worklet::wavelets::CompressedBricks single;
+  stream.clear();
+  stream.seekg(0);
+  single.LoadHeader(stream);
+  vtkm::Id3 brickIndex(1, 2, 1);
+  single.LoadBrick(stream, single.GetBrickId(brickIndex));
+  VTKM_TEST_ASSERT(!single.HasBrick(0), "Only the requested brick should be loaded");
+
+  vtkm::Id3 origin = single.GetBrickOrigin(brickIndex);
+  vtkm::Id3 brickDims;
+  vtkm::cont::ArrayHandle<vtkm::Float32> brick;
+  compressor.ReconstructBrick(single, brickIndex, 0, brick, brickDims, DeviceTag());
+  VTKM_TEST_ASSERT(brickDims == vtkm::Id3(32, 16, 18), "Wrong brick dimensions");
+  auto brickPortal = brick.GetPortalConstControl();
+  for (vtkm::Id z = 0; z < brickDims[2]; z++)
+  {
+    for (vtkm::Id y = 0; y < brickDims[1]; y++)
+    {
+      for (vtkm::Id x = 0; x < brickDims[0]; x++)
+      {
+        vtkm::Id volIdx = ((z + origin[2]) * dims[1] + y + origin[1]) * dims[0] + x + origin[0];
+        VTKM_TEST_ASSERT(
+          test_equal(brickPortal.Get((z * brickDims[1] + y) * brickDims[0] + x),
+                     outPortal.Get(volIdx)),
+          "Single brick differs from the volume reconstruction");
+      }
+    }
+  }
+
+  // A coarser level averages 2x2x2 points, so it keeps the brick's range
+  vtkm::cont::ArrayHandle<vtkm::Float32> coarse;
+  compressor.ReconstructBrick(single, brickIndex, 1, coarse, brickDims, DeviceTag());
+  VTKM_TEST_ASSERT(brickDims == vtkm::Id3(16, 8, 9), "Wrong coarse brick dimensions");
+  auto coarsePortal = coarse.GetPortalConstControl();
+  for (vtkm::Id z = 0; z < brickDims[2]; z++)
+  {
+    for (vtkm::Id y = 0; y < brickDims[1]; y++)
+    {
+      for (vtkm::Id x = 0; x < brickDims[0]; x++)
+      {
+        vtkm::Id volIdx =
+          ((2 * z + origin[2]) * dims[1] + 2 * y + origin[1]) * dims[0] + 2 * x + origin[0];
+        VTKM_TEST_ASSERT(
+          vtkm::Abs(coarsePortal.Get((z * brickDims[1] + y) * brickDims[0] + x) -
+                    inPortal.Get(volIdx)) < 1.0f,
+          "Coarse brick is not an approximation of the volume");
+      }
+    }
+  }
+
+  // Streams that do not hold bricks are rejected
+  std::stringstream garbage("not a compressed volume");
+  bool threw = false;
+  try
+  {
+    single.LoadHeader(garbage);
+  }
+  catch (vtkm::cont::ErrorBadValue&)
+  {
+    threw = true;
+  }
+  VTKM_TEST_ASSERT(threw, "Loading garbage should fail");
+}
+
 void TestDecomposeReconstruct2D(vtkm::Float64 cratio)
 {
   std::cout << "Testing 2D wavelet compressor on a (1000x1000) square... " << std::endl;
@@ -397,6 +507,8 @@ void TestWaveletCompressor()
   TestDecomposeReconstruct2D(cratio);
   std::cout << std::endl;
   TestDecomposeReconstruct3D(cratio);
+  std::cout << std::endl;
+  TestBrickCompressor();
 }
 
 int UnitTestWaveletCompressor(int, char* [])
@@ -0,0 +1,332 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//
+//  Copyright 2014 National Technology & Engineering Solutions of Sandia, LLC (NTESS).
+//  Copyright 2014 UT-Battelle, LLC.
+//  Copyright 2014 Los Alamos National Security.
+//
+//  Under the terms of Contract DE-NA0003525 with NTESS,
+//  the U.S. Government retains certain rights in this software.
+//
+//  Under the terms of Contract DE-AC52-06NA25396 with Los Alamos National
+//  Laboratory (LANL), the U.S. Government retains certain rights in
+//  this software.
+//============================================================================
+
+#ifndef vtk_m_worklet_wavelets_compressedbricks_h
+#define vtk_m_worklet_wavelets_compressedbricks_h
+
+#include <vtkm/worklet/wavelets/WaveletFilter.h>
+
+#include <vtkm/Math.h>
+#include <vtkm/Types.h>
+#include <vtkm/cont/ErrorBadValue.h>
+
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace vtkm
+{
+namespace worklet
+{
+
+namespace wavelets
+{
+
+// Container for a volume that is compressed brick by brick.
+//
+// The volume is cut into bricks of a fixed size (bricks on the upper faces
+// may be smaller), and every brick is wavelet transformed and encoded on its
+// own, so bricks can be added one at a time and decoded independently. The
+// container only stores the encoded bytes of each brick; the encoding itself
+// is done by vtkm::worklet::WaveletBrickCompressor.
+//
+// On disk, the container is a fixed header, a table of brick offsets and the
+// brick payloads, all in host byte order. LoadHeader() and LoadBrick() read
+// single bricks from a stream without reading the rest of the payloads.
+class CompressedBricks
+{
+public:
+  CompressedBricks()
+    : Wavelet(BIOR4_4)
+    , Dimensions(0, 0, 0)
+    , BrickSize(1, 1, 1)
+    , NumberOfLevels(0)
+  {
+  }
+
+  CompressedBricks(WaveletName wname,
+                   const vtkm::Id3& dimensions,
+                   const vtkm::Id3& brickSize,
+                   vtkm::Id nLevels)
+    : Wavelet(wname)
+    , Dimensions(dimensions)
+    , BrickSize(brickSize)
+    , NumberOfLevels(nLevels)
+  {
+    this->Validate();
+    this->Bricks.resize(static_cast<std::size_t>(this->GetNumberOfBricks()));
+    this->HasBricks.resize(this->Bricks.size(), false);
+  }
+
+  WaveletName GetWaveletName() const { return this->Wavelet; }
+  const vtkm::Id3& GetDimensions() const { return this->Dimensions; }
+  const vtkm::Id3& GetBrickSize() const { return this->BrickSize; }
+  vtkm::Id GetNumberOfLevels() const { return this->NumberOfLevels; }
+
+  // Number of bricks along each axis
+  vtkm::Id3 GetBrickGridDimensions() const
+  {
+    return vtkm::Id3((this->Dimensions[0] + this->BrickSize[0] - 1) / this->BrickSize[0],
+                     (this->Dimensions[1] + this->BrickSize[1] - 1) / this->BrickSize[1],
+                     (this->Dimensions[2] + this->BrickSize[2] - 1) / this->BrickSize[2]);
+  }
+
+  vtkm::Id GetNumberOfBricks() const
+  {
+    vtkm::Id3 grid = this->GetBrickGridDimensions();
+    return grid[0] * grid[1] * grid[2];
+  }
+
+  vtkm::Id GetBrickId(const vtkm::Id3& brickIndex) const
+  {
+    vtkm::Id3 grid = this->GetBrickGridDimensions();
+    if (brickIndex[0] < 0 || brickIndex[0] >= grid[0] || brickIndex[1] < 0 ||
+        brickIndex[1] >= grid[1] || brickIndex[2] < 0 || brickIndex[2] >= grid[2])
+    {
+      throw vtkm::cont::ErrorBadValue("Brick index is out of range.");
+    }
+    return (brickIndex[2] * grid[1] + brickIndex[1]) * grid[0] + brickIndex[0];
+  }
+
+  // First point of a brick in the volume
+  vtkm::Id3 GetBrickOrigin(const vtkm::Id3& brickIndex) const
+  {
+    return vtkm::Id3(brickIndex[0] * this->BrickSize[0],
+                     brickIndex[1] * this->BrickSize[1],
+                     brickIndex[2] * this->BrickSize[2]);
+  }
+
+  // Number of points of a brick, which is smaller than the brick size for
+  // bricks that are cut off by the upper faces of the volume
+  vtkm::Id3 GetBrickDimensions(const vtkm::Id3& brickIndex) const
+  {
+    vtkm::Id3 origin = this->GetBrickOrigin(brickIndex);
+    return vtkm::Id3(vtkm::Min(this->BrickSize[0], this->Dimensions[0] - origin[0]),
+                     vtkm::Min(this->BrickSize[1], this->Dimensions[1] - origin[1]),
+                     vtkm::Min(this->BrickSize[2], this->Dimensions[2] - origin[2]));
+  }
+
+  bool HasBrick(vtkm::Id brickId) const
+  {
+    return this->HasBricks[static_cast<std::size_t>(this->CheckBrickId(brickId))];
+  }
+
+  void SetBrick(vtkm::Id brickId, std::vector<vtkm::UInt8>&& bytes)
+  {
+    std::size_t id = static_cast<std::size_t>(this->CheckBrickId(brickId));
+    this->Bricks[id] = std::move(bytes);
+    this->HasBricks[id] = true;
+  }
+
+  const std::vector<vtkm::UInt8>& GetBrick(vtkm::Id brickId) const
+  {
+    if (!this->HasBrick(brickId))
+    {
+      throw vtkm::cont::ErrorBadValue("Brick has not been compressed or loaded.");
+    }
+    return this->Bricks[static_cast<std::size_t>(brickId)];
+  }
+
+  // Total number of bytes of the encoded bricks
+  vtkm::Id GetCompressedSize() const
+  {
+    std::size_t size = 0;
+    for (const auto& brick : this->Bricks)
+    {
+      size += brick.size();
+    }
+    return static_cast<vtkm::Id>(size);
+  }
+
+  void Save(std::ostream& out) const
+  {
+    for (std::size_t i = 0; i < this->HasBricks.size(); i++)
+    {
+      if (!this->HasBricks[i])
+      {
+        throw vtkm::cont::ErrorBadValue("Cannot save a container with missing bricks.");
+      }
+    }
+
+    WriteValue(out, MagicNumber());
+    WriteValue(out, static_cast<vtkm::Int32>(this->Wavelet));
+    for (vtkm::IdComponent i = 0; i < 3; i++)
+    {
+      WriteValue(out, static_cast<vtkm::Int64>(this->Dimensions[i]));
+    }
+    for (vtkm::IdComponent i = 0; i < 3; i++)
+    {
+      WriteValue(out, static_cast<vtkm::Int64>(this->BrickSize[i]));
+    }
+    WriteValue(out, static_cast<vtkm::Int64>(this->NumberOfLevels));
+
+    vtkm::UInt64 offset = 0;
+    WriteValue(out, offset);
+    for (const auto& brick : this->Bricks)
+    {
+      offset += static_cast<vtkm::UInt64>(brick.size());
+      WriteValue(out, offset);
+    }
+    for (const auto& brick : this->Bricks)
+    {
+      out.write(reinterpret_cast<const char*>(brick.data()),
+                static_cast<std::streamsize>(brick.size()));
+    }
+    if (!out)
+    {
+      throw vtkm::cont::ErrorBadValue("Failed to write compressed bricks.");
+    }
+  }
+
+  // Reads the whole container
+  void Load(std::istream& in)
+  {
+    this->LoadHeader(in);
+    for (vtkm::Id i = 0; i < this->GetNumberOfBricks(); i++)
+    {
+      this->LoadBrick(in, i);
+    }
+  }
+
+  // Reads the header and brick offsets only. The bricks can then be read one
+  // at a time with LoadBrick() as long as the stream stays open.
+  void LoadHeader(std::istream& in)
+  {
+    if (ReadValue<vtkm::UInt32>(in) != MagicNumber())
+    {
+      throw vtkm::cont::ErrorBadValue("Stream does not hold wavelet compressed bricks.");
+    }
+    vtkm::Int32 wname = ReadValue<vtkm::Int32>(in);
+    if (wname < static_cast<vtkm::Int32>(CDF9_7) || wname > static_cast<vtkm::Int32>(BIOR1_1))
+    {
+      throw vtkm::cont::ErrorBadValue("Unknown wavelet in compressed bricks.");
+    }
+    this->Wavelet = static_cast<WaveletName>(wname);
+    for (vtkm::IdComponent i = 0; i < 3; i++)
+    {
+      this->Dimensions[i] = static_cast<vtkm::Id>(ReadValue<vtkm::Int64>(in));
+    }
+    for (vtkm::IdComponent i = 0; i < 3; i++)
+    {
+      this->BrickSize[i] = static_cast<vtkm::Id>(ReadValue<vtkm::Int64>(in));
+    }
+    this->NumberOfLevels = static_cast<vtkm::Id>(ReadValue<vtkm::Int64>(in));
+    this->Validate();
+
+    std::size_t numberOfBricks = static_cast<std::size_t>(this->GetNumberOfBricks());
+    this->Offsets.resize(numberOfBricks + 1);
+    for (auto& offset : this->Offsets)
+    {
+      offset = ReadValue<vtkm::UInt64>(in);
+    }
+    for (std::size_t i = 0; i < numberOfBricks; i++)
+    {
+      if (this->Offsets[i] > this->Offsets[i + 1])
+      {
+        throw vtkm::cont::ErrorBadValue("Corrupted brick offsets in compressed bricks.");
+      }
+    }
+    this->PayloadStart = in.tellg();
+
+    this->Bricks.assign(numberOfBricks, std::vector<vtkm::UInt8>());
+    this->HasBricks.assign(numberOfBricks, false);
+  }
+
+  void LoadBrick(std::istream& in, vtkm::Id brickId)
+  {
+    std::size_t id = static_cast<std::size_t>(this->CheckBrickId(brickId));
+    if (this->Offsets.size() != this->Bricks.size() + 1)
+    {
+      throw vtkm::cont::ErrorBadValue("LoadHeader must be called before LoadBrick.");
+    }
+    std::vector<vtkm::UInt8> bytes(
+      static_cast<std::size_t>(this->Offsets[id + 1] - this->Offsets[id]));
+    in.seekg(this->PayloadStart + static_cast<std::streamoff>(this->Offsets[id]));
+    in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!in)
+    {
+      throw vtkm::cont::ErrorBadValue("Failed to read a compressed brick.");
+    }
+    this->SetBrick(brickId, std::move(bytes));
+  }
+
+private:
+  WaveletName Wavelet;
+  vtkm::Id3 Dimensions;
+  vtkm::Id3 BrickSize;
+  vtkm::Id NumberOfLevels;
+  std::vector<std::vector<vtkm::UInt8>> Bricks;
+  std::vector<bool> HasBricks;
+
+  // Only valid after LoadHeader
+  std::vector<vtkm::UInt64> Offsets;
+  std::streampos PayloadStart;
+
+  static vtkm::UInt32 MagicNumber() { return 0x42574d56; } // "VMWB"
+
+  void Validate() const
+  {
+    for (vtkm::IdComponent i = 0; i < 3; i++)
+    {
+      if (this->Dimensions[i] < 1 || this->BrickSize[i] < 1)
+      {
+        throw vtkm::cont::ErrorBadValue("Volume and brick dimensions must be positive.");
+      }
+    }
+    if (this->NumberOfLevels < 0)
+    {
+      throw vtkm::cont::ErrorBadValue("Number of levels of transform must not be negative.");
+    }
+  }
+
+  vtkm::Id CheckBrickId(vtkm::Id brickId) const
+  {
+    if (brickId < 0 || brickId >= static_cast<vtkm::Id>(this->Bricks.size()))
+    {
+      throw vtkm::cont::ErrorBadValue("Brick id is out of range.");
+    }
+    return brickId;
+  }
+
+  template <typename T>
+  static void WriteValue(std::ostream& out, const T& value)
+  {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  static T ReadValue(std::istream& in)
+  {
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!in)
+    {
+      throw vtkm::cont::ErrorBadValue("Unexpected end of compressed bricks.");
+    }
+    return value;
+  }
+};
+
+} // namespace wavelets
+} // namespace worklet
+} // namespace vtkm
+
+#endif // vtk_m_worklet_wavelets_compressedbricks_h
@@ -214,6 +214,13 @@ public:
     vtkm::cont::DeviceAdapterAlgorithm<DeviceTag>::Sort(array, SortLessAbsFunctor());
   }
 
+  // Find the value that would be at index n if array was sorted by DeviceSort
+  template <typename ArrayType, typename DeviceTag>
+  typename ArrayType::ValueType DeviceSelectNth(const ArrayType& array, vtkm::Id n, DeviceTag)
+  {
+    return vtkm::cont::DeviceAdapterAlgorithm<DeviceTag>::SelectNth(array, n, SortLessAbsFunctor());
+  }
+
   // Reduce to the sum of all values on device
   template <typename ArrayType, typename DeviceTag>
   typename ArrayType::ValueType DeviceSum(const ArrayType& array, DeviceTag)
@@ -330,6 +337,30 @@ public:
     dispatcher.Invoke(smallCube, bigCube);
   }
 
+  // Copy a part of a big cube to a small cube
+  template <typename BigArrayType, typename SmallArrayType, typename DeviceTag>
+  void DeviceCubeCopyFrom(const BigArrayType& bigCube,
+                          vtkm::Id bigX,
+                          vtkm::Id bigY,
+                          vtkm::Id bigZ,
+                          SmallArrayType& smallCube,
+                          vtkm::Id smallX,
+                          vtkm::Id smallY,
+                          vtkm::Id smallZ,
+                          vtkm::Id startX,
+                          vtkm::Id startY,
+                          vtkm::Id startZ,
+                          DeviceTag)
+  {
+    VTKM_ASSERT(startX + smallX <= bigX && startY + smallY <= bigY && startZ + smallZ <= bigZ);
+    (void)bigZ;
+    using CopyFromWorklet = vtkm::worklet::wavelets::CubeCopyFrom;
+    CopyFromWorklet cp(smallX, smallY, bigX, bigY, startX, startY, startZ);
+    vtkm::worklet::DispatcherMapField<CopyFromWorklet, DeviceTag> dispatcher(cp);
+    smallCube.Allocate(smallX * smallY * smallZ);
+    dispatcher.Invoke(smallCube, bigCube);
+  }
+
   template <typename ArrayType>
   void Print2DArray(const std::string& str, const ArrayType& arr, vtkm::Id dimX)
   {
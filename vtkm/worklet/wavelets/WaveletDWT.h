@@ -773,7 +773,7 @@ public:
       FrontBackXFormType worklet(WaveletBase::filter.GetLowDecomposeFilter(),
                                  WaveletBase::filter.GetHighDecomposeFilter(),
                                  filterLen,
-                                 L[1],
+                                 L[2],
                                  oddLow,
                                  sigPretendDimX,
                                  sigPretendDimY,
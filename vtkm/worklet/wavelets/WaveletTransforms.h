@@ -3239,6 +3239,29 @@ public:
   }
 };
 
+class ScaleWorklet : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldInOut<ScalarAll>); // Scaling in-place
+  using ExecutionSignature = void(_1);
+  using InputDomain = _1;
+
+  // Constructor
+  ScaleWorklet(vtkm::Float64 s)
+    : scale(s)
+  {
+  }
+
+  template <typename ValueType>
+  VTKM_EXEC void operator()(ValueType& v) const
+  {
+    v = static_cast<ValueType>(v * scale);
+  }
+
+private:
+  vtkm::Float64 scale;
+};
+
 class CopyWorklet : public vtkm::worklet::WorkletMapField
 {
 public:
@@ -3739,6 +3762,52 @@ private:
   const vtkm::Id outStartX, outStartY, outStartZ; // where to put
 };
 
+// Worklet: Copies a part of a big cube to become a small cube
+class CubeCopyFrom : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldOut<ScalarAll>,      // Output, small cube
+                                WholeArrayIn<ScalarAll>); // Input, big cube
+  using ExecutionSignature = void(_1, _2, WorkIndex);
+
+  // Constructor
+  VTKM_EXEC_CONT
+  CubeCopyFrom(vtkm::Id outx,
+               vtkm::Id outy,
+               vtkm::Id inx,
+               vtkm::Id iny,
+               vtkm::Id xStart,
+               vtkm::Id yStart,
+               vtkm::Id zStart)
+    : outDimX(outx)
+    , outDimY(outy)
+    , inDimX(inx)
+    , inDimY(iny)
+    , inStartX(xStart)
+    , inStartY(yStart)
+    , inStartZ(zStart)
+  {
+  }
+
+  template <typename ValueOutType, typename PortalInType>
+  VTKM_EXEC void operator()(ValueOutType& valueOut,
+                            const PortalInType& arrayIn,
+                            const vtkm::Id& workIdx) const
+  {
+    vtkm::Id z = workIdx / (outDimX * outDimY);
+    vtkm::Id y = (workIdx - z * outDimX * outDimY) / outDimX;
+    vtkm::Id x = workIdx % outDimX;
+    vtkm::Id inputIdx =
+      (z + inStartZ) * inDimX * inDimY + (y + inStartY) * inDimX + (x + inStartX);
+    valueOut = static_cast<ValueOutType>(arrayIn.Get(inputIdx));
+  }
+
+private:
+  const vtkm::Id outDimX, outDimY;             // output small cube
+  const vtkm::Id inDimX, inDimY;               // input big cube
+  const vtkm::Id inStartX, inStartY, inStartZ; // where to take from
+};
+
 } // namespace wavelets
 } // namespace worlet
 } // namespace vtkm